@@ -0,0 +1,497 @@
+// This file is part of the AMD Work Graph Mesh Node Sample.
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include "chunkculling.h"
+
+#include "chunkmetadata.h"
+#include "horizonculling.h"
+#include "terrainclipmap.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+
+namespace meshnode
+{
+    static const uint32_t TileCountPerChunk = TerrainTilesPerChunk * TerrainTilesPerChunk;
+    static const float    TerrainTileSize   = TerrainChunkSize / TerrainTilesPerChunk;
+    static const float    TileDiagonal      = TerrainTileSize * 1.41421356f;
+
+    // Heights fade out between these distances to the camera, see GetCurvedWorldHeightScale, with a slope of at most 1.5 / (end - start)
+    static const float HeightFadeStartDistance = 1000.f;
+    static const float HeightFadeEndDistance   = 2000.f;
+    static const float HeightFadeMaxSlope      = 1.5f / (HeightFadeEndDistance - HeightFadeStartDistance);
+    // Deviation of the curved tile from the box around its corners, i.e. curvature of the world over a tile & float rounding
+    static const float TileCurvatureMargin = 0.1f;
+
+    ChunkCuller::ChunkCuller(const ChunkCullingDesc& desc)
+        : m_Desc(desc)
+    {
+    }
+
+    const std::vector<ChunkRecord>& ChunkCuller::Cull(const WorkGraphCBData& data)
+    {
+        const auto startTime = std::chrono::high_resolution_clock::now();
+
+        m_Chunks.clear();
+        m_Stats = {};
+
+        const ChunkGridRecord grid       = ComputeChunkGrid(data, m_Desc.Quality);
+        const size_t          chunkCount = static_cast<size_t>(grid.grid.x) * grid.grid.y;
+
+        m_Stats.GridChunkCount = static_cast<uint32_t>(chunkCount);
+
+        if (chunkCount > 0)
+        {
+            const float3     cameraPosition = data.CameraPosition.xyz();
+            const ClipPlanes clipPlanes     = ComputeClipPlanes(data.ViewProjection);
+
+            // Chunk corners are shared by up to four chunks, curve them once.
+            // The y component is zero, thus the curved position does not depend on the height range of the bounding box.
+            const uint32_t cornerRowLength = grid.grid.x + 1;
+
+            m_Corners.resize(static_cast<size_t>(cornerRowLength) * (grid.grid.y + 1));
+            for (uint32_t y = 0; y <= grid.grid.y; ++y)
+            {
+                for (uint32_t x = 0; x < cornerRowLength; ++x)
+                {
+                    const int2   corner              = grid.offset + int2(static_cast<int32_t>(x), static_cast<int32_t>(y));
+                    const float3 cornerWorldPosition = float3(static_cast<float>(corner.x), 0.f, static_cast<float>(corner.y)) * TerrainChunkSize;
+
+                    m_Corners[y * cornerRowLength + x] = GetCurvedWorldSpacePosition(cameraPosition, cornerWorldPosition);
+                }
+            }
+
+            // Bounding boxes, same as GetGridBoundingBox in common.hlsl
+            for (uint32_t i = 0; i < 3; ++i)
+            {
+                m_BoxMin[i].resize(chunkCount);
+                m_BoxMax[i].resize(chunkCount);
+            }
+            m_Visible.resize(chunkCount);
+
+            for (uint32_t y = 0; y < grid.grid.y; ++y)
+            {
+                for (uint32_t x = 0; x < grid.grid.x; ++x)
+                {
+                    const size_t index       = static_cast<size_t>(y) * grid.grid.x + x;
+                    const float3 minPosition = m_Corners[y * cornerRowLength + x] + float3(0.f, TerrainChunkMinHeight, 0.f);
+                    const float3 maxPosition = m_Corners[(y + 1) * cornerRowLength + x + 1] + float3(0.f, TerrainChunkMaxHeight, 0.f);
+
+                    m_BoxMin[0][index] = minPosition.x;
+                    m_BoxMin[1][index] = minPosition.y;
+                    m_BoxMin[2][index] = minPosition.z;
+                    m_BoxMax[0][index] = maxPosition.x;
+                    m_BoxMax[1][index] = maxPosition.y;
+                    m_BoxMax[2][index] = maxPosition.z;
+                }
+            }
+
+            const float* const boxMin[3] = {m_BoxMin[0].data(), m_BoxMin[1].data(), m_BoxMin[2].data()};
+            const float* const boxMax[3] = {m_BoxMax[0].data(), m_BoxMax[1].data(), m_BoxMax[2].data()};
+
+            IsBoxVisibleBatch(boxMin, boxMax, &clipPlanes.Planes[0].x, m_Visible.data(), chunkCount, m_Desc.Isa);
+
+            for (uint32_t y = 0; y < grid.grid.y; ++y)
+            {
+                for (uint32_t x = 0; x < grid.grid.x; ++x)
+                {
+                    if (m_Visible[static_cast<size_t>(y) * grid.grid.x + x] != 0.f)
+                    {
+                        ChunkRecord record       = {};
+                        record.chunkGridPosition = grid.offset + int2(static_cast<int32_t>(x), static_cast<int32_t>(y));
+                        m_Chunks.push_back(record);
+                    }
+                }
+            }
+
+            if (m_Desc.pMetadataCache && m_Desc.UseHeightBounds)
+            {
+                CullWithHeightBounds(data);
+            }
+
+            if (m_Desc.pMetadataCache)
+            {
+                const ChunkMetadataCacheStats previousStats = m_Desc.pMetadataCache->GetFrameStats();
+
+                m_Desc.pMetadataCache->UpdateChunkRecords(m_Chunks);
+
+                const ChunkMetadataCacheStats& cacheStats = m_Desc.pMetadataCache->GetFrameStats();
+
+                m_Stats.HeightSampleCount = static_cast<uint32_t>(cacheStats.ChunkMisses - previousStats.ChunkMisses);
+                m_Stats.BiomeSampleCount  = static_cast<uint32_t>(cacheStats.TileBiomeMisses - previousStats.TileBiomeMisses);
+
+                if (m_Desc.UseHeightBounds)
+                {
+                    for (size_t i = 0; i < m_Chunks.size(); ++i)
+                    {
+                        for (uint32_t j = 0; j < TileCountPerChunk; ++j)
+                        {
+                            if ((m_VisibleTiles[i] & (uint64_t(1) << j)) == 0)
+                            {
+                                SetChunkTileBiome(m_Chunks[i].tileBiomes, j, ChunkTileCulled);
+                            }
+                        }
+                    }
+                }
+            }
+            else
+            {
+                ComputeLevelsOfDetail(data, grid);
+                ComputeTileBiomes();
+            }
+
+            if (m_Desc.pHorizonCuller)
+            {
+                m_Desc.pHorizonCuller->Cull(data, m_Chunks);
+
+                m_Stats.OccludedChunkCount = m_Desc.pHorizonCuller->GetStats().OccludedChunkCount;
+            }
+        }
+
+        m_Stats.VisibleChunkCount = static_cast<uint32_t>(m_Chunks.size());
+        m_Stats.TimeMs            = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+
+        return m_Chunks;
+    }
+
+    void ChunkCuller::ComputeLevelsOfDetail(const WorkGraphCBData& data, const ChunkGridRecord& grid)
+    {
+        // Level of detail grid with a border of one chunk for the neighbors of the chunks at the grid edges
+        const int2     origin    = grid.offset + int2(-1, -1);
+        const uint32_t rowLength = grid.grid.x + 2;
+
+        m_LevelsOfDetail.assign(static_cast<size_t>(rowLength) * (grid.grid.y + 2), -1);
+        m_HeightSampleCells.clear();
+
+        const auto getCell = [&](const int2& chunkGridPosition) {
+            return static_cast<uint32_t>(chunkGridPosition.y - origin.y) * rowLength + static_cast<uint32_t>(chunkGridPosition.x - origin.x);
+        };
+
+        // Collect visible chunks & their neighbors, each cell is sampled once
+        for (const ChunkRecord& chunk : m_Chunks)
+        {
+            for (const int2& offset : {int2(0, 0), int2(-1, 0), int2(0, -1), int2(1, 0), int2(0, 1)})
+            {
+                const uint32_t cell = getCell(chunk.chunkGridPosition + offset);
+
+                if (m_LevelsOfDetail[cell] < 0)
+                {
+                    m_LevelsOfDetail[cell] = 0;
+                    m_HeightSampleCells.push_back(cell);
+                }
+            }
+        }
+
+        const size_t sampleCount = m_HeightSampleCells.size();
+
+        m_SampleX.resize(sampleCount);
+        m_SampleZ.resize(sampleCount);
+        m_Heights.resize(sampleCount);
+
+        for (size_t i = 0; i < sampleCount; ++i)
+        {
+            const uint32_t cell   = m_HeightSampleCells[i];
+            const float2   center = GetTerrainChunkCenter(origin + int2(static_cast<int32_t>(cell % rowLength), static_cast<int32_t>(cell / rowLength)));
+
+            m_SampleX[i] = center.x;
+            m_SampleZ[i] = center.y;
+        }
+
+        if (m_Desc.pTerrainClipmap)
+        {
+            for (size_t i = 0; i < sampleCount; ++i)
+            {
+                m_Heights[i] = m_Desc.pTerrainClipmap->GetHeight(float2(m_SampleX[i], m_SampleZ[i]));
+            }
+        }
+        else
+        {
+            GetTerrainHeightBatch(m_SampleX.data(), m_SampleZ.data(), m_Heights.data(), sampleCount, m_Desc.Isa);
+        }
+
+        const float3 cameraPosition = data.CameraPosition.xyz();
+
+        for (size_t i = 0; i < sampleCount; ++i)
+        {
+            const float3 chunkCenterPosition = float3(m_SampleX[i], m_Heights[i], m_SampleZ[i]);
+
+            m_LevelsOfDetail[m_HeightSampleCells[i]] = GetTerrainChunkLevelOfDetail(cameraPosition, chunkCenterPosition);
+        }
+
+        for (ChunkRecord& chunk : m_Chunks)
+        {
+            const int32_t levelOfDetail = m_LevelsOfDetail[getCell(chunk.chunkGridPosition)];
+
+            chunk.levelOfDetail               = levelOfDetail;
+            chunk.levelOfDetailTransitionMask = 0;
+
+            // same neighbor order as DrawTerrainChunkRecord::levelOfDetailTransition
+            const int2 neighbors[4] = {int2(-1, 0), int2(0, -1), int2(1, 0), int2(0, 1)};
+
+            for (uint32_t i = 0; i < 4; ++i)
+            {
+                if (m_LevelsOfDetail[getCell(chunk.chunkGridPosition + neighbors[i])] > levelOfDetail)
+                {
+                    chunk.levelOfDetailTransitionMask |= 1u << i;
+                }
+            }
+        }
+
+        m_Stats.HeightSampleCount = static_cast<uint32_t>(sampleCount);
+    }
+
+    void ChunkCuller::ComputeTileBiomes()
+    {
+        const uint32_t tileCount   = TerrainTilesPerChunk * TerrainTilesPerChunk;
+        const size_t   sampleCount = m_Chunks.size() * tileCount;
+
+        m_SampleX.resize(sampleCount);
+        m_SampleZ.resize(sampleCount);
+        for (auto& weights : m_BiomeWeights)
+        {
+            weights.resize(sampleCount);
+        }
+
+        for (size_t i = 0; i < m_Chunks.size(); ++i)
+        {
+            const int2 chunkGridPosition = m_Chunks[i].chunkGridPosition;
+
+            for (uint32_t j = 0; j < tileCount; ++j)
+            {
+                const int2 tileGridPosition =
+                    int2(chunkGridPosition.x * static_cast<int32_t>(TerrainTilesPerChunk) + static_cast<int32_t>(j % TerrainTilesPerChunk),
+                         chunkGridPosition.y * static_cast<int32_t>(TerrainTilesPerChunk) + static_cast<int32_t>(j / TerrainTilesPerChunk));
+                const float2 center = GetTerrainTileCenter(tileGridPosition);
+
+                m_SampleX[i * tileCount + j] = center.x;
+                m_SampleZ[i * tileCount + j] = center.y;
+            }
+        }
+
+        if (m_Desc.pTerrainClipmap)
+        {
+            for (size_t i = 0; i < sampleCount; ++i)
+            {
+                const float3 biomeWeights = m_Desc.pTerrainClipmap->GetBiomeWeights(float2(m_SampleX[i], m_SampleZ[i]));
+
+                m_BiomeWeights[0][i] = biomeWeights.x;
+                m_BiomeWeights[1][i] = biomeWeights.y;
+                m_BiomeWeights[2][i] = biomeWeights.z;
+            }
+        }
+        else
+        {
+            GetBiomeWeightsBatch(m_SampleX.data(),
+                                 m_SampleZ.data(),
+                                 m_BiomeWeights[0].data(),
+                                 m_BiomeWeights[1].data(),
+                                 m_BiomeWeights[2].data(),
+                                 sampleCount,
+                                 m_Desc.Isa);
+        }
+
+        for (size_t i = 0; i < m_Chunks.size(); ++i)
+        {
+            for (uint32_t j = 0; j < tileCount; ++j)
+            {
+                const size_t sample = i * tileCount + j;
+
+                SetChunkTileBiome(m_Chunks[i].tileBiomes, j, GetDominantBiome(float3(m_BiomeWeights[0][sample], m_BiomeWeights[1][sample], m_BiomeWeights[2][sample])));
+            }
+        }
+
+        m_Stats.BiomeSampleCount = static_cast<uint32_t>(sampleCount);
+    }
+
+    void ChunkCuller::CullWithHeightBounds(const WorkGraphCBData& data)
+    {
+        const float3   cameraPosition   = data.CameraPosition.xyz();
+        const float2   cameraPositionXZ = float2(cameraPosition.x, cameraPosition.z);
+        const uint32_t cornerRowLength  = TerrainTilesPerChunk + 1;
+        const size_t   boxCount         = m_Chunks.size() * TileCountPerChunk;
+
+        m_ChunkGridPositions.clear();
+        for (const ChunkRecord& chunk : m_Chunks)
+        {
+            m_ChunkGridPositions.push_back(chunk.chunkGridPosition);
+        }
+
+        const std::vector<const ChunkMetadata*>& heightBounds = m_Desc.pMetadataCache->RequestHeightBounds(m_ChunkGridPositions);
+
+        // Boxes around the height bounds of all tiles, followed by the boxes with the fixed height range of the ChunkGrid node
+        for (uint32_t i = 0; i < 3; ++i)
+        {
+            m_BoxMin[i].resize(boxCount * 2);
+            m_BoxMax[i].resize(boxCount * 2);
+        }
+        m_Visible.resize(boxCount * 2);
+        m_TileCorners.resize(static_cast<size_t>(cornerRowLength) * cornerRowLength);
+        m_TileCornerUps.resize(m_TileCorners.size());
+
+        const auto setBox = [&](size_t index, const float3& minPosition, const float3& maxPosition) {
+            m_BoxMin[0][index] = minPosition.x;
+            m_BoxMin[1][index] = minPosition.y;
+            m_BoxMin[2][index] = minPosition.z;
+            m_BoxMax[0][index] = maxPosition.x;
+            m_BoxMax[1][index] = maxPosition.y;
+            m_BoxMax[2][index] = maxPosition.z;
+        };
+
+        for (size_t i = 0; i < m_Chunks.size(); ++i)
+        {
+            const ChunkMetadata& bounds         = *heightBounds[i];
+            const int2           tileGridOrigin = int2(m_Chunks[i].chunkGridPosition.x * static_cast<int32_t>(TerrainTilesPerChunk),
+                                                       m_Chunks[i].chunkGridPosition.y * static_cast<int32_t>(TerrainTilesPerChunk));
+
+            // Curved positions are linear in the height, thus each tile corner is curved once at height zero & one
+            for (uint32_t y = 0; y < cornerRowLength; ++y)
+            {
+                for (uint32_t x = 0; x < cornerRowLength; ++x)
+                {
+                    const int2   corner              = tileGridOrigin + int2(static_cast<int32_t>(x), static_cast<int32_t>(y));
+                    const float3 cornerWorldPosition = float3(static_cast<float>(corner.x), 0.f, static_cast<float>(corner.y)) * TerrainTileSize;
+                    const float3 curvedPosition      = GetCurvedWorldSpacePosition(cameraPosition, cornerWorldPosition);
+
+                    m_TileCorners[y * cornerRowLength + x]   = curvedPosition;
+                    m_TileCornerUps[y * cornerRowLength + x] = GetCurvedWorldSpacePosition(cameraPosition, cornerWorldPosition + float3(0.f, 1.f, 0.f)) - curvedPosition;
+                }
+            }
+
+            for (uint32_t j = 0; j < TileCountPerChunk; ++j)
+            {
+                const uint32_t x = j % TerrainTilesPerChunk;
+                const uint32_t y = j / TerrainTilesPerChunk;
+
+                const float minHeight = bounds.TileMinHeights[j] - TerrainHeightBoundsMargin;
+                const float maxHeight = bounds.TileMaxHeights[j] + TerrainHeightBoundsMargin + TerrainContentHeight;
+
+                float3 minPosition = float3(std::numeric_limits<float>::max());
+                float3 maxPosition = float3(-std::numeric_limits<float>::max());
+                float  minDistance = std::numeric_limits<float>::max();
+                float  maxDistance = 0.f;
+
+                for (uint32_t corner = 0; corner < 4; ++corner)
+                {
+                    const uint32_t cornerX     = x + (corner & 1);
+                    const uint32_t cornerY     = y + (corner >> 1);
+                    const uint32_t cornerIndex = cornerY * cornerRowLength + cornerX;
+
+                    const float3 lowPosition  = m_TileCorners[cornerIndex] + m_TileCornerUps[cornerIndex] * minHeight;
+                    const float3 highPosition = m_TileCorners[cornerIndex] + m_TileCornerUps[cornerIndex] * maxHeight;
+
+                    minPosition = min(minPosition, min(lowPosition, highPosition));
+                    maxPosition = max(maxPosition, max(lowPosition, highPosition));
+
+                    const float2 cornerPosition =
+                        float2(static_cast<float>(tileGridOrigin.x + static_cast<int32_t>(cornerX)), static_cast<float>(tileGridOrigin.y + static_cast<int32_t>(cornerY))) *
+                        TerrainTileSize;
+                    const float distance = length(cornerPosition - cameraPositionXZ);
+
+                    minDistance = std::min(minDistance, distance);
+                    maxDistance = std::max(maxDistance, distance);
+                }
+
+                // Inside the fade range, points of the tile closer to the camera than all corners have a larger height scale than the corners
+                float margin = TileCurvatureMargin;
+                if ((maxDistance > HeightFadeStartDistance) && ((minDistance - TileDiagonal) < HeightFadeEndDistance))
+                {
+                    margin += std::max(std::abs(minHeight), std::abs(maxHeight)) * HeightFadeMaxSlope * TileDiagonal;
+                }
+
+                const size_t index = i * TileCountPerChunk + j;
+
+                setBox(index, minPosition - float3(margin), maxPosition + float3(margin));
+
+                // same as GetGridBoundingBox in common.hlsl
+                setBox(boxCount + index,
+                       m_TileCorners[y * cornerRowLength + x] + float3(0.f, TerrainChunkMinHeight, 0.f),
+                       m_TileCorners[(y + 1) * cornerRowLength + x + 1] + float3(0.f, TerrainChunkMaxHeight, 0.f));
+            }
+        }
+
+        const ClipPlanes   clipPlanes = ComputeClipPlanes(data.ViewProjection);
+        const float* const boxMin[3]  = {m_BoxMin[0].data(), m_BoxMin[1].data(), m_BoxMin[2].data()};
+        const float* const boxMax[3]  = {m_BoxMax[0].data(), m_BoxMax[1].data(), m_BoxMax[2].data()};
+
+        IsBoxVisibleBatch(boxMin, boxMax, &clipPlanes.Planes[0].x, m_Visible.data(), boxCount * 2, m_Desc.Isa);
+
+        // Remove chunks without visible tiles, the terrain of a chunk is covered by the boxes of its tiles. Keeps the order of the records.
+        m_VisibleTiles.resize(m_Chunks.size());
+
+        size_t chunkCount = 0;
+
+        for (size_t i = 0; i < m_Chunks.size(); ++i)
+        {
+            uint64_t visibleTiles = 0;
+
+            for (uint32_t j = 0; j < TileCountPerChunk; ++j)
+            {
+                const size_t index = i * TileCountPerChunk + j;
+
+                if (m_Visible[boxCount + index] == 0.f)
+                {
+                    continue;
+                }
+
+                ++m_Stats.FrustumTileCount;
+
+                if (m_Visible[index] != 0.f)
+                {
+                    visibleTiles |= uint64_t(1) << j;
+                }
+                else
+                {
+                    ++m_Stats.BoundsCulledTileCount;
+                }
+            }
+
+            if (visibleTiles == 0)
+            {
+                ++m_Stats.BoundsCulledChunkCount;
+                continue;
+            }
+
+            m_VisibleTiles[chunkCount] = visibleTiles;
+            m_Chunks[chunkCount++]     = m_Chunks[i];
+        }
+
+        m_Chunks.resize(chunkCount);
+        m_VisibleTiles.resize(chunkCount);
+    }
+
+    const std::vector<ChunkRecord>& ChunkCuller::GetChunks() const
+    {
+        return m_Chunks;
+    }
+
+    const ChunkCullingStats& ChunkCuller::GetStats() const
+    {
+        return m_Stats;
+    }
+
+    void ChunkCuller::SetTerrainKernelIsa(TerrainKernelIsa isa)
+    {
+        m_Desc.Isa = isa;
+    }
+}  // namespace meshnode
@@ -0,0 +1,129 @@
+// This file is part of the AMD Work Graph Mesh Node Sample.
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+
+#include "terrain.h"
+#include "worldgraph.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// CPU frustum culling & level of detail selection of the terrain chunk grid.
+// Performs the work of the World & ChunkGrid nodes for the whole grid at once with the SIMD terrain kernels, such that the work graph
+// can be launched with one Chunk record per visible chunk instead of a single World record. See the Chunk node in world.hlsl.
+namespace meshnode
+{
+    class TerrainClipmap;
+    class ChunkMetadataCache;
+    class HorizonCuller;
+
+    struct ChunkCullingDesc
+    {
+        // only WorldGridMaxDistance is used, must match the quality tier the shaders were compiled with
+        WorldGraphQuality Quality;
+        // chunk center heights are sampled from this clipmap like the shaders, nullptr uses the analytic terrain height
+        const TerrainClipmap* pTerrainClipmap = nullptr;
+        // instruction set of the frustum test & the analytic terrain functions
+        TerrainKernelIsa Isa = TerrainKernelIsa::Auto;
+        // levels of detail & tile biomes are taken from this cache, which uses the analytic terrain functions instead of the clipmap.
+        // nullptr samples the terrain for all visible chunks every frame.
+        ChunkMetadataCache* pMetadataCache = nullptr;
+        // tests the chunks inside the view frustum again per tile with boxes around the terrain height bounds of pMetadataCache, expanded by
+        // TerrainContentHeight, instead of the fixed TerrainChunkMinHeight to TerrainChunkMaxHeight range. Tiles outside of the view frustum
+        // are marked with ChunkTileCulled & chunks without visible tiles are removed. Requires pMetadataCache.
+        bool UseHeightBounds = false;
+        // removes chunks & marks tiles hidden behind the terrain after the frustum test, nullptr disables occlusion culling
+        HorizonCuller* pHorizonCuller = nullptr;
+    };
+
+    struct ChunkCullingStats
+    {
+        // chunks in the grid of the World node
+        uint32_t GridChunkCount    = 0;
+        uint32_t VisibleChunkCount = 0;
+        // chunks inside the view frustum removed by the height bounds test & by the horizon culling, not part of VisibleChunkCount
+        uint32_t BoundsCulledChunkCount = 0;
+        uint32_t OccludedChunkCount     = 0;
+        // tiles of the chunks inside the view frustum that are inside with the fixed height range & outside with their height bounds,
+        // only counted with UseHeightBounds
+        uint32_t FrustumTileCount      = 0;
+        uint32_t BoundsCulledTileCount = 0;
+        // terrain heights sampled for the level of detail of the visible chunks & their neighbors, only cache misses with a cache
+        uint32_t HeightSampleCount = 0;
+        // tile biome weights sampled for the tiles of the visible chunks, only cache misses with a cache
+        uint32_t BiomeSampleCount = 0;
+        double   TimeMs           = 0.0;
+    };
+
+    /**
+     * Computes the Chunk entry records of a frame.
+     * Records are bit-identical to the chunks, levels of detail & tile biomes computed by the World & ChunkGrid nodes of WorldGraphEmulator
+     * and ordered like the thread groups of ChunkGrid, i.e. row by row.
+     */
+    class ChunkCuller
+    {
+    public:
+        explicit ChunkCuller(const ChunkCullingDesc& desc);
+
+        /**
+         * @brief   Cull the chunk grid of the camera in data. The returned records are valid until the next call.
+         */
+        const std::vector<ChunkRecord>& Cull(const WorkGraphCBData& data);
+
+        const std::vector<ChunkRecord>& GetChunks() const;
+        const ChunkCullingStats&        GetStats() const;
+
+        void SetTerrainKernelIsa(TerrainKernelIsa isa);
+
+    private:
+        void ComputeLevelsOfDetail(const WorkGraphCBData& data, const ChunkGridRecord& grid);
+        void ComputeTileBiomes();
+        void CullWithHeightBounds(const WorkGraphCBData& data);
+
+        ChunkCullingDesc         m_Desc;
+        std::vector<ChunkRecord> m_Chunks;
+        ChunkCullingStats        m_Stats;
+
+        // Scratch memory, kept across frames
+        // curved world positions of the chunk corners, (grid.x + 1) * (grid.y + 1)
+        std::vector<float3> m_Corners;
+        // bounding boxes & visibility of all chunks, structure of arrays for the SIMD frustum test
+        std::vector<float> m_BoxMin[3];
+        std::vector<float> m_BoxMax[3];
+        std::vector<float> m_Visible;
+        // level of detail of the grid with a border of one chunk, -1 if not needed
+        std::vector<int32_t>  m_LevelsOfDetail;
+        std::vector<uint32_t> m_HeightSampleCells;
+        std::vector<float>    m_SampleX;
+        std::vector<float>    m_SampleZ;
+        std::vector<float>    m_Heights;
+        // biome weights at the tile centers of the visible chunks
+        std::vector<float> m_BiomeWeights[3];
+        // tile corners of one chunk at height zero & their curved offset per meter of height, tiles inside the view frustum with their
+        // height bounds of each chunk, bit i = tile i
+        std::vector<int2>     m_ChunkGridPositions;
+        std::vector<float3>   m_TileCorners;
+        std::vector<float3>   m_TileCornerUps;
+        std::vector<uint64_t> m_VisibleTiles;
+    };
+}  // namespace meshnode
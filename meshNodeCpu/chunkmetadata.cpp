@@ -0,0 +1,616 @@
+// This file is part of the AMD Work Graph Mesh Node Sample.
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include "chunkmetadata.h"
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
+namespace meshnode
+{
+    static const uint32_t TileCountPerChunk        = TerrainTilesPerChunk * TerrainTilesPerChunk;
+    static const uint32_t DetailedTileCountPerTile = TerrainDetailedTilesPerTile * TerrainDetailedTilesPerTile;
+    // terrain samples of a mountain tile, the detailed tile centers & corners and the tile center
+    static const uint32_t MountainTileSampleCount = 2 * DetailedTileCountPerTile + 1;
+
+    static uint64_t GetChunkKey(const int2& chunkGridPosition)
+    {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(chunkGridPosition.x)) << 32) | static_cast<uint32_t>(chunkGridPosition.y);
+    }
+
+    // rounds towards negative infinity, such that negative tile positions map to the chunk containing them
+    static int32_t FloorDivide(int32_t value, int32_t divisor)
+    {
+        return (value >= 0) ? (value / divisor) : -((-value + divisor - 1) / divisor);
+    }
+
+    static int2 GetTileChunkGridPosition(const int2& tileGridPosition)
+    {
+        const int32_t tilesPerChunk = static_cast<int32_t>(TerrainTilesPerChunk);
+
+        return int2(FloorDivide(tileGridPosition.x, tilesPerChunk), FloorDivide(tileGridPosition.y, tilesPerChunk));
+    }
+
+    // row-major index of the tile within its chunk
+    static uint32_t GetTileIndex(const int2& tileGridPosition, const int2& chunkGridPosition)
+    {
+        const int32_t tilesPerChunk = static_cast<int32_t>(TerrainTilesPerChunk);
+
+        return static_cast<uint32_t>((tileGridPosition.y - chunkGridPosition.y * tilesPerChunk) * tilesPerChunk + (tileGridPosition.x - chunkGridPosition.x * tilesPerChunk));
+    }
+
+    static int2 GetTileGridPosition(const int2& chunkGridPosition, uint32_t tileIndex)
+    {
+        const int32_t tilesPerChunk = static_cast<int32_t>(TerrainTilesPerChunk);
+
+        return int2(chunkGridPosition.x * tilesPerChunk + static_cast<int32_t>(tileIndex % TerrainTilesPerChunk),
+                    chunkGridPosition.y * tilesPerChunk + static_cast<int32_t>(tileIndex / TerrainTilesPerChunk));
+    }
+
+    void ChunkMetadataCacheStats::Add(const ChunkMetadataCacheStats& other)
+    {
+        ChunkLookups += other.ChunkLookups;
+        ChunkMisses += other.ChunkMisses;
+        TileBiomeLookups += other.TileBiomeLookups;
+        TileBiomeMisses += other.TileBiomeMisses;
+        MountainTileLookups += other.MountainTileLookups;
+        MountainTileMisses += other.MountainTileMisses;
+        HeightBoundsLookups += other.HeightBoundsLookups;
+        HeightBoundsMisses += other.HeightBoundsMisses;
+        LevelOfDetailChanges += other.LevelOfDetailChanges;
+        TransitionMaskUpdates += other.TransitionMaskUpdates;
+        DistanceEvictions += other.DistanceEvictions;
+        CapacityEvictions += other.CapacityEvictions;
+        TerrainSampleCount += other.TerrainSampleCount;
+        TimeMs += other.TimeMs;
+    }
+
+    uint64_t ChunkMetadataCacheStats::GetLookupCount() const
+    {
+        return ChunkLookups + TileBiomeLookups + MountainTileLookups + HeightBoundsLookups;
+    }
+
+    uint64_t ChunkMetadataCacheStats::GetMissCount() const
+    {
+        return ChunkMisses + TileBiomeMisses + MountainTileMisses + HeightBoundsMisses;
+    }
+
+    double ChunkMetadataCacheStats::GetHitRate() const
+    {
+        const uint64_t lookupCount = GetLookupCount();
+
+        return (lookupCount > 0) ? static_cast<double>(lookupCount - GetMissCount()) / static_cast<double>(lookupCount) : 1.0;
+    }
+
+    ChunkMetadataCache::ChunkMetadataCache(const ChunkMetadataCacheDesc& desc)
+        : m_Desc(desc)
+    {
+    }
+
+    void ChunkMetadataCache::BeginFrame(const float3& cameraPosition)
+    {
+        m_TotalStats.Add(m_FrameStats);
+
+        m_FrameStats     = {};
+        m_CameraPosition = cameraPosition;
+        ++m_FrameIndex;
+
+        const auto startTime = std::chrono::high_resolution_clock::now();
+
+        Evict();
+
+        m_FrameStats.TimeMs += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+    }
+
+    void ChunkMetadataCache::UpdateChunkRecords(std::vector<ChunkRecord>& chunks)
+    {
+        const auto startTime = std::chrono::high_resolution_clock::now();
+
+        m_UsedChunks.clear();
+        m_RecordChunks.clear();
+
+        // Visible chunks & their neighbors, each chunk is counted once per frame
+        for (const ChunkRecord& record : chunks)
+        {
+            for (const int2& offset : {int2(0, 0), int2(-1, 0), int2(0, -1), int2(1, 0), int2(0, 1)})
+            {
+                bool           created = false;
+                ChunkMetadata& chunk   = Acquire(record.chunkGridPosition + offset, created);
+
+                if (chunk.LevelOfDetailFrame != m_FrameIndex)
+                {
+                    chunk.LevelOfDetailFrame = m_FrameIndex;
+                    m_UsedChunks.push_back(&chunk);
+
+                    ++m_FrameStats.ChunkLookups;
+                    m_FrameStats.ChunkMisses += created ? 1 : 0;
+                }
+
+                if ((offset.x == 0) && (offset.y == 0))
+                {
+                    m_RecordChunks.push_back(&chunk);
+                }
+            }
+        }
+
+        ComputeCenterHeights();
+
+        // Levels of detail are cheap to derive from the cached heights, but only band crossings invalidate transition masks
+        for (ChunkMetadata* pChunk : m_UsedChunks)
+        {
+            const float2  center        = GetTerrainChunkCenter(pChunk->ChunkGridPosition);
+            const int32_t levelOfDetail = GetTerrainChunkLevelOfDetail(m_CameraPosition, float3(center.x, pChunk->CenterHeight, center.y));
+
+            if (levelOfDetail != pChunk->LevelOfDetail)
+            {
+                m_FrameStats.LevelOfDetailChanges += (pChunk->LevelOfDetail >= 0) ? 1 : 0;
+
+                pChunk->LevelOfDetail = levelOfDetail;
+                InvalidateTransitionMasks(pChunk->ChunkGridPosition);
+            }
+        }
+
+        // same neighbor order as DrawTerrainChunkRecord::levelOfDetailTransition
+        const int2 neighbors[4] = {int2(-1, 0), int2(0, -1), int2(1, 0), int2(0, 1)};
+
+        for (ChunkMetadata* pChunk : m_RecordChunks)
+        {
+            if (!pChunk->IsTransitionMaskValid)
+            {
+                pChunk->LevelOfDetailTransitionMask = 0;
+
+                for (uint32_t i = 0; i < 4; ++i)
+                {
+                    if (Find(pChunk->ChunkGridPosition + neighbors[i])->LevelOfDetail > pChunk->LevelOfDetail)
+                    {
+                        pChunk->LevelOfDetailTransitionMask |= 1u << i;
+                    }
+                }
+
+                pChunk->IsTransitionMaskValid = true;
+                ++m_FrameStats.TransitionMaskUpdates;
+            }
+
+            m_FrameStats.TileBiomeLookups += TileCountPerChunk;
+
+            if (!pChunk->HasTileBiomes)
+            {
+                // set before the batch, such that chunks listed twice are only computed once
+                pChunk->HasTileBiomes = true;
+                m_MissingTileBiomes.push_back(pChunk);
+
+                m_FrameStats.TileBiomeMisses += TileCountPerChunk;
+            }
+        }
+
+        ComputeTileBiomes();
+
+        for (size_t i = 0; i < chunks.size(); ++i)
+        {
+            const ChunkMetadata& chunk = *m_RecordChunks[i];
+
+            chunks[i].levelOfDetail               = chunk.LevelOfDetail;
+            chunks[i].levelOfDetailTransitionMask = chunk.LevelOfDetailTransitionMask;
+            chunks[i].tileBiomes = chunk.TileBiomes;
+        }
+
+        m_FrameStats.TimeMs += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+    }
+
+    void ChunkMetadataCache::RequestMountainTileFeatures(const std::vector<int2>& tileGridPositions)
+    {
+        const auto startTime = std::chrono::high_resolution_clock::now();
+
+        for (const int2& tileGridPosition : tileGridPositions)
+        {
+            const int2     chunkGridPosition = GetTileChunkGridPosition(tileGridPosition);
+            const uint32_t tileIndex         = GetTileIndex(tileGridPosition, chunkGridPosition);
+
+            bool           created = false;
+            ChunkMetadata& chunk   = Acquire(chunkGridPosition, created);
+
+            ++m_FrameStats.MountainTileLookups;
+
+            if (((chunk.MountainTileMask >> tileIndex) & 1) == 0)
+            {
+                chunk.MountainTileMask |= uint64_t(1) << tileIndex;
+                m_MissingMountainTiles.emplace_back(&chunk, tileIndex);
+
+                ++m_FrameStats.MountainTileMisses;
+            }
+        }
+
+        ComputeCenterHeights();
+
+        const size_t sampleCount = m_MissingMountainTiles.size() * MountainTileSampleCount;
+
+        m_SampleX.resize(sampleCount);
+        m_SampleZ.resize(sampleCount);
+        for (auto& results : m_SampleResults)
+        {
+            results.resize(sampleCount);
+        }
+
+        for (size_t i = 0; i < m_MissingMountainTiles.size(); ++i)
+        {
+            const int2   tileGridPosition = GetTileGridPosition(m_MissingMountainTiles[i].first->ChunkGridPosition, m_MissingMountainTiles[i].second);
+            const size_t offset           = i * MountainTileSampleCount;
+
+            for (uint32_t j = 0; j < DetailedTileCountPerTile; ++j)
+            {
+                const float2 center = GetTerrainDetailedTileCenter(tileGridPosition, j);
+                const float2 corner = GetTerrainDetailedTileCorner(tileGridPosition, j);
+
+                m_SampleX[offset + j]                            = center.x;
+                m_SampleZ[offset + j]                            = center.y;
+                m_SampleX[offset + DetailedTileCountPerTile + j] = corner.x;
+                m_SampleZ[offset + DetailedTileCountPerTile + j] = corner.y;
+            }
+
+            const float2 tileCenter = GetTerrainTileCenter(tileGridPosition);
+
+            m_SampleX[offset + 2 * DetailedTileCountPerTile] = tileCenter.x;
+            m_SampleZ[offset + 2 * DetailedTileCountPerTile] = tileCenter.y;
+        }
+
+        GetTerrainHeightAndGradientBatch(m_SampleX.data(),
+                                         m_SampleZ.data(),
+                                         m_SampleResults[0].data(),
+                                         m_SampleResults[1].data(),
+                                         m_SampleResults[2].data(),
+                                         sampleCount,
+                                         m_Desc.Isa);
+
+        for (size_t i = 0; i < m_MissingMountainTiles.size(); ++i)
+        {
+            ChunkMetadata& chunk     = *m_MissingMountainTiles[i].first;
+            const uint32_t tileIndex = m_MissingMountainTiles[i].second;
+            const size_t   offset    = i * MountainTileSampleCount;
+
+            // same normal as GetTerrainNormal & GetTerrainSample, at the detailed tile corners
+            float normalsY[DetailedTileCountPerTile];
+            for (uint32_t j = 0; j < DetailedTileCountPerTile; ++j)
+            {
+                const size_t cornerIndex = offset + DetailedTileCountPerTile + j;
+
+                normalsY[j] = normalize(float3(-m_SampleResults[1][cornerIndex], 1.f, -m_SampleResults[2][cornerIndex])).y;
+            }
+
+            const MountainTileFeatures features = ComputeMountainTileFeatures(GetTileGridPosition(chunk.ChunkGridPosition, tileIndex),
+                                                                              m_SampleResults[0][offset + 2 * DetailedTileCountPerTile],
+                                                                              &m_SampleResults[0][offset],
+                                                                              normalsY);
+
+            chunk.TreeCounts[tileIndex] = static_cast<uint8_t>(features.TreeCount);
+            chunk.RockMasks[tileIndex]  = features.RockMask;
+        }
+
+        m_FrameStats.TerrainSampleCount += sampleCount;
+        m_MissingMountainTiles.clear();
+
+        m_FrameStats.TimeMs += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+    }
+
+    const std::vector<const ChunkMetadata*>& ChunkMetadataCache::RequestHeightBounds(const std::vector<int2>& chunkGridPositions)
+    {
+        const auto startTime = std::chrono::high_resolution_clock::now();
+
+        // samples per chunk edge, the samples on tile edges are shared by both tiles
+        const uint32_t samplesPerTile  = static_cast<uint32_t>(TerrainChunkSize / TerrainTilesPerChunk / HeightBoundsSpacing);
+        const uint32_t samplesPerEdge  = TerrainTilesPerChunk * samplesPerTile + 1;
+        const size_t   samplesPerChunk = static_cast<size_t>(samplesPerEdge) * samplesPerEdge;
+
+        m_RequestedChunks.clear();
+
+        for (const int2& chunkGridPosition : chunkGridPositions)
+        {
+            bool           created = false;
+            ChunkMetadata& chunk   = Acquire(chunkGridPosition, created);
+
+            ++m_FrameStats.HeightBoundsLookups;
+
+            if (!chunk.HasHeightBounds)
+            {
+                chunk.HasHeightBounds = true;
+                m_MissingHeightBounds.push_back(&chunk);
+
+                ++m_FrameStats.HeightBoundsMisses;
+            }
+
+            m_RequestedChunks.push_back(&chunk);
+        }
+
+        ComputeCenterHeights();
+
+        const size_t sampleCount = m_MissingHeightBounds.size() * samplesPerChunk;
+
+        m_SampleX.resize(sampleCount);
+        m_SampleZ.resize(sampleCount);
+        m_SampleResults[0].resize(sampleCount);
+
+        for (size_t i = 0; i < m_MissingHeightBounds.size(); ++i)
+        {
+            const int2   chunkGridPosition  = m_MissingHeightBounds[i]->ChunkGridPosition;
+            const float2 chunkWorldPosition = float2(static_cast<float>(chunkGridPosition.x), static_cast<float>(chunkGridPosition.y)) * TerrainChunkSize;
+
+            for (uint32_t y = 0; y < samplesPerEdge; ++y)
+            {
+                for (uint32_t x = 0; x < samplesPerEdge; ++x)
+                {
+                    const size_t sample = i * samplesPerChunk + y * samplesPerEdge + x;
+
+                    m_SampleX[sample] = chunkWorldPosition.x + x * HeightBoundsSpacing;
+                    m_SampleZ[sample] = chunkWorldPosition.y + y * HeightBoundsSpacing;
+                }
+            }
+        }
+
+        GetTerrainHeightBatch(m_SampleX.data(), m_SampleZ.data(), m_SampleResults[0].data(), sampleCount, m_Desc.Isa);
+
+        for (size_t i = 0; i < m_MissingHeightBounds.size(); ++i)
+        {
+            ChunkMetadata& chunk   = *m_MissingHeightBounds[i];
+            const float*   heights = &m_SampleResults[0][i * samplesPerChunk];
+
+            chunk.MinHeight = std::numeric_limits<float>::max();
+            chunk.MaxHeight = -std::numeric_limits<float>::max();
+
+            for (uint32_t tile = 0; tile < TileCountPerChunk; ++tile)
+            {
+                const uint32_t tileX = (tile % TerrainTilesPerChunk) * samplesPerTile;
+                const uint32_t tileY = (tile / TerrainTilesPerChunk) * samplesPerTile;
+
+                float minHeight = std::numeric_limits<float>::max();
+                float maxHeight = -std::numeric_limits<float>::max();
+
+                for (uint32_t y = tileY; y <= tileY + samplesPerTile; ++y)
+                {
+                    for (uint32_t x = tileX; x <= tileX + samplesPerTile; ++x)
+                    {
+                        minHeight = std::min(minHeight, heights[y * samplesPerEdge + x]);
+                        maxHeight = std::max(maxHeight, heights[y * samplesPerEdge + x]);
+                    }
+                }
+
+                chunk.TileMinHeights[tile] = minHeight;
+                chunk.TileMaxHeights[tile] = maxHeight;
+                chunk.MinHeight            = std::min(chunk.MinHeight, minHeight);
+                chunk.MaxHeight            = std::max(chunk.MaxHeight, maxHeight);
+            }
+        }
+
+        m_FrameStats.TerrainSampleCount += sampleCount;
+        m_MissingHeightBounds.clear();
+
+        m_FrameStats.TimeMs += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+
+        return m_RequestedChunks;
+    }
+
+    bool ChunkMetadataCache::FindMountainTileFeatures(const int2& tileGridPosition, MountainTileFeatures& outFeatures) const
+    {
+        const int2 chunkGridPosition = GetTileChunkGridPosition(tileGridPosition);
+        const auto it                = m_Chunks.find(GetChunkKey(chunkGridPosition));
+
+        if (it == m_Chunks.end())
+        {
+            return false;
+        }
+
+        const ChunkMetadata& chunk     = it->second;
+        const uint32_t       tileIndex = GetTileIndex(tileGridPosition, chunkGridPosition);
+
+        if (((chunk.MountainTileMask >> tileIndex) & 1) == 0)
+        {
+            return false;
+        }
+
+        outFeatures.TreeCount = chunk.TreeCounts[tileIndex];
+        outFeatures.RockMask  = chunk.RockMasks[tileIndex];
+
+        return true;
+    }
+
+    void ChunkMetadataCache::Clear()
+    {
+        m_Chunks.clear();
+    }
+
+    size_t ChunkMetadataCache::GetEntryCount() const
+    {
+        return m_Chunks.size();
+    }
+
+    const ChunkMetadataCacheStats& ChunkMetadataCache::GetFrameStats() const
+    {
+        return m_FrameStats;
+    }
+
+    ChunkMetadataCacheStats ChunkMetadataCache::GetTotalStats() const
+    {
+        ChunkMetadataCacheStats result = m_TotalStats;
+        result.Add(m_FrameStats);
+
+        return result;
+    }
+
+    void ChunkMetadataCache::SetTerrainKernelIsa(TerrainKernelIsa isa)
+    {
+        m_Desc.Isa = isa;
+    }
+
+    ChunkMetadata* ChunkMetadataCache::Find(const int2& chunkGridPosition)
+    {
+        const auto it = m_Chunks.find(GetChunkKey(chunkGridPosition));
+
+        return (it != m_Chunks.end()) ? &it->second : nullptr;
+    }
+
+    ChunkMetadata& ChunkMetadataCache::Acquire(const int2& chunkGridPosition, bool& outCreated)
+    {
+        // element pointers stay valid on rehash, thus chunks can be referenced until the next eviction
+        const auto     result = m_Chunks.try_emplace(GetChunkKey(chunkGridPosition));
+        ChunkMetadata& chunk  = result.first->second;
+
+        if (result.second)
+        {
+            chunk.ChunkGridPosition = chunkGridPosition;
+            m_MissingHeights.push_back(&chunk);
+        }
+
+        chunk.LastUsedFrame = m_FrameIndex;
+        outCreated          = result.second;
+
+        return chunk;
+    }
+
+    void ChunkMetadataCache::ComputeCenterHeights()
+    {
+        const size_t sampleCount = m_MissingHeights.size();
+
+        m_SampleX.resize(sampleCount);
+        m_SampleZ.resize(sampleCount);
+        m_SampleResults[0].resize(sampleCount);
+
+        for (size_t i = 0; i < sampleCount; ++i)
+        {
+            const float2 center = GetTerrainChunkCenter(m_MissingHeights[i]->ChunkGridPosition);
+
+            m_SampleX[i] = center.x;
+            m_SampleZ[i] = center.y;
+        }
+
+        GetTerrainHeightBatch(m_SampleX.data(), m_SampleZ.data(), m_SampleResults[0].data(), sampleCount, m_Desc.Isa);
+
+        for (size_t i = 0; i < sampleCount; ++i)
+        {
+            m_MissingHeights[i]->CenterHeight = m_SampleResults[0][i];
+        }
+
+        m_FrameStats.TerrainSampleCount += sampleCount;
+        m_MissingHeights.clear();
+    }
+
+    void ChunkMetadataCache::InvalidateTransitionMasks(const int2& chunkGridPosition)
+    {
+        // the transition mask of a chunk depends on its own level of detail & those of its four neighbors
+        for (const int2& offset : {int2(0, 0), int2(-1, 0), int2(0, -1), int2(1, 0), int2(0, 1)})
+        {
+            if (ChunkMetadata* pChunk = Find(chunkGridPosition + offset))
+            {
+                pChunk->IsTransitionMaskValid = false;
+            }
+        }
+    }
+
+    void ChunkMetadataCache::ComputeTileBiomes()
+    {
+        const size_t sampleCount = m_MissingTileBiomes.size() * TileCountPerChunk;
+
+        m_SampleX.resize(sampleCount);
+        m_SampleZ.resize(sampleCount);
+        for (auto& results : m_SampleResults)
+        {
+            results.resize(sampleCount);
+        }
+
+        for (size_t i = 0; i < m_MissingTileBiomes.size(); ++i)
+        {
+            const int2 chunkGridPosition = m_MissingTileBiomes[i]->ChunkGridPosition;
+
+            for (uint32_t j = 0; j < TileCountPerChunk; ++j)
+            {
+                const float2 center = GetTerrainTileCenter(GetTileGridPosition(chunkGridPosition, j));
+
+                m_SampleX[i * TileCountPerChunk + j] = center.x;
+                m_SampleZ[i * TileCountPerChunk + j] = center.y;
+            }
+        }
+
+        GetBiomeWeightsBatch(m_SampleX.data(),
+                             m_SampleZ.data(),
+                             m_SampleResults[0].data(),
+                             m_SampleResults[1].data(),
+                             m_SampleResults[2].data(),
+                             sampleCount,
+                             m_Desc.Isa);
+
+        for (size_t i = 0; i < m_MissingTileBiomes.size(); ++i)
+        {
+            ChunkMetadata& chunk = *m_MissingTileBiomes[i];
+
+            for (uint32_t j = 0; j < TileCountPerChunk; ++j)
+            {
+                const size_t sample = i * TileCountPerChunk + j;
+                const float3 biomeWeights(m_SampleResults[0][sample], m_SampleResults[1][sample], m_SampleResults[2][sample]);
+
+                SetChunkTileBiome(chunk.TileBiomes, j, GetDominantBiome(biomeWeights));
+            }
+        }
+
+        m_FrameStats.TerrainSampleCount += sampleCount;
+        m_MissingTileBiomes.clear();
+    }
+
+    void ChunkMetadataCache::Evict()
+    {
+        const float2 cameraPosition = float2(m_CameraPosition.x, m_CameraPosition.z);
+
+        // Distance: chunks far behind the camera, which were not used in the previous frame
+        for (auto it = m_Chunks.begin(); it != m_Chunks.end();)
+        {
+            const ChunkMetadata& chunk = it->second;
+
+            if (((chunk.LastUsedFrame + 1) < m_FrameIndex) && (length(GetTerrainChunkCenter(chunk.ChunkGridPosition) - cameraPosition) > m_Desc.EvictionDistance))
+            {
+                it = m_Chunks.erase(it);
+                ++m_FrameStats.DistanceEvictions;
+            }
+            else
+            {
+                ++it;
+            }
+        }
+
+        // Least recently used chunks above the capacity
+        if (m_Chunks.size() > m_Desc.Capacity)
+        {
+            const size_t evictionCount = m_Chunks.size() - m_Desc.Capacity;
+
+            m_EvictionOrder.clear();
+            for (const auto& entry : m_Chunks)
+            {
+                m_EvictionOrder.emplace_back(entry.second.LastUsedFrame, entry.first);
+            }
+
+            std::nth_element(m_EvictionOrder.begin(), m_EvictionOrder.begin() + evictionCount, m_EvictionOrder.end());
+
+            for (size_t i = 0; i < evictionCount; ++i)
+            {
+                m_Chunks.erase(m_EvictionOrder[i].second);
+            }
+
+            m_FrameStats.CapacityEvictions += evictionCount;
+        }
+    }
+}  // namespace meshnode
@@ -0,0 +1,193 @@
+// This file is part of the AMD Work Graph Mesh Node Sample.
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+
+#include "terrain.h"
+#include "worldgraph.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// Persistent cache of per-chunk & per-tile terrain metadata, keyed by the chunk grid position.
+// Chunk center heights, tile biomes, tile height bounds and mountain tile features only depend on the analytic terrain functions, i.e. never go stale,
+// and are computed once when a chunk is first requested. The camera dependent levels of detail are re-derived from the cached heights
+// every frame, transition masks are only recomputed if the level of detail of the chunk or one of its neighbors crossed a band.
+// Entries are evicted by distance to the camera and, above the capacity, in least recently used order.
+namespace meshnode
+{
+    struct ChunkMetadataCacheDesc
+    {
+        // maximum number of cached chunks, ~1.2 KiB each
+        uint32_t Capacity = 4096;
+        // chunks farther than this from the camera are evicted once they were not used in the previous frame
+        float EvictionDistance = 2500.f;
+        // instruction set used for cache misses
+        TerrainKernelIsa Isa = TerrainKernelIsa::Auto;
+    };
+
+    /**
+     * Cache telemetry, per frame or accumulated since construction.
+     */
+    struct ChunkMetadataCacheStats
+    {
+        // chunk center heights of visible chunks & their neighbors, a miss samples the terrain height
+        uint64_t ChunkLookups = 0;
+        uint64_t ChunkMisses  = 0;
+        // dominant biomes of the tiles of visible chunks, a miss samples the biome weights of all tiles of the chunk
+        uint64_t TileBiomeLookups = 0;
+        uint64_t TileBiomeMisses  = 0;
+        // tree clusters & rocks of mountain tiles, a miss samples the terrain at the tile center & the detailed tile centers & corners
+        uint64_t MountainTileLookups = 0;
+        uint64_t MountainTileMisses  = 0;
+        // tile & chunk height bounds for the height bounds & horizon culling, a miss samples the terrain on a grid over the chunk
+        uint64_t HeightBoundsLookups = 0;
+        uint64_t HeightBoundsMisses  = 0;
+        // level of detail band crossings of cached chunks & the resulting transition mask updates
+        uint64_t LevelOfDetailChanges  = 0;
+        uint64_t TransitionMaskUpdates = 0;
+        uint64_t DistanceEvictions     = 0;
+        uint64_t CapacityEvictions     = 0;
+        // terrain samples taken for cache misses
+        uint64_t TerrainSampleCount = 0;
+        double   TimeMs             = 0.0;
+
+        void     Add(const ChunkMetadataCacheStats& other);
+        uint64_t GetLookupCount() const;
+        uint64_t GetMissCount() const;
+        // hits / lookups over all lookup kinds, 1 if there were no lookups
+        double GetHitRate() const;
+    };
+
+    /**
+     * Cached metadata of one chunk.
+     */
+    struct ChunkMetadata
+    {
+        int2 ChunkGridPosition;
+        // terrain height at GetTerrainChunkCenter
+        float CenterHeight = 0.f;
+        // level of detail for the camera of the last frame the chunk was visible or a neighbor of a visible chunk, -1 if not computed yet
+        int32_t LevelOfDetail = -1;
+        // valid until the level of detail of the chunk or one of its neighbors changes
+        uint32_t LevelOfDetailTransitionMask = 0;
+        bool     IsTransitionMaskValid       = false;
+        bool     HasTileBiomes               = false;
+        // see ChunkRecord::tileBiomes
+        uint4 TileBiomes;
+        // bit i is set if the features of tile i (row-major) are cached
+        uint64_t MountainTileMask = 0;
+        uint8_t  TreeCounts[TerrainTilesPerChunk * TerrainTilesPerChunk] = {};
+        uint64_t RockMasks[TerrainTilesPerChunk * TerrainTilesPerChunk]  = {};
+        // terrain height range of each tile (row-major) & of the whole chunk, see ChunkMetadataCache::RequestHeightBounds
+        bool  HasHeightBounds = false;
+        float TileMinHeights[TerrainTilesPerChunk * TerrainTilesPerChunk] = {};
+        float TileMaxHeights[TerrainTilesPerChunk * TerrainTilesPerChunk] = {};
+        float MinHeight                                                   = 0.f;
+        float MaxHeight                                                   = 0.f;
+        // frame indices for the eviction & to count lookups once per frame
+        uint64_t LastUsedFrame      = 0;
+        uint64_t LevelOfDetailFrame = 0;
+    };
+
+    /**
+     * Not thread-safe, except for concurrent FindMountainTileFeatures calls.
+     * Call BeginFrame once per frame before ChunkCuller::Cull & WorldGraphEmulator::Execute.
+     */
+    class ChunkMetadataCache
+    {
+    public:
+        explicit ChunkMetadataCache(const ChunkMetadataCacheDesc& desc = {});
+
+        /**
+         * @brief   Start a new frame, evicts chunks & resets the frame stats.
+         */
+        void BeginFrame(const float3& cameraPosition);
+
+        /**
+         * @brief   Fill the level of detail, transition mask & tile biomes of the chunk records from the cache, see ChunkCuller.
+         *          The values are bit-identical to the Chunk records computed with the analytic terrain functions.
+         */
+        void UpdateChunkRecords(std::vector<ChunkRecord>& chunks);
+
+        /**
+         * @brief   Compute the terrain height range of the tiles of the chunks missing in the cache, in one batch.
+         *          Heights are sampled on a grid with HeightBoundsSpacing, which matches the terrain mesh vertices from level of detail 1 onwards.
+         *          Returns the chunks in the order of chunkGridPositions, pointers are valid until the next BeginFrame.
+         */
+        const std::vector<const ChunkMetadata*>& RequestHeightBounds(const std::vector<int2>& chunkGridPositions);
+
+        /**
+         * @brief   Compute the tree clusters & rocks of mountain tiles missing in the cache, in one batch.
+         */
+        void RequestMountainTileFeatures(const std::vector<int2>& tileGridPositions);
+        /**
+         * @brief   Returns false if the tile was not requested, i.e. is not cached.
+         */
+        bool FindMountainTileFeatures(const int2& tileGridPosition, MountainTileFeatures& outFeatures) const;
+
+        void Clear();
+
+        // spacing of the height samples for the tile height bounds
+        static constexpr float HeightBoundsSpacing = 8.f;
+
+        size_t                         GetEntryCount() const;
+        const ChunkMetadataCacheStats& GetFrameStats() const;
+        ChunkMetadataCacheStats        GetTotalStats() const;
+
+        void SetTerrainKernelIsa(TerrainKernelIsa isa);
+
+    private:
+        ChunkMetadata* Find(const int2& chunkGridPosition);
+        // returns the entry of the chunk & marks it as used, new entries are queued for ComputeCenterHeights
+        ChunkMetadata& Acquire(const int2& chunkGridPosition, bool& outCreated);
+        void           ComputeCenterHeights();
+        void           InvalidateTransitionMasks(const int2& chunkGridPosition);
+        void           ComputeTileBiomes();
+        void           Evict();
+
+        ChunkMetadataCacheDesc                      m_Desc;
+        std::unordered_map<uint64_t, ChunkMetadata> m_Chunks;
+        float3                                      m_CameraPosition;
+        uint64_t                                    m_FrameIndex = 0;
+        ChunkMetadataCacheStats                     m_FrameStats;
+        // stats of all previous frames
+        ChunkMetadataCacheStats m_TotalStats;
+
+        // Scratch memory, kept across frames
+        // chunks without center height, tile biomes or mountain tile features, computed in one batch each
+        std::vector<ChunkMetadata*>                      m_MissingHeights;
+        std::vector<ChunkMetadata*>                      m_MissingTileBiomes;
+        std::vector<std::pair<ChunkMetadata*, uint32_t>> m_MissingMountainTiles;
+        std::vector<ChunkMetadata*>                      m_MissingHeightBounds;
+        std::vector<const ChunkMetadata*>                m_RequestedChunks;
+        // chunks used by UpdateChunkRecords & the chunk of each record
+        std::vector<ChunkMetadata*> m_UsedChunks;
+        std::vector<ChunkMetadata*> m_RecordChunks;
+        std::vector<float>          m_SampleX;
+        std::vector<float>          m_SampleZ;
+        std::vector<float>          m_SampleResults[3];
+        // least recently used order, last used frame & key
+        std::vector<std::pair<uint64_t, uint64_t>> m_EvictionOrder;
+    };
+}  // namespace meshnode
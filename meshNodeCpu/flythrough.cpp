@@ -0,0 +1,225 @@
+// This file is part of the AMD Work Graph Mesh Node Sample.
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "flythrough.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+
+namespace meshnode
+{
+    static const uint32_t FlythroughMagic   = 0x54464E4D;  // "MNFT"
+    static const uint32_t FlythroughVersion = 1;
+
+    bool SaveFlythrough(const std::filesystem::path& path, const std::vector<FlythroughFrame>& frames)
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file)
+        {
+            return false;
+        }
+
+        const uint32_t header[] = {FlythroughMagic, FlythroughVersion, static_cast<uint32_t>(frames.size()), sizeof(FlythroughFrame)};
+
+        file.write(reinterpret_cast<const char*>(header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(frames.data()), frames.size() * sizeof(FlythroughFrame));
+        file.close();
+
+        return !file.fail();
+    }
+
+    bool LoadFlythrough(const std::filesystem::path& path, std::vector<FlythroughFrame>& frames)
+    {
+        std::ifstream file(path, std::ios::binary);
+        if (!file)
+        {
+            return false;
+        }
+
+        uint32_t header[4] = {};
+        if (!file.read(reinterpret_cast<char*>(header), sizeof(header)) || (header[0] != FlythroughMagic) || (header[1] != FlythroughVersion) ||
+            (header[3] != sizeof(FlythroughFrame)))
+        {
+            return false;
+        }
+
+        frames.resize(header[2]);
+
+        return static_cast<bool>(file.read(reinterpret_cast<char*>(frames.data()), frames.size() * sizeof(FlythroughFrame)));
+    }
+
+    static float3 CatmullRom(const float3& p0, const float3& p1, const float3& p2, const float3& p3, float t)
+    {
+        const float t2 = t * t;
+        const float t3 = t2 * t;
+
+        return 0.5f * ((2.f * p1) + (p2 - p0) * t + (2.f * p0 - 5.f * p1 + 4.f * p2 - p3) * t2 + (3.f * p1 - p0 - 3.f * p2 + p3) * t3);
+    }
+
+    static float Lerp(float a, float b, float t)
+    {
+        return a + (b - a) * t;
+    }
+
+    std::vector<FlythroughFrame> SampleFlythroughPath(const std::vector<FlythroughKey>& keys, float timeStep)
+    {
+        std::vector<FlythroughFrame> frames;
+
+        if (keys.empty() || !(timeStep > 0.f))
+        {
+            return frames;
+        }
+
+        const double startTime = keys.front().Time;
+        const double duration  = std::max(keys.back().Time - startTime, 0.0);
+        // time of frame i is computed as i * timeStep, such that rounding does not accumulate over long paths.
+        // The last frame is kept if it is within a thousandth of a time step of the last key.
+        const size_t frameCount = static_cast<size_t>(std::floor(duration / timeStep + 1e-3)) + 1;
+
+        frames.reserve(frameCount);
+
+        size_t segment = 0;
+        for (size_t i = 0; i < frameCount; ++i)
+        {
+            const float time = static_cast<float>(startTime + i * static_cast<double>(timeStep));
+
+            while ((segment + 2 < keys.size()) && (time >= keys[segment + 1].Time))
+            {
+                ++segment;
+            }
+
+            const FlythroughKey& k0 = keys[(segment > 0) ? segment - 1 : 0];
+            const FlythroughKey& k1 = keys[segment];
+            const FlythroughKey& k2 = keys[std::min(segment + 1, keys.size() - 1)];
+            const FlythroughKey& k3 = keys[std::min(segment + 2, keys.size() - 1)];
+
+            const float segmentDuration = k2.Time - k1.Time;
+            const float t               = (segmentDuration > 0.f) ? std::min(std::max((time - k1.Time) / segmentDuration, 0.f), 1.f) : 0.f;
+
+            FlythroughFrame frame = {};
+            frame.Position        = CatmullRom(k0.Position, k1.Position, k2.Position, k3.Position, t);
+            frame.Yaw             = Lerp(k1.Yaw, k2.Yaw, t);
+            frame.Pitch           = Lerp(k1.Pitch, k2.Pitch, t);
+            frame.WindStrength    = Lerp(k1.WindStrength, k2.WindStrength, t);
+            frame.WindDirection   = Lerp(k1.WindDirection, k2.WindDirection, t);
+            frame.DeltaTime       = timeStep;
+
+            frames.push_back(frame);
+        }
+
+        return frames;
+    }
+
+    // integers, e.g. record counts & hashes, are written with all digits, other values with enough digits to round-trip timings
+    static void WriteValue(std::ofstream& file, double value)
+    {
+        if ((value == std::floor(value)) && (std::abs(value) < 9007199254740992.0))
+        {
+            file << static_cast<int64_t>(value);
+        }
+        else
+        {
+            file << value;
+        }
+    }
+
+    FlythroughStats::FlythroughStats(const std::vector<std::string>& columns)
+        : m_Columns(columns)
+    {
+    }
+
+    void FlythroughStats::AddFrame(const std::vector<double>& values)
+    {
+        // missing values are reported as 0
+        for (size_t column = 0; column < m_Columns.size(); ++column)
+        {
+            m_Values.push_back((column < values.size()) ? values[column] : 0.0);
+        }
+    }
+
+    double FlythroughStats::GetAverage(size_t column) const
+    {
+        const size_t frameCount = GetFrameCount();
+
+        double sum = 0.0;
+        for (size_t frame = 0; frame < frameCount; ++frame)
+        {
+            sum += GetValue(frame, column);
+        }
+
+        return (frameCount > 0) ? sum / frameCount : 0.0;
+    }
+
+    bool FlythroughStats::Write(const std::filesystem::path& path) const
+    {
+        std::ofstream file(path, std::ios::trunc);
+        if (!file)
+        {
+            return false;
+        }
+
+        file << std::setprecision(9);
+
+        const size_t frameCount = GetFrameCount();
+
+        if (path.extension() == ".json")
+        {
+            file << "{\n  \"Frames\": [\n";
+
+            for (size_t frame = 0; frame < frameCount; ++frame)
+            {
+                file << "    {";
+                for (size_t column = 0; column < m_Columns.size(); ++column)
+                {
+                    file << ((column > 0) ? ", " : "") << '"' << m_Columns[column] << "\": ";
+                    WriteValue(file, GetValue(frame, column));
+                }
+                file << "}" << ((frame + 1 < frameCount) ? "," : "") << "\n";
+            }
+
+            file << "  ]\n}\n";
+        }
+        else
+        {
+            for (size_t column = 0; column < m_Columns.size(); ++column)
+            {
+                file << ((column > 0) ? "," : "") << m_Columns[column];
+            }
+            file << "\n";
+
+            for (size_t frame = 0; frame < frameCount; ++frame)
+            {
+                for (size_t column = 0; column < m_Columns.size(); ++column)
+                {
+                    file << ((column > 0) ? "," : "");
+                    WriteValue(file, GetValue(frame, column));
+                }
+                file << "\n";
+            }
+        }
+
+        file.close();
+
+        return !file.fail();
+    }
+}  // namespace meshnode
@@ -0,0 +1,110 @@
+// This file is part of the AMD Work Graph Mesh Node Sample.
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+
+#include "hlslmath.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+// Camera flythroughs for deterministic benchmarks.
+// A flythrough is a sequence of frames, either recorded in the sample or sampled from a key frame path with a fixed time step.
+// It can be played back in the sample or headless with the WorldGraphEmulator, such that two builds see identical frames.
+namespace meshnode
+{
+    /**
+     * Camera pose, wind settings & time step of a single frame.
+     * Yaw & pitch are defined as in MeshNodeSampleCameraComponent, the wind direction is in degrees as in the sample UI.
+     */
+    struct FlythroughFrame
+    {
+        float3 Position;
+        float  Yaw           = 0.f;
+        float  Pitch         = 0.f;
+        float  WindStrength  = 1.f;
+        float  WindDirection = 0.f;
+        float  DeltaTime     = 0.f;
+    };
+
+    /**
+     * Key frame of a flythrough path at Time seconds.
+     * Positions are interpolated with a Catmull-Rom spline through all keys, all other values linearly.
+     */
+    struct FlythroughKey
+    {
+        float  Time = 0.f;
+        float3 Position;
+        float  Yaw           = 0.f;
+        float  Pitch         = 0.f;
+        float  WindStrength  = 1.f;
+        float  WindDirection = 0.f;
+    };
+
+    /**
+     * @brief   Write frames to a flythrough file: "MNFT", version, frame count & frame size (uint32 each), followed by the frames.
+     */
+    bool SaveFlythrough(const std::filesystem::path& path, const std::vector<FlythroughFrame>& frames);
+
+    /**
+     * @brief   Read frames from a file written by SaveFlythrough. Returns false if the file could not be read or has a different version.
+     */
+    bool LoadFlythrough(const std::filesystem::path& path, std::vector<FlythroughFrame>& frames);
+
+    /**
+     * @brief   Sample a path every timeStep seconds, from the first to the last key. Keys must be sorted by time.
+     *          All frames use timeStep as DeltaTime.
+     */
+    std::vector<FlythroughFrame> SampleFlythroughPath(const std::vector<FlythroughKey>& keys, float timeStep);
+
+    /**
+     * Per-frame statistics of a flythrough playback, e.g. frame time, markers & record counts.
+     */
+    class FlythroughStats
+    {
+    public:
+        explicit FlythroughStats(const std::vector<std::string>& columns);
+
+        /**
+         * @brief   Add the values of a frame, one per column.
+         */
+        void AddFrame(const std::vector<double>& values);
+
+        const std::vector<std::string>& GetColumns() const { return m_Columns; }
+        size_t                          GetFrameCount() const { return m_Columns.empty() ? 0 : m_Values.size() / m_Columns.size(); }
+        double                          GetValue(size_t frame, size_t column) const { return m_Values[frame * m_Columns.size() + column]; }
+        double                          GetAverage(size_t column) const;
+
+        /**
+         * @brief   Write all frames as JSON if path has a .json extension, as CSV otherwise.
+         *          JSON files contain a "Frames" array with one object per frame, keyed by column name.
+         */
+        bool Write(const std::filesystem::path& path) const;
+
+    private:
+        std::vector<std::string> m_Columns;
+        // frame-major
+        std::vector<double> m_Values;
+    };
+}  // namespace meshnode
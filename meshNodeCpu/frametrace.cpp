@@ -0,0 +1,350 @@
+// This file is part of the AMD Work Graph Mesh Node Sample.
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "frametrace.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <type_traits>
+
+namespace meshnode
+{
+    // process id of all events, tracks are threads of this process
+    static const uint32_t FrameTraceProcessId = 1;
+
+    static const char* GetTrackName(FrameTraceTrack track)
+    {
+        switch (track)
+        {
+        case FrameTraceTrack::Frames:
+            return "Frames";
+        case FrameTraceTrack::Cpu:
+            return "CPU";
+        case FrameTraceTrack::Gpu:
+            return "GPU";
+        }
+
+        return "";
+    }
+
+    FrameTraceWriter::FrameTraceWriter(size_t bufferSize)
+        // reserves room for the largest single write, see Write
+        : m_Buffer(std::max<size_t>(bufferSize, 4096))
+    {
+    }
+
+    FrameTraceWriter::~FrameTraceWriter()
+    {
+        Close();
+    }
+
+    bool FrameTraceWriter::Open(const std::filesystem::path&                            path,
+                                const char*                                             processName,
+                                const std::vector<std::pair<std::string, std::string>>& metadata)
+    {
+        Close();
+
+        m_File.open(path, std::ios::binary | std::ios::trunc);
+        if (!m_File)
+        {
+            return false;
+        }
+
+        m_BufferSize  = 0;
+        m_HasEvents   = false;
+        m_InFrame     = false;
+        m_WriteFailed = false;
+        m_Stats       = {};
+
+        Write("{\"displayTimeUnit\":\"ms\",\"otherData\":{");
+        for (size_t i = 0; i < metadata.size(); ++i)
+        {
+            Write((i > 0) ? "," : "");
+            WriteString(metadata[i].first.c_str());
+            Write(":");
+            WriteString(metadata[i].second.c_str());
+        }
+        Write("},\"traceEvents\":[\n");
+
+        BeginEvent();
+        Write("{\"ph\":\"M\",\"name\":\"process_name\",\"pid\":1,\"tid\":0,\"args\":{\"name\":");
+        WriteString(processName);
+        Write("}}");
+
+        for (const FrameTraceTrack track : {FrameTraceTrack::Frames, FrameTraceTrack::Cpu, FrameTraceTrack::Gpu})
+        {
+            char prefix[128];
+            snprintf(prefix, sizeof(prefix), "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":%u,\"tid\":%u,\"args\":{\"name\":", FrameTraceProcessId, static_cast<uint32_t>(track));
+
+            BeginEvent();
+            Write(prefix);
+            WriteString(GetTrackName(track));
+            Write("}}");
+
+            // keep the tracks in this order instead of sorting them by name
+            snprintf(prefix, sizeof(prefix), "{\"ph\":\"M\",\"name\":\"thread_sort_index\",\"pid\":%u,\"tid\":%u,\"args\":{\"sort_index\":%u}}", FrameTraceProcessId, static_cast<uint32_t>(track), static_cast<uint32_t>(track));
+
+            BeginEvent();
+            Write(prefix);
+        }
+
+        return !m_WriteFailed;
+    }
+
+    bool FrameTraceWriter::IsOpen() const
+    {
+        return m_File.is_open();
+    }
+
+    void FrameTraceWriter::BeginFrame(uint64_t frameIndex, double timeUs, const FrameTraceArg* pArgs, size_t argCount)
+    {
+        if (!IsOpen())
+        {
+            return;
+        }
+
+        if (m_InFrame)
+        {
+            EndFrame(timeUs);
+        }
+
+        BeginEvent();
+        Write("{\"ph\":\"B\",\"name\":\"Frame\",\"pid\":1,\"tid\":1,\"ts\":");
+        WriteNumber("%.3f", timeUs);
+        Write(",\"args\":{\"Frame\":");
+        WriteNumber("%.0f", static_cast<double>(frameIndex));
+        WriteArgs(pArgs, argCount);
+        Write("}}");
+
+        m_InFrame = true;
+    }
+
+    void FrameTraceWriter::EndFrame(double timeUs)
+    {
+        if (!IsOpen() || !m_InFrame)
+        {
+            return;
+        }
+
+        BeginEvent();
+        Write("{\"ph\":\"E\",\"pid\":1,\"tid\":1,\"ts\":");
+        WriteNumber("%.3f", timeUs);
+        Write("}");
+
+        m_InFrame = false;
+        ++m_Stats.FrameCount;
+    }
+
+    bool FrameTraceWriter::IsInFrame() const
+    {
+        return m_InFrame;
+    }
+
+    void FrameTraceWriter::AddEvent(FrameTraceTrack track, const char* name, double startUs, double durationUs, const FrameTraceArg* pArgs, size_t argCount)
+    {
+        AddEvent<char>(track, name, startUs, durationUs, pArgs, argCount);
+    }
+
+    void FrameTraceWriter::AddEvent(FrameTraceTrack track, const wchar_t* name, double startUs, double durationUs, const FrameTraceArg* pArgs, size_t argCount)
+    {
+        AddEvent<wchar_t>(track, name, startUs, durationUs, pArgs, argCount);
+    }
+
+    template <typename Char>
+    void FrameTraceWriter::AddEvent(FrameTraceTrack track, const Char* name, double startUs, double durationUs, const FrameTraceArg* pArgs, size_t argCount)
+    {
+        if (!IsOpen())
+        {
+            return;
+        }
+
+        char prefix[64];
+        snprintf(prefix, sizeof(prefix), "{\"ph\":\"X\",\"pid\":%u,\"tid\":%u,\"name\":", FrameTraceProcessId, static_cast<uint32_t>(track));
+
+        BeginEvent();
+        Write(prefix);
+        WriteString(name);
+        Write(",\"ts\":");
+        WriteNumber("%.3f", startUs);
+        Write(",\"dur\":");
+        WriteNumber("%.3f", durationUs);
+        if (argCount > 0)
+        {
+            Write(",\"args\":{");
+            WriteString(pArgs[0].Name);
+            Write(":");
+            WriteNumber("%.9g", pArgs[0].Value);
+            WriteArgs(pArgs + 1, argCount - 1);
+            Write("}");
+        }
+        Write("}");
+    }
+
+    void FrameTraceWriter::AddCounter(const char* name, double timeUs, double value)
+    {
+        if (!IsOpen())
+        {
+            return;
+        }
+
+        BeginEvent();
+        Write("{\"ph\":\"C\",\"pid\":1,\"name\":");
+        WriteString(name);
+        Write(",\"ts\":");
+        WriteNumber("%.3f", timeUs);
+        Write(",\"args\":{\"value\":");
+        WriteNumber("%.9g", value);
+        Write("}}");
+    }
+
+    void FrameTraceWriter::FlushFrames()
+    {
+        if ((m_BufferSize * 2) >= m_Buffer.size())
+        {
+            Flush();
+        }
+    }
+
+    bool FrameTraceWriter::Close()
+    {
+        if (!IsOpen())
+        {
+            return false;
+        }
+
+        Write("\n]}\n");
+        Flush();
+
+        m_File.close();
+
+        return !m_WriteFailed && !m_File.fail();
+    }
+
+    const FrameTraceStats& FrameTraceWriter::GetStats() const
+    {
+        return m_Stats;
+    }
+
+    void FrameTraceWriter::BeginEvent()
+    {
+        Write(m_HasEvents ? ",\n" : "");
+
+        m_HasEvents = true;
+        ++m_Stats.EventCount;
+    }
+
+    // Arguments following at least one other argument
+    void FrameTraceWriter::WriteArgs(const FrameTraceArg* pArgs, size_t argCount)
+    {
+        for (size_t i = 0; i < argCount; ++i)
+        {
+            Write(",");
+            WriteString(pArgs[i].Name);
+            Write(":");
+            WriteNumber("%.9g", pArgs[i].Value);
+        }
+    }
+
+    void FrameTraceWriter::Write(const char* pData, size_t size)
+    {
+        if ((m_BufferSize + size) > m_Buffer.size())
+        {
+            if (m_InFrame)
+            {
+                ++m_Stats.FrameFlushCount;
+            }
+            Flush();
+        }
+
+        // writes are short pieces of an event, at most a name or a number, and always fit into the empty buffer
+        std::copy(pData, pData + size, m_Buffer.data() + m_BufferSize);
+        m_BufferSize += size;
+    }
+
+    void FrameTraceWriter::Write(const char* pString)
+    {
+        Write(pString, strlen(pString));
+    }
+
+    template <typename Char>
+    void FrameTraceWriter::WriteString(const Char* pString)
+    {
+        // escaped in chunks, such that every write fits into the buffer
+        char   chunk[256];
+        size_t chunkSize = 0;
+
+        chunk[chunkSize++] = '"';
+
+        for (const Char* c = pString; (c != nullptr) && (*c != 0); ++c)
+        {
+            if ((chunkSize + 2) > sizeof(chunk))
+            {
+                Write(chunk, chunkSize);
+                chunkSize = 0;
+            }
+
+            const uint32_t code = static_cast<uint32_t>(static_cast<typename std::make_unsigned<Char>::type>(*c));
+
+            if ((code == '"') || (code == '\\'))
+            {
+                chunk[chunkSize++] = '\\';
+                chunk[chunkSize++] = static_cast<char>(code);
+            }
+            else
+            {
+                // control & non-ASCII characters, trace names are ASCII
+                chunk[chunkSize++] = ((code < 0x20) || (code >= 0x7F)) ? '?' : static_cast<char>(code);
+            }
+        }
+
+        chunk[chunkSize++] = '"';
+        Write(chunk, chunkSize);
+    }
+
+    void FrameTraceWriter::WriteNumber(const char* format, double value)
+    {
+        char number[64];
+        // JSON has no representation for infinity & NaN
+        const int length = snprintf(number, sizeof(number), format, std::isfinite(value) ? value : 0.0);
+
+        Write(number, static_cast<size_t>(std::max(length, 0)));
+    }
+
+    void FrameTraceWriter::Flush()
+    {
+        if (m_BufferSize == 0)
+        {
+            return;
+        }
+
+        if (m_File.is_open())
+        {
+            m_File.write(m_Buffer.data(), m_BufferSize);
+            m_WriteFailed |= m_File.fail();
+        }
+
+        m_Stats.ByteCount += m_BufferSize;
+        ++m_Stats.FlushCount;
+        m_BufferSize = 0;
+    }
+}  // namespace meshnode
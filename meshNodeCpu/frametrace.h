@@ -0,0 +1,142 @@
+// This file is part of the AMD Work Graph Mesh Node Sample.
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Export of per-frame timings in the Chrome trace event format, which chrome://tracing and Perfetto (ui.perfetto.dev) open directly.
+// Traces of the same flythrough recorded with two builds can be compared marker by marker and frame by frame.
+namespace meshnode
+{
+    /**
+     * Tracks of a frame trace, written as threads of a single process.
+     */
+    enum class FrameTraceTrack : uint32_t
+    {
+        // one slice per frame, with the frame index & the settings in effect as arguments
+        Frames = 1,
+        Cpu    = 2,
+        Gpu    = 3,
+    };
+
+    /**
+     * Numeric setting in effect during a frame, e.g. the geometry budget level.
+     */
+    struct FrameTraceArg
+    {
+        const char* Name  = nullptr;
+        double      Value = 0.0;
+    };
+
+    struct FrameTraceStats
+    {
+        uint64_t FrameCount = 0;
+        uint64_t EventCount = 0;
+        uint64_t ByteCount  = 0;
+        // buffer writes to the file, FrameFlushCount of them happened inside a frame because the buffer ran full before FlushFrames
+        uint32_t FlushCount      = 0;
+        uint32_t FrameFlushCount = 0;
+    };
+
+    /**
+     * Writes frames & timing events in the Chrome trace event format. Timestamps are in microseconds since an arbitrary start.
+     * Events are formatted into a buffer allocated up front, which is only written to the file by FlushFrames once it is half full
+     * & when the trace is closed, such that capturing neither allocates nor blocks on file IO unless the buffer runs full between
+     * two FlushFrames calls. Events may be added outside of frames & for earlier frames, e.g. GPU timings that arrive late.
+     */
+    class FrameTraceWriter
+    {
+    public:
+        static constexpr size_t DefaultBufferSize = 4 << 20;
+
+        explicit FrameTraceWriter(size_t bufferSize = DefaultBufferSize);
+        ~FrameTraceWriter();
+
+        FrameTraceWriter(const FrameTraceWriter&)            = delete;
+        FrameTraceWriter& operator=(const FrameTraceWriter&) = delete;
+
+        /**
+         * @brief   Create the trace file, name the process & tracks and write metadata, e.g. the build & quality tier, as "otherData".
+         *          Closes a previous trace. Returns false if the file could not be created.
+         */
+        bool Open(const std::filesystem::path& path, const char* processName, const std::vector<std::pair<std::string, std::string>>& metadata);
+        bool IsOpen() const;
+
+        /**
+         * @brief   Begin the slice of a frame on the Frames track, ending a frame that is still open.
+         */
+        void BeginFrame(uint64_t frameIndex, double timeUs, const FrameTraceArg* pArgs = nullptr, size_t argCount = 0);
+        void EndFrame(double timeUs);
+        bool IsInFrame() const;
+
+        /**
+         * @brief   Add a complete slice, e.g. a CPU or GPU profiler marker. Names are escaped, non-ASCII characters are replaced.
+         */
+        void AddEvent(FrameTraceTrack track, const char* name, double startUs, double durationUs, const FrameTraceArg* pArgs = nullptr, size_t argCount = 0);
+        void AddEvent(FrameTraceTrack track, const wchar_t* name, double startUs, double durationUs, const FrameTraceArg* pArgs = nullptr, size_t argCount = 0);
+
+        /**
+         * @brief   Add a sample of a counter track, e.g. the work graph GPU time.
+         */
+        void AddCounter(const char* name, double timeUs, double value);
+
+        /**
+         * @brief   Write the buffered events to the file if the buffer is at least half full. Call outside of the measured part of a frame,
+         *          e.g. once all events of the frame are added.
+         */
+        void FlushFrames();
+
+        /**
+         * @brief   Write the remaining events & close the file. Returns false if writing any part of the trace failed.
+         */
+        bool Close();
+
+        const FrameTraceStats& GetStats() const;
+
+    private:
+        template <typename Char>
+        void AddEvent(FrameTraceTrack track, const Char* name, double startUs, double durationUs, const FrameTraceArg* pArgs, size_t argCount);
+        void BeginEvent();
+        void WriteArgs(const FrameTraceArg* pArgs, size_t argCount);
+
+        void Write(const char* pData, size_t size);
+        void Write(const char* pString);
+        template <typename Char>
+        void WriteString(const Char* pString);
+        void WriteNumber(const char* format, double value);
+        void Flush();
+
+        std::ofstream     m_File;
+        std::vector<char> m_Buffer;
+        size_t            m_BufferSize  = 0;
+        bool              m_HasEvents   = false;
+        bool              m_InFrame     = false;
+        bool              m_WriteFailed = false;
+        FrameTraceStats   m_Stats;
+    };
+}  // namespace meshnode
@@ -0,0 +1,172 @@
+// This file is part of the AMD Work Graph Mesh Node Sample.
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "geometrybudget.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace meshnode
+{
+    GeometryBudgetScales GetGeometryBudgetScales(float level)
+    {
+        const float clampedLevel = std::clamp(level, 0.f, 1.f);
+
+        GeometryBudgetScales scales;
+        scales.DenseGrassDistance  = clampedLevel;
+        scales.SparseGrassDistance = 0.5f + 0.5f * clampedLevel;
+        scales.FlowerDistance      = clampedLevel;
+        scales.InsectDistance      = clampedLevel;
+        scales.GrassBladeDensity   = clampedLevel;
+
+        return scales;
+    }
+
+    void SetGeometryBudget(WorkGraphCBData& data, const GeometryBudgetScales& scales)
+    {
+        data.DenseGrassDistanceScale  = scales.DenseGrassDistance;
+        data.SparseGrassDistanceScale = scales.SparseGrassDistance;
+        data.FlowerDistanceScale      = scales.FlowerDistance;
+        data.InsectDistanceScale      = scales.InsectDistance;
+        data.GrassBladeDensityScale   = scales.GrassBladeDensity;
+    }
+
+    GeometryBudgetGovernor::GeometryBudgetGovernor(const GeometryBudgetDesc& desc)
+        : m_Desc(desc)
+    {
+        m_Desc.FilterFrameCount = std::clamp(m_Desc.FilterFrameCount, 1u, MaxFilterFrameCount);
+        m_Desc.MinLevel         = std::clamp(m_Desc.MinLevel, 0.f, 1.f);
+
+        Reset();
+    }
+
+    float GeometryBudgetGovernor::Update(double workGraphTimeMs)
+    {
+        if (!(workGraphTimeMs > 0.0))
+        {
+            return m_Level;
+        }
+
+        // timings of frames before the last level change are still in flight
+        if (m_HoldFrames > 0)
+        {
+            --m_HoldFrames;
+            return m_Level;
+        }
+
+        m_Timings[m_NextTiming] = workGraphTimeMs;
+        m_NextTiming            = (m_NextTiming + 1) % m_Desc.FilterFrameCount;
+        m_TimingCount           = std::min(m_TimingCount + 1, m_Desc.FilterFrameCount);
+        m_SampleCount++;
+
+        std::array<double, MaxFilterFrameCount> sortedTimings = m_Timings;
+        std::nth_element(sortedTimings.begin(), sortedTimings.begin() + m_TimingCount / 2, sortedTimings.begin() + m_TimingCount);
+
+        const double medianTimeMs = sortedTimings[m_TimingCount / 2];
+
+        // average of the medians until the smoothing weight is reached, such that the first median does not dominate
+        const double weight = std::max(m_Desc.Smoothing, 1.0 / m_SampleCount);
+        m_SmoothedTimeMs += (medianTimeMs - m_SmoothedTimeMs) * weight;
+
+        // wait for three filter windows at the current level, such that the smoothed time has settled
+        if (m_SampleCount < (3 * m_Desc.FilterFrameCount))
+        {
+            return m_Level;
+        }
+
+        const double targetTimeMs = m_Desc.TargetTimeMs;
+
+        if (m_Direction == 0)
+        {
+            if ((m_SmoothedTimeMs >= (targetTimeMs * (1.0 - m_Desc.Hysteresis))) && (m_SmoothedTimeMs <= (targetTimeMs * (1.0 + m_Desc.Hysteresis))))
+            {
+                return m_Level;
+            }
+
+            m_Direction = (m_SmoothedTimeMs > targetTimeMs) ? -1 : 1;
+        }
+
+        // once the band is left, the level moves until the time crosses the target, not only until it is back in the band,
+        // where noise would push it out again
+        if (((m_Direction < 0) && (m_SmoothedTimeMs <= targetTimeMs)) || ((m_Direction > 0) && (m_SmoothedTimeMs >= targetTimeMs)))
+        {
+            m_Direction = 0;
+            return m_Level;
+        }
+
+        // the step is at least MinStep, such that the time crosses the target instead of approaching it in ever smaller steps
+        const float desiredLevel = m_Level * static_cast<float>(std::sqrt(targetTimeMs / m_SmoothedTimeMs));
+        const float step         = std::clamp(std::abs(desiredLevel - m_Level),
+                                      m_Desc.MinStep,
+                                      (m_Direction < 0) ? m_Desc.MaxDecreaseStep : m_Desc.MaxIncreaseStep);
+        const float level        = std::clamp(m_Level + step * m_Direction, m_Desc.MinLevel, 1.f);
+
+        if (level != m_Level)
+        {
+            m_Level = level;
+
+            // restart the filter with the timings of the new level
+            m_TimingCount    = 0;
+            m_NextTiming     = 0;
+            m_SampleCount    = 0;
+            m_SmoothedTimeMs = 0.0;
+            m_HoldFrames     = m_Desc.HoldFrameCount;
+        }
+
+        return m_Level;
+    }
+
+    void GeometryBudgetGovernor::Reset()
+    {
+        m_Level          = 1.f;
+        m_TimingCount    = 0;
+        m_NextTiming     = 0;
+        m_SampleCount    = 0;
+        m_SmoothedTimeMs = 0.0;
+        m_HoldFrames     = 0;
+        m_Direction      = 0;
+    }
+
+    void GeometryBudgetGovernor::SetTargetTimeMs(double targetTimeMs)
+    {
+        m_Desc.TargetTimeMs = targetTimeMs;
+    }
+
+    const GeometryBudgetDesc& GeometryBudgetGovernor::GetDesc() const
+    {
+        return m_Desc;
+    }
+
+    float GeometryBudgetGovernor::GetLevel() const
+    {
+        return m_Level;
+    }
+
+    GeometryBudgetScales GeometryBudgetGovernor::GetScales() const
+    {
+        return GetGeometryBudgetScales(m_Level);
+    }
+
+    double GeometryBudgetGovernor::GetSmoothedTimeMs() const
+    {
+        return m_SmoothedTimeMs;
+    }
+}  // namespace meshnode
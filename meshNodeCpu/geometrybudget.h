@@ -0,0 +1,122 @@
+// This file is part of the AMD Work Graph Mesh Node Sample.
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+
+#include "workgraphcommon.h"
+
+#include <array>
+#include <cstdint>
+
+// Frame-time driven geometry budget of the ground cover & decorations.
+// The quality tier defines the largest distances & the dense grass blade count the shaders are compiled for (see common.hlsl),
+// GeometryBudgetGovernor scales them down at runtime through WorkGraphCBData to hold a target work graph GPU time.
+// The governor only sees timings, such that it can be driven by the profiler of the sample & by simulated traces (MeshNodeCpuTool budget).
+namespace meshnode
+{
+    // Scales of the quality tier limits, see the geometry budget fields of WorkGraphCBData
+    struct GeometryBudgetScales
+    {
+        float DenseGrassDistance  = 1.f;
+        float SparseGrassDistance = 1.f;
+        float FlowerDistance      = 1.f;
+        float InsectDistance      = 1.f;
+        float GrassBladeDensity   = 1.f;
+    };
+
+    /**
+     * @brief   Scales of a budget level in [0, 1]. Dense grass, flowers & insects scale with the level,
+     *          sparse grass keeps at least half of its distance to cover the ground behind the dense grass.
+     */
+    GeometryBudgetScales GetGeometryBudgetScales(float level);
+
+    /**
+     * @brief   Write the scales to the geometry budget fields of the constant buffer.
+     */
+    void SetGeometryBudget(WorkGraphCBData& data, const GeometryBudgetScales& scales);
+
+    struct GeometryBudgetDesc
+    {
+        // work graph GPU time to hold
+        double TargetTimeMs = 10.0;
+        // relative band around the target in which the level is kept, avoids oscillating between two levels
+        double Hysteresis = 0.1;
+        // timings of the last FilterFrameCount frames are reduced to their median, which removes single-frame spikes,
+        // & the medians are smoothed with weight Smoothing for the latest median
+        uint32_t FilterFrameCount = 5;
+        double   Smoothing        = 0.1;
+        // lowest level, i.e. smallest fraction of the quality tier distances & blade count
+        float MinLevel = 0.25f;
+        // smallest & largest level change per update. The level decreases faster than it increases, such that an overload is left quickly.
+        float MinStep         = 0.02f;
+        float MaxDecreaseStep = 0.15f;
+        float MaxIncreaseStep = 0.05f;
+        // timings ignored after a level change, covers the latency of the GPU timings
+        uint32_t HoldFrameCount = 4;
+    };
+
+    /**
+     * Feedback controller of the geometry budget level.
+     * Ground cover cost grows with the covered area, i.e. the square of the distances, thus the governor moves the level by
+     * the square root of the ratio of target & smoothed time once the smoothed time leaves the hysteresis band.
+     * As only part of the work graph time scales with the level, the step underestimates the required change,
+     * thus the governor keeps stepping until the smoothed time crosses the target & only then returns to the band check.
+     * After a level change the governor ignores the timings of HoldFrameCount frames, which the profiler still reports for frames
+     * before the change, & restarts its filter, such that every change is based on three full filter windows at the current level.
+     */
+    class GeometryBudgetGovernor
+    {
+    public:
+        explicit GeometryBudgetGovernor(const GeometryBudgetDesc& desc);
+
+        /**
+         * @brief   Add the work graph GPU time of a frame & return the level of the next frame.
+         *          Non-positive times, e.g. while the profiler has no timings yet, keep the level.
+         */
+        float Update(double workGraphTimeMs);
+
+        /**
+         * @brief   Return to the full quality tier & forget the smoothed time, e.g. after the work graph was rebuilt.
+         */
+        void Reset();
+
+        void SetTargetTimeMs(double targetTimeMs);
+
+        const GeometryBudgetDesc& GetDesc() const;
+        float                     GetLevel() const;
+        GeometryBudgetScales      GetScales() const;
+        double                    GetSmoothedTimeMs() const;
+
+        static constexpr uint32_t MaxFilterFrameCount = 15;
+
+    private:
+        GeometryBudgetDesc                       m_Desc;
+        float                                    m_Level = 1.f;
+        std::array<double, MaxFilterFrameCount> m_Timings;
+        uint32_t                                 m_TimingCount    = 0;
+        uint32_t                                 m_NextTiming     = 0;
+        uint32_t                                 m_SampleCount    = 0;
+        double                                   m_SmoothedTimeMs = 0.0;
+        uint32_t                                 m_HoldFrames     = 0;
+        // direction of the level while the time is moved back to the target, 0 once it is reached
+        int32_t m_Direction = 0;
+    };
+}  // namespace meshnode
@@ -0,0 +1,552 @@
+// This file is part of the AMD Work Graph Mesh Node Sample.
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+// Minimal HLSL-style vector types & intrinsics for CPU ports of shader code.
+// Operations are written with the same evaluation order as the HLSL code they mirror, such that CPU results are reproducible.
+// Only the subset used by the CPU mirrors is implemented.
+namespace meshnode
+{
+    struct float2
+    {
+        float x = 0.f;
+        float y = 0.f;
+
+        float2() = default;
+        float2(float x_, float y_)
+            : x(x_)
+            , y(y_)
+        {
+        }
+        explicit float2(float s)
+            : x(s)
+            , y(s)
+        {
+        }
+    };
+
+    struct float3
+    {
+        float x = 0.f;
+        float y = 0.f;
+        float z = 0.f;
+
+        float3() = default;
+        float3(float x_, float y_, float z_)
+            : x(x_)
+            , y(y_)
+            , z(z_)
+        {
+        }
+        explicit float3(float s)
+            : x(s)
+            , y(s)
+            , z(s)
+        {
+        }
+    };
+
+    struct float4
+    {
+        float x = 0.f;
+        float y = 0.f;
+        float z = 0.f;
+        float w = 0.f;
+
+        float4() = default;
+        float4(float x_, float y_, float z_, float w_)
+            : x(x_)
+            , y(y_)
+            , z(z_)
+            , w(w_)
+        {
+        }
+        float4(const float3& xyz, float w_)
+            : x(xyz.x)
+            , y(xyz.y)
+            , z(xyz.z)
+            , w(w_)
+        {
+        }
+
+        float3 xyz() const
+        {
+            return float3(x, y, z);
+        }
+    };
+
+    // 4x4 matrix with the HLSL column_major packing used for constant buffers, i.e. stored column by column.
+    // Same memory layout as the Cauldron Mat4 uploaded by the sample.
+    struct float4x4
+    {
+        float4 columns[4];
+
+        // row as returned by matrix[row] in HLSL
+        float4 operator[](int row) const
+        {
+            const auto get = [row](const float4& c) { return (row == 0) ? c.x : (row == 1) ? c.y : (row == 2) ? c.z : c.w; };
+
+            return float4(get(columns[0]), get(columns[1]), get(columns[2]), get(columns[3]));
+        }
+    };
+
+    struct int2
+    {
+        int32_t x = 0;
+        int32_t y = 0;
+
+        int2() = default;
+        int2(int32_t x_, int32_t y_)
+            : x(x_)
+            , y(y_)
+        {
+        }
+    };
+
+    struct uint2
+    {
+        uint32_t x = 0;
+        uint32_t y = 0;
+
+        uint2() = default;
+        uint2(uint32_t x_, uint32_t y_)
+            : x(x_)
+            , y(y_)
+        {
+        }
+    };
+
+    struct uint3
+    {
+        uint32_t x = 0;
+        uint32_t y = 0;
+        uint32_t z = 0;
+
+        uint3() = default;
+        uint3(uint32_t x_, uint32_t y_, uint32_t z_)
+            : x(x_)
+            , y(y_)
+            , z(z_)
+        {
+        }
+    };
+
+    struct int4
+    {
+        int32_t x = 0;
+        int32_t y = 0;
+        int32_t z = 0;
+        int32_t w = 0;
+
+        int4() = default;
+        int4(int32_t x_, int32_t y_, int32_t z_, int32_t w_)
+            : x(x_)
+            , y(y_)
+            , z(z_)
+            , w(w_)
+        {
+        }
+    };
+
+    struct uint4
+    {
+        uint32_t x = 0;
+        uint32_t y = 0;
+        uint32_t z = 0;
+        uint32_t w = 0;
+
+        uint4() = default;
+        uint4(uint32_t x_, uint32_t y_, uint32_t z_, uint32_t w_)
+            : x(x_)
+            , y(y_)
+            , z(z_)
+            , w(w_)
+        {
+        }
+
+        // component access as vector[i] in HLSL
+        uint32_t& operator[](int i)
+        {
+            return (&x)[i];
+        }
+        uint32_t operator[](int i) const
+        {
+            return (&x)[i];
+        }
+    };
+
+    // HLSL bools are 32 bit in records & constant buffers
+    struct bool4
+    {
+        uint32_t x = 0;
+        uint32_t y = 0;
+        uint32_t z = 0;
+        uint32_t w = 0;
+    };
+
+    // 16-bit vector types of HLSL with -enable-16bit-types, used by the quantized record encodings, see shaders/recordencoding.h
+    struct int16_t2
+    {
+        int16_t x = 0;
+        int16_t y = 0;
+
+        int16_t2() = default;
+        int16_t2(int16_t x_, int16_t y_)
+            : x(x_)
+            , y(y_)
+        {
+        }
+    };
+
+    struct int16_t3
+    {
+        int16_t x = 0;
+        int16_t y = 0;
+        int16_t z = 0;
+
+        int16_t3() = default;
+        int16_t3(int16_t x_, int16_t y_, int16_t z_)
+            : x(x_)
+            , y(y_)
+            , z(z_)
+        {
+        }
+    };
+
+    struct uint16_t2
+    {
+        uint16_t x = 0;
+        uint16_t y = 0;
+
+        uint16_t2() = default;
+        uint16_t2(uint16_t x_, uint16_t y_)
+            : x(x_)
+            , y(y_)
+        {
+        }
+    };
+
+    struct uint16_t3
+    {
+        uint16_t x = 0;
+        uint16_t y = 0;
+        uint16_t z = 0;
+
+        uint16_t3() = default;
+        uint16_t3(uint16_t x_, uint16_t y_, uint16_t z_)
+            : x(x_)
+            , y(y_)
+            , z(z_)
+        {
+        }
+    };
+
+    inline float2 operator+(const float2& a, const float2& b)
+    {
+        return float2(a.x + b.x, a.y + b.y);
+    }
+
+    inline float2 operator-(const float2& a, const float2& b)
+    {
+        return float2(a.x - b.x, a.y - b.y);
+    }
+
+    inline float2 operator*(const float2& a, const float2& b)
+    {
+        return float2(a.x * b.x, a.y * b.y);
+    }
+
+    inline float2 operator*(float s, const float2& a)
+    {
+        return float2(s * a.x, s * a.y);
+    }
+
+    inline float2 operator*(const float2& a, float s)
+    {
+        return float2(a.x * s, a.y * s);
+    }
+
+    inline float2 operator/(const float2& a, float s)
+    {
+        return float2(a.x / s, a.y / s);
+    }
+
+    inline float3 operator+(const float3& a, const float3& b)
+    {
+        return float3(a.x + b.x, a.y + b.y, a.z + b.z);
+    }
+
+    inline float3 operator-(const float3& a, const float3& b)
+    {
+        return float3(a.x - b.x, a.y - b.y, a.z - b.z);
+    }
+
+    inline float3 operator*(float s, const float3& a)
+    {
+        return float3(s * a.x, s * a.y, s * a.z);
+    }
+
+    inline float3 operator*(const float3& a, float s)
+    {
+        return float3(a.x * s, a.y * s, a.z * s);
+    }
+
+    inline float3 operator/(const float3& a, float s)
+    {
+        return float3(a.x / s, a.y / s, a.z / s);
+    }
+
+    inline float4 operator+(const float4& a, const float4& b)
+    {
+        return float4(a.x + b.x, a.y + b.y, a.z + b.z, a.w + b.w);
+    }
+
+    inline float4 operator-(const float4& a, const float4& b)
+    {
+        return float4(a.x - b.x, a.y - b.y, a.z - b.z, a.w - b.w);
+    }
+
+    inline float4 operator/(const float4& a, float s)
+    {
+        return float4(a.x / s, a.y / s, a.z / s, a.w / s);
+    }
+
+    inline int2 operator+(const int2& a, const int2& b)
+    {
+        return int2(a.x + b.x, a.y + b.y);
+    }
+
+    inline float dot(const float2& a, const float2& b)
+    {
+        return a.x * b.x + a.y * b.y;
+    }
+
+    inline float dot(const float3& a, const float3& b)
+    {
+        return a.x * b.x + a.y * b.y + a.z * b.z;
+    }
+
+    inline float dot(const float4& a, const float4& b)
+    {
+        return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
+    }
+
+    inline float4 mul(const float4x4& m, const float4& v)
+    {
+        return float4(dot(m[0], v), dot(m[1], v), dot(m[2], v), dot(m[3], v));
+    }
+
+    inline float length(const float2& v)
+    {
+        return std::sqrt(dot(v, v));
+    }
+
+    inline float length(const float3& v)
+    {
+        return std::sqrt(dot(v, v));
+    }
+
+    inline float distance(const float3& a, const float3& b)
+    {
+        return length(a - b);
+    }
+
+    inline float2 min(const float2& a, const float2& b)
+    {
+        return float2(std::min(a.x, b.x), std::min(a.y, b.y));
+    }
+
+    inline float2 max(const float2& a, const float2& b)
+    {
+        return float2(std::max(a.x, b.x), std::max(a.y, b.y));
+    }
+
+    inline float3 min(const float3& a, const float3& b)
+    {
+        return float3(std::min(a.x, b.x), std::min(a.y, b.y), std::min(a.z, b.z));
+    }
+
+    inline float3 max(const float3& a, const float3& b)
+    {
+        return float3(std::max(a.x, b.x), std::max(a.y, b.y), std::max(a.z, b.z));
+    }
+
+    inline float2 normalize(const float2& v)
+    {
+        return v / length(v);
+    }
+
+    inline float3 normalize(const float3& v)
+    {
+        return v / length(v);
+    }
+
+    inline float3 cross(const float3& a, const float3& b)
+    {
+        return float3(a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x);
+    }
+
+    inline float2 floor(const float2& v)
+    {
+        return float2(std::floor(v.x), std::floor(v.y));
+    }
+
+    inline float frac(float v)
+    {
+        return v - std::floor(v);
+    }
+
+    inline float2 frac(const float2& v)
+    {
+        return float2(frac(v.x), frac(v.y));
+    }
+
+    // HLSL round rounds halfway cases to even (DXIL Round_ne), same as nearbyint in the default rounding mode
+    inline float round(float v)
+    {
+        return std::nearbyint(v);
+    }
+
+    inline float lerp(float a, float b, float t)
+    {
+        return a + t * (b - a);
+    }
+
+    inline float3 lerp(const float3& a, const float3& b, float t)
+    {
+        return a + t * (b - a);
+    }
+
+    inline float clamp(float v, float lo, float hi)
+    {
+        return std::min(std::max(v, lo), hi);
+    }
+
+    inline float saturate(float v)
+    {
+        return clamp(v, 0.f, 1.f);
+    }
+
+    inline float smoothstep(float a, float b, float x)
+    {
+        const float t = saturate((x - a) / (b - a));
+        return t * t * (3.f - 2.f * t);
+    }
+
+    // DXC expands pow with small constant integer exponents into multiplications, which also keeps negative bases valid.
+    inline float pow2(float v)
+    {
+        return v * v;
+    }
+
+    inline float pow3(float v)
+    {
+        return v * v * v;
+    }
+
+    inline float pow4(float v)
+    {
+        const float v2 = v * v;
+        return v2 * v2;
+    }
+
+    inline uint32_t asuint(float v)
+    {
+        uint32_t u;
+        std::memcpy(&u, &v, sizeof(u));
+        return u;
+    }
+
+    inline float asfloat(uint32_t u)
+    {
+        float v;
+        std::memcpy(&v, &u, sizeof(v));
+        return v;
+    }
+
+    // IEEE half precision bits in the lower 16 bits, rounded to nearest even. Values beyond the half range become infinity.
+    inline uint32_t f32tof16(float v)
+    {
+        const uint32_t bits     = asuint(v);
+        const uint32_t sign     = (bits >> 16) & 0x8000u;
+        const uint32_t absolute = bits & 0x7fffffffu;
+
+        // NaN & infinity
+        if (absolute >= 0x7f800000u)
+        {
+            return sign | 0x7c00u | ((absolute > 0x7f800000u) ? 0x200u : 0u);
+        }
+        // overflow, 65520 is the smallest value rounding to infinity
+        if (absolute >= 0x477ff000u)
+        {
+            return sign | 0x7c00u;
+        }
+        // denormals & zero, the implicit bit is shifted into the mantissa
+        if (absolute < 0x38800000u)
+        {
+            const uint32_t shift = 113u - (absolute >> 23);
+            // values below 2^-25 round to zero
+            if (shift > 11u)
+            {
+                return sign;
+            }
+            const uint32_t mantissa = (absolute & 0x7fffffu) | 0x800000u;
+            const uint32_t half     = mantissa >> (shift + 13u);
+            const uint32_t rest     = mantissa & ((1u << (shift + 13u)) - 1u);
+            const uint32_t midpoint = 1u << (shift + 12u);
+
+            return sign | (half + (((rest > midpoint) || ((rest == midpoint) && (half & 1u))) ? 1u : 0u));
+        }
+
+        // normals, rebias the exponent & round the 13 dropped mantissa bits
+        const uint32_t half = (absolute - 0x38000000u) >> 13;
+        const uint32_t rest = absolute & 0x1fffu;
+
+        return sign | (half + (((rest > 0x1000u) || ((rest == 0x1000u) && (half & 1u))) ? 1u : 0u));
+    }
+
+    inline float f16tof32(uint32_t v)
+    {
+        const uint32_t sign     = (v & 0x8000u) << 16;
+        const uint32_t exponent = (v >> 10) & 0x1fu;
+        const uint32_t mantissa = v & 0x3ffu;
+
+        if (exponent == 0x1fu)
+        {
+            return asfloat(sign | 0x7f800000u | (mantissa << 13));
+        }
+        if (exponent == 0u)
+        {
+            // denormals are exact in single precision
+            const float denormal = static_cast<float>(mantissa) * (1.f / 16777216.f);
+            return sign ? -denormal : denormal;
+        }
+
+        return asfloat(sign | ((exponent + 112u) << 23) | (mantissa << 13));
+    }
+}  // namespace meshnode
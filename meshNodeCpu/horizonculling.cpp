@@ -0,0 +1,385 @@
+// This file is part of the AMD Work Graph Mesh Node Sample.
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include "horizonculling.h"
+
+#include "chunkmetadata.h"
+
+#include <algorithm>
+#include <bitset>
+#include <chrono>
+#include <cmath>
+#include <limits>
+
+namespace meshnode
+{
+    static const uint32_t TileCountPerChunk = TerrainTilesPerChunk * TerrainTilesPerChunk;
+    static const float    TerrainTileSize   = TerrainChunkSize / TerrainTilesPerChunk;
+
+    static const float Pi = 3.14159265359f;
+
+    static float2 GetGridPosition(const int2& gridPosition, float elementSize)
+    {
+        return float2(static_cast<float>(gridPosition.x), static_cast<float>(gridPosition.y)) * elementSize;
+    }
+
+    // Elevation of a point on the curved world, seen from the camera.
+    // The point is at angle alpha around the center of the world below the camera & at distance radius from it.
+    // Written with the difference to the world radius, which is small compared to the radius itself.
+    static float GetElevation(float cameraHeight, float radiusOffset, float alpha)
+    {
+        const float s = std::sin(alpha);
+        const float h = std::sin(alpha * 0.5f);
+
+        const float radius = EarthRadius + radiusOffset;
+
+        return (radiusOffset - cameraHeight - 2.f * radius * h * h) / (radius * s);
+    }
+
+    HorizonCuller::HorizonCuller(const HorizonCullingDesc& desc, ChunkMetadataCache& metadataCache)
+        : m_Desc(desc)
+        , m_MetadataCache(metadataCache)
+    {
+        m_Desc.AzimuthBinCount = std::max(m_Desc.AzimuthBinCount, 1u);
+    }
+
+    void HorizonCuller::Cull(const WorkGraphCBData& data, std::vector<ChunkRecord>& chunks)
+    {
+        const auto startTime = std::chrono::high_resolution_clock::now();
+
+        m_Stats            = {};
+        m_Stats.ChunkCount = static_cast<uint32_t>(chunks.size());
+
+        const float3 cameraPosition   = data.CameraPosition.xyz();
+        const float2 cameraPositionXZ = float2(cameraPosition.x, cameraPosition.z);
+
+        // a camera below the terrain sees the terrain from below, which is not a heightfield anymore
+        if (chunks.empty() || (cameraPosition.y <= GetTerrainHeight(cameraPositionXZ)))
+        {
+            m_Stats.TimeMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+            return;
+        }
+
+        m_ChunkGridPositions.clear();
+        for (const ChunkRecord& chunk : chunks)
+        {
+            m_ChunkGridPositions.push_back(chunk.chunkGridPosition);
+        }
+
+        const std::vector<const ChunkMetadata*>& heightBounds = m_MetadataCache.RequestHeightBounds(m_ChunkGridPositions);
+
+        // Tile frustum test, same bounding boxes as the tile output of the Chunk node
+        const size_t tileCount = chunks.size() * TileCountPerChunk;
+
+        for (uint32_t i = 0; i < 3; ++i)
+        {
+            m_BoxMin[i].resize(tileCount);
+            m_BoxMax[i].resize(tileCount);
+        }
+        m_Visible.resize(tileCount);
+
+        for (size_t i = 0; i < chunks.size(); ++i)
+        {
+            for (uint32_t j = 0; j < TileCountPerChunk; ++j)
+            {
+                const int2 tileGridPosition = int2(chunks[i].chunkGridPosition.x * static_cast<int32_t>(TerrainTilesPerChunk) + static_cast<int32_t>(j % TerrainTilesPerChunk),
+                                                   chunks[i].chunkGridPosition.y * static_cast<int32_t>(TerrainTilesPerChunk) + static_cast<int32_t>(j / TerrainTilesPerChunk));
+
+                const float2 minPosition = GetGridPosition(tileGridPosition, TerrainTileSize);
+                const float2 maxPosition = GetGridPosition(tileGridPosition + int2(1, 1), TerrainTileSize);
+
+                const float3 boxMin = GetCurvedWorldSpacePosition(cameraPosition, float3(minPosition.x, 0.f, minPosition.y)) + float3(0.f, TerrainChunkMinHeight, 0.f);
+                const float3 boxMax = GetCurvedWorldSpacePosition(cameraPosition, float3(maxPosition.x, 0.f, maxPosition.y)) + float3(0.f, TerrainChunkMaxHeight, 0.f);
+
+                const size_t index = i * TileCountPerChunk + j;
+
+                m_BoxMin[0][index] = boxMin.x;
+                m_BoxMin[1][index] = boxMin.y;
+                m_BoxMin[2][index] = boxMin.z;
+                m_BoxMax[0][index] = boxMax.x;
+                m_BoxMax[1][index] = boxMax.y;
+                m_BoxMax[2][index] = boxMax.z;
+            }
+        }
+
+        const ClipPlanes   clipPlanes = ComputeClipPlanes(data.ViewProjection);
+        const float* const boxMin[3]  = {m_BoxMin[0].data(), m_BoxMin[1].data(), m_BoxMin[2].data()};
+        const float* const boxMax[3]  = {m_BoxMax[0].data(), m_BoxMax[1].data(), m_BoxMax[2].data()};
+
+        IsBoxVisibleBatch(boxMin, boxMax, &clipPlanes.Planes[0].x, m_Visible.data(), tileCount, m_Desc.Isa);
+
+        m_FrustumTiles.assign(chunks.size(), 0);
+        m_OccludedChunks.assign(chunks.size(), 0);
+
+        // Occluders are all tiles of the chunk records, the terrain of a chunk is drawn regardless of the tile visibility.
+        // Occludees are the chunks & their tiles inside the view frustum, expanded by the content placed on them.
+        m_Occluders.clear();
+        m_Occludees.clear();
+
+        const float cameraHeight = cameraPosition.y;
+
+        for (size_t i = 0; i < chunks.size(); ++i)
+        {
+            const ChunkMetadata& bounds            = *heightBounds[i];
+            const int2           chunkGridPosition = chunks[i].chunkGridPosition;
+            const float2         chunkMinPosition  = GetGridPosition(chunkGridPosition, TerrainChunkSize);
+            const float2         chunkMaxPosition  = GetGridPosition(chunkGridPosition + int2(1, 1), TerrainChunkSize);
+
+            Footprint chunk = GetFootprint(cameraPositionXZ, chunkMinPosition - float2(m_Desc.ContentRadius), chunkMaxPosition + float2(m_Desc.ContentRadius));
+            chunk.Elevation = GetMaxElevation(cameraHeight, bounds.MaxHeight + m_Desc.ContentHeight + m_Desc.HeightMargin, chunk);
+            chunk.Chunk     = static_cast<uint32_t>(i);
+            chunk.Tile      = TileCountPerChunk;
+
+            if (chunk.MinDistance >= m_Desc.MinDistance)
+            {
+                m_Occludees.push_back(chunk);
+            }
+
+            for (uint32_t j = 0; j < TileCountPerChunk; ++j)
+            {
+                const float2 tileMinPosition =
+                    chunkMinPosition + float2(static_cast<float>(j % TerrainTilesPerChunk), static_cast<float>(j / TerrainTilesPerChunk)) * TerrainTileSize;
+                const float2 tileMaxPosition = tileMinPosition + float2(TerrainTileSize);
+
+                Footprint occluder = GetFootprint(cameraPositionXZ, tileMinPosition, tileMaxPosition);
+
+                if (occluder.MinDistance >= m_Desc.MinDistance)
+                {
+                    occluder.Elevation = GetMinElevation(cameraHeight, bounds.TileMinHeights[j] - m_Desc.HeightMargin, occluder);
+                    occluder.Chunk     = static_cast<uint32_t>(i);
+                    occluder.Tile      = j;
+
+                    m_Occluders.push_back(occluder);
+                }
+
+                // tiles already culled by ChunkCuller are neither tested nor counted
+                if ((m_Visible[i * TileCountPerChunk + j] == 0.f) || (GetChunkTileBiome(chunks[i].tileBiomes, j) == ChunkTileCulled))
+                {
+                    continue;
+                }
+
+                m_FrustumTiles[i] |= uint64_t(1) << j;
+
+                Footprint tile = GetFootprint(cameraPositionXZ, tileMinPosition - float2(m_Desc.ContentRadius), tileMaxPosition + float2(m_Desc.ContentRadius));
+                tile.Elevation = GetMaxElevation(cameraHeight, bounds.TileMaxHeights[j] + m_Desc.ContentHeight + m_Desc.HeightMargin, tile);
+                tile.Chunk     = static_cast<uint32_t>(i);
+                tile.Tile      = j;
+
+                if (tile.MinDistance >= m_Desc.MinDistance)
+                {
+                    m_Occludees.push_back(tile);
+                }
+            }
+        }
+
+        m_VisibleTiles = m_FrustumTiles;
+
+        // Front to back sweep, an occluder is added to the horizon once it is entirely closer than the next occludee
+        std::sort(m_Occluders.begin(), m_Occluders.end(), [](const Footprint& a, const Footprint& b) { return a.MaxDistance < b.MaxDistance; });
+        std::sort(m_Occludees.begin(), m_Occludees.end(), [](const Footprint& a, const Footprint& b) { return a.MinDistance < b.MinDistance; });
+
+        m_Horizon.assign(m_Desc.AzimuthBinCount, -std::numeric_limits<float>::max());
+
+        size_t occluderIndex = 0;
+
+        for (const Footprint& occludee : m_Occludees)
+        {
+            for (; (occluderIndex < m_Occluders.size()) && (m_Occluders[occluderIndex].MaxDistance <= occludee.MinDistance); ++occluderIndex)
+            {
+                AddOccluder(m_Occluders[occluderIndex]);
+            }
+
+            if (m_OccludedChunks[occludee.Chunk] || !IsOccluded(occludee))
+            {
+                continue;
+            }
+
+            if (occludee.Tile == TileCountPerChunk)
+            {
+                m_OccludedChunks[occludee.Chunk] = 1;
+            }
+            else
+            {
+                m_VisibleTiles[occludee.Chunk] &= ~(uint64_t(1) << occludee.Tile);
+            }
+        }
+
+        m_Stats.OccluderCount = static_cast<uint32_t>(occluderIndex);
+
+        // Remove hidden chunks & chunks whose tiles inside the view frustum are all hidden, keeps the order of the remaining records
+        size_t chunkCount = 0;
+
+        for (size_t i = 0; i < chunks.size(); ++i)
+        {
+            const uint32_t frustumTileCount = static_cast<uint32_t>(std::bitset<64>(m_FrustumTiles[i]).count());
+
+            m_Stats.VisibleTileCount += frustumTileCount;
+
+            if (m_OccludedChunks[i] || ((m_FrustumTiles[i] != 0) && (m_VisibleTiles[i] == 0)))
+            {
+                m_Stats.OccludedTileCount += frustumTileCount;
+                ++m_Stats.OccludedChunkCount;
+                continue;
+            }
+
+            for (uint32_t j = 0; j < TileCountPerChunk; ++j)
+            {
+                if ((m_FrustumTiles[i] & ~m_VisibleTiles[i]) & (uint64_t(1) << j))
+                {
+                    SetChunkTileBiome(chunks[i].tileBiomes, j, ChunkTileCulled);
+                    ++m_Stats.OccludedTileCount;
+                }
+            }
+
+            chunks[chunkCount++] = chunks[i];
+        }
+
+        chunks.resize(chunkCount);
+
+        m_Stats.TimeMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+    }
+
+    const HorizonCullingStats& HorizonCuller::GetStats() const
+    {
+        return m_Stats;
+    }
+
+    void HorizonCuller::SetTerrainKernelIsa(TerrainKernelIsa isa)
+    {
+        m_Desc.Isa = isa;
+    }
+
+    HorizonCuller::Footprint HorizonCuller::GetFootprint(const float2& cameraPosition, const float2& minPosition, const float2& maxPosition) const
+    {
+        const float2 corners[4] = {minPosition, float2(maxPosition.x, minPosition.y), float2(minPosition.x, maxPosition.y), maxPosition};
+
+        // azimuth range relative to the center, which does not wrap around as long as the camera is outside of the footprint
+        const float2 centerOffset  = (minPosition + maxPosition) * 0.5f - cameraPosition;
+        const float  centerAzimuth = std::atan2(centerOffset.y, centerOffset.x);
+
+        Footprint result   = {};
+        result.MinAzimuth  = 0.f;
+        result.MaxAzimuth  = 0.f;
+        result.MaxDistance = 0.f;
+
+        for (const float2& corner : corners)
+        {
+            const float2 offset  = corner - cameraPosition;
+            float        azimuth = std::atan2(offset.y, offset.x) - centerAzimuth;
+
+            azimuth = (azimuth > Pi) ? (azimuth - 2.f * Pi) : ((azimuth < -Pi) ? (azimuth + 2.f * Pi) : azimuth);
+
+            result.MinAzimuth  = std::min(result.MinAzimuth, azimuth);
+            result.MaxAzimuth  = std::max(result.MaxAzimuth, azimuth);
+            result.MaxDistance = std::max(result.MaxDistance, length(offset));
+        }
+
+        const float binsPerRadian = m_Desc.AzimuthBinCount / (2.f * Pi);
+
+        result.MinAzimuth = (centerAzimuth + Pi + result.MinAzimuth) * binsPerRadian;
+        result.MaxAzimuth = (centerAzimuth + Pi + result.MaxAzimuth) * binsPerRadian;
+
+        // closest point of the footprint
+        const float2 closest = float2(std::clamp(cameraPosition.x, minPosition.x, maxPosition.x), std::clamp(cameraPosition.y, minPosition.y, maxPosition.y));
+        result.MinDistance   = length(closest - cameraPosition);
+
+        return result;
+    }
+
+    // The elevation of a point at a fixed radius increases with the angle up to the horizon of the camera & decreases beyond,
+    // thus the minimum over the distance range is at one of its ends. The elevation increases with the radius.
+    float HorizonCuller::GetMinElevation(float cameraHeight, float height, const Footprint& footprint) const
+    {
+        // lowest radius of the height within the distance range, heights fade out with the distance
+        const float heightScale  = GetCurvedWorldHeightScale((height >= 0.f) ? footprint.MaxDistance : footprint.MinDistance);
+        const float radiusOffset = height * heightScale;
+
+        return std::min(GetElevation(cameraHeight, radiusOffset, footprint.MinDistance / EarthRadius),
+                        GetElevation(cameraHeight, radiusOffset, footprint.MaxDistance / EarthRadius));
+    }
+
+    float HorizonCuller::GetMaxElevation(float cameraHeight, float height, const Footprint& footprint) const
+    {
+        const float heightScale  = GetCurvedWorldHeightScale((height >= 0.f) ? footprint.MinDistance : footprint.MaxDistance);
+        const float radiusOffset = height * heightScale;
+
+        const float minAlpha = footprint.MinDistance / EarthRadius;
+        const float maxAlpha = footprint.MaxDistance / EarthRadius;
+
+        float result = std::max(GetElevation(cameraHeight, radiusOffset, minAlpha), GetElevation(cameraHeight, radiusOffset, maxAlpha));
+
+        // maximum at the horizon, where cos(alpha) = radius / (EarthRadius + cameraHeight)
+        const float cosHorizon = (EarthRadius + radiusOffset) / (EarthRadius + cameraHeight);
+
+        if (cosHorizon < 1.f)
+        {
+            const float horizonAlpha = std::acos(cosHorizon);
+
+            if ((horizonAlpha > minAlpha) && (horizonAlpha < maxAlpha))
+            {
+                result = std::max(result, GetElevation(cameraHeight, radiusOffset, horizonAlpha));
+            }
+        }
+
+        return result;
+    }
+
+    void HorizonCuller::AddOccluder(const Footprint& occluder)
+    {
+        const int32_t binCount = static_cast<int32_t>(m_Desc.AzimuthBinCount);
+
+        // bins entirely covered by the occluder
+        const int32_t firstBin = static_cast<int32_t>(std::ceil(occluder.MinAzimuth));
+        const int32_t lastBin  = static_cast<int32_t>(std::floor(occluder.MaxAzimuth)) - 1;
+
+        for (int32_t bin = firstBin; bin <= lastBin; ++bin)
+        {
+            float& horizon = m_Horizon[((bin % binCount) + binCount) % binCount];
+
+            horizon = std::max(horizon, occluder.Elevation);
+        }
+    }
+
+    bool HorizonCuller::IsOccluded(const Footprint& occludee) const
+    {
+        const int32_t binCount = static_cast<int32_t>(m_Desc.AzimuthBinCount);
+
+        // bins touched by the occludee
+        const int32_t firstBin = static_cast<int32_t>(std::floor(occludee.MinAzimuth));
+        const int32_t lastBin  = static_cast<int32_t>(std::ceil(occludee.MaxAzimuth)) - 1;
+
+        if ((lastBin - firstBin + 1) >= binCount)
+        {
+            return false;
+        }
+
+        for (int32_t bin = firstBin; bin <= lastBin; ++bin)
+        {
+            if (m_Horizon[((bin % binCount) + binCount) % binCount] <= occludee.Elevation)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+}  // namespace meshnode
@@ -0,0 +1,131 @@
+// This file is part of the AMD Work Graph Mesh Node Sample.
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#pragma once
+
+#include "terrain.h"
+#include "worldgraph.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Coarse occlusion culling of terrain chunks & tiles hidden behind nearer terrain.
+// The terrain is a heightfield on the curved world, thus the view from the camera is bounded by a horizon: for every azimuth
+// around the camera, the lowest elevation above which nearer terrain is guaranteed to block the view. The horizon is built
+// front to back from the minimum heights of the tiles of the visible chunks, taken from the height bounds of ChunkMetadataCache.
+// Chunks & tiles whose maximum height, including the content placed on them, stays below the horizon over their whole azimuth range are hidden.
+namespace meshnode
+{
+    class ChunkMetadataCache;
+
+    struct HorizonCullingDesc
+    {
+        // angular resolution of the horizon around the camera
+        uint32_t AzimuthBinCount = 2048;
+        // height of the tallest content above the terrain, i.e. trees
+        float ContentHeight = TerrainContentHeight;
+        // horizontal distance by which content reaches beyond its tile, i.e. tree clusters & crowns
+        float ContentRadius = 8.f;
+        // error of the sampled height bounds against the rendered terrain mesh, subtracted from occluders & added to occludees
+        float HeightMargin = TerrainHeightBoundsMargin;
+        // chunks & tiles closer to the camera are never occluded, tiles closer to the camera do not occlude
+        float MinDistance = 64.f;
+        // instruction set of the tile frustum test
+        TerrainKernelIsa Isa = TerrainKernelIsa::Auto;
+    };
+
+    struct HorizonCullingStats
+    {
+        // chunk records before & removed by the horizon test
+        uint32_t ChunkCount         = 0;
+        uint32_t OccludedChunkCount = 0;
+        // tiles of the chunk records inside the view frustum & hidden by the horizon test, including the tiles of occluded chunks
+        uint32_t VisibleTileCount  = 0;
+        uint32_t OccludedTileCount = 0;
+        // tiles added to the horizon
+        uint32_t OccluderCount = 0;
+        double   TimeMs        = 0.0;
+    };
+
+    /**
+     * Horizon culling of the chunk records computed by ChunkCuller.
+     */
+    class HorizonCuller
+    {
+    public:
+        HorizonCuller(const HorizonCullingDesc& desc, ChunkMetadataCache& metadataCache);
+
+        /**
+         * @brief   Remove the chunks hidden from the camera in data & mark hidden tiles of the remaining chunks with ChunkTileCulled.
+         *          Leaves the records unchanged if the camera is below the terrain.
+         */
+        void Cull(const WorkGraphCBData& data, std::vector<ChunkRecord>& chunks);
+
+        const HorizonCullingStats& GetStats() const;
+
+        void SetTerrainKernelIsa(TerrainKernelIsa isa);
+
+    private:
+        /**
+         * Chunk or tile footprint on the curved world, seen from the camera.
+         */
+        struct Footprint
+        {
+            // horizontal distance range & azimuth range in bins, the azimuth range is not wrapped & can be negative
+            float MinDistance;
+            float MaxDistance;
+            float MinAzimuth;
+            float MaxAzimuth;
+            // minimum elevation of occluders, maximum elevation of occludees
+            float Elevation;
+            // chunk record index & tile index, TileCountPerChunk for chunks
+            uint32_t Chunk;
+            uint32_t Tile;
+        };
+
+        Footprint GetFootprint(const float2& cameraPosition, const float2& minPosition, const float2& maxPosition) const;
+        float     GetMinElevation(float cameraHeight, float height, const Footprint& footprint) const;
+        float     GetMaxElevation(float cameraHeight, float height, const Footprint& footprint) const;
+        void      AddOccluder(const Footprint& occluder);
+        bool      IsOccluded(const Footprint& occludee) const;
+
+        HorizonCullingDesc  m_Desc;
+        ChunkMetadataCache& m_MetadataCache;
+        HorizonCullingStats m_Stats;
+
+        // Scratch memory, kept across frames
+        // maximum occluder elevation per azimuth bin, elevations are slopes, i.e. height over horizontal distance
+        std::vector<float>     m_Horizon;
+        std::vector<int2>      m_ChunkGridPositions;
+        std::vector<Footprint> m_Occluders;
+        std::vector<Footprint> m_Occludees;
+        // tile bounding boxes & visibility for the frustum test, structure of arrays
+        std::vector<float> m_BoxMin[3];
+        std::vector<float> m_BoxMax[3];
+        std::vector<float> m_Visible;
+        // per chunk record, whether it is hidden & the masks of its tiles inside the view frustum & of those not hidden
+        std::vector<uint8_t>  m_OccludedChunks;
+        std::vector<uint64_t> m_FrustumTiles;
+        std::vector<uint64_t> m_VisibleTiles;
+    };
+}  // namespace meshnode
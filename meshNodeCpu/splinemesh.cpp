@@ -0,0 +1,279 @@
+// This file is part of the AMD Work Graph Mesh Node Sample.
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "splinemesh.h"
+
+#include "terrain.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace meshnode
+{
+    static const float Pi = 3.14159265359f;
+
+    static uint32_t Hash(const float3& vec)
+    {
+        return CombineSeed(Hash(vec.x), Hash(vec.y), Hash(vec.z));
+    }
+
+    // Vertex & triangle of a mesh shader thread, see the start of SplineMeshShader
+    struct SplineThread
+    {
+        // control point & index on its vertex ring of the thread vertex
+        uint32_t VertexControlPoint       = 0;
+        uint32_t VertexControlPointVertex = 0;
+        // lower control point of the section, index of the triangle in the section & first vertex of the lower ring of the thread triangle
+        uint32_t PrimitiveSection             = 0;
+        uint32_t PrimitiveSectionTriangle     = 0;
+        uint32_t PrimitiveSectionVertexOffset = 0;
+    };
+
+    // SplineTopology::RingLoop
+    static SplineThread GetSplineThread(const uint2& vertexCounts, uint32_t controlPointCount, uint32_t threadId)
+    {
+        SplineThread thread;
+
+        uint32_t vertexOutputCount    = 0;
+        uint32_t primitiveOutputCount = 0;
+
+        const uint32_t firstRingVertexCount = DecodeVertexCount(vertexCounts, 0);
+
+        if (threadId < firstRingVertexCount)
+        {
+            thread.VertexControlPointVertex = threadId;
+        }
+
+        vertexOutputCount += firstRingVertexCount;
+
+        uint32_t lastRingVertexCount = firstRingVertexCount;
+
+        for (uint32_t ring = 1; ring < controlPointCount; ++ring)
+        {
+            const uint32_t controlPointVertexCount = DecodeVertexCount(vertexCounts, ring);
+
+            if ((vertexOutputCount <= threadId) && ((vertexOutputCount + controlPointVertexCount) > threadId))
+            {
+                thread.VertexControlPoint       = ring;
+                thread.VertexControlPointVertex = threadId - vertexOutputCount;
+            }
+
+            const uint32_t triangleCount = GetSplineSectionTriangleCount(lastRingVertexCount, controlPointVertexCount);
+
+            if ((primitiveOutputCount <= threadId) && ((primitiveOutputCount + triangleCount) > threadId))
+            {
+                thread.PrimitiveSection             = ring - 1;
+                thread.PrimitiveSectionTriangle     = threadId - primitiveOutputCount;
+                thread.PrimitiveSectionVertexOffset = vertexOutputCount - lastRingVertexCount;
+            }
+
+            vertexOutputCount += controlPointVertexCount;
+            primitiveOutputCount += triangleCount;
+
+            lastRingVertexCount = controlPointVertexCount;
+        }
+
+        return thread;
+    }
+
+    // SplineTopology::PrefixSums
+    static SplineThread GetSplineThread(const uint4& prefixSums, uint32_t threadId)
+    {
+        const uint2 vertexSums   = uint2(prefixSums.x, prefixSums.y);
+        const uint2 triangleSums = uint2(prefixSums.z, prefixSums.w);
+
+        SplineThread thread;
+
+        thread.VertexControlPoint       = FindSplinePrefixSumIndex(vertexSums, threadId);
+        thread.VertexControlPointVertex = threadId - GetSplinePrefixSumOffset(vertexSums, thread.VertexControlPoint);
+
+        thread.PrimitiveSection             = FindSplinePrefixSumIndex(triangleSums, threadId);
+        thread.PrimitiveSectionTriangle     = threadId - GetSplinePrefixSumOffset(triangleSums, thread.PrimitiveSection);
+        thread.PrimitiveSectionVertexOffset = GetSplinePrefixSumOffset(vertexSums, thread.PrimitiveSection);
+
+        return thread;
+    }
+
+    static float3 GetSplineVertex(const DrawSplineRecord& record, uint32_t splineIndex, uint32_t controlPointCount, const SplineThread& thread)
+    {
+        const uint32_t controlPointOffset = splineIndex * splineMaxControlPointCount;
+        const float2   splineOrigin       = record.origin[splineIndex];
+        const uint32_t controlPoint       = thread.VertexControlPoint;
+
+        const float3   controlPointPosition    = DecodeRecordPosition(record.controlPointPositions[controlPointOffset + controlPoint], splineOrigin);
+        const uint32_t controlPointVertexCount = DecodeVertexCount(record.controlPointVertexCounts[splineIndex], controlPoint);
+
+        float3 forward = float3(0.f, 0.f, 0.f);
+        if (controlPoint > 0)
+        {
+            forward = forward + (controlPointPosition - DecodeRecordPosition(record.controlPointPositions[controlPointOffset + controlPoint - 1], splineOrigin));
+        }
+        if (controlPoint < (controlPointCount - 1))
+        {
+            forward = forward + (DecodeRecordPosition(record.controlPointPositions[controlPointOffset + controlPoint + 1], splineOrigin) - controlPointPosition);
+        }
+
+        forward = normalize(forward);
+
+        const float3 right = normalize(cross(forward, float3(1.f, 0.f, 0.f)));
+        const float3 up    = normalize(cross(forward, right));
+
+        const float rotationOffset = DecodeHalf(record.rotationOffset[splineIndex]);
+        const float vertexAlpha    = rotationOffset + (thread.VertexControlPointVertex / float(controlPointVertexCount)) * 2.f * Pi;
+
+        const float2 radius         = DecodeHalf(record.controlPointRadii[controlPointOffset + controlPoint]);
+        const float  noiseAmplitude = DecodeHalf(record.controlPointNoiseAmplitudes[controlPointOffset + controlPoint]);
+
+        const float noise = (Random(Hash(controlPointPosition), Hash(vertexAlpha)) * 2.f - 1.f) * noiseAmplitude;
+
+        return controlPointPosition + std::cos(vertexAlpha) * right * radius.y + std::sin(vertexAlpha) * up * radius.x + forward * noise;
+    }
+
+    static uint3 GetSplineTriangle(const uint2& vertexCounts, const SplineThread& thread)
+    {
+        const uint32_t lowerVertexCount = DecodeVertexCount(vertexCounts, thread.PrimitiveSection);
+        const uint32_t upperVertexCount = DecodeVertexCount(vertexCounts, thread.PrimitiveSection + 1);
+
+        const int lowerSectionCount = static_cast<int>(GetSplineRingSectionCount(lowerVertexCount));
+        const int upperSectionCount = static_cast<int>(GetSplineRingSectionCount(upperVertexCount));
+
+        const uint32_t lowerVertexOffset = thread.PrimitiveSectionVertexOffset;
+        const uint32_t upperVertexOffset = lowerVertexOffset + lowerVertexCount;
+
+        // regular sections are determined by the smaller ring, irregular triangles connect the larger ring to the smaller ring
+        const bool isLower = lowerSectionCount <= upperSectionCount;
+
+        const int   sectionCount  = isLower ? lowerSectionCount : upperSectionCount;
+        const float sectionFactor = isLower ? upperSectionCount / float(lowerSectionCount) : lowerSectionCount / float(upperSectionCount);
+
+        const int  sectionTriangle        = static_cast<int>(thread.PrimitiveSectionTriangle);
+        const int  regularTriangleCount   = sectionCount * 2;
+        const bool isIrregularTriangle    = sectionTriangle >= regularTriangleCount;
+        const int  irregularTriangleIndex = sectionTriangle - regularTriangleCount;
+
+        int lowerSection     = 0;
+        int upperSection     = 0;
+        int sectionJumpCount = 0;
+
+        int section      = 0;
+        int otherSection = 0;
+        for (; section < sectionCount; ++section)
+        {
+            const int otherSectionTarget = static_cast<int>(section * sectionFactor);
+
+            for (; otherSection < otherSectionTarget; ++otherSection)
+            {
+                if (isIrregularTriangle && (sectionJumpCount == irregularTriangleIndex))
+                {
+                    lowerSection = isLower ? section : otherSection;
+                    upperSection = isLower ? otherSection : section;
+                }
+                sectionJumpCount++;
+            }
+
+            if (!isIrregularTriangle && (section == (sectionTriangle / 2)))
+            {
+                lowerSection = isLower ? section : otherSection;
+                upperSection = isLower ? otherSection : section;
+            }
+
+            otherSection++;
+        }
+        for (; otherSection < std::max(lowerSectionCount, upperSectionCount); ++otherSection)
+        {
+            if (isIrregularTriangle && (sectionJumpCount == irregularTriangleIndex))
+            {
+                lowerSection = isLower ? section : otherSection;
+                upperSection = isLower ? otherSection : section;
+            }
+            sectionJumpCount++;
+        }
+
+        const auto lower = [&](int offset) { return lowerVertexOffset + static_cast<uint32_t>(lowerSection + offset) % lowerVertexCount; };
+        const auto upper = [&](int offset) { return upperVertexOffset + static_cast<uint32_t>(upperSection + offset) % upperVertexCount; };
+
+        if (isIrregularTriangle)
+        {
+            return isLower ? uint3(lower(1), upper(1), upper(0)) : uint3(lower(0), lower(1), upper(0));
+        }
+
+        return (sectionTriangle & 0x1) ? uint3(upper(0), lower(1), upper(1)) : uint3(lower(0), lower(1), upper(0));
+    }
+
+    void TessellateSpline(const DrawSplineRecord& record, uint32_t splineIndex, SplineMesh& mesh, SplineTopology topology)
+    {
+        const uint32_t controlPointCount = std::min<uint32_t>(record.controlPointCount[splineIndex], splineMaxControlPointCount);
+        const uint2&   vertexCounts      = record.controlPointVertexCounts[splineIndex];
+
+        mesh.VertexCount   = 0;
+        mesh.TriangleCount = 0;
+        mesh.Vertices.clear();
+        mesh.Triangles.clear();
+
+        for (uint32_t controlPoint = 0; controlPoint < controlPointCount; ++controlPoint)
+        {
+            const uint32_t vertexCount = DecodeVertexCount(vertexCounts, controlPoint);
+
+            mesh.VertexCount += vertexCount;
+            if (controlPoint > 0)
+            {
+                mesh.TriangleCount += GetSplineSectionTriangleCount(DecodeVertexCount(vertexCounts, controlPoint - 1), vertexCount);
+            }
+        }
+
+        if (topology == SplineTopology::PrefixSums)
+        {
+            const uint4&   prefixSums    = record.ringPrefixSums[splineIndex];
+            const uint32_t vertexCount   = std::min(mesh.VertexCount, splineMeshMaxVertexCount);
+            const uint32_t triangleCount = std::min(mesh.TriangleCount, splineMeshMaxTriangleCount);
+
+            for (uint32_t threadId = 0; threadId < splineMeshThreadCount; ++threadId)
+            {
+                const SplineThread thread = GetSplineThread(prefixSums, threadId);
+
+                if (threadId < vertexCount)
+                {
+                    mesh.Vertices.push_back(GetSplineVertex(record, splineIndex, controlPointCount, thread));
+                }
+                if (threadId < triangleCount)
+                {
+                    mesh.Triangles.push_back(GetSplineTriangle(vertexCounts, thread));
+                }
+            }
+
+            return;
+        }
+
+        for (uint32_t threadId = 0; threadId < std::max(mesh.VertexCount, mesh.TriangleCount); ++threadId)
+        {
+            const SplineThread thread = GetSplineThread(vertexCounts, controlPointCount, threadId);
+
+            if (threadId < mesh.VertexCount)
+            {
+                mesh.Vertices.push_back(GetSplineVertex(record, splineIndex, controlPointCount, thread));
+            }
+            if (threadId < mesh.TriangleCount)
+            {
+                mesh.Triangles.push_back(GetSplineTriangle(vertexCounts, thread));
+            }
+        }
+    }
+}  // namespace meshnode
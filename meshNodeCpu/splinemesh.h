@@ -0,0 +1,65 @@
+// This file is part of the AMD Work Graph Mesh Node Sample.
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+
+#include "worldgraph.h"
+
+#include <cstdint>
+#include <vector>
+
+// CPU port of the spline mesh node (SplineMeshShader in splinerenderer.hlsl), used to validate the splines generated by the tree & rock nodes.
+// Every mesh shader thread generates at most one vertex & one triangle; the port runs the thread code for all vertices & triangles of a spline,
+// including those beyond the output limits, which the mesh shader drops.
+namespace meshnode
+{
+    // How mesh shader threads find the ring of their vertex & the section of their triangle
+    enum class SplineTopology
+    {
+        // every thread sums the vertex & triangle counts of all rings, as SplineMeshShader did before DrawSplineRecord::ringPrefixSums
+        RingLoop,
+        // every thread looks up its ring & section in DrawSplineRecord::ringPrefixSums, same as SplineMeshShader
+        PrefixSums,
+    };
+
+    struct SplineMesh
+    {
+        // vertex & triangle counts of the spline, before the mesh shader clamps them to splineMeshMaxVertexCount & splineMeshMaxTriangleCount
+        uint32_t VertexCount   = 0;
+        uint32_t TriangleCount = 0;
+        // world-space vertex positions without the wind offset, grouped by vertex ring
+        std::vector<float3> Vertices;
+        // vertex indices of the triangles
+        std::vector<uint3> Triangles;
+
+        bool IsClamped() const
+        {
+            return (VertexCount > splineMeshMaxVertexCount) || (TriangleCount > splineMeshMaxTriangleCount);
+        }
+    };
+
+    /**
+     * @brief   Generate the vertices & triangles of the spline splineIndex in a DrawSplineRecord, same as the thread groups of SplineMeshShader.
+     *          With SplineTopology::PrefixSums, only the splineMeshThreadCount threads of a thread group run & the vertices & triangles
+     *          beyond the output limits are dropped, same as on the GPU.
+     */
+    void TessellateSpline(const DrawSplineRecord& record, uint32_t splineIndex, SplineMesh& mesh, SplineTopology topology = SplineTopology::RingLoop);
+}  // namespace meshnode
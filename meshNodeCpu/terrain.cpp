@@ -0,0 +1,576 @@
+// This file is part of the AMD Work Graph Mesh Node Sample.
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include "terrain.h"
+#include "terrainkernels.h"
+
+#if defined(MESHNODE_CPU_X86) && defined(_MSC_VER)
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
+namespace meshnode
+{
+    // PerlinNoise2D & PerlinNoise2DWithGradient evaluations on this thread, see GetNoiseEvaluationCount
+    static thread_local uint64_t NoiseEvaluationCount = 0;
+
+    // ========================
+    // Random & noise functions
+
+    float2 PerlinNoiseDir2D(const int2& position)
+    {
+        const int2 pos = int2(position.x % 289, position.y % 289);
+
+        // HLSL % on floats keeps the sign of the dividend, same as fmod
+        float f = 0;
+        f       = static_cast<float>(34 * pos.x + 1);
+        f       = std::fmod(f * pos.x, 289.f) + pos.y;
+        f       = std::fmod((34 * f + 1) * f, 289.f);
+        f       = frac(f / 43) * 2 - 1;
+
+        const float x = f - round(f);
+        const float y = std::abs(f) - 0.5f;
+
+        return normalize(float2(x, y));
+    }
+
+    float PerlinNoise2D(const float2& position)
+    {
+        ++NoiseEvaluationCount;
+
+        const float2 gridFloor    = floor(position);
+        const int2   gridPosition = int2(static_cast<int32_t>(gridFloor.x), static_cast<int32_t>(gridFloor.y));
+        const float2 gridOffset   = frac(position);
+
+        const float d00 = dot(PerlinNoiseDir2D(gridPosition + int2(0, 0)), gridOffset - float2(0, 0));
+        const float d01 = dot(PerlinNoiseDir2D(gridPosition + int2(0, 1)), gridOffset - float2(0, 1));
+        const float d10 = dot(PerlinNoiseDir2D(gridPosition + int2(1, 0)), gridOffset - float2(1, 0));
+        const float d11 = dot(PerlinNoiseDir2D(gridPosition + int2(1, 1)), gridOffset - float2(1, 1));
+
+        const float2 interpolationWeights = gridOffset * gridOffset * gridOffset * (gridOffset * (gridOffset * 6 - float2(15)) + float2(10));
+
+        const float d0 = lerp(d00, d01, interpolationWeights.y);
+        const float d1 = lerp(d10, d11, interpolationWeights.y);
+
+        return lerp(d0, d1, interpolationWeights.x);
+    }
+
+    float3 PerlinNoise2DWithGradient(const float2& position)
+    {
+        ++NoiseEvaluationCount;
+
+        const float2 gridFloor    = floor(position);
+        const int2   gridPosition = int2(static_cast<int32_t>(gridFloor.x), static_cast<int32_t>(gridFloor.y));
+        const float2 gridOffset   = frac(position);
+
+        const float2 g00 = PerlinNoiseDir2D(gridPosition + int2(0, 0));
+        const float2 g01 = PerlinNoiseDir2D(gridPosition + int2(0, 1));
+        const float2 g10 = PerlinNoiseDir2D(gridPosition + int2(1, 0));
+        const float2 g11 = PerlinNoiseDir2D(gridPosition + int2(1, 1));
+
+        const float d00 = dot(g00, gridOffset - float2(0, 0));
+        const float d01 = dot(g01, gridOffset - float2(0, 1));
+        const float d10 = dot(g10, gridOffset - float2(1, 0));
+        const float d11 = dot(g11, gridOffset - float2(1, 1));
+
+        const float2 interpolationWeights     = gridOffset * gridOffset * gridOffset * (gridOffset * (gridOffset * 6 - float2(15)) + float2(10));
+        const float2 interpolationDerivatives = 30 * gridOffset * gridOffset * (gridOffset * (gridOffset - float2(2)) + float2(1));
+
+        const float d0 = lerp(d00, d01, interpolationWeights.y);
+        const float d1 = lerp(d10, d11, interpolationWeights.y);
+
+        const float2 gradient0 = float2(lerp(g00.x, g01.x, interpolationWeights.y),
+                                        lerp(g00.y, g01.y, interpolationWeights.y) + (d01 - d00) * interpolationDerivatives.y);
+        const float2 gradient1 = float2(lerp(g10.x, g11.x, interpolationWeights.y),
+                                        lerp(g10.y, g11.y, interpolationWeights.y) + (d11 - d10) * interpolationDerivatives.y);
+
+        const float noise     = lerp(d0, d1, interpolationWeights.x);
+        const float gradientX = lerp(gradient0.x, gradient1.x, interpolationWeights.x) + (d1 - d0) * interpolationDerivatives.x;
+        const float gradientY = lerp(gradient0.y, gradient1.y, interpolationWeights.x);
+
+        return float3(noise, gradientX, gradientY);
+    }
+
+    uint64_t GetNoiseEvaluationCount()
+    {
+        return NoiseEvaluationCount;
+    }
+
+    void ResetNoiseEvaluationCount()
+    {
+        NoiseEvaluationCount = 0;
+    }
+
+    uint32_t Hash(uint32_t seed)
+    {
+        seed = (seed ^ 61u) ^ (seed >> 16u);
+        seed *= 9u;
+        seed = seed ^ (seed >> 4u);
+        seed *= 0x27d4eb2du;
+        seed = seed ^ (seed >> 15u);
+        return seed;
+    }
+
+    uint32_t Hash(float seed)
+    {
+        return Hash(asuint(seed));
+    }
+
+    uint32_t CombineSeed(uint32_t a, uint32_t b)
+    {
+        // HLSL operator precedence, + binds stronger than ^
+        return a ^ (Hash(b) + 0x9e3779b9u + (a << 6) + (a >> 2));
+    }
+
+    uint32_t CombineSeed(uint32_t a, uint32_t b, uint32_t c)
+    {
+        return CombineSeed(CombineSeed(a, b), c);
+    }
+
+    uint32_t CombineSeed(uint32_t a, uint32_t b, uint32_t c, uint32_t d)
+    {
+        return CombineSeed(CombineSeed(a, b), c, d);
+    }
+
+    float Random(uint32_t seed)
+    {
+        return static_cast<float>(Hash(seed)) / static_cast<float>(~0u);
+    }
+
+    float Random(uint32_t a, uint32_t b)
+    {
+        return Random(CombineSeed(a, b));
+    }
+
+    float Random(uint32_t a, uint32_t b, uint32_t c)
+    {
+        return Random(CombineSeed(a, b), c);
+    }
+
+    float Random(uint32_t a, uint32_t b, uint32_t c, uint32_t d)
+    {
+        return Random(CombineSeed(a, b), c, d);
+    }
+
+    float Random(uint32_t a, uint32_t b, uint32_t c, uint32_t d, uint32_t e)
+    {
+        return Random(CombineSeed(a, b), c, d, e);
+    }
+
+    // ========================
+    // Terrain functions
+
+    static float3 PerlinNoise2DWithGradient(const float2& position, float scale)
+    {
+        const float3 noise = PerlinNoise2DWithGradient(scale * position);
+
+        return float3(noise.x, scale * noise.y, scale * noise.z);
+    }
+
+    static float3 PerlinNoise2DWithGradient(const float2& position, float scale, const float2& offset)
+    {
+        const float3 noise = PerlinNoise2DWithGradient(scale * position + offset);
+
+        return float3(noise.x, scale * noise.y, scale * noise.z);
+    }
+
+    static float3 MaxWithGradient(const float3& a, const float3& b)
+    {
+        return (a.x < b.x) ? b : a;
+    }
+
+    static float SmoothstepDerivative(float a, float b, float x)
+    {
+        const float t = saturate((x - a) / (b - a));
+
+        return 6 * t * (1 - t) / (b - a);
+    }
+
+    // Mountain factor before squaring & its gradient at biomePosition = position * 0.01, see GetMountainFactorAnalytic
+    static float3 GetMountainFactor(const float2& biomePosition, float& noise01)
+    {
+        const float3 octave01 = PerlinNoise2DWithGradient(biomePosition, 0.1f);
+        noise01               = octave01.x;
+
+        float3 mountainFactor = float3(0, 0, 0);
+        mountainFactor        = mountainFactor + 1 * PerlinNoise2DWithGradient(biomePosition, 0.5f);
+        mountainFactor        = mountainFactor + 2 * PerlinNoise2DWithGradient(biomePosition, 0.2f, float2(38, 23));
+        mountainFactor        = mountainFactor + 4 * octave01;
+
+        return mountainFactor;
+    }
+
+    static float3 GetBiomeWeights(const float2& biomePosition, float mountainFactor, float noise01)
+    {
+        float woodlandMountainFactor = 1.f - smoothstep(0, 1, 4 * pow2(mountainFactor - 0.5f));
+        woodlandMountainFactor       = woodlandMountainFactor - pow4(4 * noise01);
+        const float mountainWeight   = clamp(pow2(clamp(mountainFactor, 0, 1)), 0, 1);
+
+        float woodlandFactor = 0;
+        woodlandFactor += 1 * pow3(4 * PerlinNoise2D(0.3f * biomePosition));
+        woodlandFactor += 5 * pow2(1 * noise01);
+        woodlandFactor = clamp(smoothstep(0, 1, woodlandFactor), 0, 1);
+
+        woodlandFactor = smoothstep(0, 1, std::max(woodlandMountainFactor, woodlandFactor - mountainWeight));
+
+        const float grasslandFactor = clamp(1 - (mountainWeight + woodlandFactor), 0, 1);
+
+        return float3(mountainWeight, woodlandFactor, grasslandFactor);
+    }
+
+    float3 GetBiomeWeights(const float2& position)
+    {
+        const float2 biomePosition = position * 0.01f;
+
+        float        noise01        = 0;
+        const float3 mountainFactor = GetMountainFactor(biomePosition, noise01);
+
+        return GetBiomeWeights(biomePosition, mountainFactor.x, noise01);
+    }
+
+    static float3 GetTerrainHeightAndGradient(const float2& pos, const float3& mountainFactor)
+    {
+        const float  mountainFactorClamped = clamp(mountainFactor.x, 0, 1);
+        const float  mountainWeight        = clamp(pow2(mountainFactorClamped), 0, 1);
+        const bool   mountainFactorInRange = (mountainFactor.x > 0) && (mountainFactor.x < 1);
+        const float2 mountainGradient =
+            mountainFactorInRange ? (2 * mountainFactorClamped * 0.01f) * float2(mountainFactor.y, mountainFactor.z) : float2(0, 0);
+
+        // scale position down for low-frequency perlin noise
+        const float2 samplePosition = pos / 400.f;
+
+        // Add multiple perlin noise layers to achieve base terrain height
+        float3 baseHeight = float3(0, 0, 0);
+        baseHeight        = baseHeight + 1.0f * PerlinNoise2DWithGradient(samplePosition, 1.0f, float2(34, 98));
+        baseHeight        = baseHeight + 0.35f * PerlinNoise2DWithGradient(samplePosition, 2.0f, float2(73, 42));
+        baseHeight        = baseHeight + 0.25f * MaxWithGradient(PerlinNoise2DWithGradient(samplePosition, 3.2f, float2(+0.5f, -0.5f)),
+                                                                 PerlinNoise2DWithGradient(samplePosition, 3.5f, float2(-0.5f, +0.5f)));
+        baseHeight        = baseHeight + 0.15f * PerlinNoise2DWithGradient(samplePosition, 4.0f);
+        baseHeight        = baseHeight + 0.08f * PerlinNoise2DWithGradient(samplePosition, 8.0f);
+        baseHeight        = baseHeight + 0.07f * PerlinNoise2DWithGradient(samplePosition, 9.0f);
+
+        // Add additional high-frequency noise in mountain biome
+        float3 mountainHeight = float3(0, 0, 0);
+        mountainHeight        = mountainHeight + 0.97f * PerlinNoise2DWithGradient(samplePosition, 1.0f);
+        mountainHeight        = mountainHeight + 0.95f * MaxWithGradient(PerlinNoise2DWithGradient(samplePosition, 2.8f, float2(+2.3f, -4.5f)),
+                                                                         PerlinNoise2DWithGradient(samplePosition, 3.1f, float2(-6.5f, +3.6f)));
+        mountainHeight        = mountainHeight + 0.75f * PerlinNoise2DWithGradient(samplePosition, 2.0f, float2(34, 56));
+
+        const float mountainBlend = smoothstep(0.5f, 1.0f, mountainWeight);
+
+        // square height to make hills a bit more pronounced and scale to final height
+        float height = 140.0f * baseHeight.x * baseHeight.x;
+        height += 70.0f * mountainHeight.x * mountainHeight.x * mountainBlend;
+        // raise mountain biome up
+        height += 40.0f * smoothstep(0.0f, 1.0f, mountainWeight);
+
+        // chain rule, noise gradients are relative to samplePosition
+        float2 gradient = 280.0f * baseHeight.x * float2(baseHeight.y, baseHeight.z);
+        gradient        = gradient + 140.0f * mountainHeight.x * mountainBlend * float2(mountainHeight.y, mountainHeight.z);
+        gradient        = gradient / 400.f;
+        gradient        = gradient + (70.0f * mountainHeight.x * mountainHeight.x * SmoothstepDerivative(0.5f, 1.0f, mountainWeight) +
+                                      40.0f * SmoothstepDerivative(0.0f, 1.0f, mountainWeight)) *
+                                         mountainGradient;
+
+        return float3(height, gradient.x, gradient.y);
+    }
+
+    float3 GetTerrainHeightAndGradient(const float2& pos)
+    {
+        float noise01 = 0;
+
+        return GetTerrainHeightAndGradient(pos, GetMountainFactor(pos * 0.01f, noise01));
+    }
+
+    float GetTerrainHeight(const float2& pos)
+    {
+        return GetTerrainHeightAndGradient(pos).x;
+    }
+
+    float3 GetTerrainPosition(const float2& pos)
+    {
+        return float3(pos.x, GetTerrainHeight(pos), pos.y);
+    }
+
+    float3 GetTerrainNormal(const float2& pos)
+    {
+        const float3 heightAndGradient = GetTerrainHeightAndGradient(pos);
+
+        return normalize(float3(-heightAndGradient.y, 1, -heightAndGradient.z));
+    }
+
+    TerrainSample GetTerrainSample(const float2& position)
+    {
+        const float2 biomePosition = position * 0.01f;
+
+        float        noise01           = 0;
+        const float3 mountainFactor    = GetMountainFactor(biomePosition, noise01);
+        const float3 heightAndGradient = GetTerrainHeightAndGradient(position, mountainFactor);
+
+        TerrainSample result;
+        result.Height       = heightAndGradient.x;
+        result.Normal       = normalize(float3(-heightAndGradient.y, 1, -heightAndGradient.z));
+        result.BiomeWeights = GetBiomeWeights(biomePosition, mountainFactor.x, noise01);
+
+        return result;
+    }
+
+    // ========================
+    // Batch evaluation
+
+    static void PerlinNoise2DScalar(const float* x, const float* y, float* noise, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            noise[i] = PerlinNoise2D(float2(x[i], y[i]));
+        }
+    }
+
+    static void GetBiomeWeightsScalar(const float* x, const float* z, float* mountain, float* woodland, float* grassland, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            const float3 weights = GetBiomeWeights(float2(x[i], z[i]));
+
+            mountain[i]  = weights.x;
+            woodland[i]  = weights.y;
+            grassland[i] = weights.z;
+        }
+    }
+
+    static void GetTerrainHeightScalar(const float* x, const float* z, float* height, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            height[i] = GetTerrainHeight(float2(x[i], z[i]));
+        }
+    }
+
+    static void GetTerrainHeightAndGradientScalar(const float* x, const float* z, float* height, float* gradientX, float* gradientZ, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            const float3 heightAndGradient = GetTerrainHeightAndGradient(float2(x[i], z[i]));
+
+            height[i]    = heightAndGradient.x;
+            gradientX[i] = heightAndGradient.y;
+            gradientZ[i] = heightAndGradient.z;
+        }
+    }
+
+    static void GetTerrainNormalScalar(const float* x, const float* z, float* normalX, float* normalY, float* normalZ, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            const float3 normal = GetTerrainNormal(float2(x[i], z[i]));
+
+            normalX[i] = normal.x;
+            normalY[i] = normal.y;
+            normalZ[i] = normal.z;
+        }
+    }
+
+    static void IsBoxVisibleScalar(const float* const boxMin[3], const float* const boxMax[3], const float* planes, float* visible, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            visible[i] = 1.f;
+
+            for (int p = 0; p < 6; ++p)
+            {
+                const float4 plane(planes[p * 4 + 0], planes[p * 4 + 1], planes[p * 4 + 2], planes[p * 4 + 3]);
+
+                const float3 axis = float3(plane.x < 0.f ? boxMin[0][i] : boxMax[0][i],  //
+                                           plane.y < 0.f ? boxMin[1][i] : boxMax[1][i],  //
+                                           plane.z < 0.f ? boxMin[2][i] : boxMax[2][i]);
+
+                if ((dot(plane.xyz(), axis) + plane.w) < 0.f)
+                {
+                    visible[i] = 0.f;
+                    break;
+                }
+            }
+        }
+    }
+
+    static const detail::TerrainKernels ScalarKernels = {PerlinNoise2DScalar,
+                                                         GetBiomeWeightsScalar,
+                                                         GetTerrainHeightScalar,
+                                                         GetTerrainHeightAndGradientScalar,
+                                                         GetTerrainNormalScalar,
+                                                         IsBoxVisibleScalar};
+
+#ifdef MESHNODE_CPU_X86
+    static bool IsAvx2Supported()
+    {
+#ifdef _MSC_VER
+        int cpuInfo[4];
+        __cpuid(cpuInfo, 1);
+        const bool osXSave = (cpuInfo[2] & (1 << 27)) != 0;
+        const bool avx     = (cpuInfo[2] & (1 << 28)) != 0;
+        // OS must save YMM registers
+        if (!osXSave || !avx || ((_xgetbv(0) & 0x6) != 0x6))
+        {
+            return false;
+        }
+        __cpuidex(cpuInfo, 7, 0);
+        return (cpuInfo[1] & (1 << 5)) != 0;
+#else
+        return __builtin_cpu_supports("avx2");
+#endif  // _MSC_VER
+    }
+
+    static bool IsAvx512Supported()
+    {
+#ifdef _MSC_VER
+        if (!IsAvx2Supported() || ((_xgetbv(0) & 0xE6) != 0xE6))
+        {
+            return false;
+        }
+        int cpuInfo[4];
+        __cpuidex(cpuInfo, 7, 0);
+        // AVX-512 F
+        return (cpuInfo[1] & (1 << 16)) != 0;
+#else
+        return __builtin_cpu_supports("avx512f");
+#endif  // _MSC_VER
+    }
+#endif  // MESHNODE_CPU_X86
+
+    bool IsTerrainKernelIsaSupported(TerrainKernelIsa isa)
+    {
+        switch (isa)
+        {
+        case TerrainKernelIsa::Auto:
+        case TerrainKernelIsa::Scalar:
+        case TerrainKernelIsa::Generic:
+            return true;
+#ifdef MESHNODE_CPU_X86
+        case TerrainKernelIsa::Avx2:
+        {
+            static const bool supported = IsAvx2Supported();
+            return supported;
+        }
+        case TerrainKernelIsa::Avx512:
+        {
+            static const bool supported = IsAvx512Supported();
+            return supported;
+        }
+#endif  // MESHNODE_CPU_X86
+        default:
+            return false;
+        }
+    }
+
+    TerrainKernelIsa GetBestTerrainKernelIsa()
+    {
+        if (IsTerrainKernelIsaSupported(TerrainKernelIsa::Avx512))
+        {
+            return TerrainKernelIsa::Avx512;
+        }
+        if (IsTerrainKernelIsaSupported(TerrainKernelIsa::Avx2))
+        {
+            return TerrainKernelIsa::Avx2;
+        }
+
+        return TerrainKernelIsa::Generic;
+    }
+
+    const char* GetTerrainKernelIsaName(TerrainKernelIsa isa)
+    {
+        switch (isa)
+        {
+        case TerrainKernelIsa::Auto:
+            return "Auto";
+        case TerrainKernelIsa::Scalar:
+            return "Scalar";
+        case TerrainKernelIsa::Generic:
+            return "Generic";
+        case TerrainKernelIsa::Avx2:
+            return "AVX2";
+        case TerrainKernelIsa::Avx512:
+            return "AVX-512";
+        default:
+            return "Unknown";
+        }
+    }
+
+    // Unsupported instruction sets fall back to the best supported one
+    static const detail::TerrainKernels& GetTerrainKernels(TerrainKernelIsa isa)
+    {
+        if ((isa == TerrainKernelIsa::Auto) || !IsTerrainKernelIsaSupported(isa))
+        {
+            static const TerrainKernelIsa bestIsa = GetBestTerrainKernelIsa();
+            isa                                   = bestIsa;
+        }
+
+        switch (isa)
+        {
+        case TerrainKernelIsa::Scalar:
+            return ScalarKernels;
+#ifdef MESHNODE_CPU_X86
+        case TerrainKernelIsa::Avx2:
+            return detail::GetTerrainKernelsAvx2();
+        case TerrainKernelIsa::Avx512:
+            return detail::GetTerrainKernelsAvx512();
+#endif  // MESHNODE_CPU_X86
+        default:
+            return detail::GetTerrainKernelsGeneric();
+        }
+    }
+
+    void PerlinNoise2DBatch(const float* x, const float* y, float* noise, size_t count, TerrainKernelIsa isa)
+    {
+        GetTerrainKernels(isa).PerlinNoise2D(x, y, noise, count);
+    }
+
+    void GetBiomeWeightsBatch(const float* x, const float* z, float* mountain, float* woodland, float* grassland, size_t count, TerrainKernelIsa isa)
+    {
+        GetTerrainKernels(isa).GetBiomeWeights(x, z, mountain, woodland, grassland, count);
+    }
+
+    void GetTerrainHeightBatch(const float* x, const float* z, float* height, size_t count, TerrainKernelIsa isa)
+    {
+        GetTerrainKernels(isa).GetTerrainHeight(x, z, height, count);
+    }
+
+    void GetTerrainHeightAndGradientBatch(const float*     x,
+                                          const float*     z,
+                                          float*           height,
+                                          float*           gradientX,
+                                          float*           gradientZ,
+                                          size_t           count,
+                                          TerrainKernelIsa isa)
+    {
+        GetTerrainKernels(isa).GetTerrainHeightAndGradient(x, z, height, gradientX, gradientZ, count);
+    }
+
+    void GetTerrainNormalBatch(const float* x, const float* z, float* normalX, float* normalY, float* normalZ, size_t count, TerrainKernelIsa isa)
+    {
+        GetTerrainKernels(isa).GetTerrainNormal(x, z, normalX, normalY, normalZ, count);
+    }
+
+    void IsBoxVisibleBatch(const float* const boxMin[3], const float* const boxMax[3], const float* planes, float* visible, size_t count, TerrainKernelIsa isa)
+    {
+        GetTerrainKernels(isa).IsBoxVisible(boxMin, boxMax, planes, visible, count);
+    }
+}  // namespace meshnode
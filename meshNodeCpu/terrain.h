@@ -0,0 +1,185 @@
+// This file is part of the AMD Work Graph Mesh Node Sample.
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#pragma once
+
+#include "hlslmath.h"
+
+#include <cstddef>
+#include <cstdint>
+
+// CPU mirror of the procedural terrain functions in shaders/utils.hlsl & shaders/heightmap.hlsl.
+// The scalar functions are the reference implementation and follow the HLSL code operation by operation.
+// Changes to the HLSL functions must be mirrored here.
+// GetBiomeWeights, GetTerrainHeight, GetTerrainNormal & GetTerrainSample mirror the analytic HLSL functions (GetBiomeWeightsAnalytic, ...),
+// see terrainclipmap.h for the clipmap sampled by the shaders.
+namespace meshnode
+{
+    // ========================
+    // Random & noise functions, see utils.hlsl
+
+    float2 PerlinNoiseDir2D(const int2& position);
+    float  PerlinNoise2D(const float2& position);
+    /**
+     * @brief   PerlinNoise2D with analytic gradient. x = noise, y & z = derivative with respect to position.x & position.y.
+     */
+    float3 PerlinNoise2DWithGradient(const float2& position);
+
+    /**
+     * @brief   Number of PerlinNoise2D & PerlinNoise2DWithGradient evaluations on the calling thread since the last reset.
+     *          Only the scalar functions are counted, used to measure the noise cost of terrain queries.
+     */
+    uint64_t GetNoiseEvaluationCount();
+    void     ResetNoiseEvaluationCount();
+
+    uint32_t Hash(uint32_t seed);
+    uint32_t Hash(float seed);
+    uint32_t CombineSeed(uint32_t a, uint32_t b);
+    uint32_t CombineSeed(uint32_t a, uint32_t b, uint32_t c);
+    uint32_t CombineSeed(uint32_t a, uint32_t b, uint32_t c, uint32_t d);
+
+    float Random(uint32_t seed);
+    float Random(uint32_t a, uint32_t b);
+    float Random(uint32_t a, uint32_t b, uint32_t c);
+    float Random(uint32_t a, uint32_t b, uint32_t c, uint32_t d);
+    float Random(uint32_t a, uint32_t b, uint32_t c, uint32_t d, uint32_t e);
+
+    // ========================
+    // Terrain functions, see heightmap.hlsl
+
+    /**
+     * @brief   Biome weights at a world-space xz position. x = mountain, y = woodland, z = grassland.
+     */
+    float3 GetBiomeWeights(const float2& position);
+    float  GetTerrainHeight(const float2& position);
+    float3 GetTerrainPosition(const float2& position);
+    /**
+     * @brief   Terrain height & its analytic gradient in a single pass. x = height (same value as GetTerrainHeight), y & z = d height / d x & z.
+     *          Evaluates 14 noise functions, compared to 51 for the previous finite difference normal.
+     *          GetTerrainHeight evaluates the same noise functions, only the mountain biome weight is computed.
+     */
+    float3 GetTerrainHeightAndGradient(const float2& position);
+    /**
+     * @brief   Terrain normal from the analytic height gradient.
+     */
+    float3 GetTerrainNormal(const float2& position);
+
+    /**
+     * Height, normal & biome weights at one position, same layout as TerrainSample in heightmap.hlsl.
+     */
+    struct TerrainSample
+    {
+        float  Height = 0.f;
+        float3 Normal;
+        // x = mountain, y = woodland, z = grassland
+        float3 BiomeWeights;
+    };
+
+    /**
+     * @brief   Fused GetTerrainHeight, GetTerrainNormal & GetBiomeWeights, mirrors GetTerrainSampleAnalytic.
+     *          Each noise octave is evaluated once (15 noise evaluations), results are bit-identical to the separate functions.
+     */
+    TerrainSample GetTerrainSample(const float2& position);
+
+    // ========================
+    // Batch evaluation
+
+    /**
+     * Instruction set used by the batch functions.
+     * All instruction sets produce bit-identical results to the scalar reference functions above.
+     */
+    enum class TerrainKernelIsa
+    {
+        // best instruction set supported by the CPU
+        Auto,
+        // scalar reference functions
+        Scalar,
+        // 8-wide portable C++, vectorized by the compiler
+        Generic,
+        // 8-wide AVX2
+        Avx2,
+        // 16-wide AVX-512
+        Avx512,
+    };
+
+    /**
+     * @brief   Returns true if the instruction set was compiled into the library and is supported by the CPU.
+     */
+    bool             IsTerrainKernelIsaSupported(TerrainKernelIsa isa);
+    TerrainKernelIsa GetBestTerrainKernelIsa();
+    const char*      GetTerrainKernelIsaName(TerrainKernelIsa isa);
+
+    /**
+     * @brief   Evaluate PerlinNoise2D for count positions given as separate x & y arrays.
+     */
+    void PerlinNoise2DBatch(const float* x, const float* y, float* noise, size_t count, TerrainKernelIsa isa = TerrainKernelIsa::Auto);
+
+    /**
+     * @brief   Evaluate GetBiomeWeights for count world-space xz positions.
+     */
+    void GetBiomeWeightsBatch(const float*     x,
+                              const float*     z,
+                              float*           mountain,
+                              float*           woodland,
+                              float*           grassland,
+                              size_t           count,
+                              TerrainKernelIsa isa = TerrainKernelIsa::Auto);
+
+    /**
+     * @brief   Evaluate GetTerrainHeight for count world-space xz positions.
+     */
+    void GetTerrainHeightBatch(const float* x, const float* z, float* height, size_t count, TerrainKernelIsa isa = TerrainKernelIsa::Auto);
+
+    /**
+     * @brief   Evaluate GetTerrainHeightAndGradient for count world-space xz positions.
+     */
+    void GetTerrainHeightAndGradientBatch(const float*     x,
+                                          const float*     z,
+                                          float*           height,
+                                          float*           gradientX,
+                                          float*           gradientZ,
+                                          size_t           count,
+                                          TerrainKernelIsa isa = TerrainKernelIsa::Auto);
+
+    /**
+     * @brief   Evaluate GetTerrainNormal for count world-space xz positions.
+     */
+    void GetTerrainNormalBatch(const float*     x,
+                               const float*     z,
+                               float*           normalX,
+                               float*           normalY,
+                               float*           normalZ,
+                               size_t           count,
+                               TerrainKernelIsa isa = TerrainKernelIsa::Auto);
+
+    /**
+     * @brief   Frustum test of count axis-aligned boxes, same as AxisAlignedBoundingBox::IsVisible in utils.hlsl.
+     *          boxMin & boxMax are x, y & z arrays, planes are 6 float4 planes (xyz = normal, w = distance).
+     *          visible is set to 1 for boxes on the inner side of all planes, 0 otherwise.
+     */
+    void IsBoxVisibleBatch(const float* const boxMin[3],
+                           const float* const boxMax[3],
+                           const float*       planes,
+                           float*             visible,
+                           size_t             count,
+                           TerrainKernelIsa   isa = TerrainKernelIsa::Auto);
+}  // namespace meshnode
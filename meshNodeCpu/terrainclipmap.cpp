@@ -0,0 +1,469 @@
+// This file is part of the AMD Work Graph Mesh Node Sample.
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include "terrainclipmap.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <thread>
+
+namespace meshnode
+{
+    // Updates regenerating fewer texels are baked on the calling thread, e.g. the strips exposed by regular camera movement
+    static const uint64_t ParallelBakeTexelCount = 16384;
+
+    static uint32_t PackSnorm16(float x, float z)
+    {
+        const auto pack = [](float v) { return static_cast<uint32_t>(static_cast<int32_t>(std::nearbyint(clamp(v, -1.f, 1.f) * 32767.f))) & 0xFFFFu; };
+
+        return pack(x) | (pack(z) << 16);
+    }
+
+    static float2 UnpackSnorm16(uint32_t packed)
+    {
+        return float2(static_cast<float>(static_cast<int16_t>(packed & 0xFFFFu)), static_cast<float>(static_cast<int16_t>(packed >> 16))) / 32767.f;
+    }
+
+    static uint32_t PackUnorm16(float x, float y)
+    {
+        const auto pack = [](float v) { return static_cast<uint32_t>(std::nearbyint(saturate(v) * 65535.f)); };
+
+        return pack(x) | (pack(y) << 16);
+    }
+
+    static float2 UnpackUnorm16(uint32_t packed)
+    {
+        return float2(static_cast<float>(packed & 0xFFFFu), static_cast<float>(packed >> 16)) / 65535.f;
+    }
+
+    TerrainClipmap::TerrainClipmap(const TerrainClipmapDesc& desc)
+        : m_Desc(desc)
+    {
+        // toroidal addressing requires a power of two resolution
+        uint32_t resolution = 1;
+        while (resolution < m_Desc.Resolution)
+        {
+            resolution *= 2;
+        }
+        m_Desc.Resolution = resolution;
+        m_Desc.LevelCount = std::max(m_Desc.LevelCount, 1u);
+
+        m_Levels.resize(m_Desc.LevelCount);
+        m_Texels.resize(static_cast<size_t>(m_Desc.LevelCount) * m_Desc.Resolution * m_Desc.Resolution, TerrainClipmapTexel{});
+    }
+
+    const TerrainClipmapUpdateStats& TerrainClipmap::Update(float cameraX, float cameraZ)
+    {
+        const auto startTime = std::chrono::high_resolution_clock::now();
+
+        m_UpdatedRegions.clear();
+        m_Stats = {};
+
+        const int32_t resolution = static_cast<int32_t>(m_Desc.Resolution);
+
+        // Unused budget accumulates up to a full level on top of the budget of this update,
+        // such that levels which have to be regenerated completely are not starved by the strips of finer levels
+        if (m_Desc.TexelBudget == 0)
+        {
+            m_TexelBalance = UINT64_MAX;
+        }
+        else
+        {
+            m_TexelBalance = std::min(m_TexelBalance + m_Desc.TexelBudget, static_cast<uint64_t>(resolution) * resolution + m_Desc.TexelBudget);
+        }
+
+        // Returns how many strips of stripTexelCount texels fit into the budget, at most count
+        const auto AllocateStrips = [&](uint32_t count, uint64_t stripTexelCount) {
+            const uint32_t strips = static_cast<uint32_t>(std::min<uint64_t>(count, m_TexelBalance / stripTexelCount));
+
+            m_TexelBalance -= strips * stripTexelCount;
+
+            return strips;
+        };
+
+        for (uint32_t l = 0; l < m_Desc.LevelCount; ++l)
+        {
+            auto& level = m_Levels[l];
+
+            const double  texelSize = GetLevelTexelSize(l);
+            const int32_t targetX   = static_cast<int32_t>(std::floor(cameraX / texelSize)) - resolution / 2;
+            const int32_t targetZ   = static_cast<int32_t>(std::floor(cameraZ / texelSize)) - resolution / 2;
+
+            const int32_t deltaX = targetX - level.OriginX;
+            const int32_t deltaZ = targetZ - level.OriginZ;
+
+            if (!level.Valid || (std::abs(deltaX) >= resolution) || (std::abs(deltaZ) >= resolution))
+            {
+                // no texel of the current window can be reused
+                if (AllocateStrips(1, static_cast<uint64_t>(resolution) * resolution) == 1)
+                {
+                    level.OriginX = targetX;
+                    level.OriginZ = targetZ;
+                    level.Valid   = true;
+
+                    ScheduleRegion(l, targetX, targetZ, resolution, resolution);
+                }
+            }
+            else
+            {
+                // Newly exposed columns. Texels of the columns moving out of the window are replaced in place.
+                if (deltaX != 0)
+                {
+                    const int32_t columns = static_cast<int32_t>(AllocateStrips(std::abs(deltaX), resolution));
+                    if (columns > 0)
+                    {
+                        level.OriginX += (deltaX > 0) ? columns : -columns;
+
+                        ScheduleRegion(l, (deltaX > 0) ? level.OriginX + resolution - columns : level.OriginX, level.OriginZ, columns, resolution);
+                    }
+                }
+
+                // Newly exposed rows, spanning the already moved columns
+                if (deltaZ != 0)
+                {
+                    const int32_t rows = static_cast<int32_t>(AllocateStrips(std::abs(deltaZ), resolution));
+                    if (rows > 0)
+                    {
+                        level.OriginZ += (deltaZ > 0) ? rows : -rows;
+
+                        ScheduleRegion(l, level.OriginX, (deltaZ > 0) ? level.OriginZ + resolution - rows : level.OriginZ, resolution, rows);
+                    }
+                }
+            }
+
+            if (!level.Valid || (level.OriginX != targetX) || (level.OriginZ != targetZ))
+            {
+                ++m_Stats.PendingLevelCount;
+            }
+        }
+
+        // Regions of the same level can overlap in texel memory, thus regions are baked in order & only the rows of a region are distributed across threads
+        const uint32_t threadCount = (m_Desc.ThreadCount > 0) ? m_Desc.ThreadCount : std::max(std::thread::hardware_concurrency(), 1u);
+
+        for (const auto& region : m_UpdatedRegions)
+        {
+            if ((threadCount > 1) && (m_Stats.RegeneratedTexelCount >= ParallelBakeTexelCount))
+            {
+                const uint32_t rowsPerThread = (region.Height + threadCount - 1) / threadCount;
+
+                std::vector<std::thread> threads;
+                for (uint32_t firstRow = 0; firstRow < region.Height; firstRow += rowsPerThread)
+                {
+                    threads.emplace_back([this, &region, firstRow, rowsPerThread]() {
+                        BakeRegion(region, firstRow, std::min(rowsPerThread, region.Height - firstRow));
+                    });
+                }
+                for (auto& thread : threads)
+                {
+                    thread.join();
+                }
+            }
+            else
+            {
+                BakeRegion(region, 0, region.Height);
+            }
+        }
+
+        UpdateUploadRanges();
+
+        m_Stats.BakeTimeMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+
+        return m_Stats;
+    }
+
+    const TerrainClipmapDesc& TerrainClipmap::GetDesc() const
+    {
+        return m_Desc;
+    }
+
+    const TerrainClipmapLevel& TerrainClipmap::GetLevel(uint32_t level) const
+    {
+        return m_Levels[level];
+    }
+
+    float TerrainClipmap::GetLevelTexelSize(uint32_t level) const
+    {
+        return m_Desc.TexelSize * static_cast<float>(1u << level);
+    }
+
+    const std::vector<TerrainClipmapTexel>& TerrainClipmap::GetTexels() const
+    {
+        return m_Texels;
+    }
+
+    const std::vector<TerrainClipmapRegion>& TerrainClipmap::GetUpdatedRegions() const
+    {
+        return m_UpdatedRegions;
+    }
+
+    const std::vector<TerrainClipmapUploadRange>& TerrainClipmap::GetUploadRanges() const
+    {
+        return m_UploadRanges;
+    }
+
+    const TerrainClipmapUpdateStats& TerrainClipmap::GetStats() const
+    {
+        return m_Stats;
+    }
+
+    float TerrainClipmap::Sample(const float2& position, TerrainClipmapSample& result) const
+    {
+        result = {};
+
+        const int32_t resolution = static_cast<int32_t>(m_Desc.Resolution);
+
+        // weight not yet covered by finer levels
+        float weight = 1.f;
+
+        for (uint32_t l = 0; l < m_Desc.LevelCount; ++l)
+        {
+            const auto& level = m_Levels[l];
+            if (!level.Valid)
+            {
+                continue;
+            }
+
+            const float2 texelPosition = position / GetLevelTexelSize(l);
+
+            // distance to the window border in texels, bilinear filtering reads texel & texel + 1
+            const float borderX = std::min(texelPosition.x - level.OriginX, (level.OriginX + resolution - 1) - texelPosition.x);
+            const float borderZ = std::min(texelPosition.y - level.OriginZ, (level.OriginZ + resolution - 1) - texelPosition.y);
+            const float border  = std::min(borderX, borderZ);
+            if (border < 0)
+            {
+                continue;
+            }
+
+            const float2  texel  = floor(texelPosition);
+            const float2  offset = texelPosition - texel;
+            const int32_t x      = static_cast<int32_t>(texel.x);
+            const int32_t z      = static_cast<int32_t>(texel.y);
+
+            const auto& t00 = m_Texels[GetTexelIndex(l, x, z)];
+            const auto& t10 = m_Texels[GetTexelIndex(l, x + 1, z)];
+            const auto& t01 = m_Texels[GetTexelIndex(l, x, z + 1)];
+            const auto& t11 = m_Texels[GetTexelIndex(l, x + 1, z + 1)];
+
+            const auto Bilinear = [&](float v00, float v10, float v01, float v11) { return lerp(lerp(v00, v10, offset.x), lerp(v01, v11, offset.x), offset.y); };
+
+            const float2 n00 = UnpackSnorm16(t00.Normal), n10 = UnpackSnorm16(t10.Normal), n01 = UnpackSnorm16(t01.Normal), n11 = UnpackSnorm16(t11.Normal);
+            const float2 b00 = UnpackUnorm16(t00.BiomeWeights), b10 = UnpackUnorm16(t10.BiomeWeights), b01 = UnpackUnorm16(t01.BiomeWeights),
+                         b11 = UnpackUnorm16(t11.BiomeWeights);
+
+            const float alpha       = saturate(border / m_Desc.BlendWidth);
+            const float levelWeight = weight * alpha;
+
+            result.Height += levelWeight * Bilinear(t00.Height, t10.Height, t01.Height, t11.Height);
+            result.NormalXZ = result.NormalXZ + levelWeight * float2(Bilinear(n00.x, n10.x, n01.x, n11.x), Bilinear(n00.y, n10.y, n01.y, n11.y));
+            result.BiomeWeights =
+                result.BiomeWeights + levelWeight * float2(Bilinear(b00.x, b10.x, b01.x, b11.x), Bilinear(b00.y, b10.y, b01.y, b11.y));
+
+            weight *= 1.f - alpha;
+            if (weight <= 0.f)
+            {
+                break;
+            }
+        }
+
+        return weight;
+    }
+
+    float TerrainClipmap::GetHeight(const float2& position) const
+    {
+        TerrainClipmapSample sample;
+        const float          weight = Sample(position, sample);
+
+        return (weight > 0.f) ? sample.Height + weight * meshnode::GetTerrainHeight(position) : sample.Height;
+    }
+
+    float3 TerrainClipmap::GetNormal(const float2& position) const
+    {
+        TerrainClipmapSample sample;
+        const float          weight = Sample(position, sample);
+
+        // outside of the clipmap
+        if (weight >= 1.f)
+        {
+            return meshnode::GetTerrainNormal(position);
+        }
+
+        float2 normalXZ = sample.NormalXZ;
+        if (weight > 0.f)
+        {
+            const float3 normal = meshnode::GetTerrainNormal(position);
+            normalXZ            = normalXZ + weight * float2(normal.x, normal.z);
+        }
+
+        return float3(normalXZ.x, std::sqrt(saturate(1.f - dot(normalXZ, normalXZ))), normalXZ.y);
+    }
+
+    float3 TerrainClipmap::GetBiomeWeights(const float2& position) const
+    {
+        TerrainClipmapSample sample;
+        const float          weight = Sample(position, sample);
+
+        float2 biomeWeights = sample.BiomeWeights;
+        if (weight > 0.f)
+        {
+            const float3 analyticBiomeWeights = meshnode::GetBiomeWeights(position);
+            biomeWeights                      = biomeWeights + weight * float2(analyticBiomeWeights.x, analyticBiomeWeights.y);
+        }
+
+        return float3(biomeWeights.x, biomeWeights.y, clamp(1.f - (biomeWeights.x + biomeWeights.y), 0.f, 1.f));
+    }
+
+    TerrainSample TerrainClipmap::GetTerrainSample(const float2& position) const
+    {
+        TerrainClipmapSample sample;
+        const float          weight = Sample(position, sample);
+
+        // outside of the clipmap
+        if (weight >= 1.f)
+        {
+            return meshnode::GetTerrainSample(position);
+        }
+
+        float  height       = sample.Height;
+        float2 normalXZ     = sample.NormalXZ;
+        float2 biomeWeights = sample.BiomeWeights;
+        if (weight > 0.f)
+        {
+            const TerrainSample analyticSample = meshnode::GetTerrainSample(position);
+
+            height += weight * analyticSample.Height;
+            normalXZ     = normalXZ + weight * float2(analyticSample.Normal.x, analyticSample.Normal.z);
+            biomeWeights = biomeWeights + weight * float2(analyticSample.BiomeWeights.x, analyticSample.BiomeWeights.y);
+        }
+
+        TerrainSample result;
+        result.Height       = height;
+        result.Normal       = float3(normalXZ.x, std::sqrt(saturate(1.f - dot(normalXZ, normalXZ))), normalXZ.y);
+        result.BiomeWeights = float3(biomeWeights.x, biomeWeights.y, clamp(1.f - (biomeWeights.x + biomeWeights.y), 0.f, 1.f));
+
+        return result;
+    }
+
+    void TerrainClipmap::ScheduleRegion(uint32_t level, int32_t x, int32_t z, uint32_t width, uint32_t height)
+    {
+        m_UpdatedRegions.push_back({level, x, z, width, height});
+
+        ++m_Stats.RegionCount;
+        m_Stats.RegeneratedTexelCount += static_cast<uint64_t>(width) * height;
+    }
+
+    void TerrainClipmap::BakeRegion(const TerrainClipmapRegion& region, uint32_t firstRow, uint32_t rowCount)
+    {
+        const float  texelSize  = GetLevelTexelSize(region.Level);
+        const size_t texelCount = static_cast<size_t>(region.Width) * rowCount;
+
+        // all rows are evaluated with a single batch, such that narrow column strips still fill the SIMD lanes
+        std::vector<float> x(texelCount), z(texelCount), height(texelCount);
+        std::vector<float> gradientX(texelCount), gradientZ(texelCount);
+        std::vector<float> mountain(texelCount), woodland(texelCount), grassland(texelCount);
+
+        for (uint32_t row = 0; row < rowCount; ++row)
+        {
+            for (uint32_t column = 0; column < region.Width; ++column)
+            {
+                x[row * region.Width + column] = static_cast<float>(region.X + static_cast<int32_t>(column)) * texelSize;
+                z[row * region.Width + column] = static_cast<float>(region.Z + static_cast<int32_t>(firstRow + row)) * texelSize;
+            }
+        }
+
+        // height & normal from a single pass over the height noise
+        GetTerrainHeightAndGradientBatch(x.data(), z.data(), height.data(), gradientX.data(), gradientZ.data(), texelCount);
+        GetBiomeWeightsBatch(x.data(), z.data(), mountain.data(), woodland.data(), grassland.data(), texelCount);
+
+        for (uint32_t row = 0; row < rowCount; ++row)
+        {
+            for (uint32_t column = 0; column < region.Width; ++column)
+            {
+                const size_t i      = row * region.Width + column;
+                const float3 normal = normalize(float3(-gradientX[i], 1, -gradientZ[i]));
+
+                auto& texel = m_Texels[GetTexelIndex(region.Level, region.X + static_cast<int32_t>(column), region.Z + static_cast<int32_t>(firstRow + row))];
+                texel.Height       = height[i];
+                texel.Normal       = PackSnorm16(normal.x, normal.z);
+                texel.BiomeWeights = PackUnorm16(mountain[i], woodland[i]);
+            }
+        }
+    }
+
+    void TerrainClipmap::UpdateUploadRanges()
+    {
+        m_UploadRanges.clear();
+
+        const uint32_t resolution = m_Desc.Resolution;
+
+        // Each row of a region is contiguous in texel memory, except where it wraps around the level border
+        for (const auto& region : m_UpdatedRegions)
+        {
+            const uint32_t firstColumn = static_cast<uint32_t>(region.X) & (resolution - 1);
+            const uint32_t width       = std::min(region.Width, resolution - firstColumn);
+
+            for (uint32_t row = 0; row < region.Height; ++row)
+            {
+                const size_t rowStart = GetTexelIndex(region.Level, 0, region.Z + static_cast<int32_t>(row));
+
+                m_UploadRanges.push_back({rowStart + firstColumn, width});
+                if (width < region.Width)
+                {
+                    m_UploadRanges.push_back({rowStart, region.Width - width});
+                }
+            }
+        }
+
+        // merge overlapping & adjacent ranges, e.g. the rows of row strips
+        std::sort(m_UploadRanges.begin(), m_UploadRanges.end(), [](const TerrainClipmapUploadRange& a, const TerrainClipmapUploadRange& b) {
+            return a.FirstTexel < b.FirstTexel;
+        });
+
+        size_t mergedCount = 0;
+        for (const auto& range : m_UploadRanges)
+        {
+            if ((mergedCount > 0) && (range.FirstTexel <= m_UploadRanges[mergedCount - 1].FirstTexel + m_UploadRanges[mergedCount - 1].TexelCount))
+            {
+                auto& merged      = m_UploadRanges[mergedCount - 1];
+                merged.TexelCount = std::max(merged.FirstTexel + merged.TexelCount, range.FirstTexel + range.TexelCount) - merged.FirstTexel;
+            }
+            else
+            {
+                m_UploadRanges[mergedCount++] = range;
+            }
+        }
+        m_UploadRanges.resize(mergedCount);
+
+        for (const auto& range : m_UploadRanges)
+        {
+            m_Stats.UploadTexelCount += range.TexelCount;
+        }
+    }
+
+    size_t TerrainClipmap::GetTexelIndex(uint32_t level, int32_t x, int32_t z) const
+    {
+        const uint32_t mask = m_Desc.Resolution - 1;
+
+        return (static_cast<size_t>(level) * m_Desc.Resolution + (static_cast<uint32_t>(z) & mask)) * m_Desc.Resolution + (static_cast<uint32_t>(x) & mask);
+    }
+}  // namespace meshnode
@@ -0,0 +1,178 @@
+// This file is part of the AMD Work Graph Mesh Node Sample.
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#pragma once
+
+#include "terrain.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Camera-centred clipmap cache of terrain height, normal & biome weights.
+// The GPU counterpart samples the clipmap in shaders/heightmap.hlsl, changes to the texel layout or sampling must be mirrored there.
+namespace meshnode
+{
+    /**
+     * Single clipmap texel, same layout as TerrainClipmapTexel in heightmap.hlsl.
+     * Normal stores x & z as snorm16, y is reconstructed (terrain normals always point up).
+     * BiomeWeights stores mountain & woodland weights as unorm16, grassland is derived the same way as in GetBiomeWeights.
+     */
+    struct TerrainClipmapTexel
+    {
+        float    Height;
+        uint32_t Normal;
+        uint32_t BiomeWeights;
+    };
+
+    struct TerrainClipmapDesc
+    {
+        uint32_t LevelCount = 6;
+        // texels per level side, must be a power of two
+        uint32_t Resolution = 256;
+        // world-space size of a texel on the finest level, doubles with every level
+        float TexelSize = 1.f;
+        // width of the band in texels in which a level is blended with the next coarser level
+        float BlendWidth = 16.f;
+        // average number of texels regenerated per update, 0 = unlimited.
+        // Unused budget is carried over to later updates, up to the size of a level.
+        uint32_t TexelBudget = 0;
+        // worker threads for regenerating large regions, 0 = one per hardware thread
+        uint32_t ThreadCount = 0;
+    };
+
+    struct TerrainClipmapLevel
+    {
+        // texel coordinates of the first texel in the level window. Texel (x, z) is located at world position (x, z) * texel size.
+        int32_t OriginX = 0;
+        int32_t OriginZ = 0;
+        // false until the level was generated for the first time
+        bool Valid = false;
+    };
+
+    /**
+     * Rectangle of texels regenerated by an update, in texel coordinates of the level.
+     */
+    struct TerrainClipmapRegion
+    {
+        uint32_t Level;
+        int32_t  X;
+        int32_t  Z;
+        uint32_t Width;
+        uint32_t Height;
+    };
+
+    /**
+     * Contiguous range of texels in GetTexels() modified by an update.
+     */
+    struct TerrainClipmapUploadRange
+    {
+        size_t FirstTexel;
+        size_t TexelCount;
+    };
+
+    struct TerrainClipmapUpdateStats
+    {
+        uint32_t RegionCount           = 0;
+        uint64_t RegeneratedTexelCount = 0;
+        uint64_t UploadTexelCount      = 0;
+        // levels not centred on the camera after the update due to the texel budget
+        uint32_t PendingLevelCount = 0;
+        double   BakeTimeMs        = 0.0;
+    };
+
+    /**
+     * Interpolated clipmap values, see TerrainClipmap::Sample.
+     */
+    struct TerrainClipmapSample
+    {
+        float  Height = 0.f;
+        float2 NormalXZ;
+        // x = mountain, y = woodland
+        float2 BiomeWeights;
+    };
+
+    class TerrainClipmap
+    {
+    public:
+        explicit TerrainClipmap(const TerrainClipmapDesc& desc);
+
+        /**
+         * @brief   Move all levels towards the camera. Only texels in newly exposed toroidal strips are regenerated,
+         *          levels which were never generated or moved by more than a level size are regenerated completely.
+         *          Levels that do not fit into the texel budget keep their previous window, which remains valid for sampling.
+         */
+        const TerrainClipmapUpdateStats& Update(float cameraX, float cameraZ);
+
+        const TerrainClipmapDesc&  GetDesc() const;
+        const TerrainClipmapLevel& GetLevel(uint32_t level) const;
+        float                      GetLevelTexelSize(uint32_t level) const;
+
+        /**
+         * @brief   Texels of all levels. Level l starts at l * Resolution^2, texel (x, z) is stored at row z & (Resolution - 1),
+         *          column x & (Resolution - 1).
+         */
+        const std::vector<TerrainClipmapTexel>& GetTexels() const;
+
+        /**
+         * @brief   Regions regenerated & texel ranges modified by the last update.
+         */
+        const std::vector<TerrainClipmapRegion>&      GetUpdatedRegions() const;
+        const std::vector<TerrainClipmapUploadRange>& GetUploadRanges() const;
+        const TerrainClipmapUpdateStats&              GetStats() const;
+
+        /**
+         * @brief   Blend of all levels containing position, same as SampleTerrainClipmap in heightmap.hlsl.
+         *          Returns the remaining weight, which has to be filled in with the analytic terrain functions.
+         */
+        float Sample(const float2& position, TerrainClipmapSample& result) const;
+
+        /**
+         * @brief   Clipmap counterparts of GetTerrainHeight, GetTerrainNormal & GetBiomeWeights.
+         *          Falls back to the analytic functions outside of the clipmap, same as the work graph shaders.
+         */
+        float  GetHeight(const float2& position) const;
+        float3 GetNormal(const float2& position) const;
+        float3 GetBiomeWeights(const float2& position) const;
+
+        /**
+         * @brief   Clipmap counterpart of GetTerrainSample, same as GetTerrainSample in heightmap.hlsl.
+         *          Blends all values from a single clipmap lookup & a single analytic evaluation.
+         */
+        TerrainSample GetTerrainSample(const float2& position) const;
+
+    private:
+        void   ScheduleRegion(uint32_t level, int32_t x, int32_t z, uint32_t width, uint32_t height);
+        void   BakeRegion(const TerrainClipmapRegion& region, uint32_t firstRow, uint32_t rowCount);
+        void   UpdateUploadRanges();
+        size_t GetTexelIndex(uint32_t level, int32_t x, int32_t z) const;
+
+        TerrainClipmapDesc                     m_Desc;
+        std::vector<TerrainClipmapLevel>       m_Levels;
+        std::vector<TerrainClipmapTexel>       m_Texels;
+        std::vector<TerrainClipmapRegion>      m_UpdatedRegions;
+        std::vector<TerrainClipmapUploadRange> m_UploadRanges;
+        TerrainClipmapUpdateStats              m_Stats;
+        // texels that can be regenerated by the next update, see TerrainClipmapDesc::TexelBudget
+        uint64_t m_TexelBalance = 0;
+    };
+}  // namespace meshnode
@@ -0,0 +1,49 @@
+// This file is part of the AMD Work Graph Mesh Node Sample.
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#pragma once
+
+// Internal interface between the batch functions in terrain.cpp and the per-instruction set kernels.
+
+#include <cstddef>
+
+namespace meshnode
+{
+    namespace detail
+    {
+        struct TerrainKernels
+        {
+            void (*PerlinNoise2D)(const float* x, const float* y, float* noise, size_t count);
+            void (*GetBiomeWeights)(const float* x, const float* z, float* mountain, float* woodland, float* grassland, size_t count);
+            void (*GetTerrainHeight)(const float* x, const float* z, float* height, size_t count);
+            void (*GetTerrainHeightAndGradient)(const float* x, const float* z, float* height, float* gradientX, float* gradientZ, size_t count);
+            void (*GetTerrainNormal)(const float* x, const float* z, float* normalX, float* normalY, float* normalZ, size_t count);
+            void (*IsBoxVisible)(const float* const boxMin[3], const float* const boxMax[3], const float* planes, float* visible, size_t count);
+        };
+
+        const TerrainKernels& GetTerrainKernelsGeneric();
+#ifdef MESHNODE_CPU_X86
+        const TerrainKernels& GetTerrainKernelsAvx2();
+        const TerrainKernels& GetTerrainKernelsAvx512();
+#endif  // MESHNODE_CPU_X86
+    }  // namespace detail
+}  // namespace meshnode
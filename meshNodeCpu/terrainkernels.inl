@@ -0,0 +1,544 @@
+// This file is part of the AMD Work Graph Mesh Node Sample.
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+// SIMD kernels of the terrain functions, see terrain.cpp for the scalar reference.
+// This file is included by the per-instruction set translation units inside their own namespace, after defining:
+//   Width                          number of lanes
+//   vfloat, vint, vintmask         vector types
+//   Load, Store, Set, SetInt       memory access & broadcast
+//   + - * / & unary - on vfloat, + - * on vint
+//   Floor, RoundEven, Abs, Sqrt    per-lane float functions
+//   Min, Max                       same semantics as std::min & std::max, including signed zeros
+//   ToInt (truncating), ToFloat    conversions
+//   LessThan, Select               int & float compare, select
+// Every operation must match the scalar reference exactly, such that all instruction sets produce bit-identical results.
+// Standard library templates are not used, as their out-of-line instantiations could be shared with translation units compiled for other instruction sets.
+
+static vfloat Pow2(const vfloat& v)
+{
+    return v * v;
+}
+
+static vfloat Pow3(const vfloat& v)
+{
+    return v * v * v;
+}
+
+static vfloat Pow4(const vfloat& v)
+{
+    const vfloat v2 = v * v;
+    return v2 * v2;
+}
+
+static vfloat Clamp(const vfloat& v, float lo, float hi)
+{
+    return Min(Max(v, Set(lo)), Set(hi));
+}
+
+static vfloat Saturate(const vfloat& v)
+{
+    return Clamp(v, 0.f, 1.f);
+}
+
+static vfloat Smoothstep(float a, float b, const vfloat& x)
+{
+    const vfloat t = Saturate((x - Set(a)) / Set(b - a));
+    return t * t * (Set(3.f) - Set(2.f) * t);
+}
+
+static vfloat Lerp(const vfloat& a, const vfloat& b, const vfloat& t)
+{
+    return a + t * (b - a);
+}
+
+static vfloat Frac(const vfloat& v)
+{
+    return v - Floor(v);
+}
+
+// C++ & HLSL remainder of integer division by 289, result has the sign of the dividend.
+// Quotient is estimated in float & corrected, which is exact for |a| < 2^24.
+static vint Remainder289(const vint& a)
+{
+    const vint zero    = SetInt(0);
+    const vint divisor = SetInt(289);
+
+    const vint absA     = Select(LessThan(a, zero), zero - a, a);
+    const vint quotient = ToInt(ToFloat(absA) * Set(1.f / 289.f));
+
+    vint remainder = absA - quotient * divisor;
+    remainder      = Select(LessThan(remainder, zero), remainder + divisor, remainder);
+    remainder      = Select(LessThan(SetInt(288), remainder), remainder - divisor, remainder);
+
+    return Select(LessThan(a, zero), zero - remainder, remainder);
+}
+
+// fmod by 289 for integral float values with |v| < 2^24, which holds for all values in PerlinNoiseDir2D
+static vfloat FloatRemainder289(const vfloat& v)
+{
+    return ToFloat(Remainder289(ToInt(v)));
+}
+
+static void PerlinNoiseDir2D(const vint& positionX, const vint& positionY, vfloat& directionX, vfloat& directionY)
+{
+    const vint posX = Remainder289(positionX);
+    const vint posY = Remainder289(positionY);
+
+    vfloat f = ToFloat(SetInt(34) * posX + SetInt(1));
+    f        = FloatRemainder289(f * ToFloat(posX)) + ToFloat(posY);
+    f        = FloatRemainder289((Set(34.f) * f + Set(1.f)) * f);
+    f        = Frac(f / Set(43.f)) * Set(2.f) - Set(1.f);
+
+    const vfloat x = f - RoundEven(f);
+    const vfloat y = Abs(f) - Set(0.5f);
+
+    const vfloat length = Sqrt(x * x + y * y);
+
+    directionX = x / length;
+    directionY = y / length;
+}
+
+static vfloat PerlinNoise2D(const vfloat& positionX, const vfloat& positionY)
+{
+    const vfloat floorX = Floor(positionX);
+    const vfloat floorY = Floor(positionY);
+    const vint   gridX  = ToInt(floorX);
+    const vint   gridY  = ToInt(floorY);
+    const vint   one    = SetInt(1);
+
+    const vfloat offsetX = positionX - floorX;
+    const vfloat offsetY = positionY - floorY;
+
+    // offset - 0 is exact, the subtraction is kept to match the scalar reference for signed zeros
+    const vfloat offsetX0 = offsetX - Set(0.f);
+    const vfloat offsetY0 = offsetY - Set(0.f);
+    const vfloat offsetX1 = offsetX - Set(1.f);
+    const vfloat offsetY1 = offsetY - Set(1.f);
+
+    vfloat directionX, directionY;
+
+    PerlinNoiseDir2D(gridX, gridY, directionX, directionY);
+    const vfloat d00 = directionX * offsetX0 + directionY * offsetY0;
+    PerlinNoiseDir2D(gridX, gridY + one, directionX, directionY);
+    const vfloat d01 = directionX * offsetX0 + directionY * offsetY1;
+    PerlinNoiseDir2D(gridX + one, gridY, directionX, directionY);
+    const vfloat d10 = directionX * offsetX1 + directionY * offsetY0;
+    PerlinNoiseDir2D(gridX + one, gridY + one, directionX, directionY);
+    const vfloat d11 = directionX * offsetX1 + directionY * offsetY1;
+
+    const vfloat weightX = offsetX * offsetX * offsetX * (offsetX * (offsetX * Set(6.f) - Set(15.f)) + Set(10.f));
+    const vfloat weightY = offsetY * offsetY * offsetY * (offsetY * (offsetY * Set(6.f) - Set(15.f)) + Set(10.f));
+
+    const vfloat d0 = Lerp(d00, d01, weightY);
+    const vfloat d1 = Lerp(d10, d11, weightY);
+
+    return Lerp(d0, d1, weightX);
+}
+
+static vfloat PerlinNoise2D(float scale, const vfloat& x, const vfloat& y)
+{
+    return PerlinNoise2D(Set(scale) * x, Set(scale) * y);
+}
+
+static vfloat PerlinNoise2D(float scale, const vfloat& x, const vfloat& y, float offsetX, float offsetY)
+{
+    return PerlinNoise2D(Set(scale) * x + Set(offsetX), Set(scale) * y + Set(offsetY));
+}
+
+// Mountain factor before squaring & the noise term shared by all biome factors
+static vfloat GetMountainFactor(const vfloat& posX, const vfloat& posY, const vfloat& noise01)
+{
+    vfloat mountainFactor = Set(0.f);
+    mountainFactor        = mountainFactor + Set(1.f) * PerlinNoise2D(0.5f, posX, posY);
+    mountainFactor        = mountainFactor + Set(2.f) * PerlinNoise2D(0.2f, posX, posY, 38.f, 23.f);
+    mountainFactor        = mountainFactor + Set(4.f) * noise01;
+
+    return mountainFactor;
+}
+
+static vfloat GetMountainWeight(const vfloat& x, const vfloat& z)
+{
+    const vfloat posX    = x * Set(0.01f);
+    const vfloat posY    = z * Set(0.01f);
+    const vfloat noise01 = PerlinNoise2D(0.1f, posX, posY);
+
+    return Clamp(Pow2(Clamp(GetMountainFactor(posX, posY, noise01), 0.f, 1.f)), 0.f, 1.f);
+}
+
+static void GetBiomeWeights(const vfloat& x, const vfloat& z, vfloat& mountain, vfloat& woodland, vfloat& grassland)
+{
+    const vfloat posX = x * Set(0.01f);
+    const vfloat posY = z * Set(0.01f);
+    // PerlinNoise2D(0.1 * pos) is used three times
+    const vfloat noise01 = PerlinNoise2D(0.1f, posX, posY);
+
+    vfloat mountainFactor = GetMountainFactor(posX, posY, noise01);
+
+    vfloat woodlandMountainFactor = Set(1.f) - Smoothstep(0.f, 1.f, Set(4.f) * Pow2(mountainFactor - Set(0.5f)));
+    woodlandMountainFactor        = woodlandMountainFactor - Pow4(Set(4.f) * noise01);
+    mountainFactor                = Clamp(Pow2(Clamp(mountainFactor, 0.f, 1.f)), 0.f, 1.f);
+
+    vfloat woodlandFactor = Set(0.f);
+    woodlandFactor        = woodlandFactor + Set(1.f) * Pow3(Set(4.f) * PerlinNoise2D(0.3f, posX, posY));
+    woodlandFactor        = woodlandFactor + Set(5.f) * Pow2(Set(1.f) * noise01);
+    woodlandFactor        = Clamp(Smoothstep(0.f, 1.f, woodlandFactor), 0.f, 1.f);
+
+    woodlandFactor = Smoothstep(0.f, 1.f, Max(woodlandMountainFactor, woodlandFactor - mountainFactor));
+
+    mountain  = mountainFactor;
+    woodland  = woodlandFactor;
+    grassland = Clamp(Set(1.f) - (mountainFactor + woodlandFactor), 0.f, 1.f);
+}
+
+static vfloat GetTerrainHeight(const vfloat& x, const vfloat& z)
+{
+    // height only depends on the mountain weight, woodland & grassland weights are skipped
+    const vfloat mountain = GetMountainWeight(x, z);
+
+    const vfloat sampleX = x / Set(400.f);
+    const vfloat sampleY = z / Set(400.f);
+
+    vfloat baseHeight = Set(0.f);
+    baseHeight        = baseHeight + Set(1.0f) * PerlinNoise2D(1.0f, sampleX, sampleY, 34.f, 98.f);
+    baseHeight        = baseHeight + Set(0.35f) * PerlinNoise2D(2.0f, sampleX, sampleY, 73.f, 42.f);
+    baseHeight        = baseHeight + Set(0.25f) * Max(PerlinNoise2D(3.2f, sampleX, sampleY, +0.5f, -0.5f),  //
+                                                      PerlinNoise2D(3.5f, sampleX, sampleY, -0.5f, +0.5f));
+    baseHeight        = baseHeight + Set(0.15f) * PerlinNoise2D(4.0f, sampleX, sampleY);
+    baseHeight        = baseHeight + Set(0.08f) * PerlinNoise2D(8.0f, sampleX, sampleY);
+    baseHeight        = baseHeight + Set(0.07f) * PerlinNoise2D(9.0f, sampleX, sampleY);
+
+    vfloat height = Set(140.0f) * baseHeight * baseHeight;
+
+    vfloat mountainHeight = Set(0.f);
+    mountainHeight        = mountainHeight + Set(0.97f) * PerlinNoise2D(1.0f, sampleX, sampleY);
+    mountainHeight        = mountainHeight + Set(0.95f) * Max(PerlinNoise2D(2.8f, sampleX, sampleY, +2.3f, -4.5f),  //
+                                                              PerlinNoise2D(3.1f, sampleX, sampleY, -6.5f, +3.6f));
+    mountainHeight        = mountainHeight + Set(0.75f) * PerlinNoise2D(2.0f, sampleX, sampleY, 34.f, 56.f);
+
+    height = height + Set(70.0f) * mountainHeight * mountainHeight * Smoothstep(0.5f, 1.0f, mountain);
+    height = height + Set(40.0f) * Smoothstep(0.0f, 1.0f, mountain);
+
+    return height;
+}
+
+// Value & gradient, see float3 results of the scalar ...WithGradient functions
+struct vfloat3
+{
+    vfloat x;
+    vfloat y;
+    vfloat z;
+};
+
+// a + s * b
+static vfloat3 AddScaled(const vfloat3& a, float s, const vfloat3& b)
+{
+    return {a.x + Set(s) * b.x, a.y + Set(s) * b.y, a.z + Set(s) * b.z};
+}
+
+static vfloat3 PerlinNoise2DWithGradient(const vfloat& positionX, const vfloat& positionY)
+{
+    const vfloat floorX = Floor(positionX);
+    const vfloat floorY = Floor(positionY);
+    const vint   gridX  = ToInt(floorX);
+    const vint   gridY  = ToInt(floorY);
+    const vint   one    = SetInt(1);
+
+    const vfloat offsetX = positionX - floorX;
+    const vfloat offsetY = positionY - floorY;
+
+    const vfloat offsetX0 = offsetX - Set(0.f);
+    const vfloat offsetY0 = offsetY - Set(0.f);
+    const vfloat offsetX1 = offsetX - Set(1.f);
+    const vfloat offsetY1 = offsetY - Set(1.f);
+
+    vfloat g00X, g00Y, g01X, g01Y, g10X, g10Y, g11X, g11Y;
+    PerlinNoiseDir2D(gridX, gridY, g00X, g00Y);
+    PerlinNoiseDir2D(gridX, gridY + one, g01X, g01Y);
+    PerlinNoiseDir2D(gridX + one, gridY, g10X, g10Y);
+    PerlinNoiseDir2D(gridX + one, gridY + one, g11X, g11Y);
+
+    const vfloat d00 = g00X * offsetX0 + g00Y * offsetY0;
+    const vfloat d01 = g01X * offsetX0 + g01Y * offsetY1;
+    const vfloat d10 = g10X * offsetX1 + g10Y * offsetY0;
+    const vfloat d11 = g11X * offsetX1 + g11Y * offsetY1;
+
+    const vfloat weightX     = offsetX * offsetX * offsetX * (offsetX * (offsetX * Set(6.f) - Set(15.f)) + Set(10.f));
+    const vfloat weightY     = offsetY * offsetY * offsetY * (offsetY * (offsetY * Set(6.f) - Set(15.f)) + Set(10.f));
+    const vfloat derivativeX = Set(30.f) * offsetX * offsetX * (offsetX * (offsetX - Set(2.f)) + Set(1.f));
+    const vfloat derivativeY = Set(30.f) * offsetY * offsetY * (offsetY * (offsetY - Set(2.f)) + Set(1.f));
+
+    const vfloat d0 = Lerp(d00, d01, weightY);
+    const vfloat d1 = Lerp(d10, d11, weightY);
+
+    const vfloat gradient0X = Lerp(g00X, g01X, weightY);
+    const vfloat gradient0Y = Lerp(g00Y, g01Y, weightY) + (d01 - d00) * derivativeY;
+    const vfloat gradient1X = Lerp(g10X, g11X, weightY);
+    const vfloat gradient1Y = Lerp(g10Y, g11Y, weightY) + (d11 - d10) * derivativeY;
+
+    return {Lerp(d0, d1, weightX), Lerp(gradient0X, gradient1X, weightX) + (d1 - d0) * derivativeX, Lerp(gradient0Y, gradient1Y, weightX)};
+}
+
+static vfloat3 PerlinNoise2DWithGradient(float scale, const vfloat& x, const vfloat& y)
+{
+    const vfloat3 noise = PerlinNoise2DWithGradient(Set(scale) * x, Set(scale) * y);
+
+    return {noise.x, Set(scale) * noise.y, Set(scale) * noise.z};
+}
+
+static vfloat3 PerlinNoise2DWithGradient(float scale, const vfloat& x, const vfloat& y, float offsetX, float offsetY)
+{
+    const vfloat3 noise = PerlinNoise2DWithGradient(Set(scale) * x + Set(offsetX), Set(scale) * y + Set(offsetY));
+
+    return {noise.x, Set(scale) * noise.y, Set(scale) * noise.z};
+}
+
+// (a.x < b.x) ? b : a, same as std::max on the values
+static vfloat3 MaxWithGradient(const vfloat3& a, const vfloat3& b)
+{
+    const vintmask selectB = LessThan(a.x, b.x);
+
+    return {Select(selectB, b.x, a.x), Select(selectB, b.y, a.y), Select(selectB, b.z, a.z)};
+}
+
+static vfloat SmoothstepDerivative(float a, float b, const vfloat& x)
+{
+    const vfloat t = Saturate((x - Set(a)) / Set(b - a));
+    return Set(6.f) * t * (Set(1.f) - t) / Set(b - a);
+}
+
+static vfloat3 GetTerrainHeightAndGradient(const vfloat& x, const vfloat& z)
+{
+    const vfloat posX = x * Set(0.01f);
+    const vfloat posY = z * Set(0.01f);
+
+    vfloat3 mountainFactor = {Set(0.f), Set(0.f), Set(0.f)};
+    mountainFactor         = AddScaled(mountainFactor, 1.f, PerlinNoise2DWithGradient(0.5f, posX, posY));
+    mountainFactor         = AddScaled(mountainFactor, 2.f, PerlinNoise2DWithGradient(0.2f, posX, posY, 38.f, 23.f));
+    mountainFactor         = AddScaled(mountainFactor, 4.f, PerlinNoise2DWithGradient(0.1f, posX, posY));
+
+    const vfloat   mountainFactorClamped = Clamp(mountainFactor.x, 0.f, 1.f);
+    const vfloat   mountain              = Clamp(Pow2(mountainFactorClamped), 0.f, 1.f);
+    const vintmask aboveZero             = LessThan(Set(0.f), mountainFactor.x);
+    const vintmask belowOne              = LessThan(mountainFactor.x, Set(1.f));
+    const vfloat   mountainGradientScale = Set(2.f) * mountainFactorClamped * Set(0.01f);
+    const vfloat   mountainGradientX     = Select(aboveZero, Select(belowOne, mountainGradientScale * mountainFactor.y, Set(0.f)), Set(0.f));
+    const vfloat   mountainGradientY     = Select(aboveZero, Select(belowOne, mountainGradientScale * mountainFactor.z, Set(0.f)), Set(0.f));
+
+    const vfloat sampleX = x / Set(400.f);
+    const vfloat sampleY = z / Set(400.f);
+
+    vfloat3 baseHeight = {Set(0.f), Set(0.f), Set(0.f)};
+    baseHeight         = AddScaled(baseHeight, 1.0f, PerlinNoise2DWithGradient(1.0f, sampleX, sampleY, 34.f, 98.f));
+    baseHeight         = AddScaled(baseHeight, 0.35f, PerlinNoise2DWithGradient(2.0f, sampleX, sampleY, 73.f, 42.f));
+    baseHeight         = AddScaled(baseHeight,
+                           0.25f,
+                           MaxWithGradient(PerlinNoise2DWithGradient(3.2f, sampleX, sampleY, +0.5f, -0.5f),  //
+                                           PerlinNoise2DWithGradient(3.5f, sampleX, sampleY, -0.5f, +0.5f)));
+    baseHeight         = AddScaled(baseHeight, 0.15f, PerlinNoise2DWithGradient(4.0f, sampleX, sampleY));
+    baseHeight         = AddScaled(baseHeight, 0.08f, PerlinNoise2DWithGradient(8.0f, sampleX, sampleY));
+    baseHeight         = AddScaled(baseHeight, 0.07f, PerlinNoise2DWithGradient(9.0f, sampleX, sampleY));
+
+    vfloat3 mountainHeight = {Set(0.f), Set(0.f), Set(0.f)};
+    mountainHeight         = AddScaled(mountainHeight, 0.97f, PerlinNoise2DWithGradient(1.0f, sampleX, sampleY));
+    mountainHeight         = AddScaled(mountainHeight,
+                               0.95f,
+                               MaxWithGradient(PerlinNoise2DWithGradient(2.8f, sampleX, sampleY, +2.3f, -4.5f),  //
+                                               PerlinNoise2DWithGradient(3.1f, sampleX, sampleY, -6.5f, +3.6f)));
+    mountainHeight         = AddScaled(mountainHeight, 0.75f, PerlinNoise2DWithGradient(2.0f, sampleX, sampleY, 34.f, 56.f));
+
+    const vfloat mountainBlend = Smoothstep(0.5f, 1.0f, mountain);
+
+    vfloat height = Set(140.0f) * baseHeight.x * baseHeight.x;
+    height        = height + Set(70.0f) * mountainHeight.x * mountainHeight.x * mountainBlend;
+    height        = height + Set(40.0f) * Smoothstep(0.0f, 1.0f, mountain);
+
+    const vfloat baseScale     = Set(280.0f) * baseHeight.x;
+    const vfloat mountainScale = Set(140.0f) * mountainHeight.x * mountainBlend;
+    const vfloat biomeScale    = Set(70.0f) * mountainHeight.x * mountainHeight.x * SmoothstepDerivative(0.5f, 1.0f, mountain) +
+                              Set(40.0f) * SmoothstepDerivative(0.0f, 1.0f, mountain);
+
+    vfloat gradientX = baseScale * baseHeight.y;
+    vfloat gradientY = baseScale * baseHeight.z;
+    gradientX        = gradientX + mountainScale * mountainHeight.y;
+    gradientY        = gradientY + mountainScale * mountainHeight.z;
+    gradientX        = gradientX / Set(400.f);
+    gradientY        = gradientY / Set(400.f);
+    gradientX        = gradientX + biomeScale * mountainGradientX;
+    gradientY        = gradientY + biomeScale * mountainGradientY;
+
+    return {height, gradientX, gradientY};
+}
+
+static void GetTerrainNormal(const vfloat& x, const vfloat& z, vfloat& normalX, vfloat& normalY, vfloat& normalZ)
+{
+    const vfloat3 heightAndGradient = GetTerrainHeightAndGradient(x, z);
+
+    // normalize(float3(-gradient.x, 1, -gradient.z))
+    const vfloat nx     = -heightAndGradient.y;
+    const vfloat ny     = Set(1.f);
+    const vfloat nz     = -heightAndGradient.z;
+    const vfloat length = Sqrt(nx * nx + ny * ny + nz * nz);
+
+    normalX = nx / length;
+    normalY = ny / length;
+    normalZ = nz / length;
+}
+
+// Frustum test of boxes against 6 planes (xyz = normal, w = distance), see AxisAlignedBoundingBox::IsVisible in utils.hlsl.
+// The box corner closest to the inside of a plane only depends on the plane, thus it is selected once per plane for all lanes.
+static vfloat IsBoxVisible(const vfloat boxMin[3], const vfloat boxMax[3], const float* planes)
+{
+    vfloat visible = Set(1.f);
+
+    for (int i = 0; i < 6; ++i)
+    {
+        const float* plane = planes + i * 4;
+
+        const vfloat& axisX = (plane[0] < 0.f) ? boxMin[0] : boxMax[0];
+        const vfloat& axisY = (plane[1] < 0.f) ? boxMin[1] : boxMax[1];
+        const vfloat& axisZ = (plane[2] < 0.f) ? boxMin[2] : boxMax[2];
+
+        const vfloat distance = Set(plane[0]) * axisX + Set(plane[1]) * axisY + Set(plane[2]) * axisZ + Set(plane[3]);
+
+        visible = Select(LessThan(distance, Set(0.f)), Set(0.f), visible);
+    }
+
+    return visible;
+}
+
+// ========================
+// Batch drivers, the last partial batch is padded with zeros
+
+static vfloat LoadPartial(const float* pData, size_t count)
+{
+    if (count == Width)
+    {
+        return Load(pData);
+    }
+
+    float lanes[Width] = {};
+    for (size_t i = 0; i < count; ++i)
+    {
+        lanes[i] = pData[i];
+    }
+    return Load(lanes);
+}
+
+static void StorePartial(float* pData, const vfloat& v, size_t count)
+{
+    if (count == Width)
+    {
+        Store(pData, v);
+        return;
+    }
+
+    float lanes[Width];
+    Store(lanes, v);
+    for (size_t i = 0; i < count; ++i)
+    {
+        pData[i] = lanes[i];
+    }
+}
+
+static void PerlinNoise2DBatch(const float* x, const float* y, float* noise, size_t count)
+{
+    for (size_t i = 0; i < count; i += Width)
+    {
+        const size_t laneCount = ((count - i) < static_cast<size_t>(Width)) ? (count - i) : static_cast<size_t>(Width);
+
+        StorePartial(noise + i, PerlinNoise2D(LoadPartial(x + i, laneCount), LoadPartial(y + i, laneCount)), laneCount);
+    }
+}
+
+static void GetBiomeWeightsBatch(const float* x, const float* z, float* mountain, float* woodland, float* grassland, size_t count)
+{
+    for (size_t i = 0; i < count; i += Width)
+    {
+        const size_t laneCount = ((count - i) < static_cast<size_t>(Width)) ? (count - i) : static_cast<size_t>(Width);
+
+        vfloat m, w, g;
+        GetBiomeWeights(LoadPartial(x + i, laneCount), LoadPartial(z + i, laneCount), m, w, g);
+
+        StorePartial(mountain + i, m, laneCount);
+        StorePartial(woodland + i, w, laneCount);
+        StorePartial(grassland + i, g, laneCount);
+    }
+}
+
+static void GetTerrainHeightBatch(const float* x, const float* z, float* height, size_t count)
+{
+    for (size_t i = 0; i < count; i += Width)
+    {
+        const size_t laneCount = ((count - i) < static_cast<size_t>(Width)) ? (count - i) : static_cast<size_t>(Width);
+
+        StorePartial(height + i, GetTerrainHeight(LoadPartial(x + i, laneCount), LoadPartial(z + i, laneCount)), laneCount);
+    }
+}
+
+static void GetTerrainHeightAndGradientBatch(const float* x, const float* z, float* height, float* gradientX, float* gradientZ, size_t count)
+{
+    for (size_t i = 0; i < count; i += Width)
+    {
+        const size_t laneCount = ((count - i) < static_cast<size_t>(Width)) ? (count - i) : static_cast<size_t>(Width);
+
+        const vfloat3 heightAndGradient = GetTerrainHeightAndGradient(LoadPartial(x + i, laneCount), LoadPartial(z + i, laneCount));
+
+        StorePartial(height + i, heightAndGradient.x, laneCount);
+        StorePartial(gradientX + i, heightAndGradient.y, laneCount);
+        StorePartial(gradientZ + i, heightAndGradient.z, laneCount);
+    }
+}
+
+static void GetTerrainNormalBatch(const float* x, const float* z, float* normalX, float* normalY, float* normalZ, size_t count)
+{
+    for (size_t i = 0; i < count; i += Width)
+    {
+        const size_t laneCount = ((count - i) < static_cast<size_t>(Width)) ? (count - i) : static_cast<size_t>(Width);
+
+        vfloat nx, ny, nz;
+        GetTerrainNormal(LoadPartial(x + i, laneCount), LoadPartial(z + i, laneCount), nx, ny, nz);
+
+        StorePartial(normalX + i, nx, laneCount);
+        StorePartial(normalY + i, ny, laneCount);
+        StorePartial(normalZ + i, nz, laneCount);
+    }
+}
+
+static void IsBoxVisibleBatch(const float* const boxMin[3], const float* const boxMax[3], const float* planes, float* visible, size_t count)
+{
+    for (size_t i = 0; i < count; i += Width)
+    {
+        const size_t laneCount = ((count - i) < static_cast<size_t>(Width)) ? (count - i) : static_cast<size_t>(Width);
+
+        const vfloat minimum[3] = {LoadPartial(boxMin[0] + i, laneCount), LoadPartial(boxMin[1] + i, laneCount), LoadPartial(boxMin[2] + i, laneCount)};
+        const vfloat maximum[3] = {LoadPartial(boxMax[0] + i, laneCount), LoadPartial(boxMax[1] + i, laneCount), LoadPartial(boxMax[2] + i, laneCount)};
+
+        StorePartial(visible + i, IsBoxVisible(minimum, maximum, planes), laneCount);
+    }
+}
+
+static const detail::TerrainKernels Kernels = {PerlinNoise2DBatch,
+                                               GetBiomeWeightsBatch,
+                                               GetTerrainHeightBatch,
+                                               GetTerrainHeightAndGradientBatch,
+                                               GetTerrainNormalBatch,
+                                               IsBoxVisibleBatch};
@@ -0,0 +1,178 @@
+// This file is part of the AMD Work Graph Mesh Node Sample.
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+// 8-wide AVX2 terrain kernels. Compiled with AVX2 code generation, only called if the CPU supports AVX2.
+
+#include "terrainkernels.h"
+
+#include <immintrin.h>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace meshnode
+{
+    namespace avx2
+    {
+        static const int Width = 8;
+
+        struct vfloat
+        {
+            __m256 v;
+        };
+
+        struct vint
+        {
+            __m256i v;
+        };
+
+        using vintmask = vint;
+
+        static vfloat Load(const float* pData)
+        {
+            return {_mm256_loadu_ps(pData)};
+        }
+
+        static void Store(float* pData, const vfloat& v)
+        {
+            _mm256_storeu_ps(pData, v.v);
+        }
+
+        static vfloat Set(float s)
+        {
+            return {_mm256_set1_ps(s)};
+        }
+
+        static vint SetInt(int32_t s)
+        {
+            return {_mm256_set1_epi32(s)};
+        }
+
+        static vfloat operator+(const vfloat& a, const vfloat& b)
+        {
+            return {_mm256_add_ps(a.v, b.v)};
+        }
+
+        static vfloat operator-(const vfloat& a, const vfloat& b)
+        {
+            return {_mm256_sub_ps(a.v, b.v)};
+        }
+
+        static vfloat operator*(const vfloat& a, const vfloat& b)
+        {
+            return {_mm256_mul_ps(a.v, b.v)};
+        }
+
+        static vfloat operator/(const vfloat& a, const vfloat& b)
+        {
+            return {_mm256_div_ps(a.v, b.v)};
+        }
+
+        static vfloat operator-(const vfloat& a)
+        {
+            return {_mm256_xor_ps(a.v, _mm256_set1_ps(-0.f))};
+        }
+
+        static vint operator+(const vint& a, const vint& b)
+        {
+            return {_mm256_add_epi32(a.v, b.v)};
+        }
+
+        static vint operator-(const vint& a, const vint& b)
+        {
+            return {_mm256_sub_epi32(a.v, b.v)};
+        }
+
+        static vint operator*(const vint& a, const vint& b)
+        {
+            return {_mm256_mullo_epi32(a.v, b.v)};
+        }
+
+        static vfloat Floor(const vfloat& a)
+        {
+            return {_mm256_round_ps(a.v, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC)};
+        }
+
+        static vfloat RoundEven(const vfloat& a)
+        {
+            return {_mm256_round_ps(a.v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC)};
+        }
+
+        static vfloat Abs(const vfloat& a)
+        {
+            return {_mm256_andnot_ps(_mm256_set1_ps(-0.f), a.v)};
+        }
+
+        static vfloat Sqrt(const vfloat& a)
+        {
+            return {_mm256_sqrt_ps(a.v)};
+        }
+
+        // minps/maxps return the second operand if the comparison is false, swap operands to match std::min & std::max
+        static vfloat Min(const vfloat& a, const vfloat& b)
+        {
+            return {_mm256_min_ps(b.v, a.v)};
+        }
+
+        static vfloat Max(const vfloat& a, const vfloat& b)
+        {
+            return {_mm256_max_ps(b.v, a.v)};
+        }
+
+        static vint ToInt(const vfloat& a)
+        {
+            return {_mm256_cvttps_epi32(a.v)};
+        }
+
+        static vfloat ToFloat(const vint& a)
+        {
+            return {_mm256_cvtepi32_ps(a.v)};
+        }
+
+        static vintmask LessThan(const vint& a, const vint& b)
+        {
+            return {_mm256_cmpgt_epi32(b.v, a.v)};
+        }
+
+        static vint Select(const vintmask& mask, const vint& a, const vint& b)
+        {
+            return {_mm256_blendv_epi8(b.v, a.v, mask.v)};
+        }
+
+        static vintmask LessThan(const vfloat& a, const vfloat& b)
+        {
+            return {_mm256_castps_si256(_mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ))};
+        }
+
+        static vfloat Select(const vintmask& mask, const vfloat& a, const vfloat& b)
+        {
+            return {_mm256_blendv_ps(b.v, a.v, _mm256_castsi256_ps(mask.v))};
+        }
+
+#include "terrainkernels.inl"
+    }  // namespace avx2
+
+    const detail::TerrainKernels& detail::GetTerrainKernelsAvx2()
+    {
+        return avx2::Kernels;
+    }
+}  // namespace meshnode
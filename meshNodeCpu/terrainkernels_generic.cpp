@@ -0,0 +1,230 @@
+// This file is part of the AMD Work Graph Mesh Node Sample.
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+// Portable 8-wide terrain kernels. Operations are written as per-lane loops, which the compiler vectorizes for the target architecture.
+
+#include "terrainkernels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace meshnode
+{
+    namespace generic
+    {
+        static const int Width = 8;
+
+        struct vfloat
+        {
+            float v[Width];
+        };
+
+        struct vint
+        {
+            int32_t v[Width];
+        };
+
+        // all bits set for true lanes
+        using vintmask = vint;
+
+        template <typename T, typename Op>
+        static T Map(const T& a, Op op)
+        {
+            T result;
+            for (int i = 0; i < Width; ++i)
+            {
+                result.v[i] = op(a.v[i]);
+            }
+            return result;
+        }
+
+        template <typename T, typename Op>
+        static T Map(const T& a, const T& b, Op op)
+        {
+            T result;
+            for (int i = 0; i < Width; ++i)
+            {
+                result.v[i] = op(a.v[i], b.v[i]);
+            }
+            return result;
+        }
+
+        static vfloat Load(const float* pData)
+        {
+            vfloat result;
+            std::copy(pData, pData + Width, result.v);
+            return result;
+        }
+
+        static void Store(float* pData, const vfloat& v)
+        {
+            std::copy(v.v, v.v + Width, pData);
+        }
+
+        static vfloat Set(float s)
+        {
+            vfloat result;
+            std::fill(result.v, result.v + Width, s);
+            return result;
+        }
+
+        static vint SetInt(int32_t s)
+        {
+            vint result;
+            std::fill(result.v, result.v + Width, s);
+            return result;
+        }
+
+        static vfloat operator+(const vfloat& a, const vfloat& b)
+        {
+            return Map(a, b, [](float x, float y) { return x + y; });
+        }
+
+        static vfloat operator-(const vfloat& a, const vfloat& b)
+        {
+            return Map(a, b, [](float x, float y) { return x - y; });
+        }
+
+        static vfloat operator*(const vfloat& a, const vfloat& b)
+        {
+            return Map(a, b, [](float x, float y) { return x * y; });
+        }
+
+        static vfloat operator/(const vfloat& a, const vfloat& b)
+        {
+            return Map(a, b, [](float x, float y) { return x / y; });
+        }
+
+        static vfloat operator-(const vfloat& a)
+        {
+            return Map(a, [](float x) { return -x; });
+        }
+
+        static vint operator+(const vint& a, const vint& b)
+        {
+            return Map(a, b, [](int32_t x, int32_t y) { return x + y; });
+        }
+
+        static vint operator-(const vint& a, const vint& b)
+        {
+            return Map(a, b, [](int32_t x, int32_t y) { return x - y; });
+        }
+
+        static vint operator*(const vint& a, const vint& b)
+        {
+            return Map(a, b, [](int32_t x, int32_t y) { return x * y; });
+        }
+
+        static vfloat Floor(const vfloat& a)
+        {
+            return Map(a, [](float x) { return std::floor(x); });
+        }
+
+        static vfloat RoundEven(const vfloat& a)
+        {
+            return Map(a, [](float x) { return std::nearbyint(x); });
+        }
+
+        static vfloat Abs(const vfloat& a)
+        {
+            return Map(a, [](float x) { return std::abs(x); });
+        }
+
+        static vfloat Sqrt(const vfloat& a)
+        {
+            return Map(a, [](float x) { return std::sqrt(x); });
+        }
+
+        static vfloat Min(const vfloat& a, const vfloat& b)
+        {
+            return Map(a, b, [](float x, float y) { return std::min(x, y); });
+        }
+
+        static vfloat Max(const vfloat& a, const vfloat& b)
+        {
+            return Map(a, b, [](float x, float y) { return std::max(x, y); });
+        }
+
+        static vint ToInt(const vfloat& a)
+        {
+            vint result;
+            for (int i = 0; i < Width; ++i)
+            {
+                result.v[i] = static_cast<int32_t>(a.v[i]);
+            }
+            return result;
+        }
+
+        static vfloat ToFloat(const vint& a)
+        {
+            vfloat result;
+            for (int i = 0; i < Width; ++i)
+            {
+                result.v[i] = static_cast<float>(a.v[i]);
+            }
+            return result;
+        }
+
+        static vintmask LessThan(const vint& a, const vint& b)
+        {
+            return Map(a, b, [](int32_t x, int32_t y) { return (x < y) ? int32_t(-1) : int32_t(0); });
+        }
+
+        static vint Select(const vintmask& mask, const vint& a, const vint& b)
+        {
+            vint result;
+            for (int i = 0; i < Width; ++i)
+            {
+                result.v[i] = mask.v[i] ? a.v[i] : b.v[i];
+            }
+            return result;
+        }
+
+        static vintmask LessThan(const vfloat& a, const vfloat& b)
+        {
+            vint result;
+            for (int i = 0; i < Width; ++i)
+            {
+                result.v[i] = (a.v[i] < b.v[i]) ? int32_t(-1) : int32_t(0);
+            }
+            return result;
+        }
+
+        static vfloat Select(const vintmask& mask, const vfloat& a, const vfloat& b)
+        {
+            vfloat result;
+            for (int i = 0; i < Width; ++i)
+            {
+                result.v[i] = mask.v[i] ? a.v[i] : b.v[i];
+            }
+            return result;
+        }
+
+#include "terrainkernels.inl"
+    }  // namespace generic
+
+    const detail::TerrainKernels& detail::GetTerrainKernelsGeneric()
+    {
+        return generic::Kernels;
+    }
+}  // namespace meshnode
@@ -0,0 +1,2162 @@
+// This file is part of the AMD Work Graph Mesh Node Sample.
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include "worldgraph.h"
+
+#include "chunkmetadata.h"
+#include "terrain.h"
+#include "terrainclipmap.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <new>
+#include <thread>
+
+namespace meshnode
+{
+    // ==================
+    // Constants, see common.hlsl. Grid definitions & record limits are shared, see shaders/workgraphrecords.h.
+
+    static const float GrassSpacing     = 0.25f;
+    static const float DetailedTileSize = grassPatchesPerDetailedTile * GrassSpacing;
+    static const float TileSize         = detailedTilesPerTile * DetailedTileSize;
+    static const float ChunkSize        = tilesPerChunk * TileSize;
+
+    // quality tier independent limits, scaled by the geometry budget like the quality tier distances
+    static const float ButterflyMaxDistanceLimit = 25.f;
+    static const float BeeMaxDistanceLimit       = 40.f;
+
+    static const float NightStartTime = 18.f;
+    static const float NightEndTime   = 6.f;
+
+    static const float Pi = 3.14159265359f;
+
+    // Pine tree leaves use dense vertex rings, which are split into two pieces, see tree.hlsl
+    static const uint32_t PineLeafRingVertexCount  = 16;
+    static const uint32_t PineLeafSplinePieceCount = 2;
+
+    static const WorldGraphNodeInfo NodeInfos[WorldGraphNodeCount] = {
+        {"World", "World", WorldGraphLaunch::Thread, 0, 0},
+        {"ChunkGrid", "ChunkGrid", WorldGraphLaunch::Broadcasting, sizeof(ChunkGridRecord), 0},
+        {"Chunk", "Chunk", WorldGraphLaunch::Broadcasting, sizeof(ChunkRecord), 0},
+        {"MountainTile", "Tile[0]", WorldGraphLaunch::Broadcasting, sizeof(TileRecord), 0},
+        {"WoodlandTile", "Tile[1]", WorldGraphLaunch::Broadcasting, sizeof(TileRecord), 0},
+        {"GrasslandTile", "Tile[2]", WorldGraphLaunch::Broadcasting, sizeof(TileRecord), 0},
+        {"DetailedTile", "DetailedTile", WorldGraphLaunch::Broadcasting, sizeof(TileRecord), 0},
+        {"GenerateOakTree", "GenerateTree[0]", WorldGraphLaunch::Coalescing, sizeof(GenerateTreeRecord), 0},
+        {"GeneratePineTree", "GenerateTree[1]", WorldGraphLaunch::Coalescing, sizeof(GenerateTreeRecord), 0},
+        {"GenerateRock", "GenerateRock", WorldGraphLaunch::Coalescing, sizeof(GenerateTreeRecord), 0},
+        {"TerrainMeshShader", "DrawTerrainChunk", WorldGraphLaunch::Mesh, sizeof(DrawTerrainChunkRecord), drawTerrainChunkMaxInputRecords},
+        {"SplineMeshShader", "DrawSpline", WorldGraphLaunch::Mesh, sizeof(DrawSplineRecord), drawSplineMaxInputRecords},
+        {"SparseGrassMeshShader", "DrawSparseGrassPatch", WorldGraphLaunch::Mesh, sizeof(DrawSparseGrassRecord), drawSparseGrassMaxInputRecords},
+        {"DenseGrassMeshShader", "DrawDenseGrassPatch", WorldGraphLaunch::Mesh, sizeof(DrawDenseGrassRecord), drawDenseGrassMaxInputRecords},
+        {"MushroomMeshShader", "DrawMushroomPatch", WorldGraphLaunch::Mesh, sizeof(DrawMushroomRecord), drawMushroomMaxInputRecords},
+        {"FlowerMeshShader", "DrawFlowerPatch[0]", WorldGraphLaunch::Mesh, sizeof(DrawFlowerRecord), drawFlowerMaxInputRecords},
+        {"SparseFlowerMeshShader", "DrawFlowerPatch[1]", WorldGraphLaunch::Mesh, sizeof(DrawFlowerRecord), drawFlowerMaxInputRecords},
+        {"BeeMeshShader", "DrawBees", WorldGraphLaunch::Mesh, sizeof(DrawInsectRecord), drawBeesMaxInputRecords},
+        {"ButterflyMeshShader", "DrawButterflies", WorldGraphLaunch::Mesh, sizeof(DrawInsectRecord), drawButterfliesMaxInputRecords},
+    };
+
+    const WorldGraphNodeInfo& GetWorldGraphNodeInfo(WorldGraphNode node)
+    {
+        return NodeInfos[static_cast<uint32_t>(node)];
+    }
+
+#define WORLD_GRAPH_OUTPUT(producer, nodeId, record, maxRecords) {WorldGraphNode::producer, nodeId, #record, sizeof(record), maxRecords}
+
+    static const WorldGraphOutputInfo OutputInfos[WorldGraphOutputCount] = {
+        WORLD_GRAPH_OUTPUT(World, "ChunkGrid", ChunkGridRecord, 1),
+        WORLD_GRAPH_OUTPUT(ChunkGrid, "DrawTerrainChunk", DrawTerrainChunkRecord, 1),
+        WORLD_GRAPH_OUTPUT(ChunkGrid, "Tile", TileRecord, tilesPerChunk * tilesPerChunk),
+        WORLD_GRAPH_OUTPUT(Chunk, "DrawTerrainChunk", DrawTerrainChunkRecord, 1),
+        WORLD_GRAPH_OUTPUT(Chunk, "Tile", TileRecord, tilesPerChunk * tilesPerChunk),
+        WORLD_GRAPH_OUTPUT(MountainTile, "GenerateRock", GenerateTreeRecord, detailedTilesPerTile * detailedTilesPerTile),
+        WORLD_GRAPH_OUTPUT(MountainTile, "GenerateTree[1]", GenerateTreeRecord, detailedTilesPerTile * detailedTilesPerTile),
+        WORLD_GRAPH_OUTPUT(WoodlandTile, "DetailedTile", TileRecord, detailedTilesPerTile * detailedTilesPerTile),
+        WORLD_GRAPH_OUTPUT(WoodlandTile, "GenerateTree", GenerateTreeRecord, detailedTilesPerTile * detailedTilesPerTile),
+        WORLD_GRAPH_OUTPUT(WoodlandTile, "DrawMushroomPatch", DrawMushroomRecord, 1),
+        WORLD_GRAPH_OUTPUT(WoodlandTile, "DrawSparseGrassPatch", DrawSparseGrassRecord, 1),
+        WORLD_GRAPH_OUTPUT(GrasslandTile, "DetailedTile", TileRecord, detailedTilesPerTile * detailedTilesPerTile),
+        WORLD_GRAPH_OUTPUT(GrasslandTile, "DrawButterflies", DrawInsectRecord, 1),
+        WORLD_GRAPH_OUTPUT(GrasslandTile, "DrawFlowerPatch", DrawFlowerRecord, 1),
+        WORLD_GRAPH_OUTPUT(GrasslandTile, "DrawBees", DrawInsectRecord, 1),
+        WORLD_GRAPH_OUTPUT(GrasslandTile, "DrawSparseGrassPatch", DrawSparseGrassRecord, 1),
+        WORLD_GRAPH_OUTPUT(DetailedTile, "DrawDenseGrassPatch", DrawDenseGrassRecord, 1),
+        WORLD_GRAPH_OUTPUT(GenerateOakTree, "DrawSpline", DrawSplineRecord, 3),
+        WORLD_GRAPH_OUTPUT(GeneratePineTree, "DrawSpline", DrawSplineRecord, 1 + PineLeafSplinePieceCount),
+        WORLD_GRAPH_OUTPUT(GenerateRock, "DrawSpline", DrawSplineRecord, 1),
+    };
+
+#undef WORLD_GRAPH_OUTPUT
+
+    const WorldGraphOutputInfo& GetWorldGraphOutputInfo(uint32_t index)
+    {
+        return OutputInfos[index];
+    }
+
+    // ==================
+    // Camera
+
+    static float4x4 FromRows(const float4& r0, const float4& r1, const float4& r2, const float4& r3)
+    {
+        float4x4 result;
+        result.columns[0] = float4(r0.x, r1.x, r2.x, r3.x);
+        result.columns[1] = float4(r0.y, r1.y, r2.y, r3.y);
+        result.columns[2] = float4(r0.z, r1.z, r2.z, r3.z);
+        result.columns[3] = float4(r0.w, r1.w, r2.w, r3.w);
+
+        return result;
+    }
+
+    static float4x4 Multiply(const float4x4& a, const float4x4& b)
+    {
+        float4x4 result;
+        for (int c = 0; c < 4; ++c)
+        {
+            result.columns[c] = mul(a, b.columns[c]);
+        }
+
+        return result;
+    }
+
+    // General 4x4 inverse by cofactor expansion, in double precision
+    static float4x4 Inverse(const float4x4& matrix)
+    {
+        double m[16];
+        for (int r = 0; r < 4; ++r)
+        {
+            const float4 row = matrix[r];
+            m[r * 4 + 0]     = row.x;
+            m[r * 4 + 1]     = row.y;
+            m[r * 4 + 2]     = row.z;
+            m[r * 4 + 3]     = row.w;
+        }
+
+        double inv[16];
+        inv[0]  = m[5] * m[10] * m[15] - m[5] * m[11] * m[14] - m[9] * m[6] * m[15] + m[9] * m[7] * m[14] + m[13] * m[6] * m[11] - m[13] * m[7] * m[10];
+        inv[4]  = -m[4] * m[10] * m[15] + m[4] * m[11] * m[14] + m[8] * m[6] * m[15] - m[8] * m[7] * m[14] - m[12] * m[6] * m[11] + m[12] * m[7] * m[10];
+        inv[8]  = m[4] * m[9] * m[15] - m[4] * m[11] * m[13] - m[8] * m[5] * m[15] + m[8] * m[7] * m[13] + m[12] * m[5] * m[11] - m[12] * m[7] * m[9];
+        inv[12] = -m[4] * m[9] * m[14] + m[4] * m[10] * m[13] + m[8] * m[5] * m[14] - m[8] * m[6] * m[13] - m[12] * m[5] * m[10] + m[12] * m[6] * m[9];
+        inv[1]  = -m[1] * m[10] * m[15] + m[1] * m[11] * m[14] + m[9] * m[2] * m[15] - m[9] * m[3] * m[14] - m[13] * m[2] * m[11] + m[13] * m[3] * m[10];
+        inv[5]  = m[0] * m[10] * m[15] - m[0] * m[11] * m[14] - m[8] * m[2] * m[15] + m[8] * m[3] * m[14] + m[12] * m[2] * m[11] - m[12] * m[3] * m[10];
+        inv[9]  = -m[0] * m[9] * m[15] + m[0] * m[11] * m[13] + m[8] * m[1] * m[15] - m[8] * m[3] * m[13] - m[12] * m[1] * m[11] + m[12] * m[3] * m[9];
+        inv[13] = m[0] * m[9] * m[14] - m[0] * m[10] * m[13] - m[8] * m[1] * m[14] + m[8] * m[2] * m[13] + m[12] * m[1] * m[10] - m[12] * m[2] * m[9];
+        inv[2]  = m[1] * m[6] * m[15] - m[1] * m[7] * m[14] - m[5] * m[2] * m[15] + m[5] * m[3] * m[14] + m[13] * m[2] * m[7] - m[13] * m[3] * m[6];
+        inv[6]  = -m[0] * m[6] * m[15] + m[0] * m[7] * m[14] + m[4] * m[2] * m[15] - m[4] * m[3] * m[14] - m[12] * m[2] * m[7] + m[12] * m[3] * m[6];
+        inv[10] = m[0] * m[5] * m[15] - m[0] * m[7] * m[13] - m[4] * m[1] * m[15] + m[4] * m[3] * m[13] + m[12] * m[1] * m[7] - m[12] * m[3] * m[5];
+        inv[14] = -m[0] * m[5] * m[14] + m[0] * m[6] * m[13] + m[4] * m[1] * m[14] - m[4] * m[2] * m[13] - m[12] * m[1] * m[6] + m[12] * m[2] * m[5];
+        inv[3]  = -m[1] * m[6] * m[11] + m[1] * m[7] * m[10] + m[5] * m[2] * m[11] - m[5] * m[3] * m[10] - m[9] * m[2] * m[7] + m[9] * m[3] * m[6];
+        inv[7]  = m[0] * m[6] * m[11] - m[0] * m[7] * m[10] - m[4] * m[2] * m[11] + m[4] * m[3] * m[10] + m[8] * m[2] * m[7] - m[8] * m[3] * m[6];
+        inv[11] = -m[0] * m[5] * m[11] + m[0] * m[7] * m[9] + m[4] * m[1] * m[11] - m[4] * m[3] * m[9] - m[8] * m[1] * m[7] + m[8] * m[3] * m[5];
+        inv[15] = m[0] * m[5] * m[10] - m[0] * m[6] * m[9] - m[4] * m[1] * m[10] + m[4] * m[2] * m[9] + m[8] * m[1] * m[6] - m[8] * m[2] * m[5];
+
+        const double determinant = m[0] * inv[0] + m[1] * inv[4] + m[2] * inv[8] + m[3] * inv[12];
+        const double scale       = (determinant != 0.0) ? 1.0 / determinant : 0.0;
+
+        const auto row = [&](int r) {
+            return float4(static_cast<float>(inv[r * 4 + 0] * scale),
+                          static_cast<float>(inv[r * 4 + 1] * scale),
+                          static_cast<float>(inv[r * 4 + 2] * scale),
+                          static_cast<float>(inv[r * 4 + 3] * scale));
+        };
+
+        return FromRows(row(0), row(1), row(2), row(3));
+    }
+
+    WorkGraphCBData CreateWorkGraphCBData(const WorldGraphCamera& camera)
+    {
+        // right-handed view looking along -PolarToVector(yaw, pitch), same as the sample camera
+        const float3 back = float3(std::sin(camera.Yaw) * std::cos(camera.Pitch), std::sin(camera.Pitch), std::cos(camera.Yaw) * std::cos(camera.Pitch));
+        const float3 zAxis = normalize(back);
+        const float3 xAxis = normalize(cross(float3(0.f, 1.f, 0.f), zAxis));
+        const float3 yAxis = cross(zAxis, xAxis);
+
+        const float4x4 view = FromRows(float4(xAxis, -dot(xAxis, camera.Position)),
+                                       float4(yAxis, -dot(yAxis, camera.Position)),
+                                       float4(zAxis, -dot(zAxis, camera.Position)),
+                                       float4(0.f, 0.f, 0.f, 1.f));
+
+        // right-handed perspective projection with depth in [0, 1]
+        const float    yScale     = 1.f / std::tan(camera.Yfov * 0.5f);
+        const float    xScale     = yScale / camera.AspectRatio;
+        const float    depthRange = camera.Far / (camera.Near - camera.Far);
+        const float4x4 projection = FromRows(float4(xScale, 0.f, 0.f, 0.f),
+                                             float4(0.f, yScale, 0.f, 0.f),
+                                             float4(0.f, 0.f, depthRange, camera.Near * depthRange),
+                                             float4(0.f, 0.f, -1.f, 0.f));
+
+        WorkGraphCBData data        = {};
+        data.ViewProjection         = Multiply(projection, view);
+        data.PreviousViewProjection = data.ViewProjection;
+        data.InverseViewProjection  = Inverse(data.ViewProjection);
+        data.CameraPosition         = float4(camera.Position, 1.f);
+        data.PreviousCameraPosition = data.CameraPosition;
+
+        // full quality tier, see GeometryBudgetGovernor
+        data.DenseGrassDistanceScale  = 1.f;
+        data.SparseGrassDistanceScale = 1.f;
+        data.FlowerDistanceScale      = 1.f;
+        data.InsectDistanceScale      = 1.f;
+        data.GrassBladeDensityScale   = 1.f;
+
+        return data;
+    }
+
+    // ==================
+    // Record arena
+
+    // record alignment within the arena
+    static const size_t RecordAlignment = 16;
+
+    RecordArena::RecordArena(size_t blockSize)
+        : m_BlockSize(blockSize)
+    {
+    }
+
+    void* RecordArena::Allocate(size_t size)
+    {
+        size = (size + RecordAlignment - 1) & ~(RecordAlignment - 1);
+
+        while ((m_BlockIndex < m_Blocks.size()) && ((m_BlockOffset + size) > m_BlockSize))
+        {
+            ++m_BlockIndex;
+            m_BlockOffset = 0;
+        }
+
+        if (m_BlockIndex == m_Blocks.size())
+        {
+            // new[] returns memory aligned for any fundamental type, at least RecordAlignment on all supported platforms
+            m_Blocks.emplace_back(new uint8_t[m_BlockSize]);
+            m_BlockOffset = 0;
+        }
+
+        void* pRecord = m_Blocks[m_BlockIndex].get() + m_BlockOffset;
+        m_BlockOffset += size;
+        m_AllocatedBytes += size;
+
+        return pRecord;
+    }
+
+    void RecordArena::Reset()
+    {
+        m_BlockIndex     = 0;
+        m_BlockOffset    = 0;
+        m_AllocatedBytes = 0;
+    }
+
+    size_t RecordArena::GetAllocatedBytes() const
+    {
+        return m_AllocatedBytes;
+    }
+
+    size_t RecordArena::GetCapacity() const
+    {
+        return m_Blocks.size() * m_BlockSize;
+    }
+
+    // ==================
+    // Work stealing scheduler
+
+    /**
+     * Runs a range of tasks on a fixed set of workers. The calling thread is worker 0.
+     * Each worker owns a queue of task ranges. A worker splits the range it pops until a single task remains & pushes the other halves
+     * back to its own queue. Idle workers steal the oldest, i.e. largest, range from the queues of other workers.
+     */
+    class WorkStealingScheduler
+    {
+    public:
+        explicit WorkStealingScheduler(uint32_t workerCount)
+            : m_Queues(std::max(workerCount, 1u))
+        {
+            for (uint32_t i = 1; i < workerCount; ++i)
+            {
+                m_Threads.emplace_back([this, i]() { WorkerMain(i); });
+            }
+        }
+
+        ~WorkStealingScheduler()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                m_Exit = true;
+            }
+            m_WorkCondition.notify_all();
+
+            for (auto& thread : m_Threads)
+            {
+                thread.join();
+            }
+        }
+
+        uint32_t GetWorkerCount() const
+        {
+            return static_cast<uint32_t>(m_Queues.size());
+        }
+
+        /**
+         * @brief   Call task(worker, index) for every index in [0, taskCount) & return once all tasks are finished.
+         */
+        void Run(size_t taskCount, const std::function<void(uint32_t, size_t)>& task)
+        {
+            if (taskCount == 0)
+            {
+                return;
+            }
+
+            m_pTask     = &task;
+            m_TaskCount = taskCount;
+            m_FinishedTaskCount.store(0);
+            m_Queues[0].Ranges.push_back({0, taskCount});
+
+            if (m_Threads.empty())
+            {
+                ProcessTasks(0);
+                return;
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                ++m_Generation;
+                m_FinishedWorkerCount = 0;
+            }
+            m_WorkCondition.notify_all();
+
+            ProcessTasks(0);
+
+            // all workers have to leave the task loop before the task can go out of scope
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_DoneCondition.wait(lock, [this]() { return m_FinishedWorkerCount == m_Threads.size(); });
+        }
+
+    private:
+        struct TaskRange
+        {
+            size_t Begin;
+            size_t End;
+        };
+
+        struct alignas(64) WorkerQueue
+        {
+            std::mutex            Mutex;
+            std::deque<TaskRange> Ranges;
+        };
+
+        void WorkerMain(uint32_t worker)
+        {
+            uint64_t generation = 0;
+
+            while (true)
+            {
+                {
+                    std::unique_lock<std::mutex> lock(m_Mutex);
+                    m_WorkCondition.wait(lock, [&]() { return m_Exit || (m_Generation != generation); });
+
+                    if (m_Exit)
+                    {
+                        return;
+                    }
+                    generation = m_Generation;
+                }
+
+                ProcessTasks(worker);
+
+                {
+                    std::lock_guard<std::mutex> lock(m_Mutex);
+                    ++m_FinishedWorkerCount;
+                }
+                m_DoneCondition.notify_one();
+            }
+        }
+
+        bool Pop(uint32_t worker, TaskRange& range)
+        {
+            WorkerQueue&                queue = m_Queues[worker];
+            std::lock_guard<std::mutex> lock(queue.Mutex);
+
+            if (queue.Ranges.empty())
+            {
+                return false;
+            }
+
+            range = queue.Ranges.back();
+            queue.Ranges.pop_back();
+
+            return true;
+        }
+
+        bool Steal(uint32_t worker, TaskRange& range)
+        {
+            for (size_t i = 1; i < m_Queues.size(); ++i)
+            {
+                WorkerQueue&                queue = m_Queues[(worker + i) % m_Queues.size()];
+                std::lock_guard<std::mutex> lock(queue.Mutex);
+
+                if (!queue.Ranges.empty())
+                {
+                    range = queue.Ranges.front();
+                    queue.Ranges.pop_front();
+
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        void ProcessTasks(uint32_t worker)
+        {
+            while (m_FinishedTaskCount.load() < m_TaskCount)
+            {
+                TaskRange range;
+                if (!Pop(worker, range) && !Steal(worker, range))
+                {
+                    // remaining tasks are being executed by other workers
+                    std::this_thread::yield();
+                    continue;
+                }
+
+                while ((range.End - range.Begin) > 1)
+                {
+                    const size_t middle = range.Begin + (range.End - range.Begin) / 2;
+                    {
+                        std::lock_guard<std::mutex> lock(m_Queues[worker].Mutex);
+                        m_Queues[worker].Ranges.push_back({middle, range.End});
+                    }
+                    range.End = middle;
+                }
+
+                (*m_pTask)(worker, range.Begin);
+                m_FinishedTaskCount.fetch_add(1);
+            }
+        }
+
+        std::vector<WorkerQueue> m_Queues;
+        std::vector<std::thread> m_Threads;
+
+        const std::function<void(uint32_t, size_t)>* m_pTask     = nullptr;
+        size_t                                       m_TaskCount = 0;
+        std::atomic<size_t>                          m_FinishedTaskCount{0};
+
+        std::mutex              m_Mutex;
+        std::condition_variable m_WorkCondition;
+        std::condition_variable m_DoneCondition;
+        uint64_t                m_Generation          = 0;
+        size_t                  m_FinishedWorkerCount = 0;
+        bool                    m_Exit                = false;
+    };
+
+    // ==================
+    // Shader helpers, see utils.hlsl & common.hlsl
+
+    struct AxisAlignedBoundingBox
+    {
+        float3 Min;
+        float3 Max;
+    };
+
+    static float4 PlaneNormalize(const float4& plane)
+    {
+        const float l = length(plane.xyz());
+
+        if (l > 0.f)
+        {
+            return plane / l;
+        }
+
+        return float4();
+    }
+
+    ClipPlanes ComputeClipPlanes(const float4x4& viewProjection)
+    {
+        ClipPlanes result;
+
+        result.Planes[0] = PlaneNormalize(viewProjection[3] + viewProjection[0]);
+        result.Planes[1] = PlaneNormalize(viewProjection[3] - viewProjection[0]);
+        result.Planes[2] = PlaneNormalize(viewProjection[3] + viewProjection[1]);
+        result.Planes[3] = PlaneNormalize(viewProjection[3] - viewProjection[1]);
+        result.Planes[4] = PlaneNormalize(viewProjection[3] + viewProjection[2]);
+        result.Planes[5] = PlaneNormalize(viewProjection[3] - viewProjection[2]);
+
+        return result;
+    }
+
+    static bool IsSphereVisible(const float3& center, float radius, const ClipPlanes& clipPlanes)
+    {
+        for (int i = 0; i < 6; ++i)
+        {
+            if (dot(float4(center, 1.f), clipPlanes.Planes[i]) < -radius)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    static bool IsVisible(const AxisAlignedBoundingBox& box, const ClipPlanes& clipPlanes)
+    {
+        for (int i = 0; i < 6; ++i)
+        {
+            const float4& plane = clipPlanes.Planes[i];
+
+            const float3 axis = float3(plane.x < 0.f ? box.Min.x : box.Max.x,  //
+                                       plane.y < 0.f ? box.Min.y : box.Max.y,  //
+                                       plane.z < 0.f ? box.Min.z : box.Max.z);
+
+            if ((dot(plane.xyz(), axis) + plane.w) < 0.f)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    static float2 ToFloat2(const int2& v)
+    {
+        return float2(static_cast<float>(v.x), static_cast<float>(v.y));
+    }
+
+    static float2 GetXZ(const float3& v)
+    {
+        return float2(v.x, v.z);
+    }
+
+    static uint32_t AsUint(int32_t v)
+    {
+        return static_cast<uint32_t>(v);
+    }
+
+    static float2 GetGrassOffset(const int2& grid)
+    {
+        const float theta               = 2.f * Pi * Random(AsUint(grid.x), AsUint(grid.y), 1337);
+        const float radius              = std::sqrt(Random(AsUint(grid.x), 19, AsUint(grid.y)));
+        const float patchCenterVariance = 0.4f;
+
+        return patchCenterVariance * radius * float2(std::cos(theta), std::sin(theta));
+    }
+
+    float GetCurvedWorldHeightScale(float distanceToCamera)
+    {
+        return smoothstep(2000.f, 1000.f, distanceToCamera);
+    }
+
+    float3 GetCurvedWorldSpacePosition(const float3& cameraPosition, const float3& worldSpacePosition)
+    {
+        const float2 center           = GetXZ(cameraPosition);
+        const float2 centerToPos      = GetXZ(worldSpacePosition) - center;
+        const float  distanceToCenter = length(centerToPos);
+        const float2 direction        = centerToPos / distanceToCenter;
+
+        const float alpha = distanceToCenter / EarthRadius;
+        const float s     = std::sin(alpha);
+        const float c     = std::cos(alpha);
+
+        const float3 curvedPosUp       = normalize(float3(direction.x * s, c, direction.y * s));
+        const float3 centerToCurvedPos = float3(direction.x * s * EarthRadius, (c * EarthRadius) - EarthRadius, direction.y * s * EarthRadius);
+
+        const float heightScale = GetCurvedWorldHeightScale(distanceToCenter);
+
+        return float3(center.x, 0.f, center.y) + centerToCurvedPos +  // base postion
+               curvedPosUp * worldSpacePosition.y * heightScale;      // add rotated y component
+    }
+
+    /**
+     * Per-frame values shared by all nodes, i.e. the constant buffer & the terrain functions of heightmap.hlsl.
+     */
+    struct GraphContext
+    {
+        const WorkGraphCBData&    Data;
+        const WorldGraphQuality&  Quality;
+        const TerrainClipmap*     pTerrainClipmap;
+        const ChunkMetadataCache* pMetadataCache;
+        bool                      SplitSplines;
+        ClipPlanes                Planes;
+        // distance limits & dense grass blade density scaled by the geometry budget, see GetDenseGrassMaxDistance & co. in common.hlsl
+        float DenseGrassMaxDistance;
+        float SparseGrassMaxDistance;
+        float FlowerMaxDistance;
+        float FlowerSparseStartDistance;
+        float MushroomMaxDistance;
+        float ButterflyMaxDistance;
+        float BeeMaxDistance;
+        float GrassBladeDensity;
+
+        float3 GetCameraPosition() const
+        {
+            return Data.CameraPosition.xyz();
+        }
+
+        float GetTimeOfDay() const
+        {
+            return 12.f;
+        }
+
+        bool IsNight() const
+        {
+            return (GetTimeOfDay() > NightStartTime) || (GetTimeOfDay() < NightEndTime);
+        }
+
+        // maxBladeCount is the quality tier limit of the dense grass mesh shader, see GetDenseGrassBladeCount in common.hlsl
+        float GetDenseGrassBladeCount(float maxBladeCount, float distanceToCamera) const
+        {
+            const float bladeCount = std::max(maxBladeCount * GrassBladeDensity, 2.f);
+
+            return lerp(bladeCount, 2.f, std::pow(saturate(distanceToCamera / (DenseGrassMaxDistance * 1.05f)), 0.75f));
+        }
+
+        TerrainSample GetTerrainSample(const float2& position) const
+        {
+            return pTerrainClipmap ? pTerrainClipmap->GetTerrainSample(position) : meshnode::GetTerrainSample(position);
+        }
+
+        float3 GetBiomeWeights(const float2& position) const
+        {
+            return pTerrainClipmap ? pTerrainClipmap->GetBiomeWeights(position) : meshnode::GetBiomeWeights(position);
+        }
+
+        float3 GetTerrainNormal(const float2& position) const
+        {
+            return pTerrainClipmap ? pTerrainClipmap->GetNormal(position) : meshnode::GetTerrainNormal(position);
+        }
+
+        float3 GetTerrainPosition(const float2& position) const
+        {
+            return float3(position.x, pTerrainClipmap ? pTerrainClipmap->GetHeight(position) : GetTerrainHeight(position), position.y);
+        }
+
+        float3 GetCurvedWorldSpacePosition(const float3& worldSpacePosition) const
+        {
+            return meshnode::GetCurvedWorldSpacePosition(GetCameraPosition(), worldSpacePosition);
+        }
+
+        AxisAlignedBoundingBox GetGridBoundingBox(const int2& gridPosition, float elementSize, float minHeight, float maxHeight) const
+        {
+            const float3 minWorldPosition = float3(static_cast<float>(gridPosition.x), 0.f, static_cast<float>(gridPosition.y)) * elementSize;
+            const float3 maxWorldPosition = float3(static_cast<float>(gridPosition.x + 1), 0.f, static_cast<float>(gridPosition.y + 1)) * elementSize;
+
+            AxisAlignedBoundingBox result;
+            result.Min = GetCurvedWorldSpacePosition(minWorldPosition) + float3(0.f, minHeight, 0.f);
+            result.Max = GetCurvedWorldSpacePosition(maxWorldPosition) + float3(0.f, maxHeight, 0.f);
+
+            return result;
+        }
+
+        AxisAlignedBoundingBox GetCurvedGridBoundingBox(const int2& gridPosition, float elementSize, float minHeight, float maxHeight) const
+        {
+            const float2 minWorldPosition = ToFloat2(gridPosition) * elementSize;
+            const float2 maxWorldPosition = ToFloat2(gridPosition + int2(1, 1)) * elementSize;
+
+            AxisAlignedBoundingBox result;
+            result.Min = float3(std::numeric_limits<float>::max());
+            result.Max = float3(-std::numeric_limits<float>::max());
+
+            // the curvature moves each xz corner differently, i.e. all four corners are needed
+            for (int32_t corner = 0; corner < 4; ++corner)
+            {
+                const float2 cornerWorldPosition =
+                    float2((corner & 1) ? maxWorldPosition.x : minWorldPosition.x, (corner & 2) ? maxWorldPosition.y : minWorldPosition.y);
+
+                const float3 low  = GetCurvedWorldSpacePosition(float3(cornerWorldPosition.x, minHeight, cornerWorldPosition.y));
+                const float3 high = GetCurvedWorldSpacePosition(float3(cornerWorldPosition.x, maxHeight, cornerWorldPosition.y));
+
+                result.Min = min(result.Min, min(low, high));
+                result.Max = max(result.Max, max(low, high));
+            }
+
+            return result;
+        }
+    };
+
+    /**
+     * Inputs & outputs of a single thread group.
+     */
+    struct GroupContext
+    {
+        const GraphContext& Graph;
+        const void* const*  ppRecords;
+        uint32_t            RecordCount;
+        uint2               GroupId;
+        RecordArena&        Arena;
+        std::vector<std::pair<WorldGraphNode, const void*>>& Outputs;
+
+        template <typename Record>
+        const Record& GetInput(uint32_t index = 0) const
+        {
+            return *static_cast<const Record*>(ppRecords[index]);
+        }
+
+        // GetThreadNodeOutputRecords & GetGroupNodeOutputRecords, records are zero-initialized
+        template <typename Record>
+        Record& Output(WorldGraphNode node)
+        {
+            Record* pRecord = new (Arena.Allocate(sizeof(Record))) Record();
+            Outputs.emplace_back(node, pRecord);
+
+            return *pRecord;
+        }
+    };
+
+    // ==================
+    // World & chunk grid, see world.hlsl
+
+    static float2 ComputeFarPlaneCorner(const WorkGraphCBData& data, const WorldGraphQuality& quality, float clipX, float clipY)
+    {
+        const float2 cameraPosition = GetXZ(data.CameraPosition.xyz());
+
+        // compute position of frustum corner on far plane
+        const float4 corner              = mul(data.InverseViewProjection, float4(clipX, clipY, 1.f, 1.f));
+        const float3 cornerWorldPosition = corner.xyz() / corner.w;
+
+        const float2 viewVector       = GetXZ(cornerWorldPosition) - cameraPosition;
+        const float  viewVectorLength = length(viewVector);
+        // limit view vector to maximum terrain distance
+        const float viewVectorScale = std::min(quality.WorldGridMaxDistance / viewVectorLength, 1.f);
+
+        return cameraPosition + viewVector * viewVectorScale;
+    }
+
+    ChunkGridRecord ComputeChunkGrid(const WorkGraphCBData& data, const WorldGraphQuality& quality)
+    {
+        // Compute bounding box of view frustum, starting with camera position
+        float2 minTerrainPosition = GetXZ(data.CameraPosition.xyz());
+        float2 maxTerrainPosition = minTerrainPosition;
+
+        for (const float2& clip : {float2(-1.f, -1.f), float2(-1.f, 1.f), float2(1.f, -1.f), float2(1.f, 1.f)})
+        {
+            const float2 corner = ComputeFarPlaneCorner(data, quality, clip.x, clip.y);
+
+            minTerrainPosition = min(minTerrainPosition, corner);
+            maxTerrainPosition = max(maxTerrainPosition, corner);
+        }
+
+        // Compute & round chunk coordinates
+        const int2 minChunkPosition(static_cast<int32_t>(std::floor(minTerrainPosition.x / ChunkSize)),
+                                    static_cast<int32_t>(std::floor(minTerrainPosition.y / ChunkSize)));
+        const int2 maxChunkPosition(static_cast<int32_t>(std::ceil(maxTerrainPosition.x / ChunkSize)),
+                                    static_cast<int32_t>(std::ceil(maxTerrainPosition.y / ChunkSize)));
+
+        const int32_t maxGridSize = static_cast<int32_t>(MaxChunkGridSize);
+
+        ChunkGridRecord record;
+        record.grid   = uint2(std::clamp(maxChunkPosition.x - minChunkPosition.x, 0, maxGridSize), std::clamp(maxChunkPosition.y - minChunkPosition.y, 0, maxGridSize));
+        record.offset = minChunkPosition;
+
+        return record;
+    }
+
+    float2 GetTerrainChunkCenter(const int2& chunkGridPosition)
+    {
+        const float2 chunkWorldPosition = ToFloat2(chunkGridPosition) * ChunkSize;
+
+        return chunkWorldPosition + float2(ChunkSize * 0.5f);
+    }
+
+    int32_t GetTerrainChunkLevelOfDetail(const float3& cameraPosition, const float3& chunkCenterPosition)
+    {
+        const float distanceToCamera = distance(cameraPosition, chunkCenterPosition);
+
+        return static_cast<int32_t>(clamp(distanceToCamera / (3 * ChunkSize), 0.f, 3.f));
+    }
+
+    uint32_t GetDominantBiome(const float3& biomeWeights)
+    {
+        return biomeWeights.x > biomeWeights.y ? (biomeWeights.x > biomeWeights.z ? 0 : 2) : (biomeWeights.y > biomeWeights.z ? 1 : 2);
+    }
+
+    uint32_t GetChunkTileBiome(const uint4& tileBiomes, uint32_t tileIndex)
+    {
+        return (tileBiomes[tileIndex / 16] >> ((tileIndex % 16) * 2)) & 3u;
+    }
+
+    void SetChunkTileBiome(uint4& tileBiomes, uint32_t tileIndex, uint32_t biome)
+    {
+        const uint32_t shift = (tileIndex % 16) * 2;
+
+        tileBiomes[tileIndex / 16] = (tileBiomes[tileIndex / 16] & ~(3u << shift)) | ((biome & 3u) << shift);
+    }
+
+    static void World(GroupContext& group)
+    {
+        group.Output<ChunkGridRecord>(WorldGraphNode::ChunkGrid) = ComputeChunkGrid(group.Graph.Data, group.Graph.Quality);
+    }
+
+    static int32_t GetTerrainChunkLevelOfDetail(const GraphContext& graph, const int2& chunkGridPosition)
+    {
+        return GetTerrainChunkLevelOfDetail(graph.GetCameraPosition(), graph.GetTerrainPosition(GetTerrainChunkCenter(chunkGridPosition)));
+    }
+
+    static void OutputTerrainChunk(GroupContext& group, const int2& chunkGridPosition, int32_t levelOfDetail, uint32_t levelOfDetailTransitionMask)
+    {
+        const uint32_t dispatchSize = 8 / std::clamp(1u << levelOfDetail, 1u, 8u);
+
+        auto& record             = group.Output<DrawTerrainChunkRecord>(WorldGraphNode::DrawTerrainChunk);
+        record.dispatchGrid      = uint3(dispatchSize, dispatchSize, 1);
+        record.chunkGridPosition = chunkGridPosition;
+        record.levelOfDetail     = levelOfDetail;
+
+        record.levelOfDetailTransition.x = levelOfDetailTransitionMask & 1;
+        record.levelOfDetailTransition.y = (levelOfDetailTransitionMask >> 1) & 1;
+        record.levelOfDetailTransition.z = (levelOfDetailTransitionMask >> 2) & 1;
+        record.levelOfDetailTransition.w = (levelOfDetailTransitionMask >> 3) & 1;
+    }
+
+    // Tile output, one thread per tile.
+    // pTileBiomes holds the dominant biome of each tile for chunks classified on the CPU, nullptr samples the biome weights.
+    static void OutputTiles(GroupContext& group, const int2& chunkGridPosition, const uint4* pTileBiomes)
+    {
+        const GraphContext& graph = group.Graph;
+
+        for (int32_t y = 0; y < static_cast<int32_t>(tilesPerChunk); ++y)
+        {
+            for (int32_t x = 0; x < static_cast<int32_t>(tilesPerChunk); ++x)
+            {
+                const int2   threadGridPosition  = int2(chunkGridPosition.x * tilesPerChunk + x, chunkGridPosition.y * tilesPerChunk + y);
+                const float2 threadWorldPosition = ToFloat2(threadGridPosition) * TileSize;
+
+                const AxisAlignedBoundingBox tileBoundingBox = graph.GetGridBoundingBox(threadGridPosition, TileSize, TerrainChunkMinHeight, TerrainChunkMaxHeight);
+
+                if (!IsVisible(tileBoundingBox, graph.Planes))
+                {
+                    continue;
+                }
+
+                // Classify biome tile to launch by dominant biome in center of tile
+                const uint32_t biome = pTileBiomes ? GetChunkTileBiome(*pTileBiomes, y * tilesPerChunk + x)
+                                                   : GetDominantBiome(graph.GetBiomeWeights(threadWorldPosition + float2(TileSize * 0.5f)));
+
+                if (biome == ChunkTileCulled)
+                {
+                    continue;
+                }
+
+                const WorldGraphNode tileNode = static_cast<WorldGraphNode>(static_cast<uint32_t>(WorldGraphNode::MountainTile) + biome);
+
+                group.Output<TileRecord>(tileNode).position = threadGridPosition;
+            }
+        }
+    }
+
+    static void ChunkGrid(GroupContext& group)
+    {
+        const GraphContext&    graph             = group.Graph;
+        const ChunkGridRecord& input             = group.GetInput<ChunkGridRecord>();
+        const int2             chunkGridPosition = input.offset + int2(static_cast<int32_t>(group.GroupId.x), static_cast<int32_t>(group.GroupId.y));
+
+        const AxisAlignedBoundingBox chunkBoundingBox = graph.GetGridBoundingBox(chunkGridPosition, ChunkSize, TerrainChunkMinHeight, TerrainChunkMaxHeight);
+        const bool                   isChunkVisible   = IsVisible(chunkBoundingBox, graph.Planes);
+
+        if (!isChunkVisible)
+        {
+            return;
+        }
+
+        // Terrain output
+        const int32_t levelOfDetail = GetTerrainChunkLevelOfDetail(graph, chunkGridPosition);
+
+        uint32_t levelOfDetailTransitionMask = 0;
+        levelOfDetailTransitionMask |= (GetTerrainChunkLevelOfDetail(graph, chunkGridPosition + int2(-1, 0)) > levelOfDetail) ? 1u : 0u;
+        levelOfDetailTransitionMask |= (GetTerrainChunkLevelOfDetail(graph, chunkGridPosition + int2(0, -1)) > levelOfDetail) ? 2u : 0u;
+        levelOfDetailTransitionMask |= (GetTerrainChunkLevelOfDetail(graph, chunkGridPosition + int2(1, 0)) > levelOfDetail) ? 4u : 0u;
+        levelOfDetailTransitionMask |= (GetTerrainChunkLevelOfDetail(graph, chunkGridPosition + int2(0, 1)) > levelOfDetail) ? 8u : 0u;
+
+        OutputTerrainChunk(group, chunkGridPosition, levelOfDetail, levelOfDetailTransitionMask);
+        OutputTiles(group, chunkGridPosition, nullptr);
+    }
+
+    // Entry node for chunks culled on the CPU, the input record already holds the level of detail & the tile biomes
+    static void Chunk(GroupContext& group)
+    {
+        const ChunkRecord& input = group.GetInput<ChunkRecord>();
+
+        OutputTerrainChunk(group, input.chunkGridPosition, input.levelOfDetail, input.levelOfDetailTransitionMask);
+        OutputTiles(group, input.chunkGridPosition, &input.tileBiomes);
+    }
+
+    // ==================
+    // Biome tiles, see biomes.hlsl
+    // Threads of a group are executed one after another between group barriers.
+    // Group records are filled in thread order, which is one of the orders the atomic counters in the shaders can produce.
+
+    static const uint32_t ThreadsPerTile = detailedTilesPerTile * detailedTilesPerTile;
+
+    static int2 GetGroupThreadId(uint32_t linearGroupThreadId, uint32_t groupWidth)
+    {
+        return int2(static_cast<int32_t>(linearGroupThreadId % groupWidth), static_cast<int32_t>(linearGroupThreadId / groupWidth));
+    }
+
+    static int2 GetDetailedTileGridPosition(const int2& tileGridPosition, const int2& groupThreadId)
+    {
+        return int2(tileGridPosition.x * static_cast<int32_t>(detailedTilesPerTile) + groupThreadId.x,
+                    tileGridPosition.y * static_cast<int32_t>(detailedTilesPerTile) + groupThreadId.y);
+    }
+
+    static uint32_t GetSeed(const int2& gridPosition)
+    {
+        return CombineSeed(AsUint(gridPosition.x), AsUint(gridPosition.y));
+    }
+
+    float2 GetTerrainTileCenter(const int2& tileGridPosition)
+    {
+        return ToFloat2(tileGridPosition) * TileSize + float2(TileSize * 0.5f);
+    }
+
+    float2 GetTerrainDetailedTileCenter(const int2& tileGridPosition, uint32_t detailedTileIndex)
+    {
+        const int2   groupThreadId       = GetGroupThreadId(detailedTileIndex, detailedTilesPerTile);
+        const float2 threadWorldPosition = ToFloat2(GetDetailedTileGridPosition(tileGridPosition, groupThreadId)) * DetailedTileSize;
+
+        return threadWorldPosition + float2(DetailedTileSize * 0.5f);
+    }
+
+    float2 GetTerrainDetailedTileCorner(const int2& tileGridPosition, uint32_t detailedTileIndex)
+    {
+        const int2 groupThreadId = GetGroupThreadId(detailedTileIndex, detailedTilesPerTile);
+
+        return ToFloat2(GetDetailedTileGridPosition(tileGridPosition, groupThreadId)) * DetailedTileSize;
+    }
+
+    MountainTileFeatures ComputeMountainTileFeatures(const int2&  tileGridPosition,
+                                                     float        tileCenterHeight,
+                                                     const float* detailedTileCenterHeights,
+                                                     const float* detailedTileCornerNormalsY)
+    {
+        MountainTileFeatures result;
+
+        // Gradient estimation
+        int32_t terrainGradient = 0;
+
+        for (uint32_t i = 0; i < ThreadsPerTile; ++i)
+        {
+            const int2    groupThreadId = GetGroupThreadId(i, detailedTilesPerTile);
+            const int32_t border        = detailedTilesPerTile - 1;
+
+            if ((groupThreadId.x == 0) || (groupThreadId.y == 0) || (groupThreadId.x == border) || (groupThreadId.y == border))
+            {
+                const float towardsCenter = tileCenterHeight - detailedTileCenterHeights[i];
+
+                terrainGradient += static_cast<int32_t>(towardsCenter * 10.f);
+            }
+        }
+
+        // Tree cluster
+        {
+            const uint32_t seed = GetSeed(tileGridPosition);
+
+            const bool hasTreeCluster = (terrainGradient < 0) && (Random(seed, 97834) > 0.55f);
+            result.TreeCount          = static_cast<uint32_t>(hasTreeCluster * round(lerp(5.f, 10.f, Random(seed, 5614))));
+        }
+
+        // Rocks
+        for (uint32_t i = 0; i < ThreadsPerTile; ++i)
+        {
+            const uint32_t seed = GetSeed(GetDetailedTileGridPosition(tileGridPosition, GetGroupThreadId(i, detailedTilesPerTile)));
+
+            const bool hasRock = (std::abs(terrainGradient) < 500) && (Random(seed, 7982) > 0.75f) && (detailedTileCornerNormalsY[i] > 0.65f);
+
+            if (hasRock)
+            {
+                result.RockMask |= uint64_t(1) << i;
+            }
+        }
+
+        return result;
+    }
+
+    static void MountainTile(GroupContext& group)
+    {
+        const GraphContext& graph                   = group.Graph;
+        const int2          tileGridPosition        = group.GetInput<TileRecord>().position;
+        const float2        tileCenterWorldPosition = GetTerrainTileCenter(tileGridPosition);
+
+        MountainTileFeatures features;
+
+        // Tree clusters & rocks only depend on the terrain, cached tiles skip all terrain queries
+        if (!graph.pMetadataCache || !graph.pMetadataCache->FindMountainTileFeatures(tileGridPosition, features))
+        {
+            float threadCenterHeight[ThreadsPerTile];
+            float threadCornerNormalY[ThreadsPerTile];
+
+            for (uint32_t i = 0; i < ThreadsPerTile; ++i)
+            {
+                // height at the detailed tile center, where rocks are placed, slope at the detailed tile corner
+                threadCenterHeight[i]  = graph.GetTerrainPosition(GetTerrainDetailedTileCenter(tileGridPosition, i)).y;
+                threadCornerNormalY[i] = graph.GetTerrainNormal(GetTerrainDetailedTileCorner(tileGridPosition, i)).y;
+            }
+
+            features = ComputeMountainTileFeatures(tileGridPosition, graph.GetTerrainPosition(tileCenterWorldPosition).y, threadCenterHeight, threadCornerNormalY);
+        }
+
+        // Tree cluster output
+        {
+            const uint32_t seed = GetSeed(tileGridPosition);
+
+            for (uint32_t i = 0; i < std::min(features.TreeCount, ThreadsPerTile); ++i)
+            {
+                const float  angle  = i * (1.5f + Random(seed, 8437));
+                const float  radius = i * (1.f + Random(seed, 4742));
+                const float2 offset = float2(std::sin(angle), std::cos(angle)) * radius;
+
+                group.Output<GenerateTreeRecord>(WorldGraphNode::GeneratePineTree).position = tileCenterWorldPosition + offset;
+            }
+        }
+
+        // Rock output
+        for (uint32_t i = 0; i < ThreadsPerTile; ++i)
+        {
+            if ((features.RockMask >> i) & 1)
+            {
+                group.Output<GenerateTreeRecord>(WorldGraphNode::GenerateRock).position = GetTerrainDetailedTileCenter(tileGridPosition, i);
+            }
+        }
+    }
+
+    static bool HasTree(const GraphContext& graph, const int2& detailedTileGridPosition, int32_t& outTreeType, float2& outTreePosition)
+    {
+        outTreeType     = -1;
+        outTreePosition = float2(INFINITY);
+
+        const float2 detailedTileWorldPosition = ToFloat2(detailedTileGridPosition) * DetailedTileSize;
+
+        const uint32_t seed = GetSeed(detailedTileGridPosition);
+
+        // biome weights & normal from a single terrain evaluation
+        const TerrainSample terrainSample = graph.GetTerrainSample(detailedTileWorldPosition);
+        const float3        biomeWeight   = terrainSample.BiomeWeights;
+        const float3        terrainNormal = terrainSample.Normal;
+
+        // check if woodlands is the dominant biome
+        if ((biomeWeight.y < biomeWeight.x) || (biomeWeight.y < biomeWeight.z))
+        {
+            return false;
+        }
+
+        const float2 randomOffset = float2(Random(seed, 82347), Random(seed, 9780));
+
+        outTreeType     = ((biomeWeight.x > 0.4f) || (terrainNormal.y < 0.85f)) ? 1 : 0;
+        outTreePosition = detailedTileWorldPosition + randomOffset * DetailedTileSize;
+
+        return (Random(seed, 7982) > 0.1f) &&             // Randomly limit tree occurance
+               (Random(seed, 28937) < biomeWeight.y) &&  // Only place trees in woodland biome
+               (terrainNormal.y > 0.65f);                // Don't place trees on very steep slopes
+    }
+
+    /**
+     * Per-thread values shared by the sparse grass & detailed tile outputs of the woodland & grassland tiles.
+     */
+    struct BiomeTileThread
+    {
+        int2   GridPosition;
+        float2 WorldPosition;
+        float3 CenterWorldPosition;
+        float  CenterDistanceToCamera;
+        bool   IsVisible;
+    };
+
+    static void InitBiomeTileThread(const GraphContext& graph, const int2& tileGridPosition, uint32_t linearGroupThreadId, float centerHeight, BiomeTileThread& thread)
+    {
+        thread.GridPosition = GetDetailedTileGridPosition(tileGridPosition, GetGroupThreadId(linearGroupThreadId, detailedTilesPerTile));
+        thread.WorldPosition = ToFloat2(thread.GridPosition) * DetailedTileSize;
+
+        const float2 centerPosition   = thread.WorldPosition + float2(DetailedTileSize * 0.5f);
+        thread.CenterWorldPosition    = float3(centerPosition.x, centerHeight, centerPosition.y);
+        thread.CenterDistanceToCamera = distance(graph.GetCameraPosition(), thread.CenterWorldPosition);
+
+        thread.IsVisible = IsVisible(graph.GetCurvedGridBoundingBox(
+                                         thread.GridPosition, DetailedTileSize, centerHeight + DetailedTileMinHeightOffset, centerHeight + DetailedTileMaxHeightOffset),
+                                     graph.Planes);
+    }
+
+    static void OutputSparseGrass(GroupContext& group, const BiomeTileThread* threads)
+    {
+        const GraphContext& graph  = group.Graph;
+        const int2          origin = GetDetailedTileGridPosition(group.GetInput<TileRecord>().position, int2(0, 0));
+
+        DrawSparseGrassRecord* pRecord    = nullptr;
+        uint32_t               patchCount = 0;
+
+        for (uint32_t i = 0; i < ThreadsPerTile; ++i)
+        {
+            const BiomeTileThread& thread = threads[i];
+
+            // --- frustum cull ---
+            const float radius    = std::sqrt(static_cast<float>(grassPatchesPerDetailedTile * grassPatchesPerDetailedTile)) * GrassSpacing;
+            bool        hasOutput = IsSphereVisible(graph.GetCurvedWorldSpacePosition(thread.CenterWorldPosition), radius, graph.Planes);
+
+            // --- distance cull ---
+            if (((thread.CenterDistanceToCamera + radius) < graph.DenseGrassMaxDistance) ||
+                ((thread.CenterDistanceToCamera + radius) > graph.SparseGrassMaxDistance))
+            {
+                hasOutput = false;
+            }
+
+            if (hasOutput)
+            {
+                if (!pRecord)
+                {
+                    pRecord         = &group.Output<DrawSparseGrassRecord>(WorldGraphNode::DrawSparseGrassPatch);
+                    pRecord->origin = origin;
+                }
+
+                // XZ-position
+                pRecord->position[patchCount++] =
+                    int16_t2(static_cast<int16_t>(thread.GridPosition.x - origin.x), static_cast<int16_t>(thread.GridPosition.y - origin.y));
+            }
+        }
+
+        if (pRecord)
+        {
+            pRecord->dispatchGrid = uint3(patchCount, sparseGrassThreadGroupsPerRecord, 1);
+        }
+    }
+
+    static void OutputDetailedTiles(GroupContext& group, const BiomeTileThread* threads)
+    {
+        for (uint32_t i = 0; i < ThreadsPerTile; ++i)
+        {
+            const bool hasDetailedTileOutput =
+                threads[i].IsVisible && (threads[i].CenterDistanceToCamera < (group.Graph.DenseGrassMaxDistance + (DetailedTileSize * 2)));
+
+            if (hasDetailedTileOutput)
+            {
+                group.Output<TileRecord>(WorldGraphNode::DetailedTile).position = threads[i].GridPosition;
+            }
+        }
+    }
+
+    static void WoodlandTile(GroupContext& group)
+    {
+        const GraphContext& graph             = group.Graph;
+        const int2          tileGridPosition  = group.GetInput<TileRecord>().position;
+        const float2        tileWorldPosition = ToFloat2(tileGridPosition) * TileSize;
+
+        BiomeTileThread threads[ThreadsPerTile];
+        for (uint32_t i = 0; i < ThreadsPerTile; ++i)
+        {
+            const int2   gridPosition   = GetDetailedTileGridPosition(tileGridPosition, GetGroupThreadId(i, detailedTilesPerTile));
+            const float2 centerPosition = ToFloat2(gridPosition) * DetailedTileSize + float2(DetailedTileSize * 0.5f);
+
+            InitBiomeTileThread(graph, tileGridPosition, i, graph.GetTerrainPosition(centerPosition).y, threads[i]);
+        }
+
+        OutputSparseGrass(group, threads);
+
+        // tree output
+        DrawMushroomRecord* pMushroomRecord = nullptr;
+        uint32_t            mushroomCount   = 0;
+
+        for (uint32_t i = 0; i < ThreadsPerTile; ++i)
+        {
+            const BiomeTileThread& thread = threads[i];
+            const uint32_t         seed   = GetSeed(thread.GridPosition);
+
+            int32_t    treeType;
+            float2     treePosition;
+            const bool hasTreeOutput = HasTree(graph, thread.GridPosition, treeType, treePosition);
+
+            if (hasTreeOutput)
+            {
+                const WorldGraphNode treeNode = (treeType == 0) ? WorldGraphNode::GenerateOakTree : WorldGraphNode::GeneratePineTree;
+
+                group.Output<GenerateTreeRecord>(treeNode).position = treePosition;
+            }
+
+            // Place mushrooms under each tree
+            const bool hasMushroomOutput = hasTreeOutput && (thread.CenterDistanceToCamera < (graph.MushroomMaxDistance * 1.5f + (DetailedTileSize * 2)));
+            // Select random number of mushrooms to generate
+            const int32_t mushroomOutputCount =
+                static_cast<int32_t>(hasMushroomOutput * round(lerp(1.f, static_cast<float>(maxMushroomsPerDetailedTile), Random(seed, 67823))));
+
+            if (mushroomOutputCount > 0 && !pMushroomRecord)
+            {
+                pMushroomRecord         = &group.Output<DrawMushroomRecord>(WorldGraphNode::DrawMushroomPatch);
+                pMushroomRecord->origin = tileWorldPosition;
+            }
+
+            for (int32_t mushroomIndex = 0; mushroomIndex < mushroomOutputCount; ++mushroomIndex)
+            {
+                const float  mushroomAngleRange  = Pi / 2;
+                const float  mushroomOffsetAngle = (-mushroomAngleRange / 2.f) + (mushroomIndex * (mushroomAngleRange / mushroomOutputCount)) +
+                                                  (Random(seed, AsUint(mushroomIndex), 23456) - 1.f) * (mushroomAngleRange / mushroomOutputCount);
+                const float  mushroomOffsetRadius = 0.75f + Random(seed, AsUint(mushroomIndex), 89237) * 0.5f;
+                const float2 mushroomOffset       = float2(std::cos(mushroomOffsetAngle), std::sin(mushroomOffsetAngle)) * mushroomOffsetRadius;
+
+                pMushroomRecord->position[mushroomCount++] = EncodeRecordPosition(graph.GetTerrainPosition(treePosition + mushroomOffset), tileWorldPosition);
+            }
+        }
+
+        if (pMushroomRecord)
+        {
+            pMushroomRecord->dispatchGrid = uint3(mushroomCount, 1, 1);
+        }
+
+        OutputDetailedTiles(group, threads);
+    }
+
+    static void GrasslandTile(GroupContext& group)
+    {
+        const GraphContext& graph                   = group.Graph;
+        const int2          tileGridPosition        = group.GetInput<TileRecord>().position;
+        const float2        tileWorldPosition       = ToFloat2(tileGridPosition) * TileSize;
+        const float3        tileCenterWorldPosition = graph.GetTerrainPosition(tileWorldPosition + float2(TileSize * 0.5f));
+
+        BiomeTileThread threads[ThreadsPerTile];
+        float3          threadBiomeWeights[ThreadsPerTile];
+        for (uint32_t i = 0; i < ThreadsPerTile; ++i)
+        {
+            const int2   gridPosition   = GetDetailedTileGridPosition(tileGridPosition, GetGroupThreadId(i, detailedTilesPerTile));
+            const float2 cornerPosition = ToFloat2(gridPosition) * DetailedTileSize;
+            const float2 centerPosition = cornerPosition + float2(DetailedTileSize * 0.5f);
+
+            // meadow weight at the detailed tile corner
+            threadBiomeWeights[i] = graph.GetBiomeWeights(cornerPosition);
+
+            InitBiomeTileThread(graph, tileGridPosition, i, graph.GetTerrainPosition(centerPosition).y, threads[i]);
+        }
+
+        const bool isNight = graph.IsNight();
+
+        OutputSparseGrass(group, threads);
+
+        // butterfly output
+        {
+            DrawInsectRecord* pRecord        = nullptr;
+            uint32_t          butterflyCount = 0;
+
+            for (uint32_t i = 0; i < ThreadsPerTile; ++i)
+            {
+                const uint32_t seed = GetSeed(threads[i].GridPosition);
+
+                // 2% chance of spawning butterflies
+                const float butterflyProbability = 0.02f;
+                const bool  hasButterflyOutput   = !isNight &&                                                    // no butterflies at night
+                                                (threads[i].CenterDistanceToCamera < graph.ButterflyMaxDistance) &&  // cull butterflies in distance
+                                                (Random(seed, 1998) < butterflyProbability);
+
+                if (hasButterflyOutput)
+                {
+                    if (!pRecord)
+                    {
+                        pRecord         = &group.Output<DrawInsectRecord>(WorldGraphNode::DrawButterflies);
+                        pRecord->origin = tileWorldPosition;
+                    }
+
+                    pRecord->position[butterflyCount++] = EncodeRecordPosition(threads[i].CenterWorldPosition, tileWorldPosition);
+                }
+            }
+
+            if (pRecord)
+            {
+                pRecord->dispatchGrid = uint3(butterflyCount, 1, 1);
+            }
+        }
+
+        // flower output
+        {
+            const uint32_t flowerType = distance(graph.GetCameraPosition(), tileCenterWorldPosition) > graph.FlowerSparseStartDistance;
+
+            DrawFlowerRecord* pFlowerRecord = nullptr;
+            DrawInsectRecord* pBeeRecord    = nullptr;
+            uint32_t          flowerCount   = 0;
+            uint32_t          beeCount      = 0;
+
+            for (uint32_t i = 0; i < ThreadsPerTile; ++i)
+            {
+                const BiomeTileThread& thread      = threads[i];
+                const float3&          biomeWeight = threadBiomeWeights[i];
+                const uint32_t         seed        = GetSeed(thread.GridPosition);
+
+                // cull flowers for visibility and max distance
+                const float flowerMaxDistance  = graph.FlowerMaxDistance;
+                const float flowerCullDistance = flowerMaxDistance - (Random(seed, 8437) * flowerMaxDistance * 0.2f);
+                const bool  hasFlowerOutput    = thread.IsVisible && (thread.CenterDistanceToCamera < flowerCullDistance);
+                // select random number of flowers to generate. number also depends on meadow biome weight
+                const int32_t flowerOutputCount =
+                    static_cast<int32_t>(hasFlowerOutput * round(lerp(0.f, static_cast<float>(maxFlowersPerDetailedTile), Random(seed, 2134) * biomeWeight.z)));
+                // 30% chance of spawning bees over a flower
+                const float beeProbability = 0.3f;
+                // one of the generated flowers can also spawn a bee patch
+                const bool hasBeeOutput = (flowerOutputCount > 0) &&                          // patch has at least one flower
+                                          !isNight &&                                         // no bees at night
+                                          (thread.CenterDistanceToCamera < graph.BeeMaxDistance) &&  // cull bees in distance
+                                          (Random(seed, 2378) < beeProbability);              // limit bee occurrance
+
+                if (flowerOutputCount == 0)
+                {
+                    continue;
+                }
+
+                if (!pFlowerRecord)
+                {
+                    pFlowerRecord = &group.Output<DrawFlowerRecord>(flowerType == 1 ? WorldGraphNode::DrawSparseFlowerPatch : WorldGraphNode::DrawFlowerPatch);
+                    pFlowerRecord->origin = tileWorldPosition;
+                }
+
+                const uint32_t flowerOutputIndex = flowerCount;
+
+                for (int32_t flowerId = 0; flowerId < flowerOutputCount; ++flowerId)
+                {
+                    const uint32_t x      = asuint(thread.WorldPosition.x);
+                    const uint32_t y      = asuint(thread.WorldPosition.y);
+                    const float2   offset = float2(Random(x, y, AsUint(flowerId), 4387), Random(x, y, AsUint(flowerId), 8327)) * DetailedTileSize;
+
+                    pFlowerRecord->position[flowerCount++] = EncodeRecordPosition(thread.WorldPosition + offset, tileWorldPosition);
+                }
+
+                if (hasBeeOutput)
+                {
+                    if (!pBeeRecord)
+                    {
+                        pBeeRecord         = &group.Output<DrawInsectRecord>(WorldGraphNode::DrawBees);
+                        pBeeRecord->origin = tileWorldPosition;
+                    }
+
+                    // bees fly above the first flower of the detailed tile, at its decoded position as seen by the flower mesh shader
+                    const float2 flowerPosition = DecodeRecordPosition(pFlowerRecord->position[flowerOutputIndex], tileWorldPosition);
+
+                    pBeeRecord->position[beeCount++] = EncodeRecordPosition(graph.GetTerrainPosition(flowerPosition), tileWorldPosition);
+                }
+            }
+
+            if (pFlowerRecord)
+            {
+                if (flowerType == 1)
+                {
+                    pFlowerRecord->dispatchGrid = uint3((flowerCount + flowersInSparseFlowerThreadGroup - 1) / flowersInSparseFlowerThreadGroup, 1, 1);
+                }
+                else
+                {
+                    pFlowerRecord->dispatchGrid = uint3(flowerCount, 1, 1);
+                }
+                pFlowerRecord->flowerPatchCount = flowerCount;
+            }
+            if (pBeeRecord)
+            {
+                pBeeRecord->dispatchGrid = uint3(beeCount, 1, 1);
+            }
+        }
+
+        OutputDetailedTiles(group, threads);
+    }
+
+    static void DetailedTile(GroupContext& group)
+    {
+        const GraphContext& graph             = group.Graph;
+        const int2          tileGridPosition  = group.GetInput<TileRecord>().position;
+        const float2        tileWorldPosition = ToFloat2(tileGridPosition) * DetailedTileSize;
+
+        DrawDenseGrassRecord* pRecord    = nullptr;
+        uint32_t              patchCount = 0;
+
+        for (uint32_t i = 0; i < grassPatchesPerDetailedTile * grassPatchesPerDetailedTile; ++i)
+        {
+            const int2 groupThreadId      = GetGroupThreadId(i, grassPatchesPerDetailedTile);
+            const int2 threadGridPosition = int2(tileGridPosition.x * static_cast<int32_t>(grassPatchesPerDetailedTile) + groupThreadId.x,
+                                                 tileGridPosition.y * static_cast<int32_t>(grassPatchesPerDetailedTile) + groupThreadId.y);
+            const float2 threadWorldPosition = (ToFloat2(threadGridPosition) + GetGrassOffset(threadGridPosition)) * GrassSpacing;
+
+            // get terrain height and normal & biome weights
+            const TerrainSample patchSample   = graph.GetTerrainSample(threadWorldPosition);
+            const float3        patchPosition = float3(threadWorldPosition.x, patchSample.Height, threadWorldPosition.y);
+            const float3        patchNormal   = patchSample.Normal;
+            const float3        biomeWeights  = patchSample.BiomeWeights;
+
+            bool hasOutput = true;
+
+            // don't spawn grass on extremly steep slopes
+            if (patchNormal.y < 0.55f)
+            {
+                hasOutput = false;
+            }
+
+            // cull against view frustum
+            const float radius = 4 * GrassSpacing;
+            if (!IsSphereVisible(patchPosition, radius, graph.Planes))
+            {
+                hasOutput = false;
+            }
+
+            const float distanceToCamera = distance(graph.GetCameraPosition(), patchPosition);
+
+            // cull against distance to camera
+            if (distanceToCamera > graph.DenseGrassMaxDistance)
+            {
+                hasOutput = false;
+            }
+
+            // cull at biome transitions to mountain biome
+            if (Random(asuint(patchPosition.x), asuint(patchPosition.z), 2378) < biomeWeights.x * 2)
+            {
+                hasOutput = false;
+            }
+
+            if (!hasOutput)
+            {
+                continue;
+            }
+
+            const float minGrassHeight = 0.2f;
+            const float maxGrassHeight = minGrassHeight + .35f;
+            const float grassHeight =
+                minGrassHeight + (maxGrassHeight - minGrassHeight) * Random(AsUint(threadGridPosition.x), AsUint(threadGridPosition.y), 34567);
+
+            // Each dense grass mesh shader can only render 16 grass blades.
+            // If grass patch has more than 16 blades, we require two thread groups to draw this patch
+            const bool hasSplitOutput =
+                graph.GetDenseGrassBladeCount(static_cast<float>(std::min(graph.Quality.MaxNumGrassBlades, 32u)), distanceToCamera) > 16.f;
+
+            if (!pRecord)
+            {
+                pRecord         = &group.Output<DrawDenseGrassRecord>(WorldGraphNode::DrawDenseGrassPatch);
+                pRecord->origin = tileWorldPosition;
+            }
+
+            const int16_t3 encodedPatchPosition = EncodeRecordPosition(patchPosition, tileWorldPosition);
+
+            for (uint32_t bladeOffset = 0; bladeOffset < (hasSplitOutput ? 2u : 1u); ++bladeOffset)
+            {
+                pRecord->position[patchCount] = encodedPatchPosition;
+                pRecord->patch[patchCount]    = EncodeDenseGrassPatch(grassHeight, bladeOffset);
+                ++patchCount;
+            }
+        }
+
+        if (pRecord)
+        {
+            pRecord->dispatchGrid = uint3(patchCount, 1, 1);
+        }
+    }
+
+    // ==================
+    // Trees & rocks, see tree.hlsl & rock.hlsl
+
+    // Spline generated by the tree & rock nodes, same as GeneratedSpline in splinegeneration.hlsl
+    struct GeneratedSpline
+    {
+        float2   Origin;
+        float3   Color;
+        float    RotationOffset = 0.f;
+        float2   WindStrength;
+        uint32_t ControlPointCount = 0;
+        // packed vertex counts, see EncodeVertexCounts
+        uint2  VertexCounts;
+        float3 Positions[splineMaxControlPointCount];
+        float2 Radii[splineMaxControlPointCount];
+        float  NoiseAmplitudes[splineMaxControlPointCount] = {};
+    };
+
+    static void SetControlPoint(GeneratedSpline& spline, uint32_t index, const float3& position, const float2& radius, float noiseAmplitude)
+    {
+        spline.Positions[index]       = position;
+        spline.Radii[index]           = radius;
+        spline.NoiseAmplitudes[index] = noiseAmplitude;
+    }
+
+    // Writes the pieces of a spline to pieceCapacity consecutive records, same as WriteSpline in splinegeneration.hlsl.
+    // Without WorldGraphDesc::SplitSplines, the spline is written to the first record as a single piece.
+    static void WriteSpline(const GraphContext& graph, DrawSplineRecord* const* records, uint32_t pieceCapacity, uint32_t splineIndex, const GeneratedSpline& spline)
+    {
+        for (uint32_t pieceIndex = 0; pieceIndex < pieceCapacity; ++pieceIndex)
+        {
+            SplinePiece piece = GetSplinePiece(spline.VertexCounts, spline.ControlPointCount, pieceIndex);
+
+            if (!graph.SplitSplines)
+            {
+                piece.firstControlPoint = 0;
+                piece.controlPointCount = spline.ControlPointCount;
+                piece.vertexCounts      = spline.VertexCounts;
+            }
+
+            DrawSplineRecord& record = *records[pieceIndex];
+
+            record.color[splineIndex]                    = EncodeHalf(spline.Color);
+            record.rotationOffset[splineIndex]           = EncodeHalf(spline.RotationOffset);
+            record.windStrength[splineIndex]             = EncodeHalf(spline.WindStrength);
+            record.controlPointCount[splineIndex]        = static_cast<uint16_t>(piece.controlPointCount);
+            record.origin[splineIndex]                   = spline.Origin;
+            record.controlPointVertexCounts[splineIndex] = piece.vertexCounts;
+            record.ringPrefixSums[splineIndex]           = ComputeSplinePrefixSums(piece.vertexCounts, piece.controlPointCount);
+
+            for (uint32_t i = 0; i < piece.controlPointCount; ++i)
+            {
+                const uint32_t controlPointIndex = splineIndex * splineMaxControlPointCount + i;
+                const uint32_t controlPoint      = piece.firstControlPoint + i;
+
+                record.controlPointPositions[controlPointIndex]       = EncodeRecordPosition(spline.Positions[controlPoint], spline.Origin);
+                record.controlPointRadii[controlPointIndex]           = EncodeHalf(spline.Radii[controlPoint]);
+                record.controlPointNoiseAmplitudes[controlPointIndex] = EncodeHalf(spline.NoiseAmplitudes[controlPoint]);
+            }
+        }
+    }
+
+    static uint32_t RoundToUint(float v)
+    {
+        return static_cast<uint32_t>(round(v));
+    }
+
+    static void GenerateOakTree(GroupContext& group)
+    {
+        const GraphContext& graph = group.Graph;
+
+        DrawSplineRecord* records[3];
+        for (auto& pRecord : records)
+        {
+            pRecord               = &group.Output<DrawSplineRecord>(WorldGraphNode::DrawSpline);
+            pRecord->dispatchGrid = uint3(group.RecordCount, 1, 1);
+        }
+
+        for (uint32_t threadId = 0; threadId < group.RecordCount; ++threadId)
+        {
+            const float2        basePositionXZ = group.GetInput<GenerateTreeRecord>(threadId).position;
+            const TerrainSample terrainSample  = graph.GetTerrainSample(basePositionXZ);
+            const float3        basePosition   = float3(basePositionXZ.x, terrainSample.Height, basePositionXZ.y);
+
+            const uint32_t seed = CombineSeed(asuint(basePositionXZ.x), asuint(basePositionXZ.y));
+
+            const float  rotationAngle = Random(seed, 78923) * 2 * Pi;
+            const float3 forward       = float3(std::sin(rotationAngle), 0.f, std::cos(rotationAngle));
+            const float3 up            = lerp(float3(0.f, 1.f, 0.f), terrainSample.Normal, 0.1f);
+            const float3 side          = normalize(cross(forward, up));
+
+            const float upScale   = lerp(0.5f, 1.2f, Random(seed, 546));
+            const float sideScale = lerp(0.6f, 1.0f, Random(seed, 9487));
+
+            const uint32_t splineIndex = threadId;
+
+            // Tree trunk
+            {
+                GeneratedSpline spline;
+                spline.Origin            = basePositionXZ;
+                spline.Color             = float3(0.18f, 0.12f, 0.10f) * 6;
+                spline.WindStrength      = float2(0.f, 0.f);
+                spline.ControlPointCount = 5;
+                spline.VertexCounts      = uint2(EncodeVertexCounts(5, 4, 3, 2), EncodeVertexCounts(1, 0, 0, 0));
+
+                SetControlPoint(spline, 0, basePosition - up, float2(0.5f * sideScale), 0.f);
+                SetControlPoint(spline, 1, basePosition + 2 * upScale * up, float2(0.35f * sideScale), 0.5f);
+                SetControlPoint(spline, 2, basePosition + 4 * upScale * up + 1 * sideScale * forward, float2(0.25f * sideScale), 0.f);
+                SetControlPoint(
+                    spline, 3, basePosition + 4.5f * upScale * up + 1.5f * sideScale * forward + 0.5f * sideScale * side, float2(0.3f * sideScale), 0.f);
+                SetControlPoint(spline, 4, basePosition + 5.5f * upScale * up + 2 * sideScale * forward + 1 * sideScale * side, float2(0.f), 0.f);
+
+                WriteSpline(graph, &records[0], 1, splineIndex, spline);
+            }
+
+            // Tree branch
+            {
+                GeneratedSpline spline;
+                spline.Origin            = basePositionXZ;
+                spline.Color             = float3(0.18f, 0.12f, 0.10f) * 6;
+                spline.WindStrength      = float2(0.f, 0.f);
+                spline.ControlPointCount = 3;
+                spline.VertexCounts      = uint2(EncodeVertexCounts(4, 3, 1, 0), EncodeVertexCounts(0, 0, 0, 0));
+
+                SetControlPoint(spline, 0, basePosition + 3 * upScale * up + 0.5f * sideScale * forward, float2(0.25f * sideScale), 0.f);
+                SetControlPoint(spline, 1, basePosition + 4 * upScale * up - 0.5f * sideScale * forward, float2(0.2f * sideScale), 0.25f);
+                SetControlPoint(spline, 2, basePosition + 5 * upScale * up - 1 * sideScale * forward, float2(0.f), 0.f);
+
+                WriteSpline(graph, &records[1], 1, splineIndex, spline);
+            }
+
+            // Tree leaves
+            {
+                const uint32_t leafVertexCount0 = RoundToUint(lerp(5.f, 7.f, Random(seed, 2156)));
+                const uint32_t leafVertexCount1 = RoundToUint(lerp(3.f, 5.f, Random(seed, 458)));
+
+                GeneratedSpline spline;
+                spline.Origin            = basePositionXZ;
+                spline.Color             = float3(0.3f, 0.3f, 0.0f) * lerp(0.7f, 1.3f, Random(seed, 1456));
+                spline.RotationOffset    = rotationAngle;
+                spline.WindStrength      = float2(0.125f, 0.5f);
+                spline.ControlPointCount = 4;
+                spline.VertexCounts      = uint2(EncodeVertexCounts(1, leafVertexCount0, leafVertexCount1, 1), EncodeVertexCounts(0, 0, 0, 0));
+
+                SetControlPoint(spline, 0, basePosition + 4 * upScale * up + 0.5f * sideScale * forward, float2(0.f), 0.f);
+                SetControlPoint(spline, 1, basePosition + 5 * upScale * up + 0.5f * sideScale * forward, float2(2.5f, 4.f) * sideScale, 0.7f * upScale);
+                SetControlPoint(spline, 2, basePosition + 6.5f * upScale * up + 0.5f * sideScale * forward, float2(3.5f * sideScale), 0.7f * upScale);
+                SetControlPoint(spline, 3, basePosition + 8.5f * upScale * up + 0.5f * sideScale * forward + 0.5f * sideScale * side, float2(0.f), 0.f);
+
+                WriteSpline(graph, &records[2], 1, splineIndex, spline);
+            }
+        }
+    }
+
+    static void GeneratePineTree(GroupContext& group)
+    {
+        const GraphContext& graph = group.Graph;
+
+        // trunk & leaf pieces, the leaves are written to a single record without spline splitting
+        const uint32_t leafPieceCapacity = graph.SplitSplines ? PineLeafSplinePieceCount : 1;
+
+        DrawSplineRecord* records[1 + PineLeafSplinePieceCount];
+        for (uint32_t i = 0; i < (1 + leafPieceCapacity); ++i)
+        {
+            records[i]               = &group.Output<DrawSplineRecord>(WorldGraphNode::DrawSpline);
+            records[i]->dispatchGrid = uint3(group.RecordCount, 1, 1);
+        }
+
+        for (uint32_t threadId = 0; threadId < group.RecordCount; ++threadId)
+        {
+            const float2        basePositionXZ = group.GetInput<GenerateTreeRecord>(threadId).position;
+            const TerrainSample terrainSample  = graph.GetTerrainSample(basePositionXZ);
+            const float3        basePosition   = float3(basePositionXZ.x, terrainSample.Height, basePositionXZ.y);
+            const float3        terrainNormal  = terrainSample.Normal;
+            const float3        basePositionUp = lerp(float3(0.f, 1.f, 0.f), terrainNormal, 0.1f);
+
+            const uint32_t seed = CombineSeed(asuint(basePositionXZ.x), asuint(basePositionXZ.y));
+
+            const float stemTerrainFactor = 1.f + (1.f - smoothstep(0.6f, 1.0f, terrainNormal.y)) * 0.5f;
+
+            const float rotationAngle    = Random(seed, 14658) * 2 * Pi;
+            const float stemHeight       = 1 + Random(seed, 2384) * 2 * stemTerrainFactor;
+            const float leafRadiusScale  = 1.5f + Random(seed, 3827);
+            const float leafSectionScale = 1.5f + Random(seed, 78934) * 2 * stemTerrainFactor;
+
+            const uint32_t splineIndex = threadId;
+
+            // Tree trunk
+            {
+                GeneratedSpline spline;
+                spline.Origin            = basePositionXZ;
+                spline.Color             = float3(1.08f, 0.72f, 0.6f);
+                spline.RotationOffset    = rotationAngle;
+                spline.WindStrength      = float2(0.125f, 0.f);
+                spline.ControlPointCount = 2;
+                spline.VertexCounts      = uint2(EncodeVertexCounts(5, 4, 0, 0), EncodeVertexCounts(0, 0, 0, 0));
+
+                SetControlPoint(spline, 0, basePosition - basePositionUp * 4.f, float2(0.4f), 0.f);
+                SetControlPoint(spline, 1, basePosition + float3(0.f, stemHeight + 0.5f, 0.f), float2(0.3f), 0.f);
+
+                WriteSpline(graph, &records[0], 1, splineIndex, spline);
+            }
+
+            // Tree leaves
+            {
+                const float  green      = saturate(PerlinNoise2D(0.05f * basePositionXZ));
+                const float  brightness = PerlinNoise2D(0.4f * basePositionXZ + float2(498.f, 345.f));
+                const float3 color      = float3(0.24f, 0.25f + green * 0.15f, 0.0f) * (1.0f + brightness * 0.4f);
+
+                const uint32_t ringVertexCount = PineLeafRingVertexCount;
+
+                GeneratedSpline spline;
+                spline.Origin            = basePositionXZ;
+                spline.Color             = color;
+                spline.RotationOffset    = rotationAngle;
+                spline.WindStrength      = float2(0.125f, 0.5f);
+                spline.ControlPointCount = 7;
+                spline.VertexCounts      = uint2(EncodeVertexCounts(1, ringVertexCount, ringVertexCount, ringVertexCount),
+                                            EncodeVertexCounts(ringVertexCount, ringVertexCount, 1, 0));
+
+                const float ringHeight0 = stemHeight;
+                const float ringHeight1 = stemHeight + 1 * leafSectionScale;
+                const float ringHeight2 = stemHeight + 2 * leafSectionScale;
+                const float ringHeight3 = stemHeight + 3 * leafSectionScale;
+
+                SetControlPoint(spline, 0, basePosition + float3(0.f, ringHeight0, 0.f), float2(0.f), 0.f);
+                SetControlPoint(spline, 1, basePosition + float3(0.f, ringHeight0 + 0.5f, 0.f), float2(leafRadiusScale), 0.2f);
+                SetControlPoint(spline, 2, basePosition + float3(0.f, ringHeight1, 0.f), float2(leafRadiusScale * 0.3f), 0.1f);
+                SetControlPoint(spline, 3, basePosition + float3(0.f, ringHeight1 + 0.5f, 0.f), float2(leafRadiusScale * 0.8f), 0.2f);
+                SetControlPoint(spline, 4, basePosition + float3(0.f, ringHeight2, 0.f), float2(leafRadiusScale * 0.3f), 0.1f);
+                SetControlPoint(spline, 5, basePosition + float3(0.f, ringHeight2 + 0.5f, 0.f), float2(leafRadiusScale * 0.6f), 0.2f);
+                SetControlPoint(spline, 6, basePosition + float3(0.f, ringHeight3, 0.f), float2(0.f), 0.f);
+
+                WriteSpline(graph, &records[1], leafPieceCapacity, splineIndex, spline);
+            }
+        }
+    }
+
+    static void GenerateRock(GroupContext& group)
+    {
+        const GraphContext& graph = group.Graph;
+
+        DrawSplineRecord* pRecord = &group.Output<DrawSplineRecord>(WorldGraphNode::DrawSpline);
+        pRecord->dispatchGrid     = uint3(group.RecordCount, 1, 1);
+
+        for (uint32_t threadId = 0; threadId < group.RecordCount; ++threadId)
+        {
+            const float2   basePositionXZ = group.GetInput<GenerateTreeRecord>(threadId).position;
+            const uint32_t seed           = CombineSeed(asuint(basePositionXZ.x), asuint(basePositionXZ.y));
+
+            const TerrainSample terrainSample  = graph.GetTerrainSample(basePositionXZ);
+            const float3        basePosition   = float3(basePositionXZ.x, terrainSample.Height, basePositionXZ.y);
+            const float3        terrainNormal  = terrainSample.Normal;
+            const float3        basePositionUp = lerp(float3(0.f, 1.f, 0.f), terrainNormal, 1 + Random(seed, 456) * 0.5f);
+
+            const float rotationAngle = Random(seed, 14658) * 2 * Pi;
+
+            const float  upScale   = lerp(0.5f, 1.2f, Random(seed, 546));
+            const float  a         = 1.05f + Random(seed, 6514);
+            const float2 sideScale = lerp(0.6f, 5.0f, Random(seed, 9487)) * float2(a, 1.f);
+
+            const float f = 1.05f + Random(seed, 1564);
+            const float c = lerp(0.5f, 0.9f, Random(seed, 49827));
+
+            const uint32_t vertexCount0 = RoundToUint(lerp(5.f, 7.f, Random(seed, 4145)));
+            const uint32_t vertexCount1 = RoundToUint(lerp(5.f, 7.f, Random(seed, 4578)));
+
+            GeneratedSpline spline;
+            spline.Origin            = basePositionXZ;
+            spline.Color             = float3(0.1f, 0.1f, 0.1f) * 3.5f;
+            spline.RotationOffset    = rotationAngle;
+            spline.WindStrength      = float2(0.f);
+            spline.ControlPointCount = 4;
+            spline.VertexCounts      = uint2(EncodeVertexCounts(1, vertexCount0, vertexCount1, 1), EncodeVertexCounts(0, 0, 0, 0));
+
+            SetControlPoint(spline, 0, basePosition - terrainNormal, float2(0.f), 0.f);
+            SetControlPoint(spline, 1, basePosition, sideScale, 0.5f * upScale);
+            SetControlPoint(spline, 2, basePosition + upScale * basePositionUp, c * sideScale, 0.5f * upScale);
+            SetControlPoint(spline, 3, basePosition + f * upScale * basePositionUp, float2(Random(seed, 89514)), 0.f);
+
+            WriteSpline(graph, &pRecord, 1, threadId, spline);
+        }
+    }
+
+    // ==================
+    // Mesh node outputs, i.e. the vertex & primitive counts passed to SetMeshOutputCounts by the mesh shaders
+
+    static uint2 GetTerrainChunkOutputCounts(const DrawTerrainChunkRecord& record)
+    {
+        // 8x8 quads per group, see terrainrenderer.hlsl
+        const uint32_t groupCount = record.dispatchGrid.x * record.dispatchGrid.y;
+
+        return uint2(groupCount * 81, groupCount * 128);
+    }
+
+    static uint2 GetSplineOutputCounts(const DrawSplineRecord& record)
+    {
+        uint2 result = uint2(0, 0);
+
+        for (uint32_t i = 0; i < std::min<uint32_t>(record.dispatchGrid.x, maxSplinesPerRecord); ++i)
+        {
+            const uint32_t controlPointCount = std::min<uint32_t>(record.controlPointCount[i], splineMaxControlPointCount);
+            const uint4&   prefixSums        = record.ringPrefixSums[i];
+
+            const uint32_t vertexCount   = (controlPointCount > 0) ? DecodeSplinePrefixSum(uint2(prefixSums.x, prefixSums.y), controlPointCount - 1) : 0;
+            const uint32_t triangleCount = (controlPointCount > 1) ? DecodeSplinePrefixSum(uint2(prefixSums.z, prefixSums.w), controlPointCount - 2) : 0;
+
+            result.x += std::min(vertexCount, splineMeshMaxVertexCount);
+            result.y += std::min(triangleCount, splineMeshMaxTriangleCount);
+        }
+
+        return result;
+    }
+
+    static uint2 GetDenseGrassOutputCounts(const GraphContext& graph, const DrawDenseGrassRecord& record)
+    {
+        // 16 blades of 8 vertices & 6 triangles per group, see densegrassmeshshader.hlsl
+        const uint32_t groupMaxBladeCount = 16;
+        const float    maxBladeCount      = static_cast<float>(std::min(graph.Quality.MaxNumGrassBlades, 32u));
+
+        uint2 result = uint2(0, 0);
+
+        for (uint32_t i = 0; i < std::min<uint32_t>(record.dispatchGrid.x, maxDenseGrassPatchesPerRecord); ++i)
+        {
+            const float3 patchPosition = DecodeRecordPosition(record.position[i], record.origin);
+            const float  bladeCount    = std::ceil(graph.GetDenseGrassBladeCount(maxBladeCount, distance(patchPosition, graph.GetCameraPosition())));
+            const float  bladeOffset   = static_cast<float>(DecodeDenseGrassPatchBladeOffset(record.patch[i]) * groupMaxBladeCount);
+
+            const uint32_t groupBladeCount = static_cast<uint32_t>(clamp(bladeCount - bladeOffset, 0.f, static_cast<float>(groupMaxBladeCount)));
+
+            result.x += groupBladeCount * 8;
+            result.y += groupBladeCount * 6;
+        }
+
+        return result;
+    }
+
+    static uint2 GetMushroomOutputCounts(const DrawMushroomRecord& record)
+    {
+        // hat & stem points of the mushroom types, see mushroommeshshader.hlsl
+        const uint32_t hatPoints[2] = {7, 8};
+        const uint32_t stemPoints   = 5;
+
+        uint2 result = uint2(0, 0);
+
+        for (uint32_t i = 0; i < std::min<uint32_t>(record.dispatchGrid.x, maxMushroomsPerRecord); ++i)
+        {
+            const float3   patchCenter = DecodeRecordPosition(record.position[i], record.origin);
+            const uint32_t seed        = CombineSeed(asuint(patchCenter.x), asuint(patchCenter.z));
+            const uint32_t type        = static_cast<uint32_t>(2 * Random(seed, 11002));
+
+            const uint32_t vertexCount   = 2 * stemPoints + 2 * hatPoints[type] + 1;
+            const uint32_t triangleCount = 2 * stemPoints + 3 * hatPoints[type];
+            const uint32_t maxCount      = std::min(256 / vertexCount, 192 / triangleCount);
+            const uint32_t count         = static_cast<uint32_t>(std::min(static_cast<float>(maxCount), 1.f + maxCount * Random(seed, 99990001)));
+
+            result.x += count * vertexCount;
+            result.y += count * triangleCount;
+        }
+
+        return result;
+    }
+
+    // see GetFlowerCount in flowermeshshader.hlsl, 6 flowers fit a dense flower group
+    static uint32_t GetFlowerCount(uint32_t seed)
+    {
+        return static_cast<uint32_t>(round(lerp(2.f, 6.f, Random(seed, 6145))));
+    }
+
+    static uint2 GetFlowerOutputCounts(const GraphContext& graph, const DrawFlowerRecord& record)
+    {
+        uint2 result = uint2(0, 0);
+
+        for (uint32_t i = 0; i < std::min<uint32_t>(record.dispatchGrid.x, maxFlowersPerRecord); ++i)
+        {
+            const float3   patchPosition = graph.GetTerrainPosition(DecodeRecordPosition(record.position[i], record.origin));
+            const uint32_t seed          = CombineSeed(asuint(patchPosition.x), asuint(patchPosition.z));
+
+            const uint32_t flowerCount         = GetFlowerCount(seed);
+            const uint32_t headRingVertexCount = static_cast<uint32_t>(round(lerp(4.f, 6.f, Random(seed, 7878))));
+
+            // stem of 6 vertices & triangles, head of two rings & tips
+            result.x += flowerCount * (6 + headRingVertexCount * 2 + 2);
+            result.y += flowerCount * (6 + headRingVertexCount * 4);
+        }
+
+        return result;
+    }
+
+    static uint2 GetSparseFlowerOutputCounts(const DrawFlowerRecord& record)
+    {
+        // each flower is a quad
+        const uint32_t patchCount = std::min<uint32_t>(record.flowerPatchCount, maxFlowersPerRecord);
+
+        uint32_t flowerCount = 0;
+
+        for (uint32_t i = 0; i < std::min<uint32_t>(patchCount, record.dispatchGrid.x * flowersInSparseFlowerThreadGroup); ++i)
+        {
+            const float2 patchPosition = DecodeRecordPosition(record.position[i], record.origin);
+
+            flowerCount += GetFlowerCount(CombineSeed(asuint(patchPosition.x), asuint(patchPosition.y)));
+        }
+
+        return uint2(flowerCount * 4, flowerCount * 2);
+    }
+
+    static uint2 GetMeshOutputCounts(const GraphContext& graph, WorldGraphNode node, const void* pRecord)
+    {
+        const uint3&   grid       = *static_cast<const uint3*>(pRecord);
+        const uint32_t groupCount = grid.x * grid.y * grid.z;
+
+        switch (node)
+        {
+        case WorldGraphNode::DrawTerrainChunk:
+            return GetTerrainChunkOutputCounts(*static_cast<const DrawTerrainChunkRecord*>(pRecord));
+        case WorldGraphNode::DrawSpline:
+            return GetSplineOutputCounts(*static_cast<const DrawSplineRecord*>(pRecord));
+        case WorldGraphNode::DrawSparseGrassPatch:
+            // 32 blades of 4 vertices & 2 triangles per group, see sparsegrassmeshshader.hlsl
+            return uint2(groupCount * 128, groupCount * 64);
+        case WorldGraphNode::DrawDenseGrassPatch:
+            return GetDenseGrassOutputCounts(graph, *static_cast<const DrawDenseGrassRecord*>(pRecord));
+        case WorldGraphNode::DrawMushroomPatch:
+            return GetMushroomOutputCounts(*static_cast<const DrawMushroomRecord*>(pRecord));
+        case WorldGraphNode::DrawFlowerPatch:
+            return GetFlowerOutputCounts(graph, *static_cast<const DrawFlowerRecord*>(pRecord));
+        case WorldGraphNode::DrawSparseFlowerPatch:
+            return GetSparseFlowerOutputCounts(*static_cast<const DrawFlowerRecord*>(pRecord));
+        case WorldGraphNode::DrawBees:
+            // 19 bees of 11 vertices & 10 triangles per group, see beemeshshader.hlsl
+            return uint2(groupCount * 19 * 11, groupCount * 19 * 10);
+        case WorldGraphNode::DrawButterflies:
+            // 13 butterflies of 16 vertices & 14 triangles per group, see butterflymeshshader.hlsl
+            return uint2(groupCount * 13 * 16, groupCount * 13 * 14);
+        default:
+            return uint2(0, 0);
+        }
+    }
+
+    // Used entries of the record arrays, GetGenerationRecordCapacity is the size of the arrays
+    static uint32_t GetMeshRecordEntryCount(WorldGraphNode node, const void* pRecord)
+    {
+        switch (node)
+        {
+        case WorldGraphNode::DrawTerrainChunk:
+            return 0;
+        case WorldGraphNode::DrawFlowerPatch:
+        case WorldGraphNode::DrawSparseFlowerPatch:
+            // the sparse flower record dispatches one group per flowersInSparseFlowerThreadGroup patches
+            return static_cast<const DrawFlowerRecord*>(pRecord)->flowerPatchCount;
+        default:
+            // one group per entry
+            return static_cast<const uint3*>(pRecord)->x;
+        }
+    }
+
+    // ==================
+    // Emulator
+
+    using NodeFunction = void (*)(GroupContext&);
+
+    static const NodeFunction NodeFunctions[WorldGraphNodeCount] = {
+        World,
+        ChunkGrid,
+        Chunk,
+        MountainTile,
+        WoodlandTile,
+        GrasslandTile,
+        DetailedTile,
+        GenerateOakTree,
+        GeneratePineTree,
+        GenerateRock,
+    };
+
+    WorldGraphEmulator::WorldGraphEmulator(const WorldGraphDesc& desc)
+        : m_Desc(desc)
+    {
+        const uint32_t threadCount = (m_Desc.ThreadCount > 0) ? m_Desc.ThreadCount : std::max(std::thread::hardware_concurrency(), 1u);
+
+        m_pScheduler = std::make_unique<WorkStealingScheduler>(threadCount);
+        m_Arenas.resize(threadCount);
+    }
+
+    WorldGraphEmulator::~WorldGraphEmulator() = default;
+
+    const WorldGraphFrame& WorldGraphEmulator::Execute(const WorkGraphCBData& data)
+    {
+        const auto startTime = std::chrono::high_resolution_clock::now();
+
+        ResetFrame();
+
+        // entry record, the World node has no input data
+        m_Frame.Records[static_cast<uint32_t>(WorldGraphNode::World)].push_back(nullptr);
+
+        return ExecuteNodes(data, startTime);
+    }
+
+    const WorldGraphFrame& WorldGraphEmulator::Execute(const WorkGraphCBData& data, const std::vector<ChunkRecord>& chunks)
+    {
+        const auto startTime = std::chrono::high_resolution_clock::now();
+
+        ResetFrame();
+
+        // entry records are copied, such that they stay valid with the rest of the frame
+        for (const ChunkRecord& chunk : chunks)
+        {
+            const ChunkRecord* pRecord = new (m_Arenas[0].Allocate(sizeof(ChunkRecord))) ChunkRecord(chunk);
+
+            m_Frame.Records[static_cast<uint32_t>(WorldGraphNode::Chunk)].push_back(pRecord);
+        }
+
+        return ExecuteNodes(data, startTime);
+    }
+
+    void WorldGraphEmulator::ResetFrame()
+    {
+        for (auto& arena : m_Arenas)
+        {
+            arena.Reset();
+        }
+        for (uint32_t i = 0; i < WorldGraphNodeCount; ++i)
+        {
+            m_Frame.Records[i].clear();
+            m_Frame.Nodes[i] = {};
+        }
+    }
+
+    const WorldGraphFrame& WorldGraphEmulator::ExecuteNodes(const WorkGraphCBData& data, std::chrono::high_resolution_clock::time_point startTime)
+    {
+        // Producers are ordered before their consumers in WorldGraphNode
+        for (uint32_t i = 0; i < WorldGraphNodeCount; ++i)
+        {
+            const double nodeStartMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+
+            ExecuteNode(static_cast<WorldGraphNode>(i), data);
+
+            m_Frame.Nodes[i].StartMs = nodeStartMs;
+        }
+
+        m_Frame.ArenaBytes = 0;
+        for (const auto& arena : m_Arenas)
+        {
+            m_Frame.ArenaBytes += arena.GetAllocatedBytes();
+        }
+
+        m_Frame.TimeMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+
+        return m_Frame;
+    }
+
+    void WorldGraphEmulator::ExecuteNode(WorldGraphNode node, const WorkGraphCBData& data)
+    {
+        const auto startTime = std::chrono::high_resolution_clock::now();
+
+        const WorldGraphNodeInfo&       info    = GetWorldGraphNodeInfo(node);
+        const std::vector<const void*>& records = m_Frame.Records[static_cast<uint32_t>(node)];
+        WorldGraphNodeStats&            stats   = m_Frame.Nodes[static_cast<uint32_t>(node)];
+
+        stats.RecordCount = records.size();
+
+        GraphContext graph = {data, m_Desc.Quality, m_Desc.pTerrainClipmap, m_Desc.pMetadataCache, m_Desc.SplitSplines};
+        graph.Planes                    = ComputeClipPlanes(data.ViewProjection);
+        graph.DenseGrassMaxDistance     = m_Desc.Quality.DenseGrassMaxDistance * saturate(data.DenseGrassDistanceScale);
+        graph.SparseGrassMaxDistance    = m_Desc.Quality.SparseGrassMaxDistance * saturate(data.SparseGrassDistanceScale);
+        graph.FlowerMaxDistance         = m_Desc.Quality.FlowerMaxDistance * saturate(data.FlowerDistanceScale);
+        graph.FlowerSparseStartDistance = std::min(100.f, graph.FlowerMaxDistance);
+        graph.MushroomMaxDistance       = graph.DenseGrassMaxDistance;
+        graph.ButterflyMaxDistance      = ButterflyMaxDistanceLimit * saturate(data.InsectDistanceScale);
+        graph.BeeMaxDistance            = BeeMaxDistanceLimit * saturate(data.InsectDistanceScale);
+        graph.GrassBladeDensity         = saturate(data.GrassBladeDensityScale);
+
+        // Thread groups launched by the input records
+        m_Launches.clear();
+        switch (info.Launch)
+        {
+        case WorldGraphLaunch::Thread:
+            // one thread per record, each thread is emulated as a group
+            for (size_t i = 0; i < records.size(); ++i)
+            {
+                m_Launches.push_back({&records[i], 1, uint2(0, 0)});
+            }
+            stats.GroupCount = records.size();
+            break;
+        case WorldGraphLaunch::Broadcasting:
+            for (size_t i = 0; i < records.size(); ++i)
+            {
+                // the biome & detailed tiles use a fixed dispatch grid of a single group
+                const uint2 grid = (node == WorldGraphNode::ChunkGrid) ? static_cast<const ChunkGridRecord*>(records[i])->grid : uint2(1, 1);
+
+                for (uint32_t y = 0; y < grid.y; ++y)
+                {
+                    for (uint32_t x = 0; x < grid.x; ++x)
+                    {
+                        m_Launches.push_back({&records[i], 1, uint2(x, y)});
+                    }
+                }
+            }
+            stats.GroupCount = m_Launches.size();
+            break;
+        case WorldGraphLaunch::Coalescing:
+            for (size_t i = 0; i < records.size(); i += maxSplinesPerRecord)
+            {
+                m_Launches.push_back({&records[i], static_cast<uint32_t>(std::min<size_t>(maxSplinesPerRecord, records.size() - i)), uint2(0, 0)});
+            }
+            stats.GroupCount = m_Launches.size();
+            break;
+        case WorldGraphLaunch::Mesh:
+            // dispatch grid is the first member of all mesh node records
+            for (const void* pRecord : records)
+            {
+                const uint3&   grid       = *static_cast<const uint3*>(pRecord);
+                const uint32_t entryCount = GetMeshRecordEntryCount(node, pRecord);
+
+                stats.GroupCount += static_cast<uint64_t>(grid.x) * grid.y * grid.z;
+                stats.EntryCount += entryCount;
+                stats.MaxEntryCount = std::max(stats.MaxEntryCount, entryCount);
+            }
+
+            if (m_Desc.CountMeshOutputs)
+            {
+                m_MeshOutputCounts.resize(records.size());
+
+                m_pScheduler->Run(records.size(), [&](uint32_t, size_t recordIndex) {
+                    m_MeshOutputCounts[recordIndex] = GetMeshOutputCounts(graph, node, records[recordIndex]);
+                });
+
+                for (const uint2& counts : m_MeshOutputCounts)
+                {
+                    stats.VertexCount += counts.x;
+                    stats.PrimitiveCount += counts.y;
+                }
+
+                stats.TimeMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+            }
+            return;
+        }
+
+        if (m_GroupOutputs.size() < m_Launches.size())
+        {
+            m_GroupOutputs.resize(m_Launches.size());
+        }
+
+        // Cache misses are computed in one batch before the groups are launched, the groups only read the cache
+        if ((node == WorldGraphNode::MountainTile) && m_Desc.pMetadataCache)
+        {
+            m_MountainTiles.clear();
+            for (const void* pRecord : records)
+            {
+                m_MountainTiles.push_back(static_cast<const TileRecord*>(pRecord)->position);
+            }
+
+            m_Desc.pMetadataCache->RequestMountainTileFeatures(m_MountainTiles);
+        }
+
+        const NodeFunction function = NodeFunctions[static_cast<uint32_t>(node)];
+
+        m_pScheduler->Run(m_Launches.size(), [&](uint32_t worker, size_t groupIndex) {
+            const GroupLaunch& launch  = m_Launches[groupIndex];
+            auto&              outputs = m_GroupOutputs[groupIndex];
+
+            outputs.clear();
+
+            GroupContext group = {graph, launch.ppRecords, launch.RecordCount, launch.GroupId, m_Arenas[worker], outputs};
+            function(group);
+        });
+
+        // Gather outputs in group order
+        for (size_t i = 0; i < m_Launches.size(); ++i)
+        {
+            for (const auto& output : m_GroupOutputs[i])
+            {
+                m_Frame.Records[static_cast<uint32_t>(output.first)].push_back(output.second);
+            }
+        }
+
+        stats.TimeMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+    }
+
+    static_assert(generationNodeCount == WorldGraphNodeCount, "generation counter nodes must match WorldGraphNode");
+
+    void GetGenerationCounters(const WorldGraphFrame& frame, uint32_t* pCounters)
+    {
+        // the UAV counters are 32 bit, saturate instead of wrapping around
+        const auto saturateCounter = [](uint64_t value) { return static_cast<uint32_t>(std::min<uint64_t>(value, UINT32_MAX)); };
+
+        for (uint32_t node = 0; node < generationNodeCount; ++node)
+        {
+            const WorldGraphNodeStats& stats = frame.Nodes[node];
+
+            pCounters[GetGenerationCounterIndex(node, generationCounterRecords)]    = saturateCounter(stats.RecordCount);
+            pCounters[GetGenerationCounterIndex(node, generationCounterGroups)]     = saturateCounter(stats.GroupCount);
+            pCounters[GetGenerationCounterIndex(node, generationCounterVertices)]   = saturateCounter(stats.VertexCount);
+            pCounters[GetGenerationCounterIndex(node, generationCounterPrimitives)] = saturateCounter(stats.PrimitiveCount);
+            pCounters[GetGenerationCounterIndex(node, generationCounterEntries)]    = saturateCounter(stats.EntryCount);
+            pCounters[GetGenerationCounterIndex(node, generationCounterMaxEntries)] = stats.MaxEntryCount;
+        }
+    }
+
+    const WorldGraphFrame& WorldGraphEmulator::GetFrame() const
+    {
+        return m_Frame;
+    }
+
+    uint32_t WorldGraphEmulator::GetThreadCount() const
+    {
+        return m_pScheduler->GetWorkerCount();
+    }
+}  // namespace meshnode
@@ -0,0 +1,403 @@
+// This file is part of the AMD Work Graph Mesh Node Sample.
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#pragma once
+
+#include "generationcounters.h"
+#include "hlslmath.h"
+#include "workgraphcommon.h"
+#include "workgraphrecords.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// CPU emulator of the world generation work graph, e.g. for profiling & regression testing without a GPU supporting work graphs.
+// Executes World -> ChunkGrid -> Tile[3] -> DetailedTile -> GenerateTree[2] & GenerateRock and collects the records sent to the mesh nodes.
+// Alternatively, the graph is entered at the Chunk node with the visible chunks computed by ChunkCuller, see chunkculling.h.
+// The node functions mirror world.hlsl, biomes.hlsl, tree.hlsl & rock.hlsl; changes to the shaders must be mirrored in worldgraph.cpp.
+namespace meshnode
+{
+    class TerrainClipmap;
+    class ChunkMetadataCache;
+
+    // Work graph constant buffer (WorkGraphCBData) & record structs (ChunkRecord, DrawSplineRecord, ...) are shared with the shaders,
+    // see shaders/workgraphcommon.h & shaders/workgraphrecords.h.
+
+    // ===================================
+    // Work graph nodes
+
+    enum class WorldGraphNode : uint32_t
+    {
+        World,
+        ChunkGrid,
+        // entry node for CPU culled chunks, see ChunkCuller
+        Chunk,
+        MountainTile,
+        WoodlandTile,
+        GrasslandTile,
+        DetailedTile,
+        GenerateOakTree,
+        GeneratePineTree,
+        GenerateRock,
+        // mesh nodes, records are collected but not executed
+        DrawTerrainChunk,
+        DrawSpline,
+        DrawSparseGrassPatch,
+        DrawDenseGrassPatch,
+        DrawMushroomPatch,
+        DrawFlowerPatch,
+        DrawSparseFlowerPatch,
+        DrawBees,
+        DrawButterflies,
+        Count,
+    };
+
+    static const uint32_t WorldGraphNodeCount = static_cast<uint32_t>(WorldGraphNode::Count);
+
+    enum class WorldGraphLaunch
+    {
+        // one thread per record
+        Thread,
+        // dispatch grid of thread groups per record
+        Broadcasting,
+        // one thread group for up to MaxInputRecords records
+        Coalescing,
+        // mesh node, broadcasting launch of the dispatch grid in the record
+        Mesh,
+    };
+
+    struct WorldGraphNodeInfo
+    {
+        // shader function name
+        const char* Name;
+        // node id in the work graph, e.g. Tile[0]
+        const char*      NodeId;
+        WorldGraphLaunch Launch;
+        size_t           RecordSize;
+        // NodeMaxInputRecordsPerGraphEntryRecord of mesh nodes, 0 if not declared.
+        // The limit is shared across the node array, i.e. DrawFlowerPatch[0] & [1] share 200 records.
+        uint32_t MaxInputRecords;
+    };
+
+    const WorldGraphNodeInfo& GetWorldGraphNodeInfo(WorldGraphNode node);
+
+    /**
+     * Output declaration of a node, i.e. [MaxRecords(...)] [NodeId(...)] NodeOutput<Record> in the shaders.
+     * MaxRecords is per thread group of the producer & shared across output arrays, e.g. the Tile[3] output of ChunkGrid.
+     */
+    struct WorldGraphOutputInfo
+    {
+        WorldGraphNode Producer;
+        // node id of the output, e.g. Tile for Tile[0..2]
+        const char* NodeId;
+        const char* RecordName;
+        size_t      RecordSize;
+        uint32_t    MaxRecords;
+    };
+
+    static const uint32_t WorldGraphOutputCount = 20;
+
+    const WorldGraphOutputInfo& GetWorldGraphOutputInfo(uint32_t index);
+
+    /**
+     * Distance limits & grass blade count of a quality tier, see common.hlsl. Defaults are the "High" tier.
+     * Except for WorldGridMaxDistance, these are upper limits scaled by the geometry budget of WorkGraphCBData, see geometrybudget.h.
+     */
+    struct WorldGraphQuality
+    {
+        float    WorldGridMaxDistance   = 2000.f;
+        float    DenseGrassMaxDistance  = 80.f;
+        float    SparseGrassMaxDistance = 250.f;
+        float    FlowerMaxDistance      = 300.f;
+        uint32_t MaxNumGrassBlades      = 32;
+    };
+
+    // ===================================
+    // Chunk grid, see world.hlsl. Shared by the World & ChunkGrid nodes and ChunkCuller.
+
+    // World-space size of a terrain chunk, see chunkSize in common.hlsl
+    static const float TerrainChunkSize = 256.f;
+    // Height range of the chunk & tile bounding boxes
+    static const float TerrainChunkMinHeight = -100.f;
+    static const float TerrainChunkMaxHeight = 300.f;
+    // Maximum chunk grid size in each dimension, same as NodeMaxDispatchGrid of ChunkGrid
+    static const uint32_t MaxChunkGridSize = 32;
+    // Tiles per chunk & detailed tiles per tile in each dimension, see tilesPerChunk & detailedTilesPerTile in common.hlsl
+    static const uint32_t TerrainTilesPerChunk        = 8;
+    static const uint32_t TerrainDetailedTilesPerTile = 8;
+    // Radius of the curved world, see earthRadius in common.hlsl
+    static const float EarthRadius = 6000.f;
+    // Tile biome of ChunkRecord::tileBiomes for tiles culled on the CPU, i.e. outside of the view frustum with their height bounds or hidden
+    // behind the terrain, see ChunkCuller & HorizonCuller. No tile record is output for such tiles.
+    static const uint32_t ChunkTileCulled = 3;
+    // Height of the tallest content above the terrain (trees) & error of the sampled terrain height bounds of ChunkMetadataCache
+    static const float TerrainContentHeight      = 40.f;
+    static const float TerrainHeightBoundsMargin = 4.f;
+    // Height range of detailed tile bounding boxes relative to the terrain height at the detailed tile center, see
+    // detailedTileMinHeightOffset in common.hlsl. Covers terrain gradients up to 7 & grass or flowers on top.
+    static const float DetailedTileMinHeightOffset = -20.f;
+    static const float DetailedTileMaxHeightOffset = 22.f;
+
+    /**
+     * View frustum planes, xyz = normal pointing inside, w = distance.
+     */
+    struct ClipPlanes
+    {
+        float4 Planes[6];
+    };
+
+    /**
+     * @brief   Extract & normalize the frustum planes of a view projection matrix, same as ComputeClipPlanes in utils.hlsl.
+     */
+    ClipPlanes ComputeClipPlanes(const float4x4& viewProjection);
+
+    /**
+     * @brief   Scale of the terrain height at a horizontal distance from the camera, heights fade out between 1000 & 2000 m.
+     */
+    float GetCurvedWorldHeightScale(float distanceToCamera);
+
+    /**
+     * @brief   Project a position onto the curved world centered at the camera, same as GetCurvedWorldSpacePosition in common.hlsl.
+     *          The position is moved along the normal of the sphere with radius EarthRadius below the camera, i.e. keeps its azimuth.
+     */
+    float3 GetCurvedWorldSpacePosition(const float3& cameraPosition, const float3& worldSpacePosition);
+
+    /**
+     * @brief   Grid of chunks covering the view frustum up to the world grid distance, same as the World node.
+     */
+    ChunkGridRecord ComputeChunkGrid(const WorkGraphCBData& data, const WorldGraphQuality& quality);
+
+    /**
+     * @brief   World-space xz position of the chunk center, at which the terrain height for the level of detail is sampled.
+     */
+    float2 GetTerrainChunkCenter(const int2& chunkGridPosition);
+
+    /**
+     * @brief   Terrain level of detail of a chunk, same as GetTerrainChunkLevelOfDetail in world.hlsl.
+     *          chunkCenterPosition is the terrain position at GetTerrainChunkCenter.
+     */
+    int32_t GetTerrainChunkLevelOfDetail(const float3& cameraPosition, const float3& chunkCenterPosition);
+
+    /**
+     * @brief   World-space xz position of the tile center, at which the dominant biome is sampled.
+     */
+    float2 GetTerrainTileCenter(const int2& tileGridPosition);
+
+    /**
+     * @brief   World-space xz position of the center of a detailed tile, detailedTileIndex is the row-major index within the tile.
+     */
+    float2 GetTerrainDetailedTileCenter(const int2& tileGridPosition, uint32_t detailedTileIndex);
+
+    /**
+     * @brief   World-space xz position of the minimum corner of a detailed tile, at which MountainTile tests the slope for rocks.
+     */
+    float2 GetTerrainDetailedTileCorner(const int2& tileGridPosition, uint32_t detailedTileIndex);
+
+    /**
+     * @brief   Biome tile launched for the biome weights at the tile center, 0 = mountain, 1 = woodland, 2 = grassland.
+     *          ChunkTileCulled is only set by the CPU culling.
+     */
+    uint32_t GetDominantBiome(const float3& biomeWeights);
+
+    /**
+     * @brief   Tile biome packed into ChunkRecord::tileBiomes, tileIndex is the row-major tile index within the chunk.
+     */
+    uint32_t GetChunkTileBiome(const uint4& tileBiomes, uint32_t tileIndex);
+    void     SetChunkTileBiome(uint4& tileBiomes, uint32_t tileIndex, uint32_t biome);
+
+    /**
+     * Tree cluster & rocks of a mountain tile, see MountainTile in biomes.hlsl.
+     * Only depends on the terrain below the tile, i.e. does not change from frame to frame.
+     */
+    struct MountainTileFeatures
+    {
+        // pine trees around the tile center
+        uint32_t TreeCount = 0;
+        // bit i is set if detailed tile i (row-major) places a rock at its center
+        uint64_t RockMask = 0;
+    };
+
+    /**
+     * @brief   Tree cluster & rocks of a mountain tile from the terrain height at the tile center, the heights at the centers
+     *          and the normal y components at the corners of its detailed tiles, in row-major order.
+     */
+    MountainTileFeatures ComputeMountainTileFeatures(const int2&  tileGridPosition,
+                                                     float        tileCenterHeight,
+                                                     const float* detailedTileCenterHeights,
+                                                     const float* detailedTileCornerNormalsY);
+
+    struct WorldGraphDesc
+    {
+        WorldGraphQuality Quality;
+        // worker threads, 0 = one per hardware thread. The calling thread is one of the workers.
+        uint32_t ThreadCount = 0;
+        // terrain queries sample this clipmap like the shaders, nullptr uses the analytic terrain functions
+        const TerrainClipmap* pTerrainClipmap = nullptr;
+        // mountain tiles read their tree clusters & rocks from this cache instead of sampling the terrain, nullptr disables caching.
+        // The cache holds values of the analytic terrain functions, see chunkmetadata.h.
+        ChunkMetadataCache* pMetadataCache = nullptr;
+        // splines exceeding the output limits of the spline mesh node are split into several pieces, see shaders/splinesplitting.h.
+        // false writes every spline as a single piece, which the mesh shader clamps, to compare against the generators before splitting.
+        bool SplitSplines = true;
+        // evaluate the output counts of the mesh node groups like the mesh shaders, see WorldGraphNodeStats::VertexCount.
+        // Costs a terrain height sample per flower patch.
+        bool CountMeshOutputs = false;
+    };
+
+    /**
+     * Camera for CreateWorkGraphCBData. Yaw & pitch are defined as in MeshNodeSampleCameraComponent.
+     */
+    struct WorldGraphCamera
+    {
+        float3 Position = float3(120.65f, 24.44f, -15.74f);
+        float  Yaw      = 2.944f;
+        float  Pitch    = 0.f;
+        // defaults of the sample camera at 16:9
+        float AspectRatio = 16.f / 9.f;
+        float Yfov        = 1.5707963f / (16.f / 9.f);
+        float Near        = 0.5f;
+        float Far         = 2000.f;
+    };
+
+    /**
+     * @brief   Work graph constants for a camera, equivalent to the constants set up by the sample without jitter.
+     *          The previous frame values are set to the current camera.
+     */
+    WorkGraphCBData CreateWorkGraphCBData(const WorldGraphCamera& camera);
+
+    /**
+     * Bump allocator for the records of a frame. Blocks are kept across frames, such that steady state frames do not allocate.
+     */
+    class RecordArena
+    {
+    public:
+        explicit RecordArena(size_t blockSize = 1 << 20);
+
+        // size must not exceed the block size
+        void* Allocate(size_t size);
+        void  Reset();
+
+        // bytes allocated since the last reset
+        size_t GetAllocatedBytes() const;
+        size_t GetCapacity() const;
+
+    private:
+        std::vector<std::unique_ptr<uint8_t[]>> m_Blocks;
+        size_t                                  m_BlockSize      = 0;
+        size_t                                  m_BlockIndex     = 0;
+        size_t                                  m_BlockOffset    = 0;
+        size_t                                  m_AllocatedBytes = 0;
+    };
+
+    struct WorldGraphNodeStats
+    {
+        uint64_t RecordCount = 0;
+        // launched thread groups, i.e. the dispatch grid sizes for broadcasting & mesh nodes
+        uint64_t GroupCount = 0;
+        // mesh nodes: vertices & primitives of all groups as set by SetMeshOutputCounts, only counted with WorldGraphDesc::CountMeshOutputs
+        uint64_t VertexCount    = 0;
+        uint64_t PrimitiveCount = 0;
+        // mesh nodes: sum & maximum of the used entries of the record arrays, see GetGenerationRecordCapacity
+        uint64_t EntryCount    = 0;
+        uint32_t MaxEntryCount = 0;
+        // start of the node relative to the start of WorldGraphEmulator::Execute
+        double StartMs = 0.0;
+        double TimeMs  = 0.0;
+    };
+
+    /**
+     * Records & statistics of a frame, valid until the next WorldGraphEmulator::Execute.
+     */
+    struct WorldGraphFrame
+    {
+        // input records of every node, in a deterministic order independent of the worker count.
+        // Records are cast to the record struct of the node, see WorldGraphNodeInfo::RecordSize.
+        std::vector<const void*> Records[WorldGraphNodeCount];
+        WorldGraphNodeStats      Nodes[WorldGraphNodeCount];
+        // record memory used by the frame
+        size_t ArenaBytes = 0;
+        double TimeMs     = 0.0;
+    };
+
+    /**
+     * @brief   Write the node statistics of a frame in the layout of the GenerationCounters UAV of the sample, see shaders/generationcounters.h,
+     *          such that headless runs report the same counters. pCounters holds generationCounterBufferSize values.
+     */
+    void GetGenerationCounters(const WorldGraphFrame& frame, uint32_t* pCounters);
+
+    class WorkStealingScheduler;
+
+    /**
+     * Executes the world generation work graph on the CPU.
+     * Nodes are executed in topological order, which is one of the schedules allowed for a work graph.
+     * The thread groups of a node are distributed across the workers with work stealing. Each group writes its outputs to a record arena
+     * owned by the executing worker; the outputs are then gathered in group order, such that the records do not depend on the scheduling.
+     * Coalescing nodes receive batches of up to maxSplinesPerRecord records in this order.
+     */
+    class WorldGraphEmulator
+    {
+    public:
+        explicit WorldGraphEmulator(const WorldGraphDesc& desc);
+        ~WorldGraphEmulator();
+
+        /**
+         * @brief   Execute the graph with one entry record for the World node.
+         */
+        const WorldGraphFrame& Execute(const WorkGraphCBData& data);
+        /**
+         * @brief   Execute the graph with one entry record per chunk for the Chunk node, e.g. the visible chunks of ChunkCuller.
+         *          Produces the same mesh node records as the World node for the same chunks.
+         */
+        const WorldGraphFrame& Execute(const WorkGraphCBData& data, const std::vector<ChunkRecord>& chunks);
+
+        const WorldGraphFrame& GetFrame() const;
+        uint32_t               GetThreadCount() const;
+
+    private:
+        struct GroupLaunch
+        {
+            const void* const* ppRecords;
+            uint32_t           RecordCount;
+            uint2              GroupId;
+        };
+
+        void                   ResetFrame();
+        const WorldGraphFrame& ExecuteNodes(const WorkGraphCBData& data, std::chrono::high_resolution_clock::time_point startTime);
+        void                   ExecuteNode(WorldGraphNode node, const WorkGraphCBData& data);
+
+        WorldGraphDesc                         m_Desc;
+        std::unique_ptr<WorkStealingScheduler> m_pScheduler;
+        // one arena per worker
+        std::vector<RecordArena> m_Arenas;
+        std::vector<GroupLaunch> m_Launches;
+        // records written by each group, in emission order
+        std::vector<std::vector<std::pair<WorldGraphNode, const void*>>> m_GroupOutputs;
+        // tile positions of the mountain tile records, requested from the metadata cache before the node is executed
+        std::vector<int2>  m_MountainTiles;
+        // vertex & primitive counts of each mesh node record, with WorldGraphDesc::CountMeshOutputs
+        std::vector<uint2> m_MeshOutputCounts;
+        WorldGraphFrame    m_Frame;
+    };
+}  // namespace meshnode
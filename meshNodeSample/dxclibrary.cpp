@@ -0,0 +1,82 @@
+// This file is part of the AMD Work Graph Mesh Node Sample.
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include "dxclibrary.h"
+
+#ifndef _WIN32
+#include <dlfcn.h>
+
+#include <cstdlib>
+#endif  // _WIN32
+
+DxcLibrary::DxcLibrary()
+{
+#ifdef _WIN32
+    // dxil.dll is optional, DXC uses it for signing DXIL if present
+    m_pSigningModule = LoadLibraryW(L"dxil.dll");
+    m_pModule        = LoadLibraryW(L"dxcompiler.dll");
+
+    if (m_pModule == nullptr)
+    {
+        m_ErrorString = L"Failed to load dxcompiler.dll";
+        return;
+    }
+
+    m_pfnDxcCreateInstance = reinterpret_cast<DxcCreateInstanceProc>(GetProcAddress(static_cast<HMODULE>(m_pModule), "DxcCreateInstance"));
+#else
+    const char* libraryPath = std::getenv("DXC_LIBRARY_PATH");
+    if ((libraryPath == nullptr) || (libraryPath[0] == 0))
+    {
+        libraryPath = "libdxcompiler.so";
+    }
+
+    m_pModule = dlopen(libraryPath, RTLD_NOW | RTLD_LOCAL);
+
+    if (m_pModule == nullptr)
+    {
+        const std::string error = dlerror();
+        m_ErrorString           = L"Failed to load " + std::wstring(error.begin(), error.end());
+        return;
+    }
+
+    m_pfnDxcCreateInstance = reinterpret_cast<DxcCreateInstanceProc>(dlsym(m_pModule, "DxcCreateInstance"));
+#endif  // _WIN32
+
+    if (m_pfnDxcCreateInstance == nullptr)
+    {
+        m_ErrorString = L"Failed to load DxcCreateInstance from DXC library";
+    }
+}
+
+DxcLibrary::~DxcLibrary()
+{
+    // DXC objects may still be released during static destruction, thus the library is intentionally never unloaded
+}
+
+DxcCreateInstanceProc DxcLibrary::GetCreateInstanceProc(std::wstring& errorString)
+{
+    // thread-safe initialization on first use
+    static DxcLibrary library;
+
+    errorString = library.m_ErrorString;
+    return library.m_pfnDxcCreateInstance;
+}
@@ -0,0 +1,60 @@
+// This file is part of the AMD Work Graph Mesh Node Sample.
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#pragma once
+
+#include <string>
+
+#ifdef _WIN32
+// windows headers
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+// for BSTR typedef
+#include <dxgi.h>
+#endif  // _WIN32
+
+// DXC header
+// On non-Windows platforms, dxcapi.h provides the required COM types through WinAdapter.h
+#include <dxcapi.h>
+
+/**
+ * Loads the DXC shared library once per process.
+ * Uses dxcompiler.dll (and dxil.dll for signing) on Windows and libdxcompiler.so on Linux.
+ * On Linux, the library path can be overridden with the DXC_LIBRARY_PATH environment variable.
+ */
+class DxcLibrary
+{
+public:
+    /**
+     * @brief   Get DxcCreateInstance entry point. Returns nullptr and the reason in errorString if DXC could not be loaded.
+     */
+    static DxcCreateInstanceProc GetCreateInstanceProc(std::wstring& errorString);
+
+private:
+    DxcLibrary();
+    ~DxcLibrary();
+
+    void*                 m_pModule              = nullptr;
+    void*                 m_pSigningModule       = nullptr;
+    DxcCreateInstanceProc m_pfnDxcCreateInstance = nullptr;
+    std::wstring          m_ErrorString;
+};
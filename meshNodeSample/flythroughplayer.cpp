@@ -0,0 +1,219 @@
+// This file is part of the AMD Work Graph Mesh Node Sample.
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include "flythroughplayer.h"
+
+#include "core/framework.h"
+#include "core/scene.h"
+#include "misc/assert.h"
+#include "misc/log.h"
+
+// camera the flythrough is applied to
+#include "samplecameracomponent.h"
+
+#include <filesystem>
+#include <fstream>
+
+using namespace cauldron;
+
+FlythroughPlayer::FlythroughPlayer(const std::wstring& recordingPath, const std::wstring& statsPath)
+    : m_RecordingPath(recordingPath)
+    , m_StatsPath(statsPath)
+{
+}
+
+FlythroughPlayer::~FlythroughPlayer()
+{
+    // Save flythrough recording
+    if ((m_Mode == Mode::Record) && !m_Frames.empty())
+    {
+        if (meshnode::SaveFlythrough(m_RecordingPath, m_Frames))
+        {
+            Log::Write(LOGLEVEL_INFO, L"Recorded %zu flythrough frames to %ls", m_Frames.size(), m_RecordingPath.c_str());
+        }
+        else
+        {
+            CauldronWarning(L"Failed to save flythrough recording to %ls", m_RecordingPath.c_str());
+        }
+    }
+    MeshNodeSampleCameraComponent::SetFlythroughCallback(nullptr);
+
+    if (m_pStats)
+        delete m_pStats;
+}
+
+void FlythroughPlayer::StartRecording()
+{
+    m_Mode = Mode::Record;
+
+    Log::Write(LOGLEVEL_INFO, L"Recording flythrough to %ls", m_RecordingPath.c_str());
+}
+
+bool FlythroughPlayer::StartPlayback(const std::string& keyFramePath)
+{
+    if (!keyFramePath.empty())
+    {
+        // { "TimeStep": 0.0166667, "Keys": [ { "Time": 0.0, "Position": [x, y, z], "Yaw": 2.944, "Pitch": 0.0, "WindStrength": 1.0, "WindDirection": 0.0 }, ... ] }
+        std::ifstream file(keyFramePath);
+        const json    path = json::parse(file, nullptr, false);
+
+        if (path.is_discarded() || (path.find("Keys") == path.end()))
+        {
+            CauldronWarning(L"Failed to load flythrough path %hs, flythrough playback disabled.", keyFramePath.c_str());
+            return false;
+        }
+
+        std::vector<meshnode::FlythroughKey> keys;
+        for (const json& keyData : path["Keys"])
+        {
+            meshnode::FlythroughKey key = {};
+            key.Time                    = keyData.value("Time", key.Time);
+            key.Yaw                     = keyData.value("Yaw", key.Yaw);
+            key.Pitch                   = keyData.value("Pitch", key.Pitch);
+            key.WindStrength            = keyData.value("WindStrength", key.WindStrength);
+            key.WindDirection           = keyData.value("WindDirection", key.WindDirection);
+
+            if ((keyData.find("Position") != keyData.end()) && (keyData["Position"].size() == 3))
+            {
+                key.Position = meshnode::float3(keyData["Position"][0].get<float>(), keyData["Position"][1].get<float>(), keyData["Position"][2].get<float>());
+            }
+
+            keys.push_back(key);
+        }
+
+        m_Frames         = meshnode::SampleFlythroughPath(keys, path.value("TimeStep", 1.f / 60.f));
+        m_PlaybackSource = keyFramePath;
+    }
+    else if (meshnode::LoadFlythrough(m_RecordingPath, m_Frames))
+    {
+        m_PlaybackSource = std::filesystem::path(m_RecordingPath).string();
+    }
+    else
+    {
+        CauldronWarning(L"Failed to load flythrough recording %ls, flythrough playback disabled.", m_RecordingPath.c_str());
+        return false;
+    }
+
+    if (m_Frames.empty())
+    {
+        return false;
+    }
+
+    m_Mode   = Mode::Playback;
+    m_pStats = new meshnode::FlythroughStats({"Frame",
+                                              "Time",
+                                              "DeltaTime",
+                                              "FrameTimeMs",
+                                              "ExecuteMs",
+                                              "TerrainClipmapMs",
+                                              "ChunkCullingMs",
+                                              "VisibleChunks",
+                                              "BoundsCulledChunks",
+                                              "OccludedChunks",
+                                              "MetadataCacheHitRate",
+                                              "WorkGraphGpuMs",
+                                              "GeometryBudgetLevel",
+                                              "GeneratedVertices",
+                                              "GeneratedPrimitives"});
+
+    // The camera applies one frame per update, Execute uses the time step & wind settings of the frame last applied
+    MeshNodeSampleCameraComponent::SetFlythroughCallback([this](meshnode::FlythroughFrame& frame) {
+        if ((m_Mode != Mode::Playback) || (m_FrameIndex >= m_Frames.size()))
+        {
+            return false;
+        }
+
+        frame = m_Frames[m_FrameIndex++];
+        return true;
+    });
+
+    Log::Write(LOGLEVEL_INFO, L"Playing back flythrough with %zu frames", m_Frames.size());
+    return true;
+}
+
+void FlythroughPlayer::Update(double deltaTime, float windStrength, float windDirection, const FlythroughFrameStats& stats)
+{
+    const auto   currentTime = std::chrono::high_resolution_clock::now();
+    const double frameTimeMs =
+        (m_LastFrameTime.time_since_epoch().count() != 0) ? std::chrono::duration<double, std::milli>(currentTime - m_LastFrameTime).count() : 0.0;
+
+    m_LastFrameTime = currentTime;
+
+    if (m_Mode == Mode::Record)
+    {
+        const auto* pCamera = static_cast<const MeshNodeSampleCameraComponent*>(GetScene()->GetCurrentCamera());
+        const Vec4  eyePos  = pCamera->GetCameraTranslation();
+
+        meshnode::FlythroughFrame frame = {};
+        frame.Position                  = meshnode::float3(eyePos.getX(), eyePos.getY(), eyePos.getZ());
+        frame.Yaw                       = pCamera->GetYaw();
+        frame.Pitch                     = pCamera->GetPitch();
+        frame.WindStrength              = windStrength;
+        frame.WindDirection             = windDirection;
+        frame.DeltaTime                 = static_cast<float>(deltaTime);
+
+        m_Frames.push_back(frame);
+    }
+
+    // Frames are reported once they have been applied to the camera
+    if ((m_Mode != Mode::Playback) || (m_FrameIndex == 0))
+    {
+        return;
+    }
+
+    m_pStats->AddFrame({static_cast<double>(m_FrameIndex - 1),
+                        m_Time,
+                        deltaTime,
+                        frameTimeMs,
+                        stats.ExecuteTimeMs,
+                        stats.TerrainClipmapTimeMs,
+                        stats.ChunkCullingTimeMs,
+                        static_cast<double>(stats.VisibleChunkCount),
+                        static_cast<double>(stats.BoundsCulledChunkCount),
+                        static_cast<double>(stats.OccludedChunkCount),
+                        stats.MetadataCacheHitRate,
+                        stats.WorkGraphGpuTimeMs,
+                        stats.GeometryBudgetLevel,
+                        static_cast<double>(stats.GenerationCounters.Vertices),
+                        static_cast<double>(stats.GenerationCounters.Primitives)});
+    m_Time += deltaTime;
+
+    if (m_FrameIndex == m_Frames.size())
+    {
+        if (m_pStats->Write(m_StatsPath))
+        {
+            Log::Write(LOGLEVEL_INFO,
+                       L"Flythrough finished, %zu frames with %.3f ms average frame time. Statistics written to %ls",
+                       m_pStats->GetFrameCount(),
+                       m_pStats->GetAverage(3),
+                       m_StatsPath.c_str());
+        }
+        else
+        {
+            CauldronWarning(L"Failed to write flythrough statistics to %ls", m_StatsPath.c_str());
+        }
+
+        // Return camera to user input
+        m_Mode = Mode::Off;
+        MeshNodeSampleCameraComponent::SetFlythroughCallback(nullptr);
+    }
+}
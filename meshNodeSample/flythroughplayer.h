@@ -0,0 +1,107 @@
+// This file is part of the AMD Work Graph Mesh Node Sample.
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#pragma once
+
+// generation counter totals reported in the statistics
+#include "generationcounterreadback.h"
+
+// CPU flythrough frames & statistics
+#include "flythrough.h"
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Times & counts of a rendered frame, added to the flythrough statistics during playback.
+ */
+struct FlythroughFrameStats
+{
+    double   ExecuteTimeMs          = 0.0;
+    double   TerrainClipmapTimeMs   = 0.0;
+    double   ChunkCullingTimeMs     = 0.0;
+    uint32_t VisibleChunkCount      = 0;
+    uint32_t BoundsCulledChunkCount = 0;
+    uint32_t OccludedChunkCount     = 0;
+    double   MetadataCacheHitRate   = 0.0;
+    double   WorkGraphGpuTimeMs     = 0.0;
+    double   GeometryBudgetLevel    = 1.0;
+
+    GenerationCounterTotals GenerationCounters;
+};
+
+/**
+ * Flythrough recording & playback, see meshNodeCpu/flythrough.h.
+ * During playback, frames are applied to the camera by MeshNodeSampleCameraComponent & the statistics of every frame are written once
+ * the last frame was rendered. Recordings are saved when the player is destroyed.
+ */
+class FlythroughPlayer
+{
+public:
+    FlythroughPlayer(const std::wstring& recordingPath, const std::wstring& statsPath);
+    ~FlythroughPlayer();
+
+    /**
+     * @brief   Record the camera pose, wind settings & time step of every frame to the recording.
+     */
+    void StartRecording();
+    /**
+     * @brief   Play back the key frame path if keyFramePath is set, the recording otherwise.
+     *          Returns false if the flythrough could not be loaded or has no frames.
+     */
+    bool StartPlayback(const std::string& keyFramePath);
+
+    /**
+     * @brief   Record the frame, or add the frame last applied to the camera to the playback statistics.
+     *          Writes the statistics & returns the camera to user input once the playback is finished.
+     */
+    void Update(double deltaTime, float windStrength, float windDirection, const FlythroughFrameStats& stats);
+
+    bool IsRecording() const { return m_Mode == Mode::Record; }
+    bool IsPlaying() const { return m_Mode == Mode::Playback; }
+    // frames applied to the camera since the playback started
+    size_t GetPlaybackFrameCount() const { return m_FrameIndex; }
+    // frame last applied to the camera, nullptr if not playing or no frame was applied yet
+    const meshnode::FlythroughFrame* GetPlaybackFrame() const { return (IsPlaying() && (m_FrameIndex > 0)) ? &m_Frames[m_FrameIndex - 1] : nullptr; }
+    // key frame path or recording played back
+    const std::string& GetPlaybackSource() const { return m_PlaybackSource; }
+
+private:
+    enum class Mode
+    {
+        Off,
+        Record,
+        Playback
+    };
+
+    Mode                                           m_Mode = Mode::Off;
+    std::wstring                                   m_RecordingPath;
+    std::wstring                                   m_StatsPath;
+    std::string                                    m_PlaybackSource;
+    std::vector<meshnode::FlythroughFrame>         m_Frames;
+    size_t                                         m_FrameIndex = 0;
+    double                                         m_Time       = 0.0;
+    meshnode::FlythroughStats*                     m_pStats     = nullptr;
+    std::chrono::high_resolution_clock::time_point m_LastFrameTime;
+};
@@ -0,0 +1,228 @@
+// This file is part of the AMD Work Graph Mesh Node Sample.
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include "frametracecapture.h"
+
+#include "core/framework.h"
+#include "core/uimanager.h"
+#include "misc/assert.h"
+#include "misc/log.h"
+#include "render/profiler.h"
+
+// flythrough frame played back
+#include "flythroughplayer.h"
+
+#include <algorithm>
+
+using namespace cauldron;
+
+FrameTraceCapture::FrameTraceCapture(const FrameTraceCaptureDesc& desc, const std::vector<std::pair<std::string, std::string>>& metadata)
+    : m_Writer(desc.BufferSize)
+    , m_Desc(desc)
+    , m_Metadata(metadata)
+    , m_Enabled(desc.Enabled)
+{
+    // frames stay pending until their markers are reported
+    const uint32_t maxLatency = static_cast<uint32_t>(m_PendingFrames.size()) - 1;
+    m_Desc.CpuMarkerLatency   = std::min(m_Desc.CpuMarkerLatency, maxLatency);
+    m_Desc.GpuMarkerLatency   = std::min(m_Desc.GpuMarkerLatency, maxLatency);
+
+    m_Metadata.push_back({"CpuMarkerLatencyFrames", std::to_string(m_Desc.CpuMarkerLatency)});
+    m_Metadata.push_back({"GpuMarkerLatencyFrames", std::to_string(m_Desc.GpuMarkerLatency)});
+
+    m_StartTime = std::chrono::high_resolution_clock::now();
+}
+
+void FrameTraceCapture::InitUI()
+{
+    // Unchecked once the frames of the capture are written
+    UISection section   = {};
+    section.SectionName = "Frame Trace";
+
+    section.AddCheckBox("Capture Frame Trace", &m_Enabled);
+
+    GetUIManager()->RegisterUIElements(section);
+}
+
+double FrameTraceCapture::GetTimeUs(std::chrono::high_resolution_clock::time_point time) const
+{
+    return std::chrono::duration<double, std::micro>(time - m_StartTime).count();
+}
+
+const FrameTraceCapture::PendingFrame* FrameTraceCapture::GetPendingFrame(uint32_t latency) const
+{
+    const uint64_t      renderFrame = m_RenderFrame - latency;
+    const PendingFrame& frame       = m_PendingFrames[renderFrame % m_PendingFrames.size()];
+
+    return (latency < m_RenderFrame) && (frame.RenderFrame == renderFrame) ? &frame : nullptr;
+}
+
+void FrameTraceCapture::Update(std::chrono::high_resolution_clock::time_point frameStartTime,
+                               const FlythroughPlayer*                        pFlythroughPlayer,
+                               const std::vector<meshnode::FrameTraceArg>&    args)
+{
+    const double frameStartUs = GetTimeUs(frameStartTime);
+
+    ++m_RenderFrame;
+
+    const bool flythroughPlaying = pFlythroughPlayer && pFlythroughPlayer->IsPlaying();
+
+    // Stop once all frames are captured, the flythrough ended or the capture was stopped in the UI.
+    // The trace stays open until the profiler reported the markers of the last captured frame, see AddEvents.
+    if (m_Writer.IsInFrame())
+    {
+        const bool framesCaptured     = (m_Desc.FrameCount > 0) && (m_Writer.GetStats().FrameCount + 1 >= m_Desc.FrameCount);
+        const bool flythroughFinished = m_Flythrough && !flythroughPlaying;
+
+        if (framesCaptured || flythroughFinished || !m_Enabled)
+        {
+            m_Writer.EndFrame(frameStartUs);
+
+            m_DrainFrameCount = std::max({m_Desc.CpuMarkerLatency, m_Desc.GpuMarkerLatency, 1u});
+            m_Enabled         = false;
+            return;
+        }
+    }
+    // Captures during flythrough playback wait for the first frame applied to the camera
+    else if (!m_Writer.IsOpen() && m_Enabled && !(flythroughPlaying && (pFlythroughPlayer->GetPlaybackFrameCount() == 0)))
+    {
+        // Numbered captures after the first one, e.g. frametrace_2.json
+        m_CapturePath = m_Desc.Path;
+        if (++m_CaptureCount > 1)
+        {
+            m_CapturePath.replace_filename(m_CapturePath.stem().string() + "_" + std::to_string(m_CaptureCount) + m_CapturePath.extension().string());
+        }
+
+        if (!m_Writer.Open(m_CapturePath, "MeshNodeSample", m_Metadata))
+        {
+            CauldronWarning(L"Failed to create frame trace %hs", m_CapturePath.string().c_str());
+
+            m_Enabled = false;
+            return;
+        }
+
+        m_Flythrough = flythroughPlaying;
+
+        Log::Write(LOGLEVEL_INFO, L"Capturing frame trace to %hs", m_CapturePath.string().c_str());
+    }
+
+    // draining the markers of the last captured frames
+    if (!m_Writer.IsOpen() || (m_DrainFrameCount > 0))
+    {
+        return;
+    }
+
+    // Settings in effect during the frame
+    std::vector<meshnode::FrameTraceArg> frameArgs = args;
+    frameArgs.push_back({"FlythroughFrame", m_Flythrough ? static_cast<double>(pFlythroughPlayer->GetPlaybackFrameCount()) - 1.0 : -1.0});
+
+    PendingFrame& frame = m_PendingFrames[m_RenderFrame % m_PendingFrames.size()];
+    frame.RenderFrame   = m_RenderFrame;
+    frame.TraceFrame    = m_Writer.GetStats().FrameCount;
+    frame.StartUs       = frameStartUs;
+
+    m_Writer.BeginFrame(frame.TraceFrame, frameStartUs, frameArgs.data(), frameArgs.size());
+}
+
+void FrameTraceCapture::AddCpuEvent(const char* name, std::chrono::high_resolution_clock::time_point startTime, double durationMs)
+{
+    if (!m_Writer.IsInFrame())
+    {
+        return;
+    }
+
+    const PendingFrame&           frame    = m_PendingFrames[m_RenderFrame % m_PendingFrames.size()];
+    const meshnode::FrameTraceArg frameArg = {"Frame", static_cast<double>(frame.TraceFrame)};
+
+    m_Writer.AddEvent(meshnode::FrameTraceTrack::Cpu, name, GetTimeUs(startTime), durationMs * 1000.0, &frameArg, 1);
+}
+
+void FrameTraceCapture::AddEvents(double workGraphGpuTimeMs)
+{
+    if (!m_Writer.IsOpen())
+    {
+        return;
+    }
+
+    if (m_Writer.IsInFrame())
+    {
+        const PendingFrame&           frame     = m_PendingFrames[m_RenderFrame % m_PendingFrames.size()];
+        const meshnode::FrameTraceArg frameArg  = {"Frame", static_cast<double>(frame.TraceFrame)};
+        const double                  executeUs = GetTimeUs(std::chrono::high_resolution_clock::now()) - frame.StartUs;
+
+        m_Writer.AddEvent(meshnode::FrameTraceTrack::Cpu, "WorkGraphRenderModule::Execute", frame.StartUs, executeUs, &frameArg, 1);
+    }
+
+    // The profiler reports the markers of a frame a fixed number of frames later. They are added to the frame they were measured in,
+    // starting at its start & spaced as measured, unless that frame was not captured.
+    const auto addTimings = [&](meshnode::FrameTraceTrack track, uint32_t latency, const std::vector<TimingInfo>& timings) {
+        const PendingFrame* pFrame = GetPendingFrame(latency);
+        if (pFrame == nullptr)
+        {
+            return;
+        }
+
+        const meshnode::FrameTraceArg frameArg = {"Frame", static_cast<double>(pFrame->TraceFrame)};
+
+        for (const TimingInfo& timing : timings)
+        {
+            const double startUs    = std::chrono::duration<double, std::micro>(timing.StartTime - timings.front().StartTime).count();
+            const double durationUs = std::chrono::duration<double, std::micro>(timing.EndTime - timing.StartTime).count();
+
+            m_Writer.AddEvent(track, timing.Label.c_str(), pFrame->StartUs + startUs, durationUs, &frameArg, 1);
+        }
+    };
+
+    addTimings(meshnode::FrameTraceTrack::Cpu, m_Desc.CpuMarkerLatency, GetProfiler()->GetCPUTimings());
+    addTimings(meshnode::FrameTraceTrack::Gpu, m_Desc.GpuMarkerLatency, GetProfiler()->GetGPUTimings());
+
+    if (const PendingFrame* pFrame = GetPendingFrame(m_Desc.GpuMarkerLatency))
+    {
+        m_Writer.AddCounter("WorkGraphGpuMs", pFrame->StartUs, workGraphGpuTimeMs);
+    }
+
+    // Close once the markers of all captured frames are added
+    if ((m_DrainFrameCount > 0) && (--m_DrainFrameCount == 0))
+    {
+        const std::string path = m_CapturePath.string();
+        if (m_Writer.Close())
+        {
+            const meshnode::FrameTraceStats& stats = m_Writer.GetStats();
+
+            Log::Write(LOGLEVEL_INFO,
+                       L"Frame trace with %llu frames written to %hs, %llu bytes, %u of %u flushes inside frames",
+                       static_cast<unsigned long long>(stats.FrameCount),
+                       path.c_str(),
+                       static_cast<unsigned long long>(stats.ByteCount),
+                       stats.FrameFlushCount,
+                       stats.FlushCount);
+        }
+        else
+        {
+            CauldronWarning(L"Failed to write frame trace %hs", path.c_str());
+        }
+        return;
+    }
+
+    // File IO after all events of the frame, outside of the Execute time
+    m_Writer.FlushFrames();
+}
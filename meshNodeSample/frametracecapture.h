@@ -0,0 +1,116 @@
+// This file is part of the AMD Work Graph Mesh Node Sample.
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#pragma once
+
+// Chrome trace event writer
+#include "frametrace.h"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <utility>
+#include <vector>
+
+class FlythroughPlayer;
+
+/**
+ * Settings of a frame trace capture, see "FrameTrace" in meshnodesampleconfig.json.
+ */
+struct FrameTraceCaptureDesc
+{
+    std::string Path = "frametrace.json";
+    // frames per capture, 0 = until the capture is stopped in the UI or the flythrough ends
+    uint32_t FrameCount = 600;
+    size_t   BufferSize = meshnode::FrameTraceWriter::DefaultBufferSize;
+    // frames between a frame & the profiler reporting its markers, for GPU markers the swap chain back buffer count
+    uint32_t CpuMarkerLatency = 1;
+    uint32_t GpuMarkerLatency = 3;
+    // start a capture with the first frame
+    bool Enabled = false;
+};
+
+/**
+ * Captures frames, CPU times & profiler markers of the sample as frame traces, see meshNodeCpu/frametrace.h.
+ * The writer & its buffer are created up front, it is open while capturing. Captures are started & stopped with the "Capture Frame Trace" checkbox.
+ * Captures started during flythrough playback begin with the first frame played back & end with the flythrough.
+ * Captured frames stay pending until the profiler reports their markers, the trace is closed once the last frame's markers are added.
+ */
+class FrameTraceCapture
+{
+public:
+    /**
+     * @brief   metadata holds the settings fixed at startup, written as otherData of every trace.
+     */
+    FrameTraceCapture(const FrameTraceCaptureDesc& desc, const std::vector<std::pair<std::string, std::string>>& metadata);
+
+    /**
+     * @brief   Register the "Capture Frame Trace" checkbox, unchecked once the frames of a capture are written.
+     */
+    void InitUI();
+
+    /**
+     * @brief   Start or stop a capture, end the previous frame & begin the frame with the settings in effect (args).
+     *          pFlythroughPlayer is nullptr if no flythrough is played back.
+     */
+    void Update(std::chrono::high_resolution_clock::time_point frameStartTime,
+                const FlythroughPlayer*                        pFlythroughPlayer,
+                const std::vector<meshnode::FrameTraceArg>&    args);
+    /**
+     * @brief   Add a CPU time measured in the current frame, e.g. the terrain clipmap update.
+     */
+    void AddCpuEvent(const char* name, std::chrono::high_resolution_clock::time_point startTime, double durationMs);
+    /**
+     * @brief   Add the render module time of the frame & the latest CPU & GPU profiler markers, then write the frames to the file.
+     */
+    void AddEvents(double workGraphGpuTimeMs);
+
+private:
+    struct PendingFrame
+    {
+        uint64_t RenderFrame = UINT64_MAX;
+        uint64_t TraceFrame  = 0;
+        double   StartUs     = 0.0;
+    };
+
+    double              GetTimeUs(std::chrono::high_resolution_clock::time_point time) const;
+    const PendingFrame* GetPendingFrame(uint32_t latency) const;
+
+    // closes a running capture when destroyed
+    meshnode::FrameTraceWriter                       m_Writer;
+    FrameTraceCaptureDesc                            m_Desc;
+    std::vector<std::pair<std::string, std::string>> m_Metadata;
+    std::filesystem::path                            m_CapturePath;
+    uint32_t                                         m_CaptureCount = 0;
+    bool                                             m_Flythrough   = false;
+    std::chrono::high_resolution_clock::time_point   m_StartTime;
+    // indexed by render frame, i.e. Execute call, modulo the size, which bounds the marker latencies
+    std::array<PendingFrame, 8> m_PendingFrames;
+    uint64_t                    m_RenderFrame = 0;
+    // frames left until the markers of the last captured frame are reported, 0 while capturing
+    uint32_t m_DrainFrameCount = 0;
+
+    // UI controlled
+    bool m_Enabled = false;
+};
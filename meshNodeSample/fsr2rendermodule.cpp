@@ -32,6 +32,8 @@
 #include "render/uploadheap.h"
 #include "validation_remap.h"
 
+#include "startuptimeline.h"
+
 using namespace cauldron;
 
 void FSR2RenderModule::Init(const json& initData)
@@ -227,6 +229,7 @@ void FSR2RenderModule::UpdateFSR2Context(bool enabled)
 #endif  // #if defined(_DEBUG)
 
         // Create the FSR2 context
+        StartupTimer timer("UpdateFSR2Context");
         FfxErrorCode errorCode = ffxFsr2ContextCreate(&m_FSR2Context, &m_InitializationParameters);
         CauldronAssert(ASSERT_CRITICAL, errorCode == FFX_OK, L"Couldn't create the FidelityFX SDK FSR2 context.");
     }
@@ -0,0 +1,240 @@
+// This file is part of the AMD Work Graph Mesh Node Sample.
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include "generationcounterreadback.h"
+
+#include "core/framework.h"
+#include "misc/assert.h"
+
+// Render components
+#include "render/buffer.h"
+#include "render/device.h"
+
+// D3D12 Cauldron implementation
+#include "render/dx12/buffer_dx12.h"
+#include "render/dx12/commandlist_dx12.h"
+#include "render/dx12/device_dx12.h"
+#include "render/dx12/gpuresource_dx12.h"
+
+// common files with shaders
+#include "shaders/generationcounters.h"
+#include "shaders/workgraphcommon.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <initializer_list>
+
+using namespace cauldron;
+
+GenerationCounterReadback::GenerationCounterReadback(bool enabled, uint32_t slotCount)
+    : m_SlotValid(slotCount, false)
+    , m_Enabled(enabled)
+{
+    const uint32_t counterBytes = meshnode::generationCounterBufferSize * sizeof(uint32_t);
+
+    // The UAV is bound to the work graph in any case
+    BufferDesc bufferDesc = BufferDesc::Data(L"MeshNodeSample_GenerationCounters", counterBytes, sizeof(uint32_t), 0, ResourceFlags::AllowUnorderedAccess);
+
+    m_pCounterBuffer = Buffer::CreateBufferResource(&bufferDesc, ResourceState::UnorderedAccess);
+
+    // Zeros copied to the counters before every dispatch
+    {
+        const CD3DX12_HEAP_PROPERTIES heapProperties(D3D12_HEAP_TYPE_UPLOAD);
+        const CD3DX12_RESOURCE_DESC   resourceDesc = CD3DX12_RESOURCE_DESC::Buffer(counterBytes);
+
+        CauldronThrowOnFail(GetDevice()->GetImpl()->DX12Device()->CreateCommittedResource(
+            &heapProperties, D3D12_HEAP_FLAG_NONE, &resourceDesc, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&m_pClearBuffer)));
+
+        const CD3DX12_RANGE readRange(0, 0);
+        void*               pClearData = nullptr;
+        CauldronThrowOnFail(m_pClearBuffer->Map(0, &readRange, &pClearData));
+        memset(pClearData, 0, counterBytes);
+        m_pClearBuffer->Unmap(0, nullptr);
+    }
+
+    // One readback slot per frame in flight, the buffer stays mapped
+    {
+        const CD3DX12_HEAP_PROPERTIES heapProperties(D3D12_HEAP_TYPE_READBACK);
+        const CD3DX12_RESOURCE_DESC   resourceDesc = CD3DX12_RESOURCE_DESC::Buffer(counterBytes * slotCount);
+
+        CauldronThrowOnFail(GetDevice()->GetImpl()->DX12Device()->CreateCommittedResource(
+            &heapProperties, D3D12_HEAP_FLAG_NONE, &resourceDesc, D3D12_RESOURCE_STATE_COPY_DEST, nullptr, IID_PPV_ARGS(&m_pReadbackBuffer)));
+
+        void* pReadbackData = nullptr;
+        CauldronThrowOnFail(m_pReadbackBuffer->Map(0, nullptr, &pReadbackData));
+        m_pReadbackData = static_cast<const uint32_t*>(pReadbackData);
+    }
+}
+
+GenerationCounterReadback::~GenerationCounterReadback()
+{
+    if (m_pCounterBuffer)
+        delete m_pCounterBuffer;
+    if (m_pClearBuffer)
+        m_pClearBuffer->Release();
+    if (m_pReadbackBuffer)
+        m_pReadbackBuffer->Release();
+}
+
+void GenerationCounterReadback::InitUI()
+{
+    UISection section   = {};
+    section.SectionName = "Generation Counters";
+
+    section.AddCheckBox("Count Generated Work", &m_Enabled);
+
+    GetUIManager()->RegisterUIElements(section);
+
+    // Read-outs are added to the same section below the checkbox
+    UpdateReadouts();
+}
+
+void GenerationCounterReadback::Update(cauldron::CommandList* pCmdList, meshnode::WorkGraphCBData& workGraphData)
+{
+    workGraphData.GenerationCountersEnabled = m_Enabled ? 1 : 0;
+
+    if (!m_Enabled)
+    {
+        std::fill(m_SlotValid.begin(), m_SlotValid.end(), false);
+        m_Totals = {};
+        UpdateReadouts();
+        return;
+    }
+
+    // The current slot was last written slotCount frames ago
+    if (m_SlotValid[m_ReadbackSlot])
+    {
+        UpdateTotals(m_pReadbackData + m_ReadbackSlot * meshnode::generationCounterBufferSize);
+        UpdateReadouts();
+    }
+
+    Barrier barrier = Barrier::Transition(m_pCounterBuffer->GetResource(), ResourceState::UnorderedAccess, ResourceState::CopyDest);
+    ResourceBarrier(pCmdList, 1, &barrier);
+
+    pCmdList->GetImpl()->DX12CmdList()->CopyBufferRegion(
+        m_pCounterBuffer->GetResource()->GetImpl()->DX12Resource(), 0, m_pClearBuffer, 0, meshnode::generationCounterBufferSize * sizeof(uint32_t));
+
+    std::swap(barrier.DestState, barrier.SourceState);
+    ResourceBarrier(pCmdList, 1, &barrier);
+}
+
+void GenerationCounterReadback::ReadBack(cauldron::CommandList* pCmdList)
+{
+    if (!m_Enabled)
+    {
+        return;
+    }
+
+    const uint32_t counterBytes = meshnode::generationCounterBufferSize * sizeof(uint32_t);
+
+    Barrier barrier = Barrier::Transition(m_pCounterBuffer->GetResource(), ResourceState::UnorderedAccess, ResourceState::CopySource);
+    ResourceBarrier(pCmdList, 1, &barrier);
+
+    pCmdList->GetImpl()->DX12CmdList()->CopyBufferRegion(
+        m_pReadbackBuffer, m_ReadbackSlot * counterBytes, m_pCounterBuffer->GetResource()->GetImpl()->DX12Resource(), 0, counterBytes);
+
+    std::swap(barrier.DestState, barrier.SourceState);
+    ResourceBarrier(pCmdList, 1, &barrier);
+
+    m_SlotValid[m_ReadbackSlot] = true;
+    m_ReadbackSlot              = (m_ReadbackSlot + 1) % static_cast<uint32_t>(m_SlotValid.size());
+}
+
+void GenerationCounterReadback::UpdateTotals(const uint32_t* pCounters)
+{
+    const auto getCounter = [pCounters](uint32_t node, uint32_t counter) { return pCounters[meshnode::GetGenerationCounterIndex(node, counter)]; };
+    const auto getOccupancy = [&](std::initializer_list<uint32_t> nodes) {
+        uint64_t entries = 0, capacity = 0;
+        for (const uint32_t node : nodes)
+        {
+            entries += getCounter(node, meshnode::generationCounterEntries);
+            capacity += static_cast<uint64_t>(getCounter(node, meshnode::generationCounterRecords)) * meshnode::GetGenerationRecordCapacity(node);
+        }
+        return static_cast<float>((capacity > 0) ? 100.0 * entries / capacity : 0.0);
+    };
+
+    GenerationCounterTotals totals = {};
+    for (uint32_t node = meshnode::generationNodeDrawTerrainChunk; node < meshnode::generationNodeCount; ++node)
+    {
+        totals.MeshGroups += getCounter(node, meshnode::generationCounterGroups);
+        totals.Vertices += getCounter(node, meshnode::generationCounterVertices);
+        totals.Primitives += getCounter(node, meshnode::generationCounterPrimitives);
+    }
+
+    const auto getRecords = [&](uint32_t node) { return getCounter(node, meshnode::generationCounterRecords); };
+
+    totals.TileRecords =
+        getRecords(meshnode::generationNodeMountainTile) + getRecords(meshnode::generationNodeWoodlandTile) + getRecords(meshnode::generationNodeGrasslandTile);
+    totals.SplineRecords       = getRecords(meshnode::generationNodeDrawSpline);
+    totals.DenseGrassRecords   = getRecords(meshnode::generationNodeDrawDenseGrassPatch);
+    totals.FlowerRecords       = getRecords(meshnode::generationNodeDrawFlowerPatch) + getRecords(meshnode::generationNodeDrawSparseFlowerPatch);
+    totals.SplineOccupancy     = getOccupancy({meshnode::generationNodeDrawSpline});
+    totals.DenseGrassOccupancy = getOccupancy({meshnode::generationNodeDrawDenseGrassPatch});
+    totals.FlowerOccupancy     = getOccupancy({meshnode::generationNodeDrawFlowerPatch, meshnode::generationNodeDrawSparseFlowerPatch});
+
+    m_Totals = totals;
+}
+
+void GenerationCounterReadback::UpdateReadouts()
+{
+    const auto format = [](const char* pFormat, auto value) {
+        char text[64];
+        snprintf(text, sizeof(text), pFormat, value);
+        return std::string(text);
+    };
+
+    const std::vector<std::string> readoutText = {
+        format("Tile Records: %u", m_Totals.TileRecords),
+        format("Spline Records: %u", m_Totals.SplineRecords),
+        format("Spline Occupancy: %.1f percent", m_Totals.SplineOccupancy),
+        format("Dense Grass Records: %u", m_Totals.DenseGrassRecords),
+        format("Dense Grass Occupancy: %.1f percent", m_Totals.DenseGrassOccupancy),
+        format("Flower Records: %u", m_Totals.FlowerRecords),
+        format("Flower Occupancy: %.1f percent", m_Totals.FlowerOccupancy),
+        format("Mesh Groups: %u", m_Totals.MeshGroups),
+        format("Vertices: %llu", static_cast<unsigned long long>(m_Totals.Vertices)),
+        format("Primitives: %llu", static_cast<unsigned long long>(m_Totals.Primitives)),
+    };
+
+    // Text elements are not editable, thus the read-outs are replaced instead of written in place
+    if (readoutText == m_ReadoutText)
+    {
+        return;
+    }
+
+    if (!m_ReadoutText.empty())
+    {
+        GetUIManager()->UnRegisterUIElements(m_ReadoutSection);
+    }
+
+    m_ReadoutText = readoutText;
+
+    m_ReadoutSection             = {};
+    m_ReadoutSection.SectionName = "Generation Counters";
+    for (const std::string& text : m_ReadoutText)
+    {
+        m_ReadoutSection.AddText(text.c_str(), &m_Enabled);
+    }
+
+    GetUIManager()->RegisterUIElements(m_ReadoutSection);
+}
@@ -0,0 +1,111 @@
+// This file is part of the AMD Work Graph Mesh Node Sample.
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#pragma once
+
+#include "core/uimanager.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct ID3D12Resource;
+
+namespace cauldron
+{
+    class Buffer;
+    class CommandList;
+}  // namespace cauldron
+
+namespace meshnode
+{
+    struct WorkGraphCBData;
+}  // namespace meshnode
+
+/**
+ * Generated work of a frame summed over the nodes, see shaders/generationcounters.h.
+ */
+struct GenerationCounterTotals
+{
+    uint32_t TileRecords       = 0;
+    uint32_t SplineRecords     = 0;
+    uint32_t DenseGrassRecords = 0;
+    uint32_t FlowerRecords     = 0;
+    uint32_t MeshGroups        = 0;
+    uint64_t Vertices          = 0;
+    uint64_t Primitives        = 0;
+    // mean used entries of the record arrays in percent
+    float SplineOccupancy     = 0.f;
+    float DenseGrassOccupancy = 0.f;
+    float FlowerOccupancy     = 0.f;
+};
+
+/**
+ * Records, thread groups, mesh outputs & record array occupancy counted by the work graph nodes & shown in the "Generation Counters" UI section.
+ * The counters are cleared before & copied to a readback slot after every dispatch. Slots are read when they are reused
+ * slotCount frames later, at which point the GPU finished the copy, i.e. the totals shown are a few frames old.
+ */
+class GenerationCounterReadback
+{
+public:
+    GenerationCounterReadback(bool enabled, uint32_t slotCount);
+    ~GenerationCounterReadback();
+
+    /**
+     * @brief   Register the "Count Generated Work" checkbox & the read-outs of the totals.
+     */
+    void InitUI();
+
+    /**
+     * @brief   Read the counters of the frame that last used the current slot & clear the counters before the work graph is dispatched.
+     */
+    void Update(cauldron::CommandList* pCmdList, meshnode::WorkGraphCBData& workGraphData);
+    /**
+     * @brief   Copy the counters of the work graph dispatch to the current slot.
+     */
+    void ReadBack(cauldron::CommandList* pCmdList);
+
+    // UAV bound to the work graph, also while counting is disabled
+    cauldron::Buffer*              GetCounterBuffer() const { return m_pCounterBuffer; }
+    bool                           IsEnabled() const { return m_Enabled; }
+    // latest totals read back, all zero while disabled
+    const GenerationCounterTotals& GetTotals() const { return m_Totals; }
+
+private:
+    void UpdateTotals(const uint32_t* pCounters);
+    void UpdateReadouts();
+
+    cauldron::Buffer* m_pCounterBuffer        = nullptr;
+    ID3D12Resource*   m_pClearBuffer          = nullptr;
+    ID3D12Resource*   m_pReadbackBuffer       = nullptr;
+    const uint32_t*   m_pReadbackData         = nullptr;
+    uint32_t          m_ReadbackSlot          = 0;
+    // slots holding counters copied since the counters were enabled
+    std::vector<bool> m_SlotValid;
+
+    GenerationCounterTotals m_Totals;
+
+    // UI controlled, the read-outs are text elements re-registered whenever the totals change
+    bool                     m_Enabled = false;
+    cauldron::UISection      m_ReadoutSection;
+    std::vector<std::string> m_ReadoutText;
+};
@@ -38,9 +38,14 @@
 #include "fsr2rendermodule.h"
 #include "workgraphrendermodule.h"
 
+// Startup timing report
+#include "startuptimeline.h"
+
 // D3D12 header to enable experimental shader models
 #include "d3d12.h"
 
+#include <filesystem>
+
 using namespace cauldron;
 
 class MeshNodeSample final : public Framework
@@ -61,6 +66,17 @@ public:
         json sampleConfig;
         CauldronAssert(ASSERT_CRITICAL, ParseJsonFile(configFileName, sampleConfig), L"Could not parse JSON file %ls", configFileName);
 
+#if !defined(_RELEASE)
+        // Developer settings, e.g. shader hot-reload, are applied on top of the sample config in debug builds
+        const auto devConfigFileName = L"configs/meshnodesampledevconfig.json";
+
+        json devConfig;
+        if (std::filesystem::exists(devConfigFileName) && ParseJsonFile(devConfigFileName, devConfig))
+        {
+            sampleConfig.merge_patch(devConfig);
+        }
+#endif
+
         // Get the sample configuration
         json configData = sampleConfig["Mesh Node Sample"];
 
@@ -103,6 +119,9 @@ public:
         // Enable FSR 2 upscaling and AA
         GetFramework()->GetRenderModule("FSR2RenderModule")->EnableModule(true);
 
+        // All startup phases are recorded, report remaining phases (e.g. FSR 2 context creation)
+        StartupTimeline::Get().Finish();
+
         return 0;
     }
 
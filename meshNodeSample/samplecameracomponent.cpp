@@ -26,6 +26,8 @@
 #include "core/inputmanager.h"
 #include "core/scene.h"
 
+std::function<bool(meshnode::FlythroughFrame&)> MeshNodeSampleCameraComponent::s_FlythroughCallback;
+
 MeshNodeSampleCameraComponent::MeshNodeSampleCameraComponent(cauldron::Entity* pOwner, cauldron::ComponentData* pData, cauldron::CameraComponentMgr* pManager)
     : CameraComponent(pOwner, pData, pManager)
 {
@@ -45,6 +47,21 @@ void MeshNodeSampleCameraComponent::Update(double deltaTime)
     // If this camera is the currently active camera for the scene, check for input
     if (GetScene()->GetCurrentCamera() == this)
     {
+        // Flythrough playback replaces user input
+        meshnode::FlythroughFrame flythroughFrame = {};
+        if (s_FlythroughCallback && s_FlythroughCallback(flythroughFrame))
+        {
+            m_Yaw   = flythroughFrame.Yaw;
+            m_Pitch = flythroughFrame.Pitch;
+
+            const Vec4 eyePos = Vec4(flythroughFrame.Position.x, flythroughFrame.Position.y, flythroughFrame.Position.z, 0.f);
+
+            UpdateJitter();
+            LookAt(eyePos, eyePos - 10 * PolarToVector(m_Yaw, m_Pitch));
+            UpdateMatrices();
+            return;
+        }
+
         const InputState& inputState = GetInputManager()->GetInputState();
 
         // Read in inputs
@@ -117,27 +134,31 @@ void MeshNodeSampleCameraComponent::Update(double deltaTime)
         // Limit maximum camera height
         eyePos[1] = std::min<float>(eyePos[1], 400.f);
 
-        // Update camera jitter if we need it
-        if (CameraComponent::s_pSetJitterCallback)
-        {
-            s_pSetJitterCallback(m_jitterValues);
-            m_Dirty = true;
-        }
-        else
-        {
-            // Reset jitter if disabled
-            if (m_jitterValues.getX() != 0.f || m_jitterValues.getY() != 0.f)
-            {
-                m_jitterValues = Vec2(0.f, 0.f);
-                m_Dirty        = true;
-            }
-        }
-
+        UpdateJitter();
         LookAt(eyePos, eyePos - 10 * polarVector);
         UpdateMatrices();
     }
 }
 
+void MeshNodeSampleCameraComponent::UpdateJitter()
+{
+    // Update camera jitter if we need it
+    if (CameraComponent::s_pSetJitterCallback)
+    {
+        s_pSetJitterCallback(m_jitterValues);
+        m_Dirty = true;
+    }
+    else
+    {
+        // Reset jitter if disabled
+        if (m_jitterValues.getX() != 0.f || m_jitterValues.getY() != 0.f)
+        {
+            m_jitterValues = Vec2(0.f, 0.f);
+            m_Dirty        = true;
+        }
+    }
+}
+
 void InitCameraEntity(void*)
 {
     using namespace cauldron;
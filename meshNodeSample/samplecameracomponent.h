@@ -23,12 +23,31 @@
 
 #include "core/components/cameracomponent.h"
 
+// CPU flythrough frames
+#include "flythrough.h"
+
+#include <functional>
+
 class MeshNodeSampleCameraComponent : public cauldron::CameraComponent
 {
 public:
     MeshNodeSampleCameraComponent(cauldron::Entity* pOwner, cauldron::ComponentData* pData, cauldron::CameraComponentMgr* pManager);
 
     void Update(double deltaTime) override;
+
+    float GetYaw() const { return m_Yaw; }
+    float GetPitch() const { return m_Pitch; }
+
+    /**
+     * @brief   Set a callback providing the camera pose of the next frame, e.g. for flythrough playback.
+     *          User input is ignored as long as the callback returns true. An empty callback restores user input.
+     */
+    static void SetFlythroughCallback(std::function<bool(meshnode::FlythroughFrame&)> callback) { s_FlythroughCallback = std::move(callback); }
+
+private:
+    void UpdateJitter();
+
+    static std::function<bool(meshnode::FlythroughFrame&)> s_FlythroughCallback;
 };
 
 void InitCameraEntity(void*);
\ No newline at end of file
@@ -0,0 +1,313 @@
+// This file is part of the AMD Work Graph Mesh Node Sample.
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include "shaderarchive.h"
+
+#include <cstring>
+#include <fstream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static uint64_t AlignUp(uint64_t value, uint64_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+std::string ShaderArchiveToUtf8(const wchar_t* string)
+{
+    std::string result;
+    if (string == nullptr)
+    {
+        return result;
+    }
+
+    for (; *string != 0; ++string)
+    {
+        uint32_t codePoint = static_cast<uint32_t>(*string);
+
+        // combine UTF-16 surrogate pairs (wchar_t is 16-bit on Windows)
+        if ((codePoint >= 0xD800) && (codePoint < 0xDC00) && (string[1] >= 0xDC00) && (string[1] < 0xE000))
+        {
+            codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (static_cast<uint32_t>(string[1]) - 0xDC00);
+            ++string;
+        }
+
+        if (codePoint < 0x80)
+        {
+            result += static_cast<char>(codePoint);
+        }
+        else if (codePoint < 0x800)
+        {
+            result += static_cast<char>(0xC0 | (codePoint >> 6));
+            result += static_cast<char>(0x80 | (codePoint & 0x3F));
+        }
+        else if (codePoint < 0x10000)
+        {
+            result += static_cast<char>(0xE0 | (codePoint >> 12));
+            result += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+            result += static_cast<char>(0x80 | (codePoint & 0x3F));
+        }
+        else
+        {
+            result += static_cast<char>(0xF0 | (codePoint >> 18));
+            result += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+            result += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+            result += static_cast<char>(0x80 | (codePoint & 0x3F));
+        }
+    }
+
+    return result;
+}
+
+ShaderArchive::~ShaderArchive()
+{
+    Close();
+}
+
+bool ShaderArchive::Open(const std::wstring& archivePath)
+{
+    Close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileW(archivePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    LARGE_INTEGER fileSize = {};
+    GetFileSizeEx(file, &fileSize);
+
+    HANDLE mapping = (fileSize.QuadPart > 0) ? CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr) : nullptr;
+    if (mapping == nullptr)
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    const void* pData = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (pData == nullptr)
+    {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    m_FileHandle    = file;
+    m_MappingHandle = mapping;
+    m_pData         = static_cast<const uint8_t*>(pData);
+    m_Size          = static_cast<size_t>(fileSize.QuadPart);
+#else
+    const int file = open(ShaderArchiveToUtf8(archivePath.c_str()).c_str(), O_RDONLY);
+    if (file < 0)
+    {
+        return false;
+    }
+
+    struct stat fileStat = {};
+    if ((fstat(file, &fileStat) != 0) || (fileStat.st_size <= 0))
+    {
+        close(file);
+        return false;
+    }
+
+    void* pData = mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+    // mapping stays valid after closing the file descriptor
+    close(file);
+
+    if (pData == MAP_FAILED)
+    {
+        return false;
+    }
+
+    m_pData = static_cast<const uint8_t*>(pData);
+    m_Size  = static_cast<size_t>(fileStat.st_size);
+#endif
+
+    // Validate header & manifest, such that all accessors can skip bounds checks
+    const auto* header = reinterpret_cast<const ShaderArchiveHeader*>(m_pData);
+
+    bool valid = (m_Size >= sizeof(ShaderArchiveHeader)) && (header->Magic == ShaderArchiveMagic) && (header->Version == ShaderArchiveVersion) &&
+                 (header->FileSize == m_Size) && (sizeof(ShaderArchiveHeader) + uint64_t(header->EntryCount) * sizeof(ShaderArchiveEntry) <= m_Size) &&
+                 (header->StringTableOffset + header->StringTableSize <= m_Size) && (header->StringTableSize > 0) &&
+                 (m_pData[header->StringTableOffset + header->StringTableSize - 1] == 0);
+
+    for (uint32_t i = 0; valid && (i < header->EntryCount); ++i)
+    {
+        const auto& entry = GetEntry(i);
+
+        valid = (entry.BlobOffset % ShaderArchiveBlobAlignment == 0) && (entry.BlobOffset + entry.BlobSize <= m_Size) &&
+                (entry.ShaderFilePathOffset < header->StringTableSize) && (entry.TargetOffset < header->StringTableSize) &&
+                (entry.EntryPointOffset < header->StringTableSize) && (entry.DefinesOffset < header->StringTableSize);
+    }
+
+    if (!valid)
+    {
+        Close();
+    }
+
+    return valid;
+}
+
+void ShaderArchive::Close()
+{
+    if (m_pData == nullptr)
+    {
+        return;
+    }
+
+#ifdef _WIN32
+    UnmapViewOfFile(m_pData);
+    CloseHandle(static_cast<HANDLE>(m_MappingHandle));
+    CloseHandle(static_cast<HANDLE>(m_FileHandle));
+#else
+    munmap(const_cast<uint8_t*>(m_pData), m_Size);
+#endif
+
+    m_pData         = nullptr;
+    m_Size          = 0;
+    m_FileHandle    = nullptr;
+    m_MappingHandle = nullptr;
+}
+
+uint32_t ShaderArchive::GetEntryCount() const
+{
+    return reinterpret_cast<const ShaderArchiveHeader*>(m_pData)->EntryCount;
+}
+
+const ShaderArchiveEntry& ShaderArchive::GetEntry(uint32_t index) const
+{
+    return reinterpret_cast<const ShaderArchiveEntry*>(m_pData + sizeof(ShaderArchiveHeader))[index];
+}
+
+const char* ShaderArchive::GetString(uint32_t offset) const
+{
+    const auto* header = reinterpret_cast<const ShaderArchiveHeader*>(m_pData);
+
+    return reinterpret_cast<const char*>(m_pData + header->StringTableOffset + offset);
+}
+
+const ShaderArchiveEntry* ShaderArchive::FindEntry(const wchar_t* shaderFilePath, const wchar_t* target, const wchar_t* entryPoint, const wchar_t* defines) const
+{
+    const std::string shaderFilePathUtf8 = ShaderArchiveToUtf8(shaderFilePath);
+    const std::string targetUtf8         = ShaderArchiveToUtf8(target);
+    const std::string entryPointUtf8     = ShaderArchiveToUtf8(entryPoint);
+    const std::string definesUtf8        = ShaderArchiveToUtf8(defines);
+
+    for (uint32_t i = 0; i < GetEntryCount(); ++i)
+    {
+        const auto& entry = GetEntry(i);
+
+        if ((shaderFilePathUtf8 == GetString(entry.ShaderFilePathOffset)) && (targetUtf8 == GetString(entry.TargetOffset)) &&
+            (entryPointUtf8 == GetString(entry.EntryPointOffset)) && (definesUtf8 == GetString(entry.DefinesOffset)))
+        {
+            return &entry;
+        }
+    }
+
+    return nullptr;
+}
+
+void ShaderArchiveWriter::AddShader(const wchar_t* shaderFilePath,
+                                    const wchar_t* target,
+                                    const wchar_t* entryPoint,
+                                    const wchar_t* defines,
+                                    uint64_t       hash,
+                                    const void*    pBlob,
+                                    size_t         blobSize)
+{
+    ShaderArchiveEntry entry   = {};
+    entry.Hash                 = hash;
+    entry.BlobSize             = blobSize;
+    entry.ShaderFilePathOffset = AddString(shaderFilePath);
+    entry.TargetOffset         = AddString(target);
+    entry.EntryPointOffset     = AddString(entryPoint);
+    entry.DefinesOffset        = AddString(defines);
+
+    m_Entries.push_back(entry);
+
+    const auto* bytes = static_cast<const uint8_t*>(pBlob);
+    m_Blobs.emplace_back(bytes, bytes + blobSize);
+}
+
+uint32_t ShaderArchiveWriter::AddString(const wchar_t* string)
+{
+    const std::string utf8 = ShaderArchiveToUtf8(string);
+
+    const uint32_t offset = static_cast<uint32_t>(m_StringTable.size());
+    m_StringTable.insert(m_StringTable.end(), utf8.begin(), utf8.end());
+    m_StringTable.push_back(0);
+
+    return offset;
+}
+
+bool ShaderArchiveWriter::Write(const std::wstring& archivePath) const
+{
+    ShaderArchiveHeader header = {};
+    header.Magic               = ShaderArchiveMagic;
+    header.Version             = ShaderArchiveVersion;
+    header.EntryCount          = static_cast<uint32_t>(m_Entries.size());
+    header.StringTableOffset   = sizeof(ShaderArchiveHeader) + m_Entries.size() * sizeof(ShaderArchiveEntry);
+    header.StringTableSize     = static_cast<uint32_t>(m_StringTable.size());
+
+    // Assign aligned blob offsets after string table
+    std::vector<ShaderArchiveEntry> entries = m_Entries;
+
+    uint64_t offset = header.StringTableOffset + header.StringTableSize;
+    for (auto& entry : entries)
+    {
+        entry.BlobOffset = AlignUp(offset, ShaderArchiveBlobAlignment);
+        offset           = entry.BlobOffset + entry.BlobSize;
+    }
+    header.FileSize = offset;
+
+    std::vector<uint8_t> data(static_cast<size_t>(header.FileSize), 0);
+    memcpy(data.data(), &header, sizeof(header));
+    memcpy(data.data() + sizeof(header), entries.data(), entries.size() * sizeof(ShaderArchiveEntry));
+    memcpy(data.data() + header.StringTableOffset, m_StringTable.data(), m_StringTable.size());
+    for (size_t i = 0; i < entries.size(); ++i)
+    {
+        memcpy(data.data() + entries[i].BlobOffset, m_Blobs[i].data(), m_Blobs[i].size());
+    }
+
+#ifdef _WIN32
+    std::ofstream file(archivePath, std::ios::binary | std::ios::trunc);
+#else
+    std::ofstream file(ShaderArchiveToUtf8(archivePath.c_str()), std::ios::binary | std::ios::trunc);
+#endif
+    if (!file)
+    {
+        return false;
+    }
+
+    file.write(reinterpret_cast<const char*>(data.data()), data.size());
+
+    return static_cast<bool>(file);
+}
@@ -0,0 +1,144 @@
+// This file is part of the AMD Work Graph Mesh Node Sample.
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Packed archive of precompiled DXIL blobs.
+ *
+ * Layout:
+ *  - ShaderArchiveHeader
+ *  - ShaderArchiveEntry[EntryCount]
+ *  - string table with null-terminated UTF-8 strings (file names, entry points, targets, defines)
+ *  - DXIL blobs, each aligned to ShaderArchiveBlobAlignment bytes
+ */
+static const uint32_t ShaderArchiveMagic         = 0x41534E4D;  // "MNSA"
+static const uint32_t ShaderArchiveVersion       = 1;
+static const uint32_t ShaderArchiveBlobAlignment = 64;
+
+struct ShaderArchiveHeader
+{
+    uint32_t Magic;
+    uint32_t Version;
+    uint32_t EntryCount;
+    uint32_t StringTableSize;
+    uint64_t StringTableOffset;
+    uint64_t FileSize;
+};
+
+struct ShaderArchiveEntry
+{
+    // Source hash, see ComputeShaderSourceHash
+    uint64_t Hash;
+    uint64_t BlobOffset;
+    uint64_t BlobSize;
+    // offsets into string table
+    uint32_t ShaderFilePathOffset;
+    uint32_t TargetOffset;
+    uint32_t EntryPointOffset;
+    // variant key of the define set, see GetShaderVariantKey
+    uint32_t DefinesOffset;
+};
+
+/**
+ * Read-only view of a shader archive. The archive file is memory-mapped and blobs are returned as pointers into the mapping.
+ * All pointers stay valid until the archive is closed.
+ */
+class ShaderArchive
+{
+public:
+    ShaderArchive() = default;
+    ~ShaderArchive();
+
+    ShaderArchive(const ShaderArchive&)            = delete;
+    ShaderArchive& operator=(const ShaderArchive&) = delete;
+
+    /**
+     * @brief   Map archive file into memory & validate header and manifest. Returns false if the file is missing or invalid.
+     */
+    bool Open(const std::wstring& archivePath);
+    void Close();
+
+    bool IsOpen() const
+    {
+        return m_pData != nullptr;
+    }
+
+    uint32_t GetEntryCount() const;
+    const ShaderArchiveEntry& GetEntry(uint32_t index) const;
+    const char*               GetString(uint32_t offset) const;
+
+    const void* GetBlob(const ShaderArchiveEntry& entry) const
+    {
+        return m_pData + entry.BlobOffset;
+    }
+
+    /**
+     * @brief   Find entry for a shader compilation. defines is the variant key of the define set, see GetShaderVariantKey.
+     *          entryPoint & defines can be nullptr. Returns nullptr if not found.
+     */
+    const ShaderArchiveEntry* FindEntry(const wchar_t* shaderFilePath, const wchar_t* target, const wchar_t* entryPoint, const wchar_t* defines) const;
+
+private:
+    const uint8_t* m_pData = nullptr;
+    size_t         m_Size  = 0;
+
+    // platform specific handles of mapping
+    void* m_FileHandle    = nullptr;
+    void* m_MappingHandle = nullptr;
+};
+
+/**
+ * Builds a shader archive in memory & writes it to disk.
+ */
+class ShaderArchiveWriter
+{
+public:
+    void AddShader(const wchar_t* shaderFilePath,
+                   const wchar_t* target,
+                   const wchar_t* entryPoint,
+                   const wchar_t* defines,
+                   uint64_t       hash,
+                   const void*    pBlob,
+                   size_t         blobSize);
+
+    /**
+     * @brief   Write archive to archivePath. Returns false if the file could not be written.
+     */
+    bool Write(const std::wstring& archivePath) const;
+
+private:
+    uint32_t AddString(const wchar_t* string);
+
+    std::vector<ShaderArchiveEntry>   m_Entries;
+    std::vector<char>                 m_StringTable;
+    std::vector<std::vector<uint8_t>> m_Blobs;
+};
+
+/**
+ * @brief   Convert wide string to UTF-8. Shader names & paths are stored as UTF-8 to be independent of wchar_t size.
+ */
+std::string ShaderArchiveToUtf8(const wchar_t* string);
@@ -0,0 +1,281 @@
+// This file is part of the AMD Work Graph Mesh Node Sample.
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "shadercache.h"
+
+#include <filesystem>
+namespace filesystem = std::filesystem;
+
+#include <algorithm>
+#include <cwctype>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+// Identifies a cache entry file. Increment the version if the entry layout changes.
+static const uint32_t ShaderCacheEntryMagic   = 0x4353534D;  // "MSSC"
+static const uint32_t ShaderCacheEntryVersion = 1;
+
+struct ShaderCacheEntryHeader
+{
+    uint32_t Magic;
+    uint32_t Version;
+    uint64_t Key;
+    uint64_t Size;
+};
+
+void ShaderHasher::Add(const void* pData, size_t size)
+{
+    const uint8_t* bytes = static_cast<const uint8_t*>(pData);
+    for (size_t i = 0; i < size; ++i)
+    {
+        m_Hash ^= bytes[i];
+        m_Hash *= 1099511628211ull;
+    }
+}
+
+void ShaderHasher::Add(const std::wstring& string)
+{
+    // include terminator to separate consecutive strings
+    Add(string.c_str(), (string.size() + 1) * sizeof(wchar_t));
+}
+
+void ShaderHasher::Add(uint64_t value)
+{
+    Add(&value, sizeof(value));
+}
+
+std::wstring GetShaderVariantKey(const std::vector<ShaderDefine>& defines)
+{
+    std::vector<const ShaderDefine*> sortedDefines;
+    for (const auto& define : defines)
+    {
+        sortedDefines.push_back(&define);
+    }
+    std::sort(sortedDefines.begin(), sortedDefines.end(), [](const ShaderDefine* a, const ShaderDefine* b) { return a->Name < b->Name; });
+
+    std::wstring key;
+    for (const auto* define : sortedDefines)
+    {
+        if (!key.empty())
+        {
+            key += L";";
+        }
+        key += define->Name + L"=" + define->Value;
+    }
+
+    return key;
+}
+
+static bool ReadFileContents(const filesystem::path& path, std::string& contents)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+    {
+        return false;
+    }
+
+    std::stringstream stream;
+    stream << file.rdbuf();
+    contents = stream.str();
+
+    return true;
+}
+
+// Collects all files included with #include "..." by source, including transitive includes.
+// Include paths are resolved relative to the shaders folder, same as the -I argument passed to DXC.
+static void CollectIncludes(const filesystem::path& shadersFolderPath, const std::string& source, std::vector<std::wstring>& includes)
+{
+    std::istringstream stream(source);
+    std::string        line;
+
+    while (std::getline(stream, line))
+    {
+        const auto directive = line.find("#include");
+        if ((directive == std::string::npos) || (line.find_first_not_of(" \t") != directive))
+        {
+            continue;
+        }
+
+        const auto begin = line.find('"', directive);
+        const auto end   = (begin == std::string::npos) ? std::string::npos : line.find('"', begin + 1);
+        if (end == std::string::npos)
+        {
+            continue;
+        }
+
+        const std::wstring includeName = filesystem::path(line.substr(begin + 1, end - begin - 1)).filename().wstring();
+        if (std::find(includes.begin(), includes.end(), includeName) != includes.end())
+        {
+            continue;
+        }
+
+        includes.push_back(includeName);
+
+        std::string includeSource;
+        if (ReadFileContents(shadersFolderPath / includeName, includeSource))
+        {
+            CollectIncludes(shadersFolderPath, includeSource, includes);
+        }
+    }
+}
+
+bool ComputeShaderSourceHash(const std::wstring&        shadersDirectory,
+                             const wchar_t*             shaderFilePath,
+                             const wchar_t*             target,
+                             const wchar_t*             entryPoint,
+                             uint64_t&                  hash,
+                             std::vector<std::wstring>* pIncludes)
+{
+    const filesystem::path shadersFolderPath = shadersDirectory;
+
+    std::string shaderSource;
+    if (!ReadFileContents(shadersFolderPath / shaderFilePath, shaderSource))
+    {
+        return false;
+    }
+
+    std::vector<std::wstring> includes;
+    CollectIncludes(shadersFolderPath, shaderSource, includes);
+    // include order does not change the compiled result, sort to get a stable key
+    std::sort(includes.begin(), includes.end());
+
+    ShaderHasher hasher;
+    hasher.Add(shaderFilePath);
+    hasher.Add(shaderSource.data(), shaderSource.size());
+    for (const auto& include : includes)
+    {
+        std::string includeSource;
+        ReadFileContents(shadersFolderPath / include, includeSource);
+
+        hasher.Add(include);
+        hasher.Add(includeSource.data(), includeSource.size());
+    }
+    hasher.Add(target);
+    hasher.Add(entryPoint ? entryPoint : L"");
+
+    hash = hasher.GetHash();
+
+    if (pIncludes)
+    {
+        *pIncludes = std::move(includes);
+    }
+
+    return true;
+}
+
+ShaderCache::ShaderCache(const std::wstring& cacheDirectory)
+    : m_Directory(cacheDirectory)
+{
+    std::error_code error;
+    filesystem::create_directories(m_Directory, error);
+}
+
+std::wstring ShaderCache::GetEntryPath(uint64_t key) const
+{
+    wchar_t fileName[32];
+    swprintf(fileName, 32, L"%016llx.dxil", static_cast<unsigned long long>(key));
+
+    return (filesystem::path(m_Directory) / fileName).wstring();
+}
+
+bool ShaderCache::Load(uint64_t key, std::vector<uint8_t>& data)
+{
+    std::ifstream file(filesystem::path(GetEntryPath(key)), std::ios::binary);
+
+    ShaderCacheEntryHeader header = {};
+    if (file.read(reinterpret_cast<char*>(&header), sizeof(header)) && (header.Magic == ShaderCacheEntryMagic) &&
+        (header.Version == ShaderCacheEntryVersion) && (header.Key == key) && (header.Size > 0))
+    {
+        data.resize(static_cast<size_t>(header.Size));
+        if (file.read(reinterpret_cast<char*>(data.data()), data.size()))
+        {
+            ++m_HitCount;
+            return true;
+        }
+    }
+
+    data.clear();
+    ++m_MissCount;
+    return false;
+}
+
+void ShaderCache::Store(uint64_t key, const void* pData, size_t size)
+{
+    const std::wstring entryPath = GetEntryPath(key);
+
+    // Write to a per-thread temporary file first, such that concurrent readers never observe a partially written entry
+    std::wstringstream tempPath;
+    tempPath << entryPath << L"." << std::this_thread::get_id() << L".tmp";
+
+    {
+        std::ofstream file(filesystem::path(tempPath.str()), std::ios::binary | std::ios::trunc);
+        if (!file)
+        {
+            return;
+        }
+
+        const ShaderCacheEntryHeader header = {ShaderCacheEntryMagic, ShaderCacheEntryVersion, key, size};
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(static_cast<const char*>(pData), size);
+    }
+
+    std::error_code error;
+    filesystem::rename(tempPath.str(), entryPath, error);
+    if (error)
+    {
+        filesystem::remove(tempPath.str(), error);
+    }
+}
+
+// Entries are named by GetEntryPath ("<16 hex digits>.dxil"), temporary files left by an interrupted Store append ".<thread id>.tmp"
+static bool IsCacheFileName(const std::wstring& fileName)
+{
+    const size_t keyLength = 16;
+
+    if ((fileName.size() < keyLength) || !std::all_of(fileName.begin(), fileName.begin() + keyLength, [](wchar_t c) { return iswxdigit(c) != 0; }))
+    {
+        return false;
+    }
+
+    const std::wstring suffix     = fileName.substr(keyLength);
+    const std::wstring tempSuffix = L".tmp";
+
+    return (suffix == L".dxil") || ((suffix.rfind(L".dxil.", 0) == 0) && (suffix.size() > tempSuffix.size()) &&
+                                    (suffix.compare(suffix.size() - tempSuffix.size(), tempSuffix.size(), tempSuffix) == 0));
+}
+
+void ShaderCache::Invalidate()
+{
+    // Only the cache's own files are deleted, the directory may be shared with other files, e.g. "." or "bin"
+    std::error_code error;
+    for (const auto& entry : filesystem::directory_iterator(m_Directory, error))
+    {
+        std::error_code entryError;
+        if (entry.is_regular_file(entryError) && IsCacheFileName(entry.path().filename().wstring()))
+        {
+            filesystem::remove(entry.path(), entryError);
+        }
+    }
+
+    m_HitCount  = 0;
+    m_MissCount = 0;
+}
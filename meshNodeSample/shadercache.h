@@ -0,0 +1,123 @@
+// This file is part of the AMD Work Graph Mesh Node Sample.
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * 64-bit FNV-1a hash used to build shader cache keys.
+ */
+class ShaderHasher
+{
+public:
+    void Add(const void* pData, size_t size);
+    void Add(const std::wstring& string);
+    void Add(uint64_t value);
+
+    uint64_t GetHash() const
+    {
+        return m_Hash;
+    }
+
+private:
+    uint64_t m_Hash = 14695981039346656037ull;
+};
+
+/**
+ * Preprocessor define passed to the shader compiler, e.g. to select a quality tier.
+ */
+struct ShaderDefine
+{
+    std::wstring Name;
+    std::wstring Value;
+};
+
+/**
+ * @brief   Canonical string identifying the shader variant compiled with defines, e.g. "A=1;B=2".
+ *          Defines are sorted by name, such that the key does not depend on the order of the define set.
+ *          Returns an empty string for an empty define set.
+ */
+std::wstring GetShaderVariantKey(const std::vector<ShaderDefine>& defines);
+
+/**
+ * @brief   Hash a shader's source, all transitively included files (#include "..."), target & entry point.
+ *          Does not require DXC. Returns false if the shader source file could not be read.
+ *          If pIncludes is set, it receives the sorted file names of all included files.
+ */
+bool ComputeShaderSourceHash(const std::wstring&        shadersDirectory,
+                             const wchar_t*             shaderFilePath,
+                             const wchar_t*             target,
+                             const wchar_t*             entryPoint,
+                             uint64_t&                  hash,
+                             std::vector<std::wstring>* pIncludes = nullptr);
+
+/**
+ * On-disk cache for compiled DXIL blobs.
+ * Entries are stored as individual files named after their 64-bit key inside the cache directory.
+ * Load & Store can be called from multiple threads.
+ */
+class ShaderCache
+{
+public:
+    explicit ShaderCache(const std::wstring& cacheDirectory);
+
+    /**
+     * @brief   Load the blob stored for key. Returns false and counts a miss if no valid entry exists.
+     */
+    bool Load(uint64_t key, std::vector<uint8_t>& data);
+
+    /**
+     * @brief   Store a blob for key. Existing entries are replaced.
+     */
+    void Store(uint64_t key, const void* pData, size_t size);
+
+    /**
+     * @brief   Delete all entries & temporary files left by Store from the cache directory and reset the hit/miss counters.
+     *          Other files and the directory itself are kept.
+     */
+    void Invalidate();
+
+    uint32_t GetHitCount() const
+    {
+        return m_HitCount.load();
+    }
+
+    uint32_t GetMissCount() const
+    {
+        return m_MissCount.load();
+    }
+
+    const std::wstring& GetDirectory() const
+    {
+        return m_Directory;
+    }
+
+private:
+    std::wstring GetEntryPath(uint64_t key) const;
+
+    std::wstring          m_Directory;
+    std::atomic<uint32_t> m_HitCount  = {0};
+    std::atomic<uint32_t> m_MissCount = {0};
+};
@@ -20,13 +20,59 @@
 // THE SOFTWARE.
 
 #include "shadercompiler.h"
+#include "shadercache.h"
 
+#ifdef MESHNODE_STANDALONE
+#include <cwchar>
+#include <stdexcept>
+
+// Standalone tools are built without Cauldron, critical errors are raised as exceptions instead
+namespace cauldron
+{
+    enum AssertLevel
+    {
+        ASSERT_CRITICAL
+    };
+
+    template <typename... Args>
+    [[noreturn]] void CauldronCritical(const wchar_t* format, Args... args)
+    {
+        std::vector<wchar_t> message(4096);
+        swprintf(message.data(), message.size(), format, args...);
+
+        // file & shader names are ASCII, compiler output is truncated to ASCII
+        std::string narrowMessage;
+        for (const wchar_t* c = message.data(); *c != 0; ++c)
+        {
+            narrowMessage += (*c < 0x80) ? static_cast<char>(*c) : '?';
+        }
+
+        throw std::runtime_error(narrowMessage);
+    }
+
+    template <typename T>
+    void CauldronAssert(AssertLevel, const T& condition, const wchar_t* message)
+    {
+        if (!condition)
+        {
+            CauldronCritical(L"%ls", message);
+        }
+    }
+}  // namespace cauldron
+#else
 #include "misc/assert.h"
+#endif  // MESHNODE_STANDALONE
+
+#include <filesystem>
+namespace filesystem = std::filesystem;
 
-#define _SILENCE_EXPERIMENTAL_FILESYSTEM_DEPRECATION_WARNING  // To avoid receiving deprecation error since we are using \
-                                                              // C++11 only
-#include <experimental/filesystem>
-using namespace std::experimental;
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <sstream>
+#include <thread>
+#include <vector>
 
 template <class Interface>
 inline void SafeRelease(Interface*& pInterfaceToRelease)
@@ -39,16 +85,69 @@ inline void SafeRelease(Interface*& pInterfaceToRelease)
     }
 }
 
-ShaderCompiler::ShaderCompiler()
+#ifdef _WIN32
+// Include handler forwarding to the default DXC include handler while recording the names of all included files.
+// Only used on the stack for a single compilation, thus reference counting is a no-op.
+class RecordingIncludeHandler : public IDxcIncludeHandler
 {
-    HMODULE dxilModule       = LoadLibraryW(L"dxil.dll");
-    HMODULE dxcompilerModule = LoadLibraryW(L"dxcompiler.dll");
+public:
+    RecordingIncludeHandler(IDxcIncludeHandler* pIncludeHandler, std::vector<std::wstring>& includes)
+        : m_pIncludeHandler(pIncludeHandler)
+        , m_Includes(includes)
+    {
+    }
+
+    HRESULT STDMETHODCALLTYPE LoadSource(LPCWSTR pFilename, IDxcBlob** ppIncludeSource) override
+    {
+        // shaders folder is flat, thus file name is sufficient to identify an include
+        const std::wstring includeName = filesystem::path(pFilename).filename().wstring();
+        if (std::find(m_Includes.begin(), m_Includes.end(), includeName) == m_Includes.end())
+        {
+            m_Includes.push_back(includeName);
+        }
+
+        return m_pIncludeHandler->LoadSource(pFilename, ppIncludeSource);
+    }
+
+    HRESULT STDMETHODCALLTYPE QueryInterface(REFIID riid, void** ppvObject) override
+    {
+        if ((riid == __uuidof(IDxcIncludeHandler)) || (riid == __uuidof(IUnknown)))
+        {
+            *ppvObject = static_cast<IDxcIncludeHandler*>(this);
+            return S_OK;
+        }
 
-    cauldron::CauldronAssert(cauldron::ASSERT_CRITICAL, dxcompilerModule, L"Failed to load dxcompiler.dll");
+        *ppvObject = nullptr;
+        return E_NOINTERFACE;
+    }
+
+    ULONG STDMETHODCALLTYPE AddRef() override
+    {
+        return 1;
+    }
 
-    DxcCreateInstanceProc pfnDxcCreateInstance = DxcCreateInstanceProc(GetProcAddress(dxcompilerModule, "DxcCreateInstance"));
+    ULONG STDMETHODCALLTYPE Release() override
+    {
+        return 1;
+    }
 
-    cauldron::CauldronAssert(cauldron::ASSERT_CRITICAL, pfnDxcCreateInstance, L"Failed to load DxcCreateInstance from dxcompiler.dll");
+private:
+    IDxcIncludeHandler*        m_pIncludeHandler = nullptr;
+    std::vector<std::wstring>& m_Includes;
+};
+#endif  // _WIN32
+
+ShaderCompiler::ShaderCompiler(ShaderCache* pCache, const std::wstring& shadersDirectory)
+    : m_pCache(pCache)
+    , m_ShadersDirectory(shadersDirectory)
+{
+    std::wstring          errorString;
+    DxcCreateInstanceProc pfnDxcCreateInstance = DxcLibrary::GetCreateInstanceProc(errorString);
+
+    if (pfnDxcCreateInstance == nullptr)
+    {
+        cauldron::CauldronCritical(L"%ls", errorString.c_str());
+    }
 
     if (FAILED(pfnDxcCreateInstance(CLSID_DxcUtils, IID_PPV_ARGS(&m_pUtils))))
     {
@@ -71,6 +170,35 @@ ShaderCompiler::ShaderCompiler()
 
         cauldron::CauldronCritical(L"Failed to create DXC compiler");
     }
+
+    // Query compiler version for shader cache keys
+    {
+        std::wstringstream version;
+
+        IDxcVersionInfo* versionInfo = nullptr;
+        if (SUCCEEDED(m_pCompiler->QueryInterface(IID_PPV_ARGS(&versionInfo))))
+        {
+            UINT32 major = 0, minor = 0;
+            versionInfo->GetVersion(&major, &minor);
+            version << major << L"." << minor;
+        }
+        SafeRelease(versionInfo);
+
+        IDxcVersionInfo2* versionInfo2 = nullptr;
+        if (SUCCEEDED(m_pCompiler->QueryInterface(IID_PPV_ARGS(&versionInfo2))))
+        {
+            UINT32 commitCount = 0;
+            char*  commitHash  = nullptr;
+            if (SUCCEEDED(versionInfo2->GetCommitInfo(&commitCount, &commitHash)))
+            {
+                version << L"." << commitCount << L"-" << commitHash;
+                CoTaskMemFree(commitHash);
+            }
+        }
+        SafeRelease(versionInfo2);
+
+        m_CompilerVersion = version.str();
+    }
 }
 
 ShaderCompiler::~ShaderCompiler()
@@ -80,18 +208,32 @@ ShaderCompiler::~ShaderCompiler()
     SafeRelease(m_pUtils);
 }
 
-IDxcBlob* ShaderCompiler::CompileShader(const wchar_t* shaderFilePath, const wchar_t* target, const wchar_t* entryPoint)
+IDxcBlob* ShaderCompiler::CompileShader(const wchar_t*                   shaderFilePath,
+                                        const wchar_t*                   target,
+                                        const wchar_t*                   entryPoint,
+                                        const std::vector<ShaderDefine>& defines,
+                                        std::vector<std::wstring>*       pIncludes)
 {
-    IDxcBlobEncoding* source = nullptr;
+    std::wstring errorString;
 
-    const auto shaderSourceFilePath = std::wstring(L"Shaders\\") + shaderFilePath;
-
-    if (FAILED(m_pUtils->LoadFile(shaderSourceFilePath.c_str(), nullptr, &source)) || (source == nullptr))
+    IDxcBlob* blob = TryCompileShader(shaderFilePath, target, entryPoint, defines, errorString, pIncludes);
+    if (blob == nullptr)
     {
-        cauldron::CauldronCritical(L"Failed to load %s", shaderFilePath);
+        cauldron::CauldronCritical(L"%ls", errorString.c_str());
     }
 
-    const auto shadersFolderPath     = filesystem::current_path() / L"shaders";
+    return blob;
+}
+
+IDxcBlob* ShaderCompiler::TryCompileShader(const wchar_t*                   shaderFilePath,
+                                           const wchar_t*                   target,
+                                           const wchar_t*                   entryPoint,
+                                           const std::vector<ShaderDefine>& defines,
+                                           std::wstring&                    errorString,
+                                           std::vector<std::wstring>*       pIncludes)
+{
+    const auto shadersFolderPath     = filesystem::absolute(m_ShadersDirectory);
+    const auto shaderSourceFilePath  = (shadersFolderPath / shaderFilePath).wstring();
     const auto shaderIncludeArgument = std::wstring(L"-I") + shadersFolderPath.wstring();
 
     std::vector<const wchar_t*> arguments = {
@@ -101,22 +243,110 @@ IDxcBlob* ShaderCompiler::CompileShader(const wchar_t* shaderFilePath, const wch
         L"2021",
         // column major matrices
         DXC_ARG_PACK_MATRIX_COLUMN_MAJOR,
-        // include path for "shaders" folder
-        shaderIncludeArgument.c_str(),
     };
 
+    // Compute cache key from source hash (source, all included files, target & entry point), arguments, variant key & compiler version
+    uint64_t cacheKey = 0;
+    if (m_pCache)
+    {
+        uint64_t                  sourceHash = 0;
+        std::vector<std::wstring> includes;
+        if (!ComputeShaderSourceHash(m_ShadersDirectory, shaderFilePath, target, entryPoint, sourceHash, &includes))
+        {
+            errorString = L"Failed to load " + std::wstring(shaderFilePath);
+            return nullptr;
+        }
+
+        ShaderHasher hasher;
+        hasher.Add(sourceHash);
+        for (const auto* argument : arguments)
+        {
+            hasher.Add(argument);
+        }
+        hasher.Add(GetShaderVariantKey(defines));
+        hasher.Add(m_CompilerVersion);
+
+        cacheKey = hasher.GetHash();
+
+        std::vector<uint8_t> cachedBlob;
+        if (m_pCache->Load(cacheKey, cachedBlob))
+        {
+            IDxcBlobEncoding* blob = nullptr;
+            if (SUCCEEDED(m_pUtils->CreateBlob(cachedBlob.data(), static_cast<UINT32>(cachedBlob.size()), DXC_CP_ACP, &blob)))
+            {
+                if (pIncludes)
+                {
+                    // DXC was not invoked, use scanned includes instead
+                    *pIncludes = includes;
+                }
+
+                return blob;
+            }
+        }
+    }
+
+    // include path for "shaders" folder
+    // The include path depends on the working directory and is thus not part of the cache key.
+    arguments.push_back(shaderIncludeArgument.c_str());
+
+    IDxcBlobEncoding* source = nullptr;
+
+    if (FAILED(m_pUtils->LoadFile(shaderSourceFilePath.c_str(), nullptr, &source)) || (source == nullptr))
+    {
+        errorString = L"Failed to load " + std::wstring(shaderFilePath);
+        return nullptr;
+    }
+
+    std::vector<std::wstring> includes;
+#ifdef _WIN32
+    // record all files opened by DXC
+    RecordingIncludeHandler includeHandler(m_pIncludeHandler, includes);
+    IDxcIncludeHandler*     pIncludeHandler = &includeHandler;
+#else
+    // Implementing COM interfaces outside of DXC requires the IUnknown implementation from WinAdapter, which is not exported by libdxcompiler.so.
+    // Includes are scanned from the source instead.
+    IDxcIncludeHandler* pIncludeHandler = m_pIncludeHandler;
+    if (pIncludes)
+    {
+        uint64_t sourceHash = 0;
+        ComputeShaderSourceHash(m_ShadersDirectory, shaderFilePath, target, entryPoint, sourceHash, &includes);
+    }
+#endif  // _WIN32
+
+    std::vector<DxcDefine> dxcDefines;
+    for (const auto& define : defines)
+    {
+        dxcDefines.push_back({define.Name.c_str(), define.Value.c_str()});
+    }
+
     IDxcOperationResult* result = nullptr;
-    const auto           hr     = m_pCompiler->Compile(
-        source, shaderFilePath, entryPoint, target, arguments.data(), static_cast<UINT32>(arguments.size()), nullptr, 0, m_pIncludeHandler, &result);
+    const auto           hr     = m_pCompiler->Compile(source,
+                                             shaderFilePath,
+                                             entryPoint,
+                                             target,
+                                             arguments.data(),
+                                             static_cast<UINT32>(arguments.size()),
+                                             dxcDefines.data(),
+                                             static_cast<UINT32>(dxcDefines.size()),
+                                             pIncludeHandler,
+                                             &result);
 
     // release source blob
     SafeRelease(source);
 
+    if (pIncludes)
+    {
+        // includes are also returned for failed compilations, such that hot-reload can track them
+        std::sort(includes.begin(), includes.end());
+        *pIncludes = includes;
+    }
+
     if (FAILED(hr))
     {
         SafeRelease(result);
 
-        cauldron::CauldronCritical(L"Failed to compile shader %s", shaderFilePath);
+        errorString = L"Failed to compile shader " + std::wstring(shaderFilePath);
+        return nullptr;
     }
 
     HRESULT compileStatus;
@@ -124,10 +354,11 @@ IDxcBlob* ShaderCompiler::CompileShader(const wchar_t* shaderFilePath, const wch
     {
         SafeRelease(result);
 
-        cauldron::CauldronCritical(L"Failed to get compilation status for shader %s", shaderFilePath);
+        errorString = L"Failed to get compilation status for shader " + std::wstring(shaderFilePath);
+        return nullptr;
     }
 
-    std::wstring errorString = L"";
+    std::wstring compilerOutput = L"";
 
     // try get error string from DXC result
     {
@@ -137,7 +368,7 @@ IDxcBlob* ShaderCompiler::CompileShader(const wchar_t* shaderFilePath, const wch
             IDxcBlobWide* errorStringBlob16 = nullptr;
             m_pUtils->GetBlobAsUtf16(errorStringBlob, &errorStringBlob16);
 
-            errorString = std::wstring(errorStringBlob16->GetStringPointer(), errorStringBlob16->GetStringLength());
+            compilerOutput = std::wstring(errorStringBlob16->GetStringPointer(), errorStringBlob16->GetStringLength());
 
             SafeRelease(errorStringBlob16);
         }
@@ -148,7 +379,8 @@ IDxcBlob* ShaderCompiler::CompileShader(const wchar_t* shaderFilePath, const wch
     {
         SafeRelease(result);
 
-        cauldron::CauldronCritical(L"Failed to compile shader %s\n%s", shaderFilePath, errorString.c_str());
+        errorString = L"Failed to compile shader " + std::wstring(shaderFilePath) + L"\n" + compilerOutput;
+        return nullptr;
     }
 
     IDxcBlob* outputBlob = nullptr;
@@ -156,10 +388,102 @@ IDxcBlob* ShaderCompiler::CompileShader(const wchar_t* shaderFilePath, const wch
     {
         SafeRelease(result);
 
-        cauldron::CauldronCritical(L"Failed to get binary shader blob for shader %s", shaderFilePath);
+        errorString = L"Failed to get binary shader blob for shader " + std::wstring(shaderFilePath);
+        return nullptr;
     }
 
     SafeRelease(result);
 
+    if (m_pCache)
+    {
+        m_pCache->Store(cacheKey, outputBlob->GetBufferPointer(), outputBlob->GetBufferSize());
+    }
+
     return outputBlob;
-}
\ No newline at end of file
+}
+
+double CompileShadersParallel(std::vector<ShaderCompileJob>& jobs,
+                              ShaderCache*                   pCache,
+                              bool                           abortOnError,
+                              const std::wstring&            shadersDirectory,
+                              uint32_t                       maxWorkerCount)
+{
+    // Nothing to compile, e.g. all shaders were loaded from a shader archive. Skip loading DXC entirely.
+    if (jobs.empty())
+    {
+        return 0.0;
+    }
+
+    const auto startTime = std::chrono::high_resolution_clock::now();
+
+    const uint32_t jobCount    = static_cast<uint32_t>(jobs.size());
+    const uint32_t threadCount = (maxWorkerCount > 0) ? maxWorkerCount : std::thread::hardware_concurrency();
+    const uint32_t workerCount = std::max(1u, std::min(threadCount, jobCount));
+
+    std::atomic<uint32_t> nextJobIndex = {0};
+
+    // first exception raised by any worker, remaining workers stop picking up new jobs
+    std::exception_ptr workerException = nullptr;
+    std::atomic<bool>  workerFailed    = {false};
+
+    const auto Worker = [&]() {
+        try
+        {
+            // DXC compiler instances are not thread-safe, thus every worker uses its own
+            ShaderCompiler compiler(pCache, shadersDirectory);
+
+            for (uint32_t jobIndex = nextJobIndex++; (jobIndex < jobCount) && !workerFailed; jobIndex = nextJobIndex++)
+            {
+                auto& job = jobs[jobIndex];
+
+                const auto jobStartTime = std::chrono::high_resolution_clock::now();
+                job.StartTime           = jobStartTime;
+                job.ThreadId            = std::this_thread::get_id();
+
+                if (abortOnError)
+                {
+                    job.pBlob = compiler.CompileShader(job.ShaderFilePath, job.Target, job.EntryPoint, job.Defines, &job.Includes);
+                }
+                else
+                {
+                    job.pBlob = compiler.TryCompileShader(job.ShaderFilePath, job.Target, job.EntryPoint, job.Defines, job.Error, &job.Includes);
+                }
+
+                job.CompileTimeMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - jobStartTime).count();
+            }
+        }
+        catch (...)
+        {
+            if (!workerFailed.exchange(true))
+            {
+                workerException = std::current_exception();
+            }
+        }
+    };
+
+    // calling thread acts as first worker
+    std::vector<std::thread> workers;
+    for (uint32_t i = 1; i < workerCount; ++i)
+    {
+        workers.emplace_back(Worker);
+    }
+    Worker();
+
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+
+    if (workerException)
+    {
+        // release blobs of successful jobs before propagating the error
+        for (auto& job : jobs)
+        {
+            SafeRelease(job.pBlob);
+        }
+
+        std::rethrow_exception(workerException);
+    }
+
+    return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+}
@@ -21,25 +21,90 @@
 
 #pragma once
 
-// windows headers
-#define WIN32_LEAN_AND_MEAN
-#include <windows.h>
-// for BSTR typedef
-#include <dxgi.h>
+// DXC header & platform specific DXC loading
+#include "dxclibrary.h"
+// ShaderDefine & ShaderCache
+#include "shadercache.h"
 
-// DXC header
-#include <dxcapi.h>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Single shader compilation for CompileShadersParallel.
+ * pBlob, Includes, Error, CompileTimeMs, StartTime & ThreadId are filled in by the compilation. The caller is responsible for releasing pBlob.
+ */
+struct ShaderCompileJob
+{
+    const wchar_t* ShaderFilePath = nullptr;
+    const wchar_t* Target         = nullptr;
+    const wchar_t* EntryPoint     = nullptr;
+    // Define set selecting the shader variant, e.g. the quality tier
+    std::vector<ShaderDefine> Defines;
+
+    IDxcBlob*                 pBlob = nullptr;
+    std::vector<std::wstring> Includes;
+    std::wstring              Error;
+    double                    CompileTimeMs = 0.0;
+    // when & on which worker thread the job was compiled, e.g. for startup timelines
+    std::chrono::high_resolution_clock::time_point StartTime;
+    std::thread::id                                ThreadId;
+};
 
 class ShaderCompiler
 {
 public:
-    ShaderCompiler();
+    /**
+     * @brief   Create DXC instances, see DxcLibrary for loading DXC. If pCache is set, compiled shaders are looked up in & stored to this cache.
+     *          Shader file paths & includes are resolved relative to shadersDirectory.
+     */
+    ShaderCompiler(ShaderCache* pCache = nullptr, const std::wstring& shadersDirectory = L"shaders");
     ~ShaderCompiler();
 
-    IDxcBlob* CompileShader(const wchar_t* shaderFilePath, const wchar_t* target, const wchar_t* entryPoint);
+    /**
+     * @brief   Compile a shader from the shaders folder with the given define set. On a cache hit the DXIL blob is returned without invoking DXC.
+     *          The variant key of the define set (see GetShaderVariantKey) is part of the cache key.
+     *          If pIncludes is set, it receives the file names of all files included by the shader.
+     */
+    IDxcBlob* CompileShader(const wchar_t*                   shaderFilePath,
+                            const wchar_t*                   target,
+                            const wchar_t*                   entryPoint,
+                            const std::vector<ShaderDefine>& defines   = {},
+                            std::vector<std::wstring>*       pIncludes = nullptr);
+
+    /**
+     * @brief   Same as CompileShader, but returns nullptr and the compiler output in errorString instead of raising a critical error.
+     */
+    IDxcBlob* TryCompileShader(const wchar_t*                   shaderFilePath,
+                               const wchar_t*                   target,
+                               const wchar_t*                   entryPoint,
+                               const std::vector<ShaderDefine>& defines,
+                               std::wstring&                    errorString,
+                               std::vector<std::wstring>*       pIncludes = nullptr);
 
 private:
     IDxcUtils*          m_pUtils          = nullptr;
     IDxcCompiler*       m_pCompiler       = nullptr;
     IDxcIncludeHandler* m_pIncludeHandler = nullptr;
-};
\ No newline at end of file
+
+    ShaderCache* m_pCache = nullptr;
+    std::wstring m_ShadersDirectory;
+    // DXC version & commit, part of every cache key
+    std::wstring m_CompilerVersion;
+};
+
+/**
+ * @brief   Compile all jobs on a pool of worker threads, each owning its own ShaderCompiler (DXC instance).
+ *          Returns once all jobs are finished. Errors raised on a worker are rethrown on the calling thread.
+ *          If abortOnError is false, failed jobs instead report the compiler output in ShaderCompileJob::Error and a null blob.
+ *          No DXC instance is created if jobs is empty.
+ *          maxWorkerCount limits the number of worker threads, 0 uses one worker per hardware thread.
+ *
+ * @return  Wall-clock time in milliseconds spent compiling all jobs.
+ */
+double CompileShadersParallel(std::vector<ShaderCompileJob>& jobs,
+                              ShaderCache*                   pCache           = nullptr,
+                              bool                           abortOnError     = true,
+                              const std::wstring&            shadersDirectory = L"shaders",
+                              uint32_t                       maxWorkerCount   = 0);
\ No newline at end of file
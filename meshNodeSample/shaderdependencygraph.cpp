@@ -0,0 +1,96 @@
+// This file is part of the AMD Work Graph Mesh Node Sample.
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include "shaderdependencygraph.h"
+
+void ShaderDependencyGraph::SetDependencies(const std::wstring& shader, const std::vector<std::wstring>& files)
+{
+    RemoveShader(shader);
+
+    auto& dependencies = m_Dependencies[shader];
+    for (const auto& file : files)
+    {
+        dependencies.insert(file);
+        m_Dependents[file].insert(shader);
+    }
+}
+
+void ShaderDependencyGraph::RemoveShader(const std::wstring& shader)
+{
+    const auto it = m_Dependencies.find(shader);
+    if (it == m_Dependencies.end())
+    {
+        return;
+    }
+
+    for (const auto& file : it->second)
+    {
+        auto dependents = m_Dependents.find(file);
+        dependents->second.erase(shader);
+
+        if (dependents->second.empty())
+        {
+            m_Dependents.erase(dependents);
+        }
+    }
+
+    m_Dependencies.erase(it);
+}
+
+std::vector<std::wstring> ShaderDependencyGraph::GetDirtyShaders(const std::vector<std::wstring>& changedFiles) const
+{
+    std::set<std::wstring> dirtyShaders;
+    for (const auto& file : changedFiles)
+    {
+        const auto it = m_Dependents.find(file);
+        if (it != m_Dependents.end())
+        {
+            dirtyShaders.insert(it->second.begin(), it->second.end());
+        }
+    }
+
+    return std::vector<std::wstring>(dirtyShaders.begin(), dirtyShaders.end());
+}
+
+std::vector<std::wstring> ShaderDependencyGraph::GetDependentShaders(const std::wstring& file) const
+{
+    const auto it = m_Dependents.find(file);
+    if (it == m_Dependents.end())
+    {
+        return {};
+    }
+
+    return std::vector<std::wstring>(it->second.begin(), it->second.end());
+}
+
+std::vector<std::wstring> ShaderDependencyGraph::GetFiles() const
+{
+    std::vector<std::wstring> files;
+    files.reserve(m_Dependents.size());
+
+    for (const auto& dependents : m_Dependents)
+    {
+        files.push_back(dependents.first);
+    }
+
+    return files;
+}
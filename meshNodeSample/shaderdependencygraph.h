@@ -0,0 +1,68 @@
+// This file is part of the AMD Work Graph Mesh Node Sample.
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#pragma once
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+/**
+ * Tracks which source files each shader depends on.
+ * Shaders are identified by an arbitrary name (e.g. file, target & entry point), files by their name inside the shaders folder.
+ * Does not depend on DXC or D3D12, such that the dirty-shader logic can be tested in isolation, see "MeshNodeCpuTool dependencies".
+ */
+class ShaderDependencyGraph
+{
+public:
+    /**
+     * @brief   Replace all dependencies of a shader. The shader source file itself should be part of files.
+     */
+    void SetDependencies(const std::wstring& shader, const std::vector<std::wstring>& files);
+
+    /**
+     * @brief   Remove a shader and all its dependencies.
+     */
+    void RemoveShader(const std::wstring& shader);
+
+    /**
+     * @brief   Get all shaders that depend on at least one of the changed files, sorted by name.
+     */
+    std::vector<std::wstring> GetDirtyShaders(const std::vector<std::wstring>& changedFiles) const;
+
+    /**
+     * @brief   Get all shaders that depend on file, sorted by name.
+     */
+    std::vector<std::wstring> GetDependentShaders(const std::wstring& file) const;
+
+    /**
+     * @brief   Get union of all files any shader depends on, sorted by name.
+     */
+    std::vector<std::wstring> GetFiles() const;
+
+private:
+    // shader -> files
+    std::map<std::wstring, std::set<std::wstring>> m_Dependencies;
+    // file -> shaders, reverse of m_Dependencies
+    std::map<std::wstring, std::set<std::wstring>> m_Dependents;
+};
@@ -0,0 +1,135 @@
+// This file is part of the AMD Work Graph Mesh Node Sample.
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include "shaderfilewatcher.h"
+
+#include <filesystem>
+namespace filesystem = std::filesystem;
+
+#include <algorithm>
+#include <chrono>
+
+static int64_t GetModificationTime(const filesystem::path& path)
+{
+    std::error_code error;
+    const auto      time = filesystem::last_write_time(path, error);
+
+    return error ? 0 : static_cast<int64_t>(time.time_since_epoch().count());
+}
+
+ShaderFileWatcher::ShaderFileWatcher(const std::wstring& directory, uint32_t pollIntervalMs)
+    : m_Directory(directory)
+    , m_PollIntervalMs(pollIntervalMs)
+{
+    m_Thread = std::thread(&ShaderFileWatcher::Run, this);
+}
+
+ShaderFileWatcher::~ShaderFileWatcher()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Stop = true;
+    }
+    m_StopCondition.notify_all();
+
+    m_Thread.join();
+}
+
+void ShaderFileWatcher::SetWatchedFiles(const std::vector<std::wstring>& files)
+{
+    // Query initial modification times outside of the lock
+    std::map<std::wstring, int64_t> watchedFiles;
+    for (const auto& file : files)
+    {
+        watchedFiles[file] = GetModificationTime(filesystem::path(m_Directory) / file);
+    }
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    // keep modification time of files that are already watched, such that no change is lost
+    for (auto& watchedFile : watchedFiles)
+    {
+        const auto it = m_WatchedFiles.find(watchedFile.first);
+        if (it != m_WatchedFiles.end())
+        {
+            watchedFile.second = it->second;
+        }
+    }
+
+    m_WatchedFiles = std::move(watchedFiles);
+}
+
+std::vector<std::wstring> ShaderFileWatcher::GetChangedFiles()
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    std::vector<std::wstring> changedFiles;
+    std::swap(changedFiles, m_ChangedFiles);
+
+    std::sort(changedFiles.begin(), changedFiles.end());
+    changedFiles.erase(std::unique(changedFiles.begin(), changedFiles.end()), changedFiles.end());
+
+    return changedFiles;
+}
+
+void ShaderFileWatcher::Run()
+{
+    std::unique_lock<std::mutex> lock(m_Mutex);
+
+    while (!m_StopCondition.wait_for(lock, std::chrono::milliseconds(m_PollIntervalMs), [this]() { return m_Stop; }))
+    {
+        lock.unlock();
+        Poll();
+        lock.lock();
+    }
+}
+
+void ShaderFileWatcher::Poll()
+{
+    std::vector<std::wstring> files;
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        for (const auto& watchedFile : m_WatchedFiles)
+        {
+            files.push_back(watchedFile.first);
+        }
+    }
+
+    // Query modification times without holding the lock
+    std::vector<int64_t> modificationTimes;
+    for (const auto& file : files)
+    {
+        modificationTimes.push_back(GetModificationTime(filesystem::path(m_Directory) / file));
+    }
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    for (size_t i = 0; i < files.size(); ++i)
+    {
+        const auto it = m_WatchedFiles.find(files[i]);
+        // file might have been removed from watch list while polling
+        if ((it != m_WatchedFiles.end()) && (it->second != modificationTimes[i]))
+        {
+            it->second = modificationTimes[i];
+            m_ChangedFiles.push_back(files[i]);
+        }
+    }
+}
@@ -0,0 +1,68 @@
+// This file is part of the AMD Work Graph Mesh Node Sample.
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Polls the modification time of a set of files inside a directory on a background thread.
+ */
+class ShaderFileWatcher
+{
+public:
+    ShaderFileWatcher(const std::wstring& directory, uint32_t pollIntervalMs);
+    ~ShaderFileWatcher();
+
+    /**
+     * @brief   Replace the set of watched files. Files are given relative to the watched directory.
+     */
+    void SetWatchedFiles(const std::vector<std::wstring>& files);
+
+    /**
+     * @brief   Return & clear all files modified since the last call, sorted by name.
+     */
+    std::vector<std::wstring> GetChangedFiles();
+
+private:
+    void Run();
+    void Poll();
+
+    std::wstring m_Directory;
+    uint32_t     m_PollIntervalMs = 0;
+
+    std::mutex              m_Mutex;
+    std::condition_variable m_StopCondition;
+    bool                    m_Stop = false;
+
+    // last seen modification time per watched file, 0 if the file does not exist
+    std::map<std::wstring, int64_t> m_WatchedFiles;
+    std::vector<std::wstring>       m_ChangedFiles;
+
+    std::thread m_Thread;
+};
@@ -93,7 +93,7 @@ static const int numOutputTriangleIterations = (numOutputTriangles + (beeGroupSi
 // and you are running on a non-AMD GPU, you may need to adjust this limit.
 // You can learn more at: 
 // https://gpuopen.com/learn/work_graphs_mesh_nodes/work_graphs_mesh_nodes-tips_tricks_best_practices
-[NodeMaxInputRecordsPerGraphEntryRecord(20, true)]
+[NodeMaxInputRecordsPerGraphEntryRecord(drawBeesMaxInputRecords, true)]
 [NumThreads(beeGroupSize, 1, 1)]
 [OutputTopology("triangle")]
 void BeeMeshShader(
@@ -108,8 +108,9 @@ void BeeMeshShader(
     const int triangleCount = numBees * numBeeTriangles;
 
     SetMeshOutputCounts(vertexCount, triangleCount);
+    CountGenerationMeshGroup(generationNodeDrawBees, gtid, gid == 0, inputRecord.Get().dispatchGrid.x, vertexCount, triangleCount);
 
-    const float3 patchCenter = inputRecord.Get().position[gid];
+    const float3 patchCenter = DecodeRecordPosition(inputRecord.Get().position[gid], inputRecord.Get().origin);
     const int    seed        = CombineSeed(asuint(patchCenter.x), asuint(patchCenter.z));
 
     [[unroll]]
@@ -145,7 +146,7 @@ void BeeMeshShader(
             // slowly scale insects to 0 in the distance
             // for simplicity, we omit this scaling from the motion vector, as it only affects very distant insects
             const float distanceScale =
-                smoothstep(beeFadeStartDistance, beeMaxDistance, distance(patchCenter, GetCameraPosition()));
+                smoothstep(GetBeeFadeStartDistance(), GetBeeMaxDistance(), distance(patchCenter, GetCameraPosition()));
 
             const float scale = (.01 + 0.03 * Random(seed, insectId, 8)) * (1 - nightScale) * (1 - distanceScale);
 
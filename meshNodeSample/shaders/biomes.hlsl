@@ -51,6 +51,8 @@ void MountainTile(
     [NodeId("GenerateTree", 1)]
     NodeOutput<GenerateTreeRecord> treeOutput)
 {
+    CountGenerationGroup(generationNodeMountainTile, groupThreadId.y * detailedTilesPerTile + groupThreadId.x, true, 1);
+
     // clear groupshared counters
     terrainGradient = 0;
 
@@ -104,7 +106,7 @@ void MountainTile(
     {
         const uint seed = CombineSeed(asuint(threadGridPosition.x), asuint(threadGridPosition.y));
 
-        const float3 biomeWeight   = GetBiomeWeights(threadWorldPosition);
+        // slope is tested at the detailed tile corner, the rock is placed at its center
         const float3 terrainNormal = GetTerrainNormal(threadWorldPosition);
 
         const bool hasRockOutput =
@@ -131,15 +133,16 @@ bool HasTree(in int2 detailedTileGridPosition, out int outTreeType, out float2 o
 
     const uint seed = CombineSeed(asuint(detailedTileGridPosition.x), asuint(detailedTileGridPosition.y));
 
-    const float3 biomeWeight = GetBiomeWeights(detailedTileWorldPosition);
+    // biome weights & normal from a single terrain evaluation
+    const TerrainSample terrainSample = GetTerrainSample(detailedTileWorldPosition);
+    const float3        biomeWeight   = terrainSample.biomeWeights;
+    const float3        terrainNormal = terrainSample.normal;
 
     // check if woodlands is the dominant biome
     if ((biomeWeight.y < biomeWeight.x) || (biomeWeight.y < biomeWeight.z)) {
         return false;
     }
 
-    const float3 terrainNormal = GetTerrainNormal(detailedTileWorldPosition);
-
     const float2 randomOffset = float2(Random(seed, 82347), Random(seed, 9780));
 
     outTreeType     = ((biomeWeight.x > 0.4) || (terrainNormal.y < 0.85)) ? 1 : 0;
@@ -178,6 +181,8 @@ void WoodlandTile(
     [NodeId("DrawSparseGrassPatch")]
     NodeOutput<DrawSparseGrassRecord> sparseGrassOutput)
 {
+    CountGenerationGroup(generationNodeWoodlandTile, groupThreadId.y * detailedTilesPerTile + groupThreadId.x, true, 1);
+
     // clear groupshared counters
     sparseGrassPatchCount = 0;
     mushroomPatchCount    = 0;
@@ -195,8 +200,10 @@ void WoodlandTile(
     const float3 threadCenterCurvedWorldPosition = GetCurvedWorldSpacePosition(threadCenterWorldPosition);
     const float  centerDistanceToCamera          = distance(GetCameraPosition(), threadCenterWorldPosition);
 
-    const AxisAlignedBoundingBox threadBoundingBox =
-        GetGridBoundingBox(threadGridPosition, detailedTileSize, -100, 300);
+    const AxisAlignedBoundingBox threadBoundingBox = GetCurvedGridBoundingBox(threadGridPosition,
+                                                                              detailedTileSize,
+                                                                              threadCenterWorldPosition.y + detailedTileMinHeightOffset,
+                                                                              threadCenterWorldPosition.y + detailedTileMaxHeightOffset);
     const bool isThreadVisible = threadBoundingBox.IsVisible(ComputeClipPlanes());
 
     const uint seed = CombineSeed(asuint(threadGridPosition.x), asuint(threadGridPosition.y));
@@ -213,8 +220,8 @@ void WoodlandTile(
         }
 
         // --- distance cull ---
-        if (((centerDistanceToCamera + radius) < denseGrassMaxDistance) ||
-            ((centerDistanceToCamera + radius) > sparseGrassMaxDistance))
+        if (((centerDistanceToCamera + radius) < GetDenseGrassMaxDistance()) ||
+            ((centerDistanceToCamera + radius) > GetSparseGrassMaxDistance()))
         {
             hasOutput = false;
         }
@@ -232,11 +239,12 @@ void WoodlandTile(
 
         if (all(groupThreadId == 0) && sparseGrassPatchCount > 0) {
             sparseGrassRecord.Get().dispatchGrid = uint3(sparseGrassPatchCount, sparseGrassThreadGroupsPerRecord, 1);
+            sparseGrassRecord.Get().origin       = tileGridPosition * detailedTilesPerTile;
         }
 
         if (hasOutput) {
             // XZ-position
-            sparseGrassRecord.Get().position[outputIndex] = threadGridPosition;
+            sparseGrassRecord.Get().position[outputIndex] = int16_t2(groupThreadId);
         }
 
         sparseGrassRecord.OutputComplete();
@@ -259,7 +267,7 @@ void WoodlandTile(
 
         // Place mushrooms under each tree
         const bool hasMushroomOutput =
-            hasTreeOutput && (centerDistanceToCamera < (mushroomMaxDistance * 1.5 + (detailedTileSize * 2)));
+            hasTreeOutput && (centerDistanceToCamera < (GetMushroomMaxDistance() * 1.5 + (detailedTileSize * 2)));
         // Select random number of mushrooms to generate
         const int mushroomOutputCount =
             hasMushroomOutput * round(lerp(1, maxMushroomsPerDetailedTile, Random(seed, 67823)));
@@ -277,6 +285,7 @@ void WoodlandTile(
 
         if (all(groupThreadId == 0) && mushroomPatchCount > 0) {
             mushroomRecord.Get().dispatchGrid = uint3(mushroomPatchCount, 1, 1);
+            mushroomRecord.Get().origin       = tileWorldPosition;
         }
 
         for (int mushroomIndex = 0; mushroomIndex < mushroomOutputCount; ++mushroomIndex) {
@@ -290,7 +299,7 @@ void WoodlandTile(
                 float2(cos(mushroomOffsetAngle), sin(mushroomOffsetAngle)) * mushroomOffsetRadius;
 
             mushroomRecord.Get().position[mushroomOutputIndex + mushroomIndex] =
-                GetTerrainPosition(treePosition + mushroomOffset);
+                EncodeRecordPosition(GetTerrainPosition(treePosition + mushroomOffset), tileWorldPosition);
         }
 
         mushroomRecord.OutputComplete();
@@ -299,7 +308,7 @@ void WoodlandTile(
     // detailed tile output
     {
         const bool hasDetailedTileOutput =
-            isThreadVisible && (centerDistanceToCamera < (denseGrassMaxDistance + (detailedTileSize * 2)));
+            isThreadVisible && (centerDistanceToCamera < (GetDenseGrassMaxDistance() + (detailedTileSize * 2)));
 
         ThreadNodeOutputRecords<TileRecord> detailedTileOutputRecord =
             detailedTileOutput.GetThreadNodeOutputRecords(hasDetailedTileOutput);
@@ -344,6 +353,8 @@ void GrasslandTile(
     [NodeId("DrawSparseGrassPatch")]
     NodeOutput<DrawSparseGrassRecord> sparseGrassOutput)
 {
+    CountGenerationGroup(generationNodeGrasslandTile, groupThreadId.y * detailedTilesPerTile + groupThreadId.x, true, 1);
+
     // clear groupshared counters
     sparseGrassPatchCount = 0;
     butterflyPatchCount   = 0;
@@ -363,8 +374,10 @@ void GrasslandTile(
     const float3 threadCenterCurvedWorldPosition = GetCurvedWorldSpacePosition(threadCenterWorldPosition);
     const float  centerDistanceToCamera          = distance(GetCameraPosition(), threadCenterWorldPosition);
 
-    const AxisAlignedBoundingBox threadBoundingBox =
-        GetGridBoundingBox(threadGridPosition, detailedTileSize, -100, 300);
+    const AxisAlignedBoundingBox threadBoundingBox = GetCurvedGridBoundingBox(threadGridPosition,
+                                                                              detailedTileSize,
+                                                                              threadCenterWorldPosition.y + detailedTileMinHeightOffset,
+                                                                              threadCenterWorldPosition.y + detailedTileMaxHeightOffset);
     const bool isThreadVisible = threadBoundingBox.IsVisible(ComputeClipPlanes());
 
     const uint seed    = CombineSeed(asuint(threadGridPosition.x), asuint(threadGridPosition.y));
@@ -381,8 +394,8 @@ void GrasslandTile(
         }
 
         // --- distance cull ---
-        if (((centerDistanceToCamera + radius) < denseGrassMaxDistance) ||
-            ((centerDistanceToCamera + radius) > sparseGrassMaxDistance))
+        if (((centerDistanceToCamera + radius) < GetDenseGrassMaxDistance()) ||
+            ((centerDistanceToCamera + radius) > GetSparseGrassMaxDistance()))
         {
             hasOutput = false;
         }
@@ -400,11 +413,12 @@ void GrasslandTile(
 
         if (all(groupThreadId == 0) && sparseGrassPatchCount > 0) {
             sparseGrassRecord.Get().dispatchGrid = uint3(sparseGrassPatchCount, sparseGrassThreadGroupsPerRecord, 1);
+            sparseGrassRecord.Get().origin       = tileGridPosition * detailedTilesPerTile;
         }
 
         if (hasOutput) {
             // XZ-position
-            sparseGrassRecord.Get().position[outputIndex] = threadGridPosition;
+            sparseGrassRecord.Get().position[outputIndex] = int16_t2(groupThreadId);
         }
 
         sparseGrassRecord.OutputComplete();
@@ -416,7 +430,7 @@ void GrasslandTile(
         const float butterflyProbability = 0.02f;
         const bool  hasButterflyOutput =
             !isNight &&                                         // no butterflies at night
-            (centerDistanceToCamera < butterflyMaxDistance) &&  // cull butterflies in distance
+            (centerDistanceToCamera < GetButterflyMaxDistance()) &&  // cull butterflies in distance
             (Random(seed, 1998) < butterflyProbability);
 
         int butterflyOutputIndex = 0;
@@ -432,11 +446,12 @@ void GrasslandTile(
 
         if (all(groupThreadId == 0) && butterflyPatchCount > 0) {
             butterflyOutputRecord.Get().dispatchGrid = uint3(butterflyPatchCount, 1, 1);
+            butterflyOutputRecord.Get().origin       = tileWorldPosition;
         }
 
         if (hasButterflyOutput) {
-            // XZ-position
-            butterflyOutputRecord.Get().position[butterflyOutputIndex] = threadCenterWorldPosition;
+            butterflyOutputRecord.Get().position[butterflyOutputIndex] =
+                EncodeRecordPosition(threadCenterWorldPosition, tileWorldPosition);
         }
 
         butterflyOutputRecord.OutputComplete();
@@ -444,10 +459,11 @@ void GrasslandTile(
 
     // flower output
     {
+        // meadow weight at the detailed tile corner
         const float3 biomeWeight = GetBiomeWeights(threadWorldPosition);
 
         // cull flowers for visibility and max distance
-        const float flowerCullDistance = flowerMaxDistance - (Random(seed, 8437) * flowerMaxDistance * 0.2);
+        const float flowerCullDistance = GetFlowerMaxDistance() - (Random(seed, 8437) * GetFlowerMaxDistance() * 0.2);
         const bool  hasFlowerOutput    = isThreadVisible && (centerDistanceToCamera < flowerCullDistance);
         // select random number of flowers to generate. number also depends on meadow biome weight
         const int   flowerOutputCount =
@@ -457,7 +473,7 @@ void GrasslandTile(
         // one of the generated flowers can also spawn a bee patch
         const bool  hasBeeOutput   = (flowerOutputCount > 0) &&                 // patch has at least one flower
                                   !isNight &&                                   // no bees at night
-                                  (centerDistanceToCamera < beeMaxDistance) &&  // cull bees in distance
+                                  (centerDistanceToCamera < GetBeeMaxDistance()) &&  // cull bees in distance
                                   (Random(seed, 2378) < beeProbability);        // limit bee occurrance
 
         // output indices into shared records
@@ -474,7 +490,7 @@ void GrasslandTile(
 
         GroupMemoryBarrierWithGroupSync();
 
-        const uint flowerType = (distance(GetCameraPosition(), tileCenterWorldPosition) > flowerSparseStartDistance);
+        const uint flowerType = (distance(GetCameraPosition(), tileCenterWorldPosition) > GetFlowerSparseStartDistance());
 
         GroupNodeOutputRecords<DrawFlowerRecord> flowerOutputRecord =
             flowerOutput[flowerType].GetGroupNodeOutputRecords(flowerPatchCount > 0);
@@ -489,9 +505,11 @@ void GrasslandTile(
                 flowerOutputRecord.Get().dispatchGrid = uint3(flowerPatchCount, 1, 1);
             }
             flowerOutputRecord.Get().flowerPatchCount = flowerPatchCount;
+            flowerOutputRecord.Get().origin           = tileWorldPosition;
         }
         if (all(groupThreadId == 0) && beePatchCount > 0) {
             beeOutputRecord.Get().dispatchGrid = uint3(beePatchCount, 1, 1);
+            beeOutputRecord.Get().origin       = tileWorldPosition;
         }
 
         for (int flowerId = 0; flowerId < flowerOutputCount; ++flowerId) {
@@ -500,12 +518,16 @@ void GrasslandTile(
                        Random(asuint(threadWorldPosition.x), asuint(threadWorldPosition.y), flowerId, 8327)) *
                 detailedTileSize;
 
-            flowerOutputRecord.Get().position[flowerOutputIndex + flowerId] = threadWorldPosition + offset;
+            flowerOutputRecord.Get().position[flowerOutputIndex + flowerId] =
+                EncodeRecordPosition(threadWorldPosition + offset, tileWorldPosition);
         }
 
         if (hasBeeOutput) {
+            // bees fly above the first flower of the detailed tile, at its decoded position as seen by the flower mesh shader
+            const int16_t2 flowerPosition = flowerOutputRecord.Get().position[flowerOutputIndex];
+
             beeOutputRecord.Get().position[beeOutputIndex] =
-                GetTerrainPosition(flowerOutputRecord.Get().position[flowerOutputIndex]);
+                EncodeRecordPosition(GetTerrainPosition(DecodeRecordPosition(flowerPosition, tileWorldPosition)), tileWorldPosition);
         }
 
         flowerOutputRecord.OutputComplete();
@@ -515,7 +537,7 @@ void GrasslandTile(
     // detailed tile output
     {
         const bool hasDetailedTileOutput =
-            isThreadVisible && (centerDistanceToCamera < (denseGrassMaxDistance + (detailedTileSize * 2)));
+            isThreadVisible && (centerDistanceToCamera < (GetDenseGrassMaxDistance() + (detailedTileSize * 2)));
 
         ThreadNodeOutputRecords<TileRecord> detailedTileOutputRecord =
             detailedTileOutput.GetThreadNodeOutputRecords(hasDetailedTileOutput);
@@ -543,6 +565,8 @@ void DetailedTile(
     [NodeId("DrawDenseGrassPatch")]
     NodeOutput<DrawDenseGrassRecord> grassOutput)
 {
+    CountGenerationGroup(generationNodeDetailedTile, groupThreadId.y * grassPatchesPerDetailedTile + groupThreadId.x, true, 1);
+
     // clear groupshared counters
     denseGrassPatchCount = 0;
 
@@ -557,9 +581,10 @@ void DetailedTile(
     const float2 threadWorldPosition = (threadGridPosition + GetGrassOffset(threadGridPosition)) * grassSpacing;
 
     // get terrain height and normal & biome weights
-    const float3 patchPosition = GetTerrainPosition(threadWorldPosition.x, threadWorldPosition.y);
-    const float3 patchNormal   = GetTerrainNormal(threadWorldPosition.x, threadWorldPosition.y);
-    const float3 biomeWeights  = GetBiomeWeights(threadWorldPosition);
+    const TerrainSample patchSample   = GetTerrainSample(threadWorldPosition);
+    const float3        patchPosition = float3(threadWorldPosition.x, patchSample.height, threadWorldPosition.y);
+    const float3        patchNormal   = patchSample.normal;
+    const float3        biomeWeights  = patchSample.biomeWeights;
     
     bool hasOutput = true;
 
@@ -577,7 +602,7 @@ void DetailedTile(
     const float distanceToCamera = distance(GetCameraPosition(), patchPosition.xyz);
 
     // cull against distance to camera
-    if (distanceToCamera > denseGrassMaxDistance) {
+    if (distanceToCamera > GetDenseGrassMaxDistance()) {
         hasOutput = false;
     }
     
@@ -592,8 +617,8 @@ void DetailedTile(
 
     // Each dense grass mesh shader can only render 16 grass blades.
     // If grass patch has more than 16 blades, we require two thread groups to draw this patch
-    const bool hasSplitOutput =
-        lerp(32.f, 2., pow(saturate(distanceToCamera / (denseGrassMaxDistance * 1.05)), 0.75)) > 16.f;
+    // Blade count must match maxNumGrassBlades in densegrassmeshshader.hlsl
+    const bool hasSplitOutput = GetDenseGrassBladeCount(min(MAX_NUM_GRASS_BLADES, 32), distanceToCamera) > 16.f;
     
     // Output dense grass
     {
@@ -611,17 +636,18 @@ void DetailedTile(
 
         if (all(groupThreadId == 0) && denseGrassPatchCount > 0) {
             denseGrassRecord.Get().dispatchGrid = uint3(denseGrassPatchCount, 1, 1);
+            denseGrassRecord.Get().origin       = tileWorldPosition;
         }
 
         if (hasOutput) {
-            denseGrassRecord.Get().position[grassOutputIndex]    = patchPosition;
-            denseGrassRecord.Get().height[grassOutputIndex]      = grassHeight;
-            denseGrassRecord.Get().bladeOffset[grassOutputIndex] = 0;
+            const int16_t3 encodedPatchPosition = EncodeRecordPosition(patchPosition, tileWorldPosition);
+
+            denseGrassRecord.Get().position[grassOutputIndex] = encodedPatchPosition;
+            denseGrassRecord.Get().patch[grassOutputIndex]    = EncodeDenseGrassPatch(grassHeight, 0);
 
             if (hasSplitOutput) {
-                denseGrassRecord.Get().position[grassOutputIndex + 1]    = patchPosition;
-                denseGrassRecord.Get().height[grassOutputIndex + 1]      = grassHeight;
-                denseGrassRecord.Get().bladeOffset[grassOutputIndex + 1] = 1;
+                denseGrassRecord.Get().position[grassOutputIndex + 1] = encodedPatchPosition;
+                denseGrassRecord.Get().patch[grassOutputIndex + 1]    = EncodeDenseGrassPatch(grassHeight, 1);
             }
         }
 
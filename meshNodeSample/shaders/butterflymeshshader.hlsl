@@ -106,7 +106,7 @@ static const int numOutputTriangleIterations = (numOutputTriangles + (butterflyG
 // and you are running on a non-AMD GPU, you may need to adjust this limit.
 // You can learn more at: 
 // https://gpuopen.com/learn/work_graphs_mesh_nodes/work_graphs_mesh_nodes-tips_tricks_best_practices
-[NodeMaxInputRecordsPerGraphEntryRecord(10, true)]
+[NodeMaxInputRecordsPerGraphEntryRecord(drawButterfliesMaxInputRecords, true)]
 [NumThreads(butterflyGroupSize, 1, 1)]
 [OutputTopology("triangle")]
 void ButterflyMeshShader(
@@ -121,8 +121,9 @@ void ButterflyMeshShader(
     const int triangleCount  = numButterflies * numButterflyTriangles;
 
     SetMeshOutputCounts(vertexCount, triangleCount);
+    CountGenerationMeshGroup(generationNodeDrawButterflies, gtid, gid == 0, inputRecord.Get().dispatchGrid.x, vertexCount, triangleCount);
 
-    const float3 patchCenter = inputRecord.Get().position[gid];
+    const float3 patchCenter = DecodeRecordPosition(inputRecord.Get().position[gid], inputRecord.Get().origin);
     const int    seed        = CombineSeed(asuint(patchCenter.x), asuint(patchCenter.z));
     
     [[unroll]]
@@ -158,7 +159,7 @@ void ButterflyMeshShader(
             // slowly scale insects to 0 in the distance
             // for simplicity, we omit this scaling from the motion vector, as it only affects very distant insects
             const float distanceScale = smoothstep(
-                butterflyFadeStartDistance, butterflyMaxDistance, distance(patchCenter, GetCameraPosition()));
+                GetButterflyFadeStartDistance(), GetButterflyMaxDistance(), distance(patchCenter, GetCameraPosition()));
 
             const float scale = (.01 + 0.03 * Random(seed, insectId, 8)) * (1 - nightScale) * (1 - distanceScale);
 
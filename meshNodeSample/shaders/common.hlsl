@@ -22,39 +22,53 @@
 #pragma once
 
 #include "workgraphcommon.h"
+#include "workgraphrecords.h"
+#include "generationcounters.h"
 #include "utils.hlsl"
 #include "heightmap.hlsl"
 
 // ==================
 // Constants
 
-// World grid definitions
-// DO NOT CHANGE THESE!
-static const uint grassPatchesPerDetailedTile = 16;
-static const uint detailedTilesPerTile        = 8;
-static const uint tilesPerChunk               = 8;
-
-// World grid sizes are defined by grass blade spacing
+// World grid sizes are defined by grass blade spacing, grid definitions are in workgraphrecords.h
 static const float grassSpacing     = 0.25;
 static const float detailedTileSize = grassPatchesPerDetailedTile * grassSpacing;
 static const float tileSize         = detailedTilesPerTile * detailedTileSize;
 static const float chunkSize        = tilesPerChunk * tileSize;
 
-// Distance limits for procedural generation
-static const float worldGridMaxDistance = 2000.f;
-
-static const float denseGrassMaxDistance  = 80.f;
-static const float sparseGrassMaxDistance = 250.f;
+// Quality tier defines
+// These defaults correspond to the "High" quality tier. Other tiers are defined in meshnodesampleconfig.json
+// and passed to the shader compiler as defines, such that all values remain compile-time constants.
+#ifndef WORLD_GRID_MAX_DISTANCE
+#define WORLD_GRID_MAX_DISTANCE 2000.f
+#endif
+#ifndef DENSE_GRASS_MAX_DISTANCE
+#define DENSE_GRASS_MAX_DISTANCE 80.f
+#endif
+#ifndef SPARSE_GRASS_MAX_DISTANCE
+#define SPARSE_GRASS_MAX_DISTANCE 250.f
+#endif
+#ifndef FLOWER_MAX_DISTANCE
+#define FLOWER_MAX_DISTANCE 300.f
+#endif
+#ifndef MAX_NUM_GRASS_BLADES
+#define MAX_NUM_GRASS_BLADES 32
+#endif
 
-static const float flowerMaxDistance         = 300.f;
-static const float flowerSparseStartDistance = 100.f;
+// Distance limits for procedural generation
+static const float worldGridMaxDistance = WORLD_GRID_MAX_DISTANCE;
 
-static const float mushroomMaxDistance = denseGrassMaxDistance;
+// Upper limits of the ground cover & decoration distances. The geometry budget scales them down at runtime,
+// see GetDenseGrassMaxDistance & co. below. Record capacities are sized for these limits.
+static const float denseGrassMaxDistanceLimit  = DENSE_GRASS_MAX_DISTANCE;
+static const float sparseGrassMaxDistanceLimit = SPARSE_GRASS_MAX_DISTANCE;
+static const float flowerMaxDistanceLimit      = FLOWER_MAX_DISTANCE;
 
-static const float butterflyMaxDistance       = 25.f;
-static const float butterflyFadeStartDistance = 20.f;
-static const float beeMaxDistance             = 40.f;
-static const float beeFadeStartDistance       = 30.f;
+static const float butterflyMaxDistanceLimit = 25.f;
+static const float beeMaxDistanceLimit       = 40.f;
+// insects fade out over the last part of their distance
+static const float butterflyFadeStartFactor = 0.8f;
+static const float beeFadeStartFactor       = 0.75f;
 
 // Night time definition: start at 18:00 till 6:00
 // Bees and butterflies won't be rendered/generated at night
@@ -64,111 +78,13 @@ static const float nightEndTime   = 6.f;
 // Radius of curved world
 static const float earthRadius = 6000.f;
 
-// ===================================
-// Record structs for work graph nodes
-
-// Record for each tile in a chunk & detailed tile in a tile
-struct TileRecord {
-    int2 position;
-};
-
-// Record for drawing terrain segments inside a chunk
-struct DrawTerrainChunkRecord {
-    uint3 dispatchGrid : SV_DispatchGrid;
-    int2  chunkGridPosition;
-    int   levelOfDetail;
-    // indicated if neighboring terrain tiles have higher LOD
-    // x = (-1, 0)
-    // y = (0, -1)
-    // z = (1, 0)
-    // w = (0, 1)
-    bool4 levelOfDetailTransition;
-};
-
-struct GenerateTreeRecord {
-    float2 position;
-};
-
-static const uint maxSplinesPerRecord        = 32;
-static const uint splineMaxControlPointCount = 8;
-
-// Record for drawing multiple splines. Each spline is defined as a series of control points.
-// Each control point defines a vertex ring with varying radius and vertex count.
-struct DrawSplineRecord {
-    uint3  dispatchGrid : SV_DispatchGrid;
-    float3 color[maxSplinesPerRecord];
-    float  rotationOffset[maxSplinesPerRecord];
-    // x is overall wind strength, y is blending factor for individual vertices
-    float2 windStrength[maxSplinesPerRecord];
-    uint   controlPointCount[maxSplinesPerRecord];
-    float3 controlPointPositions[maxSplinesPerRecord * splineMaxControlPointCount];
-    uint   controlPointVertexCounts[maxSplinesPerRecord * splineMaxControlPointCount];
-    float2 controlPointRadii[maxSplinesPerRecord * splineMaxControlPointCount];
-    float  controlPointNoiseAmplitudes[maxSplinesPerRecord * splineMaxControlPointCount];
-};
-
-// Each thread in a biome tile can generate one insects
-static const uint maxInsectsPerRecord = detailedTilesPerTile * detailedTilesPerTile;
-
-// Record for insects
-// Used by
-//  - DrawBees
-//  - DrawButterflies
-struct DrawInsectRecord {
-    uint3  dispatchGrid : SV_DispatchGrid;
-    float3 position[maxInsectsPerRecord];
-};
-
-// Each thread in a biome tile can generate up to 3 mushrooms
-static const uint maxMushroomsPerDetailedTile = 3;
-static const uint maxMushroomsPerRecord = detailedTilesPerTile * detailedTilesPerTile * maxMushroomsPerDetailedTile;
+// Height range of detailed tile bounding boxes relative to the terrain height at the detailed tile center
+// covers terrain gradients up to 7 within a detailed tile & grass or flowers on top
+static const float detailedTileMinHeightOffset = -20.f;
+static const float detailedTileMaxHeightOffset = 22.f;
 
-// Record for mushrooms
-// Used by
-//  - DrawMushroomPatch
-struct DrawMushroomRecord {
-    uint3  dispatchGrid : SV_DispatchGrid;
-    float3 position[maxMushroomsPerRecord];
-};
-
-// Each thread in a biome tile can generate up to 12 flowers
-static const int maxFlowersPerDetailedTile = 12;
-static const int maxFlowersPerRecord       = (detailedTilesPerTile * detailedTilesPerTile) * maxFlowersPerDetailedTile;
-// scaling factor for dispatch grid size when using sparse flowers
-static const int flowersInSparseFlowerThreadGroup = 5;
-
-// Record for flowers
-// Used by
-//  - DrawFlowerPatch
-struct DrawFlowerRecord {
-    uint3  dispatchGrid : SV_DispatchGrid;
-    uint   flowerPatchCount;
-    float2 position[maxFlowersPerRecord];
-};
-
-// Each thread in a detailed tile corresponds to one or two dense grass patches
-static const uint maxDenseGrassPatchesPerRecord = 2 * grassPatchesPerDetailedTile * grassPatchesPerDetailedTile;
-
-// Record for dense grass
-// Used by
-//  - DrawDenseGrassPatch
-struct DrawDenseGrassRecord {
-    uint3  dispatchGrid : SV_DispatchGrid;
-    float3 position[maxDenseGrassPatchesPerRecord];
-    float  height[maxDenseGrassPatchesPerRecord];
-    uint   bladeOffset[maxDenseGrassPatchesPerRecord];
-};
-
-// Each thread in a biome tile corresponds to a sparse grass patch
-static const uint maxSparseGrassPatchesPerRecord = detailedTilesPerTile * detailedTilesPerTile;
-// Number of sparse grass mesh shader thread groups needed to render one detailed tile
-static const uint sparseGrassThreadGroupsPerRecord = 8;
-
-// record for DrawSparseGrassPatch
-struct DrawSparseGrassRecord {
-    uint3 dispatchGrid : SV_DispatchGrid;
-    int2  position[maxSparseGrassPatchesPerRecord];
-};
+// ===================================
+// Record structs for work graph nodes are shared with the CPU emulator, see workgraphrecords.h
 
 // =====================================
 // Common MS & PS input & output structs
@@ -227,38 +143,157 @@ float GetTimeOfDay()
 
 float3 GetCameraPosition()
 {
-    return CameraPosition.xyz;
+    return WorkGraphData.CameraPosition.xyz;
 }
 
 float3 GetPreviousCameraPosition()
 {
-    return PreviousCameraPosition.xyz;
+    return WorkGraphData.PreviousCameraPosition.xyz;
 }
 
 ClipPlanes ComputeClipPlanes()
 {
-    return ComputeClipPlanes(ViewProjection);
+    return ComputeClipPlanes(WorkGraphData.ViewProjection);
 }
 
 uint GetTime()
 {
-    return ShaderTime;
+    return WorkGraphData.ShaderTime;
 }
 
 uint GetPreviousTime()
 {
-    return PreviousShaderTime;
+    return WorkGraphData.PreviousShaderTime;
 }
 
 float GetWindStrength()
 {
-    return WindStrength;
+    return WorkGraphData.WindStrength;
 }
 
 // Rotation of wind direction around y-Axis; 0 = float3(1, 0, 0);
 float GetWindDirection()
 {
-    return WindDirection;
+    return WorkGraphData.WindDirection;
+}
+
+// ==============================================================================
+// Geometry budget, distances & dense grass blade density scaled by the sample to hold a work graph time budget.
+// Scales are clamped to [0, 1], such that the quality tier limits & the record capacities derived from them always hold.
+
+float GetDenseGrassMaxDistance()
+{
+    return denseGrassMaxDistanceLimit * saturate(WorkGraphData.DenseGrassDistanceScale);
+}
+
+float GetSparseGrassMaxDistance()
+{
+    return sparseGrassMaxDistanceLimit * saturate(WorkGraphData.SparseGrassDistanceScale);
+}
+
+float GetFlowerMaxDistance()
+{
+    return flowerMaxDistanceLimit * saturate(WorkGraphData.FlowerDistanceScale);
+}
+
+float GetFlowerSparseStartDistance()
+{
+    return min(100.f, GetFlowerMaxDistance());
+}
+
+float GetMushroomMaxDistance()
+{
+    return GetDenseGrassMaxDistance();
+}
+
+float GetButterflyMaxDistance()
+{
+    return butterflyMaxDistanceLimit * saturate(WorkGraphData.InsectDistanceScale);
+}
+
+float GetButterflyFadeStartDistance()
+{
+    return GetButterflyMaxDistance() * butterflyFadeStartFactor;
+}
+
+float GetBeeMaxDistance()
+{
+    return beeMaxDistanceLimit * saturate(WorkGraphData.InsectDistanceScale);
+}
+
+float GetBeeFadeStartDistance()
+{
+    return GetBeeMaxDistance() * beeFadeStartFactor;
+}
+
+// Blade count of a dense grass patch at distanceToCamera, maxBladeCount blades next to the camera at full density.
+// Shared by DenseGrassMeshShader & the DetailedTile node, which splits patches with more than 16 blades.
+float GetDenseGrassBladeCount(in const float maxBladeCount, in const float distanceToCamera)
+{
+    const float bladeCount = max(maxBladeCount * saturate(WorkGraphData.GrassBladeDensityScale), 2.f);
+
+    return lerp(bladeCount, 2., pow(saturate(distanceToCamera / (GetDenseGrassMaxDistance() * 1.05)), 0.75));
+}
+
+// ==============================================================================
+// Generation counters, see generationcounters.h. Only the first thread of a group adds to the counters,
+// threads of thread launch nodes are aggregated per wave.
+
+RWStructuredBuffer<uint> GenerationCounters : register(u0);
+
+void AddGenerationCounter(in uint node, in uint counter, in uint value)
+{
+    if (WorkGraphData.GenerationCountersEnabled && (value > 0)) {
+        InterlockedAdd(GenerationCounters[GetGenerationCounterIndex(node, counter)], value);
+    }
+}
+
+void MaxGenerationCounter(in uint node, in uint counter, in uint value)
+{
+    if (WorkGraphData.GenerationCountersEnabled) {
+        InterlockedMax(GenerationCounters[GetGenerationCounterIndex(node, counter)], value);
+    }
+}
+
+// Count a thread of a thread launch node, called by all threads
+void CountGenerationThread(in uint node)
+{
+    if (WorkGraphData.GenerationCountersEnabled) {
+        const uint threadCount = WaveActiveCountBits(true);
+
+        if (WaveIsFirstLane()) {
+            AddGenerationCounter(node, generationCounterRecords, threadCount);
+            AddGenerationCounter(node, generationCounterGroups, threadCount);
+        }
+    }
+}
+
+// Count a thread group of a broadcasting or coalescing node. recordCount input records are counted by the first group of a dispatch grid.
+void CountGenerationGroup(in uint node, in uint threadIndex, in bool isFirstGroup, in uint recordCount)
+{
+    if (threadIndex == 0) {
+        AddGenerationCounter(node, generationCounterGroups, 1);
+
+        if (isFirstGroup) {
+            AddGenerationCounter(node, generationCounterRecords, recordCount);
+        }
+    }
+}
+
+// Count a thread group of a mesh node with its output counts. The first group of a dispatch grid counts the input record & its used entries.
+void CountGenerationMeshGroup(in uint node, in uint threadIndex, in bool isFirstGroup, in uint entryCount, in uint vertexCount, in uint primitiveCount)
+{
+    if (threadIndex == 0) {
+        AddGenerationCounter(node, generationCounterGroups, 1);
+        AddGenerationCounter(node, generationCounterVertices, vertexCount);
+        AddGenerationCounter(node, generationCounterPrimitives, primitiveCount);
+
+        if (isFirstGroup) {
+            AddGenerationCounter(node, generationCounterRecords, 1);
+            AddGenerationCounter(node, generationCounterEntries, entryCount);
+            MaxGenerationCounter(node, generationCounterMaxEntries, entryCount);
+        }
+    }
 }
 
 // =====================================================
@@ -327,6 +362,37 @@ AxisAlignedBoundingBox GetGridBoundingBox(in int2  gridPosition,
     return result;
 }
 
+// Computes bounding box for a grid element with a tight height range on curved world
+// heights are curved with the position, i.e. scaled & rotated like GetCurvedWorldSpacePosition
+AxisAlignedBoundingBox GetCurvedGridBoundingBox(in int2  gridPosition,
+                                                in float elementSize,
+                                                in float minHeight,
+                                                in float maxHeight)
+{
+    const float2 minWorldPosition = gridPosition * elementSize;
+    const float2 maxWorldPosition = (gridPosition + 1) * elementSize;
+
+    AxisAlignedBoundingBox result;
+
+    result.min = float3(1e30, 1e30, 1e30);
+    result.max = float3(-1e30, -1e30, -1e30);
+
+    // the curvature moves each xz corner differently, i.e. all four corners are needed
+    for (int corner = 0; corner < 4; ++corner)
+    {
+        const float2 cornerWorldPosition =
+            float2((corner & 1) ? maxWorldPosition.x : minWorldPosition.x, (corner & 2) ? maxWorldPosition.y : minWorldPosition.y);
+
+        const float3 low  = GetCurvedWorldSpacePosition(float3(cornerWorldPosition.x, minHeight, cornerWorldPosition.y));
+        const float3 high = GetCurvedWorldSpacePosition(float3(cornerWorldPosition.x, maxHeight, cornerWorldPosition.y));
+
+        result.min = min(result.min, min(low, high));
+        result.max = max(result.max, max(low, high));
+    }
+
+    return result;
+}
+
 // Computes position on curved world, projects it into clip space & assigns it to vertex.clipSpacePosition
 // Computes motion vector and assigns it to vertex.clipSpaceMotion
 template <typename T>
@@ -338,10 +404,10 @@ void ComputeClipSpacePositionAndMotion(inout T   vertex,
     const float3 curvedWorldSpacePosition         = GetCurvedWorldSpacePosition(worldSpacePosition);
     const float3 previousCurvedWorldSpacePosition = GetCurvedWorldSpacePosition(previousWorldSpacePosition, true);
 
-    vertex.clipSpacePosition = mul(ViewProjection, float4(curvedWorldSpacePosition, 1));
+    vertex.clipSpacePosition = mul(WorkGraphData.ViewProjection, float4(curvedWorldSpacePosition, 1));
 
     const float4 previousClipSpacePosition =
-        mul(PreviousViewProjection, float4(previousCurvedWorldSpacePosition, 1));
+        mul(WorkGraphData.PreviousViewProjection, float4(previousCurvedWorldSpacePosition, 1));
     vertex.clipSpaceMotion = (previousClipSpacePosition.xy / previousClipSpacePosition.w) -
                              (vertex.clipSpacePosition.xy / vertex.clipSpacePosition.w);
 }
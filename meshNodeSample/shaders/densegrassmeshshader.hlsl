@@ -82,8 +82,9 @@ static const int numOutputTrianglesLimit = 96;
 static const int numGrassBladeVerticesPerEdge = 4;
 static const int numGrassBladeVertices        = 2 * numGrassBladeVerticesPerEdge;
 static const int numGrassBladeTriangles       = 6;
+// MAX_NUM_GRASS_BLADES is defined by the quality tier, see common.hlsl
 static const int maxNumGrassBlades =
-    min(32,
+    min(MAX_NUM_GRASS_BLADES,
         min(maxNumOutputVerticesLimit / numGrassBladeVertices, maxNumOutputTrianglesLimit / numGrassBladeTriangles));
 static const int maxNumOutputGrassBlades =
     min(32, min(numOutputVerticesLimit / numGrassBladeVertices, numOutputTrianglesLimit / numGrassBladeTriangles));
@@ -102,7 +103,7 @@ static const int numOutputTriangleIterations = (numOutputTriangles + (denseGrass
 // and you are running on a non-AMD GPU, you may need to adjust this limit.
 // You can learn more at: 
 // https://gpuopen.com/learn/work_graphs_mesh_nodes/work_graphs_mesh_nodes-tips_tricks_best_practices
-[NodeMaxInputRecordsPerGraphEntryRecord(400, true)]
+[NodeMaxInputRecordsPerGraphEntryRecord(drawDenseGrassMaxInputRecords, true)]
 [NumThreads(denseGrassGroupSize, 1, 1)]
 [OutputTopology("triangle")]
 void DenseGrassMeshShader(
@@ -112,16 +113,15 @@ void DenseGrassMeshShader(
     out indices uint3                             tris[numOutputTriangles],
     out vertices GrassVertex                      verts[numOutputVertices])
 {
-    const float3 patchCenter       = inputRecord.Get().position[gid];
-    const float  patchHeight       = inputRecord.Get().height[gid];
-    const uint   bladeOffset       = inputRecord.Get().bladeOffset[gid];
+    const float3 patchCenter       = DecodeRecordPosition(inputRecord.Get().position[gid], inputRecord.Get().origin);
+    const float  patchHeight       = DecodeDenseGrassPatchHeight(inputRecord.Get().patch[gid]);
+    const uint   bladeOffset       = DecodeDenseGrassPatchBladeOffset(inputRecord.Get().patch[gid]);
     const float  patchWindStrength = GetWindStrength();
     const float3 patchNormal       = GetTerrainNormal(patchCenter.xz);
     const int seed = CombineSeed(asuint(int(patchCenter.x / grassSpacing)), asuint(int(patchCenter.z / grassSpacing)));
 
     const float dist        = distance(patchCenter, GetCameraPosition());
-    const float bladeCountF =
-        lerp(float(maxNumGrassBlades), 2., pow(saturate(dist / (denseGrassMaxDistance * 1.05)), 0.75));
+    const float bladeCountF = GetDenseGrassBladeCount(maxNumGrassBlades, dist);
 
     const int tileBladeCount         = ceil(bladeCountF);
     const int threadGroupBladeOffset = bladeOffset * maxNumOutputGrassBlades;
@@ -131,6 +131,8 @@ void DenseGrassMeshShader(
     const int triangleCount = threadGroupBladeCount * numGrassBladeTriangles;
 
     SetMeshOutputCounts(vertexCount, triangleCount);
+    CountGenerationMeshGroup(
+        generationNodeDrawDenseGrassPatch, gtid, gid == 0, inputRecord.Get().dispatchGrid.x, vertexCount, triangleCount);
 
     const int vertId = gtid;
     if (vertId < vertexCount) {
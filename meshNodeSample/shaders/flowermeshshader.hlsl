@@ -102,7 +102,7 @@ static const float3 flowerStemColor = pow(float3(0.82, 0.89, 0.58), 2.2);
 // and you are running on a non-AMD GPU, you may need to adjust this limit.
 // You can learn more at: 
 // https://gpuopen.com/learn/work_graphs_mesh_nodes/work_graphs_mesh_nodes-tips_tricks_best_practices
-[NodeMaxInputRecordsPerGraphEntryRecord(200, true)]
+[NodeMaxInputRecordsPerGraphEntryRecord(drawFlowerMaxInputRecords, true)]
 [NumThreads(flowerGroupSize, 1, 1)]
 [OutputTopology("triangle")]
 void FlowerMeshShader(
@@ -112,9 +112,7 @@ void FlowerMeshShader(
     out indices uint3                         tris[numOutputTriangles],
     out vertices InsectVertex                 verts[numOutputVertices])
 {
-    const DrawFlowerRecord record = inputRecord.Get();
-
-    const float3 patchPosition = GetTerrainPosition(inputRecord.Get().position[gid]);
+    const float3 patchPosition = GetTerrainPosition(DecodeRecordPosition(inputRecord.Get().position[gid], inputRecord.Get().origin));
     const uint   seed          = CombineSeed(asuint(patchPosition.x), asuint(patchPosition.z));
 
     const int flowerCount         = GetFlowerCount(seed);
@@ -133,6 +131,7 @@ void FlowerMeshShader(
     const int triangleCount = totalStemTriangleCount + totalHeadTriangleCount;
 
     SetMeshOutputCounts(vertexCount, triangleCount);
+    CountGenerationMeshGroup(generationNodeDrawFlowerPatch, gtid, gid == 0, inputRecord.Get().flowerPatchCount, vertexCount, triangleCount);
 
     [[unroll]]
     for (uint i = 0; i < numOutputVertexIterations; ++i)
@@ -290,7 +289,7 @@ void FlowerMeshShader(
 // and you are running on a non-AMD GPU, you may need to adjust this limit.
 // You can learn more at: 
 // https://gpuopen.com/learn/work_graphs_mesh_nodes/work_graphs_mesh_nodes-tips_tricks_best_practices
-[NodeMaxInputRecordsPerGraphEntryRecord(200, true)]
+[NodeMaxInputRecordsPerGraphEntryRecord(drawFlowerMaxInputRecords, true)]
 [NumThreads(flowerGroupSize, 1, 1)]
 [OutputTopology("triangle")]
 void SparseFlowerMeshShader(
@@ -307,7 +306,8 @@ void SparseFlowerMeshShader(
     int totalFlowerCount = 0;
 
     if (WaveGetLaneIndex() < threadGroupPatchCount) {
-        const float2 lanePatchPosition = inputRecord.Get().position[recordPositionOffset + WaveGetLaneIndex()];
+        const float2 lanePatchPosition =
+            DecodeRecordPosition(inputRecord.Get().position[recordPositionOffset + WaveGetLaneIndex()], inputRecord.Get().origin);
         const int    laneSeed          = CombineSeed(asuint(lanePatchPosition.x), asuint(lanePatchPosition.y));
         const int    laneFlowerCount   = GetFlowerCount(laneSeed);
 
@@ -320,6 +320,8 @@ void SparseFlowerMeshShader(
     const int triangleCount = totalFlowerCount * sparseFlowerTriangleCount;
 
     SetMeshOutputCounts(vertexCount, triangleCount);
+    CountGenerationMeshGroup(
+        generationNodeDrawSparseFlowerPatch, gtid, gid == 0, inputRecord.Get().flowerPatchCount, vertexCount, triangleCount);
 
     if (gtid < vertexCount) {
         float3 patchPosition = 0;
@@ -330,7 +332,8 @@ void SparseFlowerMeshShader(
             int runningVertexCount = 0;
 
             for (int i = 0; i < maxSparseFlowerPatchesPerThreadGroup; ++i) {
-                const float2 candidatePatchPosition = inputRecord.Get().position[recordPositionOffset + i];
+                const float2 candidatePatchPosition =
+                    DecodeRecordPosition(inputRecord.Get().position[recordPositionOffset + i], inputRecord.Get().origin);
                 const int    candidateSeed =
                     CombineSeed(asuint(candidatePatchPosition.x), asuint(candidatePatchPosition.y));
                 const int candidateFlowerCount = GetFlowerCount(candidateSeed);
@@ -0,0 +1,105 @@
+// This file is part of the AMD Work Graph Mesh Node Sample.
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#pragma once
+
+// Per-node generation counters, shared by the shaders (common.hlsl), the sample (generationcounterreadback.cpp) & the CPU emulator (meshNodeCpu/worldgraph.h).
+// Each node adds to the counters of its node index in the GenerationCounters UAV while WorkGraphData.GenerationCountersEnabled is set:
+//  - records: input records, i.e. the records emitted to the node by its producers (or the CPU)
+//  - groups: launched thread groups, threads for thread launch nodes
+//  - vertices & primitives: mesh node outputs, as set by SetMeshOutputCounts
+//  - entries & max entries: sum & maximum of the used entries of the fixed-size arrays of the mesh node records, e.g. the splines of a
+//    DrawSplineRecord, see GetGenerationRecordCapacity for the array sizes
+// Thread groups of coalescing nodes depend on how the records are coalesced, which differs between GPUs & the CPU emulator.
+
+#include "workgraphrecords.h"
+
+#if __cplusplus
+namespace meshnode
+{
+#endif  // __cplusplus
+
+// node indices, same order as meshnode::WorldGraphNode
+static const uint32_t generationNodeWorld                 = 0;
+static const uint32_t generationNodeChunkGrid             = 1;
+static const uint32_t generationNodeChunk                 = 2;
+static const uint32_t generationNodeMountainTile          = 3;
+static const uint32_t generationNodeWoodlandTile          = 4;
+static const uint32_t generationNodeGrasslandTile         = 5;
+static const uint32_t generationNodeDetailedTile          = 6;
+static const uint32_t generationNodeGenerateOakTree       = 7;
+static const uint32_t generationNodeGeneratePineTree      = 8;
+static const uint32_t generationNodeGenerateRock          = 9;
+static const uint32_t generationNodeDrawTerrainChunk      = 10;
+static const uint32_t generationNodeDrawSpline            = 11;
+static const uint32_t generationNodeDrawSparseGrassPatch  = 12;
+static const uint32_t generationNodeDrawDenseGrassPatch   = 13;
+static const uint32_t generationNodeDrawMushroomPatch     = 14;
+static const uint32_t generationNodeDrawFlowerPatch       = 15;
+static const uint32_t generationNodeDrawSparseFlowerPatch = 16;
+static const uint32_t generationNodeDrawBees              = 17;
+static const uint32_t generationNodeDrawButterflies       = 18;
+static const uint32_t generationNodeCount                 = 19;
+
+// counters of each node
+static const uint32_t generationCounterRecords    = 0;
+static const uint32_t generationCounterGroups     = 1;
+static const uint32_t generationCounterVertices   = 2;
+static const uint32_t generationCounterPrimitives = 3;
+static const uint32_t generationCounterEntries    = 4;
+static const uint32_t generationCounterMaxEntries = 5;
+static const uint32_t generationCounterCount      = 6;
+
+// size of the GenerationCounters UAV in 32-bit values
+static const uint32_t generationCounterBufferSize = generationNodeCount * generationCounterCount;
+
+inline uint32_t GetGenerationCounterIndex(uint32_t node, uint32_t counter)
+{
+    return node * generationCounterCount + counter;
+}
+
+// Size of the record array counted by the entry counters of a mesh node, 0 for nodes without counted entries
+inline uint32_t GetGenerationRecordCapacity(uint32_t node)
+{
+    switch (node) {
+        case generationNodeDrawSpline:
+            return maxSplinesPerRecord;
+        case generationNodeDrawSparseGrassPatch:
+            return maxSparseGrassPatchesPerRecord;
+        case generationNodeDrawDenseGrassPatch:
+            return maxDenseGrassPatchesPerRecord;
+        case generationNodeDrawMushroomPatch:
+            return maxMushroomsPerRecord;
+        case generationNodeDrawFlowerPatch:
+        case generationNodeDrawSparseFlowerPatch:
+            return maxFlowersPerRecord;
+        case generationNodeDrawBees:
+        case generationNodeDrawButterflies:
+            return maxInsectsPerRecord;
+        default:
+            return 0;
+    }
+}
+
+#if __cplusplus
+}  // namespace meshnode
+#endif  // __cplusplus
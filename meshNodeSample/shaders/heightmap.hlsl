@@ -23,67 +23,317 @@
 
 #include "utils.hlsl"
 
-// x = mountain
-// y = woodland
-// z = grassland
-float3 GetBiomeWeights(in float2 position)
+// =====================================
+// Analytic terrain functions
+// Mirrored on the CPU in meshNodeCpu/terrain.cpp, changes must be applied to both.
+
+// Perlin noise at scale * position, with gradient with respect to position
+float3 PerlinNoise2DWithGradient(in float2 position, in float scale)
+{
+    const float3 noise = PerlinNoise2DWithGradient(scale * position);
+
+    return float3(noise.x, scale * noise.yz);
+}
+
+// Perlin noise at scale * position + offset, with gradient with respect to position
+float3 PerlinNoise2DWithGradient(in float2 position, in float scale, in float2 offset)
 {
-    const float2 pos = position * 0.01;
+    const float3 noise = PerlinNoise2DWithGradient(scale * position + offset);
 
-    float mountainFactor = 0;
-    mountainFactor += 1 * PerlinNoise2D(0.5 * pos);
-    mountainFactor += 2 * PerlinNoise2D(0.2 * pos + float2(38, 23));
-    mountainFactor += 4 * PerlinNoise2D(0.1 * pos);
+    return float3(noise.x, scale * noise.yz);
+}
 
+// max of two values with gradient, compares value (x) only
+float3 MaxWithGradient(in float3 a, in float3 b)
+{
+    return (a.x < b.x) ? b : a;
+}
+
+// d smoothstep(a, b, x) / dx
+float SmoothstepDerivative(in float a, in float b, in float x)
+{
+    const float t = saturate((x - a) / (b - a));
+
+    return 6 * t * (1 - t) / (b - a);
+}
+
+// Mountain factor before squaring at biomePosition = world position * 0.01
+// x = mountain factor
+// yz = gradient with respect to biomePosition
+// noise01 receives the 0.1 noise octave, which is shared with the woodland factor
+float3 GetMountainFactorAnalytic(in float2 biomePosition, out float noise01)
+{
+    const float3 octave01 = PerlinNoise2DWithGradient(biomePosition, 0.1);
+    noise01               = octave01.x;
+
+    float3 mountainFactor = 0;
+    mountainFactor += 1 * PerlinNoise2DWithGradient(biomePosition, 0.5);
+    mountainFactor += 2 * PerlinNoise2DWithGradient(biomePosition, 0.2, float2(38, 23));
+    mountainFactor += 4 * octave01;
+
+    return mountainFactor;
+}
+
+// Biome weights from the mountain factor & the shared 0.1 noise octave, see GetMountainFactorAnalytic
+float3 GetBiomeWeightsAnalytic(in float2 biomePosition, in float mountainFactor, in float noise01)
+{
     float woodlandMountainFactor = 1.f - smoothstep(0, 1, 4 * pow(mountainFactor - 0.5, 2));
-    woodlandMountainFactor       = woodlandMountainFactor - pow(4 * PerlinNoise2D(0.1 * pos), 4);
-    mountainFactor               = clamp(pow(clamp(mountainFactor, 0, 1), 2), 0, 1);
+    woodlandMountainFactor       = woodlandMountainFactor - pow(4 * noise01, 4);
+    const float mountainWeight   = clamp(pow(clamp(mountainFactor, 0, 1), 2), 0, 1);
 
     float woodlandFactor = 0;
-    woodlandFactor += 1 * pow(4 * PerlinNoise2D(0.3 * pos), 3);
-    woodlandFactor += 5 * pow(1 * PerlinNoise2D(0.1 * pos), 2);
+    woodlandFactor += 1 * pow(4 * PerlinNoise2D(0.3 * biomePosition), 3);
+    woodlandFactor += 5 * pow(1 * noise01, 2);
     woodlandFactor = clamp(smoothstep(0, 1, woodlandFactor), 0, 1);
 
-    woodlandFactor = smoothstep(0, 1, max(woodlandMountainFactor, woodlandFactor - mountainFactor));
+    woodlandFactor = smoothstep(0, 1, max(woodlandMountainFactor, woodlandFactor - mountainWeight));
 
-    float grasslandFactor = clamp(1 - (mountainFactor + woodlandFactor), 0, 1);
+    float grasslandFactor = clamp(1 - (mountainWeight + woodlandFactor), 0, 1);
 
-    return float3(mountainFactor, woodlandFactor, grasslandFactor);
+    return float3(mountainWeight, woodlandFactor, grasslandFactor);
 }
 
-float GetTerrainHeight(in float2 pos)
+// x = mountain
+// y = woodland
+// z = grassland
+float3 GetBiomeWeightsAnalytic(in float2 position)
 {
-    const float3 biomes = GetBiomeWeights(pos);
+    const float2 biomePosition = position * 0.01;
+
+    float        noise01;
+    const float3 mountainFactor = GetMountainFactorAnalytic(biomePosition, noise01);
+
+    // the mountain factor gradient is unused & removed by the compiler
+    return GetBiomeWeightsAnalytic(biomePosition, mountainFactor.x, noise01);
+}
+
+// Terrain height & its analytic gradient from the mountain factor, see GetMountainFactorAnalytic
+// x = height
+// y = d height / d pos.x
+// z = d height / d pos.y
+// Only the mountain biome weight contributes to the height, thus the woodland & grassland noise is not evaluated.
+float3 GetTerrainHeightAndGradient(in float2 pos, in float3 mountainFactor)
+{
+    const float  mountainFactorClamped = clamp(mountainFactor.x, 0, 1);
+    const float  mountainWeight        = clamp(pow(mountainFactorClamped, 2), 0, 1);
+    const bool   mountainFactorInRange = (mountainFactor.x > 0) && (mountainFactor.x < 1);
+    const float2 mountainGradient      = mountainFactorInRange ? (2 * mountainFactorClamped * 0.01) * mountainFactor.yz : 0;
 
     // scale position down for low-frequency perlin noise
     const float2 samplePosition = pos / 400.0;
-    
+
     // Add multiple perlin noise layers to achieve base terrain height
-    float baseHeight = 0;
-    baseHeight += 1.0 * PerlinNoise2D(1.0 * samplePosition + float2(34, 98));
-    baseHeight += 0.35 * PerlinNoise2D(2.0 * samplePosition + float2(73, 42));
-    baseHeight += 0.25 * max(PerlinNoise2D(3.2 * samplePosition + float2(+0.5, -0.5)),
-                             PerlinNoise2D(3.5 * samplePosition + float2(-0.5, +0.5)));
-    baseHeight += 0.15 * PerlinNoise2D(4.0 * samplePosition);
-    baseHeight += 0.08 * PerlinNoise2D(8.0 * samplePosition);
-    baseHeight += 0.07 * PerlinNoise2D(9.0 * samplePosition);
-    
-    // square height to make hills a bit more pronounced and scale to final height
-    float height = 140.0 * baseHeight * baseHeight;
-    
+    float3 baseHeight = 0;
+    baseHeight += 1.0 * PerlinNoise2DWithGradient(samplePosition, 1.0, float2(34, 98));
+    baseHeight += 0.35 * PerlinNoise2DWithGradient(samplePosition, 2.0, float2(73, 42));
+    baseHeight += 0.25 * MaxWithGradient(PerlinNoise2DWithGradient(samplePosition, 3.2, float2(+0.5, -0.5)),
+                                         PerlinNoise2DWithGradient(samplePosition, 3.5, float2(-0.5, +0.5)));
+    baseHeight += 0.15 * PerlinNoise2DWithGradient(samplePosition, 4.0);
+    baseHeight += 0.08 * PerlinNoise2DWithGradient(samplePosition, 8.0);
+    baseHeight += 0.07 * PerlinNoise2DWithGradient(samplePosition, 9.0);
+
     // Add additional high-frequency noise in mountain biome
-    float mountainHeight = 0;
-    mountainHeight += 0.97 * PerlinNoise2D(1.0 * samplePosition);
-    mountainHeight += 0.95 * max(PerlinNoise2D(2.8 * samplePosition + float2(+2.3, -4.5)),
-                                 PerlinNoise2D(3.1 * samplePosition + float2(-6.5, +3.6)));
-    mountainHeight += 0.75 * PerlinNoise2D(2.0 * samplePosition + float2(34, 56));
-    
-    height += 70.0 * mountainHeight * mountainHeight * smoothstep(0.5, 1.0, biomes.x);
-    
+    float3 mountainHeight = 0;
+    mountainHeight += 0.97 * PerlinNoise2DWithGradient(samplePosition, 1.0);
+    mountainHeight += 0.95 * MaxWithGradient(PerlinNoise2DWithGradient(samplePosition, 2.8, float2(+2.3, -4.5)),
+                                             PerlinNoise2DWithGradient(samplePosition, 3.1, float2(-6.5, +3.6)));
+    mountainHeight += 0.75 * PerlinNoise2DWithGradient(samplePosition, 2.0, float2(34, 56));
+
+    const float mountainBlend = smoothstep(0.5, 1.0, mountainWeight);
+
+    // square height to make hills a bit more pronounced and scale to final height
+    float height = 140.0 * baseHeight.x * baseHeight.x;
+    height += 70.0 * mountainHeight.x * mountainHeight.x * mountainBlend;
     // raise mountain biome up
-    height += 40.0 * smoothstep(0.0, 1.0, biomes.x);
+    height += 40.0 * smoothstep(0.0, 1.0, mountainWeight);
 
-    return height;
+    // chain rule, noise gradients are relative to samplePosition
+    float2 gradient = 280.0 * baseHeight.x * baseHeight.yz;
+    gradient += 140.0 * mountainHeight.x * mountainBlend * mountainHeight.yz;
+    gradient /= 400.0;
+    gradient += (70.0 * mountainHeight.x * mountainHeight.x * SmoothstepDerivative(0.5, 1.0, mountainWeight) +
+                 40.0 * SmoothstepDerivative(0.0, 1.0, mountainWeight)) *
+                mountainGradient;
+
+    return float3(height, gradient);
+}
+
+// Terrain height & its analytic gradient in a single pass
+float3 GetTerrainHeightAndGradient(in float2 pos)
+{
+    float noise01;
+
+    return GetTerrainHeightAndGradient(pos, GetMountainFactorAnalytic(pos * 0.01, noise01));
+}
+
+float GetTerrainHeightAnalytic(in float2 pos)
+{
+    // the gradient is unused & removed by the compiler
+    return GetTerrainHeightAndGradient(pos).x;
+}
+
+float3 GetTerrainNormalAnalytic(in float x, in float z)
+{
+    const float3 heightAndGradient = GetTerrainHeightAndGradient(float2(x, z));
+
+    return normalize(float3(-heightAndGradient.y, 1, -heightAndGradient.z));
+}
+
+// Height, normal & biome weights at one position, see GetTerrainSample
+struct TerrainSample {
+    float  height;
+    float3 normal;
+    // x = mountain, y = woodland, z = grassland
+    float3 biomeWeights;
+};
+
+// All terrain values at position from a single evaluation of each noise octave.
+// The mountain factor & the 0.1 noise octave are shared by the biome weights & the height.
+TerrainSample GetTerrainSampleAnalytic(in float2 position)
+{
+    const float2 biomePosition = position * 0.01;
+
+    float        noise01;
+    const float3 mountainFactor    = GetMountainFactorAnalytic(biomePosition, noise01);
+    const float3 heightAndGradient = GetTerrainHeightAndGradient(position, mountainFactor);
+
+    TerrainSample result;
+    result.height       = heightAndGradient.x;
+    result.normal       = normalize(float3(-heightAndGradient.y, 1, -heightAndGradient.z));
+    result.biomeWeights = GetBiomeWeightsAnalytic(biomePosition, mountainFactor.x, noise01);
+
+    return result;
+}
+
+// =====================================
+// Terrain clipmap
+// Camera-centred cache of terrain height, normal & biome weights, see meshNodeCpu/terrainclipmap.h.
+// Each level is a toroidal window of TerrainClipmapResolution^2 texels around the camera, the texel size doubles with every level.
+// Texel (x, z) of a level is located at world position (x, z) * texel size and stored at (x, z) & (TerrainClipmapResolution - 1).
+// Levels are updated on the CPU as the camera moves & sampled in place of the analytic terrain functions.
+
+// Same layout as meshnode::TerrainClipmapTexel
+struct TerrainClipmapTexel {
+    float height;
+    // normal x & z as snorm16, terrain normals always point up
+    uint normal;
+    // mountain & woodland weights as unorm16
+    uint biomeWeights;
+};
+
+StructuredBuffer<TerrainClipmapTexel> TerrainClipmap : register(t0);
+
+struct TerrainClipmapSample {
+    float  height;
+    float2 normalXZ;
+    // x = mountain, y = woodland
+    float2 biomeWeights;
+};
+
+TerrainClipmapSample LoadTerrainClipmapTexel(in uint level, in int2 texelPosition)
+{
+    const uint                resolution = WorkGraphData.TerrainClipmapResolution;
+    const uint2               address    = uint2(texelPosition) & (resolution - 1);
+    const TerrainClipmapTexel texel      = TerrainClipmap[(level * resolution + address.y) * resolution + address.x];
+
+    TerrainClipmapSample result;
+    result.height       = texel.height;
+    result.normalXZ     = float2(asint(texel.normal << 16) >> 16, asint(texel.normal) >> 16) / 32767.f;
+    result.biomeWeights = float2(texel.biomeWeights & 0xFFFF, texel.biomeWeights >> 16) / 65535.f;
+
+    return result;
+}
+
+TerrainClipmapSample LerpTerrainClipmapSample(in TerrainClipmapSample a, in TerrainClipmapSample b, in float t)
+{
+    TerrainClipmapSample result;
+    result.height       = lerp(a.height, b.height, t);
+    result.normalXZ     = lerp(a.normalXZ, b.normalXZ, t);
+    result.biomeWeights = lerp(a.biomeWeights, b.biomeWeights, t);
+
+    return result;
+}
+
+// Blends all clipmap levels containing position, finer levels take precedence.
+// Each level is faded out towards its border over TerrainClipmapBlendWidth texels to avoid seams between levels.
+// Returns the remaining weight, which has to be filled in with the analytic terrain functions.
+float SampleTerrainClipmap(in float2 position, out TerrainClipmapSample result)
+{
+    result.height       = 0;
+    result.normalXZ     = 0;
+    result.biomeWeights = 0;
+
+    // weight not yet covered by finer levels
+    float weight = 1;
+
+    for (uint level = 0; level < WorkGraphData.TerrainClipmapLevelCount; ++level) {
+        const int4 window = WorkGraphData.TerrainClipmapLevels[level];
+        if (window.z == 0) {
+            continue;
+        }
+
+        const float2 texelPosition = position / (WorkGraphData.TerrainClipmapTexelSize * (1u << level));
+
+        // distance to the window border in texels, bilinear filtering reads texel & texel + 1
+        const float2 borders = min(texelPosition - window.xy, (window.xy + int(WorkGraphData.TerrainClipmapResolution - 1)) - texelPosition);
+        const float  border  = min(borders.x, borders.y);
+        if (border < 0) {
+            continue;
+        }
+
+        const float2 texel  = floor(texelPosition);
+        const float2 offset = texelPosition - texel;
+
+        const TerrainClipmapSample s00 = LoadTerrainClipmapTexel(level, int2(texel) + int2(0, 0));
+        const TerrainClipmapSample s10 = LoadTerrainClipmapTexel(level, int2(texel) + int2(1, 0));
+        const TerrainClipmapSample s01 = LoadTerrainClipmapTexel(level, int2(texel) + int2(0, 1));
+        const TerrainClipmapSample s11 = LoadTerrainClipmapTexel(level, int2(texel) + int2(1, 1));
+
+        const TerrainClipmapSample levelSample =
+            LerpTerrainClipmapSample(LerpTerrainClipmapSample(s00, s10, offset.x), LerpTerrainClipmapSample(s01, s11, offset.x), offset.y);
+
+        const float alpha       = saturate(border / WorkGraphData.TerrainClipmapBlendWidth);
+        const float levelWeight = weight * alpha;
+
+        result.height += levelWeight * levelSample.height;
+        result.normalXZ += levelWeight * levelSample.normalXZ;
+        result.biomeWeights += levelWeight * levelSample.biomeWeights;
+
+        weight *= 1 - alpha;
+        if (weight <= 0) {
+            break;
+        }
+    }
+
+    return weight;
+}
+
+// =====================================
+// Terrain functions
+// Sample the terrain clipmap & fall back to the analytic functions outside of it.
+
+// x = mountain
+// y = woodland
+// z = grassland
+float3 GetBiomeWeights(in float2 position)
+{
+    TerrainClipmapSample clipmapSample;
+    const float          weight = SampleTerrainClipmap(position, clipmapSample);
+
+    float2 biomeWeights = clipmapSample.biomeWeights;
+    if (weight > 0) {
+        biomeWeights += weight * GetBiomeWeightsAnalytic(position).xy;
+    }
+
+    return float3(biomeWeights, clamp(1 - (biomeWeights.x + biomeWeights.y), 0, 1));
+}
+
+float GetTerrainHeight(in float2 pos)
+{
+    TerrainClipmapSample clipmapSample;
+    const float          weight = SampleTerrainClipmap(pos, clipmapSample);
+
+    return (weight > 0) ? clipmapSample.height + weight * GetTerrainHeightAnalytic(pos) : clipmapSample.height;
 }
 
 float GetTerrainHeight(in float x, in float y)
@@ -103,19 +353,54 @@ float3 GetTerrainPosition(in float2 pos)
 
 float3 GetTerrainNormal(in float x, in float z)
 {
-    const float height = GetTerrainHeight(x, z);
+    TerrainClipmapSample clipmapSample;
+    const float          weight = SampleTerrainClipmap(float2(x, z), clipmapSample);
 
-    static const float h  = 0.01;
-    float              dx = (height - GetTerrainHeight(x + h, z));
-    float              dz = (height - GetTerrainHeight(x, z + h));
+    // outside of the clipmap
+    if (weight >= 1) {
+        return GetTerrainNormalAnalytic(x, z);
+    }
 
-    float3 a = normalize(float3(h, -dx, 0));
-    float3 b = normalize(float3(0, -dz, h));
+    float2 normalXZ = clipmapSample.normalXZ;
+    if (weight > 0) {
+        normalXZ += weight * GetTerrainNormalAnalytic(x, z).xz;
+    }
 
-    return normalize(cross(b, a));
+    return float3(normalXZ.x, sqrt(saturate(1 - dot(normalXZ, normalXZ))), normalXZ.y);
 }
 
 float3 GetTerrainNormal(in float2 pos)
 {
     return GetTerrainNormal(pos.x, pos.y);
+}
+
+// Height, normal & biome weights from a single clipmap lookup & a single analytic evaluation outside of the clipmap.
+// Use instead of separate GetTerrainHeight, GetTerrainNormal & GetBiomeWeights calls at the same position.
+TerrainSample GetTerrainSample(in float2 position)
+{
+    TerrainClipmapSample clipmapSample;
+    const float          weight = SampleTerrainClipmap(position, clipmapSample);
+
+    // outside of the clipmap
+    if (weight >= 1) {
+        return GetTerrainSampleAnalytic(position);
+    }
+
+    float  height       = clipmapSample.height;
+    float2 normalXZ     = clipmapSample.normalXZ;
+    float2 biomeWeights = clipmapSample.biomeWeights;
+    if (weight > 0) {
+        const TerrainSample analyticSample = GetTerrainSampleAnalytic(position);
+
+        height += weight * analyticSample.height;
+        normalXZ += weight * analyticSample.normal.xz;
+        biomeWeights += weight * analyticSample.biomeWeights.xy;
+    }
+
+    TerrainSample result;
+    result.height       = height;
+    result.normal       = float3(normalXZ.x, sqrt(saturate(1 - dot(normalXZ, normalXZ))), normalXZ.y);
+    result.biomeWeights = float3(biomeWeights, clamp(1 - (biomeWeights.x + biomeWeights.y), 0, 1));
+
+    return result;
 }
\ No newline at end of file
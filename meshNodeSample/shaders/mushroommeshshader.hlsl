@@ -95,7 +95,7 @@ static const int numOutputTriangleIterations = (numOutputTrianglesLimit + (mushr
 // and you are running on a non-AMD GPU, you may need to adjust this limit.
 // You can learn more at: 
 // https://gpuopen.com/learn/work_graphs_mesh_nodes/work_graphs_mesh_nodes-tips_tricks_best_practices
-[NodeMaxInputRecordsPerGraphEntryRecord(50, true)]
+[NodeMaxInputRecordsPerGraphEntryRecord(drawMushroomMaxInputRecords, true)]
 [NumThreads(mushroomGroupSize, 1, 1)]
 [OutputTopology("triangle")]
 void MushroomMeshShader(
@@ -105,7 +105,7 @@ void MushroomMeshShader(
     out indices uint3                           tris[numOutputTrianglesLimit],
     out vertices InsectVertex                   verts[numOutputVerticesLimit])
 {
-    const float3 patchCenter = inputRecord.Get().position[gid];
+    const float3 patchCenter = DecodeRecordPosition(inputRecord.Get().position[gid], inputRecord.Get().origin);
 
     const int seed = CombineSeed(asuint(patchCenter.x), asuint(patchCenter.z));
     
@@ -144,6 +144,7 @@ void MushroomMeshShader(
     const int triangleCount = numShrooms * trisPerShroom;
 
     SetMeshOutputCounts(vertexCount, triangleCount);
+    CountGenerationMeshGroup(generationNodeDrawMushroomPatch, gtid, gid == 0, inputRecord.Get().dispatchGrid.x, vertexCount, triangleCount);
 
     [[unroll]]
     for (int i = 0; i < numOutputTriangleIterations; ++i)
@@ -0,0 +1,143 @@
+// This file is part of the AMD Work Graph Mesh Node Sample.
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#pragma once
+
+// Quantized encodings of the mesh node records, see the record structs in workgraphrecords.h.
+// Shared by the shaders & the CPU emulator (meshNodeCpu/worldgraph.h), thus only types & intrinsics available in both languages are used.
+//  - positions are stored as signed 16-bit fixed point values. x & z are relative to an origin stored once per record (or spline),
+//    y is absolute. Values outside of the representable range saturate.
+//  - colors, radii, amplitudes & angles are stored as IEEE half precision values
+//  - spline vertex counts are stored with 8 bit per control point
+
+#if __cplusplus
+#include "hlslmath.h"
+
+namespace meshnode
+{
+#endif  // __cplusplus
+
+// x & z offsets to the record origin with 1/512 m precision, i.e. within +-64 m of the origin
+#define RECORD_OFFSET_SCALE 512.f
+// y positions with 1/64 m precision, i.e. within +-512 m
+#define RECORD_HEIGHT_SCALE 64.f
+// largest encoded magnitude, -32768 is not used to keep the range symmetric
+#define RECORD_FIXED_POINT_MAX 32767.f
+
+inline int16_t EncodeFixedPoint(float value, float scale)
+{
+    return (int16_t)clamp(round(value * scale), -RECORD_FIXED_POINT_MAX, RECORD_FIXED_POINT_MAX);
+}
+
+inline float DecodeFixedPoint(int16_t value, float scale)
+{
+    return value / scale;
+}
+
+inline int16_t3 EncodeRecordPosition(float3 position, float2 origin)
+{
+    return int16_t3(EncodeFixedPoint(position.x - origin.x, RECORD_OFFSET_SCALE),
+                    EncodeFixedPoint(position.y, RECORD_HEIGHT_SCALE),
+                    EncodeFixedPoint(position.z - origin.y, RECORD_OFFSET_SCALE));
+}
+
+inline float3 DecodeRecordPosition(int16_t3 position, float2 origin)
+{
+    return float3(origin.x + DecodeFixedPoint(position.x, RECORD_OFFSET_SCALE),
+                  DecodeFixedPoint(position.y, RECORD_HEIGHT_SCALE),
+                  origin.y + DecodeFixedPoint(position.z, RECORD_OFFSET_SCALE));
+}
+
+// xz-position, e.g. for flowers which are placed on the terrain by the mesh shader
+inline int16_t2 EncodeRecordPosition(float2 position, float2 origin)
+{
+    return int16_t2(EncodeFixedPoint(position.x - origin.x, RECORD_OFFSET_SCALE), EncodeFixedPoint(position.y - origin.y, RECORD_OFFSET_SCALE));
+}
+
+inline float2 DecodeRecordPosition(int16_t2 position, float2 origin)
+{
+    return float2(origin.x + DecodeFixedPoint(position.x, RECORD_OFFSET_SCALE), origin.y + DecodeFixedPoint(position.y, RECORD_OFFSET_SCALE));
+}
+
+inline uint16_t EncodeHalf(float value)
+{
+    return (uint16_t)f32tof16(value);
+}
+
+inline uint16_t2 EncodeHalf(float2 value)
+{
+    return uint16_t2(EncodeHalf(value.x), EncodeHalf(value.y));
+}
+
+inline uint16_t3 EncodeHalf(float3 value)
+{
+    return uint16_t3(EncodeHalf(value.x), EncodeHalf(value.y), EncodeHalf(value.z));
+}
+
+inline float DecodeHalf(uint16_t value)
+{
+    return f16tof32(value);
+}
+
+inline float2 DecodeHalf(uint16_t2 value)
+{
+    return float2(DecodeHalf(value.x), DecodeHalf(value.y));
+}
+
+inline float3 DecodeHalf(uint16_t3 value)
+{
+    return float3(DecodeHalf(value.x), DecodeHalf(value.y), DecodeHalf(value.z));
+}
+
+// Vertex counts of four consecutive control points, counts must be below 256
+inline uint32_t EncodeVertexCounts(uint32_t count0, uint32_t count1, uint32_t count2, uint32_t count3)
+{
+    return (count0 & 0xFFu) | ((count1 & 0xFFu) << 8) | ((count2 & 0xFFu) << 16) | ((count3 & 0xFFu) << 24);
+}
+
+// controlPointIndex is the index within the spline, counts.x holds control points 0-3 & counts.y 4-7
+inline uint32_t DecodeVertexCount(uint2 counts, uint32_t controlPointIndex)
+{
+    const uint32_t packedCounts = (controlPointIndex < 4) ? counts.x : counts.y;
+
+    return (packedCounts >> ((controlPointIndex % 4) * 8)) & 0xFFu;
+}
+
+// Dense grass patch height in [0, 1] m with 15 bit precision & blade offset (0 or 1) in the highest bit
+inline uint16_t EncodeDenseGrassPatch(float height, uint32_t bladeOffset)
+{
+    return (uint16_t)((uint32_t)clamp(round(height * 32767.f), 0.f, 32767.f) | ((bladeOffset & 1u) << 15));
+}
+
+inline float DecodeDenseGrassPatchHeight(uint16_t patch)
+{
+    return (patch & 0x7FFFu) / 32767.f;
+}
+
+inline uint32_t DecodeDenseGrassPatchBladeOffset(uint16_t patch)
+{
+    return patch >> 15;
+}
+
+#if __cplusplus
+}  // namespace meshnode
+#endif  // __cplusplus
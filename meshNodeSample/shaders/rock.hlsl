@@ -19,7 +19,7 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 // THE SOFTWARE.
 
-#include "common.hlsl"
+#include "splinegeneration.hlsl"
 
 // Rock generation is single-threaded, this we use a coalescing node to generate multiple rocks in parallel.
 // Rocks are rendered with the same spline mesh node as the trees.
@@ -36,6 +36,8 @@ void GenerateRock(
     [NodeId("DrawSpline")]
     NodeOutput<DrawSplineRecord> output)
 {
+    CountGenerationGroup(generationNodeGenerateRock, threadId, true, inputRecord.Count());
+
     GroupNodeOutputRecords<DrawSplineRecord> outputRecord = output.GetGroupNodeOutputRecords(1);
 
     outputRecord.Get().dispatchGrid = uint3(inputRecord.Count(), 1, 1);
@@ -44,9 +46,10 @@ void GenerateRock(
         const float2 basePositionXZ = inputRecord.Get(threadId).position;
         const uint   seed           = CombineSeed(asuint(basePositionXZ.x), asuint(basePositionXZ.y));
 
-        const float3 basePosition   = GetTerrainPosition(basePositionXZ);
-        const float3 terrainNormal  = GetTerrainNormal(basePositionXZ);
-        const float3 basePositionUp = lerp(float3(0, 1, 0), terrainNormal, 1 + Random(seed, 456) * 0.5);
+        const TerrainSample terrainSample  = GetTerrainSample(basePositionXZ);
+        const float3        basePosition   = float3(basePositionXZ.x, terrainSample.height, basePositionXZ.y);
+        const float3        terrainNormal  = terrainSample.normal;
+        const float3        basePositionUp = lerp(float3(0, 1, 0), terrainNormal, 1 + Random(seed, 456) * 0.5);
 
         const float rotationAngle = Random(seed, 14658) * 2 * PI;
 
@@ -57,35 +60,23 @@ void GenerateRock(
         const float f = 1.05f + Random(seed, 1564);
         const float c = lerp(0.5, 0.9, Random(seed, 49827));
 
-        outputRecord.Get(0).color[threadId]             = float3(0.1, 0.1, 0.1) * 3.5;
-        outputRecord.Get(0).rotationOffset[threadId]    = rotationAngle;
-        outputRecord.Get(0).windStrength[threadId]      = 0;
-        outputRecord.Get(0).controlPointCount[threadId] = 4;
-
-        int controlPointIndex = threadId * splineMaxControlPointCount;
-
-        outputRecord.Get(0).controlPointPositions[controlPointIndex]       = basePosition - terrainNormal;
-        outputRecord.Get(0).controlPointVertexCounts[controlPointIndex]    = 1;
-        outputRecord.Get(0).controlPointRadii[controlPointIndex]           = 0;
-        outputRecord.Get(0).controlPointNoiseAmplitudes[controlPointIndex] = 0.0;
-        controlPointIndex++;
-
-        outputRecord.Get(0).controlPointPositions[controlPointIndex]       = basePosition;
-        outputRecord.Get(0).controlPointVertexCounts[controlPointIndex]    = round(lerp(5, 7, Random(seed, 4145)));
-        outputRecord.Get(0).controlPointRadii[controlPointIndex]           = sideScale;
-        outputRecord.Get(0).controlPointNoiseAmplitudes[controlPointIndex] = 0.5 * upScale;
-        controlPointIndex++;
-
-        outputRecord.Get(0).controlPointPositions[controlPointIndex]       = basePosition + upScale * basePositionUp;
-        outputRecord.Get(0).controlPointVertexCounts[controlPointIndex]    = round(lerp(5, 7, Random(seed, 4578)));
-        outputRecord.Get(0).controlPointRadii[controlPointIndex]           = c * sideScale;
-        outputRecord.Get(0).controlPointNoiseAmplitudes[controlPointIndex] = 0.5 * upScale;
-        controlPointIndex++;
-
-        outputRecord.Get(0).controlPointPositions[controlPointIndex]    = basePosition + f * upScale * basePositionUp;
-        outputRecord.Get(0).controlPointVertexCounts[controlPointIndex] = 1;
-        outputRecord.Get(0).controlPointRadii[controlPointIndex]        = Random(seed, 89514);
-        outputRecord.Get(0).controlPointNoiseAmplitudes[controlPointIndex] = 0;
+        const uint vertexCount0 = round(lerp(5, 7, Random(seed, 4145)));
+        const uint vertexCount1 = round(lerp(5, 7, Random(seed, 4578)));
+
+        GeneratedSpline spline;
+        spline.origin            = basePositionXZ;
+        spline.color             = float3(0.1, 0.1, 0.1) * 3.5;
+        spline.rotationOffset    = rotationAngle;
+        spline.windStrength      = 0;
+        spline.controlPointCount = 4;
+        spline.vertexCounts      = uint2(EncodeVertexCounts(1, vertexCount0, vertexCount1, 1), EncodeVertexCounts(0, 0, 0, 0));
+
+        SetControlPoint(spline, 0, basePosition - terrainNormal, 0, 0.0);
+        SetControlPoint(spline, 1, basePosition, sideScale, 0.5 * upScale);
+        SetControlPoint(spline, 2, basePosition + upScale * basePositionUp, c * sideScale, 0.5 * upScale);
+        SetControlPoint(spline, 3, basePosition + f * upScale * basePositionUp, Random(seed, 89514), 0);
+
+        WriteSpline(outputRecord, 0, 1, threadId, spline);
     }
 
     outputRecord.OutputComplete();
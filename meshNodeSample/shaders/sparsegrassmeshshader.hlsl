@@ -53,7 +53,7 @@ float2 GetPatchPosition(in int patch, in int patchOffset, in int2 gridBase)
 // and you are running on a non-AMD GPU, you may need to adjust this limit.
 // You can learn more at: 
 // https://gpuopen.com/learn/work_graphs_mesh_nodes/work_graphs_mesh_nodes-tips_tricks_best_practices
-[NodeMaxInputRecordsPerGraphEntryRecord(100, true)]
+[NodeMaxInputRecordsPerGraphEntryRecord(drawSparseGrassMaxInputRecords, true)]
 [NumThreads(sparseGrassGroupSize, 1, 1)]
 [OutputTopology("triangle")]
 void SparseGrassMeshShader(
@@ -71,6 +71,8 @@ void SparseGrassMeshShader(
     const int triangleCount = bladeCount * 2;
 
     SetMeshOutputCounts(vertexCount, triangleCount);
+    CountGenerationMeshGroup(
+        generationNodeDrawSparseGrassPatch, gtid, all(gid == 0), inputRecord.Get().dispatchGrid.x, vertexCount, triangleCount);
 
     GrassVertex vertex;
 
@@ -79,7 +81,7 @@ void SparseGrassMeshShader(
 
     float3 color = pow(float3(0.41, 0.44, 0.29), 2.2) * .775;
 
-    const int2 gridBase = inputRecord.Get().position[gid.x] * grassPatchesPerDetailedTile;
+    const int2 gridBase = (inputRecord.Get().origin + inputRecord.Get().position[gid.x]) * grassPatchesPerDetailedTile;
 
     static const float3 grassColor = float3(0.130139, 0.149961, 0.059513);
 
@@ -92,12 +94,14 @@ void SparseGrassMeshShader(
 
         const float2 pos = GetPatchPosition(patch, gid.y, gridBase);
 
-        float3 patchNormal = GetTerrainNormal(pos);
+        const TerrainSample terrainSample = GetTerrainSample(pos);
 
-        float3 center = float3(pos.x, GetTerrainHeight(pos), pos.y);
+        float3 patchNormal = terrainSample.normal;
+
+        float3 center = float3(pos.x, terrainSample.height, pos.y);
 
         // Fade grass into the ground in the distance
-        const float distanceScale = smoothstep(sparseGrassMaxDistance * 0.9, sparseGrassMaxDistance, distance(center, GetCameraPosition()));
+        const float distanceScale = smoothstep(GetSparseGrassMaxDistance() * 0.9, GetSparseGrassMaxDistance(), distance(center, GetCameraPosition()));
         center.y -= high * distanceScale;
 
         float3 center2cam = normalize(GetCameraPosition() - center);
@@ -128,11 +132,12 @@ void SparseGrassMeshShader(
         const int patch = gtid / 2;
         const int base  = 4 * patch;
 
-        const float2 pos    = GetPatchPosition(patch, gid.y, gridBase);
-        const float3 center = float3(pos.x, GetTerrainHeight(pos), pos.y);
+        const float2        pos           = GetPatchPosition(patch, gid.y, gridBase);
+        const TerrainSample terrainSample = GetTerrainSample(pos);
+        const float3        center        = float3(pos.x, terrainSample.height, pos.y);
 
-        const float3 terrainNormal = GetTerrainNormal(pos);
-        const float3 biomeWeight   = GetBiomeWeights(pos);
+        const float3 terrainNormal = terrainSample.normal;
+        const float3 biomeWeight   = terrainSample.biomeWeights;
 
         const bool cull = (Random(asuint(pos.x), asuint(pos.y), 2378) < biomeWeight.x * 2) ||
                           (terrainNormal.y < 0.55);
@@ -0,0 +1,77 @@
+// This file is part of the AMD Work Graph Mesh Node Sample.
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+
+#include "common.hlsl"
+
+// Spline generated by the tree & rock nodes. Splines which exceed the output limits of the spline mesh node
+// are split into several pieces by WriteSpline, see splinesplitting.h.
+struct GeneratedSpline {
+    float2 origin;
+    float3 color;
+    float  rotationOffset;
+    float2 windStrength;
+    uint   controlPointCount;
+    // packed vertex counts, see EncodeVertexCounts
+    uint2  vertexCounts;
+    float3 positions[splineMaxControlPointCount];
+    float2 radii[splineMaxControlPointCount];
+    float  noiseAmplitudes[splineMaxControlPointCount];
+};
+
+void SetControlPoint(inout GeneratedSpline spline, in uint index, in float3 position, in float2 radius, in float noiseAmplitude)
+{
+    spline.positions[index]       = position;
+    spline.radii[index]           = radius;
+    spline.noiseAmplitudes[index] = noiseAmplitude;
+}
+
+// Writes the pieces of a spline to the records firstRecord to firstRecord + pieceCapacity - 1.
+// Records without a piece get an empty spline, which does not output any vertices.
+void WriteSpline(GroupNodeOutputRecords<DrawSplineRecord> records,
+                 in uint                                  firstRecord,
+                 in uint                                  pieceCapacity,
+                 in uint                                  splineIndex,
+                 in GeneratedSpline                       spline)
+{
+    for (uint pieceIndex = 0; pieceIndex < pieceCapacity; ++pieceIndex) {
+        const SplinePiece piece  = GetSplinePiece(spline.vertexCounts, spline.controlPointCount, pieceIndex);
+        const uint        record = firstRecord + pieceIndex;
+
+        records.Get(record).color[splineIndex]                    = EncodeHalf(spline.color);
+        records.Get(record).rotationOffset[splineIndex]           = EncodeHalf(spline.rotationOffset);
+        records.Get(record).windStrength[splineIndex]             = EncodeHalf(spline.windStrength);
+        records.Get(record).controlPointCount[splineIndex]        = piece.controlPointCount;
+        records.Get(record).origin[splineIndex]                   = spline.origin;
+        records.Get(record).controlPointVertexCounts[splineIndex] = piece.vertexCounts;
+        records.Get(record).ringPrefixSums[splineIndex]           = ComputeSplinePrefixSums(piece.vertexCounts, piece.controlPointCount);
+
+        for (uint i = 0; i < piece.controlPointCount; ++i) {
+            const uint controlPointIndex = splineIndex * splineMaxControlPointCount + i;
+            const uint controlPoint      = piece.firstControlPoint + i;
+
+            records.Get(record).controlPointPositions[controlPointIndex]       = EncodeRecordPosition(spline.positions[controlPoint], spline.origin);
+            records.Get(record).controlPointRadii[controlPointIndex]           = EncodeHalf(spline.radii[controlPoint]);
+            records.Get(record).controlPointNoiseAmplitudes[controlPointIndex] = EncodeHalf(spline.noiseAmplitudes[controlPoint]);
+        }
+    }
+}
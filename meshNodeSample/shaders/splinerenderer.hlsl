@@ -28,14 +28,10 @@ struct TransformedVertex {
     float3 color : NORMAL1;
 };
 
-// Returns number of line sections in a vertex ring
-int GetRingSectionCount(in int ringVertexCount) {
-    return ringVertexCount == 1 ? 0 : ringVertexCount;
-}
-
-static const int splineGroupSize         = 128;
-static const int numOutputVerticesLimit  = 64;
-static const int numOutputTrianglesLimit = 128;
+// Output limits are shared with the generator nodes, which split splines exceeding them, see splinesplitting.h
+static const int splineGroupSize         = splineMeshThreadCount;
+static const int numOutputVerticesLimit  = splineMeshMaxVertexCount;
+static const int numOutputTrianglesLimit = splineMeshMaxTriangleCount;
 
 [Shader("node")]
 [NodeLaunch("mesh")]
@@ -46,7 +42,7 @@ static const int numOutputTrianglesLimit = 128;
 // and you are running on a non-AMD GPU, you may need to adjust this limit.
 // You can learn more at: 
 // https://gpuopen.com/learn/work_graphs_mesh_nodes/work_graphs_mesh_nodes-tips_tricks_best_practices
-[NodeMaxInputRecordsPerGraphEntryRecord(10000, true)]
+[NodeMaxInputRecordsPerGraphEntryRecord(drawSplineMaxInputRecords, true)]
 [NumThreads(splineGroupSize, 1, 1)]
 [OutputTopology("triangle")]
 void SplineMeshShader(
@@ -56,116 +52,64 @@ void SplineMeshShader(
     out indices uint3                         tris[numOutputTrianglesLimit],
     out vertices TransformedVertex            verts[numOutputVerticesLimit])
 {
-    const uint splineControlPointCount = clamp(inputRecord.Get().controlPointCount[gid], 0, splineMaxControlPointCount);
-    const uint splineSectionCount      = clamp(int(splineControlPointCount) - 1, 0, splineMaxControlPointCount - 1);
+    const uint splineControlPointCount = clamp(uint(inputRecord.Get().controlPointCount[gid]), 0, splineMaxControlPointCount);
 
     const uint controlPointOffset = gid * splineMaxControlPointCount;
 
-    uint vertexOutputCount    = 0;
-    uint primitiveOutputCount = 0;
-
-    // control point for which the current thread will create a vertex
-    int threadVertexControlPoint       = 0;
-    // index on control point ring which the current thread will generate
-    int threadVertexControlPointVertex = 0;
-
-    // control point section for which the current thread will create a triangle
-    int threadPrimitiveSection                     = 0;
-    // index on control point ring which the current thread will generate
-    int threadPrimitiveSectionTriangle             = 0;
-    int threadPrimitiveSectionVertexOffset = 0;
+    // quantized control point positions are relative to the spline origin, vertex counts are packed, see recordencoding.h
+    const float2 splineOrigin       = inputRecord.Get().origin[gid];
+    const uint2  splineVertexCounts = inputRecord.Get().controlPointVertexCounts[gid];
 
-    {
-        // Number of vertices in last vertex ring
-        int lastRingVertexCount = 0;
+    // inclusive prefix sums of the ring vertex counts (xy) & section triangle counts (zw), written by the generator nodes
+    const uint4 ringPrefixSums = inputRecord.Get().ringPrefixSums[gid];
 
-        // count vertices in first ring
-        {
-            const int controlPointVertexCount = inputRecord.Get().controlPointVertexCounts[controlPointOffset];
+    uint vertexOutputCount    = (splineControlPointCount > 0) ? DecodeSplinePrefixSum(ringPrefixSums.xy, splineControlPointCount - 1) : 0;
+    uint primitiveOutputCount = (splineControlPointCount > 1) ? DecodeSplinePrefixSum(ringPrefixSums.zw, splineControlPointCount - 2) : 0;
 
-            // check if current thread will generate a vertex on this ring
-            if (threadId < controlPointVertexCount)
-            {
-                threadVertexControlPoint       = 0;
-                threadVertexControlPointVertex = threadId;
-            }
-
-            // Count total number of vertices
-            vertexOutputCount += controlPointVertexCount;
-
-            // Update last ring size
-            lastRingVertexCount = controlPointVertexCount;
-        }
-
-        // count vertex & triangles count for every ring
-        for (int ring = 1; ring < splineControlPointCount; ++ring)
-        {
-            const int controlPointVertexCount = inputRecord.Get().controlPointVertexCounts[controlPointOffset + ring];
-
-            if ((vertexOutputCount <= threadId) && ((vertexOutputCount + controlPointVertexCount) > threadId))
-            {
-                threadVertexControlPoint       = ring;
-                threadVertexControlPointVertex = threadId - int(vertexOutputCount);
-            }
-
-            // lower sections are on last ring
-            const int lowerSectionCount = GetRingSectionCount(lastRingVertexCount);
-            // upper sections are on current ring
-            const int upperSectionCount = GetRingSectionCount(controlPointVertexCount);
-
-            // Count number of regular sections (i.e. one edge of the lower ring maps to one section on the upper ring)
-            const int sectionCount         = min(lowerSectionCount, upperSectionCount);
-            const int regularTriangleCount = sectionCount * 2;
-            // Count number of irregular trianlges (i.e. a edge connects with a single vertex on the other ring)
-            const int irregularTriangleCount = max(lowerSectionCount, upperSectionCount) - sectionCount;
-
-            // Total number of triangles on this ring
-            const int triangleCount = regularTriangleCount + irregularTriangleCount;
-
-            if ((primitiveOutputCount <= threadId) && ((primitiveOutputCount + triangleCount) > threadId))
-            {
-                // Primitives are generated from lower to upper ring, i.e. we need the index of the last ring
-                threadPrimitiveSection         = ring - 1;
-                threadPrimitiveSectionTriangle = threadId - primitiveOutputCount;
-                // Get index of first vertex in last ring
-                threadPrimitiveSectionVertexOffset = vertexOutputCount - lastRingVertexCount;
-            }
-
-            // Count total number of vertices & triangles
-            vertexOutputCount += controlPointVertexCount;
-            primitiveOutputCount += triangleCount;
+    // control point for which the current thread will create a vertex
+    const int threadVertexControlPoint       = FindSplinePrefixSumIndex(ringPrefixSums.xy, threadId);
+    // index on control point ring which the current thread will generate
+    const int threadVertexControlPointVertex = threadId - GetSplinePrefixSumOffset(ringPrefixSums.xy, threadVertexControlPoint);
 
-            // Update last ring size
-            lastRingVertexCount = controlPointVertexCount;
-        }
-    }
+    // control point section for which the current thread will create a triangle.
+    // Primitives are generated from lower to upper ring, i.e. section i connects ring i & i + 1
+    const int threadPrimitiveSection             = FindSplinePrefixSumIndex(ringPrefixSums.zw, threadId);
+    // index of the triangle within the section
+    const int threadPrimitiveSectionTriangle     = threadId - GetSplinePrefixSumOffset(ringPrefixSums.zw, threadPrimitiveSection);
+    // index of first vertex in the lower ring of the section
+    const int threadPrimitiveSectionVertexOffset = GetSplinePrefixSumOffset(ringPrefixSums.xy, threadPrimitiveSection);
 
     vertexOutputCount = min(vertexOutputCount, numOutputVerticesLimit);
     primitiveOutputCount = min(primitiveOutputCount, numOutputTrianglesLimit);
     
     SetMeshOutputCounts(vertexOutputCount, primitiveOutputCount);
+    CountGenerationMeshGroup(
+        generationNodeDrawSpline, threadId, gid == 0, inputRecord.Get().dispatchGrid.x, vertexOutputCount, primitiveOutputCount);
 
     if (threadId < vertexOutputCount) {
         TransformedVertex vertex;
 
         // Base position to compute object-local positions
-        const float3 splineBasePosition = inputRecord.Get().controlPointPositions[controlPointOffset];
+        const float3 splineBasePosition = DecodeRecordPosition(inputRecord.Get().controlPointPositions[controlPointOffset], splineOrigin);
 
-        const float3 controlPointPosition    = inputRecord.Get().controlPointPositions[controlPointOffset + threadVertexControlPoint];
-        const uint   controlPointVertexCount = inputRecord.Get().controlPointVertexCounts[controlPointOffset + threadVertexControlPoint];
+        const float3 controlPointPosition =
+            DecodeRecordPosition(inputRecord.Get().controlPointPositions[controlPointOffset + threadVertexControlPoint], splineOrigin);
+        const uint controlPointVertexCount = DecodeVertexCount(splineVertexCounts, threadVertexControlPoint);
 
         // Compute forward vector based on previous and next control point positions
         float3 forward = float3(0, 0, 0);
         // Add direction from previous control point
         if (threadVertexControlPoint > 0)
         {
-            const float3 previousControlPointPosition = inputRecord.Get().controlPointPositions[controlPointOffset + threadVertexControlPoint - 1];
+            const float3 previousControlPointPosition =
+                DecodeRecordPosition(inputRecord.Get().controlPointPositions[controlPointOffset + threadVertexControlPoint - 1], splineOrigin);
             forward += controlPointPosition - previousControlPointPosition;
         }
         // Add direction to next control point
         if (threadVertexControlPoint < (splineControlPointCount - 1))
         {
-            const float3 nextControlPointPosition = inputRecord.Get().controlPointPositions[controlPointOffset + threadVertexControlPoint + 1];
+            const float3 nextControlPointPosition =
+                DecodeRecordPosition(inputRecord.Get().controlPointPositions[controlPointOffset + threadVertexControlPoint + 1], splineOrigin);
             forward += nextControlPointPosition - controlPointPosition;
         }
 
@@ -175,11 +119,11 @@ void SplineMeshShader(
         float3 right = normalize(cross(forward, float3(1, 0, 0)));
         float3 up    = normalize(cross(forward, right));
 
-        const float rotationOffset = inputRecord.Get().rotationOffset[gid];
+        const float rotationOffset = DecodeHalf(inputRecord.Get().rotationOffset[gid]);
         const float vertexAlpha    = rotationOffset + (threadVertexControlPointVertex / float(controlPointVertexCount)) * 2.f * PI;
 
-        const float2 radius         = inputRecord.Get().controlPointRadii[controlPointOffset + threadVertexControlPoint];
-        const float  noiseAmplitude = inputRecord.Get().controlPointNoiseAmplitudes[controlPointOffset + threadVertexControlPoint];
+        const float2 radius         = DecodeHalf(inputRecord.Get().controlPointRadii[controlPointOffset + threadVertexControlPoint]);
+        const float  noiseAmplitude = DecodeHalf(inputRecord.Get().controlPointNoiseAmplitudes[controlPointOffset + threadVertexControlPoint]);
 
         // random noise value in [-noiseAmplitude; noiseAmplitude]
         const float noise = (Random(Hash(controlPointPosition), Hash(vertexAlpha)) * 2.0 - 1.0) * noiseAmplitude;
@@ -194,7 +138,7 @@ void SplineMeshShader(
         // y = factor for how much the actual vertex position in influencing the wind offset
         //     0 = wind offset is only determined by control point position
         //     1 = wind offset is only determined by vertex position
-        const float2 windStrength          = inputRecord.Get().windStrength[gid];
+        const float2 windStrength          = DecodeHalf(inputRecord.Get().windStrength[gid]);
         const float3 windReferencePosition = lerp(controlPointPosition, worldSpaceBasePosition, windStrength.y);
         // Get Height above terrain scaled by wind strength
         const float vertexHeight = max(windReferencePosition.y - GetTerrainHeight(windReferencePosition.xz), 0) * windStrength.x;
@@ -208,7 +152,7 @@ void SplineMeshShader(
         // compute position relative to first control point
         // this improve floating-point precision of ddx & ddy derivatives in pixel shader
         vertex.objectSpacePosition = worldSpaceBasePosition - splineBasePosition + windOffset;
-        vertex.color               = inputRecord.Get().color[gid];
+        vertex.color               = DecodeHalf(inputRecord.Get().color[gid]);
 
         ComputeClipSpacePositionAndMotion(
             vertex, worldSpaceBasePosition + windOffset, worldSpaceBasePosition + previousWindOffset);
@@ -219,12 +163,12 @@ void SplineMeshShader(
 
     if (threadId < primitiveOutputCount) {
         // Get number of vertices in current (lower) and next (upper) ring
-        const int lowerVertexCount = inputRecord.Get().controlPointVertexCounts[controlPointOffset + threadPrimitiveSection];
-        const int upperVertexCount = inputRecord.Get().controlPointVertexCounts[controlPointOffset + threadPrimitiveSection + 1];
+        const int lowerVertexCount = DecodeVertexCount(splineVertexCounts, threadPrimitiveSection);
+        const int upperVertexCount = DecodeVertexCount(splineVertexCounts, threadPrimitiveSection + 1);
 
         // Get number of sections in current and next ring
-        const int lowerSectionCount = GetRingSectionCount(lowerVertexCount);
-        const int upperSectionCount = GetRingSectionCount(upperVertexCount);
+        const int lowerSectionCount = GetSplineRingSectionCount(lowerVertexCount);
+        const int upperSectionCount = GetSplineRingSectionCount(upperVertexCount);
 
         // Get index of first vertex in current and next ring
         const int lowerVertexOffset = threadPrimitiveSectionVertexOffset;
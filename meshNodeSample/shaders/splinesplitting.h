@@ -0,0 +1,230 @@
+// This file is part of the AMD Work Graph Mesh Node Sample.
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#pragma once
+
+// Output limits of the spline mesh node, splitting of splines which exceed them & the ring prefix sums of the spline records,
+// see SplineMeshShader in splinerenderer.hlsl.
+// Shared by the shaders & the CPU emulator (meshNodeCpu/worldgraph.h), thus only types & intrinsics available in both languages are used.
+//  - a spline is split into pieces of consecutive rings, which are rendered by separate mesh shader thread groups.
+//    Pieces overlap by one ring, i.e. the last ring of a piece is the first ring of the next piece.
+//  - each piece keeps the control points next to its first & last ring as direction-only control points without vertices.
+//    The overlapping ring thus has the same forward direction, i.e. the same vertices, in both pieces.
+//  - a single section which exceeds the limits cannot be split & is still clamped by the mesh shader.
+
+#include "recordencoding.h"
+
+#if __cplusplus
+namespace meshnode
+{
+#endif  // __cplusplus
+
+static const uint32_t splineMeshThreadCount      = 128;
+static const uint32_t splineMeshMaxVertexCount   = 64;
+static const uint32_t splineMeshMaxTriangleCount = 128;
+// rings or sections per prefix sum table, i.e. 8 bit entries in an uint2
+static const uint32_t splinePrefixSumCount       = 8;
+
+// Number of line sections in a vertex ring
+inline uint32_t GetSplineRingSectionCount(uint32_t ringVertexCount)
+{
+    return (ringVertexCount == 1) ? 0 : ringVertexCount;
+}
+
+// Triangles between two consecutive rings, direction-only rings (without vertices) are not connected
+inline uint32_t GetSplineSectionTriangleCount(uint32_t lowerVertexCount, uint32_t upperVertexCount)
+{
+    if ((lowerVertexCount == 0) || (upperVertexCount == 0)) {
+        return 0;
+    }
+
+    const uint32_t lowerSectionCount = GetSplineRingSectionCount(lowerVertexCount);
+    const uint32_t upperSectionCount = GetSplineRingSectionCount(upperVertexCount);
+
+    // one edge of the smaller ring maps to one edge of the larger ring (two triangles),
+    // the remaining edges of the larger ring connect to a single vertex of the smaller ring
+    const uint32_t sectionCount       = (lowerSectionCount < upperSectionCount) ? lowerSectionCount : upperSectionCount;
+    const uint32_t largerSectionCount = (lowerSectionCount < upperSectionCount) ? upperSectionCount : lowerSectionCount;
+
+    return sectionCount * 2 + (largerSectionCount - sectionCount);
+}
+
+// controlPointIndex is the index within the spline, see DecodeVertexCount
+inline uint2 SetVertexCount(uint2 counts, uint32_t controlPointIndex, uint32_t vertexCount)
+{
+    const uint32_t shift = (controlPointIndex % 4) * 8;
+    const uint32_t mask  = 0xFFu << shift;
+
+    if (controlPointIndex < 4) {
+        counts.x = (counts.x & ~mask) | ((vertexCount & 0xFFu) << shift);
+    } else {
+        counts.y = (counts.y & ~mask) | ((vertexCount & 0xFFu) << shift);
+    }
+
+    return counts;
+}
+
+// Last ring of the piece starting at firstRing, pieces contain at least two rings
+inline uint32_t GetSplinePieceLastRing(uint2 vertexCounts, uint32_t controlPointCount, uint32_t firstRing)
+{
+    uint32_t vertexCount   = DecodeVertexCount(vertexCounts, firstRing);
+    uint32_t triangleCount = 0;
+    uint32_t lastRing      = firstRing;
+
+    for (uint32_t ring = firstRing + 1; ring < controlPointCount; ++ring) {
+        const uint32_t ringVertexCount = DecodeVertexCount(vertexCounts, ring);
+
+        vertexCount += ringVertexCount;
+        triangleCount += GetSplineSectionTriangleCount(DecodeVertexCount(vertexCounts, ring - 1), ringVertexCount);
+
+        if ((ring > (firstRing + 1)) && ((vertexCount > splineMeshMaxVertexCount) || (triangleCount > splineMeshMaxTriangleCount))) {
+            break;
+        }
+
+        lastRing = ring;
+    }
+
+    return lastRing;
+}
+
+inline uint32_t GetSplinePieceCount(uint2 vertexCounts, uint32_t controlPointCount)
+{
+    uint32_t pieceCount = 1;
+    uint32_t lastRing   = GetSplinePieceLastRing(vertexCounts, controlPointCount, 0);
+
+    while ((lastRing + 1) < controlPointCount) {
+        lastRing = GetSplinePieceLastRing(vertexCounts, controlPointCount, lastRing);
+        ++pieceCount;
+    }
+
+    return pieceCount;
+}
+
+struct SplinePiece {
+    // first control point of the spline in the piece, including the direction-only control point before the first ring
+    uint32_t firstControlPoint;
+    // 0 if the spline has less pieces
+    uint32_t controlPointCount;
+    // vertex counts of the control points in the piece, direction-only control points have no vertices
+    uint2 vertexCounts;
+};
+
+inline SplinePiece GetSplinePiece(uint2 vertexCounts, uint32_t controlPointCount, uint32_t pieceIndex)
+{
+    SplinePiece piece;
+    piece.firstControlPoint = 0;
+    piece.controlPointCount = 0;
+    piece.vertexCounts      = uint2(0, 0);
+
+    if (controlPointCount == 0) {
+        return piece;
+    }
+
+    uint32_t firstRing = 0;
+
+    for (uint32_t i = 0; i < pieceIndex; ++i) {
+        const uint32_t lastRing = GetSplinePieceLastRing(vertexCounts, controlPointCount, firstRing);
+
+        if ((lastRing + 1) >= controlPointCount) {
+            return piece;
+        }
+
+        firstRing = lastRing;
+    }
+
+    const uint32_t lastRing         = GetSplinePieceLastRing(vertexCounts, controlPointCount, firstRing);
+    const uint32_t lastControlPoint = ((lastRing + 1) < controlPointCount) ? (lastRing + 1) : lastRing;
+
+    piece.firstControlPoint = (firstRing > 0) ? (firstRing - 1) : 0;
+    piece.controlPointCount = lastControlPoint - piece.firstControlPoint + 1;
+
+    for (uint32_t controlPoint = piece.firstControlPoint; controlPoint <= lastControlPoint; ++controlPoint) {
+        const bool     isRing      = (controlPoint >= firstRing) && (controlPoint <= lastRing);
+        const uint32_t vertexCount = isRing ? DecodeVertexCount(vertexCounts, controlPoint) : 0;
+
+        piece.vertexCounts = SetVertexCount(piece.vertexCounts, controlPoint - piece.firstControlPoint, vertexCount);
+    }
+
+    return piece;
+}
+
+// Inclusive prefix sums of the ring vertex counts (xy) & of the triangle counts of the sections between two rings (zw),
+// 8 bit per ring or section in the layout of EncodeVertexCounts. Sums saturate at 255, which is beyond any mesh shader thread.
+// Entries after the last ring or section are 255, such that they never own a vertex or triangle.
+// The generators write the sums to DrawSplineRecord::ringPrefixSums, mesh shader threads look up their ring & section with
+// FindSplinePrefixSumIndex instead of summing the counts of all rings.
+inline uint4 ComputeSplinePrefixSums(uint2 vertexCounts, uint32_t controlPointCount)
+{
+    uint2 vertexSums   = uint2(0, 0);
+    uint2 triangleSums = uint2(0, 0);
+
+    uint32_t vertexSum   = 0;
+    uint32_t triangleSum = 0;
+
+    for (uint32_t ring = 0; ring < splinePrefixSumCount; ++ring) {
+        if (ring < controlPointCount) {
+            vertexSum += DecodeVertexCount(vertexCounts, ring);
+        } else {
+            vertexSum = 255;
+        }
+
+        // section i connects ring i & i + 1
+        if ((ring + 1) < controlPointCount) {
+            triangleSum += GetSplineSectionTriangleCount(DecodeVertexCount(vertexCounts, ring), DecodeVertexCount(vertexCounts, ring + 1));
+        } else {
+            triangleSum = 255;
+        }
+
+        vertexSums   = SetVertexCount(vertexSums, ring, (vertexSum < 255) ? vertexSum : 255);
+        triangleSums = SetVertexCount(triangleSums, ring, (triangleSum < 255) ? triangleSum : 255);
+    }
+
+    return uint4(vertexSums.x, vertexSums.y, triangleSums.x, triangleSums.y);
+}
+
+inline uint32_t DecodeSplinePrefixSum(uint2 prefixSums, uint32_t index)
+{
+    return DecodeVertexCount(prefixSums, index);
+}
+
+// Ring or section which owns vertex or triangle itemIndex, i.e. the number of inclusive prefix sums up to itemIndex.
+// itemIndex must be below 255, i.e. holds for all mesh shader threads.
+inline uint32_t FindSplinePrefixSumIndex(uint2 prefixSums, uint32_t itemIndex)
+{
+    uint32_t index = 0;
+
+    for (uint32_t i = 0; i < splinePrefixSumCount; ++i) {
+        index += (DecodeSplinePrefixSum(prefixSums, i) <= itemIndex) ? 1 : 0;
+    }
+
+    return index;
+}
+
+// First vertex or triangle of a ring or section
+inline uint32_t GetSplinePrefixSumOffset(uint2 prefixSums, uint32_t index)
+{
+    return (index > 0) ? DecodeSplinePrefixSum(prefixSums, index - 1) : 0;
+}
+
+#if __cplusplus
+}  // namespace meshnode
+#endif  // __cplusplus
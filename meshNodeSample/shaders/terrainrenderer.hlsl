@@ -58,7 +58,7 @@ uint3 GetPrimitive(uint index, in uint primitivesPerRow)
 // and you are running on a non-AMD GPU, you may need to adjust this limit.
 // You can learn more at: 
 // https://gpuopen.com/learn/work_graphs_mesh_nodes/work_graphs_mesh_nodes-tips_tricks_best_practices
-[NodeMaxInputRecordsPerGraphEntryRecord(32 * 32, true)]
+[NodeMaxInputRecordsPerGraphEntryRecord(drawTerrainChunkMaxInputRecords, true)]
 [NumThreads(128, 1, 1)]
 [OutputTopology("triangle")]
 void TerrainMeshShader(
@@ -86,6 +86,7 @@ void TerrainMeshShader(
     const int primitiveCount = primitivesPerAxis * primitivesPerAxis * 2;
 
     SetMeshOutputCounts(vertexCount, primitiveCount);
+    CountGenerationMeshGroup(generationNodeDrawTerrainChunk, gtid, all(gid == 0), 0, vertexCount, primitiveCount);
 
     const int2 tile = record.chunkGridPosition * baseThreadGroupsPerChunkAxis + int2(gid.xy) * threadGroupIdScale;
 
@@ -120,10 +121,11 @@ void TerrainMeshShader(
 
         const float2 globalVertexPosition = globalVertexIndex * scale;
 
-        const float3 worldSpacePosition =
-            float3(globalVertexPosition.x, GetTerrainHeight(globalVertexPosition), globalVertexPosition.y);
+        const TerrainSample terrainSample = GetTerrainSample(globalVertexPosition);
+        const float3        worldSpacePosition =
+            float3(globalVertexPosition.x, terrainSample.height, globalVertexPosition.y);
 
-        vertex.normal             = GetTerrainNormal(worldSpacePosition.xz);
+        vertex.normal             = terrainSample.normal;
         vertex.worldSpacePosition = worldSpacePosition;
         ComputeClipSpacePositionAndMotion(vertex, worldSpacePosition);
 
@@ -19,7 +19,13 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 // THE SOFTWARE.
 
-#include "common.hlsl"
+
+#include "splinegeneration.hlsl"
+
+// Pine tree leaves use dense vertex rings, which exceed the output limits of the spline mesh node.
+// The leaves are thus split into two pieces, see WriteSpline.
+static const uint pineLeafRingVertexCount  = 16;
+static const uint pineLeafSplinePieceCount = 2;
 
 // Oak tree generation is single-threaded, so we use a coalescing node to generate multiple trees at once.
 // Each oka tree consists of three splines: the trunk, a branch and the leafes.
@@ -38,17 +44,25 @@ void GenerateOakTree(
     [NodeId("DrawSpline")]
     NodeOutput<DrawSplineRecord> output)
 {
+    CountGenerationGroup(generationNodeGenerateOakTree, threadId, true, inputRecord.Count());
+
     GroupNodeOutputRecords<DrawSplineRecord> outputRecord = output.GetGroupNodeOutputRecords(3);
 
+    if (threadId < 3) {
+        // Set dispatch grid to number of splines per record
+        outputRecord.Get(threadId).dispatchGrid = uint3(inputRecord.Count(), 1, 1);
+    }
+
     if (threadId < inputRecord.Count()) {
-        const float2 basePositionXZ = inputRecord.Get(threadId).position;
-        const float3 basePosition   = GetTerrainPosition(basePositionXZ);
+        const float2        basePositionXZ = inputRecord.Get(threadId).position;
+        const TerrainSample terrainSample  = GetTerrainSample(basePositionXZ);
+        const float3        basePosition   = float3(basePositionXZ.x, terrainSample.height, basePositionXZ.y);
 
         const uint seed = CombineSeed(asuint(basePositionXZ.x), asuint(basePositionXZ.y));
 
         const float  rotationAngle = Random(seed, 78923) * 2 * PI;
         const float3 forward       = float3(sin(rotationAngle), 0, cos(rotationAngle));
-        const float3 up            = lerp(float3(0, 1, 0), GetTerrainNormal(basePositionXZ), 0.1);
+        const float3 up            = lerp(float3(0, 1, 0), terrainSample.normal, 0.1);
         const float3 side          = normalize(cross(forward, up));
 
         const float upScale   = lerp(0.5, 1.2, Random(seed, 546));
@@ -58,115 +72,59 @@ void GenerateOakTree(
 
         // Tree trunk
         {
-            // Set dispatch grid to number of splines per record
-            outputRecord.Get(0).dispatchGrid                   = uint3(inputRecord.Count(), 1, 1);
-            outputRecord.Get(0).color[splineIndex]             = float3(0.18, 0.12, 0.10) * 6;
-            outputRecord.Get(0).rotationOffset[splineIndex]    = 0;
-            outputRecord.Get(0).windStrength[splineIndex]      = float2(0, 0);
-            outputRecord.Get(0).controlPointCount[splineIndex] = 5;
-
-            int controlPointIndex = splineIndex * splineMaxControlPointCount;
-
-            outputRecord.Get(0).controlPointPositions[controlPointIndex]       = basePosition - up;
-            outputRecord.Get(0).controlPointVertexCounts[controlPointIndex]    = 5;
-            outputRecord.Get(0).controlPointRadii[controlPointIndex]           = 0.5 * sideScale;
-            outputRecord.Get(0).controlPointNoiseAmplitudes[controlPointIndex] = 0.0;
-            controlPointIndex++;
-
-            outputRecord.Get(0).controlPointPositions[controlPointIndex]       = basePosition + 2 * upScale * up;
-            outputRecord.Get(0).controlPointVertexCounts[controlPointIndex]    = 4;
-            outputRecord.Get(0).controlPointRadii[controlPointIndex]           = 0.35 * sideScale;
-            outputRecord.Get(0).controlPointNoiseAmplitudes[controlPointIndex] = 0.5;
-            controlPointIndex++;
-
-            outputRecord.Get(0).controlPointPositions[controlPointIndex] =
-                basePosition + 4 * upScale * up + 1 * sideScale * forward;
-            outputRecord.Get(0).controlPointVertexCounts[controlPointIndex]    = 3;
-            outputRecord.Get(0).controlPointRadii[controlPointIndex]           = 0.25 * sideScale;
-            outputRecord.Get(0).controlPointNoiseAmplitudes[controlPointIndex] = 0.0;
-            controlPointIndex++;
-
-            outputRecord.Get(0).controlPointPositions[controlPointIndex] =
-                basePosition + 4.5 * upScale * up + 1.5 * sideScale * forward + 0.5 * sideScale * side;
-            outputRecord.Get(0).controlPointVertexCounts[controlPointIndex]    = 2;
-            outputRecord.Get(0).controlPointRadii[controlPointIndex]           = 0.3 * sideScale;
-            outputRecord.Get(0).controlPointNoiseAmplitudes[controlPointIndex] = 0.0;
-            controlPointIndex++;
-
-            outputRecord.Get(0).controlPointPositions[controlPointIndex] =
-                basePosition + 5.5 * upScale * up + 2 * sideScale * forward + 1 * sideScale * side;
-            outputRecord.Get(0).controlPointVertexCounts[controlPointIndex]    = 1;
-            outputRecord.Get(0).controlPointRadii[controlPointIndex]           = 0.0;
-            outputRecord.Get(0).controlPointNoiseAmplitudes[controlPointIndex] = 0.0;
+            GeneratedSpline spline;
+            spline.origin            = basePositionXZ;
+            spline.color             = float3(0.18, 0.12, 0.10) * 6;
+            spline.rotationOffset    = 0;
+            spline.windStrength      = float2(0, 0);
+            spline.controlPointCount = 5;
+            spline.vertexCounts      = uint2(EncodeVertexCounts(5, 4, 3, 2), EncodeVertexCounts(1, 0, 0, 0));
+
+            SetControlPoint(spline, 0, basePosition - up, 0.5 * sideScale, 0.0);
+            SetControlPoint(spline, 1, basePosition + 2 * upScale * up, 0.35 * sideScale, 0.5);
+            SetControlPoint(spline, 2, basePosition + 4 * upScale * up + 1 * sideScale * forward, 0.25 * sideScale, 0.0);
+            SetControlPoint(spline, 3, basePosition + 4.5 * upScale * up + 1.5 * sideScale * forward + 0.5 * sideScale * side, 0.3 * sideScale, 0.0);
+            SetControlPoint(spline, 4, basePosition + 5.5 * upScale * up + 2 * sideScale * forward + 1 * sideScale * side, 0.0, 0.0);
+
+            WriteSpline(outputRecord, 0, 1, splineIndex, spline);
         }
 
         // Tree branch
         {
-            outputRecord.Get(1).dispatchGrid                   = uint3(inputRecord.Count(), 1, 1);
-            outputRecord.Get(1).color[splineIndex]             = float3(0.18, 0.12, 0.10) * 6;
-            outputRecord.Get(1).rotationOffset[splineIndex]    = 0;
-            outputRecord.Get(1).windStrength[splineIndex]      = float2(0, 0);
-            outputRecord.Get(1).controlPointCount[splineIndex] = 3;
-
-            int controlPointIndex = splineIndex * splineMaxControlPointCount;
-
-            outputRecord.Get(1).controlPointPositions[controlPointIndex] =
-                basePosition + 3 * upScale * up + 0.5 * sideScale * forward;
-            outputRecord.Get(1).controlPointVertexCounts[controlPointIndex]    = 4;
-            outputRecord.Get(1).controlPointRadii[controlPointIndex]           = 0.25 * sideScale;
-            outputRecord.Get(1).controlPointNoiseAmplitudes[controlPointIndex] = 0.0;
-            controlPointIndex++;
-
-            outputRecord.Get(1).controlPointPositions[controlPointIndex] =
-                basePosition + 4 * upScale * up - 0.5 * sideScale * forward;
-            outputRecord.Get(1).controlPointVertexCounts[controlPointIndex]    = 3;
-            outputRecord.Get(1).controlPointRadii[controlPointIndex]           = 0.2 * sideScale;
-            outputRecord.Get(1).controlPointNoiseAmplitudes[controlPointIndex] = 0.25;
-            controlPointIndex++;
-
-            outputRecord.Get(1).controlPointPositions[controlPointIndex] =
-                basePosition + 5 * upScale * up - 1 * sideScale * forward;
-            outputRecord.Get(1).controlPointVertexCounts[controlPointIndex]    = 1;
-            outputRecord.Get(1).controlPointRadii[controlPointIndex]           = 0.0;
-            outputRecord.Get(1).controlPointNoiseAmplitudes[controlPointIndex] = 0.0;
+            GeneratedSpline spline;
+            spline.origin            = basePositionXZ;
+            spline.color             = float3(0.18, 0.12, 0.10) * 6;
+            spline.rotationOffset    = 0;
+            spline.windStrength      = float2(0, 0);
+            spline.controlPointCount = 3;
+            spline.vertexCounts      = uint2(EncodeVertexCounts(4, 3, 1, 0), EncodeVertexCounts(0, 0, 0, 0));
+
+            SetControlPoint(spline, 0, basePosition + 3 * upScale * up + 0.5 * sideScale * forward, 0.25 * sideScale, 0.0);
+            SetControlPoint(spline, 1, basePosition + 4 * upScale * up - 0.5 * sideScale * forward, 0.2 * sideScale, 0.25);
+            SetControlPoint(spline, 2, basePosition + 5 * upScale * up - 1 * sideScale * forward, 0.0, 0.0);
+
+            WriteSpline(outputRecord, 1, 1, splineIndex, spline);
         }
 
         // Tree leaves
         {
-            outputRecord.Get(2).dispatchGrid       = uint3(inputRecord.Count(), 1, 1);
-            outputRecord.Get(2).color[splineIndex] = float3(0.3, 0.3, 0.0) * lerp(0.7, 1.3, Random(seed, 1456));
-            outputRecord.Get(2).rotationOffset[splineIndex]    = rotationAngle;
-            outputRecord.Get(2).windStrength[splineIndex]      = float2(0.125, 0.5);
-            outputRecord.Get(2).controlPointCount[splineIndex] = 4;
-
-            int controlPointIndex = splineIndex * splineMaxControlPointCount;
-
-            outputRecord.Get(2).controlPointPositions[controlPointIndex] =
-                basePosition + 4 * upScale * up + 0.5 * sideScale * forward;
-            outputRecord.Get(2).controlPointVertexCounts[controlPointIndex]    = 1;
-            outputRecord.Get(2).controlPointRadii[controlPointIndex]           = 0.0;
-            outputRecord.Get(2).controlPointNoiseAmplitudes[controlPointIndex] = 0.0;
-            controlPointIndex++;
-
-            outputRecord.Get(2).controlPointPositions[controlPointIndex] =
-                basePosition + 5 * upScale * up + 0.5 * sideScale * forward;
-            outputRecord.Get(2).controlPointVertexCounts[controlPointIndex]    = round(lerp(5, 7, Random(seed, 2156)));
-            outputRecord.Get(2).controlPointRadii[controlPointIndex]           = float2(2.5, 4) * sideScale;
-            outputRecord.Get(2).controlPointNoiseAmplitudes[controlPointIndex] = 0.7 * upScale;
-            controlPointIndex++;
-
-            outputRecord.Get(2).controlPointPositions[controlPointIndex] =
-                basePosition + 6.5 * upScale * up + 0.5 * sideScale * forward;
-            outputRecord.Get(2).controlPointVertexCounts[controlPointIndex]    = round(lerp(3, 5, Random(seed, 458)));
-            outputRecord.Get(2).controlPointRadii[controlPointIndex]           = 3.5 * sideScale;
-            outputRecord.Get(2).controlPointNoiseAmplitudes[controlPointIndex] = 0.7 * upScale;
-            controlPointIndex++;
-
-            outputRecord.Get(2).controlPointPositions[controlPointIndex] =
-                basePosition + 8.5 * upScale * up + 0.5 * sideScale * forward + 0.5 * sideScale * side;
-            outputRecord.Get(2).controlPointVertexCounts[controlPointIndex]    = 1;
-            outputRecord.Get(2).controlPointRadii[controlPointIndex]           = 0.0;
-            outputRecord.Get(2).controlPointNoiseAmplitudes[controlPointIndex] = 0.0;
+            const uint leafVertexCount0 = round(lerp(5, 7, Random(seed, 2156)));
+            const uint leafVertexCount1 = round(lerp(3, 5, Random(seed, 458)));
+
+            GeneratedSpline spline;
+            spline.origin            = basePositionXZ;
+            spline.color             = float3(0.3, 0.3, 0.0) * lerp(0.7, 1.3, Random(seed, 1456));
+            spline.rotationOffset    = rotationAngle;
+            spline.windStrength      = float2(0.125, 0.5);
+            spline.controlPointCount = 4;
+            spline.vertexCounts      = uint2(EncodeVertexCounts(1, leafVertexCount0, leafVertexCount1, 1), EncodeVertexCounts(0, 0, 0, 0));
+
+            SetControlPoint(spline, 0, basePosition + 4 * upScale * up + 0.5 * sideScale * forward, 0.0, 0.0);
+            SetControlPoint(spline, 1, basePosition + 5 * upScale * up + 0.5 * sideScale * forward, float2(2.5, 4) * sideScale, 0.7 * upScale);
+            SetControlPoint(spline, 2, basePosition + 6.5 * upScale * up + 0.5 * sideScale * forward, 3.5 * sideScale, 0.7 * upScale);
+            SetControlPoint(spline, 3, basePosition + 8.5 * upScale * up + 0.5 * sideScale * forward + 0.5 * sideScale * side, 0.0, 0.0);
+
+            WriteSpline(outputRecord, 2, 1, splineIndex, spline);
         }
     }
 
@@ -174,7 +132,7 @@ void GenerateOakTree(
 }
 
 // Pine tree generation works the same way as the oak tree generation.
-// Each pine tree consists of two splines: the tree trunk and the "leaves".
+// Each pine tree consists of two splines: the tree trunk and the "leaves", which are split into pineLeafSplinePieceCount pieces.
 [Shader("node")]
 [NodeId("GenerateTree", 1)]
 [NodeLaunch("coalescing")]
@@ -185,17 +143,24 @@ void GeneratePineTree(
 
     uint threadId : SV_GroupThreadID,
 
-    [MaxRecords(2)]
+    [MaxRecords(1 + pineLeafSplinePieceCount)]
     [NodeId("DrawSpline")]
     NodeOutput<DrawSplineRecord> output)
 {
-    GroupNodeOutputRecords<DrawSplineRecord> outputRecord = output.GetGroupNodeOutputRecords(2);
+    CountGenerationGroup(generationNodeGeneratePineTree, threadId, true, inputRecord.Count());
+
+    GroupNodeOutputRecords<DrawSplineRecord> outputRecord = output.GetGroupNodeOutputRecords(1 + pineLeafSplinePieceCount);
+
+    if (threadId < (1 + pineLeafSplinePieceCount)) {
+        outputRecord.Get(threadId).dispatchGrid = uint3(inputRecord.Count(), 1, 1);
+    }
 
     if (threadId < inputRecord.Count()) {
-        const float2 basePositionXZ = inputRecord.Get(threadId).position;
-        const float3 basePosition   = GetTerrainPosition(basePositionXZ);
-        const float3 terrainNormal  = GetTerrainNormal(basePositionXZ);
-        const float3 basePositionUp = lerp(float3(0, 1, 0), terrainNormal, 0.1);
+        const float2        basePositionXZ = inputRecord.Get(threadId).position;
+        const TerrainSample terrainSample  = GetTerrainSample(basePositionXZ);
+        const float3        basePosition   = float3(basePositionXZ.x, terrainSample.height, basePositionXZ.y);
+        const float3        terrainNormal  = terrainSample.normal;
+        const float3        basePositionUp = lerp(float3(0, 1, 0), terrainNormal, 0.1);
 
         const uint seed = CombineSeed(asuint(basePositionXZ.x), asuint(basePositionXZ.y));
 
@@ -210,25 +175,18 @@ void GeneratePineTree(
 
         // Tree trunk
         {
-            outputRecord.Get(0).dispatchGrid                    = uint3(inputRecord.Count(), 1, 1);
-            outputRecord.Get(0).color[splineIndex]             = float3(1.08, 0.72, 0.6);
-            outputRecord.Get(0).rotationOffset[splineIndex]    = rotationAngle;
-            outputRecord.Get(0).windStrength[splineIndex]      = float2(0.125, 0);
-            outputRecord.Get(0).controlPointCount[splineIndex] = 2;
-
-            int controlPointIndex = splineIndex * splineMaxControlPointCount;
-
-            outputRecord.Get(0).controlPointPositions[controlPointIndex]       = basePosition - basePositionUp * 4.f;
-            outputRecord.Get(0).controlPointVertexCounts[controlPointIndex]    = 5;
-            outputRecord.Get(0).controlPointRadii[controlPointIndex]           = 0.4;
-            outputRecord.Get(0).controlPointNoiseAmplitudes[controlPointIndex] = 0.0;
-            controlPointIndex++;
-
-            outputRecord.Get(0).controlPointPositions[controlPointIndex] =
-                basePosition + float3(0, stemHeight + 0.5, 0);
-            outputRecord.Get(0).controlPointVertexCounts[controlPointIndex]    = 4;
-            outputRecord.Get(0).controlPointRadii[controlPointIndex]           = 0.3;
-            outputRecord.Get(0).controlPointNoiseAmplitudes[controlPointIndex] = 0;
+            GeneratedSpline spline;
+            spline.origin            = basePositionXZ;
+            spline.color             = float3(1.08, 0.72, 0.6);
+            spline.rotationOffset    = rotationAngle;
+            spline.windStrength      = float2(0.125, 0);
+            spline.controlPointCount = 2;
+            spline.vertexCounts      = uint2(EncodeVertexCounts(5, 4, 0, 0), EncodeVertexCounts(0, 0, 0, 0));
+
+            SetControlPoint(spline, 0, basePosition - basePositionUp * 4.f, 0.4, 0.0);
+            SetControlPoint(spline, 1, basePosition + float3(0, stemHeight + 0.5, 0), 0.3, 0);
+
+            WriteSpline(outputRecord, 0, 1, splineIndex, spline);
         }
 
         // Tree leaves
@@ -237,64 +195,33 @@ void GeneratePineTree(
             const float  brightness = PerlinNoise2D(0.4 * basePositionXZ + float2(498, 345));
             const float3 color      = float3(0.24, 0.25 + green * 0.15, 0.0) * (1.0 + brightness * 0.4);
 
-            outputRecord.Get(1).dispatchGrid                   = uint3(inputRecord.Count(), 1, 1);
-            outputRecord.Get(1).color[splineIndex]             = color;
-            outputRecord.Get(1).rotationOffset[splineIndex]    = rotationAngle;
-            outputRecord.Get(1).windStrength[splineIndex]      = float2(0.125, 0.5);
-            outputRecord.Get(1).controlPointCount[splineIndex] = 7;
-
-            int controlPointIndex = splineIndex * splineMaxControlPointCount;
-
-            const float ringHeight0                                         = stemHeight;
-            outputRecord.Get(1).controlPointPositions[controlPointIndex]    = basePosition + float3(0, ringHeight0, 0);
-            outputRecord.Get(1).controlPointVertexCounts[controlPointIndex] = 1;
-            outputRecord.Get(1).controlPointRadii[controlPointIndex]        = 0.0;
-            outputRecord.Get(1).controlPointNoiseAmplitudes[controlPointIndex] = 0.0;
-            controlPointIndex++;
-
-            outputRecord.Get(1).controlPointPositions[controlPointIndex] =
-                basePosition + float3(0, ringHeight0 + 0.5, 0);
-            outputRecord.Get(1).controlPointVertexCounts[controlPointIndex]    = 7;
-            outputRecord.Get(1).controlPointRadii[controlPointIndex]           = leafRadiusScale;
-            outputRecord.Get(1).controlPointNoiseAmplitudes[controlPointIndex] = 0.2;
-            controlPointIndex++;
-
-            const float ringHeight1                                         = stemHeight + 1 * leafSectionScale;
-            outputRecord.Get(1).controlPointPositions[controlPointIndex]    = basePosition + float3(0, ringHeight1, 0);
-            outputRecord.Get(1).controlPointVertexCounts[controlPointIndex] = 7;
-            outputRecord.Get(1).controlPointRadii[controlPointIndex]        = leafRadiusScale * 0.3;
-            outputRecord.Get(1).controlPointNoiseAmplitudes[controlPointIndex] = 0.1;
-            controlPointIndex++;
-
-            outputRecord.Get(1).controlPointPositions[controlPointIndex] =
-                basePosition + float3(0, ringHeight1 + 0.5, 0);
-            outputRecord.Get(1).controlPointVertexCounts[controlPointIndex]    = 7;
-            outputRecord.Get(1).controlPointRadii[controlPointIndex]           = leafRadiusScale * 0.8;
-            outputRecord.Get(1).controlPointNoiseAmplitudes[controlPointIndex] = 0.2;
-            controlPointIndex++;
-
-            const float ringHeight2                                         = stemHeight + 2 * leafSectionScale;
-            outputRecord.Get(1).controlPointPositions[controlPointIndex]    = basePosition + float3(0, ringHeight2, 0);
-            outputRecord.Get(1).controlPointVertexCounts[controlPointIndex] = 7;
-            outputRecord.Get(1).controlPointRadii[controlPointIndex]        = leafRadiusScale * 0.3;
-            outputRecord.Get(1).controlPointNoiseAmplitudes[controlPointIndex] = 0.1;
-            controlPointIndex++;
-
-            outputRecord.Get(1).controlPointPositions[controlPointIndex] =
-                basePosition + float3(0, ringHeight2 + 0.5, 0);
-            outputRecord.Get(1).controlPointVertexCounts[controlPointIndex]    = 7;
-            outputRecord.Get(1).controlPointRadii[controlPointIndex]           = leafRadiusScale * 0.6;
-            outputRecord.Get(1).controlPointNoiseAmplitudes[controlPointIndex] = 0.2;
-            controlPointIndex++;
-
-            const float ringHeight3                                         = stemHeight + 3 * leafSectionScale;
-            outputRecord.Get(1).controlPointPositions[controlPointIndex]    = basePosition + float3(0, ringHeight3, 0);
-            outputRecord.Get(1).controlPointVertexCounts[controlPointIndex] = 1;
-            outputRecord.Get(1).controlPointRadii[controlPointIndex]        = 0.0;
-            outputRecord.Get(1).controlPointNoiseAmplitudes[controlPointIndex] = 0.0;
-            controlPointIndex++;
+            const uint ringVertexCount = pineLeafRingVertexCount;
+
+            GeneratedSpline spline;
+            spline.origin            = basePositionXZ;
+            spline.color             = color;
+            spline.rotationOffset    = rotationAngle;
+            spline.windStrength      = float2(0.125, 0.5);
+            spline.controlPointCount = 7;
+            spline.vertexCounts      = uint2(EncodeVertexCounts(1, ringVertexCount, ringVertexCount, ringVertexCount),
+                                        EncodeVertexCounts(ringVertexCount, ringVertexCount, 1, 0));
+
+            const float ringHeight0 = stemHeight;
+            const float ringHeight1 = stemHeight + 1 * leafSectionScale;
+            const float ringHeight2 = stemHeight + 2 * leafSectionScale;
+            const float ringHeight3 = stemHeight + 3 * leafSectionScale;
+
+            SetControlPoint(spline, 0, basePosition + float3(0, ringHeight0, 0), 0.0, 0.0);
+            SetControlPoint(spline, 1, basePosition + float3(0, ringHeight0 + 0.5, 0), leafRadiusScale, 0.2);
+            SetControlPoint(spline, 2, basePosition + float3(0, ringHeight1, 0), leafRadiusScale * 0.3, 0.1);
+            SetControlPoint(spline, 3, basePosition + float3(0, ringHeight1 + 0.5, 0), leafRadiusScale * 0.8, 0.2);
+            SetControlPoint(spline, 4, basePosition + float3(0, ringHeight2, 0), leafRadiusScale * 0.3, 0.1);
+            SetControlPoint(spline, 5, basePosition + float3(0, ringHeight2 + 0.5, 0), leafRadiusScale * 0.6, 0.2);
+            SetControlPoint(spline, 6, basePosition + float3(0, ringHeight3, 0), 0.0, 0.0);
+
+            WriteSpline(outputRecord, 1, pineLeafSplinePieceCount, splineIndex, spline);
         }
     }
 
     outputRecord.OutputComplete();
-}
\ No newline at end of file
+}
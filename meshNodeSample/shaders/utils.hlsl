@@ -92,6 +92,45 @@ float PerlinNoise2D(in float2 position)
     return lerp(d0, d1, interpolationWeights.x);
 }
 
+// Perlin noise with analytic gradient
+// x = noise, same value as PerlinNoise2D
+// y = d noise / d position.x
+// z = d noise / d position.y
+float3 PerlinNoise2DWithGradient(in float2 position)
+{
+    const int2 gridPositon = floor(position);
+    const float2 gridOffset = frac(position);
+
+    const float2 g00 = PerlinNoiseDir2D(gridPositon + int2(0, 0));
+    const float2 g01 = PerlinNoiseDir2D(gridPositon + int2(0, 1));
+    const float2 g10 = PerlinNoiseDir2D(gridPositon + int2(1, 0));
+    const float2 g11 = PerlinNoiseDir2D(gridPositon + int2(1, 1));
+
+    const float d00 = dot(g00, gridOffset - float2(0, 0));
+    const float d01 = dot(g01, gridOffset - float2(0, 1));
+    const float d10 = dot(g10, gridOffset - float2(1, 0));
+    const float d11 = dot(g11, gridOffset - float2(1, 1));
+
+    const float2 interpolationWeights = gridOffset * gridOffset * gridOffset * (gridOffset * (gridOffset * 6 - 15) + 10);
+    // derivative of the quintic interpolation weights
+    const float2 interpolationDerivatives = 30 * gridOffset * gridOffset * (gridOffset * (gridOffset - 2) + 1);
+
+    const float d0 = lerp(d00, d01, interpolationWeights.y);
+    const float d1 = lerp(d10, d11, interpolationWeights.y);
+
+    // the derivative of each corner dot product is its gradient direction
+    const float2 gradient0 = float2(lerp(g00.x, g01.x, interpolationWeights.y),
+                                    lerp(g00.y, g01.y, interpolationWeights.y) + (d01 - d00) * interpolationDerivatives.y);
+    const float2 gradient1 = float2(lerp(g10.x, g11.x, interpolationWeights.y),
+                                    lerp(g10.y, g11.y, interpolationWeights.y) + (d11 - d10) * interpolationDerivatives.y);
+
+    const float noise = lerp(d0, d1, interpolationWeights.x);
+    const float gradientX = lerp(gradient0.x, gradient1.x, interpolationWeights.x) + (d1 - d0) * interpolationDerivatives.x;
+    const float gradientY = lerp(gradient0.y, gradient1.y, interpolationWeights.x);
+
+    return float3(noise, gradientX, gradientY);
+}
+
 uint Hash(uint seed)
 {
     seed = (seed ^ 61u) ^ (seed >> 16u);
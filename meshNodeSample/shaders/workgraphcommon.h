@@ -21,33 +21,78 @@
 
 #pragma once
 
+// Work graph constant buffer, shared by the shaders, the sample (workgraphrendermodule.cpp) & the CPU emulator (meshNodeCpu/worldgraph.h).
+// The members are defined once in WorkGraphCBData, which the shaders bind as ConstantBuffer<WorkGraphCBData> WorkGraphData.
+// In C++, the matrices use the column_major packing of HLSL constant buffers, see meshnode::float4x4.
+// The static checks at the end of this file fail if a member moves, as the C++ layout must follow the HLSL constant buffer packing rules.
+
 #if __cplusplus
-#include "misc/math.h"
+#include <cstddef>
+
+#include "hlslmath.h"
+
+namespace meshnode
+{
 #endif  // __cplusplus
 
-#if __cplusplus
+// Maximum number of terrain clipmap levels, see heightmap.hlsl
+#define TERRAIN_CLIPMAP_MAX_LEVEL_COUNT 8
+
 struct WorkGraphCBData {
-    Mat4     ViewProjection;
-    Mat4     PreviousViewProjection;
-    Mat4     InverseViewProjection;
-    Vec4     CameraPosition;
-    Vec4     PreviousCameraPosition;
+    float4x4 ViewProjection;
+    float4x4 PreviousViewProjection;
+    float4x4 InverseViewProjection;
+    float4   CameraPosition;
+    float4   PreviousCameraPosition;
     uint32_t ShaderTime;
     uint32_t PreviousShaderTime;
     float    WindStrength;
     float    WindDirection;
+    // Terrain clipmap, see TerrainClipmap in heightmap.hlsl
+    // xy = texel coordinates of the level window origin, z = 1 if the level is valid
+    int4     TerrainClipmapLevels[TERRAIN_CLIPMAP_MAX_LEVEL_COUNT];
+    float    TerrainClipmapTexelSize;
+    uint32_t TerrainClipmapResolution;
+    // 0 disables the clipmap
+    uint32_t TerrainClipmapLevelCount;
+    float    TerrainClipmapBlendWidth;
+    // Geometry budget, scales of the quality tier distances & dense grass blade count in [0, 1]
+    // set by the frame-time governor of the sample, see GetDenseGrassMaxDistance & co. in common.hlsl & meshNodeCpu/geometrybudget.h
+    float    DenseGrassDistanceScale;
+    float    SparseGrassDistanceScale;
+    float    FlowerDistanceScale;
+    float    InsectDistanceScale;
+    float    GrassBladeDensityScale;
+    // 1 if the nodes add to the GenerationCounters UAV, see generationcounters.h
+    uint32_t GenerationCountersEnabled;
+    uint2    Padding;
 };
+
+#if __cplusplus
+// HLSL constant buffer packing: 16 byte rows, members must not straddle a row
+static_assert(offsetof(WorkGraphCBData, ViewProjection) == 0, "WorkGraphCBData layout changed");
+static_assert(offsetof(WorkGraphCBData, PreviousViewProjection) == 64, "WorkGraphCBData layout changed");
+static_assert(offsetof(WorkGraphCBData, InverseViewProjection) == 128, "WorkGraphCBData layout changed");
+static_assert(offsetof(WorkGraphCBData, CameraPosition) == 192, "WorkGraphCBData layout changed");
+static_assert(offsetof(WorkGraphCBData, PreviousCameraPosition) == 208, "WorkGraphCBData layout changed");
+static_assert(offsetof(WorkGraphCBData, ShaderTime) == 224, "WorkGraphCBData layout changed");
+static_assert(offsetof(WorkGraphCBData, PreviousShaderTime) == 228, "WorkGraphCBData layout changed");
+static_assert(offsetof(WorkGraphCBData, WindStrength) == 232, "WorkGraphCBData layout changed");
+static_assert(offsetof(WorkGraphCBData, WindDirection) == 236, "WorkGraphCBData layout changed");
+static_assert(offsetof(WorkGraphCBData, TerrainClipmapLevels) == 240, "WorkGraphCBData layout changed");
+static_assert(offsetof(WorkGraphCBData, TerrainClipmapTexelSize) == 368, "WorkGraphCBData layout changed");
+static_assert(offsetof(WorkGraphCBData, TerrainClipmapResolution) == 372, "WorkGraphCBData layout changed");
+static_assert(offsetof(WorkGraphCBData, TerrainClipmapLevelCount) == 376, "WorkGraphCBData layout changed");
+static_assert(offsetof(WorkGraphCBData, TerrainClipmapBlendWidth) == 380, "WorkGraphCBData layout changed");
+static_assert(offsetof(WorkGraphCBData, DenseGrassDistanceScale) == 384, "WorkGraphCBData layout changed");
+static_assert(offsetof(WorkGraphCBData, SparseGrassDistanceScale) == 388, "WorkGraphCBData layout changed");
+static_assert(offsetof(WorkGraphCBData, FlowerDistanceScale) == 392, "WorkGraphCBData layout changed");
+static_assert(offsetof(WorkGraphCBData, InsectDistanceScale) == 396, "WorkGraphCBData layout changed");
+static_assert(offsetof(WorkGraphCBData, GrassBladeDensityScale) == 400, "WorkGraphCBData layout changed");
+static_assert(offsetof(WorkGraphCBData, GenerationCountersEnabled) == 404, "WorkGraphCBData layout changed");
+static_assert(offsetof(WorkGraphCBData, Padding) == 408, "WorkGraphCBData layout changed");
+static_assert(sizeof(WorkGraphCBData) == 416, "WorkGraphCBData layout changed");
+}  // namespace meshnode
 #else
-cbuffer WorkGraphCBData : register(b0)
-{
-    matrix ViewProjection;
-    matrix PreviousViewProjection;
-    matrix InverseViewProjection;
-    float4 CameraPosition;
-    float4 PreviousCameraPosition;
-    uint   ShaderTime;
-    uint   PreviousShaderTime;
-    float  WindStrength;
-    float  WindDirection;
-}
-#endif  // __cplusplus
\ No newline at end of file
+ConstantBuffer<WorkGraphCBData> WorkGraphData : register(b0);
+#endif  // __cplusplus
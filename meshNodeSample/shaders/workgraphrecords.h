@@ -0,0 +1,228 @@
+// This file is part of the AMD Work Graph Mesh Node Sample.
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#pragma once
+
+// Record structs of the work graph nodes & their capacity limits.
+// Shared by the shaders (common.hlsl & world.hlsl) & the CPU emulator (meshNodeCpu/worldgraph.h), thus only types available in both
+// languages are used. In C++, 16-bit types are 2 byte aligned & all other types 4 byte aligned, same as the record layout in HLSL.
+// The static checks at the end of this file fail if a record changes its size or alignment, see "MeshNodeCpuTool layout".
+
+#include "recordencoding.h"
+#include "splinesplitting.h"
+
+#if __cplusplus
+#include <cstddef>
+
+namespace meshnode
+{
+// system value semantics are HLSL only
+#define RECORD_DISPATCH_GRID
+#else
+#define RECORD_DISPATCH_GRID : SV_DispatchGrid
+#endif  // __cplusplus
+
+// World grid definitions
+// DO NOT CHANGE THESE!
+static const uint32_t grassPatchesPerDetailedTile = 16;
+static const uint32_t detailedTilesPerTile        = 8;
+static const uint32_t tilesPerChunk               = 8;
+
+// ===================================
+// Record structs for work graph nodes
+// Mesh node records use the quantized encodings of recordencoding.h, e.g. positions are 16-bit offsets to a record origin.
+
+// Record for launching a grid of chunks
+// grid size & offset are computed based on current camera view
+struct ChunkGridRecord {
+    uint2 grid RECORD_DISPATCH_GRID;
+    int2  offset;
+};
+
+// Record for launching a single visible chunk
+// chunks are culled & their level of detail is selected on the CPU, see ChunkCuller in meshNodeCpu/chunkculling.h
+struct ChunkRecord {
+    int2    chunkGridPosition;
+    int32_t levelOfDetail;
+    // bit i is set if neighbor i has a higher level of detail, same order as DrawTerrainChunkRecord::levelOfDetailTransition
+    uint32_t levelOfDetailTransitionMask;
+    // dominant biome of each tile, 2 bits per tile in row-major order
+    // classified on the CPU & cached across frames, see ChunkMetadataCache in meshNodeCpu/chunkmetadata.h
+    // tiles culled with their terrain height bounds or hidden behind the terrain are marked with culledTileBiome
+    uint4 tileBiomes;
+};
+
+// Record for each tile in a chunk & detailed tile in a tile
+struct TileRecord {
+    int2 position;
+};
+
+// Record for drawing terrain segments inside a chunk
+struct DrawTerrainChunkRecord {
+    uint3   dispatchGrid RECORD_DISPATCH_GRID;
+    int2    chunkGridPosition;
+    int32_t levelOfDetail;
+    // indicated if neighboring terrain tiles have higher LOD
+    // x = (-1, 0)
+    // y = (0, -1)
+    // z = (1, 0)
+    // w = (0, 1)
+    bool4 levelOfDetailTransition;
+};
+
+struct GenerateTreeRecord {
+    float2 position;
+};
+
+static const uint32_t maxSplinesPerRecord        = 32;
+static const uint32_t splineMaxControlPointCount = 8;
+
+// Record for drawing multiple splines. Each spline is defined as a series of control points.
+// Each control point defines a vertex ring with varying radius and vertex count.
+// Splines of a record can be generated by different tiles, thus each spline has its own origin.
+struct DrawSplineRecord {
+    uint3     dispatchGrid RECORD_DISPATCH_GRID;
+    float2    origin[maxSplinesPerRecord];
+    // half precision, see EncodeHalf
+    uint16_t3 color[maxSplinesPerRecord];
+    uint16_t  rotationOffset[maxSplinesPerRecord];
+    // x is overall wind strength, y is blending factor for individual vertices
+    uint16_t2 windStrength[maxSplinesPerRecord];
+    // 16 bit, as different threads write the counts of neighboring splines
+    uint16_t  controlPointCount[maxSplinesPerRecord];
+    // 8 bit per control point, see EncodeVertexCounts
+    uint2     controlPointVertexCounts[maxSplinesPerRecord];
+    // vertex & triangle prefix sums of the rings, see ComputeSplinePrefixSums
+    uint4     ringPrefixSums[maxSplinesPerRecord];
+    // relative to the spline origin, see EncodeRecordPosition
+    int16_t3  controlPointPositions[maxSplinesPerRecord * splineMaxControlPointCount];
+    uint16_t2 controlPointRadii[maxSplinesPerRecord * splineMaxControlPointCount];
+    uint16_t  controlPointNoiseAmplitudes[maxSplinesPerRecord * splineMaxControlPointCount];
+};
+
+// Each thread in a biome tile can generate one insects
+static const uint32_t maxInsectsPerRecord = detailedTilesPerTile * detailedTilesPerTile;
+
+// Record for insects
+// Used by
+//  - DrawBees
+//  - DrawButterflies
+struct DrawInsectRecord {
+    uint3    dispatchGrid RECORD_DISPATCH_GRID;
+    // world position of the tile
+    float2   origin;
+    int16_t3 position[maxInsectsPerRecord];
+};
+
+// Each thread in a biome tile can generate up to 3 mushrooms
+static const uint32_t maxMushroomsPerDetailedTile = 3;
+static const uint32_t maxMushroomsPerRecord       = detailedTilesPerTile * detailedTilesPerTile * maxMushroomsPerDetailedTile;
+
+// Record for mushrooms
+// Used by
+//  - DrawMushroomPatch
+struct DrawMushroomRecord {
+    uint3    dispatchGrid RECORD_DISPATCH_GRID;
+    // world position of the tile
+    float2   origin;
+    int16_t3 position[maxMushroomsPerRecord];
+};
+
+// Each thread in a biome tile can generate up to 12 flowers
+static const int32_t maxFlowersPerDetailedTile        = 12;
+static const int32_t maxFlowersPerRecord              = (detailedTilesPerTile * detailedTilesPerTile) * maxFlowersPerDetailedTile;
+// scaling factor for dispatch grid size when using sparse flowers
+static const int32_t flowersInSparseFlowerThreadGroup = 5;
+
+// Record for flowers
+// Used by
+//  - DrawFlowerPatch
+struct DrawFlowerRecord {
+    uint3    dispatchGrid RECORD_DISPATCH_GRID;
+    uint32_t flowerPatchCount;
+    // world position of the tile
+    float2   origin;
+    // xz-position, flowers are placed on the terrain
+    int16_t2 position[maxFlowersPerRecord];
+};
+
+// Each thread in a detailed tile corresponds to one or two dense grass patches
+static const uint32_t maxDenseGrassPatchesPerRecord = 2 * grassPatchesPerDetailedTile * grassPatchesPerDetailedTile;
+
+// Record for dense grass
+// Used by
+//  - DrawDenseGrassPatch
+struct DrawDenseGrassRecord {
+    uint3    dispatchGrid RECORD_DISPATCH_GRID;
+    // world position of the detailed tile
+    float2   origin;
+    int16_t3 position[maxDenseGrassPatchesPerRecord];
+    // grass height & blade offset, see EncodeDenseGrassPatch
+    uint16_t patch[maxDenseGrassPatchesPerRecord];
+};
+
+// Each thread in a biome tile corresponds to a sparse grass patch
+static const uint32_t maxSparseGrassPatchesPerRecord   = detailedTilesPerTile * detailedTilesPerTile;
+// Number of sparse grass mesh shader thread groups needed to render one detailed tile
+static const uint32_t sparseGrassThreadGroupsPerRecord = 8;
+
+// record for DrawSparseGrassPatch
+struct DrawSparseGrassRecord {
+    uint3    dispatchGrid RECORD_DISPATCH_GRID;
+    // detailed tile grid position of the tile
+    int2     origin;
+    // detailed tile grid position relative to the origin
+    int16_t2 position[maxSparseGrassPatchesPerRecord];
+};
+
+// ===================================
+// NodeMaxInputRecordsPerGraphEntryRecord of the mesh nodes
+// These limits were set through instrumentation and are not required on AMD GPUs, see "MeshNodeCpuTool limits".
+// Limits of node arrays are shared by all nodes of the array.
+
+static const uint32_t drawTerrainChunkMaxInputRecords = 32 * 32;
+static const uint32_t drawSplineMaxInputRecords       = 10000;
+static const uint32_t drawSparseGrassMaxInputRecords  = 100;
+static const uint32_t drawDenseGrassMaxInputRecords   = 400;
+static const uint32_t drawMushroomMaxInputRecords     = 50;
+static const uint32_t drawFlowerMaxInputRecords       = 200;
+static const uint32_t drawBeesMaxInputRecords         = 20;
+static const uint32_t drawButterfliesMaxInputRecords  = 10;
+
+#if __cplusplus
+// Record sizes & alignments of the HLSL structs. Offsets are checked where 16-bit members are followed by 32-bit members.
+static_assert((sizeof(ChunkGridRecord) == 16) && (alignof(ChunkGridRecord) == 4), "ChunkGridRecord layout changed");
+static_assert((sizeof(ChunkRecord) == 32) && (alignof(ChunkRecord) == 4), "ChunkRecord layout changed");
+static_assert((sizeof(TileRecord) == 8) && (alignof(TileRecord) == 4), "TileRecord layout changed");
+static_assert((sizeof(DrawTerrainChunkRecord) == 40) && (alignof(DrawTerrainChunkRecord) == 4), "DrawTerrainChunkRecord layout changed");
+static_assert((sizeof(GenerateTreeRecord) == 8) && (alignof(GenerateTreeRecord) == 4), "GenerateTreeRecord layout changed");
+static_assert((sizeof(DrawSplineRecord) == 4556) && (alignof(DrawSplineRecord) == 4), "DrawSplineRecord layout changed");
+static_assert(offsetof(DrawSplineRecord, controlPointVertexCounts) == 716, "DrawSplineRecord layout changed");
+static_assert(offsetof(DrawSplineRecord, ringPrefixSums) == 972, "DrawSplineRecord layout changed");
+static_assert(splineMaxControlPointCount <= splinePrefixSumCount, "ring prefix sums cannot hold all control points");
+static_assert((sizeof(DrawInsectRecord) == 404) && (alignof(DrawInsectRecord) == 4), "DrawInsectRecord layout changed");
+static_assert((sizeof(DrawMushroomRecord) == 1172) && (alignof(DrawMushroomRecord) == 4), "DrawMushroomRecord layout changed");
+static_assert((sizeof(DrawFlowerRecord) == 3096) && (alignof(DrawFlowerRecord) == 4), "DrawFlowerRecord layout changed");
+static_assert((sizeof(DrawDenseGrassRecord) == 4116) && (alignof(DrawDenseGrassRecord) == 4), "DrawDenseGrassRecord layout changed");
+static_assert((sizeof(DrawSparseGrassRecord) == 276) && (alignof(DrawSparseGrassRecord) == 4), "DrawSparseGrassRecord layout changed");
+}  // namespace meshnode
+#endif  // __cplusplus
@@ -21,17 +21,10 @@
 
 #include "common.hlsl"
 
-// Record for launching a grid of chunks
-// grid size & offset are computed based on current camera view
-struct ChunkGridRecord {
-    uint2 grid : SV_DispatchGrid;
-    int2  offset;
-};
-
 float2 ComputeFarPlaneCorner(in float clipX, in float clipY)
 {
     // compute position of frustum corner on far plane
-    const float3 cornerWorldPosition = PerspectiveProject(InverseViewProjection, float3(clipX, clipY, 1.f));
+    const float3 cornerWorldPosition = PerspectiveProject(WorkGraphData.InverseViewProjection, float3(clipX, clipY, 1.f));
 
     const float2 viewVector       = cornerWorldPosition.xz - GetCameraPosition().xz;
     const float  viewVectorLength = length(viewVector);
@@ -54,6 +47,8 @@ void World(
     [NodeId("ChunkGrid")]
     NodeOutput<ChunkGridRecord> chunkGridOutput)
 {
+    CountGenerationThread(generationNodeWorld);
+
     // This node computes the world-space extends of the chunk grid based on the current camera view frustum
 
     // Compute bounding box of view frustum
@@ -89,6 +84,46 @@ int GetTerrainChunkLevelOfDetail(in int2 chunkGridPosition)
     return clamp(distanceToCamera / (3 * chunkSize), 0, 3);
 }
 
+// Classifies a tile by the dominant biome in its center
+uint GetTileBiome(in int2 tileGridPosition)
+{
+    // Get biome weights in center of tile
+    const float3 biomeWeights = GetBiomeWeights(tileGridPosition * tileSize + tileSize * 0.5);
+
+    // Classify biome tile to launch by dominant biome
+    return biomeWeights.x > biomeWeights.y ? (biomeWeights.x > biomeWeights.z ? 0 : 2)
+                                           : (biomeWeights.y > biomeWeights.z ? 1 : 2);
+}
+
+// biome of tiles culled on the CPU, i.e. outside of the view frustum with their terrain height bounds or hidden behind the terrain
+// (see ChunkCuller in meshNodeCpu/chunkculling.h & HorizonCuller in meshNodeCpu/horizonculling.h)
+static const uint culledTileBiome = 3;
+
+// Launches the biome tile node of a chunk thread if the tile is visible
+void OutputTile(in int2                     chunkGridPosition,
+                in int2                     groupThreadId,
+                in uint                     biome,
+                in ClipPlanes               clipPlanes,
+                NodeOutputArray<TileRecord> tileOutput)
+{
+    const int2 threadGridPosition = chunkGridPosition * tilesPerChunk + groupThreadId;
+
+    const AxisAlignedBoundingBox tileBoundingBox = GetGridBoundingBox(threadGridPosition, tileSize, -100, 300);
+
+    const bool hasTileOutput = (biome != culledTileBiome) && tileBoundingBox.IsVisible(clipPlanes);
+
+    // all threads must call GetThreadNodeOutputRecords on a valid output
+    ThreadNodeOutputRecords<TileRecord> tileOutputRecord =
+        tileOutput[min(biome, 2)].GetThreadNodeOutputRecords(hasTileOutput);
+
+    if (hasTileOutput) {
+
+        tileOutputRecord.Get().position = threadGridPosition;
+    }
+
+    tileOutputRecord.OutputComplete();
+}
+
 [Shader("node")]
 [NodeLaunch("broadcasting")]
 [NodeMaxDispatchGrid(32, 32, 1)]
@@ -109,6 +144,8 @@ void ChunkGrid(
     [NodeArraySize(3)]
     NodeOutputArray<TileRecord> tileOutput)
 {
+    CountGenerationGroup(generationNodeChunkGrid, groupThreadId.y * tilesPerChunk + groupThreadId.x, all(groupId == 0), 1);
+
     const ChunkGridRecord input              = inputRecord.Get();
     const int2            chunkGridPosition  = input.offset + groupId;
     const float2          chunkWorldPosition = chunkGridPosition * chunkSize;
@@ -149,28 +186,58 @@ void ChunkGrid(
     // Tile output
     if (isChunkVisible)
     {
-        const int2   threadGridPosition  = chunkGridPosition * tilesPerChunk + groupThreadId;
-        const float2 threadWorldPosition = threadGridPosition * tileSize;
+        const uint biome = GetTileBiome(chunkGridPosition * tilesPerChunk + groupThreadId);
 
-        const AxisAlignedBoundingBox tileBoundingBox = GetGridBoundingBox(threadGridPosition, tileSize, -100, 300);
+        OutputTile(chunkGridPosition, groupThreadId, biome, clipPlanes, tileOutput);
+    }
+}
 
-        const bool hasTileOutput = tileBoundingBox.IsVisible(clipPlanes);
+[Shader("node")]
+[NodeLaunch("broadcasting")]
+[NodeDispatchGrid(1, 1, 1)]
+// each thread corresponds to one tile
+[NumThreads(tilesPerChunk, tilesPerChunk, 1)]
+void Chunk(
+    DispatchNodeInputRecord<ChunkRecord> inputRecord,
+
+    int2 groupThreadId : SV_GroupThreadID,
+
+    [MaxRecords(1)]
+    [NodeId("DrawTerrainChunk")]
+    NodeOutput<DrawTerrainChunkRecord> terrainOutput,
+
+    [MaxRecords(tilesPerChunk * tilesPerChunk)]
+    [NodeId("Tile")]
+    [NodeArraySize(3)]
+    NodeOutputArray<TileRecord> tileOutput)
+{
+    CountGenerationGroup(generationNodeChunk, groupThreadId.y * tilesPerChunk + groupThreadId.x, true, 1);
 
-        // Get biome weights in center of tile
-        const float3 biomeWeights = GetBiomeWeights(threadWorldPosition + tileSize * 0.5);
+    // Alternative entry to World & ChunkGrid: the CPU launches one record per visible chunk,
+    // thus the chunk visibility test, the level of detail selection & the tile biome classification are skipped.
+    const ChunkRecord input = inputRecord.Get();
 
-        // Classify biome tile to launch by dominant biome
-        const uint biome = biomeWeights.x > biomeWeights.y ? (biomeWeights.x > biomeWeights.z ? 0 : 2)
-                                                           : (biomeWeights.y > biomeWeights.z ? 1 : 2);
+    // Terrain output
+    {
+        GroupNodeOutputRecords<DrawTerrainChunkRecord> terrainOutputRecord = terrainOutput.GetGroupNodeOutputRecords(1);
 
-        ThreadNodeOutputRecords<TileRecord> tileOutputRecord =
-            tileOutput[biome].GetThreadNodeOutputRecords(hasTileOutput);
+        const uint dispatchSize = 8 / clamp(1U << input.levelOfDetail, 1, 8);
 
-        if (hasTileOutput) {
+        terrainOutputRecord.Get().dispatchGrid      = uint3(dispatchSize, dispatchSize, 1);
+        terrainOutputRecord.Get().chunkGridPosition = input.chunkGridPosition;
+        terrainOutputRecord.Get().levelOfDetail     = input.levelOfDetail;
 
-            tileOutputRecord.Get().position = chunkGridPosition * tilesPerChunk + groupThreadId;
-        }
+        terrainOutputRecord.Get().levelOfDetailTransition.x = IsBitSet(input.levelOfDetailTransitionMask, 0);
+        terrainOutputRecord.Get().levelOfDetailTransition.y = IsBitSet(input.levelOfDetailTransitionMask, 1);
+        terrainOutputRecord.Get().levelOfDetailTransition.z = IsBitSet(input.levelOfDetailTransitionMask, 2);
+        terrainOutputRecord.Get().levelOfDetailTransition.w = IsBitSet(input.levelOfDetailTransitionMask, 3);
 
-        tileOutputRecord.OutputComplete();
+        terrainOutputRecord.OutputComplete();
     }
+
+    // Tile output, the biome of the tile is read from the record instead of sampling the biome weights
+    const uint tileIndex = groupThreadId.x + groupThreadId.y * tilesPerChunk;
+    const uint biome     = (input.tileBiomes[tileIndex / 16] >> ((tileIndex % 16) * 2)) & 0x3;
+
+    OutputTile(input.chunkGridPosition, groupThreadId, biome, ComputeClipPlanes(), tileOutput);
 }
@@ -0,0 +1,186 @@
+// This file is part of the AMD Work Graph Mesh Node Sample.
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include "startuptimeline.h"
+
+#include "misc/assert.h"
+#include "misc/log.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+
+using namespace cauldron;
+
+StartupTimeline& StartupTimeline::Get()
+{
+    static StartupTimeline timeline;
+    return timeline;
+}
+
+// Create timeline during static initialization, such that all timestamps are relative to the program start
+static const StartupTimeline& s_StartupTimeline = StartupTimeline::Get();
+
+StartupTimeline::StartupTimeline()
+    : m_StartTime(Clock::now())
+{
+}
+
+void StartupTimeline::AddPhase(const std::string& name,
+                               Clock::time_point  startTime,
+                               Clock::time_point  endTime,
+                               std::thread::id    threadId,
+                               uint64_t           dxilSize,
+                               uint32_t           includeCount)
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    if (m_Finished)
+    {
+        return;
+    }
+
+    // threads are numbered in order of their first phase
+    const auto threadIndex = m_ThreadIndices.emplace(threadId, static_cast<uint32_t>(m_ThreadIndices.size())).first->second;
+
+    StartupPhase phase = {};
+    phase.Name         = name;
+    phase.StartMs      = std::chrono::duration<double, std::milli>(startTime - m_StartTime).count();
+    phase.DurationMs   = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+    phase.DxilSize     = dxilSize;
+    phase.IncludeCount = includeCount;
+    phase.ThreadIndex  = threadIndex;
+
+    m_Phases.push_back(phase);
+}
+
+void StartupTimeline::SetReportPath(const std::wstring& path)
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_ReportPath = path;
+}
+
+void StartupTimeline::Report()
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    for (size_t i = m_ReportedPhaseCount; i < m_Phases.size(); ++i)
+    {
+        const auto& phase = m_Phases[i];
+
+        if (phase.DxilSize > 0)
+        {
+            Log::Write(LOGLEVEL_INFO,
+                       L"Startup: %-48hs %8.1f ms (thread %u, %llu bytes DXIL, %u includes)",
+                       phase.Name.c_str(),
+                       phase.DurationMs,
+                       phase.ThreadIndex,
+                       static_cast<unsigned long long>(phase.DxilSize),
+                       phase.IncludeCount);
+        }
+        else
+        {
+            Log::Write(LOGLEVEL_INFO, L"Startup: %-48hs %8.1f ms (thread %u)", phase.Name.c_str(), phase.DurationMs, phase.ThreadIndex);
+        }
+    }
+    m_ReportedPhaseCount = m_Phases.size();
+
+    WriteReport();
+}
+
+void StartupTimeline::Finish()
+{
+    Report();
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Finished = true;
+}
+
+std::vector<StartupPhase> StartupTimeline::GetPhases() const
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_Phases;
+}
+
+static std::string EscapeJsonString(const std::string& string)
+{
+    std::string escaped;
+    for (const char c : string)
+    {
+        if ((c == '"') || (c == '\\'))
+        {
+            escaped += '\\';
+        }
+        escaped += c;
+    }
+
+    return escaped;
+}
+
+void StartupTimeline::WriteReport() const
+{
+    if (m_ReportPath.empty())
+    {
+        return;
+    }
+
+    std::ofstream file(std::filesystem::path(m_ReportPath), std::ios::trunc);
+    if (!file)
+    {
+        CauldronWarning(L"Failed to write startup timeline to %ls", m_ReportPath.c_str());
+        return;
+    }
+
+    double endMs = 0.0;
+    for (const auto& phase : m_Phases)
+    {
+        endMs = std::max(endMs, phase.StartMs + phase.DurationMs);
+    }
+
+    file << std::fixed << std::setprecision(3);
+    file << "{\n";
+    file << "  \"totalMs\": " << endMs << ",\n";
+    file << "  \"threadCount\": " << m_ThreadIndices.size() << ",\n";
+    file << "  \"phases\": [";
+    for (size_t i = 0; i < m_Phases.size(); ++i)
+    {
+        const auto& phase = m_Phases[i];
+
+        file << ((i == 0) ? "\n" : ",\n");
+        file << "    {\"name\": \"" << EscapeJsonString(phase.Name) << "\", \"startMs\": " << phase.StartMs << ", \"durationMs\": " << phase.DurationMs
+             << ", \"dxilSize\": " << phase.DxilSize << ", \"includeCount\": " << phase.IncludeCount << ", \"thread\": " << phase.ThreadIndex << "}";
+    }
+    file << "\n  ]\n";
+    file << "}\n";
+}
+
+StartupTimer::StartupTimer(std::string name)
+    : m_Name(std::move(name))
+    , m_StartTime(StartupTimeline::Clock::now())
+{
+}
+
+StartupTimer::~StartupTimer()
+{
+    StartupTimeline::Get().AddPhase(m_Name, m_StartTime, StartupTimeline::Clock::now(), std::this_thread::get_id(), m_DxilSize, m_IncludeCount);
+}
@@ -0,0 +1,133 @@
+// This file is part of the AMD Work Graph Mesh Node Sample.
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Single timed phase of the sample startup.
+ */
+struct StartupPhase
+{
+    std::string Name;
+    // milliseconds since program start
+    double StartMs    = 0.0;
+    double DurationMs = 0.0;
+    // size of DXIL compiled or loaded in this phase, 0 if not applicable
+    uint64_t DxilSize = 0;
+    // number of files included by the compiled shader, 0 if not applicable
+    uint32_t IncludeCount = 0;
+    // sequential index of the thread the phase ran on, 0 is the first thread that recorded a phase
+    uint32_t ThreadIndex = 0;
+};
+
+/**
+ * Records CPU timings of startup phases (module initialization, shader compilation, pipeline creation) from any thread.
+ * Phases are reported to the log and written to a JSON report, such that startup regressions can be compared between builds.
+ * Recording stops once Finish is called, such that hot-reloads or resizes do not show up in the timeline.
+ */
+class StartupTimeline
+{
+public:
+    using Clock = std::chrono::high_resolution_clock;
+
+    /**
+     * @brief   Global timeline shared by all render modules. Timestamps are relative to the program start.
+     */
+    static StartupTimeline& Get();
+
+    /**
+     * @brief   Record a phase that ran from startTime to endTime on thread threadId.
+     */
+    void AddPhase(const std::string& name,
+                  Clock::time_point  startTime,
+                  Clock::time_point  endTime,
+                  std::thread::id    threadId,
+                  uint64_t           dxilSize     = 0,
+                  uint32_t           includeCount = 0);
+
+    /**
+     * @brief   Set file the JSON report is written to. No report is written if path is empty.
+     */
+    void SetReportPath(const std::wstring& path);
+
+    /**
+     * @brief   Log all phases recorded since the previous report and write all phases to the JSON report.
+     */
+    void Report();
+
+    /**
+     * @brief   Report remaining phases and stop recording.
+     */
+    void Finish();
+
+    std::vector<StartupPhase> GetPhases() const;
+
+private:
+    StartupTimeline();
+
+    void WriteReport() const;
+
+    mutable std::mutex                  m_Mutex;
+    Clock::time_point                   m_StartTime;
+    std::vector<StartupPhase>           m_Phases;
+    std::map<std::thread::id, uint32_t> m_ThreadIndices;
+    size_t                              m_ReportedPhaseCount = 0;
+    std::wstring                        m_ReportPath;
+    bool                                m_Finished = false;
+};
+
+/**
+ * Records a phase in the global startup timeline from construction to destruction on the current thread.
+ */
+class StartupTimer
+{
+public:
+    explicit StartupTimer(std::string name);
+    ~StartupTimer();
+
+    StartupTimer(const StartupTimer&)            = delete;
+    StartupTimer& operator=(const StartupTimer&) = delete;
+
+    void SetDxilSize(uint64_t dxilSize)
+    {
+        m_DxilSize = dxilSize;
+    }
+
+    void SetIncludeCount(uint32_t includeCount)
+    {
+        m_IncludeCount = includeCount;
+    }
+
+private:
+    std::string                        m_Name;
+    StartupTimeline::Clock::time_point m_StartTime;
+    uint64_t                           m_DxilSize     = 0;
+    uint32_t                           m_IncludeCount = 0;
+};
@@ -25,6 +25,7 @@
 #include "core/scene.h"
 #include "core/uimanager.h"
 #include "misc/assert.h"
+#include "misc/log.h"
 
 // Render components
 #include "render/buffer.h"
@@ -50,16 +51,114 @@
 #include "shaders/shadingcommon.h"
 #include "shaders/workgraphcommon.h"
 
+// generation counter UAV & read-outs
+#include "generationcounterreadback.h"
 // shader compiler
+#include "shadercache.h"
 #include "shadercompiler.h"
-
+#include "shaderfilewatcher.h"
+#include "workgraphshaders.h"
+
+#include "startuptimeline.h"
+
+// CPU terrain clipmap & chunk culling
+#include "chunkculling.h"
+#include "chunkmetadata.h"
+#include "horizonculling.h"
+// geometry budget governor
+#include "geometrybudget.h"
+#include "terrainclipmap.h"
+// CPU work graph emulator
+#include "worldgraph.h"
+// flythrough recording & playback
+#include "flythroughplayer.h"
+// frame trace capture
+#include "frametracecapture.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
 #include <sstream>
+#include <thread>
 
 using namespace cauldron;
 
+static_assert(sizeof(Mat4) == sizeof(meshnode::float4x4), "Mat4 must match meshnode::float4x4");
+
+// Cauldron matrices are stored column by column, same as the constant buffer matrices of WorkGraphCBData
+static meshnode::float4x4 ToFloat4x4(const Mat4& matrix)
+{
+    meshnode::float4x4 result;
+    std::memcpy(&result, &matrix, sizeof(result));
+
+    return result;
+}
+
+static meshnode::float4 ToFloat4(const Vec4& vector)
+{
+    return meshnode::float4(vector.getX(), vector.getY(), vector.getZ(), vector.getW());
+}
+
 // Name for work graph program inside the state object
 static const wchar_t* WorkGraphProgramName = L"WorkGraph";
 
+// DXC blob referencing DXIL inside the memory-mapped shader archive.
+// Allows archive & compiled shaders to be handled the same way without copying the DXIL.
+class ShaderArchiveBlob : public IDxcBlob
+{
+public:
+    ShaderArchiveBlob(const void* pData, size_t size)
+        : m_pData(pData)
+        , m_Size(size)
+    {
+    }
+
+    LPVOID STDMETHODCALLTYPE GetBufferPointer() override
+    {
+        return const_cast<void*>(m_pData);
+    }
+
+    SIZE_T STDMETHODCALLTYPE GetBufferSize() override
+    {
+        return m_Size;
+    }
+
+    HRESULT STDMETHODCALLTYPE QueryInterface(REFIID riid, void** ppvObject) override
+    {
+        if ((riid == __uuidof(IDxcBlob)) || (riid == __uuidof(IUnknown)))
+        {
+            AddRef();
+            *ppvObject = static_cast<IDxcBlob*>(this);
+            return S_OK;
+        }
+
+        *ppvObject = nullptr;
+        return E_NOINTERFACE;
+    }
+
+    ULONG STDMETHODCALLTYPE AddRef() override
+    {
+        return ++m_RefCount;
+    }
+
+    ULONG STDMETHODCALLTYPE Release() override
+    {
+        const ULONG refCount = --m_RefCount;
+        if (refCount == 0)
+        {
+            delete this;
+        }
+
+        return refCount;
+    }
+
+private:
+    const void*        m_pData    = nullptr;
+    size_t             m_Size     = 0;
+    std::atomic<ULONG> m_RefCount = {1};
+};
+
 WorkGraphRenderModule::WorkGraphRenderModule()
     : RenderModule(L"WorkGraphRenderModule")
 {
@@ -67,6 +166,27 @@ WorkGraphRenderModule::WorkGraphRenderModule()
 
 WorkGraphRenderModule::~WorkGraphRenderModule()
 {
+    // Saves the flythrough recording
+    if (m_pFlythroughPlayer)
+        delete m_pFlythroughPlayer;
+
+    // Stop hot-reload & wait for pending rebuild
+    if (m_pShaderFileWatcher)
+        delete m_pShaderFileWatcher;
+    if (m_WorkGraphRebuild.valid())
+    {
+        WorkGraphRebuild rebuild = m_WorkGraphRebuild.get();
+        if (rebuild.pStateObject)
+            rebuild.pStateObject->Release();
+        ReleaseShaderBlobs(rebuild.Shaders);
+    }
+    for (auto& retired : m_RetiredWorkGraphs)
+    {
+        retired.pStateObject->Release();
+        delete retired.pBackingMemoryBuffer;
+    }
+    ReleaseShaderBlobs(m_WorkGraphShaders);
+
     // Delete work graph
     if (m_pWorkGraphStateObject)
         m_pWorkGraphStateObject->Release();
@@ -77,6 +197,30 @@ WorkGraphRenderModule::~WorkGraphRenderModule()
     if (m_pWorkGraphBackingMemoryBuffer)
         delete m_pWorkGraphBackingMemoryBuffer;
 
+    // closes a running capture
+    if (m_pFrameTraceCapture)
+        delete m_pFrameTraceCapture;
+
+    if (m_pGeometryBudgetGovernor)
+        delete m_pGeometryBudgetGovernor;
+
+    if (m_pGenerationCounters)
+        delete m_pGenerationCounters;
+
+    // Delete terrain clipmap
+    if (m_pChunkCuller)
+        delete m_pChunkCuller;
+    if (m_pHorizonCuller)
+        delete m_pHorizonCuller;
+    if (m_pChunkMetadataCache)
+        delete m_pChunkMetadataCache;
+    if (m_pTerrainClipmap)
+        delete m_pTerrainClipmap;
+    if (m_pTerrainClipmapBuffer)
+        delete m_pTerrainClipmapBuffer;
+    if (m_pTerrainClipmapUploadBuffer)
+        m_pTerrainClipmapUploadBuffer->Release();
+
     // Delete shading pipeline
     if (m_pShadingPipeline)
         delete m_pShadingPipeline;
@@ -84,27 +228,204 @@ WorkGraphRenderModule::~WorkGraphRenderModule()
         delete m_pShadingRootSignature;
     if (m_pShadingParameterSet)
         delete m_pShadingParameterSet;
+
+    if (m_pShaderCache)
+        delete m_pShaderCache;
 }
 
 void WorkGraphRenderModule::Init(const json& initData)
 {
-    InitTextures();
+    const auto initStartTime = StartupTimeline::Clock::now();
+
+    // Startup timeline report
+    // "StartupTimeline": "startuptimeline.json"
+    if (initData.find("StartupTimeline") != initData.end())
+    {
+        const std::string reportPath = initData["StartupTimeline"].get<std::string>();
+        StartupTimeline::Get().SetReportPath(std::wstring(reportPath.begin(), reportPath.end()));
+    }
+
+    // Shader cache settings
+    // "ShaderCache": { "Enabled": true, "Directory": "shadercache", "Invalidate": false }
+    {
+        bool        enabled    = true;
+        bool        invalidate = false;
+        std::string directory  = "shadercache";
+
+        if (initData.find("ShaderCache") != initData.end())
+        {
+            const json& cacheConfig = initData["ShaderCache"];
+
+            enabled    = cacheConfig.value("Enabled", enabled);
+            invalidate = cacheConfig.value("Invalidate", invalidate);
+            directory  = cacheConfig.value("Directory", directory);
+        }
+
+        if (enabled)
+        {
+            m_pShaderCache = new ShaderCache(std::wstring(directory.begin(), directory.end()));
+
+            if (invalidate)
+            {
+                m_pShaderCache->Invalidate();
+            }
+        }
+    }
+
+    // Precompiled shader archive, see MeshNodeShaderTool
+    // "ShaderArchive": "workgraphshaders.mnsa"
+    if (initData.find("ShaderArchive") != initData.end())
+    {
+        const std::string archivePath = initData["ShaderArchive"].get<std::string>();
+
+        if (!m_ShaderArchive.Open(std::wstring(archivePath.begin(), archivePath.end())))
+        {
+            Log::Write(LOGLEVEL_INFO, L"No valid shader archive found at %hs, compiling shaders from source.", archivePath.c_str());
+        }
+    }
+
+    // Quality tier, selects the define set all work graph shaders are compiled with
+    // "QualityTier": "High", "QualityTiers": { "High": { "DENSE_GRASS_MAX_DISTANCE": "80.f", ... }, ... }
+    if (initData.find("QualityTier") != initData.end())
+    {
+        const std::string tier = initData["QualityTier"].get<std::string>();
+
+        if ((initData.find("QualityTiers") != initData.end()) && (initData["QualityTiers"].find(tier) != initData["QualityTiers"].end()))
+        {
+            for (const auto& define : initData["QualityTiers"][tier].items())
+            {
+                // values are passed verbatim, such that the variant key matches the archive built by MeshNodeShaderTool
+                const std::string value = define.value().get<std::string>();
+
+                m_ShaderDefines.push_back(
+                    {std::wstring(define.key().begin(), define.key().end()), std::wstring(value.begin(), value.end())});
+            }
+
+            Log::Write(LOGLEVEL_INFO, L"Quality tier: %hs", tier.c_str());
+        }
+        else
+        {
+            CauldronWarning(L"Unknown quality tier %hs, using shader defaults.", tier.c_str());
+        }
+    }
+
+    // Work graph backing memory size, 0 uses MaxSizeInBytes. See "MeshNodeCpuTool limits" for a recommended size.
+    // "BackingMemory": { "SizeInBytes": 0 }
+    if (initData.find("BackingMemory") != initData.end())
+    {
+        m_WorkGraphBackingMemorySize = initData["BackingMemory"].value("SizeInBytes", m_WorkGraphBackingMemorySize);
+    }
+
+    // Shader hot-reload settings
+    // "HotReload": { "Enabled": false, "PollIntervalMs": 250 }
+    if (initData.find("HotReload") != initData.end())
+    {
+        const json& hotReloadConfig = initData["HotReload"];
+
+        if (hotReloadConfig.value("Enabled", false))
+        {
+            const uint32_t pollIntervalMs = hotReloadConfig.value("PollIntervalMs", 250u);
+
+            // watch shaders in same folder as ShaderCompiler loads them from
+            m_pShaderFileWatcher = new ShaderFileWatcher(L"shaders", pollIntervalMs);
+        }
+    }
+
+    {
+        StartupTimer timer("InitTextures");
+        InitTextures();
+    }
+    {
+        StartupTimer timer("InitTerrainClipmap");
+        InitTerrainClipmap(initData);
+    }
+    InitChunkCulling(initData);
+    InitGeometryBudget(initData);
+
+    // Generation counters
+    // "GenerationCounters": { "Enabled": false }
+    // Records, thread groups, mesh outputs & record array occupancy per node, shown in the "Generation Counters" UI section.
+    // The atomics are skipped by the nodes while disabled, can be toggled in the UI.
+    {
+        bool enabled = false;
+        if (initData.find("GenerationCounters") != initData.end())
+        {
+            enabled = initData["GenerationCounters"].value("Enabled", enabled);
+        }
+
+        m_pGenerationCounters = new GenerationCounterReadback(enabled, WorkGraphRetireFrameCount);
+    }
+
+
+    // Flythrough recording & playback
+    // "Flythrough": { "Mode": "Off", "Recording": "flythrough.mnft", "Path": "", "Stats": "flythroughstats.csv" }
+    // Mode is "Off", "Record" or "Playback". Playback uses the JSON key frame path if "Path" is set, the recording otherwise.
+    if (initData.find("Flythrough") != initData.end())
+    {
+        const json&       flythroughConfig = initData["Flythrough"];
+        const std::string mode             = flythroughConfig.value("Mode", std::string("Off"));
+        const std::string recordingPath    = flythroughConfig.value("Recording", std::string("flythrough.mnft"));
+        const std::string statsPath        = flythroughConfig.value("Stats", std::string("flythroughstats.csv"));
+
+        if ((mode == "Record") || (mode == "Playback"))
+        {
+            m_pFlythroughPlayer =
+                new FlythroughPlayer(std::wstring(recordingPath.begin(), recordingPath.end()), std::wstring(statsPath.begin(), statsPath.end()));
+
+            if (mode == "Record")
+            {
+                m_pFlythroughPlayer->StartRecording();
+            }
+            else if (!m_pFlythroughPlayer->StartPlayback(flythroughConfig.value("Path", std::string())))
+            {
+                delete m_pFlythroughPlayer;
+                m_pFlythroughPlayer = nullptr;
+            }
+        }
+    }
+
+    InitFrameTrace(initData);
+    // Shading pipeline is built in the background while the work graph shaders are compiled
+    auto shadingPipelineReady = InitShadingPipeline();
     InitWorkGraphProgram();
-    InitShadingPipeline();
+    shadingPipelineReady.get();
 
     cauldron::UISection uiSection = {};
     uiSection.SectionName         = "Procedural Generation";
 
     uiSection.AddFloatSlider("Wind Strength", &m_WindStrength, 0.f, 2.5f);
     uiSection.AddFloatSlider("Wind Direction", &m_WindDirection, 0.f, 360.f, nullptr, nullptr, false, "%.1f");
+    uiSection.AddCheckBox("Geometry Budget", &m_GeometryBudgetEnabled);
+    uiSection.AddFloatSlider("Work Graph Budget (ms)", &m_GeometryBudgetTargetMs, 1.f, 33.f, nullptr, &m_GeometryBudgetEnabled, false, "%.1f");
 
     GetUIManager()->RegisterUIElements(uiSection);
 
+    m_pGenerationCounters->InitUI();
+
+    m_pFrameTraceCapture->InitUI();
+
+    // Report all phases so far. FSR2 context creation & remaining phases are reported once the sample finished initializing.
+    StartupTimeline::Get().AddPhase("WorkGraphRenderModule::Init", initStartTime, StartupTimeline::Clock::now(), std::this_thread::get_id());
+    StartupTimeline::Get().Report();
+
     SetModuleReady(true);
 }
 
 void WorkGraphRenderModule::Execute(double deltaTime, cauldron::CommandList* pCmdList)
 {
+    const auto executeStartTime = std::chrono::high_resolution_clock::now();
+
+    // Swap in reloaded shaders before recording any work graph commands
+    UpdateShaderHotReload();
+
+    // Flythrough playback replaces time step & wind settings with the frame last applied to the camera
+    if (const meshnode::FlythroughFrame* pFrame = m_pFlythroughPlayer ? m_pFlythroughPlayer->GetPlaybackFrame() : nullptr)
+    {
+        deltaTime       = pFrame->DeltaTime;
+        m_WindStrength  = pFrame->WindStrength;
+        m_WindDirection = pFrame->WindDirection;
+    }
+
     const auto previousShaderTime = m_shaderTime;
 
     // Increment shader time
@@ -126,8 +447,39 @@ void WorkGraphRenderModule::Execute(double deltaTime, cauldron::CommandList* pCm
         height = resInfo.RenderHeight;
     }
 
+    // Settings in effect during the frame
+    m_pFrameTraceCapture->Update(executeStartTime,
+                                 m_pFlythroughPlayer,
+                                 {
+                                     {"DeltaTime", deltaTime},
+                                     {"WindStrength", m_WindStrength},
+                                     {"WindDirection", m_WindDirection},
+                                     {"GeometryBudgetEnabled", m_GeometryBudgetEnabled ? 1.0 : 0.0},
+                                     {"GeometryBudgetTargetMs", m_GeometryBudgetTargetMs},
+                                     {"GeometryBudgetLevel", m_GeometryBudgetEnabled ? m_pGeometryBudgetGovernor->GetLevel() : 1.0},
+                                     {"GenerationCountersEnabled", m_pGenerationCounters->IsEnabled() ? 1.0 : 0.0},
+                                     {"Width", static_cast<double>(width)},
+                                     {"Height", static_cast<double>(height)},
+                                 });
+
+    // CPU time spent updating the terrain clipmap & culling chunks, chunks culled with their height bounds or hidden behind the terrain and
+    // the chunk metadata cache hit rate, reported in the flythrough statistics
+    FlythroughFrameStats frameStats = {};
+
+    auto clipmapStartTime      = executeStartTime;
+    auto chunkCullingStartTime = executeStartTime;
+
     {
-        GPUScopedProfileCapture workGraphMarker(pCmdList, L"Work Graph");
+        // Upload regenerated clipmap texels before the work graph samples the clipmap
+        clipmapStartTime = std::chrono::high_resolution_clock::now();
+
+        meshnode::WorkGraphCBData workGraphData = {};
+        UpdateTerrainClipmap(pCmdList, GetScene()->GetCurrentCamera()->GetCameraTranslation(), workGraphData);
+
+        frameStats.TerrainClipmapTimeMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - clipmapStartTime).count();
+
+        UpdateGeometryBudget(workGraphData);
+        m_pGenerationCounters->Update(pCmdList, workGraphData);
 
         std::vector<Barrier> barriers;
         barriers.push_back(Barrier::Transition(m_pGBufferColorOutput->GetResource(),
@@ -160,18 +512,19 @@ void WorkGraphRenderModule::Execute(double deltaTime, cauldron::CommandList* pCm
 
         const auto* currentCamera = GetScene()->GetCurrentCamera();
 
-        WorkGraphCBData workGraphData        = {};
-        workGraphData.ViewProjection         = currentCamera->GetProjectionJittered() * currentCamera->GetView();
-        workGraphData.PreviousViewProjection = currentCamera->GetPrevProjectionJittered() * currentCamera->GetPreviousView();
-        workGraphData.InverseViewProjection  = InverseMatrix(workGraphData.ViewProjection);
-        workGraphData.CameraPosition         = currentCamera->GetCameraTranslation();
-        workGraphData.PreviousCameraPosition = InverseMatrix(currentCamera->GetPreviousView()).getCol3();
+        const Mat4 viewProjection = currentCamera->GetProjectionJittered() * currentCamera->GetView();
+
+        workGraphData.ViewProjection         = ToFloat4x4(viewProjection);
+        workGraphData.PreviousViewProjection = ToFloat4x4(currentCamera->GetPrevProjectionJittered() * currentCamera->GetPreviousView());
+        workGraphData.InverseViewProjection  = ToFloat4x4(InverseMatrix(viewProjection));
+        workGraphData.CameraPosition         = ToFloat4(currentCamera->GetCameraTranslation());
+        workGraphData.PreviousCameraPosition = ToFloat4(InverseMatrix(currentCamera->GetPreviousView()).getCol3());
         workGraphData.ShaderTime             = m_shaderTime;
         workGraphData.PreviousShaderTime     = previousShaderTime;
         workGraphData.WindStrength           = m_WindStrength;
         workGraphData.WindDirection          = DEG_TO_RAD(m_WindDirection);
 
-        BufferAddressInfo workGraphDataInfo = GetDynamicBufferPool()->AllocConstantBuffer(sizeof(WorkGraphCBData), &workGraphData);
+        BufferAddressInfo workGraphDataInfo = GetDynamicBufferPool()->AllocConstantBuffer(sizeof(meshnode::WorkGraphCBData), &workGraphData);
         m_pWorkGraphParameterSet->UpdateRootConstantBuffer(&workGraphDataInfo, 0);
 
         // Bind all the parameters
@@ -189,22 +542,55 @@ void WorkGraphRenderModule::Execute(double deltaTime, cauldron::CommandList* pCm
             dispatchDesc.NodeCPUInput.RecordStrideInBytes = 0;
             dispatchDesc.NodeCPUInput.pRecords            = nullptr;
 
-            // Get ID3D12GraphicsCommandList10 from Cauldron command list
-            ID3D12GraphicsCommandList10* commandList;
-            CauldronThrowOnFail(pCmdList->GetImpl()->DX12CmdList()->QueryInterface(IID_PPV_ARGS(&commandList)));
-
-            commandList->SetProgram(&m_WorkGraphProgramDesc);
-            commandList->DispatchGraph(&dispatchDesc);
-
-            // Release command list (only releases additional reference created by QueryInterface)
-            commandList->Release();
-
-            // Clear backing memory initialization flag, as the graph has run at least once now
-            m_WorkGraphProgramDesc.WorkGraph.Flags &= ~D3D12_SET_WORK_GRAPH_FLAG_INITIALIZE;
+            if (m_pChunkCuller)
+            {
+                // Launch graph with one record per visible chunk, records are copied into the command list
+                if (m_pChunkMetadataCache)
+                {
+                    m_pChunkMetadataCache->BeginFrame(workGraphData.CameraPosition.xyz());
+                }
+
+                chunkCullingStartTime = std::chrono::high_resolution_clock::now();
+
+                const std::vector<meshnode::ChunkRecord>& chunks = m_pChunkCuller->Cull(workGraphData);
+
+                frameStats.ChunkCullingTimeMs     = m_pChunkCuller->GetStats().TimeMs;
+                frameStats.VisibleChunkCount      = static_cast<uint32_t>(chunks.size());
+                frameStats.BoundsCulledChunkCount = m_pChunkCuller->GetStats().BoundsCulledChunkCount;
+                frameStats.OccludedChunkCount     = m_pChunkCuller->GetStats().OccludedChunkCount;
+                frameStats.MetadataCacheHitRate   = m_pChunkMetadataCache ? m_pChunkMetadataCache->GetFrameStats().GetHitRate() : 0.0;
+
+                dispatchDesc.NodeCPUInput.EntrypointIndex     = m_WorkGraphChunkEntryPointIndex;
+                dispatchDesc.NodeCPUInput.NumRecords          = frameStats.VisibleChunkCount;
+                dispatchDesc.NodeCPUInput.RecordStrideInBytes = sizeof(meshnode::ChunkRecord);
+                dispatchDesc.NodeCPUInput.pRecords            = chunks.data();
+            }
+
+            // Nothing to draw if all chunks were culled
+            if (dispatchDesc.NodeCPUInput.NumRecords > 0)
+            {
+                // Only the work graph itself is timed, the clears & uploads above are excluded from the geometry budget
+                GPUScopedProfileCapture workGraphMarker(pCmdList, L"Work Graph");
+
+                // Get ID3D12GraphicsCommandList10 from Cauldron command list
+                ID3D12GraphicsCommandList10* commandList;
+                CauldronThrowOnFail(pCmdList->GetImpl()->DX12CmdList()->QueryInterface(IID_PPV_ARGS(&commandList)));
+
+                commandList->SetProgram(&m_WorkGraphProgramDesc);
+                commandList->DispatchGraph(&dispatchDesc);
+
+                // Release command list (only releases additional reference created by QueryInterface)
+                commandList->Release();
+
+                // Clear backing memory initialization flag, as the graph has run at least once now
+                m_WorkGraphProgramDesc.WorkGraph.Flags &= ~D3D12_SET_WORK_GRAPH_FLAG_INITIALIZE;
+            }
         }
 
         EndRaster(pCmdList, nullptr);
 
+        m_pGenerationCounters->ReadBack(pCmdList);
+
         // Transition render targets back to readable state
         for (auto& barrier : barriers)
         {
@@ -249,6 +635,23 @@ void WorkGraphRenderModule::Execute(double deltaTime, cauldron::CommandList* pCm
             m_pShadingOutput->GetResource(), ResourceState::UnorderedAccess, ResourceState::NonPixelShaderResource | ResourceState::PixelShaderResource);
         ResourceBarrier(pCmdList, 1, &barrier);
     }
+
+    if (m_pFlythroughPlayer)
+    {
+        frameStats.ExecuteTimeMs       = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - executeStartTime).count();
+        frameStats.WorkGraphGpuTimeMs  = m_WorkGraphGpuTimeMs;
+        frameStats.GeometryBudgetLevel = m_GeometryBudgetEnabled ? m_pGeometryBudgetGovernor->GetLevel() : 1.0;
+        frameStats.GenerationCounters  = m_pGenerationCounters->GetTotals();
+
+        m_pFlythroughPlayer->Update(deltaTime, m_WindStrength, m_WindDirection, frameStats);
+    }
+
+    m_pFrameTraceCapture->AddCpuEvent("TerrainClipmap", clipmapStartTime, frameStats.TerrainClipmapTimeMs);
+    if (m_pChunkCuller)
+    {
+        m_pFrameTraceCapture->AddCpuEvent("ChunkCulling", chunkCullingStartTime, frameStats.ChunkCullingTimeMs);
+    }
+    m_pFrameTraceCapture->AddEvents(m_WorkGraphGpuTimeMs);
 }
 
 void WorkGraphRenderModule::OnResize(const cauldron::ResolutionInfo& resInfo)
@@ -272,11 +675,311 @@ void WorkGraphRenderModule::InitTextures()
     m_pGBufferDepthRasterView = GetRasterViewAllocator()->RequestRasterView(m_pGBufferDepthOutput, ViewDimension::Texture2D);
 }
 
+void WorkGraphRenderModule::InitTerrainClipmap(const json& initData)
+{
+    // Terrain clipmap settings
+    // "TerrainClipmap": { "Enabled": true, "LevelCount": 6, "Resolution": 256, "TexelSize": 1.0, "BlendWidth": 16.0, "TexelBudget": 65536 }
+    bool                         enabled = false;
+    meshnode::TerrainClipmapDesc desc    = {};
+
+    if (initData.find("TerrainClipmap") != initData.end())
+    {
+        const json& clipmapConfig = initData["TerrainClipmap"];
+
+        enabled          = clipmapConfig.value("Enabled", enabled);
+        desc.LevelCount  = std::min(clipmapConfig.value("LevelCount", desc.LevelCount), static_cast<uint32_t>(TERRAIN_CLIPMAP_MAX_LEVEL_COUNT));
+        desc.Resolution  = clipmapConfig.value("Resolution", desc.Resolution);
+        desc.TexelSize   = clipmapConfig.value("TexelSize", desc.TexelSize);
+        desc.BlendWidth  = clipmapConfig.value("BlendWidth", desc.BlendWidth);
+        desc.TexelBudget = clipmapConfig.value("TexelBudget", desc.TexelBudget);
+    }
+
+    // The buffer is bound to the work graph in any case, a single texel suffices if the clipmap is disabled
+    size_t texelCount = 1;
+
+    if (enabled)
+    {
+        m_pTerrainClipmap = new meshnode::TerrainClipmap(desc);
+        texelCount        = m_pTerrainClipmap->GetTexels().size();
+
+        // Each upload slot can hold all levels, such that a frame never runs out of upload memory
+        const CD3DX12_HEAP_PROPERTIES heapProperties(D3D12_HEAP_TYPE_UPLOAD);
+        const CD3DX12_RESOURCE_DESC   resourceDesc = CD3DX12_RESOURCE_DESC::Buffer(texelCount * sizeof(meshnode::TerrainClipmapTexel) * WorkGraphRetireFrameCount);
+
+        CauldronThrowOnFail(GetDevice()->GetImpl()->DX12Device()->CreateCommittedResource(
+            &heapProperties, D3D12_HEAP_FLAG_NONE, &resourceDesc, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&m_pTerrainClipmapUploadBuffer)));
+
+        // upload buffer stays mapped, it is never read on the CPU
+        const CD3DX12_RANGE readRange(0, 0);
+        CauldronThrowOnFail(m_pTerrainClipmapUploadBuffer->Map(0, &readRange, reinterpret_cast<void**>(&m_pTerrainClipmapUploadData)));
+
+        Log::Write(LOGLEVEL_INFO,
+                   L"Terrain clipmap: %u levels with %ux%u texels, finest texel size %.2f",
+                   m_pTerrainClipmap->GetDesc().LevelCount,
+                   m_pTerrainClipmap->GetDesc().Resolution,
+                   m_pTerrainClipmap->GetDesc().Resolution,
+                   m_pTerrainClipmap->GetDesc().TexelSize);
+    }
+
+    BufferDesc bufferDesc = BufferDesc::Data(L"MeshNodeSample_TerrainClipmap",
+                                             static_cast<uint32_t>(texelCount * sizeof(meshnode::TerrainClipmapTexel)),
+                                             sizeof(meshnode::TerrainClipmapTexel),
+                                             0,
+                                             ResourceFlags::None);
+
+    m_pTerrainClipmapBuffer = Buffer::CreateBufferResource(&bufferDesc, ResourceState::NonPixelShaderResource | ResourceState::PixelShaderResource);
+}
+
+void WorkGraphRenderModule::UpdateTerrainClipmap(cauldron::CommandList* pCmdList, const Vec4& cameraPosition, meshnode::WorkGraphCBData& workGraphData)
+{
+    if (m_pTerrainClipmap == nullptr)
+    {
+        // shaders only use the analytic terrain functions
+        workGraphData.TerrainClipmapLevelCount = 0;
+        return;
+    }
+
+    // Levels are regenerated within the texel budget, levels not caught up with the camera keep their previous window
+    m_pTerrainClipmap->Update(cameraPosition.getX(), cameraPosition.getZ());
+
+    const auto& texels       = m_pTerrainClipmap->GetTexels();
+    const auto& uploadRanges = m_pTerrainClipmap->GetUploadRanges();
+
+    if (!uploadRanges.empty())
+    {
+        // Upload slots are reused after WorkGraphRetireFrameCount uploads, at which point the GPU finished all copies from the slot
+        size_t uploadOffset        = m_TerrainClipmapUploadSlot * texels.size() * sizeof(meshnode::TerrainClipmapTexel);
+        m_TerrainClipmapUploadSlot = (m_TerrainClipmapUploadSlot + 1) % WorkGraphRetireFrameCount;
+
+        Barrier barrier = Barrier::Transition(
+            m_pTerrainClipmapBuffer->GetResource(), ResourceState::NonPixelShaderResource | ResourceState::PixelShaderResource, ResourceState::CopyDest);
+        ResourceBarrier(pCmdList, 1, &barrier);
+
+        ID3D12GraphicsCommandList* commandList = pCmdList->GetImpl()->DX12CmdList();
+        ID3D12Resource*            destination = m_pTerrainClipmapBuffer->GetResource()->GetImpl()->DX12Resource();
+
+        for (const auto& range : uploadRanges)
+        {
+            const size_t size = range.TexelCount * sizeof(meshnode::TerrainClipmapTexel);
+
+            memcpy(m_pTerrainClipmapUploadData + uploadOffset, &texels[range.FirstTexel], size);
+            commandList->CopyBufferRegion(
+                destination, range.FirstTexel * sizeof(meshnode::TerrainClipmapTexel), m_pTerrainClipmapUploadBuffer, uploadOffset, size);
+
+            uploadOffset += size;
+        }
+
+        std::swap(barrier.DestState, barrier.SourceState);
+        ResourceBarrier(pCmdList, 1, &barrier);
+    }
+
+    const auto& desc = m_pTerrainClipmap->GetDesc();
+
+    for (uint32_t i = 0; i < desc.LevelCount; ++i)
+    {
+        const auto& level = m_pTerrainClipmap->GetLevel(i);
+
+        workGraphData.TerrainClipmapLevels[i] = meshnode::int4(level.OriginX, level.OriginZ, level.Valid ? 1 : 0, 0);
+    }
+
+    workGraphData.TerrainClipmapTexelSize  = desc.TexelSize;
+    workGraphData.TerrainClipmapResolution = desc.Resolution;
+    workGraphData.TerrainClipmapLevelCount = desc.LevelCount;
+    workGraphData.TerrainClipmapBlendWidth = desc.BlendWidth;
+}
+
+void WorkGraphRenderModule::InitChunkCulling(const json& initData)
+{
+    // CPU chunk culling settings
+    // "ChunkCulling": { "Enabled": true }
+    if ((initData.find("ChunkCulling") == initData.end()) || !initData["ChunkCulling"].value("Enabled", false))
+    {
+        return;
+    }
+
+    meshnode::ChunkCullingDesc desc = {};
+    // LOD is selected from the same terrain heights the shaders sample
+    desc.pTerrainClipmap = m_pTerrainClipmap;
+
+    // The chunk grid extent must match the quality tier the World node is compiled with
+    for (const auto& define : m_ShaderDefines)
+    {
+        if (define.Name == L"WORLD_GRID_MAX_DISTANCE")
+        {
+            desc.Quality.WorldGridMaxDistance = std::stof(define.Value);
+        }
+    }
+
+    // "MetadataCache": { "Enabled": true, "Capacity": 4096 }
+    // Chunk levels of detail & tile biomes are only computed for chunks entering the view or crossing a level of detail band.
+    // The cache samples the analytic terrain instead of the clipmap, which only differs by the clipmap interpolation error.
+    const json& cullingConfig = initData["ChunkCulling"];
+
+    if ((cullingConfig.find("MetadataCache") != cullingConfig.end()) && cullingConfig["MetadataCache"].value("Enabled", false))
+    {
+        const json& cacheConfig = cullingConfig["MetadataCache"];
+
+        meshnode::ChunkMetadataCacheDesc cacheDesc = {};
+        cacheDesc.Capacity                         = cacheConfig.value("Capacity", cacheDesc.Capacity);
+        // keep chunks just outside the grid, such that turning the camera back hits the cache
+        cacheDesc.EvictionDistance = desc.Quality.WorldGridMaxDistance + 2 * meshnode::TerrainChunkSize;
+
+        m_pChunkMetadataCache = new meshnode::ChunkMetadataCache(cacheDesc);
+        desc.pMetadataCache   = m_pChunkMetadataCache;
+    }
+
+    // "HeightBounds": { "Enabled": true }
+    // Chunks & tiles are tested with boxes around their terrain height range instead of the fixed -100 to 300 m, the tile height bounds are
+    // kept in the metadata cache.
+    if ((cullingConfig.find("HeightBounds") != cullingConfig.end()) && cullingConfig["HeightBounds"].value("Enabled", false))
+    {
+        if (m_pChunkMetadataCache)
+        {
+            desc.UseHeightBounds = true;
+        }
+        else
+        {
+            CauldronWarning(L"Height bounds culling requires the chunk metadata cache, height bounds culling is disabled.");
+        }
+    }
+
+    // "HorizonCulling": { "Enabled": true }
+    // Chunks & tiles hidden behind nearer terrain are skipped, the tile height bounds are kept in the metadata cache.
+    if ((cullingConfig.find("HorizonCulling") != cullingConfig.end()) && cullingConfig["HorizonCulling"].value("Enabled", false))
+    {
+        if (m_pChunkMetadataCache)
+        {
+            m_pHorizonCuller    = new meshnode::HorizonCuller(meshnode::HorizonCullingDesc(), *m_pChunkMetadataCache);
+            desc.pHorizonCuller = m_pHorizonCuller;
+        }
+        else
+        {
+            CauldronWarning(L"Horizon culling requires the chunk metadata cache, horizon culling is disabled.");
+        }
+    }
+
+    m_pChunkCuller = new meshnode::ChunkCuller(desc);
+
+    Log::Write(LOGLEVEL_INFO,
+               L"CPU chunk culling enabled, terrain kernels: %hs, metadata cache: %ls, height bounds: %ls, horizon culling: %ls",
+               meshnode::GetTerrainKernelIsaName(meshnode::GetBestTerrainKernelIsa()),
+               m_pChunkMetadataCache ? L"on" : L"off",
+               desc.UseHeightBounds ? L"on" : L"off",
+               m_pHorizonCuller ? L"on" : L"off");
+}
+
+void WorkGraphRenderModule::InitGeometryBudget(const json& initData)
+{
+    // Geometry budget governor
+    // "GeometryBudget": { "Enabled": false, "TargetMs": 10.0, "Hysteresis": 0.1, "MinLevel": 0.25 }
+    // Scales dense & sparse grass, flower & insect distances and the dense grass blade count below the quality tier limits,
+    // such that the GPU time of the DispatchGraph call ("Work Graph" marker) stays at TargetMs. Can be toggled in the UI.
+    meshnode::GeometryBudgetDesc desc = {};
+
+    if (initData.find("GeometryBudget") != initData.end())
+    {
+        const json& budgetConfig = initData["GeometryBudget"];
+
+        m_GeometryBudgetEnabled = budgetConfig.value("Enabled", m_GeometryBudgetEnabled);
+        desc.TargetTimeMs       = budgetConfig.value("TargetMs", desc.TargetTimeMs);
+        desc.Hysteresis         = budgetConfig.value("Hysteresis", desc.Hysteresis);
+        desc.MinLevel           = budgetConfig.value("MinLevel", desc.MinLevel);
+    }
+
+    m_GeometryBudgetTargetMs  = static_cast<float>(desc.TargetTimeMs);
+    m_pGeometryBudgetGovernor = new meshnode::GeometryBudgetGovernor(desc);
+}
+
+void WorkGraphRenderModule::UpdateGeometryBudget(meshnode::WorkGraphCBData& workGraphData)
+{
+    // The profiler reports the GPU timings of the last completed frame
+    m_WorkGraphGpuTimeMs = 0.0;
+    for (const TimingInfo& timing : GetProfiler()->GetGPUTimings())
+    {
+        if (timing.Label == L"Work Graph")
+        {
+            m_WorkGraphGpuTimeMs = std::chrono::duration<double, std::milli>(timing.EndTime - timing.StartTime).count();
+        }
+    }
+
+    if (!m_GeometryBudgetEnabled)
+    {
+        m_pGeometryBudgetGovernor->Reset();
+        meshnode::SetGeometryBudget(workGraphData, meshnode::GeometryBudgetScales());
+        return;
+    }
+
+    m_pGeometryBudgetGovernor->SetTargetTimeMs(m_GeometryBudgetTargetMs);
+    m_pGeometryBudgetGovernor->Update(m_WorkGraphGpuTimeMs);
+
+    meshnode::SetGeometryBudget(workGraphData, m_pGeometryBudgetGovernor->GetScales());
+}
+
+// Settings & shader defines are ASCII
+static std::string ToNarrowString(const std::wstring& string)
+{
+    std::string result;
+    for (const wchar_t c : string)
+    {
+        result.push_back(static_cast<char>(c));
+    }
+    return result;
+}
+
+void WorkGraphRenderModule::InitFrameTrace(const json& initData)
+{
+    // Frame trace capture
+    // "FrameTrace": { "Enabled": false, "Path": "frametrace.json", "FrameCount": 600, "BufferSizeInBytes": 4194304,
+    //                 "CpuMarkerLatencyFrames": 1, "GpuMarkerLatencyFrames": 3 }
+    // Writes frames, CPU times & profiler markers in the Chrome trace event format, e.g. for comparing a flythrough across builds
+    // in chrome://tracing or ui.perfetto.dev. Enabled starts a capture with the first frame, captures can be started in the UI.
+    // The latencies are the frames between a frame & the profiler reporting its markers, for GPU markers the swap chain back buffer count.
+    FrameTraceCaptureDesc desc = {};
+
+    if (initData.find("FrameTrace") != initData.end())
+    {
+        const json& traceConfig = initData["FrameTrace"];
+
+        desc.Enabled          = traceConfig.value("Enabled", desc.Enabled);
+        desc.Path             = traceConfig.value("Path", desc.Path);
+        desc.FrameCount       = traceConfig.value("FrameCount", desc.FrameCount);
+        desc.BufferSize       = traceConfig.value("BufferSizeInBytes", desc.BufferSize);
+        desc.CpuMarkerLatency = traceConfig.value("CpuMarkerLatencyFrames", desc.CpuMarkerLatency);
+        desc.GpuMarkerLatency = traceConfig.value("GpuMarkerLatencyFrames", desc.GpuMarkerLatency);
+    }
+
+    // Settings fixed at startup, the settings that can change are written with every frame
+    std::vector<std::pair<std::string, std::string>> metadata = {
+        {"Build", __DATE__ " " __TIME__},
+        {"QualityTier", initData.value("QualityTier", std::string())},
+        {"TerrainClipmap", m_pTerrainClipmap ? "Enabled" : "Disabled"},
+        {"ChunkCulling", m_pChunkCuller ? "Enabled" : "Disabled"},
+        {"MetadataCache", m_pChunkMetadataCache ? "Enabled" : "Disabled"},
+        {"HorizonCulling", m_pHorizonCuller ? "Enabled" : "Disabled"},
+        {"BackingMemorySizeInBytes", std::to_string(m_WorkGraphBackingMemorySize)},
+    };
+
+    // key frame path or recording played back
+    if (m_pFlythroughPlayer && m_pFlythroughPlayer->IsPlaying())
+    {
+        metadata.push_back({"Flythrough", m_pFlythroughPlayer->GetPlaybackSource()});
+    }
+
+    for (const ShaderDefine& define : m_ShaderDefines)
+    {
+        metadata.push_back({ToNarrowString(define.Name), ToNarrowString(define.Value)});
+    }
+
+    m_pFrameTraceCapture = new FrameTraceCapture(desc, metadata);
+}
+
 void WorkGraphRenderModule::InitWorkGraphProgram()
 {
     // Create root signature for work graph
     RootSignatureDesc workGraphRootSigDesc;
     workGraphRootSigDesc.AddConstantBufferView(0, ShaderBindStage::Compute, 1);
+    workGraphRootSigDesc.AddBufferSRVSet(0, ShaderBindStage::Compute, 1);
+    workGraphRootSigDesc.AddBufferUAVSet(0, ShaderBindStage::Compute, 1);
     // Work graphs with mesh nodes use graphics root signature instead of compute root signature
     workGraphRootSigDesc.m_PipelineType = PipelineType::Graphics;
 
@@ -284,18 +987,22 @@ void WorkGraphRenderModule::InitWorkGraphProgram()
 
     // Create parameter set for root signature
     m_pWorkGraphParameterSet = ParameterSet::CreateParameterSet(m_pWorkGraphRootSignature);
-    m_pWorkGraphParameterSet->SetRootConstantBufferResource(GetDynamicBufferPool()->GetResource(), sizeof(WorkGraphCBData), 0);
-
-    // Get D3D12 device
-    // CreateStateObject is only available on ID3D12Device9
-    ID3D12Device9* d3dDevice = nullptr;
-    CauldronThrowOnFail(GetDevice()->GetImpl()->DX12Device()->QueryInterface(IID_PPV_ARGS(&d3dDevice)));
+    m_pWorkGraphParameterSet->SetRootConstantBufferResource(GetDynamicBufferPool()->GetResource(), sizeof(meshnode::WorkGraphCBData), 0);
+    m_pWorkGraphParameterSet->SetBufferSRV(m_pTerrainClipmapBuffer, 0);
+    m_pWorkGraphParameterSet->SetBufferUAV(m_pGenerationCounters->GetCounterBuffer(), 0);
 
     // Check if mesh nodes are supported
     {
+        // CheckFeatureSupport for work graphs is only available on ID3D12Device9
+        ID3D12Device9* d3dDevice = nullptr;
+        CauldronThrowOnFail(GetDevice()->GetImpl()->DX12Device()->QueryInterface(IID_PPV_ARGS(&d3dDevice)));
+
         D3D12_FEATURE_DATA_D3D12_OPTIONS21 options = {};
         CauldronThrowOnFail(d3dDevice->CheckFeatureSupport(D3D12_FEATURE_D3D12_OPTIONS21, &options, sizeof(options)));
 
+        // Release ID3D12Device9 (only releases additional reference created by QueryInterface)
+        d3dDevice->Release();
+
         // check if work graphs tier 1.1 (mesh nodes) is supported
         if (options.WorkGraphsTier < D3D12_WORK_GRAPHS_TIER_1_1)
         {
@@ -303,6 +1010,104 @@ void WorkGraphRenderModule::InitWorkGraphProgram()
         }
     }
 
+    // DXIL shader libraries & pixel shaders, see workgraphshaders.h
+    // Shaders are taken from the precompiled shader archive if possible, all remaining shaders are compiled in parallel
+    std::vector<ShaderCompileJob> shaderCompileJobs;
+    std::vector<uint32_t>         shaderCompileJobIndices;
+
+    for (uint32_t i = 0; i < WorkGraphShaderCount; ++i)
+    {
+        ShaderCompileJob shader = {};
+        shader.ShaderFilePath   = WorkGraphShaders[i].ShaderFilePath;
+        shader.Target           = WorkGraphShaders[i].Target;
+        shader.EntryPoint       = WorkGraphShaders[i].EntryPoint;
+        shader.Defines          = m_ShaderDefines;
+
+        m_WorkGraphShaders.push_back(shader);
+
+        if (!LoadShaderFromArchive(m_WorkGraphShaders.back()))
+        {
+            shaderCompileJobs.push_back(shader);
+            shaderCompileJobIndices.push_back(i);
+        }
+    }
+
+    // Compile all shaders not found in archive
+    {
+        const auto   compileStartTime = StartupTimeline::Clock::now();
+        const double wallTimeMs       = CompileShadersParallel(shaderCompileJobs, m_pShaderCache);
+        StartupTimeline::Get().AddPhase("CompileWorkGraphShaders", compileStartTime, StartupTimeline::Clock::now(), std::this_thread::get_id());
+
+        double summedTimeMs = 0.0;
+        for (size_t i = 0; i < shaderCompileJobs.size(); ++i)
+        {
+            const auto& job = shaderCompileJobs[i];
+            StartupTimeline::Get().AddPhase("CompileShader " + ShaderArchiveToUtf8(GetShaderName(job).c_str()),
+                                            job.StartTime,
+                                            job.StartTime + std::chrono::duration_cast<StartupTimeline::Clock::duration>(
+                                                                std::chrono::duration<double, std::milli>(job.CompileTimeMs)),
+                                            job.ThreadId,
+                                            job.pBlob->GetBufferSize(),
+                                            static_cast<uint32_t>(job.Includes.size()));
+
+            summedTimeMs += shaderCompileJobs[i].CompileTimeMs;
+
+            m_WorkGraphShaders[shaderCompileJobIndices[i]] = shaderCompileJobs[i];
+        }
+
+        Log::Write(LOGLEVEL_INFO,
+                   L"Loaded %u work graph shaders from archive, compiled %u work graph shaders in %.1f ms (sum of per-shader compile times: %.1f ms)",
+                   static_cast<uint32_t>(m_WorkGraphShaders.size() - shaderCompileJobs.size()),
+                   static_cast<uint32_t>(shaderCompileJobs.size()),
+                   wallTimeMs,
+                   summedTimeMs);
+    }
+
+    if (m_pShaderCache)
+    {
+        Log::Write(LOGLEVEL_INFO,
+                   L"Shader cache (%ls): %u hits, %u misses",
+                   m_pShaderCache->GetDirectory().c_str(),
+                   m_pShaderCache->GetHitCount(),
+                   m_pShaderCache->GetMissCount());
+    }
+
+    // Create work graph state object
+    ID3D12StateObject* stateObject = nullptr;
+    {
+        StartupTimer timer("CreateStateObject");
+
+        uint64_t dxilSize = 0;
+        for (const auto& shader : m_WorkGraphShaders)
+        {
+            dxilSize += shader.pBlob->GetBufferSize();
+        }
+        timer.SetDxilSize(dxilSize);
+
+        stateObject = CreateWorkGraphStateObject(m_WorkGraphShaders);
+    }
+    if (stateObject == nullptr)
+    {
+        CauldronCritical(L"Failed to create work graph state object.");
+    }
+
+    ActivateWorkGraphStateObject(stateObject);
+
+    // Start watching all shader files & includes for hot-reload
+    UpdateShaderDependencies(m_WorkGraphShaders);
+    if (m_pShaderFileWatcher)
+    {
+        m_pShaderFileWatcher->SetWatchedFiles(m_ShaderDependencyGraph.GetFiles());
+    }
+}
+
+ID3D12StateObject* WorkGraphRenderModule::CreateWorkGraphStateObject(const std::vector<ShaderCompileJob>& shaders) const
+{
+    // Get D3D12 device
+    // CreateStateObject is only available on ID3D12Device9
+    ID3D12Device9* d3dDevice = nullptr;
+    CauldronThrowOnFail(GetDevice()->GetImpl()->DX12Device()->QueryInterface(IID_PPV_ARGS(&d3dDevice)));
+
     // Create work graph
     CD3DX12_STATE_OBJECT_DESC stateObjectDesc(D3D12_STATE_OBJECT_TYPE_EXECUTABLE);
 
@@ -319,40 +1124,14 @@ void WorkGraphRenderModule::InitWorkGraphProgram()
     workgraphSubobject->SetProgramName(WorkGraphProgramName);
 
     // add DXIL shader libraries
-    ShaderCompiler shaderCompiler;
-
-    // list of compiled shaders to be released once the work graph is created
-    std::vector<IDxcBlob*> compiledShaders;
-
-    // Helper function for adding a shader library to the work graph state object
-    const auto AddShaderLibrary = [&](const wchar_t* shaderFileName) {
-        // compile shader as library
-        auto* blob           = shaderCompiler.CompileShader(shaderFileName, L"lib_6_9", nullptr);
-        auto  shaderBytecode = CD3DX12_SHADER_BYTECODE(blob->GetBufferPointer(), blob->GetBufferSize());
-
-        // add blob to state object
-        auto librarySubobject = stateObjectDesc.CreateSubobject<CD3DX12_DXIL_LIBRARY_SUBOBJECT>();
-        librarySubobject->SetDXILLibrary(&shaderBytecode);
-
-        // add shader blob to be released later
-        compiledShaders.push_back(blob);
-    };
-
-    // Helper function for adding a pixel shader to the work graph state object
-    // Pixel shaders need to be compiled with "ps" target and as such the DXIL library object needs to specify a name
-    // for the pixel shader (exportName) with which the generic program can reference the pixel shader
-    const auto AddPixelShader = [&](const wchar_t* shaderFileName, const wchar_t* entryPoint) {
-        // compile shader as pixel shader
-        auto* blob           = shaderCompiler.CompileShader(shaderFileName, L"ps_6_9", entryPoint);
-        auto  shaderBytecode = CD3DX12_SHADER_BYTECODE(blob->GetBufferPointer(), blob->GetBufferSize());
+    for (const auto& shader : shaders)
+    {
+        auto shaderBytecode = CD3DX12_SHADER_BYTECODE(shader.pBlob->GetBufferPointer(), shader.pBlob->GetBufferSize());
 
         // add blob to state object
         auto librarySubobject = stateObjectDesc.CreateSubobject<CD3DX12_DXIL_LIBRARY_SUBOBJECT>();
         librarySubobject->SetDXILLibrary(&shaderBytecode);
-
-        // add shader blob to be released later
-        compiledShaders.push_back(blob);
-    };
+    }
 
     // ===================================================================
     // State object for graphics PSO state description in generic programs
@@ -409,38 +1188,20 @@ void WorkGraphRenderModule::InitWorkGraphProgram()
         genericProgramSubobject->AddSubobject(*renderTargetFormatSubobject);
     };
 
-    // ===================================
-    // Add shader libraries and mesh nodes
-
-    // Shader libraries for procedural world generation
-    AddShaderLibrary(L"world.hlsl");
-    AddShaderLibrary(L"biomes.hlsl");
-    AddShaderLibrary(L"tree.hlsl");
-    AddShaderLibrary(L"rock.hlsl");
+    // ==============
+    // Add mesh nodes
 
     // Terrain Mesh Node
-    AddShaderLibrary(L"terrainrenderer.hlsl");
-    AddPixelShader(L"terrainrenderer.hlsl", L"TerrainPixelShader");
     AddMeshNode(L"TerrainMeshShader", L"TerrainPixelShader", true);
 
     // Spline Mesh Node for trees & rocks
-    AddShaderLibrary(L"splinerenderer.hlsl");
-    AddPixelShader(L"splinerenderer.hlsl", L"SplinePixelShader");
     AddMeshNode(L"SplineMeshShader", L"SplinePixelShader", true);
 
     // Grass Nodes
-    AddShaderLibrary(L"densegrassmeshshader.hlsl");
-    AddShaderLibrary(L"sparsegrassmeshshader.hlsl");
-    AddPixelShader(L"grasspixelshader.hlsl", L"GrassPixelShader");
     AddMeshNode(L"DenseGrassMeshShader", L"GrassPixelShader", false);
     AddMeshNode(L"SparseGrassMeshShader", L"GrassPixelShader", false);
 
     // Flowers, Insects & Mushroom Nodes
-    AddShaderLibrary(L"beemeshshader.hlsl");
-    AddShaderLibrary(L"butterflymeshshader.hlsl");
-    AddShaderLibrary(L"flowermeshshader.hlsl");
-    AddShaderLibrary(L"mushroommeshshader.hlsl");
-    AddPixelShader(L"insectpixelshader.hlsl", L"InsectPixelShader");
     AddMeshNode(L"BeeMeshShader", L"InsectPixelShader", false);
     AddMeshNode(L"ButterflyMeshShader", L"InsectPixelShader", false);
     AddMeshNode(L"FlowerMeshShader", L"InsectPixelShader", false);
@@ -448,17 +1209,24 @@ void WorkGraphRenderModule::InitWorkGraphProgram()
     AddMeshNode(L"MushroomMeshShader", L"InsectPixelShader", false);
 
     // Create work graph state object
-    CauldronThrowOnFail(d3dDevice->CreateStateObject(stateObjectDesc, IID_PPV_ARGS(&m_pWorkGraphStateObject)));
-
-    // release all compiled shaders
-    for (auto* shader : compiledShaders)
+    ID3D12StateObject* stateObject = nullptr;
+    if (FAILED(d3dDevice->CreateStateObject(stateObjectDesc, IID_PPV_ARGS(&stateObject))))
     {
-        if (shader)
-        {
-            shader->Release();
-        }
+        stateObject = nullptr;
     }
 
+    // Release ID3D12Device9 (only releases additional reference created by QueryInterface)
+    d3dDevice->Release();
+
+    return stateObject;
+}
+
+void WorkGraphRenderModule::ActivateWorkGraphStateObject(ID3D12StateObject* pStateObject)
+{
+    m_pWorkGraphStateObject         = pStateObject;
+    m_pWorkGraphBackingMemoryBuffer = nullptr;
+    m_WorkGraphProgramDesc          = {};
+
     // Get work graph properties
     ID3D12StateObjectProperties1* stateObjectProperties;
     ID3D12WorkGraphProperties1*   workGraphProperties;
@@ -470,16 +1238,65 @@ void WorkGraphRenderModule::InitWorkGraphProgram()
     const auto workGraphIndex = workGraphProperties->GetWorkGraphIndex(WorkGraphProgramName);
 
     // Set the input record limit. This is required for work graphs with mesh nodes.
-    // In this case we'll only have a single input record
+    // The World entry is launched with a single input record
     workGraphProperties->SetMaximumInputRecords(workGraphIndex, 1, 1);
 
     // Create backing memory buffer
     D3D12_WORK_GRAPH_MEMORY_REQUIREMENTS memoryRequirements = {};
     workGraphProperties->GetWorkGraphMemoryRequirements(workGraphIndex, &memoryRequirements);
+
+    // Backing memory allocated without a configured size
+    UINT64 defaultBackingMemorySize = memoryRequirements.MaxSizeInBytes;
+
+    if (m_pChunkCuller)
+    {
+        // The Chunk entry is launched with up to one record per chunk of the grid.
+        // NodeMaxInputRecordsPerGraphEntryRecord limits of the mesh nodes scale with the number of entry records, which inflates
+        // the maximum memory requirement far beyond the records a frame generates. Any size above MinSizeInBytes is valid.
+        const D3D12_WORK_GRAPH_MEMORY_REQUIREMENTS worldMemoryRequirements = memoryRequirements;
+
+        workGraphProperties->SetMaximumInputRecords(workGraphIndex, meshnode::MaxChunkGridSize * meshnode::MaxChunkGridSize, 1);
+        workGraphProperties->GetWorkGraphMemoryRequirements(workGraphIndex, &memoryRequirements);
+
+        defaultBackingMemorySize = memoryRequirements.MaxSizeInBytes;
+
+        // Without a size measured with "MeshNodeCpuTool limits", the backing memory is capped to the maximum size of the World entry,
+        // assuming the visible chunks generate no more records than a single World record. The driver cannot check this assumption.
+        if ((m_WorkGraphBackingMemorySize == 0) && (worldMemoryRequirements.MaxSizeInBytes < memoryRequirements.MaxSizeInBytes))
+        {
+            defaultBackingMemorySize = std::max(worldMemoryRequirements.MaxSizeInBytes, memoryRequirements.MinSizeInBytes);
+
+            CauldronWarning(L"Chunk entry backing memory capped from %llu to %llu bytes, the maximum size of the World entry. "
+                            L"Set \"BackingMemory\": { \"SizeInBytes\" } to the size recommended by MeshNodeCpuTool limits.",
+                            memoryRequirements.MaxSizeInBytes,
+                            defaultBackingMemorySize);
+        }
+    }
     if (memoryRequirements.MaxSizeInBytes > 0)
     {
+        StartupTimer timer("CreateBackingMemory");
+
+        UINT64 backingMemorySize = defaultBackingMemorySize;
+        if (m_WorkGraphBackingMemorySize > 0)
+        {
+            // sizes above MinSizeInBytes grow in steps of SizeGranularityInBytes
+            const UINT64 granularity = std::max<UINT64>(memoryRequirements.SizeGranularityInBytes, 1);
+            const UINT64 extraSize   = (m_WorkGraphBackingMemorySize > memoryRequirements.MinSizeInBytes)
+                                           ? m_WorkGraphBackingMemorySize - memoryRequirements.MinSizeInBytes
+                                           : 0;
+
+            backingMemorySize = memoryRequirements.MinSizeInBytes + (extraSize + granularity - 1) / granularity * granularity;
+            backingMemorySize = std::min(backingMemorySize, memoryRequirements.MaxSizeInBytes);
+        }
+
+        Log::Write(LOGLEVEL_INFO,
+                   L"Work graph backing memory: %llu bytes (min %llu, max %llu)",
+                   backingMemorySize,
+                   memoryRequirements.MinSizeInBytes,
+                   memoryRequirements.MaxSizeInBytes);
+
         BufferDesc bufferDesc = BufferDesc::Data(L"MeshNodeSample_WorkGraphBackingMemory",
-                                                 static_cast<uint32_t>(memoryRequirements.MaxSizeInBytes),
+                                                 static_cast<uint32_t>(backingMemorySize),
                                                  1,
                                                  D3D12_WORK_GRAPHS_BACKING_MEMORY_ALIGNMENT_IN_BYTES,
                                                  ResourceFlags::AllowUnorderedAccess);
@@ -501,19 +1318,213 @@ void WorkGraphRenderModule::InitWorkGraphProgram()
         m_WorkGraphProgramDesc.WorkGraph.BackingMemory.SizeInBytes  = addressInfo.GetImpl()->SizeInBytes;
     }
 
-    // Query entry point index
-    m_WorkGraphEntryPointIndex = workGraphProperties->GetEntrypointIndex(workGraphIndex, {L"World", 0});
+    // Query entry point indices
+    m_WorkGraphEntryPointIndex      = workGraphProperties->GetEntrypointIndex(workGraphIndex, {L"World", 0});
+    m_WorkGraphChunkEntryPointIndex = workGraphProperties->GetEntrypointIndex(workGraphIndex, {L"Chunk", 0});
 
     // Release state object properties
     stateObjectProperties->Release();
     workGraphProperties->Release();
+}
 
-    // Release ID3D12Device9 (only releases additional reference created by QueryInterface)
-    d3dDevice->Release();
+bool WorkGraphRenderModule::LoadShaderFromArchive(ShaderCompileJob& shader) const
+{
+    if (!m_ShaderArchive.IsOpen())
+    {
+        return false;
+    }
+
+    StartupTimer timer("LoadShaderFromArchive " + ShaderArchiveToUtf8(GetShaderName(shader).c_str()));
+
+    const auto* entry = m_ShaderArchive.FindEntry(shader.ShaderFilePath, shader.Target, shader.EntryPoint, GetShaderVariantKey(shader.Defines).c_str());
+    if (entry == nullptr)
+    {
+        return false;
+    }
+
+    // Shader sources are not required if an archive is used. If they are present, make sure the archive is not outdated.
+    uint64_t                  sourceHash = 0;
+    std::vector<std::wstring> includes;
+    if (ComputeShaderSourceHash(L"shaders", shader.ShaderFilePath, shader.Target, shader.EntryPoint, sourceHash, &includes) &&
+        (sourceHash != entry->Hash))
+    {
+        CauldronWarning(L"Shader archive entry for %ls is outdated, compiling shader from source.", shader.ShaderFilePath);
+        return false;
+    }
+
+    shader.pBlob    = new ShaderArchiveBlob(m_ShaderArchive.GetBlob(*entry), static_cast<size_t>(entry->BlobSize));
+    shader.Includes = std::move(includes);
+
+    timer.SetDxilSize(entry->BlobSize);
+    timer.SetIncludeCount(static_cast<uint32_t>(shader.Includes.size()));
+
+    return true;
+}
+
+void WorkGraphRenderModule::UpdateShaderDependencies(const std::vector<ShaderCompileJob>& shaders)
+{
+    for (const auto& shader : shaders)
+    {
+        std::vector<std::wstring> files = shader.Includes;
+        files.push_back(shader.ShaderFilePath);
+
+        m_ShaderDependencyGraph.SetDependencies(GetShaderName(shader), files);
+    }
+}
+
+void WorkGraphRenderModule::UpdateShaderHotReload()
+{
+    // Release retired work graphs once the GPU can no longer use them
+    for (auto it = m_RetiredWorkGraphs.begin(); it != m_RetiredWorkGraphs.end();)
+    {
+        if (--it->FramesLeft == 0)
+        {
+            it->pStateObject->Release();
+            delete it->pBackingMemoryBuffer;
+
+            it = m_RetiredWorkGraphs.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    if (m_pShaderFileWatcher == nullptr)
+    {
+        return;
+    }
+
+    // Swap in work graph from finished background rebuild
+    if (m_WorkGraphRebuild.valid())
+    {
+        if (m_WorkGraphRebuild.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        {
+            return;
+        }
+
+        WorkGraphRebuild rebuild = m_WorkGraphRebuild.get();
+
+        // includes might have changed, even if the compilation failed
+        UpdateShaderDependencies(rebuild.Shaders);
+        m_pShaderFileWatcher->SetWatchedFiles(m_ShaderDependencyGraph.GetFiles());
+
+        if (rebuild.pStateObject)
+        {
+            RetiredWorkGraph retired     = {};
+            retired.pStateObject         = m_pWorkGraphStateObject;
+            retired.pBackingMemoryBuffer = m_pWorkGraphBackingMemoryBuffer;
+            retired.FramesLeft           = WorkGraphRetireFrameCount;
+            m_RetiredWorkGraphs.push_back(retired);
+
+            ReleaseShaderBlobs(m_WorkGraphShaders);
+            m_WorkGraphShaders = std::move(rebuild.Shaders);
+
+            ActivateWorkGraphStateObject(rebuild.pStateObject);
+
+            Log::Write(LOGLEVEL_INFO, L"Work graph reloaded in %.1f ms", rebuild.TimeMs);
+        }
+        else
+        {
+            for (const auto& shader : rebuild.Shaders)
+            {
+                if (!shader.Error.empty())
+                {
+                    CauldronWarning(L"%ls", shader.Error.c_str());
+                }
+            }
+            CauldronWarning(L"Work graph reload failed, keeping previous work graph.");
+
+            ReleaseShaderBlobs(rebuild.Shaders);
+        }
+    }
+
+    // Start background rebuild for all shaders affected by modified files
+    const auto changedFiles = m_pShaderFileWatcher->GetChangedFiles();
+    const auto dirtyShaders = m_ShaderDependencyGraph.GetDirtyShaders(changedFiles);
+
+    if (dirtyShaders.empty())
+    {
+        return;
+    }
+
+    Log::Write(LOGLEVEL_INFO, L"Reloading %u work graph shaders", static_cast<uint32_t>(dirtyShaders.size()));
+
+    // Copy shader list, unchanged shaders keep their blobs & only dirty shaders are recompiled
+    std::vector<ShaderCompileJob> shaders = m_WorkGraphShaders;
+    for (auto& shader : shaders)
+    {
+        if (std::find(dirtyShaders.begin(), dirtyShaders.end(), GetShaderName(shader)) != dirtyShaders.end())
+        {
+            shader.pBlob = nullptr;
+            shader.Includes.clear();
+            shader.Error.clear();
+        }
+        else
+        {
+            // rebuild holds its own reference to the blob
+            shader.pBlob->AddRef();
+        }
+    }
+
+    m_WorkGraphRebuild = std::async(std::launch::async, [this, shaders]() mutable {
+        const auto startTime = std::chrono::high_resolution_clock::now();
+
+        std::vector<ShaderCompileJob> dirtyShaderJobs;
+        for (const auto& shader : shaders)
+        {
+            if (shader.pBlob == nullptr)
+            {
+                dirtyShaderJobs.push_back(shader);
+            }
+        }
+
+        // compilation errors must not terminate the sample
+        CompileShadersParallel(dirtyShaderJobs, m_pShaderCache, false);
+
+        bool success = true;
+        for (auto& shader : shaders)
+        {
+            if (shader.pBlob == nullptr)
+            {
+                shader = dirtyShaderJobs.front();
+                dirtyShaderJobs.erase(dirtyShaderJobs.begin());
+
+                success &= (shader.pBlob != nullptr);
+            }
+        }
+
+        WorkGraphRebuild rebuild = {};
+        rebuild.pStateObject     = success ? CreateWorkGraphStateObject(shaders) : nullptr;
+        rebuild.Shaders          = std::move(shaders);
+        rebuild.TimeMs           = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+
+        return rebuild;
+    });
+}
+
+void WorkGraphRenderModule::ReleaseShaderBlobs(std::vector<ShaderCompileJob>& shaders)
+{
+    for (auto& shader : shaders)
+    {
+        if (shader.pBlob)
+        {
+            shader.pBlob->Release();
+            shader.pBlob = nullptr;
+        }
+    }
+}
+
+std::wstring WorkGraphRenderModule::GetShaderName(const ShaderCompileJob& shader)
+{
+    return std::wstring(shader.ShaderFilePath) + L":" + shader.Target + L":" + (shader.EntryPoint ? shader.EntryPoint : L"") + L":" +
+           GetShaderVariantKey(shader.Defines);
 }
 
-void WorkGraphRenderModule::InitShadingPipeline()
+std::future<void> WorkGraphRenderModule::InitShadingPipeline()
 {
+    StartupTimer timer("InitShadingPipeline");
+
     RootSignatureDesc shadingRootSigDesc;
     shadingRootSigDesc.AddConstantBufferView(0, ShaderBindStage::Compute, 1);
     shadingRootSigDesc.AddConstantBufferView(1, ShaderBindStage::Compute, 1);
@@ -522,12 +1533,6 @@ void WorkGraphRenderModule::InitShadingPipeline()
 
     m_pShadingRootSignature = RootSignature::CreateRootSignature(L"MeshNodeSample_ShadingRootSignature", shadingRootSigDesc);
 
-    PipelineDesc shadingPsoDesc;
-    shadingPsoDesc.SetRootSignature(m_pShadingRootSignature);
-    shadingPsoDesc.AddShaderDesc(ShaderBuildDesc::Compute(L"shading.hlsl", L"MainCS", ShaderModel::SM6_0));
-
-    m_pShadingPipeline = PipelineObject::CreatePipelineObject(L"MeshNodeSample_ShadingPipeline", shadingPsoDesc);
-
     m_pShadingParameterSet = ParameterSet::CreateParameterSet(m_pShadingRootSignature);
 
     m_pShadingParameterSet->SetRootConstantBufferResource(GetDynamicBufferPool()->GetResource(), sizeof(UpscalerInformation), 0);
@@ -535,4 +1540,15 @@ void WorkGraphRenderModule::InitShadingPipeline()
     m_pShadingParameterSet->SetTextureSRV(m_pGBufferColorOutput, ViewDimension::Texture2D, 0);
     m_pShadingParameterSet->SetTextureSRV(m_pGBufferNormalOutput, ViewDimension::Texture2D, 1);
     m_pShadingParameterSet->SetTextureUAV(m_pShadingOutput, ViewDimension::Texture2D, 0);
+
+    // Compiling the shading shader only depends on the root signature, thus it can run in parallel to the work graph creation
+    return std::async(std::launch::async, [this]() {
+        StartupTimer timer("CreateShadingPipeline");
+
+        PipelineDesc shadingPsoDesc;
+        shadingPsoDesc.SetRootSignature(m_pShadingRootSignature);
+        shadingPsoDesc.AddShaderDesc(ShaderBuildDesc::Compute(L"shading.hlsl", L"MainCS", ShaderModel::SM6_0));
+
+        m_pShadingPipeline = PipelineObject::CreatePipelineObject(L"MeshNodeSample_ShadingPipeline", shadingPsoDesc);
+    });
 }
@@ -27,6 +27,13 @@
 // d3dx12 for work graphs
 #include "d3dx12/d3dx12.h"
 
+#include "shaderarchive.h"
+#include "shadercompiler.h"
+#include "shaderdependencygraph.h"
+
+#include <chrono>
+#include <future>
+
 // Forward declaration of Cauldron classes
 namespace cauldron
 {
@@ -38,6 +45,22 @@ namespace cauldron
     class Texture;
 }  // namespace cauldron
 
+namespace meshnode
+{
+    class ChunkCuller;
+    class ChunkMetadataCache;
+    class GeometryBudgetGovernor;
+    class HorizonCuller;
+    class TerrainClipmap;
+    struct WorkGraphCBData;
+}  // namespace meshnode
+
+class FlythroughPlayer;
+class FrameTraceCapture;
+class GenerationCounterReadback;
+class ShaderCache;
+class ShaderFileWatcher;
+
 class WorkGraphRenderModule : public cauldron::RenderModule
 {
 public:
@@ -64,14 +87,136 @@ private:
      * @brief   Create and initialize textures required for rendering and shading.
      */
     void InitTextures();
+    /**
+     * @brief   Create the terrain clipmap & the buffer it is uploaded to. The buffer is created even if the clipmap is disabled.
+     */
+    void InitTerrainClipmap(const json& initData);
+    /**
+     * @brief   Move the terrain clipmap with the camera, upload the regenerated texels & set the clipmap constants.
+     */
+    void UpdateTerrainClipmap(cauldron::CommandList* pCmdList, const Vec4& cameraPosition, meshnode::WorkGraphCBData& workGraphData);
+    /**
+     * @brief   Create the CPU chunk culler & its metadata cache & horizon culler if enabled, see "ChunkCulling" in meshnodesampleconfig.json.
+     */
+    void InitChunkCulling(const json& initData);
+    /**
+     * @brief   Create the geometry budget governor, see "GeometryBudget" in meshnodesampleconfig.json.
+     */
+    void InitGeometryBudget(const json& initData);
+    /**
+     * @brief   Feed the latest work graph GPU time to the geometry budget governor & set the distance & density scales of the frame.
+     */
+    void UpdateGeometryBudget(meshnode::WorkGraphCBData& workGraphData);
+    /**
+     * @brief   Create the frame trace capture with the settings written with every trace, see "FrameTrace" in meshnodesampleconfig.json.
+     */
+    void InitFrameTrace(const json& initData);
     /**
      * @brief   Create and initialize the work graph program with mesh nodes.
      */
     void InitWorkGraphProgram();
+    /**
+     * @brief   Create work graph state object from compiled shaders. Returns nullptr on failure.
+     *          Only reads immutable state and can thus be called from a background thread.
+     */
+    ID3D12StateObject* CreateWorkGraphStateObject(const std::vector<ShaderCompileJob>& shaders) const;
+    /**
+     * @brief   Use state object for rendering. Creates the backing memory & program description.
+     *          Takes ownership of pStateObject.
+     */
+    void ActivateWorkGraphStateObject(ID3D12StateObject* pStateObject);
+
+    /**
+     * @brief   Take shader blob from shader archive without invoking DXC.
+     *          Returns false if the archive is not loaded, does not contain the shader or is outdated.
+     */
+    bool LoadShaderFromArchive(ShaderCompileJob& shader) const;
+
+    /**
+     * @brief   Set files each shader depends on in the dependency graph.
+     */
+    void UpdateShaderDependencies(const std::vector<ShaderCompileJob>& shaders);
+    /**
+     * @brief   Release retired work graphs, swap in finished rebuilds and start rebuilds for modified shaders.
+     *          Called once per frame before the work graph is dispatched.
+     */
+    void UpdateShaderHotReload();
+    static void         ReleaseShaderBlobs(std::vector<ShaderCompileJob>& shaders);
+    static std::wstring GetShaderName(const ShaderCompileJob& shader);
+
     /**
      * @brief   Create and initialize the shading compute pipeline.
+     *          The pipeline object is built asynchronously, the returned future completes once m_pShadingPipeline is created.
      */
-    void InitShadingPipeline();
+    std::future<void> InitShadingPipeline();
+
+    // Persistent DXIL cache, nullptr if disabled
+    ShaderCache* m_pShaderCache = nullptr;
+
+    // Defines of the selected quality tier, see "QualityTiers" in meshnodesampleconfig.json
+    std::vector<ShaderDefine> m_ShaderDefines;
+
+    // Memory-mapped precompiled shaders, blobs in m_WorkGraphShaders can point into this archive
+    ShaderArchive m_ShaderArchive;
+
+    // Compiled work graph shaders. Blobs are kept alive, such that hot-reload only needs to recompile modified shaders.
+    std::vector<ShaderCompileJob> m_WorkGraphShaders;
+
+    // Shader hot-reload, m_pShaderFileWatcher is nullptr if disabled
+    struct WorkGraphRebuild
+    {
+        std::vector<ShaderCompileJob> Shaders;
+        // nullptr if compilation or state object creation failed
+        ID3D12StateObject* pStateObject = nullptr;
+        double             TimeMs       = 0.0;
+    };
+
+    // Replaced work graphs are kept alive until the GPU is guaranteed to have finished all frames using them.
+    // Must be larger than the number of frames in flight.
+    static const uint32_t WorkGraphRetireFrameCount = 4;
+
+    struct RetiredWorkGraph
+    {
+        ID3D12StateObject* pStateObject         = nullptr;
+        cauldron::Buffer*  pBackingMemoryBuffer = nullptr;
+        uint32_t           FramesLeft           = 0;
+    };
+
+    ShaderDependencyGraph         m_ShaderDependencyGraph;
+    ShaderFileWatcher*            m_pShaderFileWatcher = nullptr;
+    std::future<WorkGraphRebuild> m_WorkGraphRebuild;
+    std::vector<RetiredWorkGraph> m_RetiredWorkGraphs;
+
+    // Camera-centred cache of terrain height, normal & biome weights, nullptr if disabled.
+    // Regenerated texels are copied to m_pTerrainClipmapBuffer through one upload slot per frame in flight.
+    meshnode::TerrainClipmap* m_pTerrainClipmap             = nullptr;
+    cauldron::Buffer*         m_pTerrainClipmapBuffer       = nullptr;
+    ID3D12Resource*           m_pTerrainClipmapUploadBuffer = nullptr;
+    uint8_t*                  m_pTerrainClipmapUploadData   = nullptr;
+    uint32_t                  m_TerrainClipmapUploadSlot    = 0;
+
+    // Flythrough recording & playback, see "Flythrough" in meshnodesampleconfig.json. nullptr if disabled or the flythrough failed to load.
+    FlythroughPlayer* m_pFlythroughPlayer = nullptr;
+
+    // Frustum culling & level of detail selection of the chunk grid on the CPU, nullptr if disabled.
+    // If enabled, the work graph is launched at the Chunk node with one record per visible chunk instead of at the World node.
+    meshnode::ChunkCuller* m_pChunkCuller = nullptr;
+    // Levels of detail & tile biomes of the chunks, kept across frames. nullptr if disabled.
+    meshnode::ChunkMetadataCache* m_pChunkMetadataCache = nullptr;
+    // Removes chunks & tiles hidden behind the terrain from the chunk records, requires the metadata cache. nullptr if disabled.
+    meshnode::HorizonCuller* m_pHorizonCuller = nullptr;
+
+    // Scales the ground cover & decoration distances of the quality tier to hold a work graph GPU time budget.
+    // The governor is fed with the "Work Graph" marker time, which the profiler reports a few frames late.
+    meshnode::GeometryBudgetGovernor* m_pGeometryBudgetGovernor = nullptr;
+    // latest "Work Graph" marker time, 0 until the profiler reports it
+    double m_WorkGraphGpuTimeMs = 0.0;
+
+    // Work counted by the work graph nodes, read back with one slot per frame in flight, see shaders/generationcounters.h
+    GenerationCounterReadback* m_pGenerationCounters = nullptr;
+
+    // Frame trace capture, see meshNodeCpu/frametrace.h
+    FrameTraceCapture* m_pFrameTraceCapture = nullptr;
 
     // time variable for shader animations in milliseconds
     uint32_t m_shaderTime = 0;
@@ -79,6 +224,8 @@ private:
     // UI controlled settings
     float m_WindStrength  = 1.f;
     float m_WindDirection = 0.f;
+    bool  m_GeometryBudgetEnabled  = false;
+    float m_GeometryBudgetTargetMs = 10.f;
 
     const cauldron::Texture*                   m_pGBufferDepthOutput     = nullptr;
     const cauldron::RasterView*                m_pGBufferDepthRasterView = nullptr;
@@ -91,11 +238,15 @@ private:
     cauldron::ParameterSet*  m_pWorkGraphParameterSet        = nullptr;
     ID3D12StateObject*       m_pWorkGraphStateObject         = nullptr;
     cauldron::Buffer*        m_pWorkGraphBackingMemoryBuffer = nullptr;
+    // requested backing memory size, clamped to the memory requirements of the work graph.
+    // 0 = MaxSizeInBytes, capped to the MaxSizeInBytes of the World entry if the graph is launched per chunk
+    uint64_t m_WorkGraphBackingMemorySize = 0;
     // Program description for binding the work graph
     // contains work graph identifier & backing memory
     D3D12_SET_PROGRAM_DESC m_WorkGraphProgramDesc = {};
-    // Index of entry point node
-    UINT m_WorkGraphEntryPointIndex = 0;
+    // Index of entry point nodes
+    UINT m_WorkGraphEntryPointIndex      = 0;
+    UINT m_WorkGraphChunkEntryPointIndex = 0;
 
     const cauldron::Texture*  m_pShadingOutput        = nullptr;
     cauldron::RootSignature*  m_pShadingRootSignature = nullptr;
@@ -0,0 +1,69 @@
+// This file is part of the AMD Work Graph Mesh Node Sample.
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#pragma once
+
+#include <cstdint>
+
+/**
+ * Shader libraries & pixel shaders that make up the work graph.
+ * Shared between the sample and the offline shader archive tool.
+ */
+struct WorkGraphShaderDesc
+{
+    const wchar_t* ShaderFilePath;
+    const wchar_t* Target;
+    // nullptr for shader libraries
+    const wchar_t* EntryPoint;
+};
+
+// Pixel shaders need to be compiled with "ps" target and as such the DXIL library object needs to specify a name
+// for the pixel shader (exportName) with which the generic program can reference the pixel shader
+static const WorkGraphShaderDesc WorkGraphShaders[] = {
+    // Shader libraries for procedural world generation
+    {L"world.hlsl", L"lib_6_9", nullptr},
+    {L"biomes.hlsl", L"lib_6_9", nullptr},
+    {L"tree.hlsl", L"lib_6_9", nullptr},
+    {L"rock.hlsl", L"lib_6_9", nullptr},
+
+    // Terrain Mesh Node
+    {L"terrainrenderer.hlsl", L"lib_6_9", nullptr},
+    {L"terrainrenderer.hlsl", L"ps_6_9", L"TerrainPixelShader"},
+
+    // Spline Mesh Node for trees & rocks
+    {L"splinerenderer.hlsl", L"lib_6_9", nullptr},
+    {L"splinerenderer.hlsl", L"ps_6_9", L"SplinePixelShader"},
+
+    // Grass Nodes
+    {L"densegrassmeshshader.hlsl", L"lib_6_9", nullptr},
+    {L"sparsegrassmeshshader.hlsl", L"lib_6_9", nullptr},
+    {L"grasspixelshader.hlsl", L"ps_6_9", L"GrassPixelShader"},
+
+    // Flowers, Insects & Mushroom Nodes
+    {L"beemeshshader.hlsl", L"lib_6_9", nullptr},
+    {L"butterflymeshshader.hlsl", L"lib_6_9", nullptr},
+    {L"flowermeshshader.hlsl", L"lib_6_9", nullptr},
+    {L"mushroommeshshader.hlsl", L"lib_6_9", nullptr},
+    {L"insectpixelshader.hlsl", L"ps_6_9", L"InsectPixelShader"},
+};
+
+static const uint32_t WorkGraphShaderCount = sizeof(WorkGraphShaders) / sizeof(WorkGraphShaders[0]);
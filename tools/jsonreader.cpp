@@ -0,0 +1,235 @@
+// This file is part of the AMD Work Graph Mesh Node Sample.
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "jsonreader.h"
+
+#include <cctype>
+#include <cstdlib>
+
+class JsonReader
+{
+public:
+    explicit JsonReader(const std::string& text)
+        : m_Text(text)
+    {
+    }
+
+    bool Parse(JsonNode& node, std::string& errorString)
+    {
+        if (!ParseValue(node) || (SkipWhitespace(), m_Position != m_Text.size()))
+        {
+            errorString = "Invalid JSON at offset " + std::to_string(m_Position);
+            return false;
+        }
+
+        return true;
+    }
+
+private:
+    void SkipWhitespace()
+    {
+        while ((m_Position < m_Text.size()) && std::isspace(static_cast<unsigned char>(m_Text[m_Position])))
+        {
+            ++m_Position;
+        }
+    }
+
+    bool Consume(char c)
+    {
+        SkipWhitespace();
+        if ((m_Position < m_Text.size()) && (m_Text[m_Position] == c))
+        {
+            ++m_Position;
+            return true;
+        }
+
+        return false;
+    }
+
+    bool ParseString(std::string& string)
+    {
+        if (!Consume('"'))
+        {
+            return false;
+        }
+
+        while (m_Position < m_Text.size())
+        {
+            const char c = m_Text[m_Position++];
+            if (c == '"')
+            {
+                return true;
+            }
+
+            if (c == '\\')
+            {
+                if (m_Position == m_Text.size())
+                {
+                    return false;
+                }
+
+                // \uXXXX escapes are not used in config files and kept as-is
+                const char escaped = m_Text[m_Position++];
+                switch (escaped)
+                {
+                case 'n':
+                    string += '\n';
+                    break;
+                case 't':
+                    string += '\t';
+                    break;
+                case 'r':
+                    string += '\r';
+                    break;
+                case 'u':
+                    string += "\\u";
+                    break;
+                default:
+                    string += escaped;
+                    break;
+                }
+            }
+            else
+            {
+                string += c;
+            }
+        }
+
+        return false;
+    }
+
+    bool ParseValue(JsonNode& node)
+    {
+        SkipWhitespace();
+        if (m_Position == m_Text.size())
+        {
+            return false;
+        }
+
+        const char c = m_Text[m_Position];
+        if (c == '"')
+        {
+            node.NodeType = JsonNode::Type::String;
+            return ParseString(node.Value);
+        }
+
+        if ((c == '{') || (c == '['))
+        {
+            const bool isObject = (c == '{');
+            const char end      = isObject ? '}' : ']';
+
+            node.NodeType = isObject ? JsonNode::Type::Object : JsonNode::Type::Array;
+            ++m_Position;
+
+            if (Consume(end))
+            {
+                return true;
+            }
+
+            do
+            {
+                std::pair<std::string, JsonNode> child;
+                if (isObject && (!ParseString(child.first) || !Consume(':')))
+                {
+                    return false;
+                }
+                if (!ParseValue(child.second))
+                {
+                    return false;
+                }
+
+                node.Children.push_back(std::move(child));
+            } while (Consume(','));
+
+            return Consume(end);
+        }
+
+        // number, true, false or null
+        const size_t begin = m_Position;
+        while ((m_Position < m_Text.size()) && (std::isalnum(static_cast<unsigned char>(m_Text[m_Position])) || (m_Text[m_Position] == '-') ||
+                                                (m_Text[m_Position] == '+') || (m_Text[m_Position] == '.')))
+        {
+            ++m_Position;
+        }
+
+        node.NodeType = JsonNode::Type::Literal;
+        node.Value    = m_Text.substr(begin, m_Position - begin);
+
+        return m_Position != begin;
+    }
+
+    const std::string& m_Text;
+    size_t             m_Position = 0;
+};
+
+bool ParseJson(const std::string& text, JsonNode& document, std::string& errorString)
+{
+    return JsonReader(text).Parse(document, errorString);
+}
+
+const JsonNode* FindJsonMember(const JsonNode& node, const std::string& key)
+{
+    for (const auto& child : node.Children)
+    {
+        if ((node.NodeType == JsonNode::Type::Object) && (child.first == key))
+        {
+            return &child.second;
+        }
+
+        if (const JsonNode* found = FindJsonMember(child.second, key))
+        {
+            return found;
+        }
+    }
+
+    return nullptr;
+}
+
+const JsonNode* GetJsonMember(const JsonNode& node, const std::string& key)
+{
+    if (node.NodeType != JsonNode::Type::Object)
+    {
+        return nullptr;
+    }
+
+    for (const auto& child : node.Children)
+    {
+        if (child.first == key)
+        {
+            return &child.second;
+        }
+    }
+
+    return nullptr;
+}
+
+double GetJsonNumber(const JsonNode* node, double defaultValue)
+{
+    if ((node == nullptr) || (node->NodeType != JsonNode::Type::Literal))
+    {
+        return defaultValue;
+    }
+
+    char*        end   = nullptr;
+    const double value = std::strtod(node->Value.c_str(), &end);
+
+    return ((end != node->Value.c_str()) && (*end == '\0')) ? value : defaultValue;
+}
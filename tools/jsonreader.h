@@ -0,0 +1,64 @@
+// This file is part of the AMD Work Graph Mesh Node Sample.
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+// Minimal JSON document tree. Numbers, booleans & null are kept as their literal text.
+struct JsonNode
+{
+    enum class Type
+    {
+        Literal,
+        String,
+        Array,
+        Object
+    };
+
+    Type        NodeType = Type::Literal;
+    std::string Value;
+    // array elements have empty keys
+    std::vector<std::pair<std::string, JsonNode>> Children;
+};
+
+/**
+ * @brief   Parse a JSON document. Only the subset of JSON used by config files is supported.
+ *          Returns false and a description in errorString if the text could not be parsed.
+ */
+bool ParseJson(const std::string& text, JsonNode& document, std::string& errorString);
+
+/**
+ * @brief   Search an object member with the given key in node and all its descendants, depth-first. Returns nullptr if not found.
+ */
+const JsonNode* FindJsonMember(const JsonNode& node, const std::string& key);
+
+/**
+ * @brief   Direct member of an object node, nullptr if node is not an object or has no such member.
+ */
+const JsonNode* GetJsonMember(const JsonNode& node, const std::string& key);
+
+/**
+ * @brief   Value of a number literal, defaultValue if node is nullptr or not a number.
+ */
+double GetJsonNumber(const JsonNode* node, double defaultValue);
@@ -0,0 +1,4460 @@
+// This file is part of the AMD Work Graph Mesh Node Sample.
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+
+// Tool for validating & benchmarking the CPU mirror of the procedural generation shaders.
+//
+// Usage:
+//   MeshNodeCpuTool parity [points]
+//   MeshNodeCpuTool bench [points] [threads]
+//   MeshNodeCpuTool clipmap [frames] [speed] [texel budget]
+//   MeshNodeCpuTool gradient [points]
+//   MeshNodeCpuTool samples [points]
+//   MeshNodeCpuTool graph [threads] [frames] [record stream file]
+//   MeshNodeCpuTool limits [poses] [threads] [quality tier]
+//   MeshNodeCpuTool flythrough <flythrough file | path.json> [stats.csv | stats.json] [threads] [max frames]
+//   MeshNodeCpuTool chunks [poses] [repetitions] [verified poses] [quality tier]
+//   MeshNodeCpuTool chunkcache [frames] [speed] [verified frames] [cache capacity]
+//   MeshNodeCpuTool horizon [flythrough file | path.json | flight] [frames] [verified frames]
+//   MeshNodeCpuTool bounds [flythrough file | path.json | flight] [frames] [verified frames]
+//   MeshNodeCpuTool records [values] [poses] [threads]
+//   MeshNodeCpuTool layout [report file]
+//   MeshNodeCpuTool splines [poses] [threads]
+//   MeshNodeCpuTool budget [target ms] [poses] [threads]
+//   MeshNodeCpuTool counters [poses] [threads]
+//   MeshNodeCpuTool trace <flythrough file | path.json> <trace.json> [threads] [max frames] [buffer bytes]
+//   MeshNodeCpuTool dependencies [shaders folder]
+//
+// "parity" compares all SIMD batch kernels against the scalar reference and fails on any bit difference.
+// "bench" reports the throughput of every batch kernel in points per second per core.
+// "clipmap" flies a camera over the terrain & reports the texels regenerated per frame by the terrain clipmap
+// and the error of the clipmap against the analytic terrain functions.
+// "gradient" validates the analytic terrain gradient against central differences and compares the noise evaluations
+// & run time of the analytic normal to the finite difference normal it replaced.
+// "samples" validates the fused GetTerrainSample against the separate terrain functions and reports the noise evaluations
+// of the terrain queries made by each work graph node, before & after moving the nodes to GetTerrainSample.
+// "graph" executes the world generation work graph on the CPU for the default sample camera, reports the records & thread groups
+// of every node and checks that the record stream does not depend on the number of worker threads.
+// The record stream can be written to a file, e.g. for comparing two builds: "MNRS", version & node count (uint32 each), followed by
+// the node id length (uint32), node id, record size (uint32), record count (uint64) & records of every node.
+// "limits" executes the work graph for camera poses spread over the world & reports percentiles & worst cases of the records sent
+// to every mesh node against its NodeMaxInputRecordsPerGraphEntryRecord limit. Limits that are exceeded or heavily over-provisioned
+// are flagged. The backing memory recommendation is derived from the worst case record bytes of a frame, quality tiers as in the sample config.
+// "flythrough" plays back a flythrough recorded by the sample or a JSON key frame path headless and writes per-frame statistics
+// (emulator frame time, per-node times, record counts & a hash of all records) as CSV or JSON, e.g. for comparing builds on identical frames.
+// "chunks" benchmarks the CPU chunk culling, which launches the work graph at the Chunk node with the visible chunks, per instruction set
+// against the number of chunks culled per frame. It fails if the instruction sets produce different chunks or if the Chunk entry
+// generates different records than the World entry for the first verified poses.
+// "chunkcache" flies a camera over the terrain & compares the chunk culling with ChunkMetadataCache against sampling the terrain every frame.
+// "horizon" reports the chunks & tiles inside the view frustum removed by the horizon culling along a flythrough or the flight path
+// of "chunkcache". On the verified frames, every hidden tile is checked against segments marched from the camera through the analytic terrain,
+// and the mesh records generated by the emulator are compared with & without horizon culling. It fails if a hidden tile is visible.
+// "bounds" reports the chunks, tiles & detailed tiles inside the view frustum with the fixed -100 to 300 m height range that are culled
+// with their terrain height bounds, along a flythrough or the flight path. On the verified frames, every culled tile is checked against
+// a grid of terrain samples, the terrain of the detailed tiles against their height range around the center height, and the mesh records
+// generated by the emulator are compared. It fails if a culled tile is visible or the terrain exceeds a detailed tile height range.
+// "records" compares the mesh record sizes before & after the quantized encodings of shaders/recordencoding.h, tests the round-trip
+// error of every encoding against its bound and reports the record bytes per frame & the largest encoded positions for camera poses
+// spread over the world. It fails if an encoding exceeds its error bound or an encoded position saturates.
+// "layout" reports the size, alignment & padding of every record in shaders/workgraphrecords.h, the worst-case output bytes
+// per producer thread group from the [MaxRecords] declarations and the mesh node input bytes per graph entry record.
+// "splines" tessellates every spline generated for camera poses spread over the world with a CPU port of the spline mesh node, once with
+// splines exceeding the mesh output limits written as a single piece (before splitting) and once split into pieces, and reports the clamped
+// splines & the vertices and triangles they lose. It fails if a split piece is clamped, the overlapping ring of two pieces differs,
+// splitting changes the generated triangles, or the ring prefix sums of the records produce different vertices or triangles than the ring loop.
+// "counters" executes the work graph for camera poses spread over the world with the mesh output counts of the mesh shaders and reports
+// the generation counters of every node as read back by the sample, see shaders/generationcounters.h: records, thread groups, vertices,
+// primitives & the occupancy of the record arrays. It fails if counting changes the records or the counters are inconsistent.
+// "trace" plays back a flythrough headless like "flythrough" and writes the frames, the emulator & node times as a Chrome trace
+// (chrome://tracing, ui.perfetto.dev) with the frame trace writer of the sample, see meshNodeCpu/frametrace.h. It reports the trace size
+// & the time spent writing and fails if the written trace cannot be parsed or does not contain every frame & event.
+// "dependencies" checks the ShaderDependencyGraph used by the shader hot-reload of the sample: setting, replacing & removing dependencies
+// and the shaders dirtied by shared & leaf files, on a synthetic graph and on the work graph shaders with the includes of their source files.
+// It fails if a changed file dirties other shaders than the ones depending on it.
+
+#include "chunkculling.h"
+#include "chunkmetadata.h"
+#include "flythrough.h"
+#include "frametrace.h"
+#include "geometrybudget.h"
+#include "horizonculling.h"
+#include "jsonreader.h"
+#include "shaderdependencygraph.h"
+#include "splinemesh.h"
+#include "terrain.h"
+#include "terrainclipmap.h"
+#include "workgraphshaders.h"
+#include "worldgraph.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cwchar>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace meshnode;
+
+static const TerrainKernelIsa BatchIsas[] = {TerrainKernelIsa::Generic, TerrainKernelIsa::Avx2, TerrainKernelIsa::Avx512};
+
+static int PrintUsage()
+{
+    printf("Usage:\n");
+    printf("  MeshNodeCpuTool parity [points]\n");
+    printf("  MeshNodeCpuTool bench [points] [threads]\n");
+    printf("  MeshNodeCpuTool clipmap [frames] [speed] [texel budget]\n");
+    printf("  MeshNodeCpuTool gradient [points]\n");
+    printf("  MeshNodeCpuTool samples [points]\n");
+    printf("  MeshNodeCpuTool graph [threads] [frames] [record stream file]\n");
+    printf("  MeshNodeCpuTool limits [poses] [threads] [quality tier]\n");
+    printf("  MeshNodeCpuTool flythrough <flythrough file | path.json> [stats.csv | stats.json] [threads] [max frames]\n");
+    printf("  MeshNodeCpuTool chunks [poses] [repetitions] [verified poses] [quality tier]\n");
+    printf("  MeshNodeCpuTool chunkcache [frames] [speed] [verified frames] [cache capacity]\n");
+    printf("  MeshNodeCpuTool horizon [flythrough file | path.json | flight] [frames] [verified frames]\n");
+    printf("  MeshNodeCpuTool bounds [flythrough file | path.json | flight] [frames] [verified frames]\n");
+    printf("  MeshNodeCpuTool records [values] [poses] [threads]\n");
+    printf("  MeshNodeCpuTool layout [report file]\n");
+    printf("  MeshNodeCpuTool splines [poses] [threads]\n");
+    printf("  MeshNodeCpuTool budget [target ms] [poses] [threads]\n");
+    printf("  MeshNodeCpuTool counters [poses] [threads]\n");
+    printf("  MeshNodeCpuTool trace <flythrough file | path.json> <trace.json> [threads] [max frames] [buffer bytes]\n");
+    printf("  MeshNodeCpuTool dependencies [shaders folder]\n");
+
+    return 1;
+}
+
+// World-space test positions. Covers the playable area, far away positions & grid cell boundaries, where rounding issues show up first.
+static void GenerateTestPositions(size_t count, std::vector<float>& x, std::vector<float>& z)
+{
+    std::mt19937                          generator(12345);
+    std::uniform_real_distribution<float> near(-5000.f, 5000.f);
+    std::uniform_real_distribution<float> far(-100000.f, 100000.f);
+    std::uniform_int_distribution<int>    grid(-2000, 2000);
+
+    x.resize(count);
+    z.resize(count);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        switch (i % 4)
+        {
+        case 0:
+        case 1:
+            x[i] = near(generator);
+            z[i] = near(generator);
+            break;
+        case 2:
+            x[i] = far(generator);
+            z[i] = far(generator);
+            break;
+        default:
+            // exact noise lattice positions of the lowest-frequency noise layers
+            x[i] = grid(generator) * 100.f;
+            z[i] = grid(generator) * 400.f;
+            break;
+        }
+    }
+}
+
+struct ParityResult
+{
+    size_t MismatchCount = 0;
+    float  MaxDifference = 0.f;
+};
+
+static void Compare(const std::vector<float>& reference, const std::vector<float>& values, ParityResult& result)
+{
+    for (size_t i = 0; i < reference.size(); ++i)
+    {
+        if (std::memcmp(&reference[i], &values[i], sizeof(float)) != 0)
+        {
+            ++result.MismatchCount;
+            result.MaxDifference = std::max(result.MaxDifference, std::abs(reference[i] - values[i]));
+        }
+    }
+}
+
+static void PrintParity(const char* function, TerrainKernelIsa isa, const ParityResult& result)
+{
+    printf("%-18s %-8s %10zu mismatches, max difference %g\n", function, GetTerrainKernelIsaName(isa), result.MismatchCount, result.MaxDifference);
+}
+
+static int Parity(size_t count)
+{
+    std::vector<float> x, z;
+    GenerateTestPositions(count, x, z);
+
+    // noise is tested at noise-space positions, as used by the terrain functions
+    std::vector<float> noiseX(count), noiseY(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        noiseX[i] = x[i] * 0.01f;
+        noiseY[i] = z[i] * 0.01f;
+    }
+
+    std::vector<float> referenceNoise(count), referenceMountain(count), referenceWoodland(count), referenceGrassland(count), referenceHeight(count);
+    std::vector<float> referenceNormalX(count), referenceNormalY(count), referenceNormalZ(count);
+    std::vector<float> referenceGradientHeight(count), referenceGradientX(count), referenceGradientZ(count);
+
+    PerlinNoise2DBatch(noiseX.data(), noiseY.data(), referenceNoise.data(), count, TerrainKernelIsa::Scalar);
+    GetBiomeWeightsBatch(x.data(), z.data(), referenceMountain.data(), referenceWoodland.data(), referenceGrassland.data(), count, TerrainKernelIsa::Scalar);
+    GetTerrainHeightBatch(x.data(), z.data(), referenceHeight.data(), count, TerrainKernelIsa::Scalar);
+    GetTerrainHeightAndGradientBatch(
+        x.data(), z.data(), referenceGradientHeight.data(), referenceGradientX.data(), referenceGradientZ.data(), count, TerrainKernelIsa::Scalar);
+    GetTerrainNormalBatch(x.data(), z.data(), referenceNormalX.data(), referenceNormalY.data(), referenceNormalZ.data(), count, TerrainKernelIsa::Scalar);
+
+    bool success = true;
+
+    for (const auto isa : BatchIsas)
+    {
+        if (!IsTerrainKernelIsaSupported(isa))
+        {
+            printf("%-18s %-8s not supported\n", "", GetTerrainKernelIsaName(isa));
+            continue;
+        }
+
+        std::vector<float> a(count), b(count), c(count);
+
+        ParityResult noise;
+        PerlinNoise2DBatch(noiseX.data(), noiseY.data(), a.data(), count, isa);
+        Compare(referenceNoise, a, noise);
+        PrintParity("PerlinNoise2D", isa, noise);
+
+        ParityResult biomes;
+        GetBiomeWeightsBatch(x.data(), z.data(), a.data(), b.data(), c.data(), count, isa);
+        Compare(referenceMountain, a, biomes);
+        Compare(referenceWoodland, b, biomes);
+        Compare(referenceGrassland, c, biomes);
+        PrintParity("GetBiomeWeights", isa, biomes);
+
+        ParityResult height;
+        GetTerrainHeightBatch(x.data(), z.data(), a.data(), count, isa);
+        Compare(referenceHeight, a, height);
+        PrintParity("GetTerrainHeight", isa, height);
+
+        ParityResult gradient;
+        GetTerrainHeightAndGradientBatch(x.data(), z.data(), a.data(), b.data(), c.data(), count, isa);
+        Compare(referenceGradientHeight, a, gradient);
+        Compare(referenceGradientX, b, gradient);
+        Compare(referenceGradientZ, c, gradient);
+        PrintParity("HeightAndGradient", isa, gradient);
+
+        ParityResult normal;
+        GetTerrainNormalBatch(x.data(), z.data(), a.data(), b.data(), c.data(), count, isa);
+        Compare(referenceNormalX, a, normal);
+        Compare(referenceNormalY, b, normal);
+        Compare(referenceNormalZ, c, normal);
+        PrintParity("GetTerrainNormal", isa, normal);
+
+        success &= (noise.MismatchCount == 0) && (biomes.MismatchCount == 0) && (height.MismatchCount == 0) && (gradient.MismatchCount == 0) &&
+                   (normal.MismatchCount == 0);
+    }
+
+    printf("%s\n", success ? "All kernels match the scalar reference." : "Kernel mismatch.");
+
+    return success ? 0 : 1;
+}
+
+// Runs kernel on threadCount threads, each processing its own slice of the positions. Returns points per second per thread.
+static double Measure(size_t count, uint32_t threadCount, const std::function<void(size_t, size_t)>& kernel)
+{
+    const size_t sliceSize = (count + threadCount - 1) / threadCount;
+
+    // repeat until the measurement is long enough to be stable
+    uint32_t iterationCount = 0;
+    double   elapsedSeconds = 0.0;
+
+    const auto startTime = std::chrono::high_resolution_clock::now();
+    while (elapsedSeconds < 0.5)
+    {
+        std::vector<std::thread> threads;
+        for (uint32_t t = 0; t < threadCount; ++t)
+        {
+            const size_t begin = std::min(count, t * sliceSize);
+            const size_t end   = std::min(count, begin + sliceSize);
+
+            threads.emplace_back([&kernel, begin, end]() { kernel(begin, end - begin); });
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+
+        ++iterationCount;
+        elapsedSeconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - startTime).count();
+    }
+
+    return (static_cast<double>(count) * iterationCount) / elapsedSeconds / threadCount;
+}
+
+static int Bench(size_t count, uint32_t threadCount)
+{
+    std::vector<float> x, z;
+    GenerateTestPositions(count, x, z);
+
+    std::vector<float> a(count), b(count), c(count);
+
+    printf("Points: %zu, threads: %u\n\n", count, threadCount);
+    printf("%-8s %18s %18s %18s %18s %18s\n", "ISA", "PerlinNoise2D", "GetBiomeWeights", "GetTerrainHeight", "HeightAndGradient", "GetTerrainNormal");
+    printf("%-8s %18s %18s %18s %18s %18s\n", "", "[points/s/core]", "[points/s/core]", "[points/s/core]", "[points/s/core]", "[points/s/core]");
+
+    const TerrainKernelIsa isas[] = {TerrainKernelIsa::Scalar, TerrainKernelIsa::Generic, TerrainKernelIsa::Avx2, TerrainKernelIsa::Avx512};
+
+    for (const auto isa : isas)
+    {
+        if (!IsTerrainKernelIsaSupported(isa))
+        {
+            printf("%-8s %18s\n", GetTerrainKernelIsaName(isa), "not supported");
+            continue;
+        }
+
+        const double noise = Measure(count, threadCount, [&](size_t begin, size_t n) {
+            PerlinNoise2DBatch(x.data() + begin, z.data() + begin, a.data() + begin, n, isa);
+        });
+        const double biomes = Measure(count, threadCount, [&](size_t begin, size_t n) {
+            GetBiomeWeightsBatch(x.data() + begin, z.data() + begin, a.data() + begin, b.data() + begin, c.data() + begin, n, isa);
+        });
+        const double height = Measure(count, threadCount, [&](size_t begin, size_t n) {
+            GetTerrainHeightBatch(x.data() + begin, z.data() + begin, a.data() + begin, n, isa);
+        });
+        const double gradient = Measure(count, threadCount, [&](size_t begin, size_t n) {
+            GetTerrainHeightAndGradientBatch(x.data() + begin, z.data() + begin, a.data() + begin, b.data() + begin, c.data() + begin, n, isa);
+        });
+        const double normal = Measure(count, threadCount, [&](size_t begin, size_t n) {
+            GetTerrainNormalBatch(x.data() + begin, z.data() + begin, a.data() + begin, b.data() + begin, c.data() + begin, n, isa);
+        });
+
+        printf("%-8s %18.3e %18.3e %18.3e %18.3e %18.3e\n", GetTerrainKernelIsaName(isa), noise, biomes, height, gradient, normal);
+    }
+
+    return 0;
+}
+
+// Camera path for the clipmap simulation, a wide curve across all biomes
+static float2 GetFlightPosition(float time, float speed)
+{
+    return float2(speed * time, 0.5f * speed * time + 400.f * std::sin(time * 0.05f));
+}
+
+static int Clipmap(uint32_t frameCount, float speed, uint32_t texelBudget)
+{
+    static const float FrameTime = 1.f / 60.f;
+
+    TerrainClipmapDesc desc = {};
+    desc.TexelBudget        = texelBudget;
+
+    TerrainClipmap clipmap(desc);
+
+    printf("Levels: %u, resolution: %u, texel size: %g, texel budget: %u, camera speed: %g m/s\n\n",
+           desc.LevelCount,
+           desc.Resolution,
+           desc.TexelSize,
+           desc.TexelBudget,
+           speed);
+
+    printf("%-13s %16s %16s %16s %10s %10s %8s\n", "Frames", "Avg. texels", "Max. texels", "Avg. uploaded", "Avg. [ms]", "Max. [ms]", "Pending");
+
+    // per second statistics
+    const uint32_t reportInterval = 60;
+
+    uint64_t totalTexelCount = 0;
+    uint64_t texelCount = 0, maxTexelCount = 0, uploadCount = 0;
+    double   timeMs = 0.0, maxTimeMs = 0.0;
+
+    for (uint32_t frame = 0; frame < frameCount; ++frame)
+    {
+        const float2 camera = GetFlightPosition(frame * FrameTime, speed);
+        const auto&  stats  = clipmap.Update(camera.x, camera.y);
+
+        totalTexelCount += stats.RegeneratedTexelCount;
+        texelCount += stats.RegeneratedTexelCount;
+        maxTexelCount = std::max(maxTexelCount, stats.RegeneratedTexelCount);
+        uploadCount += stats.UploadTexelCount;
+        timeMs += stats.BakeTimeMs;
+        maxTimeMs = std::max(maxTimeMs, stats.BakeTimeMs);
+
+        if ((((frame + 1) % reportInterval) == 0) || ((frame + 1) == frameCount))
+        {
+            const uint32_t intervalFrameCount = (frame % reportInterval) + 1;
+            const uint32_t firstFrame         = frame + 1 - intervalFrameCount;
+
+            char frames[32];
+            snprintf(frames, sizeof(frames), "%u-%u", firstFrame, frame);
+
+            printf("%-13s %16.0f %16llu %16.0f %10.3f %10.3f %8u\n",
+                   frames,
+                   static_cast<double>(texelCount) / intervalFrameCount,
+                   static_cast<unsigned long long>(maxTexelCount),
+                   static_cast<double>(uploadCount) / intervalFrameCount,
+                   timeMs / intervalFrameCount,
+                   maxTimeMs,
+                   stats.PendingLevelCount);
+
+            texelCount = maxTexelCount = uploadCount = 0;
+            timeMs = maxTimeMs = 0.0;
+        }
+    }
+
+    printf("\nRegenerated %llu texels in %u frames (%.0f per frame)\n\n",
+           static_cast<unsigned long long>(totalTexelCount),
+           frameCount,
+           static_cast<double>(totalTexelCount) / std::max(frameCount, 1u));
+
+    // Error against the analytic terrain functions around the final camera position
+    const float2 camera = GetFlightPosition((frameCount - 1) * FrameTime, speed);
+
+    struct DistanceBand
+    {
+        float MinDistance;
+        float MaxDistance;
+    };
+    const DistanceBand bands[] = {{0.f, 100.f}, {100.f, 250.f}, {250.f, 1000.f}, {1000.f, 2000.f}, {2000.f, 4000.f}};
+
+    printf("%-13s %14s %14s %16s %16s %14s\n", "Distance [m]", "Max. height", "RMS height", "Max. normal [°]", "RMS normal [°]", "Max. biome");
+
+    std::mt19937                          generator(54321);
+    std::uniform_real_distribution<float> uniform(0.f, 1.f);
+
+    for (const auto& band : bands)
+    {
+        const uint32_t sampleCount = 2000;
+
+        double maxHeightError = 0.0, squaredHeightError = 0.0, maxNormalError = 0.0, squaredNormalError = 0.0, maxBiomeError = 0.0;
+
+        for (uint32_t i = 0; i < sampleCount; ++i)
+        {
+            const float  angle    = uniform(generator) * 6.2831853f;
+            const float  distance = band.MinDistance + uniform(generator) * (band.MaxDistance - band.MinDistance);
+            const float2 position = camera + distance * float2(std::cos(angle), std::sin(angle));
+
+            const double heightError = std::abs(clipmap.GetHeight(position) - GetTerrainHeight(position));
+            maxHeightError           = std::max(maxHeightError, heightError);
+            squaredHeightError += heightError * heightError;
+
+            const float  cosAngle    = std::min(dot(clipmap.GetNormal(position), GetTerrainNormal(position)), 1.f);
+            const double normalError = std::acos(cosAngle) * 57.29578;
+            maxNormalError           = std::max(maxNormalError, normalError);
+            squaredNormalError += normalError * normalError;
+
+            const float3 biomeWeights         = clipmap.GetBiomeWeights(position);
+            const float3 analyticBiomeWeights = GetBiomeWeights(position);
+            maxBiomeError                     = std::max({maxBiomeError,
+                                                          static_cast<double>(std::abs(biomeWeights.x - analyticBiomeWeights.x)),
+                                                          static_cast<double>(std::abs(biomeWeights.y - analyticBiomeWeights.y)),
+                                                          static_cast<double>(std::abs(biomeWeights.z - analyticBiomeWeights.z))});
+        }
+
+        char distance[32];
+        snprintf(distance, sizeof(distance), "%g-%g", band.MinDistance, band.MaxDistance);
+
+        printf("%-13s %14.4f %14.4f %16.3f %16.3f %14.4f\n",
+               distance,
+               maxHeightError,
+               std::sqrt(squaredHeightError / sampleCount),
+               maxNormalError,
+               std::sqrt(squaredNormalError / sampleCount),
+               maxBiomeError);
+    }
+
+    return 0;
+}
+
+// Finite difference normal with forward differences, as used by the terrain functions before the analytic gradient
+static float3 GetTerrainNormalFiniteDifference(const float2& pos)
+{
+    const float height = GetTerrainHeight(pos);
+
+    static const float h  = 0.01f;
+    const float        dx = (height - GetTerrainHeight(float2(pos.x + h, pos.y)));
+    const float        dz = (height - GetTerrainHeight(float2(pos.x, pos.y + h)));
+
+    const float3 a = normalize(float3(h, -dx, 0));
+    const float3 b = normalize(float3(0, -dz, h));
+
+    return normalize(cross(b, a));
+}
+
+// Central difference normal, reference for the analytic gradient
+static float3 GetTerrainNormalCentralDifference(const float2& pos, float h)
+{
+    // step sizes as represented in float, positions far from the origin round the step
+    const float dx = (pos.x + h) - (pos.x - h);
+    const float dz = (pos.y + h) - (pos.y - h);
+
+    const float gradientX = (GetTerrainHeight(float2(pos.x + h, pos.y)) - GetTerrainHeight(float2(pos.x - h, pos.y))) / dx;
+    const float gradientZ = (GetTerrainHeight(float2(pos.x, pos.y + h)) - GetTerrainHeight(float2(pos.x, pos.y - h))) / dz;
+
+    return normalize(float3(-gradientX, 1, -gradientZ));
+}
+
+// atan2 of cross & dot product in double, acos of the float dot product cannot resolve small angles
+static double GetAngleDegrees(const float3& a, const float3& b)
+{
+    const double crossX = static_cast<double>(a.y) * b.z - static_cast<double>(a.z) * b.y;
+    const double crossY = static_cast<double>(a.z) * b.x - static_cast<double>(a.x) * b.z;
+    const double crossZ = static_cast<double>(a.x) * b.y - static_cast<double>(a.y) * b.x;
+    const double dotAB  = static_cast<double>(a.x) * b.x + static_cast<double>(a.y) * b.y + static_cast<double>(a.z) * b.z;
+
+    return std::atan2(std::sqrt(crossX * crossX + crossY * crossY + crossZ * crossZ), dotAB) * 57.29578;
+}
+
+struct AngleErrors
+{
+    std::vector<double> Angles;
+
+    void Print(const char* name)
+    {
+        std::sort(Angles.begin(), Angles.end());
+
+        double squaredSum = 0.0;
+        for (const auto angle : Angles)
+        {
+            squaredSum += angle * angle;
+        }
+
+        printf("%-28s %12.5f %12.5f %12.5f %12.5f\n",
+               name,
+               Angles[Angles.size() / 2],
+               std::sqrt(squaredSum / Angles.size()),
+               Angles[std::min(Angles.size() - 1, Angles.size() * 99 / 100)],
+               Angles.back());
+    }
+
+    double GetPercentile(size_t percent) const
+    {
+        return Angles[std::min(Angles.size() - 1, Angles.size() * percent / 100)];
+    }
+};
+
+// Measures the scalar run time per call in nanoseconds & the noise evaluations per call
+static void MeasureNormal(const char* name, const std::vector<float>& x, const std::vector<float>& z, const std::function<float3(const float2&)>& normalFunction)
+{
+    ResetNoiseEvaluationCount();
+
+    float3     sum       = float3(0, 0, 0);
+    const auto startTime = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < x.size(); ++i)
+    {
+        sum = sum + normalFunction(float2(x[i], z[i]));
+    }
+    const double elapsedNs = std::chrono::duration<double, std::nano>(std::chrono::high_resolution_clock::now() - startTime).count();
+
+    // sum is printed to keep the calls from being optimized away
+    printf("%-28s %12.1f %12.1f %12.3g\n",
+           name,
+           static_cast<double>(GetNoiseEvaluationCount()) / x.size(),
+           elapsedNs / x.size(),
+           static_cast<double>(sum.y) / x.size());
+}
+
+static int Gradient(size_t count)
+{
+    // central difference step, small enough to resolve the highest noise frequency (9 / 400 per metre),
+    // large enough to keep float cancellation in the height difference low
+    static const float CentralDifferenceStep = 0.2f;
+    // p99 angle between analytic & central difference normals.
+    // Larger errors are limited to the few points where the height function has a kink (max & clamp).
+    static const double MaxAngleErrorP99 = 0.25;
+
+    // positions within the playable area only, far from the origin the float step of the central difference is too coarse for a reference
+    std::mt19937                          generator(24680);
+    std::uniform_real_distribution<float> near(-5000.f, 5000.f);
+
+    std::vector<float> x(count), z(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        x[i] = near(generator);
+        z[i] = near(generator);
+    }
+
+    size_t      heightMismatchCount = 0;
+    AngleErrors analyticError, finiteDifferenceError;
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        const float2 position = float2(x[i], z[i]);
+
+        const float3 heightAndGradient = GetTerrainHeightAndGradient(position);
+        const float  height            = GetTerrainHeight(position);
+        if (std::memcmp(&heightAndGradient.x, &height, sizeof(float)) != 0)
+        {
+            ++heightMismatchCount;
+        }
+
+        const float3 reference = GetTerrainNormalCentralDifference(position, CentralDifferenceStep);
+        analyticError.Angles.push_back(GetAngleDegrees(GetTerrainNormal(position), reference));
+        finiteDifferenceError.Angles.push_back(GetAngleDegrees(GetTerrainNormalFiniteDifference(position), reference));
+    }
+
+    printf("Points: %zu, central difference step: %g\n\n", count, CentralDifferenceStep);
+    printf("Height mismatches to GetTerrainHeight: %zu\n\n", heightMismatchCount);
+
+    printf("%-28s %12s %12s %12s %12s\n", "Angle to central difference", "Median [°]", "RMS [°]", "p99 [°]", "Max. [°]");
+    analyticError.Print("Analytic gradient");
+    finiteDifferenceError.Print("Forward difference (h=0.01)");
+    printf("\n");
+
+    printf("%-28s %12s %12s %12s\n", "Normal (scalar)", "Noise evals", "Time [ns]", "");
+    MeasureNormal("Analytic gradient", x, z, [](const float2& position) { return GetTerrainNormal(position); });
+    MeasureNormal("Forward difference (h=0.01)", x, z, [](const float2& position) { return GetTerrainNormalFiniteDifference(position); });
+    MeasureNormal("Height only", x, z, [](const float2& position) { return float3(0, GetTerrainHeight(position), 0); });
+    printf("\n");
+
+    const bool success = (heightMismatchCount == 0) && (analyticError.GetPercentile(99) <= MaxAngleErrorP99);
+
+    printf("%s\n", success ? "Analytic gradient matches the terrain height." : "Analytic gradient mismatch.");
+
+    return success ? 0 : 1;
+}
+
+// Terrain functions before the fused TerrainSample API, baseline for the noise evaluation counts of the "samples" command.
+// GetBiomeWeights evaluated the 0.1 noise octave three times & GetTerrainHeight computed all three biome weights.
+namespace legacy
+{
+    static float3 GetBiomeWeights(const float2& position)
+    {
+        const float2 pos = position * 0.01f;
+
+        float mountainFactor = 0;
+        mountainFactor += 1 * PerlinNoise2D(0.5f * pos);
+        mountainFactor += 2 * PerlinNoise2D(0.2f * pos + float2(38, 23));
+        mountainFactor += 4 * PerlinNoise2D(0.1f * pos);
+
+        float woodlandMountainFactor = 1.f - smoothstep(0, 1, 4 * pow2(mountainFactor - 0.5f));
+        woodlandMountainFactor       = woodlandMountainFactor - pow4(4 * PerlinNoise2D(0.1f * pos));
+        mountainFactor               = clamp(pow2(clamp(mountainFactor, 0, 1)), 0, 1);
+
+        float woodlandFactor = 0;
+        woodlandFactor += 1 * pow3(4 * PerlinNoise2D(0.3f * pos));
+        woodlandFactor += 5 * pow2(1 * PerlinNoise2D(0.1f * pos));
+        woodlandFactor = clamp(smoothstep(0, 1, woodlandFactor), 0, 1);
+
+        woodlandFactor = smoothstep(0, 1, std::max(woodlandMountainFactor, woodlandFactor - mountainFactor));
+
+        const float grasslandFactor = clamp(1 - (mountainFactor + woodlandFactor), 0, 1);
+
+        return float3(mountainFactor, woodlandFactor, grasslandFactor);
+    }
+
+    static float GetTerrainHeight(const float2& pos)
+    {
+        const float3 biomes = legacy::GetBiomeWeights(pos);
+
+        const float2 samplePosition = pos / 400.f;
+
+        float baseHeight = 0;
+        baseHeight += 1.0f * PerlinNoise2D(1.0f * samplePosition + float2(34, 98));
+        baseHeight += 0.35f * PerlinNoise2D(2.0f * samplePosition + float2(73, 42));
+        baseHeight += 0.25f * std::max(PerlinNoise2D(3.2f * samplePosition + float2(+0.5f, -0.5f)),
+                                       PerlinNoise2D(3.5f * samplePosition + float2(-0.5f, +0.5f)));
+        baseHeight += 0.15f * PerlinNoise2D(4.0f * samplePosition);
+        baseHeight += 0.08f * PerlinNoise2D(8.0f * samplePosition);
+        baseHeight += 0.07f * PerlinNoise2D(9.0f * samplePosition);
+
+        float height = 140.0f * baseHeight * baseHeight;
+
+        float mountainHeight = 0;
+        mountainHeight += 0.97f * PerlinNoise2D(1.0f * samplePosition);
+        mountainHeight += 0.95f * std::max(PerlinNoise2D(2.8f * samplePosition + float2(+2.3f, -4.5f)),
+                                           PerlinNoise2D(3.1f * samplePosition + float2(-6.5f, +3.6f)));
+        mountainHeight += 0.75f * PerlinNoise2D(2.0f * samplePosition + float2(34, 56));
+
+        height += 70.0f * mountainHeight * mountainHeight * smoothstep(0.5f, 1.0f, biomes.x);
+        height += 40.0f * smoothstep(0.0f, 1.0f, biomes.x);
+
+        return height;
+    }
+}  // namespace legacy
+
+static bool IsBitIdentical(float a, float b)
+{
+    return std::memcmp(&a, &b, sizeof(float)) == 0;
+}
+
+static bool IsBitIdentical(const float3& a, const float3& b)
+{
+    return IsBitIdentical(a.x, b.x) && IsBitIdentical(a.y, b.y) && IsBitIdentical(a.z, b.z);
+}
+
+// Terrain queries of one work graph node or mesh shader per thread (or vertex), see the shaders named in NodeTerrainQueries::Node.
+// Before & After issue the same queries as the shader before & after moving to GetTerrainSample.
+struct NodeTerrainQueries
+{
+    const char* Node;
+    const char* Unit;
+    // Selects positions handled by the node, e.g. tiles of its biome. Not counted.
+    std::function<bool(const float2&)> Filter;
+    std::function<void(const float2&)> Before;
+    std::function<void(const float2&)> After;
+};
+
+// Tile sizes in metres, see common.hlsl
+static const float DetailedTileSize = 4.f;
+static const float TileSize         = 32.f;
+static const float ChunkSize        = 256.f;
+
+static float2 GetGridCenter(const float2& position, float gridSize)
+{
+    return float2((std::floor(position.x / gridSize) + 0.5f) * gridSize, (std::floor(position.y / gridSize) + 0.5f) * gridSize);
+}
+
+static float2 GetGridCorner(const float2& position, float gridSize)
+{
+    return float2(std::floor(position.x / gridSize) * gridSize, std::floor(position.y / gridSize) * gridSize);
+}
+
+// Dominant biome of the tile containing position, same classification as ChunkGrid in world.hlsl
+static uint32_t GetTileBiome(const float2& position)
+{
+    const float3 biomeWeights = GetBiomeWeights(GetGridCenter(position, TileSize));
+
+    return biomeWeights.x > biomeWeights.y ? (biomeWeights.x > biomeWeights.z ? 0 : 2) : (biomeWeights.y > biomeWeights.z ? 1 : 2);
+}
+
+static int Samples(size_t count)
+{
+    std::mt19937                          generator(13579);
+    std::uniform_real_distribution<float> near(-5000.f, 5000.f);
+
+    std::vector<float2> positions(count);
+    for (auto& position : positions)
+    {
+        position = float2(near(generator), near(generator));
+    }
+
+    // Fused sample must match the separate functions & the separate functions must match their previous implementation
+    size_t mismatchCount = 0;
+    for (const auto& position : positions)
+    {
+        const TerrainSample sample = GetTerrainSample(position);
+
+        mismatchCount += !IsBitIdentical(sample.Height, GetTerrainHeight(position)) || !IsBitIdentical(sample.Normal, GetTerrainNormal(position)) ||
+                         !IsBitIdentical(sample.BiomeWeights, GetBiomeWeights(position)) ||
+                         !IsBitIdentical(sample.Height, legacy::GetTerrainHeight(position)) ||
+                         !IsBitIdentical(sample.BiomeWeights, legacy::GetBiomeWeights(position));
+    }
+
+    // Clipmap sample must match the separate clipmap functions, positions cover all levels & the analytic fallback
+    TerrainClipmapDesc clipmapDesc;
+    clipmapDesc.LevelCount = 3;
+    clipmapDesc.Resolution = 128;
+
+    TerrainClipmap clipmap(clipmapDesc);
+    clipmap.Update(0.f, 0.f);
+
+    size_t clipmapMismatchCount = 0;
+    for (const auto& position : positions)
+    {
+        const float2        clipmapPosition = 0.1f * position;
+        const TerrainSample sample          = clipmap.GetTerrainSample(clipmapPosition);
+
+        clipmapMismatchCount += !IsBitIdentical(sample.Height, clipmap.GetHeight(clipmapPosition)) ||
+                                !IsBitIdentical(sample.Normal, clipmap.GetNormal(clipmapPosition)) ||
+                                !IsBitIdentical(sample.BiomeWeights, clipmap.GetBiomeWeights(clipmapPosition));
+    }
+
+    printf("Points: %zu\n\n", count);
+    printf("GetTerrainSample mismatches:         %zu\n", mismatchCount);
+    printf("Clipmap GetTerrainSample mismatches: %zu\n\n", clipmapMismatchCount);
+
+    const NodeTerrainQueries nodes[] = {
+        {"ChunkGrid",
+         "thread",
+         nullptr,
+         [](const float2& p) {
+             // terrain chunk level of detail of the chunk & its four neighbours, biome of the tile
+             for (const auto offset : {float2(0, 0), float2(-1, 0), float2(0, -1), float2(1, 0), float2(0, 1)})
+             {
+                 legacy::GetTerrainHeight(GetGridCenter(p, ChunkSize) + ChunkSize * offset);
+             }
+             legacy::GetBiomeWeights(GetGridCenter(p, TileSize));
+         },
+         [](const float2& p) {
+             for (const auto offset : {float2(0, 0), float2(-1, 0), float2(0, -1), float2(1, 0), float2(0, 1)})
+             {
+                 GetTerrainHeight(GetGridCenter(p, ChunkSize) + ChunkSize * offset);
+             }
+             GetBiomeWeights(GetGridCenter(p, TileSize));
+         }},
+        {"MountainTile",
+         "thread",
+         [](const float2& p) { return GetTileBiome(p) == 0; },
+         [](const float2& p) {
+             legacy::GetTerrainHeight(GetGridCenter(p, TileSize));
+             legacy::GetTerrainHeight(GetGridCenter(p, DetailedTileSize));
+             legacy::GetBiomeWeights(GetGridCorner(p, DetailedTileSize));
+             GetTerrainNormal(GetGridCorner(p, DetailedTileSize));
+         },
+         [](const float2& p) {
+             // rock placed at the detailed tile center, slope tested at its corner
+             GetTerrainHeight(GetGridCenter(p, TileSize));
+             GetTerrainHeight(GetGridCenter(p, DetailedTileSize));
+             GetTerrainNormal(GetGridCorner(p, DetailedTileSize));
+         }},
+        {"WoodlandTile",
+         "thread",
+         [](const float2& p) { return GetTileBiome(p) == 1; },
+         [](const float2& p) {
+             legacy::GetTerrainHeight(GetGridCenter(p, DetailedTileSize));
+             // HasTree, normal only for woodland dominated detailed tiles
+             const float3 biomeWeights = legacy::GetBiomeWeights(GetGridCorner(p, DetailedTileSize));
+             if ((biomeWeights.y >= biomeWeights.x) && (biomeWeights.y >= biomeWeights.z))
+             {
+                 GetTerrainNormal(GetGridCorner(p, DetailedTileSize));
+             }
+         },
+         [](const float2& p) {
+             GetTerrainHeight(GetGridCenter(p, DetailedTileSize));
+             GetTerrainSample(GetGridCorner(p, DetailedTileSize));
+         }},
+        {"GrasslandTile",
+         "thread",
+         [](const float2& p) { return GetTileBiome(p) == 2; },
+         [](const float2& p) {
+             legacy::GetTerrainHeight(GetGridCenter(p, TileSize));
+             legacy::GetTerrainHeight(GetGridCenter(p, DetailedTileSize));
+             legacy::GetBiomeWeights(GetGridCorner(p, DetailedTileSize));
+         },
+         [](const float2& p) {
+             // flower count from the meadow weight at the detailed tile corner
+             GetTerrainHeight(GetGridCenter(p, TileSize));
+             GetTerrainHeight(GetGridCenter(p, DetailedTileSize));
+             GetBiomeWeights(GetGridCorner(p, DetailedTileSize));
+         }},
+        {"DetailedTile",
+         "thread",
+         nullptr,
+         [](const float2& p) {
+             legacy::GetTerrainHeight(p);
+             GetTerrainNormal(p);
+             legacy::GetBiomeWeights(p);
+         },
+         [](const float2& p) { GetTerrainSample(p); }},
+        {"GenerateOakTree/PineTree",
+         "thread",
+         nullptr,
+         [](const float2& p) {
+             legacy::GetTerrainHeight(p);
+             GetTerrainNormal(p);
+         },
+         [](const float2& p) { GetTerrainSample(p); }},
+        {"GenerateRock",
+         "thread",
+         nullptr,
+         [](const float2& p) {
+             legacy::GetTerrainHeight(p);
+             GetTerrainNormal(p);
+         },
+         [](const float2& p) { GetTerrainSample(p); }},
+        {"SparseGrassMeshShader",
+         "patch",
+         nullptr,
+         [](const float2& p) {
+             // vertex & primitive threads
+             GetTerrainNormal(p);
+             legacy::GetTerrainHeight(p);
+             legacy::GetTerrainHeight(p);
+             GetTerrainNormal(p);
+             legacy::GetBiomeWeights(p);
+         },
+         [](const float2& p) {
+             GetTerrainSample(p);
+             GetTerrainSample(p);
+         }},
+        {"TerrainMeshShader",
+         "vertex",
+         nullptr,
+         [](const float2& p) {
+             legacy::GetTerrainHeight(p);
+             GetTerrainNormal(p);
+         },
+         [](const float2& p) { GetTerrainSample(p); }},
+    };
+
+    // counts are measured on the analytic path (outside of the clipmap), inside the clipmap no noise is evaluated
+    printf("Noise evaluations per unit, analytic path\n");
+    printf("%-26s %-8s %10s %10s %10s\n", "Node", "Unit", "Before", "After", "Saving");
+
+    for (const auto& node : nodes)
+    {
+        uint64_t beforeCount = 0, afterCount = 0, unitCount = 0;
+        for (const auto& position : positions)
+        {
+            if (node.Filter && !node.Filter(position))
+            {
+                continue;
+            }
+
+            ResetNoiseEvaluationCount();
+            node.Before(position);
+            beforeCount += GetNoiseEvaluationCount();
+
+            ResetNoiseEvaluationCount();
+            node.After(position);
+            afterCount += GetNoiseEvaluationCount();
+
+            ++unitCount;
+        }
+
+        if (unitCount == 0)
+        {
+            printf("%-26s %-8s %10s\n", node.Node, node.Unit, "no positions");
+            continue;
+        }
+
+        printf("%-26s %-8s %10.1f %10.1f %9.0f%%\n",
+               node.Node,
+               node.Unit,
+               static_cast<double>(beforeCount) / unitCount,
+               static_cast<double>(afterCount) / unitCount,
+               100.0 * (1.0 - static_cast<double>(afterCount) / beforeCount));
+    }
+    printf("\n");
+
+    const bool success = (mismatchCount == 0) && (clipmapMismatchCount == 0);
+
+    printf("%s\n", success ? "GetTerrainSample matches the separate terrain functions." : "GetTerrainSample mismatch.");
+
+    return success ? 0 : 1;
+}
+
+static const char* GetLaunchName(WorldGraphLaunch launch)
+{
+    switch (launch)
+    {
+    case WorldGraphLaunch::Thread:
+        return "thread";
+    case WorldGraphLaunch::Broadcasting:
+        return "broadcasting";
+    case WorldGraphLaunch::Coalescing:
+        return "coalescing";
+    default:
+        return "mesh";
+    }
+}
+
+static bool IsRecordStreamIdentical(const WorldGraphFrame& a, const WorldGraphFrame& b)
+{
+    for (uint32_t i = 0; i < WorldGraphNodeCount; ++i)
+    {
+        const size_t recordSize = GetWorldGraphNodeInfo(static_cast<WorldGraphNode>(i)).RecordSize;
+
+        if (a.Records[i].size() != b.Records[i].size())
+        {
+            return false;
+        }
+
+        for (size_t r = 0; (recordSize > 0) && (r < a.Records[i].size()); ++r)
+        {
+            if (std::memcmp(a.Records[i][r], b.Records[i][r], recordSize) != 0)
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+static bool WriteRecordStream(const char* path, const WorldGraphFrame& frame)
+{
+    FILE* pFile = fopen(path, "wb");
+    if (pFile == nullptr)
+    {
+        return false;
+    }
+
+    const uint32_t header[] = {0x53524E4D /* "MNRS" */, 1, WorldGraphNodeCount};
+    bool           success  = fwrite(header, sizeof(header), 1, pFile) == 1;
+
+    for (uint32_t i = 0; success && (i < WorldGraphNodeCount); ++i)
+    {
+        const WorldGraphNodeInfo& info        = GetWorldGraphNodeInfo(static_cast<WorldGraphNode>(i));
+        const uint32_t            idLength    = static_cast<uint32_t>(strlen(info.NodeId));
+        const uint32_t            recordSize  = static_cast<uint32_t>(info.RecordSize);
+        const uint64_t            recordCount = frame.Records[i].size();
+
+        success = (fwrite(&idLength, sizeof(idLength), 1, pFile) == 1) && (fwrite(info.NodeId, idLength, 1, pFile) == 1) &&
+                  (fwrite(&recordSize, sizeof(recordSize), 1, pFile) == 1) && (fwrite(&recordCount, sizeof(recordCount), 1, pFile) == 1);
+
+        for (const void* pRecord : frame.Records[i])
+        {
+            success = success && ((recordSize == 0) || (fwrite(pRecord, recordSize, 1, pFile) == 1));
+        }
+    }
+
+    return (fclose(pFile) == 0) && success;
+}
+
+static int Graph(uint32_t threadCount, uint32_t frameCount, const char* recordStreamPath)
+{
+    WorldGraphDesc desc = {};
+    desc.ThreadCount    = threadCount;
+
+    WorldGraphEmulator emulator(desc);
+
+    const WorkGraphCBData data = CreateWorkGraphCBData(WorldGraphCamera());
+
+    printf("Workers: %u, frames: %u, default sample camera\n\n", emulator.GetThreadCount(), frameCount);
+
+    // average node times over all frames, the first frame also allocates the record arenas
+    double nodeTimeMs[WorldGraphNodeCount] = {};
+    double totalTimeMs = 0.0, minTimeMs = 1e30;
+
+    for (uint32_t frame = 0; frame < frameCount; ++frame)
+    {
+        const WorldGraphFrame& result = emulator.Execute(data);
+
+        for (uint32_t i = 0; i < WorldGraphNodeCount; ++i)
+        {
+            nodeTimeMs[i] += result.Nodes[i].TimeMs;
+        }
+        totalTimeMs += result.TimeMs;
+        minTimeMs = std::min(minTimeMs, result.TimeMs);
+    }
+
+    const WorldGraphFrame& frame = emulator.GetFrame();
+
+    printf("%-20s %-24s %-13s %10s %10s %14s %10s\n", "Node", "Function", "Launch", "Records", "Groups", "Record bytes", "Avg. [ms]");
+
+    for (uint32_t i = 0; i < WorldGraphNodeCount; ++i)
+    {
+        const WorldGraphNodeInfo&  info  = GetWorldGraphNodeInfo(static_cast<WorldGraphNode>(i));
+        const WorldGraphNodeStats& stats = frame.Nodes[i];
+
+        printf("%-20s %-24s %-13s %10llu %10llu %14llu %10.3f\n",
+               info.NodeId,
+               info.Name,
+               GetLaunchName(info.Launch),
+               static_cast<unsigned long long>(stats.RecordCount),
+               static_cast<unsigned long long>(stats.GroupCount),
+               static_cast<unsigned long long>(stats.RecordCount * info.RecordSize),
+               nodeTimeMs[i] / frameCount);
+    }
+
+    printf("\nFrame: %.3f ms avg., %.3f ms min., record arenas: %.2f MiB\n\n", totalTimeMs / frameCount, minTimeMs, frame.ArenaBytes / (1024.0 * 1024.0));
+
+    // The record stream must not depend on the scheduling
+    desc.ThreadCount = 1;
+    WorldGraphEmulator reference(desc);
+
+    const bool identical = IsRecordStreamIdentical(reference.Execute(data), frame);
+
+    printf("%s\n", identical ? "Record stream matches single-threaded execution." : "Record stream differs from single-threaded execution.");
+
+    if (recordStreamPath != nullptr)
+    {
+        if (!WriteRecordStream(recordStreamPath, frame))
+        {
+            printf("Failed to write record stream to %s\n", recordStreamPath);
+            return 1;
+        }
+
+        printf("Record stream written to %s\n", recordStreamPath);
+    }
+
+    return identical ? 0 : 1;
+}
+
+// Distance limits & grass blade counts of the quality tiers in config/meshnodesampleconfig.json
+struct QualityTierPreset
+{
+    const char*       Name;
+    WorldGraphQuality Quality;
+};
+
+static const QualityTierPreset QualityTierPresets[] = {
+    {"Low", {1000.f, 40.f, 120.f, 150.f, 16}},
+    {"Medium", {1500.f, 60.f, 180.f, 220.f, 24}},
+    {"High", {2000.f, 80.f, 250.f, 300.f, 32}},
+    {"Ultra", {3000.f, 100.f, 350.f, 400.f, 32}},
+};
+
+// NodeMaxInputRecordsPerGraphEntryRecord of a mesh node array & the records sent to it for every camera pose
+struct NodeRecordLimit
+{
+    std::string           NodeId;
+    uint32_t              MaxInputRecords = 0;
+    std::vector<uint32_t> Nodes;
+    std::vector<uint64_t> RecordCounts;
+};
+
+// Nearest-rank percentile of sorted values
+static uint64_t GetPercentile(const std::vector<uint64_t>& sortedValues, double percentile)
+{
+    const size_t rank = static_cast<size_t>(std::ceil(percentile * sortedValues.size()));
+
+    return sortedValues[std::min(std::max<size_t>(rank, 1), sortedValues.size()) - 1];
+}
+
+// Camera poses for the record limit sweep. Positions are spread over the world, half of them close to the ground where
+// most grass & flower records are generated. Every position is looked at from headingCount evenly spaced headings.
+static std::vector<WorldGraphCamera> GenerateLimitPoses(uint32_t poseCount, uint32_t headingCount)
+{
+    static const float WorldExtent = 4096.f;
+
+    std::mt19937                          random(42);
+    std::uniform_real_distribution<float> position(-WorldExtent, WorldExtent);
+    std::uniform_real_distribution<float> groundHeight(1.5f, 20.f);
+    std::uniform_real_distribution<float> height(20.f, 400.f);
+    std::uniform_real_distribution<float> yaw(0.f, 6.2831853f);
+    std::uniform_real_distribution<float> pitch(-1.2f, 0.4f);
+
+    std::vector<WorldGraphCamera> poses;
+    poses.reserve(poseCount);
+
+    while (poses.size() < poseCount)
+    {
+        WorldGraphCamera camera = {};
+
+        const float2 pos = float2(position(random), position(random));
+        const float  y   = GetTerrainHeight(pos) + (((poses.size() / headingCount) % 2) ? height(random) : groundHeight(random));
+
+        // same height limit as the sample camera
+        camera.Position = float3(pos.x, std::min(y, 400.f), pos.y);
+
+        const float baseYaw = yaw(random);
+        for (uint32_t heading = 0; (heading < headingCount) && (poses.size() < poseCount); ++heading)
+        {
+            camera.Yaw   = baseYaw + heading * (6.2831853f / headingCount);
+            camera.Pitch = pitch(random);
+
+            poses.push_back(camera);
+        }
+    }
+
+    return poses;
+}
+
+static int Limits(uint32_t poseCount, uint32_t threadCount, const QualityTierPreset& tier)
+{
+    // a record limit is flagged as over-provisioned if the worst case uses less than this fraction of it
+    static const double OverProvisionedFraction = 0.25;
+    // headroom on top of the worst case for suggested limits & backing memory
+    static const double Headroom = 1.25;
+
+    WorldGraphDesc desc = {};
+    desc.Quality        = tier.Quality;
+    desc.ThreadCount    = threadCount;
+
+    WorldGraphEmulator emulator(desc);
+
+    // NodeMaxInputRecordsPerGraphEntryRecord is shared across node arrays, e.g. DrawFlowerPatch[0] & [1]
+    std::vector<NodeRecordLimit> limits;
+    for (uint32_t i = 0; i < WorldGraphNodeCount; ++i)
+    {
+        const WorldGraphNodeInfo& info = GetWorldGraphNodeInfo(static_cast<WorldGraphNode>(i));
+        if (info.MaxInputRecords == 0)
+        {
+            continue;
+        }
+
+        const std::string nodeId = std::string(info.NodeId).substr(0, std::string(info.NodeId).find('['));
+
+        auto it = std::find_if(limits.begin(), limits.end(), [&](const NodeRecordLimit& limit) { return limit.NodeId == nodeId; });
+        if (it == limits.end())
+        {
+            it                  = limits.insert(limits.end(), NodeRecordLimit());
+            it->NodeId          = nodeId;
+            it->MaxInputRecords = info.MaxInputRecords;
+        }
+
+        it->Nodes.push_back(i);
+    }
+
+    const std::vector<WorldGraphCamera> poses = GenerateLimitPoses(poseCount, 4);
+
+    printf("Workers: %u, camera poses: %u, quality tier: %s\n\n", emulator.GetThreadCount(), poseCount, tier.Name);
+
+    // records of all nodes are resident at once in the emulator, an upper bound for the records in flight on the GPU
+    std::vector<uint64_t> recordBytes(poses.size());
+    std::vector<size_t>   worstPoses(limits.size(), 0);
+
+    const auto startTime = std::chrono::high_resolution_clock::now();
+
+    for (size_t pose = 0; pose < poses.size(); ++pose)
+    {
+        const WorldGraphFrame& frame = emulator.Execute(CreateWorkGraphCBData(poses[pose]));
+
+        for (size_t l = 0; l < limits.size(); ++l)
+        {
+            uint64_t recordCount = 0;
+            for (const uint32_t node : limits[l].Nodes)
+            {
+                recordCount += frame.Nodes[node].RecordCount;
+            }
+
+            if ((pose == 0) || (recordCount > limits[l].RecordCounts[worstPoses[l]]))
+            {
+                worstPoses[l] = pose;
+            }
+            limits[l].RecordCounts.push_back(recordCount);
+        }
+
+        for (uint32_t i = 0; i < WorldGraphNodeCount; ++i)
+        {
+            recordBytes[pose] += frame.Nodes[i].RecordCount * GetWorldGraphNodeInfo(static_cast<WorldGraphNode>(i)).RecordSize;
+        }
+
+        if (((pose + 1) % std::max<size_t>(poses.size() / 10, 1)) == 0)
+        {
+            const double seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - startTime).count();
+
+            printf("  %zu / %zu poses, %.1f s\n", pose + 1, poses.size(), seconds);
+        }
+    }
+
+    printf("\n%-20s %8s %8s %8s %8s %8s %8s %8s  %s\n", "Node", "Limit", "p50", "p90", "p99", "p99.9", "Max", "Max [%]", "Status");
+
+    bool exceeded = false;
+
+    for (auto& limit : limits)
+    {
+        std::vector<uint64_t> sorted = limit.RecordCounts;
+        std::sort(sorted.begin(), sorted.end());
+
+        const uint64_t maxRecords = sorted.back();
+        const double   usage      = static_cast<double>(maxRecords) / limit.MaxInputRecords;
+        // suggested limit rounded up to a multiple of 10
+        const uint64_t suggested = std::max<uint64_t>((static_cast<uint64_t>(std::ceil(maxRecords * Headroom)) + 9) / 10 * 10, 10);
+
+        char status[64] = "ok";
+        if (maxRecords > limit.MaxInputRecords)
+        {
+            snprintf(status, sizeof(status), "EXCEEDED, suggest %llu", static_cast<unsigned long long>(suggested));
+            exceeded = true;
+        }
+        else if ((usage < OverProvisionedFraction) && (suggested < limit.MaxInputRecords))
+        {
+            snprintf(status, sizeof(status), "over-provisioned, suggest %llu", static_cast<unsigned long long>(suggested));
+        }
+
+        printf("%-20s %8u %8llu %8llu %8llu %8llu %8llu %8.1f  %s\n",
+               limit.NodeId.c_str(),
+               limit.MaxInputRecords,
+               static_cast<unsigned long long>(GetPercentile(sorted, 0.5)),
+               static_cast<unsigned long long>(GetPercentile(sorted, 0.9)),
+               static_cast<unsigned long long>(GetPercentile(sorted, 0.99)),
+               static_cast<unsigned long long>(GetPercentile(sorted, 0.999)),
+               static_cast<unsigned long long>(maxRecords),
+               usage * 100.0,
+               status);
+    }
+
+    printf("\nWorst case camera poses:\n");
+
+    for (size_t l = 0; l < limits.size(); ++l)
+    {
+        const WorldGraphCamera& camera = poses[worstPoses[l]];
+
+        printf("  %-20s position (%.2f, %.2f, %.2f), yaw %.3f, pitch %.3f\n",
+               limits[l].NodeId.c_str(),
+               camera.Position.x,
+               camera.Position.y,
+               camera.Position.z,
+               camera.Yaw,
+               camera.Pitch);
+    }
+
+    std::vector<uint64_t> sortedBytes = recordBytes;
+    std::sort(sortedBytes.begin(), sortedBytes.end());
+
+    // recommendation is rounded up to 1 MiB
+    static const uint64_t MiB         = 1024 * 1024;
+    const uint64_t        recommended = (static_cast<uint64_t>(std::ceil(sortedBytes.back() * Headroom)) + MiB - 1) / MiB * MiB;
+
+    printf("\nRecord bytes per frame: p50 %.2f MiB, p99 %.2f MiB, max %.2f MiB\n",
+           GetPercentile(sortedBytes, 0.5) / double(MiB),
+           GetPercentile(sortedBytes, 0.99) / double(MiB),
+           sortedBytes.back() / double(MiB));
+    printf("Recommended backing memory: %llu bytes (%.0f MiB, worst case + %.0f%%)\n",
+           static_cast<unsigned long long>(recommended),
+           recommended / double(MiB),
+           (Headroom - 1.0) * 100.0);
+    printf("Set \"BackingMemory\": { \"SizeInBytes\": %llu } in the sample config, the sample clamps it to the range reported by the driver.\n",
+           static_cast<unsigned long long>(recommended));
+
+    return exceeded ? 1 : 0;
+}
+
+// Flythrough path from a JSON file, see config/flythrough.json:
+// { "TimeStep": 0.0166667, "Keys": [ { "Time": 0.0, "Position": [x, y, z], "Yaw": 2.944, "Pitch": 0.0, "WindStrength": 1.0, "WindDirection": 0.0 }, ... ] }
+static bool LoadFlythroughPath(const char* path, std::vector<FlythroughKey>& keys, float& timeStep, std::string& errorString)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+    {
+        errorString = "Failed to open file";
+        return false;
+    }
+
+    std::stringstream stream;
+    stream << file.rdbuf();
+
+    JsonNode document;
+    if (!ParseJson(stream.str(), document, errorString))
+    {
+        return false;
+    }
+
+    const JsonNode* keysNode = GetJsonMember(document, "Keys");
+    if ((keysNode == nullptr) || (keysNode->NodeType != JsonNode::Type::Array))
+    {
+        errorString = "\"Keys\" must be an array";
+        return false;
+    }
+
+    timeStep = static_cast<float>(GetJsonNumber(GetJsonMember(document, "TimeStep"), timeStep));
+
+    for (const auto& keyNode : keysNode->Children)
+    {
+        const JsonNode* positionNode = GetJsonMember(keyNode.second, "Position");
+        if ((positionNode == nullptr) || (positionNode->NodeType != JsonNode::Type::Array) || (positionNode->Children.size() != 3))
+        {
+            errorString = "Key " + std::to_string(keys.size()) + " requires a \"Position\" array with 3 elements";
+            return false;
+        }
+
+        FlythroughKey key = {};
+        key.Time          = static_cast<float>(GetJsonNumber(GetJsonMember(keyNode.second, "Time"), key.Time));
+        key.Position      = float3(static_cast<float>(GetJsonNumber(&positionNode->Children[0].second, 0.0)),
+                                   static_cast<float>(GetJsonNumber(&positionNode->Children[1].second, 0.0)),
+                                   static_cast<float>(GetJsonNumber(&positionNode->Children[2].second, 0.0)));
+        key.Yaw           = static_cast<float>(GetJsonNumber(GetJsonMember(keyNode.second, "Yaw"), key.Yaw));
+        key.Pitch         = static_cast<float>(GetJsonNumber(GetJsonMember(keyNode.second, "Pitch"), key.Pitch));
+        key.WindStrength  = static_cast<float>(GetJsonNumber(GetJsonMember(keyNode.second, "WindStrength"), key.WindStrength));
+        key.WindDirection = static_cast<float>(GetJsonNumber(GetJsonMember(keyNode.second, "WindDirection"), key.WindDirection));
+
+        if (!keys.empty() && (key.Time < keys.back().Time))
+        {
+            errorString = "Keys must be sorted by time";
+            return false;
+        }
+
+        keys.push_back(key);
+    }
+
+    return true;
+}
+
+// FNV-1a hash of all records of a frame, identical for two builds that generate the same records
+static uint32_t GetRecordHash(const WorldGraphFrame& frame)
+{
+    uint32_t hash = 2166136261u;
+
+    for (uint32_t i = 0; i < WorldGraphNodeCount; ++i)
+    {
+        const size_t recordSize = GetWorldGraphNodeInfo(static_cast<WorldGraphNode>(i)).RecordSize;
+
+        for (const void* pRecord : frame.Records[i])
+        {
+            const uint8_t* pBytes = static_cast<const uint8_t*>(pRecord);
+            for (size_t b = 0; b < recordSize; ++b)
+            {
+                hash = (hash ^ pBytes[b]) * 16777619u;
+            }
+        }
+    }
+
+    return hash;
+}
+
+// Frames of a flythrough recorded by the sample or sampled from a JSON key frame path, prints an error if there are none
+static bool LoadFlythroughFrames(const char* flythroughPath, std::vector<FlythroughFrame>& frames)
+{
+    if (std::filesystem::path(flythroughPath).extension() == ".json")
+    {
+        std::vector<FlythroughKey> keys;
+        float                      timeStep = 1.f / 60.f;
+        std::string                errorString;
+
+        if (!LoadFlythroughPath(flythroughPath, keys, timeStep, errorString))
+        {
+            printf("Failed to load flythrough path %s: %s\n", flythroughPath, errorString.c_str());
+            return false;
+        }
+
+        frames = SampleFlythroughPath(keys, timeStep);
+    }
+    else if (!LoadFlythrough(flythroughPath, frames))
+    {
+        printf("Failed to load flythrough %s\n", flythroughPath);
+        return false;
+    }
+
+    if (frames.empty())
+    {
+        printf("Flythrough %s has no frames\n", flythroughPath);
+        return false;
+    }
+
+    return true;
+}
+
+static int Flythrough(const char* flythroughPath, const char* statsPath, uint32_t threadCount, uint32_t maxFrameCount)
+{
+    std::vector<FlythroughFrame> frames;
+
+    if (!LoadFlythroughFrames(flythroughPath, frames))
+    {
+        return 1;
+    }
+
+    if ((maxFrameCount > 0) && (frames.size() > maxFrameCount))
+    {
+        frames.resize(maxFrameCount);
+    }
+
+    WorldGraphDesc desc = {};
+    desc.ThreadCount    = threadCount;
+
+    WorldGraphEmulator emulator(desc);
+
+    std::vector<std::string> columns = {"Frame", "Time", "DeltaTime", "FrameTimeMs", "RecordHash"};
+    for (uint32_t i = 0; i < WorldGraphNodeCount; ++i)
+    {
+        columns.push_back(std::string(GetWorldGraphNodeInfo(static_cast<WorldGraphNode>(i)).NodeId) + ".Records");
+    }
+    for (uint32_t i = 0; i < WorldGraphNodeCount; ++i)
+    {
+        columns.push_back(std::string(GetWorldGraphNodeInfo(static_cast<WorldGraphNode>(i)).NodeId) + ".TimeMs");
+    }
+
+    FlythroughStats stats(columns);
+
+    printf("Workers: %u, frames: %zu, flythrough: %s\n\n", emulator.GetThreadCount(), frames.size(), flythroughPath);
+
+    // same shader time accumulation as the sample, time is the start of the frame
+    double   time       = 0.0;
+    uint32_t shaderTime = 0;
+
+    for (size_t f = 0; f < frames.size(); ++f)
+    {
+        const FlythroughFrame& flythroughFrame = frames[f];
+
+        WorldGraphCamera camera = {};
+        camera.Position         = flythroughFrame.Position;
+        camera.Yaw              = flythroughFrame.Yaw;
+        camera.Pitch            = flythroughFrame.Pitch;
+
+        const uint32_t previousShaderTime = shaderTime;
+        shaderTime += static_cast<uint32_t>(flythroughFrame.DeltaTime * 1000.0);
+
+        WorkGraphCBData data    = CreateWorkGraphCBData(camera);
+        data.ShaderTime         = shaderTime;
+        data.PreviousShaderTime = previousShaderTime;
+        data.WindStrength       = flythroughFrame.WindStrength;
+        data.WindDirection      = flythroughFrame.WindDirection * (3.14159265359f / 180.f);
+
+        const WorldGraphFrame& frame = emulator.Execute(data);
+
+        std::vector<double> values = {static_cast<double>(f), time, flythroughFrame.DeltaTime, frame.TimeMs, static_cast<double>(GetRecordHash(frame))};
+        time += flythroughFrame.DeltaTime;
+        for (uint32_t i = 0; i < WorldGraphNodeCount; ++i)
+        {
+            values.push_back(static_cast<double>(frame.Nodes[i].RecordCount));
+        }
+        for (uint32_t i = 0; i < WorldGraphNodeCount; ++i)
+        {
+            values.push_back(frame.Nodes[i].TimeMs);
+        }
+
+        stats.AddFrame(values);
+
+        if (((f + 1) % std::max<size_t>(frames.size() / 10, 1)) == 0)
+        {
+            printf("  %zu / %zu frames\n", f + 1, frames.size());
+        }
+    }
+
+    // averages of the frame time & the records of all mesh nodes
+    printf("\n%-24s %12s\n", "", "Average");
+    printf("%-24s %12.3f\n", "FrameTimeMs", stats.GetAverage(3));
+
+    for (uint32_t i = 0; i < WorldGraphNodeCount; ++i)
+    {
+        const WorldGraphNodeInfo& info = GetWorldGraphNodeInfo(static_cast<WorldGraphNode>(i));
+        if (info.Launch == WorldGraphLaunch::Mesh)
+        {
+            printf("%-24s %12.1f\n", info.NodeId, stats.GetAverage(5 + i));
+        }
+    }
+
+    if (statsPath != nullptr)
+    {
+        if (!stats.Write(statsPath))
+        {
+            printf("Failed to write frame statistics to %s\n", statsPath);
+            return 1;
+        }
+
+        printf("\nFrame statistics written to %s\n", statsPath);
+    }
+
+    return 0;
+}
+
+// True if both frames sent the same records to all nodes after the entry nodes, i.e. Tile[3] & DrawTerrainChunk onwards
+static bool IsChunkOutputIdentical(const WorldGraphFrame& a, const WorldGraphFrame& b)
+{
+    for (uint32_t i = static_cast<uint32_t>(WorldGraphNode::MountainTile); i < WorldGraphNodeCount; ++i)
+    {
+        const size_t recordSize = GetWorldGraphNodeInfo(static_cast<WorldGraphNode>(i)).RecordSize;
+
+        if (a.Records[i].size() != b.Records[i].size())
+        {
+            return false;
+        }
+
+        for (size_t r = 0; r < a.Records[i].size(); ++r)
+        {
+            if (std::memcmp(a.Records[i][r], b.Records[i][r], recordSize) != 0)
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+static int Chunks(uint32_t poseCount, uint32_t repetitionCount, uint32_t verifyPoseCount, const QualityTierPreset& tier)
+{
+    // chunks culled per frame are binned in steps of BinSize, the chunk grid holds up to 32 x 32 chunks
+    static const uint32_t BinSize  = 32;
+    static const uint32_t BinCount = (MaxChunkGridSize * MaxChunkGridSize) / BinSize + 1;
+
+    std::vector<TerrainKernelIsa> isas = {TerrainKernelIsa::Scalar};
+    for (TerrainKernelIsa isa : BatchIsas)
+    {
+        if (IsTerrainKernelIsaSupported(isa))
+        {
+            isas.push_back(isa);
+        }
+    }
+
+    ChunkCullingDesc desc = {};
+    desc.Quality          = tier.Quality;
+
+    ChunkCuller culler(desc);
+
+    struct Bin
+    {
+        uint32_t FrameCount        = 0;
+        uint64_t GridChunkCount    = 0;
+        uint64_t VisibleChunkCount = 0;
+        uint64_t HeightSampleCount = 0;
+        // per instruction set
+        std::vector<double> TimeMs;
+    };
+
+    std::vector<Bin> bins(BinCount);
+    for (Bin& bin : bins)
+    {
+        bin.TimeMs.resize(isas.size(), 0.0);
+    }
+
+    const std::vector<WorldGraphCamera> poses = GenerateLimitPoses(poseCount, 4);
+
+    uint64_t gridChunkCount = 0, visibleChunkCount = 0;
+    bool     identical      = true;
+
+    std::vector<ChunkRecord> reference;
+
+    for (const WorldGraphCamera& pose : poses)
+    {
+        const WorkGraphCBData data = CreateWorkGraphCBData(pose);
+
+        for (size_t isa = 0; isa < isas.size(); ++isa)
+        {
+            culler.SetTerrainKernelIsa(isas[isa]);
+
+            double timeMs = 0.0;
+            for (uint32_t r = 0; r < repetitionCount; ++r)
+            {
+                culler.Cull(data);
+                timeMs += culler.GetStats().TimeMs;
+            }
+
+            const std::vector<ChunkRecord>& chunks = culler.GetChunks();
+            const ChunkCullingStats&        stats  = culler.GetStats();
+            Bin&                            bin    = bins[(stats.GridChunkCount - stats.VisibleChunkCount) / BinSize];
+
+            if (isa == 0)
+            {
+                reference = chunks;
+
+                bin.FrameCount++;
+                bin.GridChunkCount += stats.GridChunkCount;
+                bin.VisibleChunkCount += stats.VisibleChunkCount;
+                bin.HeightSampleCount += stats.HeightSampleCount;
+                gridChunkCount += stats.GridChunkCount;
+                visibleChunkCount += stats.VisibleChunkCount;
+            }
+            else if ((chunks.size() != reference.size()) || ((chunks.size() > 0) && (std::memcmp(chunks.data(), reference.data(), chunks.size() * sizeof(ChunkRecord)) != 0)))
+            {
+                printf("%s chunks differ from scalar reference at camera (%.2f, %.2f, %.2f)\n",
+                       GetTerrainKernelIsaName(isas[isa]),
+                       pose.Position.x,
+                       pose.Position.y,
+                       pose.Position.z);
+                identical = false;
+            }
+
+            bin.TimeMs[isa] += timeMs / repetitionCount;
+        }
+    }
+
+    printf("Quality tier: %s, poses: %u, repetitions: %u\n\n", tier.Name, poseCount, repetitionCount);
+    printf("%-14s %8s %8s %8s %8s", "Culled chunks", "Frames", "Grid", "Visible", "Heights");
+    for (TerrainKernelIsa isa : isas)
+    {
+        printf(" %10s", GetTerrainKernelIsaName(isa));
+    }
+    printf("   (avg. per frame, times in us)\n");
+
+    for (uint32_t i = 0; i < BinCount; ++i)
+    {
+        const Bin& bin = bins[i];
+        if (bin.FrameCount == 0)
+        {
+            continue;
+        }
+
+        const double frameCount = bin.FrameCount;
+
+        printf("%5u - %-6u %8u %8.1f %8.1f %8.1f",
+               i * BinSize,
+               (i + 1) * BinSize - 1,
+               bin.FrameCount,
+               bin.GridChunkCount / frameCount,
+               bin.VisibleChunkCount / frameCount,
+               bin.HeightSampleCount / frameCount);
+        for (double timeMs : bin.TimeMs)
+        {
+            printf(" %10.2f", 1000.0 * timeMs / frameCount);
+        }
+        printf("\n");
+    }
+
+    printf("\nChunkGrid thread groups per frame: %.1f, Chunk thread groups per frame: %.1f (%.1f%% culled on the CPU)\n",
+           static_cast<double>(gridChunkCount) / poses.size(),
+           static_cast<double>(visibleChunkCount) / poses.size(),
+           (gridChunkCount > 0) ? 100.0 * (gridChunkCount - visibleChunkCount) / gridChunkCount : 0.0);
+    printf("%s\n", identical ? "All instruction sets produce identical chunk records." : "Chunk records differ between instruction sets.");
+
+    // The Chunk entry must generate the same records as the World entry
+    WorldGraphDesc graphDesc = {};
+    graphDesc.Quality        = tier.Quality;
+
+    WorldGraphEmulator worldEmulator(graphDesc);
+    WorldGraphEmulator chunkEmulator(graphDesc);
+
+    culler.SetTerrainKernelIsa(TerrainKernelIsa::Auto);
+
+    bool graphIdentical = true;
+    for (uint32_t i = 0; i < std::min<uint32_t>(verifyPoseCount, poseCount); ++i)
+    {
+        const WorkGraphCBData data = CreateWorkGraphCBData(poses[i]);
+
+        if (!IsChunkOutputIdentical(worldEmulator.Execute(data), chunkEmulator.Execute(data, culler.Cull(data))))
+        {
+            printf("Chunk entry records differ from World entry at camera (%.2f, %.2f, %.2f)\n",
+                   poses[i].Position.x,
+                   poses[i].Position.y,
+                   poses[i].Position.z);
+            graphIdentical = false;
+        }
+    }
+
+    if (verifyPoseCount > 0)
+    {
+        printf("%s\n", graphIdentical ? "Chunk entry generates the same records as the World entry." : "Chunk entry records differ from the World entry.");
+    }
+
+    return (identical && graphIdentical) ? 0 : 1;
+}
+
+// Camera 10 m above the terrain along GetFlightPosition, looking along the flight direction & panning around
+static WorldGraphCamera GetFlightCamera(float time, float speed)
+{
+    static const float TimeStep = 1.f / 60.f;
+
+    const float2 position = GetFlightPosition(time, speed);
+    const float2 velocity = GetFlightPosition(time + TimeStep, speed) - position;
+
+    WorldGraphCamera camera = {};
+    camera.Position         = float3(position.x, GetTerrainHeight(position) + 10.f, position.y);
+    camera.Yaw              = std::atan2(-velocity.x, -velocity.y) + 0.8f * std::sin(time * 0.3f);
+    camera.Pitch            = -0.15f;
+
+    return camera;
+}
+
+static void PrintCacheStats(const char* label, uint32_t frameCount, double uncachedTimeMs, double cachedTimeMs, const ChunkMetadataCacheStats& stats, size_t entryCount)
+{
+    const double frames = std::max(frameCount, 1u);
+
+    printf("%-13s %10.2f %10.2f %8.2f%% %8.2f%% %8.1f %8.2f %8.2f %8.2f %8zu %8.2f\n",
+           label,
+           1000.0 * uncachedTimeMs / frames,
+           1000.0 * cachedTimeMs / frames,
+           100.0 * stats.GetHitRate(),
+           (stats.ChunkLookups > 0) ? 100.0 * (stats.ChunkLookups - stats.ChunkMisses) / stats.ChunkLookups : 100.0,
+           stats.TerrainSampleCount / frames,
+           stats.LevelOfDetailChanges / frames,
+           stats.TransitionMaskUpdates / frames,
+           (stats.DistanceEvictions + stats.CapacityEvictions) / frames,
+           entryCount,
+           1000.0 * stats.TimeMs / frames);
+}
+
+static int ChunkCache(uint32_t frameCount, float speed, uint32_t verifyFrameCount, uint32_t capacity)
+{
+    static const float FrameTime = 1.f / 60.f;
+
+    // the culler with cache is compared against the culler sampling the analytic terrain every frame
+    ChunkMetadataCacheDesc cacheDesc = {};
+    cacheDesc.Capacity               = capacity;
+
+    ChunkMetadataCache cache(cacheDesc);
+
+    ChunkCullingDesc cullingDesc = {};
+    ChunkCuller      uncachedCuller(cullingDesc);
+
+    cullingDesc.pMetadataCache = &cache;
+    ChunkCuller cachedCuller(cullingDesc);
+
+    // mountain tile features are verified against the emulator without cache
+    WorldGraphDesc graphDesc = {};
+
+    WorldGraphEmulator uncachedEmulator(graphDesc);
+
+    graphDesc.pMetadataCache = &cache;
+    WorldGraphEmulator cachedEmulator(graphDesc);
+
+    printf("Frames: %u, camera speed: %g m/s, cache capacity: %u chunks (%zu bytes each)\n\n", frameCount, speed, capacity, sizeof(ChunkMetadata));
+    printf("%-13s %10s %10s %9s %9s %8s %8s %8s %8s %8s %8s\n",
+           "Frames",
+           "Sampled",
+           "Cached",
+           "Hit rate",
+           "Chunks",
+           "Samples",
+           "LOD chg.",
+           "Masks",
+           "Evicted",
+           "Entries",
+           "Cache");
+
+    // per second statistics
+    const uint32_t reportInterval = 60;
+    const uint32_t verifyInterval = std::max(frameCount / std::max(verifyFrameCount, 1u), 1u);
+
+    double   uncachedTimeMs = 0.0, cachedTimeMs = 0.0, totalUncachedTimeMs = 0.0, totalCachedTimeMs = 0.0;
+    double   uncachedMountainTimeMs = 0.0, cachedMountainTimeMs = 0.0;
+    uint32_t verifiedFrameCount = 0;
+    bool     identical = true, graphIdentical = true;
+
+    ChunkMetadataCacheStats intervalStats;
+
+    for (uint32_t frame = 0; frame < frameCount; ++frame)
+    {
+        const WorldGraphCamera camera = GetFlightCamera(frame * FrameTime, speed);
+        const WorkGraphCBData  data   = CreateWorkGraphCBData(camera);
+
+        cache.BeginFrame(camera.Position);
+
+        const std::vector<ChunkRecord>& cachedChunks   = cachedCuller.Cull(data);
+        const std::vector<ChunkRecord>& uncachedChunks = uncachedCuller.Cull(data);
+
+        if ((cachedChunks.size() != uncachedChunks.size()) ||
+            ((cachedChunks.size() > 0) && (std::memcmp(cachedChunks.data(), uncachedChunks.data(), cachedChunks.size() * sizeof(ChunkRecord)) != 0)))
+        {
+            printf("Cached chunk records differ at frame %u, camera (%.2f, %.2f, %.2f)\n", frame, camera.Position.x, camera.Position.y, camera.Position.z);
+            identical = false;
+        }
+
+        if ((verifiedFrameCount < verifyFrameCount) && ((frame % verifyInterval) == 0))
+        {
+            const WorldGraphFrame& cachedFrame   = cachedEmulator.Execute(data, cachedChunks);
+            const WorldGraphFrame& uncachedFrame = uncachedEmulator.Execute(data, uncachedChunks);
+
+            if (!IsChunkOutputIdentical(cachedFrame, uncachedFrame))
+            {
+                printf("Cached emulator records differ at frame %u, camera (%.2f, %.2f, %.2f)\n", frame, camera.Position.x, camera.Position.y, camera.Position.z);
+                graphIdentical = false;
+            }
+
+            cachedMountainTimeMs += cachedFrame.Nodes[static_cast<uint32_t>(WorldGraphNode::MountainTile)].TimeMs;
+            uncachedMountainTimeMs += uncachedFrame.Nodes[static_cast<uint32_t>(WorldGraphNode::MountainTile)].TimeMs;
+            ++verifiedFrameCount;
+        }
+
+        // the cache time is part of the culling time, except for the eviction in BeginFrame
+        uncachedTimeMs += uncachedCuller.GetStats().TimeMs;
+        cachedTimeMs += cachedCuller.GetStats().TimeMs;
+
+        intervalStats.Add(cache.GetFrameStats());
+
+        if ((((frame + 1) % reportInterval) == 0) || ((frame + 1) == frameCount))
+        {
+            const uint32_t firstFrame = (frame / reportInterval) * reportInterval;
+            const std::string label   = std::to_string(firstFrame) + " - " + std::to_string(frame);
+
+            PrintCacheStats(label.c_str(), frame + 1 - firstFrame, uncachedTimeMs, cachedTimeMs, intervalStats, cache.GetEntryCount());
+
+            totalUncachedTimeMs += uncachedTimeMs;
+            totalCachedTimeMs += cachedTimeMs;
+            uncachedTimeMs = cachedTimeMs = 0.0;
+            intervalStats  = {};
+        }
+    }
+
+    const ChunkMetadataCacheStats totalStats = cache.GetTotalStats();
+
+    printf("\n");
+    PrintCacheStats("Total", frameCount, totalUncachedTimeMs, totalCachedTimeMs, totalStats, cache.GetEntryCount());
+
+    const auto printHitRate = [](const char* name, uint64_t lookupCount, uint64_t missCount) {
+        printf("  %-14s %12llu lookups, %10llu misses, hit rate %6.2f%%\n",
+               name,
+               static_cast<unsigned long long>(lookupCount),
+               static_cast<unsigned long long>(missCount),
+               (lookupCount > 0) ? 100.0 * (lookupCount - missCount) / lookupCount : 100.0);
+    };
+
+    printf("\n");
+    printHitRate("Chunk heights", totalStats.ChunkLookups, totalStats.ChunkMisses);
+    printHitRate("Tile biomes", totalStats.TileBiomeLookups, totalStats.TileBiomeMisses);
+    printHitRate("Mountain tiles", totalStats.MountainTileLookups, totalStats.MountainTileMisses);
+    printf("  %-14s %12llu by distance, %10llu by capacity\n",
+           "Evictions",
+           static_cast<unsigned long long>(totalStats.DistanceEvictions),
+           static_cast<unsigned long long>(totalStats.CapacityEvictions));
+
+    printf("\n%s\n", identical ? "Cached chunk records are identical to the sampled records." : "Cached chunk records differ from the sampled records.");
+
+    if (verifiedFrameCount > 0)
+    {
+        printf("MountainTile: %.2f ms sampled, %.2f ms cached (avg. of %u emulated frames)\n",
+               uncachedMountainTimeMs / verifiedFrameCount,
+               cachedMountainTimeMs / verifiedFrameCount,
+               verifiedFrameCount);
+        printf("%s\n", graphIdentical ? "Cached emulator generates the same records." : "Cached emulator records differ.");
+    }
+
+    return (identical && graphIdentical) ? 0 : 1;
+}
+
+// Ground truth of the horizon culling: whether the segment from the camera to a point on the curved world passes below the analytic terrain.
+// The segment is marched in steps of about 2 m from the camera. Every step is projected back onto the uncurved world along the normal
+// of the curved world, where it is compared against the terrain height.
+static bool IsSegmentBlocked(const float3& cameraPosition, const float3& target, std::vector<float>& x, std::vector<float>& z, std::vector<float>& heights)
+{
+    static const uint32_t BatchSize = 64;
+    static const float    StepSize  = 2.f;
+
+    const float2 cameraPositionXZ = float2(cameraPosition.x, cameraPosition.z);
+    const float3 segment          = target - cameraPosition;
+    const uint32_t stepCount      = std::max(static_cast<uint32_t>(std::ceil(length(segment) / StepSize)), 1u);
+
+    float radii[BatchSize];
+    float distances[BatchSize];
+
+    x.resize(BatchSize);
+    z.resize(BatchSize);
+    heights.resize(BatchSize);
+
+    for (uint32_t first = 1; first < stepCount; first += BatchSize)
+    {
+        const uint32_t count = std::min(BatchSize, stepCount - first);
+
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            const float3 position = cameraPosition + segment * (static_cast<float>(first + i) / stepCount);
+            const float2 offset   = float2(position.x, position.z) - cameraPositionXZ;
+            const float  offsetLength = length(offset);
+            const float  up           = position.y + EarthRadius;
+
+            // angle around & distance to the center of the curved world below the camera
+            const float alpha = std::atan2(offsetLength, up);
+
+            radii[i]     = std::sqrt(offsetLength * offsetLength + up * up);
+            distances[i] = alpha * EarthRadius;
+
+            const float2 worldPosition = (offsetLength > 0.f) ? cameraPositionXZ + offset * (distances[i] / offsetLength) : cameraPositionXZ;
+
+            x[i] = worldPosition.x;
+            z[i] = worldPosition.y;
+        }
+
+        GetTerrainHeightBatch(x.data(), z.data(), heights.data(), count);
+
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            if (radii[i] < EarthRadius + heights[i] * GetCurvedWorldHeightScale(distances[i]))
+            {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+static bool IsBoxInFrustum(const ClipPlanes& clipPlanes, const float3& boxMin, const float3& boxMax)
+{
+    const float* const boxMinArrays[3] = {&boxMin.x, &boxMin.y, &boxMin.z};
+    const float* const boxMaxArrays[3] = {&boxMax.x, &boxMax.y, &boxMax.z};
+
+    float visible = 0.f;
+    IsBoxVisibleBatch(boxMinArrays, boxMaxArrays, &clipPlanes.Planes[0].x, &visible, 1);
+
+    return visible != 0.f;
+}
+
+static bool IsTileInFrustum(const float3& cameraPosition, const ClipPlanes& clipPlanes, const int2& tileGridPosition)
+{
+    const float3 minPosition = float3(static_cast<float>(tileGridPosition.x), 0.f, static_cast<float>(tileGridPosition.y)) * TileSize;
+    const float3 maxPosition = minPosition + float3(TileSize, 0.f, TileSize);
+
+    return IsBoxInFrustum(clipPlanes,
+                          GetCurvedWorldSpacePosition(cameraPosition, minPosition) + float3(0.f, TerrainChunkMinHeight, 0.f),
+                          GetCurvedWorldSpacePosition(cameraPosition, maxPosition) + float3(0.f, TerrainChunkMaxHeight, 0.f));
+}
+
+static uint64_t GetMeshRecordCount(const WorldGraphFrame& frame)
+{
+    uint64_t result = 0;
+
+    for (uint32_t i = 0; i < WorldGraphNodeCount; ++i)
+    {
+        if (GetWorldGraphNodeInfo(static_cast<WorldGraphNode>(i)).Launch == WorldGraphLaunch::Mesh)
+        {
+            result += frame.Records[i].size();
+        }
+    }
+
+    return result;
+}
+
+static void PrintHorizonStats(const char* label, uint32_t frameCount, const HorizonCullingStats& stats)
+{
+    const double frames = std::max(frameCount, 1u);
+
+    printf("%-13s %8.1f %8.1f %8.2f%% %9.1f %9.1f %8.2f%% %9.1f %8.3f\n",
+           label,
+           stats.ChunkCount / frames,
+           stats.OccludedChunkCount / frames,
+           (stats.ChunkCount > 0) ? 100.0 * stats.OccludedChunkCount / stats.ChunkCount : 0.0,
+           stats.VisibleTileCount / frames,
+           stats.OccludedTileCount / frames,
+           (stats.VisibleTileCount > 0) ? 100.0 * stats.OccludedTileCount / stats.VisibleTileCount : 0.0,
+           stats.OccluderCount / frames,
+           stats.TimeMs / frames);
+}
+
+static void AddHorizonStats(HorizonCullingStats& total, const HorizonCullingStats& stats)
+{
+    total.ChunkCount += stats.ChunkCount;
+    total.OccludedChunkCount += stats.OccludedChunkCount;
+    total.VisibleTileCount += stats.VisibleTileCount;
+    total.OccludedTileCount += stats.OccludedTileCount;
+    total.OccluderCount += stats.OccluderCount;
+    total.TimeMs += stats.TimeMs;
+}
+
+static int Horizon(const char* pathName, uint32_t frameCount, uint32_t verifyFrameCount)
+{
+    static const float FlightSpeed = 20.f;
+
+    std::vector<FlythroughFrame> flythroughFrames;
+
+    if (std::string(pathName) != "flight")
+    {
+        if (!LoadFlythroughFrames(pathName, flythroughFrames))
+        {
+            return 1;
+        }
+
+        frameCount = (frameCount > 0) ? std::min(frameCount, static_cast<uint32_t>(flythroughFrames.size())) : static_cast<uint32_t>(flythroughFrames.size());
+    }
+    else if (frameCount == 0)
+    {
+        frameCount = 1800;
+    }
+
+    ChunkMetadataCache cache(ChunkMetadataCacheDesc{});
+
+    ChunkCullingDesc cullingDesc = {};
+    cullingDesc.pMetadataCache   = &cache;
+
+    ChunkCuller culler(cullingDesc);
+
+    const HorizonCullingDesc horizonDesc = {};
+    HorizonCuller            horizonCuller(horizonDesc, cache);
+
+    WorldGraphDesc     graphDesc = {};
+    WorldGraphEmulator emulator(graphDesc);
+
+    printf("Path: %s, frames: %u, azimuth bins: %u, content height: %g m\n\n", pathName, frameCount, horizonDesc.AzimuthBinCount, horizonDesc.ContentHeight);
+    printf("%-13s %8s %8s %9s %9s %9s %9s %9s %8s\n", "Frames", "Chunks", "Hidden", "Culled", "Tiles", "Hidden", "Culled", "Occluders", "Time ms");
+
+    const uint32_t reportInterval = 60;
+    const uint32_t verifyInterval = std::max(frameCount / std::max(verifyFrameCount, 1u), 1u);
+
+    HorizonCullingStats      intervalStats, totalStats;
+    std::vector<ChunkRecord> chunks;
+    std::vector<float>       x, z, heights;
+
+    uint32_t verifiedFrameCount = 0;
+    uint64_t checkedTileCount = 0, visibleTileCount = 0;
+    uint64_t frustumMeshRecordCount = 0, horizonMeshRecordCount = 0;
+    double   frustumEmulatorTimeMs = 0.0, horizonEmulatorTimeMs = 0.0;
+
+    for (uint32_t frame = 0; frame < frameCount; ++frame)
+    {
+        WorldGraphCamera camera = {};
+
+        if (flythroughFrames.empty())
+        {
+            camera = GetFlightCamera(frame * (1.f / 60.f), FlightSpeed);
+        }
+        else
+        {
+            camera.Position = flythroughFrames[frame].Position;
+            camera.Yaw      = flythroughFrames[frame].Yaw;
+            camera.Pitch    = flythroughFrames[frame].Pitch;
+        }
+
+        const WorkGraphCBData data = CreateWorkGraphCBData(camera);
+
+        cache.BeginFrame(camera.Position);
+
+        const std::vector<ChunkRecord>& frustumChunks = culler.Cull(data);
+
+        chunks = frustumChunks;
+        horizonCuller.Cull(data, chunks);
+
+        AddHorizonStats(intervalStats, horizonCuller.GetStats());
+
+        if ((verifiedFrameCount < verifyFrameCount) && ((frame % verifyInterval) == 0))
+        {
+            const ClipPlanes clipPlanes = ComputeClipPlanes(data.ViewProjection);
+
+            // every corner & the center of the hidden tiles, at the height of the tallest content
+            const auto isTileVisible = [&](const int2& tileGridPosition) {
+                const float2 tilePosition = float2(static_cast<float>(tileGridPosition.x), static_cast<float>(tileGridPosition.y)) * TileSize;
+
+                for (const float2& offset : {float2(0.f, 0.f), float2(TileSize, 0.f), float2(0.f, TileSize), float2(TileSize, TileSize), float2(TileSize * 0.5f)})
+                {
+                    const float2 position = tilePosition + offset;
+                    const float3 target   = GetCurvedWorldSpacePosition(
+                        camera.Position, float3(position.x, GetTerrainHeight(position) + horizonDesc.ContentHeight, position.y));
+
+                    if (!IsSegmentBlocked(camera.Position, target, x, z, heights))
+                    {
+                        return true;
+                    }
+                }
+
+                return false;
+            };
+
+            size_t chunkIndex = 0;
+
+            for (const ChunkRecord& frustumChunk : frustumChunks)
+            {
+                // records keep their order, thus removed chunks are found by walking both lists
+                const bool isRemoved = (chunkIndex >= chunks.size()) || (chunks[chunkIndex].chunkGridPosition.x != frustumChunk.chunkGridPosition.x) ||
+                                       (chunks[chunkIndex].chunkGridPosition.y != frustumChunk.chunkGridPosition.y);
+
+                for (uint32_t i = 0; i < TerrainTilesPerChunk * TerrainTilesPerChunk; ++i)
+                {
+                    const int2 tileGridPosition =
+                        int2(frustumChunk.chunkGridPosition.x * static_cast<int32_t>(TerrainTilesPerChunk) + static_cast<int32_t>(i % TerrainTilesPerChunk),
+                             frustumChunk.chunkGridPosition.y * static_cast<int32_t>(TerrainTilesPerChunk) + static_cast<int32_t>(i / TerrainTilesPerChunk));
+
+                    const bool isHidden = isRemoved ? IsTileInFrustum(camera.Position, clipPlanes, tileGridPosition)
+                                                    : (GetChunkTileBiome(chunks[chunkIndex].tileBiomes, i) == ChunkTileCulled);
+
+                    if (isHidden)
+                    {
+                        ++checkedTileCount;
+
+                        if (isTileVisible(tileGridPosition))
+                        {
+                            printf("Hidden tile (%d, %d) is visible at frame %u, camera (%.2f, %.2f, %.2f)\n",
+                                   tileGridPosition.x,
+                                   tileGridPosition.y,
+                                   frame,
+                                   camera.Position.x,
+                                   camera.Position.y,
+                                   camera.Position.z);
+                            ++visibleTileCount;
+                        }
+                    }
+                }
+
+                chunkIndex += isRemoved ? 0 : 1;
+            }
+
+            const WorldGraphFrame& frustumFrame = emulator.Execute(data, frustumChunks);
+
+            frustumMeshRecordCount += GetMeshRecordCount(frustumFrame);
+            frustumEmulatorTimeMs += frustumFrame.TimeMs;
+
+            const WorldGraphFrame& horizonFrame = emulator.Execute(data, chunks);
+
+            horizonMeshRecordCount += GetMeshRecordCount(horizonFrame);
+            horizonEmulatorTimeMs += horizonFrame.TimeMs;
+
+            ++verifiedFrameCount;
+        }
+
+        if ((((frame + 1) % reportInterval) == 0) || ((frame + 1) == frameCount))
+        {
+            const uint32_t    firstFrame = (frame / reportInterval) * reportInterval;
+            const std::string label      = std::to_string(firstFrame) + " - " + std::to_string(frame);
+
+            PrintHorizonStats(label.c_str(), frame + 1 - firstFrame, intervalStats);
+
+            AddHorizonStats(totalStats, intervalStats);
+            intervalStats = {};
+        }
+    }
+
+    printf("\n");
+    PrintHorizonStats("Total", frameCount, totalStats);
+
+    printf("\nHorizon culling removes %.2f%% of the chunk records & %.2f%% of the tiles inside the view frustum.\n",
+           (totalStats.ChunkCount > 0) ? 100.0 * totalStats.OccludedChunkCount / totalStats.ChunkCount : 0.0,
+           (totalStats.VisibleTileCount > 0) ? 100.0 * totalStats.OccludedTileCount / totalStats.VisibleTileCount : 0.0);
+
+    if (verifiedFrameCount > 0)
+    {
+        printf("Ground truth: %llu of %llu hidden tiles are visible from the camera (%u frames)\n",
+               static_cast<unsigned long long>(visibleTileCount),
+               static_cast<unsigned long long>(checkedTileCount),
+               verifiedFrameCount);
+        printf("Emulator: %.0f mesh records & %.1f ms per frame with frustum culling, %.0f mesh records (-%.2f%%) & %.1f ms with horizon culling\n",
+               static_cast<double>(frustumMeshRecordCount) / verifiedFrameCount,
+               frustumEmulatorTimeMs / verifiedFrameCount,
+               static_cast<double>(horizonMeshRecordCount) / verifiedFrameCount,
+               (frustumMeshRecordCount > 0) ? 100.0 * (1.0 - static_cast<double>(horizonMeshRecordCount) / frustumMeshRecordCount) : 0.0,
+               horizonEmulatorTimeMs / verifiedFrameCount);
+    }
+
+    return (visibleTileCount == 0) ? 0 : 1;
+}
+
+// Chunks, tiles & detailed tiles inside the view frustum with the fixed height range of the shaders & culled with their height bounds
+struct HeightBoundsStats
+{
+    uint64_t ChunkCount              = 0;
+    uint64_t CulledChunkCount        = 0;
+    uint64_t TileCount               = 0;
+    uint64_t CulledTileCount         = 0;
+    uint64_t DetailedTileCount       = 0;
+    uint64_t CulledDetailedTileCount = 0;
+    double   FixedTimeMs             = 0.0;
+    double   TimeMs                  = 0.0;
+};
+
+static void PrintHeightBoundsStats(const char* label, uint32_t frameCount, const HeightBoundsStats& stats)
+{
+    const double frames = std::max(frameCount, 1u);
+
+    const auto percent = [](uint64_t count, uint64_t total) { return (total > 0) ? 100.0 * count / total : 0.0; };
+
+    printf("%-13s %8.1f %8.1f %8.2f%% %9.1f %9.1f %8.2f%% %9.1f %9.1f %8.2f%% %8.3f %8.3f\n",
+           label,
+           stats.ChunkCount / frames,
+           stats.CulledChunkCount / frames,
+           percent(stats.CulledChunkCount, stats.ChunkCount),
+           stats.TileCount / frames,
+           stats.CulledTileCount / frames,
+           percent(stats.CulledTileCount, stats.TileCount),
+           stats.DetailedTileCount / frames,
+           stats.CulledDetailedTileCount / frames,
+           percent(stats.CulledDetailedTileCount, stats.DetailedTileCount),
+           stats.FixedTimeMs / frames,
+           stats.TimeMs / frames);
+}
+
+static void AddHeightBoundsStats(HeightBoundsStats& total, const HeightBoundsStats& stats)
+{
+    total.ChunkCount += stats.ChunkCount;
+    total.CulledChunkCount += stats.CulledChunkCount;
+    total.TileCount += stats.TileCount;
+    total.CulledTileCount += stats.CulledTileCount;
+    total.DetailedTileCount += stats.DetailedTileCount;
+    total.CulledDetailedTileCount += stats.CulledDetailedTileCount;
+    total.FixedTimeMs += stats.FixedTimeMs;
+    total.TimeMs += stats.TimeMs;
+}
+
+static int Bounds(const char* pathName, uint32_t frameCount, uint32_t verifyFrameCount)
+{
+    static const float    FlightSpeed               = 20.f;
+    static const uint32_t DetailedTileCountPerTile  = TerrainDetailedTilesPerTile * TerrainDetailedTilesPerTile;
+    static const uint32_t TileCountPerChunk         = TerrainTilesPerChunk * TerrainTilesPerChunk;
+    // spacing of the terrain samples of the ground truth, within a tile & within a detailed tile
+    static const uint32_t TileSampleCount         = 17;
+    static const uint32_t DetailedTileSampleCount = 9;
+
+    std::vector<FlythroughFrame> flythroughFrames;
+
+    if (std::string(pathName) != "flight")
+    {
+        if (!LoadFlythroughFrames(pathName, flythroughFrames))
+        {
+            return 1;
+        }
+
+        frameCount = (frameCount > 0) ? std::min(frameCount, static_cast<uint32_t>(flythroughFrames.size())) : static_cast<uint32_t>(flythroughFrames.size());
+    }
+    else if (frameCount == 0)
+    {
+        frameCount = 1800;
+    }
+
+    ChunkMetadataCache cache(ChunkMetadataCacheDesc{});
+
+    // both cullers share the cache, the height bounds are sampled once per chunk
+    ChunkCullingDesc fixedDesc = {};
+    fixedDesc.pMetadataCache   = &cache;
+
+    ChunkCullingDesc boundsDesc = fixedDesc;
+    boundsDesc.UseHeightBounds  = true;
+
+    ChunkCuller fixedCuller(fixedDesc);
+    ChunkCuller boundsCuller(boundsDesc);
+
+    WorldGraphDesc     graphDesc = {};
+    WorldGraphEmulator emulator(graphDesc);
+
+    const float detailedTileDistance = std::max(graphDesc.Quality.FlowerMaxDistance, graphDesc.Quality.DenseGrassMaxDistance + DetailedTileSize * 2.f);
+
+    printf("Path: %s, frames: %u, content height: %g m, detailed tile heights: %g to %g m, detailed tiles up to %g m\n\n",
+           pathName,
+           frameCount,
+           TerrainContentHeight,
+           DetailedTileMinHeightOffset,
+           DetailedTileMaxHeightOffset,
+           detailedTileDistance);
+    printf("%-13s %8s %8s %9s %9s %9s %9s %9s %9s %9s %8s %8s\n",
+           "Frames",
+           "Chunks",
+           "Culled",
+           "Culled",
+           "Tiles",
+           "Culled",
+           "Culled",
+           "Detailed",
+           "Culled",
+           "Culled",
+           "Fixed ms",
+           "Tight ms");
+
+    const uint32_t reportInterval = 60;
+    const uint32_t verifyInterval = std::max(frameCount / std::max(verifyFrameCount, 1u), 1u);
+
+    HeightBoundsStats  intervalStats, totalStats;
+    std::vector<int2>  detailedTiles;
+    std::vector<float> x, z, heights;
+
+    uint32_t verifiedFrameCount = 0;
+    uint64_t checkedTileCount = 0, visibleTileCount = 0, checkedDetailedTileCount = 0, exceededDetailedTileCount = 0;
+    float    minDetailedHeightOffset = 0.f, maxDetailedHeightOffset = 0.f;
+    uint64_t fixedMeshRecordCount = 0, boundsMeshRecordCount = 0;
+    double   fixedEmulatorTimeMs = 0.0, boundsEmulatorTimeMs = 0.0;
+
+    for (uint32_t frame = 0; frame < frameCount; ++frame)
+    {
+        WorldGraphCamera camera = {};
+
+        if (flythroughFrames.empty())
+        {
+            camera = GetFlightCamera(frame * (1.f / 60.f), FlightSpeed);
+        }
+        else
+        {
+            camera.Position = flythroughFrames[frame].Position;
+            camera.Yaw      = flythroughFrames[frame].Yaw;
+            camera.Pitch    = flythroughFrames[frame].Pitch;
+        }
+
+        const WorkGraphCBData data       = CreateWorkGraphCBData(camera);
+        const ClipPlanes      clipPlanes = ComputeClipPlanes(data.ViewProjection);
+        const float2          cameraXZ   = float2(camera.Position.x, camera.Position.z);
+
+        cache.BeginFrame(camera.Position);
+
+        const std::vector<ChunkRecord>& fixedChunks  = fixedCuller.Cull(data);
+        const std::vector<ChunkRecord>& boundsChunks = boundsCuller.Cull(data);
+
+        const ChunkCullingStats& cullingStats = boundsCuller.GetStats();
+
+        intervalStats.ChunkCount += fixedChunks.size();
+        intervalStats.CulledChunkCount += cullingStats.BoundsCulledChunkCount;
+        intervalStats.TileCount += cullingStats.FrustumTileCount;
+        intervalStats.CulledTileCount += cullingStats.BoundsCulledTileCount;
+        intervalStats.FixedTimeMs += fixedCuller.GetStats().TimeMs;
+        intervalStats.TimeMs += cullingStats.TimeMs;
+
+        // Detailed tiles of the woodland & grassland tiles that are close enough for dense grass or flowers, the only content gated by
+        // the detailed tile bounding box
+        detailedTiles.clear();
+
+        for (const ChunkRecord& chunk : boundsChunks)
+        {
+            for (uint32_t i = 0; i < TileCountPerChunk; ++i)
+            {
+                const uint32_t biome = GetChunkTileBiome(chunk.tileBiomes, i);
+
+                if ((biome == 0) || (biome == ChunkTileCulled))
+                {
+                    continue;
+                }
+
+                const int2 tileGridPosition =
+                    int2(chunk.chunkGridPosition.x * static_cast<int32_t>(TerrainTilesPerChunk) + static_cast<int32_t>(i % TerrainTilesPerChunk),
+                         chunk.chunkGridPosition.y * static_cast<int32_t>(TerrainTilesPerChunk) + static_cast<int32_t>(i / TerrainTilesPerChunk));
+
+                for (uint32_t j = 0; j < DetailedTileCountPerTile; ++j)
+                {
+                    const int2 detailedTileGridPosition =
+                        int2(tileGridPosition.x * static_cast<int32_t>(TerrainDetailedTilesPerTile) + static_cast<int32_t>(j % TerrainDetailedTilesPerTile),
+                             tileGridPosition.y * static_cast<int32_t>(TerrainDetailedTilesPerTile) + static_cast<int32_t>(j / TerrainDetailedTilesPerTile));
+                    const float2 center = (float2(static_cast<float>(detailedTileGridPosition.x), static_cast<float>(detailedTileGridPosition.y)) + float2(0.5f)) *
+                                          DetailedTileSize;
+
+                    if (length(center - cameraXZ) < detailedTileDistance)
+                    {
+                        detailedTiles.push_back(detailedTileGridPosition);
+                    }
+                }
+            }
+        }
+
+        x.resize(detailedTiles.size());
+        z.resize(detailedTiles.size());
+        heights.resize(detailedTiles.size());
+
+        for (size_t i = 0; i < detailedTiles.size(); ++i)
+        {
+            x[i] = (static_cast<float>(detailedTiles[i].x) + 0.5f) * DetailedTileSize;
+            z[i] = (static_cast<float>(detailedTiles[i].y) + 0.5f) * DetailedTileSize;
+        }
+
+        GetTerrainHeightBatch(x.data(), z.data(), heights.data(), detailedTiles.size());
+
+        for (size_t i = 0; i < detailedTiles.size(); ++i)
+        {
+            const float2 minPosition = float2(static_cast<float>(detailedTiles[i].x), static_cast<float>(detailedTiles[i].y)) * DetailedTileSize;
+            const float2 maxPosition = minPosition + float2(DetailedTileSize);
+
+            const float3 fixedMin = GetCurvedWorldSpacePosition(camera.Position, float3(minPosition.x, 0.f, minPosition.y)) + float3(0.f, TerrainChunkMinHeight, 0.f);
+            const float3 fixedMax = GetCurvedWorldSpacePosition(camera.Position, float3(maxPosition.x, 0.f, maxPosition.y)) + float3(0.f, TerrainChunkMaxHeight, 0.f);
+
+            if (!IsBoxInFrustum(clipPlanes, fixedMin, fixedMax))
+            {
+                continue;
+            }
+
+            ++intervalStats.DetailedTileCount;
+
+            // same as GetCurvedGridBoundingBox in common.hlsl
+            const float minHeight = heights[i] + DetailedTileMinHeightOffset;
+            const float maxHeight = heights[i] + DetailedTileMaxHeightOffset;
+
+            float3 boxMin = float3(std::numeric_limits<float>::max());
+            float3 boxMax = float3(-std::numeric_limits<float>::max());
+            for (uint32_t corner = 0; corner < 4; ++corner)
+            {
+                const float2 cornerPosition = float2((corner & 1) ? maxPosition.x : minPosition.x, (corner & 2) ? maxPosition.y : minPosition.y);
+
+                const float3 low  = GetCurvedWorldSpacePosition(camera.Position, float3(cornerPosition.x, minHeight, cornerPosition.y));
+                const float3 high = GetCurvedWorldSpacePosition(camera.Position, float3(cornerPosition.x, maxHeight, cornerPosition.y));
+
+                boxMin = min(boxMin, min(low, high));
+                boxMax = max(boxMax, max(low, high));
+            }
+
+            if (!IsBoxInFrustum(clipPlanes, boxMin, boxMax))
+            {
+                ++intervalStats.CulledDetailedTileCount;
+            }
+        }
+
+        if ((verifiedFrameCount < verifyFrameCount) && ((frame % verifyInterval) == 0))
+        {
+            // Culled tiles are checked on a grid of terrain samples, each with a segment up to the tallest content
+            const auto isTileVisible = [&](const int2& tileGridPosition) {
+                const float2 tilePosition = float2(static_cast<float>(tileGridPosition.x), static_cast<float>(tileGridPosition.y)) * TileSize;
+                const float  spacing      = TileSize / (TileSampleCount - 1);
+
+                x.resize(TileSampleCount * TileSampleCount);
+                z.resize(x.size());
+                heights.resize(x.size());
+
+                for (uint32_t i = 0; i < x.size(); ++i)
+                {
+                    x[i] = tilePosition.x + (i % TileSampleCount) * spacing;
+                    z[i] = tilePosition.y + (i / TileSampleCount) * spacing;
+                }
+
+                GetTerrainHeightBatch(x.data(), z.data(), heights.data(), x.size());
+
+                for (uint32_t i = 0; i < x.size(); ++i)
+                {
+                    const float3 bottom = GetCurvedWorldSpacePosition(camera.Position, float3(x[i], heights[i], z[i]));
+                    const float3 top    = GetCurvedWorldSpacePosition(camera.Position, float3(x[i], heights[i] + TerrainContentHeight, z[i]));
+
+                    if (IsBoxInFrustum(clipPlanes, min(bottom, top), max(bottom, top)))
+                    {
+                        return true;
+                    }
+                }
+
+                return false;
+            };
+
+            size_t chunkIndex = 0;
+
+            for (const ChunkRecord& fixedChunk : fixedChunks)
+            {
+                // records keep their order, thus removed chunks are found by walking both lists
+                const bool isRemoved = (chunkIndex >= boundsChunks.size()) || (boundsChunks[chunkIndex].chunkGridPosition.x != fixedChunk.chunkGridPosition.x) ||
+                                       (boundsChunks[chunkIndex].chunkGridPosition.y != fixedChunk.chunkGridPosition.y);
+
+                for (uint32_t i = 0; i < TileCountPerChunk; ++i)
+                {
+                    const int2 tileGridPosition =
+                        int2(fixedChunk.chunkGridPosition.x * static_cast<int32_t>(TerrainTilesPerChunk) + static_cast<int32_t>(i % TerrainTilesPerChunk),
+                             fixedChunk.chunkGridPosition.y * static_cast<int32_t>(TerrainTilesPerChunk) + static_cast<int32_t>(i / TerrainTilesPerChunk));
+
+                    const bool isCulled = isRemoved || (GetChunkTileBiome(boundsChunks[chunkIndex].tileBiomes, i) == ChunkTileCulled);
+
+                    if (!isCulled || !IsTileInFrustum(camera.Position, clipPlanes, tileGridPosition))
+                    {
+                        continue;
+                    }
+
+                    ++checkedTileCount;
+
+                    if (isTileVisible(tileGridPosition))
+                    {
+                        printf("Culled tile (%d, %d) is visible at frame %u, camera (%.2f, %.2f, %.2f)\n",
+                               tileGridPosition.x,
+                               tileGridPosition.y,
+                               frame,
+                               camera.Position.x,
+                               camera.Position.y,
+                               camera.Position.z);
+                        ++visibleTileCount;
+                    }
+                }
+
+                chunkIndex += isRemoved ? 0 : 1;
+            }
+
+            // The detailed tile height range must contain the terrain of the whole detailed tile
+            for (const int2& detailedTile : detailedTiles)
+            {
+                const float2 tilePosition = float2(static_cast<float>(detailedTile.x), static_cast<float>(detailedTile.y)) * DetailedTileSize;
+                const float  spacing      = DetailedTileSize / (DetailedTileSampleCount - 1);
+                const float  centerHeight = GetTerrainHeight(tilePosition + float2(DetailedTileSize * 0.5f));
+
+                x.resize(DetailedTileSampleCount * DetailedTileSampleCount);
+                z.resize(x.size());
+                heights.resize(x.size());
+
+                for (uint32_t i = 0; i < x.size(); ++i)
+                {
+                    x[i] = tilePosition.x + (i % DetailedTileSampleCount) * spacing;
+                    z[i] = tilePosition.y + (i / DetailedTileSampleCount) * spacing;
+                }
+
+                GetTerrainHeightBatch(x.data(), z.data(), heights.data(), x.size());
+
+                float minOffset = 0.f, maxOffset = 0.f;
+
+                for (const float height : heights)
+                {
+                    minOffset = std::min(minOffset, height - centerHeight);
+                    maxOffset = std::max(maxOffset, height - centerHeight);
+                }
+
+                minDetailedHeightOffset = std::min(minDetailedHeightOffset, minOffset);
+                maxDetailedHeightOffset = std::max(maxDetailedHeightOffset, maxOffset);
+
+                ++checkedDetailedTileCount;
+
+                // grass & flowers are below one meter
+                if ((minOffset < DetailedTileMinHeightOffset) || ((maxOffset + 1.f) > DetailedTileMaxHeightOffset))
+                {
+                    ++exceededDetailedTileCount;
+                }
+            }
+
+            const WorldGraphFrame& fixedFrame = emulator.Execute(data, fixedChunks);
+
+            fixedMeshRecordCount += GetMeshRecordCount(fixedFrame);
+            fixedEmulatorTimeMs += fixedFrame.TimeMs;
+
+            const WorldGraphFrame& boundsFrame = emulator.Execute(data, boundsChunks);
+
+            boundsMeshRecordCount += GetMeshRecordCount(boundsFrame);
+            boundsEmulatorTimeMs += boundsFrame.TimeMs;
+
+            ++verifiedFrameCount;
+        }
+
+        if ((((frame + 1) % reportInterval) == 0) || ((frame + 1) == frameCount))
+        {
+            const uint32_t    firstFrame = (frame / reportInterval) * reportInterval;
+            const std::string label      = std::to_string(firstFrame) + " - " + std::to_string(frame);
+
+            PrintHeightBoundsStats(label.c_str(), frame + 1 - firstFrame, intervalStats);
+
+            AddHeightBoundsStats(totalStats, intervalStats);
+            intervalStats = {};
+        }
+    }
+
+    printf("\n");
+    PrintHeightBoundsStats("Total", frameCount, totalStats);
+
+    printf("\nHeight bounds cull %.2f%% of the chunks, %.2f%% of the tiles & %.2f%% of the detailed tiles inside the view frustum with the fixed "
+           "height range.\n",
+           (totalStats.ChunkCount > 0) ? 100.0 * totalStats.CulledChunkCount / totalStats.ChunkCount : 0.0,
+           (totalStats.TileCount > 0) ? 100.0 * totalStats.CulledTileCount / totalStats.TileCount : 0.0,
+           (totalStats.DetailedTileCount > 0) ? 100.0 * totalStats.CulledDetailedTileCount / totalStats.DetailedTileCount : 0.0);
+
+    if (verifiedFrameCount > 0)
+    {
+        printf("Ground truth: %llu of %llu culled tiles are visible from the camera (%u frames)\n",
+               static_cast<unsigned long long>(visibleTileCount),
+               static_cast<unsigned long long>(checkedTileCount),
+               verifiedFrameCount);
+        printf("Detailed tiles: terrain %.2f to %.2f m around the center height, %llu of %llu exceed the height range\n",
+               minDetailedHeightOffset,
+               maxDetailedHeightOffset,
+               static_cast<unsigned long long>(exceededDetailedTileCount),
+               static_cast<unsigned long long>(checkedDetailedTileCount));
+        printf("Emulator: %.0f mesh records & %.1f ms per frame with the fixed height range, %.0f mesh records (-%.2f%%) & %.1f ms with height bounds\n",
+               static_cast<double>(fixedMeshRecordCount) / verifiedFrameCount,
+               fixedEmulatorTimeMs / verifiedFrameCount,
+               static_cast<double>(boundsMeshRecordCount) / verifiedFrameCount,
+               (fixedMeshRecordCount > 0) ? 100.0 * (1.0 - static_cast<double>(boundsMeshRecordCount) / fixedMeshRecordCount) : 0.0,
+               boundsEmulatorTimeMs / verifiedFrameCount);
+    }
+
+    return ((visibleTileCount == 0) && (exceededDetailedTileCount == 0)) ? 0 : 1;
+}
+
+// Record structs before the quantized encodings of shaders/recordencoding.h, for the size comparison of "records"
+struct UnquantizedDrawSplineRecord
+{
+    uint3    DispatchGrid;
+    float3   Color[maxSplinesPerRecord];
+    float    RotationOffset[maxSplinesPerRecord];
+    float2   WindStrength[maxSplinesPerRecord];
+    uint32_t ControlPointCount[maxSplinesPerRecord];
+    float3   ControlPointPositions[maxSplinesPerRecord * splineMaxControlPointCount];
+    uint32_t ControlPointVertexCounts[maxSplinesPerRecord * splineMaxControlPointCount];
+    float2   ControlPointRadii[maxSplinesPerRecord * splineMaxControlPointCount];
+    float    ControlPointNoiseAmplitudes[maxSplinesPerRecord * splineMaxControlPointCount];
+};
+
+struct UnquantizedDrawInsectRecord
+{
+    uint3  DispatchGrid;
+    float3 Position[maxInsectsPerRecord];
+};
+
+struct UnquantizedDrawMushroomRecord
+{
+    uint3  DispatchGrid;
+    float3 Position[maxMushroomsPerRecord];
+};
+
+struct UnquantizedDrawFlowerRecord
+{
+    uint3    DispatchGrid;
+    uint32_t FlowerPatchCount;
+    float2   Position[maxFlowersPerRecord];
+};
+
+struct UnquantizedDrawDenseGrassRecord
+{
+    uint3    DispatchGrid;
+    float3   Position[maxDenseGrassPatchesPerRecord];
+    float    Height[maxDenseGrassPatchesPerRecord];
+    uint32_t BladeOffset[maxDenseGrassPatchesPerRecord];
+};
+
+struct UnquantizedDrawSparseGrassRecord
+{
+    uint3 DispatchGrid;
+    int2  Position[maxSparseGrassPatchesPerRecord];
+};
+
+static size_t GetUnquantizedRecordSize(WorldGraphNode node)
+{
+    switch (node)
+    {
+    case WorldGraphNode::DrawSpline:
+        return sizeof(UnquantizedDrawSplineRecord);
+    case WorldGraphNode::DrawSparseGrassPatch:
+        return sizeof(UnquantizedDrawSparseGrassRecord);
+    case WorldGraphNode::DrawDenseGrassPatch:
+        return sizeof(UnquantizedDrawDenseGrassRecord);
+    case WorldGraphNode::DrawMushroomPatch:
+        return sizeof(UnquantizedDrawMushroomRecord);
+    case WorldGraphNode::DrawFlowerPatch:
+    case WorldGraphNode::DrawSparseFlowerPatch:
+        return sizeof(UnquantizedDrawFlowerRecord);
+    case WorldGraphNode::DrawBees:
+    case WorldGraphNode::DrawButterflies:
+        return sizeof(UnquantizedDrawInsectRecord);
+    default:
+        return GetWorldGraphNodeInfo(node).RecordSize;
+    }
+}
+
+// Largest encoded position components of a mesh node, in fixed point units
+struct RecordPositionRange
+{
+    int32_t  MaxOffset      = 0;
+    int32_t  MaxHeight      = 0;
+    uint64_t SaturatedCount = 0;
+
+    void Add(int16_t x, int16_t z)
+    {
+        MaxOffset = std::max({MaxOffset, std::abs(static_cast<int32_t>(x)), std::abs(static_cast<int32_t>(z))});
+        SaturatedCount += (std::abs(static_cast<int32_t>(x)) >= RECORD_FIXED_POINT_MAX) + (std::abs(static_cast<int32_t>(z)) >= RECORD_FIXED_POINT_MAX);
+    }
+
+    void Add(const int16_t2& position)
+    {
+        Add(position.x, position.y);
+    }
+
+    void Add(const int16_t3& position)
+    {
+        Add(position.x, position.z);
+
+        MaxHeight = std::max(MaxHeight, std::abs(static_cast<int32_t>(position.y)));
+        SaturatedCount += std::abs(static_cast<int32_t>(position.y)) >= RECORD_FIXED_POINT_MAX;
+    }
+
+    template <typename T, size_t N>
+    void Add(const T (&positions)[N])
+    {
+        // unused entries are zero & do not change the range
+        for (const T& position : positions)
+        {
+            Add(position);
+        }
+    }
+};
+
+// Mesh nodes with fixed point positions. Sparse grass positions are detailed tile offsets to the tile origin.
+static bool HasFixedPointPositions(WorldGraphNode node)
+{
+    return (GetWorldGraphNodeInfo(node).Launch == WorldGraphLaunch::Mesh) && (node != WorldGraphNode::DrawTerrainChunk) &&
+           (node != WorldGraphNode::DrawSparseGrassPatch);
+}
+
+static void AddRecordPositions(WorldGraphNode node, const void* pRecord, RecordPositionRange& range)
+{
+    switch (node)
+    {
+    case WorldGraphNode::DrawSpline:
+        range.Add(static_cast<const DrawSplineRecord*>(pRecord)->controlPointPositions);
+        break;
+    case WorldGraphNode::DrawDenseGrassPatch:
+        range.Add(static_cast<const DrawDenseGrassRecord*>(pRecord)->position);
+        break;
+    case WorldGraphNode::DrawMushroomPatch:
+        range.Add(static_cast<const DrawMushroomRecord*>(pRecord)->position);
+        break;
+    case WorldGraphNode::DrawFlowerPatch:
+    case WorldGraphNode::DrawSparseFlowerPatch:
+        range.Add(static_cast<const DrawFlowerRecord*>(pRecord)->position);
+        break;
+    case WorldGraphNode::DrawBees:
+    case WorldGraphNode::DrawButterflies:
+        range.Add(static_cast<const DrawInsectRecord*>(pRecord)->position);
+        break;
+    default:
+        break;
+    }
+}
+
+// Round-trip tests of the encodings in shaders/recordencoding.h, returns the number of failed tests
+static uint32_t TestRecordEncodings(size_t count)
+{
+    std::mt19937                          random(7);
+    std::uniform_real_distribution<float> origin(-5000.f, 5000.f);
+    std::uniform_real_distribution<float> offset(-63.9f, 63.9f);
+    std::uniform_real_distribution<float> height(-511.f, 511.f);
+    std::uniform_real_distribution<float> unit(0.f, 1.f);
+    std::uniform_real_distribution<float> exponent(-24.f, 15.9f);
+
+    uint32_t failedCount = 0;
+
+    const auto report = [&failedCount](const char* name, double maxError, double bound, uint64_t failures) {
+        printf("%-28s %14.3e %14.3e %10llu  %s\n", name, maxError, bound, static_cast<unsigned long long>(failures), failures ? "FAIL" : "ok");
+        failedCount += failures ? 1 : 0;
+    };
+
+    printf("%-28s %14s %14s %10s\n", "Encoding", "Max error", "Bound", "Failures");
+
+    // positions, xz relative to the origin & absolute y. The bound includes the float rounding of origin + offset.
+    {
+        double   maxOffsetError = 0.0, maxHeightError = 0.0;
+        uint64_t offsetFailures = 0, heightFailures = 0;
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            const float2 positionOrigin = float2(origin(random), origin(random));
+            const float3 position       = float3(positionOrigin.x + offset(random), height(random), positionOrigin.y + offset(random));
+            const float3 decoded        = DecodeRecordPosition(EncodeRecordPosition(position, positionOrigin), positionOrigin);
+            const float2 decodedXZ      = DecodeRecordPosition(EncodeRecordPosition(float2(position.x, position.z), positionOrigin), positionOrigin);
+
+            const double offsetError = std::max({std::abs(decoded.x - position.x),
+                                                 std::abs(decoded.z - position.z),
+                                                 std::abs(decodedXZ.x - position.x),
+                                                 std::abs(decodedXZ.y - position.z)});
+            const double heightError = std::abs(decoded.y - position.y);
+            const double offsetBound = 0.5 / RECORD_OFFSET_SCALE + 2.0 * FLT_EPSILON * std::max(std::abs(position.x), std::abs(position.z));
+            const double heightBound = 0.5 / RECORD_HEIGHT_SCALE + FLT_EPSILON * std::abs(position.y);
+
+            maxOffsetError = std::max(maxOffsetError, offsetError);
+            maxHeightError = std::max(maxHeightError, heightError);
+            offsetFailures += offsetError > offsetBound;
+            heightFailures += heightError > heightBound;
+        }
+
+        report("Position xz offset (m)", maxOffsetError, 0.5 / RECORD_OFFSET_SCALE, offsetFailures);
+        report("Position y (m)", maxHeightError, 0.5 / RECORD_HEIGHT_SCALE, heightFailures);
+
+        // out of range values saturate instead of wrapping around
+        const int16_t3 saturated        = EncodeRecordPosition(float3(100.f, -1000.f, -100.f), float2(0.f, 0.f));
+        const bool     saturationPassed = (saturated.x == 32767) && (saturated.y == -32767) && (saturated.z == -32767);
+
+        report("Position saturation", 0.0, 0.0, saturationPassed ? 0 : 1);
+    }
+
+    // half precision, every half value round-trips & float values are rounded to nearest
+    {
+        uint64_t exhaustiveFailures = 0;
+
+        for (uint32_t value = 0; value < 0x10000; ++value)
+        {
+            const bool isNaN = ((value & 0x7C00u) == 0x7C00u) && ((value & 0x3FFu) != 0);
+
+            exhaustiveFailures += !isNaN && (EncodeHalf(DecodeHalf(static_cast<uint16_t>(value))) != value);
+        }
+
+        report("Half round trip (all)", 0.0, 0.0, exhaustiveFailures);
+
+        double   maxRelativeError = 0.0, maxDenormalError = 0.0;
+        uint64_t relativeFailures = 0, denormalFailures = 0;
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            const float value   = std::exp2(exponent(random)) * ((i % 2) ? -1.f : 1.f) * (1.f + unit(random));
+            const float decoded = DecodeHalf(EncodeHalf(value));
+
+            if (std::abs(value) > 65504.f)
+            {
+                continue;
+            }
+
+            if (std::abs(value) >= std::exp2(-14.f))
+            {
+                const double error = std::abs(decoded - value) / std::abs(value);
+
+                maxRelativeError = std::max(maxRelativeError, error);
+                relativeFailures += error > std::exp2(-11.0);
+            }
+            else
+            {
+                const double error = std::abs(decoded - value);
+
+                maxDenormalError = std::max(maxDenormalError, error);
+                denormalFailures += error > std::exp2(-25.0);
+            }
+        }
+
+        report("Half relative", maxRelativeError, std::exp2(-11.0), relativeFailures);
+        report("Half denormal absolute", maxDenormalError, std::exp2(-25.0), denormalFailures);
+    }
+
+    // vertex counts, every count at every control point next to random counts
+    {
+        std::uniform_int_distribution<uint32_t> vertexCount(0, 255);
+
+        uint64_t failures = 0;
+
+        for (uint32_t controlPoint = 0; controlPoint < splineMaxControlPointCount; ++controlPoint)
+        {
+            for (uint32_t value = 0; value < 256; ++value)
+            {
+                uint32_t counts[splineMaxControlPointCount];
+                for (uint32_t& c : counts)
+                {
+                    c = vertexCount(random);
+                }
+                counts[controlPoint] = value;
+
+                const uint2 packedCounts = uint2(EncodeVertexCounts(counts[0], counts[1], counts[2], counts[3]),
+                                                 EncodeVertexCounts(counts[4], counts[5], counts[6], counts[7]));
+
+                for (uint32_t i = 0; i < splineMaxControlPointCount; ++i)
+                {
+                    failures += DecodeVertexCount(packedCounts, i) != counts[i];
+                }
+            }
+        }
+
+        report("Vertex counts", 0.0, 0.0, failures);
+    }
+
+    // dense grass patch height & blade offset
+    {
+        const double bound    = 0.5 / 32767.0 + FLT_EPSILON;
+        double       maxError = 0.0;
+        uint64_t     failures = 0;
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            const float    grassHeight = unit(random);
+            const uint32_t bladeOffset = static_cast<uint32_t>(i % 2);
+            const uint16_t patch       = EncodeDenseGrassPatch(grassHeight, bladeOffset);
+            const double   error       = std::abs(DecodeDenseGrassPatchHeight(patch) - grassHeight);
+
+            maxError = std::max(maxError, error);
+            failures += (error > bound) || (DecodeDenseGrassPatchBladeOffset(patch) != bladeOffset);
+        }
+
+        report("Dense grass patch height (m)", maxError, bound, failures);
+    }
+
+    return failedCount;
+}
+
+static int Records(size_t count, uint32_t poseCount, uint32_t threadCount)
+{
+    printf("Record sizes, worst case = NodeMaxInputRecordsPerGraphEntryRecord * record size\n\n");
+    printf("%-22s %10s %10s %8s %16s %16s\n", "Node", "Before B", "After B", "Ratio", "Worst case KiB", "Worst case KiB");
+
+    for (uint32_t i = 0; i < WorldGraphNodeCount; ++i)
+    {
+        const WorldGraphNode      node = static_cast<WorldGraphNode>(i);
+        const WorldGraphNodeInfo& info = GetWorldGraphNodeInfo(node);
+
+        if (info.Launch != WorldGraphLaunch::Mesh)
+        {
+            continue;
+        }
+
+        const size_t unquantizedSize = GetUnquantizedRecordSize(node);
+
+        printf("%-22s %10zu %10zu %7.2fx %16.1f %16.1f\n",
+               info.NodeId,
+               unquantizedSize,
+               info.RecordSize,
+               static_cast<double>(unquantizedSize) / info.RecordSize,
+               info.MaxInputRecords * unquantizedSize / 1024.0,
+               info.MaxInputRecords * info.RecordSize / 1024.0);
+    }
+
+    printf("\n");
+
+    const uint32_t failedTestCount = TestRecordEncodings(count);
+
+    WorldGraphDesc desc = {};
+    desc.ThreadCount    = threadCount;
+
+    WorldGraphEmulator emulator(desc);
+
+    printf("\nWorkers: %u, camera poses: %u\n\n", emulator.GetThreadCount(), poseCount);
+
+    RecordPositionRange ranges[WorldGraphNodeCount];
+    uint64_t            recordCounts[WorldGraphNodeCount] = {};
+    uint64_t            unquantizedBytes = 0, quantizedBytes = 0, maxUnquantizedBytes = 0, maxQuantizedBytes = 0;
+
+    for (const WorldGraphCamera& camera : GenerateLimitPoses(poseCount, 4))
+    {
+        const WorldGraphFrame& frame = emulator.Execute(CreateWorkGraphCBData(camera));
+
+        uint64_t frameUnquantizedBytes = 0, frameQuantizedBytes = 0;
+
+        for (uint32_t i = 0; i < WorldGraphNodeCount; ++i)
+        {
+            const WorldGraphNode node = static_cast<WorldGraphNode>(i);
+
+            if (GetWorldGraphNodeInfo(node).Launch != WorldGraphLaunch::Mesh)
+            {
+                continue;
+            }
+
+            if (HasFixedPointPositions(node))
+            {
+                for (const void* pRecord : frame.Records[i])
+                {
+                    AddRecordPositions(node, pRecord, ranges[i]);
+                }
+            }
+
+            recordCounts[i] += frame.Records[i].size();
+            frameUnquantizedBytes += frame.Records[i].size() * GetUnquantizedRecordSize(node);
+            frameQuantizedBytes += frame.Records[i].size() * GetWorldGraphNodeInfo(node).RecordSize;
+        }
+
+        unquantizedBytes += frameUnquantizedBytes;
+        quantizedBytes += frameQuantizedBytes;
+        maxUnquantizedBytes = std::max(maxUnquantizedBytes, frameUnquantizedBytes);
+        maxQuantizedBytes   = std::max(maxQuantizedBytes, frameQuantizedBytes);
+    }
+
+    // headroom of the encoded positions, offsets are limited to +-64 m & heights to +-512 m
+    printf("%-22s %10s %12s %12s %10s\n", "Node", "Records", "Max |xz| m", "Max |y| m", "Saturated");
+
+    uint64_t saturatedCount = 0;
+
+    for (uint32_t i = 0; i < WorldGraphNodeCount; ++i)
+    {
+        const WorldGraphNode node = static_cast<WorldGraphNode>(i);
+
+        if (!HasFixedPointPositions(node))
+        {
+            continue;
+        }
+
+        printf("%-22s %10llu %12.3f %12.3f %10llu\n",
+               GetWorldGraphNodeInfo(node).NodeId,
+               static_cast<unsigned long long>(recordCounts[i]),
+               ranges[i].MaxOffset / RECORD_OFFSET_SCALE,
+               ranges[i].MaxHeight / RECORD_HEIGHT_SCALE,
+               static_cast<unsigned long long>(ranges[i].SaturatedCount));
+
+        saturatedCount += ranges[i].SaturatedCount;
+    }
+
+    const double poses = std::max(poseCount, 1u);
+
+    printf("\nMesh record bytes per frame: %.1f KiB -> %.1f KiB (%.2fx), worst frame: %.1f KiB -> %.1f KiB\n",
+           unquantizedBytes / poses / 1024.0,
+           quantizedBytes / poses / 1024.0,
+           static_cast<double>(unquantizedBytes) / std::max<uint64_t>(quantizedBytes, 1),
+           maxUnquantizedBytes / 1024.0,
+           maxQuantizedBytes / 1024.0);
+
+    if (failedTestCount > 0)
+    {
+        printf("%u encoding tests failed\n", failedTestCount);
+    }
+    if (saturatedCount > 0)
+    {
+        printf("%llu encoded position components saturated\n", static_cast<unsigned long long>(saturatedCount));
+    }
+
+    return ((failedTestCount == 0) && (saturatedCount == 0)) ? 0 : 1;
+}
+
+// ==================
+// Spline splitting
+
+struct SplineValidationStats
+{
+    uint64_t SplineCount = 0;
+    // non-empty splines, i.e. pieces of split splines
+    uint64_t PieceCount        = 0;
+    uint64_t ClampedCount      = 0;
+    uint64_t LostVertexCount   = 0;
+    uint64_t LostTriangleCount = 0;
+    // triangles of all pieces, before clamping
+    uint64_t TriangleCount = 0;
+    // continuation pieces whose first ring differs from the last ring of the previous piece
+    uint64_t SeamErrorCount = 0;
+    // pieces ending with a direction-only control point without a continuation piece, i.e. pieces dropped by the generator
+    uint64_t DroppedPieceCount = 0;
+    // triangles referencing vertices outside of the vertices output by the mesh shader
+    uint64_t InvalidTriangleCount = 0;
+    // pieces whose DrawSplineRecord::ringPrefixSums differ from ComputeSplinePrefixSums, or whose output vertices or triangles
+    // looked up with the prefix sums differ from those of the ring loop
+    uint64_t TopologyMismatchCount = 0;
+};
+
+// Tessellates a piece with SplineTopology::PrefixSums & compares the output vertices & triangles to those of the ring loop
+static bool IsSameTopology(const DrawSplineRecord& record, uint32_t splineIndex, const SplineMesh& ringLoopMesh, SplineMesh& prefixSumMesh)
+{
+    const uint4& prefixSums         = record.ringPrefixSums[splineIndex];
+    const uint4  expectedPrefixSums = ComputeSplinePrefixSums(record.controlPointVertexCounts[splineIndex], record.controlPointCount[splineIndex]);
+
+    if ((prefixSums.x != expectedPrefixSums.x) || (prefixSums.y != expectedPrefixSums.y) || (prefixSums.z != expectedPrefixSums.z) ||
+        (prefixSums.w != expectedPrefixSums.w))
+    {
+        return false;
+    }
+
+    TessellateSpline(record, splineIndex, prefixSumMesh, SplineTopology::PrefixSums);
+
+    const uint32_t outputVertexCount   = std::min(ringLoopMesh.VertexCount, splineMeshMaxVertexCount);
+    const uint32_t outputTriangleCount = std::min(ringLoopMesh.TriangleCount, splineMeshMaxTriangleCount);
+
+    if ((prefixSumMesh.Vertices.size() != outputVertexCount) || (prefixSumMesh.Triangles.size() != outputTriangleCount))
+    {
+        return false;
+    }
+
+    for (uint32_t i = 0; i < outputVertexCount; ++i)
+    {
+        if (!IsBitIdentical(ringLoopMesh.Vertices[i], prefixSumMesh.Vertices[i]))
+        {
+            return false;
+        }
+    }
+
+    for (uint32_t i = 0; i < outputTriangleCount; ++i)
+    {
+        const uint3& a = ringLoopMesh.Triangles[i];
+        const uint3& b = prefixSumMesh.Triangles[i];
+
+        if ((a.x != b.x) || (a.y != b.y) || (a.z != b.z))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Pieces of a split spline start and/or end with a direction-only control point, see shaders/splinesplitting.h
+static bool IsContinuationPiece(const DrawSplineRecord& record, uint32_t splineIndex)
+{
+    return (record.controlPointCount[splineIndex] > 1) && (DecodeVertexCount(record.controlPointVertexCounts[splineIndex], 0) == 0);
+}
+
+static bool IsContinuedPiece(const DrawSplineRecord& record, uint32_t splineIndex)
+{
+    const uint32_t controlPointCount = record.controlPointCount[splineIndex];
+
+    return (controlPointCount > 1) && (DecodeVertexCount(record.controlPointVertexCounts[splineIndex], controlPointCount - 1) == 0);
+}
+
+// Vertex count of the first or last ring with vertices
+static uint32_t GetOuterRingVertexCount(const DrawSplineRecord& record, uint32_t splineIndex, bool last)
+{
+    const uint32_t controlPointCount = record.controlPointCount[splineIndex];
+
+    for (uint32_t i = 0; i < controlPointCount; ++i)
+    {
+        const uint32_t vertexCount = DecodeVertexCount(record.controlPointVertexCounts[splineIndex], last ? (controlPointCount - 1 - i) : i);
+
+        if (vertexCount > 0)
+        {
+            return vertexCount;
+        }
+    }
+
+    return 0;
+}
+
+// Tessellates all splines of a frame. Pieces of a split spline are written to consecutive records of a generator thread group at the same spline index.
+static void ValidateSplines(const WorldGraphFrame& frame, SplineValidationStats& stats)
+{
+    const std::vector<const void*>& records = frame.Records[static_cast<uint32_t>(WorldGraphNode::DrawSpline)];
+
+    SplineMesh mesh, previousMesh, prefixSumMesh;
+
+    for (size_t r = 0; r < records.size(); ++r)
+    {
+        const DrawSplineRecord& record = *static_cast<const DrawSplineRecord*>(records[r]);
+
+        for (uint32_t splineIndex = 0; splineIndex < record.dispatchGrid.x; ++splineIndex)
+        {
+            if (record.controlPointCount[splineIndex] == 0)
+            {
+                continue;
+            }
+
+            TessellateSpline(record, splineIndex, mesh);
+
+            if (!IsSameTopology(record, splineIndex, mesh, prefixSumMesh))
+            {
+                ++stats.TopologyMismatchCount;
+            }
+
+            ++stats.PieceCount;
+            stats.TriangleCount += mesh.TriangleCount;
+
+            const uint32_t outputVertexCount   = std::min(mesh.VertexCount, splineMeshMaxVertexCount);
+            const uint32_t outputTriangleCount = std::min(mesh.TriangleCount, splineMeshMaxTriangleCount);
+
+            if (mesh.IsClamped())
+            {
+                ++stats.ClampedCount;
+                stats.LostVertexCount += mesh.VertexCount - outputVertexCount;
+                stats.LostTriangleCount += mesh.TriangleCount - outputTriangleCount;
+            }
+
+            for (uint32_t i = 0; i < outputTriangleCount; ++i)
+            {
+                const uint3& triangle = mesh.Triangles[i];
+
+                if ((triangle.x >= outputVertexCount) || (triangle.y >= outputVertexCount) || (triangle.z >= outputVertexCount))
+                {
+                    ++stats.InvalidTriangleCount;
+                }
+            }
+
+            if (IsContinuationPiece(record, splineIndex))
+            {
+                // the first ring must be generated with the same vertices as the last ring of the previous piece
+                const DrawSplineRecord* pPrevious = (r > 0) ? static_cast<const DrawSplineRecord*>(records[r - 1]) : nullptr;
+
+                bool seamMatches = false;
+
+                if (pPrevious && (splineIndex < pPrevious->dispatchGrid.x) && IsContinuedPiece(*pPrevious, splineIndex))
+                {
+                    TessellateSpline(*pPrevious, splineIndex, previousMesh);
+
+                    const uint32_t ringVertexCount = GetOuterRingVertexCount(record, splineIndex, false);
+
+                    seamMatches = (ringVertexCount == GetOuterRingVertexCount(*pPrevious, splineIndex, true)) &&
+                                  (ringVertexCount <= mesh.Vertices.size()) && (ringVertexCount <= previousMesh.Vertices.size());
+
+                    for (uint32_t i = 0; seamMatches && (i < ringVertexCount); ++i)
+                    {
+                        seamMatches = IsBitIdentical(mesh.Vertices[i], previousMesh.Vertices[previousMesh.Vertices.size() - ringVertexCount + i]);
+                    }
+                }
+
+                if (!seamMatches)
+                {
+                    ++stats.SeamErrorCount;
+                }
+            }
+            else
+            {
+                ++stats.SplineCount;
+            }
+
+            if (IsContinuedPiece(record, splineIndex))
+            {
+                const DrawSplineRecord* pNext = ((r + 1) < records.size()) ? static_cast<const DrawSplineRecord*>(records[r + 1]) : nullptr;
+
+                if (!pNext || (splineIndex >= pNext->dispatchGrid.x) || !IsContinuationPiece(*pNext, splineIndex))
+                {
+                    ++stats.DroppedPieceCount;
+                }
+            }
+        }
+    }
+}
+
+static void PrintSplineStats(const char* label, uint32_t poseCount, const SplineValidationStats& stats)
+{
+    const double poses = std::max(poseCount, 1u);
+
+    printf("%-8s %12.1f %12.1f %12.1f %14.1f %14.1f %14.1f %14.1f\n",
+           label,
+           stats.SplineCount / poses,
+           stats.PieceCount / poses,
+           stats.ClampedCount / poses,
+           stats.LostVertexCount / poses,
+           stats.LostTriangleCount / poses,
+           stats.InvalidTriangleCount / poses,
+           stats.TriangleCount / poses);
+}
+
+static int Splines(uint32_t poseCount, uint32_t threadCount)
+{
+    WorldGraphDesc desc = {};
+    desc.ThreadCount    = threadCount;
+
+    // generators before spline splitting, i.e. every spline is a single piece clamped by the mesh shader
+    WorldGraphDesc unsplitDesc = desc;
+    unsplitDesc.SplitSplines   = false;
+
+    WorldGraphEmulator emulator(desc);
+    WorldGraphEmulator unsplitEmulator(unsplitDesc);
+
+    printf("Workers: %u, camera poses: %u, mesh output limits: %u vertices, %u triangles\n\n",
+           emulator.GetThreadCount(),
+           poseCount,
+           splineMeshMaxVertexCount,
+           splineMeshMaxTriangleCount);
+
+    SplineValidationStats before, after;
+
+    for (const WorldGraphCamera& camera : GenerateLimitPoses(poseCount, 4))
+    {
+        const WorkGraphCBData data = CreateWorkGraphCBData(camera);
+
+        ValidateSplines(unsplitEmulator.Execute(data), before);
+        ValidateSplines(emulator.Execute(data), after);
+    }
+
+    printf("Per frame:\n");
+    printf("%-8s %12s %12s %12s %14s %14s %14s %14s\n", "", "Splines", "Pieces", "Clamped", "Lost vertices", "Lost tris", "Invalid tris", "Triangles");
+    PrintSplineStats("Before", poseCount, before);
+    PrintSplineStats("After", poseCount, after);
+
+    uint64_t errorCount = 0;
+
+    if (after.ClampedCount > 0)
+    {
+        printf("%llu split spline pieces are clamped\n", static_cast<unsigned long long>(after.ClampedCount));
+        errorCount += after.ClampedCount;
+    }
+    if ((after.SeamErrorCount + before.SeamErrorCount) > 0)
+    {
+        printf("%llu pieces do not continue the previous piece\n", static_cast<unsigned long long>(after.SeamErrorCount + before.SeamErrorCount));
+        errorCount += after.SeamErrorCount + before.SeamErrorCount;
+    }
+    if ((after.DroppedPieceCount + before.DroppedPieceCount) > 0)
+    {
+        printf("%llu pieces miss their continuation\n", static_cast<unsigned long long>(after.DroppedPieceCount + before.DroppedPieceCount));
+        errorCount += after.DroppedPieceCount + before.DroppedPieceCount;
+    }
+    if (after.InvalidTriangleCount > 0)
+    {
+        printf("%llu triangles reference vertices which are not output\n", static_cast<unsigned long long>(after.InvalidTriangleCount));
+        errorCount += after.InvalidTriangleCount;
+    }
+    if ((after.TopologyMismatchCount + before.TopologyMismatchCount) > 0)
+    {
+        printf("%llu pieces are tessellated differently with the ring prefix sums\n",
+               static_cast<unsigned long long>(after.TopologyMismatchCount + before.TopologyMismatchCount));
+        errorCount += after.TopologyMismatchCount + before.TopologyMismatchCount;
+    }
+    if ((after.SplineCount != before.SplineCount) || (after.TriangleCount != before.TriangleCount))
+    {
+        printf("Splitting changed the splines or triangles\n");
+        ++errorCount;
+    }
+
+    return (errorCount == 0) ? 0 : 1;
+}
+
+// ==================
+// Record layout report
+
+struct RecordFieldLayout
+{
+    const char* Name;
+    size_t      Offset;
+    size_t      Size;
+};
+
+struct RecordLayout
+{
+    const char*                    Name;
+    size_t                         Size;
+    size_t                         Alignment;
+    std::vector<RecordFieldLayout> Fields;
+};
+
+#define RECORD_FIELD(record, field) {#field, offsetof(record, field), sizeof(record::field)}
+#define RECORD_LAYOUT(record, ...) {#record, sizeof(record), alignof(record), {__VA_ARGS__}}
+
+static std::vector<RecordLayout> GetRecordLayouts()
+{
+    return {
+        RECORD_LAYOUT(ChunkGridRecord, RECORD_FIELD(ChunkGridRecord, grid), RECORD_FIELD(ChunkGridRecord, offset)),
+        RECORD_LAYOUT(ChunkRecord,
+                      RECORD_FIELD(ChunkRecord, chunkGridPosition),
+                      RECORD_FIELD(ChunkRecord, levelOfDetail),
+                      RECORD_FIELD(ChunkRecord, levelOfDetailTransitionMask),
+                      RECORD_FIELD(ChunkRecord, tileBiomes)),
+        RECORD_LAYOUT(TileRecord, RECORD_FIELD(TileRecord, position)),
+        RECORD_LAYOUT(DrawTerrainChunkRecord,
+                      RECORD_FIELD(DrawTerrainChunkRecord, dispatchGrid),
+                      RECORD_FIELD(DrawTerrainChunkRecord, chunkGridPosition),
+                      RECORD_FIELD(DrawTerrainChunkRecord, levelOfDetail),
+                      RECORD_FIELD(DrawTerrainChunkRecord, levelOfDetailTransition)),
+        RECORD_LAYOUT(GenerateTreeRecord, RECORD_FIELD(GenerateTreeRecord, position)),
+        RECORD_LAYOUT(DrawSplineRecord,
+                      RECORD_FIELD(DrawSplineRecord, dispatchGrid),
+                      RECORD_FIELD(DrawSplineRecord, origin),
+                      RECORD_FIELD(DrawSplineRecord, color),
+                      RECORD_FIELD(DrawSplineRecord, rotationOffset),
+                      RECORD_FIELD(DrawSplineRecord, windStrength),
+                      RECORD_FIELD(DrawSplineRecord, controlPointCount),
+                      RECORD_FIELD(DrawSplineRecord, controlPointVertexCounts),
+                      RECORD_FIELD(DrawSplineRecord, ringPrefixSums),
+                      RECORD_FIELD(DrawSplineRecord, controlPointPositions),
+                      RECORD_FIELD(DrawSplineRecord, controlPointRadii),
+                      RECORD_FIELD(DrawSplineRecord, controlPointNoiseAmplitudes)),
+        RECORD_LAYOUT(DrawInsectRecord,
+                      RECORD_FIELD(DrawInsectRecord, dispatchGrid),
+                      RECORD_FIELD(DrawInsectRecord, origin),
+                      RECORD_FIELD(DrawInsectRecord, position)),
+        RECORD_LAYOUT(DrawMushroomRecord,
+                      RECORD_FIELD(DrawMushroomRecord, dispatchGrid),
+                      RECORD_FIELD(DrawMushroomRecord, origin),
+                      RECORD_FIELD(DrawMushroomRecord, position)),
+        RECORD_LAYOUT(DrawFlowerRecord,
+                      RECORD_FIELD(DrawFlowerRecord, dispatchGrid),
+                      RECORD_FIELD(DrawFlowerRecord, flowerPatchCount),
+                      RECORD_FIELD(DrawFlowerRecord, origin),
+                      RECORD_FIELD(DrawFlowerRecord, position)),
+        RECORD_LAYOUT(DrawDenseGrassRecord,
+                      RECORD_FIELD(DrawDenseGrassRecord, dispatchGrid),
+                      RECORD_FIELD(DrawDenseGrassRecord, origin),
+                      RECORD_FIELD(DrawDenseGrassRecord, position),
+                      RECORD_FIELD(DrawDenseGrassRecord, patch)),
+        RECORD_LAYOUT(DrawSparseGrassRecord,
+                      RECORD_FIELD(DrawSparseGrassRecord, dispatchGrid),
+                      RECORD_FIELD(DrawSparseGrassRecord, origin),
+                      RECORD_FIELD(DrawSparseGrassRecord, position)),
+    };
+}
+
+#undef RECORD_LAYOUT
+#undef RECORD_FIELD
+
+static void PrintLayoutReport(FILE* file, const std::vector<RecordLayout>& layouts)
+{
+    fprintf(file, "Records (shaders/workgraphrecords.h):\n");
+    fprintf(file, "%-24s %8s %6s %8s %8s %8s\n", "Record", "Bytes", "Align", "Fields", "Padding", "Waste %");
+
+    for (const auto& layout : layouts)
+    {
+        size_t fieldBytes = 0;
+
+        for (const auto& field : layout.Fields)
+        {
+            fieldBytes += field.Size;
+        }
+
+        fprintf(file,
+                "%-24s %8zu %6zu %8zu %8zu %8.2f\n",
+                layout.Name,
+                layout.Size,
+                layout.Alignment,
+                fieldBytes,
+                layout.Size - fieldBytes,
+                100.0 * (layout.Size - fieldBytes) / layout.Size);
+
+        // padding between fields, trailing padding is included in the record padding above
+        size_t end = 0;
+
+        for (const auto& field : layout.Fields)
+        {
+            if (field.Offset > end)
+            {
+                fprintf(file, "    %zu bytes of padding before %s at offset %zu\n", field.Offset - end, field.Name, field.Offset);
+            }
+            end = field.Offset + field.Size;
+        }
+    }
+
+    // worst-case output records per thread group of the producer, i.e. the backing memory a single group can claim
+    fprintf(file, "\nOutputs per producer thread group ([MaxRecords] x record bytes):\n");
+    fprintf(file, "%-18s %-22s %-24s %10s %10s\n", "Producer", "Output", "Record", "MaxRecords", "Bytes");
+
+    uint64_t groupBytes = 0;
+
+    for (uint32_t i = 0; i < WorldGraphOutputCount; ++i)
+    {
+        const WorldGraphOutputInfo& output = GetWorldGraphOutputInfo(i);
+        const uint64_t              bytes  = static_cast<uint64_t>(output.MaxRecords) * output.RecordSize;
+
+        fprintf(file,
+                "%-18s %-22s %-24s %10u %10llu\n",
+                GetWorldGraphNodeInfo(output.Producer).Name,
+                output.NodeId,
+                output.RecordName,
+                output.MaxRecords,
+                static_cast<unsigned long long>(bytes));
+
+        groupBytes += bytes;
+
+        const bool isLastOutput = ((i + 1) == WorldGraphOutputCount) || (GetWorldGraphOutputInfo(i + 1).Producer != output.Producer);
+
+        if (isLastOutput)
+        {
+            fprintf(file, "%-18s %-22s %-24s %10s %10llu\n", "", "", "", "total", static_cast<unsigned long long>(groupBytes));
+            groupBytes = 0;
+        }
+    }
+
+    // mesh nodes can hold up to NodeMaxInputRecordsPerGraphEntryRecord records per entry record, shared across node arrays
+    fprintf(file, "\nMesh node inputs per graph entry record (NodeMaxInputRecordsPerGraphEntryRecord x record bytes):\n");
+    fprintf(file, "%-22s %10s %10s %12s\n", "Node", "Bytes", "MaxInput", "KiB");
+
+    uint64_t meshBytes = 0;
+
+    for (uint32_t i = 0; i < WorldGraphNodeCount; ++i)
+    {
+        const WorldGraphNodeInfo& info = GetWorldGraphNodeInfo(static_cast<WorldGraphNode>(i));
+
+        // DrawFlowerPatch[1] shares the limit of DrawFlowerPatch[0]
+        if ((info.MaxInputRecords == 0) || (static_cast<WorldGraphNode>(i) == WorldGraphNode::DrawSparseFlowerPatch))
+        {
+            continue;
+        }
+
+        const uint64_t bytes = static_cast<uint64_t>(info.MaxInputRecords) * info.RecordSize;
+
+        fprintf(file, "%-22s %10zu %10u %12.1f\n", info.NodeId, info.RecordSize, info.MaxInputRecords, bytes / 1024.0);
+
+        meshBytes += bytes;
+    }
+
+    fprintf(file, "%-22s %10s %10s %12.1f\n", "total", "", "", meshBytes / 1024.0);
+}
+
+static int Layout(const char* reportPath)
+{
+    const std::vector<RecordLayout> layouts = GetRecordLayouts();
+
+    // fields must be in declaration order & inside the record, otherwise the HLSL layout differs
+    uint32_t errorCount = 0;
+
+    for (const auto& layout : layouts)
+    {
+        size_t end = 0;
+
+        for (const auto& field : layout.Fields)
+        {
+            if ((field.Offset < end) || ((field.Offset + field.Size) > layout.Size))
+            {
+                printf("%s::%s overlaps the previous field or exceeds the record\n", layout.Name, field.Name);
+                ++errorCount;
+            }
+            end = field.Offset + field.Size;
+        }
+    }
+
+    PrintLayoutReport(stdout, layouts);
+
+    if (reportPath != nullptr)
+    {
+        FILE* file = fopen(reportPath, "w");
+
+        if (file == nullptr)
+        {
+            printf("Failed to write %s\n", reportPath);
+            return 1;
+        }
+
+        PrintLayoutReport(file, layouts);
+        fclose(file);
+
+        printf("\nWrote %s\n", reportPath);
+    }
+
+    return (errorCount == 0) ? 0 : 1;
+}
+
+// ==================
+// Geometry budget
+
+// Mesh nodes scaled by the geometry budget, see GetGeometryBudgetScales
+static const WorldGraphNode BudgetedNodes[] = {WorldGraphNode::DrawSparseGrassPatch,
+                                               WorldGraphNode::DrawDenseGrassPatch,
+                                               WorldGraphNode::DrawMushroomPatch,
+                                               WorldGraphNode::DrawFlowerPatch,
+                                               WorldGraphNode::DrawSparseFlowerPatch,
+                                               WorldGraphNode::DrawBees,
+                                               WorldGraphNode::DrawButterflies};
+
+// Mesh thread groups of the budgeted nodes per level, relative to the full quality tier. Used as the cost model of the simulated traces.
+struct BudgetWorkloadCurve
+{
+    std::vector<float>  Levels;
+    std::vector<double> Workloads;
+
+    // linear interpolation between the measured levels, which are in descending order
+    double Evaluate(float level) const
+    {
+        for (size_t i = 1; i < Levels.size(); ++i)
+        {
+            if (level >= Levels[i])
+            {
+                const float t = (level - Levels[i]) / (Levels[i - 1] - Levels[i]);
+                return Workloads[i] + (Workloads[i - 1] - Workloads[i]) * t;
+            }
+        }
+
+        return Workloads.back();
+    }
+};
+
+// Segment of a simulated trace. The work graph time at the full quality tier is Load times the target, ramping to EndLoad,
+// of which Share scales with the workload curve of the budgeted nodes. Thread group counts do not reflect the cost of the
+// ground cover, which dominates the time in meadows, thus the share is part of the scenario.
+struct BudgetTraceSegment
+{
+    double   Load;
+    double   EndLoad;
+    double   Share;
+    // relative uniform noise per frame
+    double   Noise;
+    // every SpikeInterval-th frame takes four times as long, e.g. shader compilation or paging. 0 disables spikes.
+    uint32_t SpikeInterval;
+};
+
+struct BudgetTrace
+{
+    const char*                     Name;
+    std::vector<BudgetTraceSegment> Segments;
+};
+
+struct BudgetTraceStats
+{
+    uint32_t FrameCount     = 0;
+    uint32_t ChangeCount    = 0;
+    uint32_t ReversalCount  = 0;
+    uint32_t OverBudgetCount = 0;
+    double   LevelSum       = 0.0;
+    // failed steady state checks of the segments
+    uint32_t FailedSegmentCount = 0;
+};
+
+// The profiler reports the GPU time of a frame this many frames later
+static const uint32_t BudgetTimingLatency = 2;
+
+static BudgetTraceStats SimulateBudgetTrace(const BudgetTrace& trace, const BudgetWorkloadCurve& curve, const GeometryBudgetDesc& desc, uint32_t segmentFrameCount)
+{
+    GeometryBudgetGovernor governor(desc);
+
+    std::mt19937                           random(7);
+    std::uniform_real_distribution<double> noise(-1.0, 1.0);
+
+    std::vector<double> pendingTimings;
+    BudgetTraceStats    stats;
+    int                 lastDirection = 0;
+
+    const double target = desc.TargetTimeMs;
+
+    for (const BudgetTraceSegment& segment : trace.Segments)
+    {
+        // steady state of the second half of the segment
+        double   steadyTimeSum    = 0.0;
+        uint32_t steadyChangeCount = 0;
+
+        for (uint32_t frame = 0; frame < segmentFrameCount; ++frame)
+        {
+            const float  level = governor.GetLevel();
+            const double load  = segment.Load + (segment.EndLoad - segment.Load) * frame / segmentFrameCount;
+
+            double timeMs = load * target * ((1.0 - segment.Share) + segment.Share * curve.Evaluate(level));
+            timeMs *= 1.0 + segment.Noise * noise(random);
+
+            const bool isSpike = (segment.SpikeInterval > 0) && ((frame % segment.SpikeInterval) == (segment.SpikeInterval - 1));
+            if (isSpike)
+            {
+                timeMs *= 4.0;
+            }
+
+            pendingTimings.push_back(timeMs);
+
+            const double reportedTimeMs = (pendingTimings.size() > BudgetTimingLatency) ? pendingTimings[pendingTimings.size() - 1 - BudgetTimingLatency] : 0.0;
+            const float  nextLevel      = governor.Update(reportedTimeMs);
+
+            ++stats.FrameCount;
+            stats.LevelSum += level;
+            stats.OverBudgetCount += (!isSpike && (timeMs > (target * (1.0 + desc.Hysteresis)))) ? 1 : 0;
+
+            if (nextLevel != level)
+            {
+                const int direction = (nextLevel > level) ? 1 : -1;
+
+                ++stats.ChangeCount;
+                stats.ReversalCount += ((lastDirection != 0) && (direction != lastDirection)) ? 1 : 0;
+                lastDirection = direction;
+            }
+
+            if (frame >= (segmentFrameCount / 2))
+            {
+                steadyTimeSum += isSpike ? (timeMs / 4.0) : timeMs;
+                steadyChangeCount += (nextLevel != level) ? 1 : 0;
+            }
+        }
+
+        // the level must have settled & the time must be close to the target, unless the level is at one of its bounds.
+        // A ramping load is only required to be tracked.
+        const bool isRamp = (segment.EndLoad != segment.Load);
+        const double steadyTime = steadyTimeSum / (segmentFrameCount - segmentFrameCount / 2);
+        const float  level      = governor.GetLevel();
+        const double tolerance  = 1.5 * desc.Hysteresis;
+
+        const bool isAtTarget = (steadyTime >= (target * (1.0 - tolerance))) && (steadyTime <= (target * (1.0 + tolerance)));
+        const bool isAtMax    = (level >= 1.f) && (steadyTime <= (target * (1.0 + tolerance)));
+        const bool isAtMin    = (level <= desc.MinLevel) && (steadyTime >= (target * (1.0 - tolerance)));
+
+        if ((!isRamp && (steadyChangeCount > 2)) || !(isAtTarget || isAtMax || isAtMin))
+        {
+            ++stats.FailedSegmentCount;
+        }
+    }
+
+    return stats;
+}
+
+static int Budget(double targetTimeMs, uint32_t poseCount, uint32_t threadCount)
+{
+    WorldGraphDesc graphDesc = {};
+    graphDesc.ThreadCount    = threadCount;
+
+    WorldGraphEmulator emulator(graphDesc);
+
+    const std::vector<WorldGraphCamera> poses = GenerateLimitPoses(poseCount, 4);
+
+    printf("Workers: %u, camera poses: %u\n\n", emulator.GetThreadCount(), poseCount);
+
+    // --- workload of the budgeted nodes per level ---
+    BudgetWorkloadCurve curve;
+    curve.Levels = {1.f, 0.8f, 0.6f, 0.4f, 0.25f};
+
+    uint32_t errorCount             = 0;
+    uint64_t fullBudgetedGroupCount = 0;
+    double   budgetedShare          = 0.0;
+
+    printf("%-8s %14s %14s %10s\n", "Level", "Budgeted", "All mesh", "Relative");
+
+    for (const float level : curve.Levels)
+    {
+        uint64_t budgetedGroupCount = 0;
+        uint64_t meshGroupCount     = 0;
+
+        for (const WorldGraphCamera& camera : poses)
+        {
+            WorkGraphCBData data = CreateWorkGraphCBData(camera);
+            SetGeometryBudget(data, GetGeometryBudgetScales(level));
+
+            const WorldGraphFrame& frame = emulator.Execute(data);
+
+            for (const WorldGraphNode node : BudgetedNodes)
+            {
+                budgetedGroupCount += frame.Nodes[static_cast<uint32_t>(node)].GroupCount;
+            }
+            for (uint32_t node = static_cast<uint32_t>(WorldGraphNode::DrawTerrainChunk); node < WorldGraphNodeCount; ++node)
+            {
+                meshGroupCount += frame.Nodes[node].GroupCount;
+            }
+        }
+
+        if (level == 1.f)
+        {
+            fullBudgetedGroupCount = budgetedGroupCount;
+            budgetedShare          = static_cast<double>(budgetedGroupCount) / std::max<uint64_t>(meshGroupCount, 1);
+        }
+
+        const double workload = static_cast<double>(budgetedGroupCount) / std::max<uint64_t>(fullBudgetedGroupCount, 1);
+
+        // every level must reduce the budgeted work
+        if (!curve.Workloads.empty() && (workload >= curve.Workloads.back()))
+        {
+            ++errorCount;
+        }
+
+        printf("%-8.2f %14.1f %14.1f %10.3f\n",
+               level,
+               static_cast<double>(budgetedGroupCount) / poseCount,
+               static_cast<double>(meshGroupCount) / poseCount,
+               workload);
+
+        curve.Workloads.push_back(workload);
+    }
+
+    printf("Budgeted share of the mesh thread groups: %.1f%%\n\n", budgetedShare * 100.0);
+
+    if (errorCount > 0)
+    {
+        printf("Lower levels do not reduce the budgeted mesh thread groups\n");
+    }
+
+    // --- simulated traces ---
+    GeometryBudgetDesc desc = {};
+    desc.TargetTimeMs       = targetTimeMs;
+
+    const uint32_t segmentFrameCount = 600;
+
+    // Loads are relative to the target at the full quality tier
+    const BudgetTrace traces[] = {
+        {"meadow", {{1.6, 1.6, 0.7, 0.0, 0}}},
+        {"mountain", {{0.5, 0.5, 0.2, 0.0, 0}}},
+        {"meadow-mountain", {{1.6, 1.6, 0.7, 0.0, 0}, {0.5, 0.5, 0.2, 0.0, 0}, {1.6, 1.6, 0.7, 0.0, 0}, {1.1, 1.1, 0.4, 0.0, 0}}},
+        {"ramp", {{1.0, 1.8, 0.7, 0.0, 0}, {1.8, 1.0, 0.7, 0.0, 0}}},
+        {"noise", {{1.6, 1.6, 0.7, 0.15, 0}, {1.2, 1.2, 0.6, 0.15, 0}}},
+        {"spikes", {{1.6, 1.6, 0.7, 0.05, 37}, {1.2, 1.2, 0.6, 0.05, 37}}},
+    };
+
+    printf("Target: %.2f ms, hysteresis: %.0f%%, min level: %.2f, timing latency: %u frames, %u frames per segment\n",
+           desc.TargetTimeMs,
+           desc.Hysteresis * 100.0,
+           desc.MinLevel,
+           BudgetTimingLatency,
+           segmentFrameCount);
+    printf("%-16s %8s %8s %10s %10s %12s %10s\n", "Trace", "Frames", "Changes", "Reversals", "Mean level", "Over budget", "Segments");
+
+    for (const BudgetTrace& trace : traces)
+    {
+        const BudgetTraceStats stats = SimulateBudgetTrace(trace, curve, desc, segmentFrameCount);
+
+        printf("%-16s %8u %8u %10u %10.3f %11.1f%% %5zu/%zu %s\n",
+               trace.Name,
+               stats.FrameCount,
+               stats.ChangeCount,
+               stats.ReversalCount,
+               stats.LevelSum / stats.FrameCount,
+               100.0 * stats.OverBudgetCount / stats.FrameCount,
+               trace.Segments.size() - stats.FailedSegmentCount,
+               trace.Segments.size(),
+               (stats.FailedSegmentCount == 0) ? "ok" : "FAIL");
+
+        errorCount += stats.FailedSegmentCount;
+    }
+
+    return (errorCount == 0) ? 0 : 1;
+}
+
+// ==================
+// Generation counters
+
+static int Counters(uint32_t poseCount, uint32_t threadCount)
+{
+    WorldGraphDesc desc = {};
+    desc.ThreadCount    = threadCount;
+
+    WorldGraphDesc countingDesc   = desc;
+    countingDesc.CountMeshOutputs = true;
+
+    WorldGraphEmulator emulator(desc);
+    WorldGraphEmulator countingEmulator(countingDesc);
+
+    printf("Workers: %u, camera poses: %u\n\n", emulator.GetThreadCount(), poseCount);
+
+    // sums over all poses, except for the maximum entries
+    uint64_t totals[generationCounterBufferSize] = {};
+    uint32_t counters[generationCounterBufferSize];
+    uint64_t errorCount = 0;
+    double   timeMs = 0.0, countingTimeMs = 0.0;
+
+    for (const WorldGraphCamera& camera : GenerateLimitPoses(poseCount, 4))
+    {
+        const WorkGraphCBData data = CreateWorkGraphCBData(camera);
+
+        const WorldGraphFrame& frame = emulator.Execute(data);
+        const uint32_t         hash  = GetRecordHash(frame);
+        timeMs += frame.TimeMs;
+
+        const WorldGraphFrame& countingFrame = countingEmulator.Execute(data);
+        countingTimeMs += countingFrame.TimeMs;
+
+        if (GetRecordHash(countingFrame) != hash)
+        {
+            printf("Counting the mesh outputs changed the records at position (%.2f, %.2f, %.2f)\n", camera.Position.x, camera.Position.y, camera.Position.z);
+            ++errorCount;
+        }
+
+        GetGenerationCounters(countingFrame, counters);
+
+        for (uint32_t node = 0; node < generationNodeCount; ++node)
+        {
+            const uint32_t records    = counters[GetGenerationCounterIndex(node, generationCounterRecords)];
+            const uint32_t entries    = counters[GetGenerationCounterIndex(node, generationCounterEntries)];
+            const uint32_t maxEntries = counters[GetGenerationCounterIndex(node, generationCounterMaxEntries)];
+            const uint32_t capacity   = GetGenerationRecordCapacity(node);
+
+            const bool isMeshNode = GetWorldGraphNodeInfo(static_cast<WorldGraphNode>(node)).Launch == WorldGraphLaunch::Mesh;
+            const bool hasOutputs = (counters[GetGenerationCounterIndex(node, generationCounterVertices)] > 0) ||
+                                    (counters[GetGenerationCounterIndex(node, generationCounterPrimitives)] > 0);
+
+            if ((maxEntries > capacity) || (entries > static_cast<uint64_t>(records) * capacity) || (hasOutputs && !isMeshNode))
+            {
+                printf("%s: inconsistent counters at position (%.2f, %.2f, %.2f)\n",
+                       GetWorldGraphNodeInfo(static_cast<WorldGraphNode>(node)).Name,
+                       camera.Position.x,
+                       camera.Position.y,
+                       camera.Position.z);
+                ++errorCount;
+            }
+
+            for (uint32_t counter = 0; counter < generationCounterCount; ++counter)
+            {
+                const uint32_t index = GetGenerationCounterIndex(node, counter);
+
+                totals[index] = (counter == generationCounterMaxEntries) ? std::max<uint64_t>(totals[index], counters[index]) : totals[index] + counters[index];
+            }
+        }
+    }
+
+    printf("Per frame:\n");
+    printf("%-24s %10s %10s %12s %12s %10s %12s\n", "Node", "Records", "Groups", "Vertices", "Primitives", "Occupancy", "Max entries");
+
+    uint64_t vertexCount = 0, primitiveCount = 0;
+
+    for (uint32_t node = 0; node < generationNodeCount; ++node)
+    {
+        const uint64_t* pNode    = &totals[GetGenerationCounterIndex(node, 0)];
+        const uint32_t  capacity = GetGenerationRecordCapacity(node);
+
+        printf("%-24s %10.1f %10.1f %12.1f %12.1f",
+               GetWorldGraphNodeInfo(static_cast<WorldGraphNode>(node)).Name,
+               static_cast<double>(pNode[generationCounterRecords]) / poseCount,
+               static_cast<double>(pNode[generationCounterGroups]) / poseCount,
+               static_cast<double>(pNode[generationCounterVertices]) / poseCount,
+               static_cast<double>(pNode[generationCounterPrimitives]) / poseCount);
+
+        // the occupancy of a record array is the mean of the used entries over all records of the node
+        if ((capacity > 0) && (pNode[generationCounterRecords] > 0))
+        {
+            char maxEntries[32];
+            snprintf(maxEntries, sizeof(maxEntries), "%llu/%u", static_cast<unsigned long long>(pNode[generationCounterMaxEntries]), capacity);
+
+            printf(" %9.1f%% %12s", 100.0 * pNode[generationCounterEntries] / (static_cast<double>(pNode[generationCounterRecords]) * capacity), maxEntries);
+        }
+        printf("\n");
+
+        vertexCount += pNode[generationCounterVertices];
+        primitiveCount += pNode[generationCounterPrimitives];
+    }
+
+    printf("%-24s %10s %10s %12.1f %12.1f\n",
+           "Total",
+           "",
+           "",
+           static_cast<double>(vertexCount) / poseCount,
+           static_cast<double>(primitiveCount) / poseCount);
+    printf("\nEmulator frame time: %.3f ms, with mesh output counts: %.3f ms\n", timeMs / poseCount, countingTimeMs / poseCount);
+
+    return (errorCount == 0) ? 0 : 1;
+}
+
+// ==================
+// Frame trace
+
+// Checks a written trace: valid JSON, all events written, every frame begun & ended in order and every CPU slice inside its frame
+static bool ValidateFrameTrace(const char* tracePath, const FrameTraceStats& stats)
+{
+    std::ifstream     file(tracePath, std::ios::binary);
+    std::stringstream text;
+    text << file.rdbuf();
+
+    JsonNode    document;
+    std::string errorString;
+
+    if (!file || !ParseJson(text.str(), document, errorString))
+    {
+        printf("Failed to parse trace %s: %s\n", tracePath, errorString.c_str());
+        return false;
+    }
+
+    const JsonNode* pEvents = GetJsonMember(document, "traceEvents");
+    if ((pEvents == nullptr) || (pEvents->NodeType != JsonNode::Type::Array) || (GetJsonMember(document, "otherData") == nullptr))
+    {
+        printf("Trace %s has no traceEvents or otherData\n", tracePath);
+        return false;
+    }
+
+    uint32_t errorCount = 0;
+    uint64_t frameCount = 0;
+    bool     inFrame    = false;
+    double   frameStart = 0.0;
+    double   lastTime   = -DBL_MAX;
+
+    for (const auto& member : pEvents->Children)
+    {
+        const JsonNode* pPhase = GetJsonMember(member.second, "ph");
+        const double    time   = GetJsonNumber(GetJsonMember(member.second, "ts"), 0.0);
+        const double    tid    = GetJsonNumber(GetJsonMember(member.second, "tid"), 0.0);
+
+        if (pPhase == nullptr)
+        {
+            ++errorCount;
+            continue;
+        }
+
+        if ((pPhase->Value == "B") || (pPhase->Value == "E"))
+        {
+            const bool begin = (pPhase->Value == "B");
+
+            if ((begin == inFrame) || (time < lastTime) || (tid != static_cast<double>(FrameTraceTrack::Frames)))
+            {
+                ++errorCount;
+            }
+
+            if (begin)
+            {
+                const JsonNode* pArgs = GetJsonMember(member.second, "args");
+                if ((pArgs == nullptr) || (GetJsonNumber(GetJsonMember(*pArgs, "Frame"), -1.0) != static_cast<double>(frameCount)))
+                {
+                    ++errorCount;
+                }
+            }
+            else
+            {
+                ++frameCount;
+            }
+
+            inFrame    = begin;
+            frameStart = time;
+            lastTime   = time;
+        }
+        else if ((pPhase->Value == "X") && (tid == static_cast<double>(FrameTraceTrack::Cpu)))
+        {
+            // the emulator only adds CPU slices within frames
+            const double duration = GetJsonNumber(GetJsonMember(member.second, "dur"), -1.0);
+
+            if (!inFrame || (time < frameStart) || (duration < 0.0))
+            {
+                ++errorCount;
+            }
+        }
+    }
+
+    if ((pEvents->Children.size() != stats.EventCount) || (frameCount != stats.FrameCount) || inFrame)
+    {
+        printf("Trace %s has %zu events & %llu frames, written were %llu events & %llu frames\n",
+               tracePath,
+               pEvents->Children.size(),
+               static_cast<unsigned long long>(frameCount),
+               static_cast<unsigned long long>(stats.EventCount),
+               static_cast<unsigned long long>(stats.FrameCount));
+        ++errorCount;
+    }
+
+    if (errorCount > 0)
+    {
+        printf("Trace %s has %u invalid events\n", tracePath, errorCount);
+    }
+
+    return errorCount == 0;
+}
+
+static int Trace(const char* flythroughPath, const char* tracePath, uint32_t threadCount, uint32_t maxFrameCount, size_t bufferSize)
+{
+    std::vector<FlythroughFrame> frames;
+
+    if (!LoadFlythroughFrames(flythroughPath, frames))
+    {
+        return 1;
+    }
+
+    if ((maxFrameCount > 0) && (frames.size() > maxFrameCount))
+    {
+        frames.resize(maxFrameCount);
+    }
+
+    WorldGraphDesc desc = {};
+    desc.ThreadCount    = threadCount;
+
+    WorldGraphEmulator emulator(desc);
+    FrameTraceWriter   writer(bufferSize);
+
+    const std::vector<std::pair<std::string, std::string>> metadata = {
+        {"Flythrough", flythroughPath},
+        {"Workers", std::to_string(emulator.GetThreadCount())},
+        {"Build", __DATE__ " " __TIME__},
+    };
+
+    if (!writer.Open(tracePath, "MeshNodeCpuTool", metadata))
+    {
+        printf("Failed to create trace %s\n", tracePath);
+        return 1;
+    }
+
+    printf("Workers: %u, frames: %zu, flythrough: %s, trace buffer: %zu bytes\n\n", emulator.GetThreadCount(), frames.size(), flythroughPath, bufferSize);
+
+    const auto traceStartTime = std::chrono::high_resolution_clock::now();
+    const auto getTraceTimeUs = [&]() { return std::chrono::duration<double, std::micro>(std::chrono::high_resolution_clock::now() - traceStartTime).count(); };
+
+    uint32_t shaderTime   = 0;
+    double   emulatorMs   = 0.0;
+    double   writerTimeMs = 0.0;
+
+    for (size_t f = 0; f < frames.size(); ++f)
+    {
+        const FlythroughFrame& flythroughFrame = frames[f];
+
+        WorldGraphCamera camera = {};
+        camera.Position         = flythroughFrame.Position;
+        camera.Yaw              = flythroughFrame.Yaw;
+        camera.Pitch            = flythroughFrame.Pitch;
+
+        const uint32_t previousShaderTime = shaderTime;
+        shaderTime += static_cast<uint32_t>(flythroughFrame.DeltaTime * 1000.0);
+
+        WorkGraphCBData data    = CreateWorkGraphCBData(camera);
+        data.ShaderTime         = shaderTime;
+        data.PreviousShaderTime = previousShaderTime;
+        data.WindStrength       = flythroughFrame.WindStrength;
+        data.WindDirection      = flythroughFrame.WindDirection * (3.14159265359f / 180.f);
+
+        // settings in effect, same arguments as the frames traced by the sample where they exist
+        const FrameTraceArg args[] = {
+            {"FlythroughFrame", static_cast<double>(f)},
+            {"DeltaTime", flythroughFrame.DeltaTime},
+            {"WindStrength", flythroughFrame.WindStrength},
+            {"WindDirection", flythroughFrame.WindDirection},
+        };
+
+        const double frameStartUs = getTraceTimeUs();
+        writer.BeginFrame(f, frameStartUs, args, std::size(args));
+
+        const double           executeStartUs = getTraceTimeUs();
+        const WorldGraphFrame& frame          = emulator.Execute(data);
+        const double           executeEndUs   = getTraceTimeUs();
+
+        emulatorMs += frame.TimeMs;
+
+        writer.AddEvent(FrameTraceTrack::Cpu, "WorldGraphEmulator::Execute", executeStartUs, executeEndUs - executeStartUs);
+        for (uint32_t i = 0; i < WorldGraphNodeCount; ++i)
+        {
+            const WorldGraphNodeStats& node = frame.Nodes[i];
+            if (node.RecordCount > 0)
+            {
+                writer.AddEvent(FrameTraceTrack::Cpu, GetWorldGraphNodeInfo(static_cast<WorldGraphNode>(i)).NodeId, executeStartUs + node.StartMs * 1000.0, node.TimeMs * 1000.0);
+            }
+        }
+        writer.AddCounter("FrameTimeMs", frameStartUs, frame.TimeMs);
+        writer.EndFrame(getTraceTimeUs());
+        writer.FlushFrames();
+
+        writerTimeMs += (getTraceTimeUs() - executeEndUs) / 1000.0 + (executeStartUs - frameStartUs) / 1000.0;
+
+        if (((f + 1) % std::max<size_t>(frames.size() / 10, 1)) == 0)
+        {
+            printf("  %zu / %zu frames\n", f + 1, frames.size());
+        }
+    }
+
+    const auto   closeStartTime = std::chrono::high_resolution_clock::now();
+    const bool   closed         = writer.Close();
+    const double closeTimeMs    = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - closeStartTime).count();
+
+    if (!closed)
+    {
+        printf("Failed to write trace %s\n", tracePath);
+        return 1;
+    }
+
+    const FrameTraceStats& stats      = writer.GetStats();
+    const double           frameCount = static_cast<double>(std::max<uint64_t>(stats.FrameCount, 1));
+
+    printf("\nFrames: %llu, events: %llu, bytes: %llu (%.0f per frame)\n",
+           static_cast<unsigned long long>(stats.FrameCount),
+           static_cast<unsigned long long>(stats.EventCount),
+           static_cast<unsigned long long>(stats.ByteCount),
+           stats.ByteCount / frameCount);
+    printf("Flushes: %u, inside frames: %u\n", stats.FlushCount, stats.FrameFlushCount);
+    printf("Emulator frame time: %.3f ms, trace writing: %.4f ms per frame, closing: %.3f ms\n", emulatorMs / frameCount, writerTimeMs / frameCount, closeTimeMs);
+
+    if (!ValidateFrameTrace(tracePath, stats))
+    {
+        return 1;
+    }
+
+    printf("\nTrace written to %s\n", tracePath);
+
+    return 0;
+}
+
+// ==================
+// Shader dependencies
+
+// Same shader naming as the sample, e.g. "terrainrenderer.hlsl ps_6_9 TerrainPixelShader"
+static std::wstring GetShaderName(const WorkGraphShaderDesc& shader)
+{
+    std::wstring name = std::wstring(shader.ShaderFilePath) + L" " + shader.Target;
+    if (shader.EntryPoint != nullptr)
+    {
+        name += std::wstring(L" ") + shader.EntryPoint;
+    }
+    return name;
+}
+
+static std::string ToNarrowString(const std::wstring& string)
+{
+    std::string result;
+    for (const wchar_t c : string)
+    {
+        result.push_back(static_cast<char>(c));
+    }
+    return result;
+}
+
+// Files included by a shader source file, recursively. Includes that do not exist in the shaders folder (e.g. C++-only headers behind
+// preprocessor guards) are skipped, the sample records the files opened by the DXC include handler instead.
+static void AddShaderIncludes(const std::filesystem::path& shaderDirectory, const std::string& file, std::set<std::string>& includes)
+{
+    std::ifstream stream(shaderDirectory / file);
+    std::string   line;
+
+    while (std::getline(stream, line))
+    {
+        const size_t directive = line.find("#include \"");
+        if (directive == std::string::npos)
+        {
+            continue;
+        }
+
+        const size_t      nameStart = directive + strlen("#include \"");
+        const size_t      nameEnd   = line.find('"', nameStart);
+        const std::string name      = line.substr(nameStart, nameEnd - nameStart);
+
+        if ((nameEnd != std::string::npos) && std::filesystem::exists(shaderDirectory / name) && includes.insert(name).second)
+        {
+            AddShaderIncludes(shaderDirectory, name, includes);
+        }
+    }
+}
+
+static bool CheckShaders(const char* check, const std::vector<std::wstring>& shaders, const std::vector<std::wstring>& expectedShaders)
+{
+    const bool passed = (shaders == expectedShaders);
+
+    printf("  %-56s %s\n", check, passed ? "ok" : "FAILED");
+    if (!passed)
+    {
+        for (const std::wstring& shader : shaders)
+        {
+            printf("    got      %s\n", ToNarrowString(shader).c_str());
+        }
+        for (const std::wstring& shader : expectedShaders)
+        {
+            printf("    expected %s\n", ToNarrowString(shader).c_str());
+        }
+    }
+
+    return passed;
+}
+
+static int Dependencies(const char* shaderDirectory)
+{
+    uint32_t errorCount = 0;
+
+    // Synthetic graph: two libraries share common.hlsl, a pixel shader is compiled from the same file as one of them
+    printf("Synthetic graph:\n");
+    {
+        ShaderDependencyGraph graph;
+        graph.SetDependencies(L"a lib", {L"a.hlsl", L"common.hlsl", L"utils.hlsl"});
+        graph.SetDependencies(L"b lib", {L"b.hlsl", L"common.hlsl"});
+        graph.SetDependencies(L"b ps", {L"b.hlsl", L"pixel.hlsl"});
+
+        errorCount += !CheckShaders("shared include dirties all its shaders", graph.GetDirtyShaders({L"common.hlsl"}), {L"a lib", L"b lib"});
+        errorCount += !CheckShaders("leaf include dirties one shader", graph.GetDirtyShaders({L"pixel.hlsl"}), {L"b ps"});
+        errorCount += !CheckShaders("source file dirties every target", graph.GetDirtyShaders({L"b.hlsl"}), {L"b lib", L"b ps"});
+        errorCount += !CheckShaders("changed files are merged & sorted", graph.GetDirtyShaders({L"pixel.hlsl", L"utils.hlsl", L"b.hlsl"}), {L"a lib", L"b lib", L"b ps"});
+        errorCount += !CheckShaders("unknown file dirties nothing", graph.GetDirtyShaders({L"unknown.hlsl"}), {});
+        errorCount += !CheckShaders("dependent shaders of an include", graph.GetDependentShaders(L"utils.hlsl"), {L"a lib"});
+
+        // replaced dependencies no longer dirty the shader
+        graph.SetDependencies(L"a lib", {L"a.hlsl", L"common.hlsl"});
+        errorCount += !CheckShaders("replaced dependency dirties nothing", graph.GetDirtyShaders({L"utils.hlsl"}), {});
+
+        graph.RemoveShader(L"b lib");
+        errorCount += !CheckShaders("removed shader is not dirtied", graph.GetDirtyShaders({L"common.hlsl", L"b.hlsl"}), {L"a lib", L"b ps"});
+
+        graph.RemoveShader(L"a lib");
+        graph.RemoveShader(L"a lib");
+        const bool filesRemoved = (graph.GetFiles() == std::vector<std::wstring>{L"b.hlsl", L"pixel.hlsl"});
+        printf("  %-56s %s\n", "removed shaders drop files no other shader uses", filesRemoved ? "ok" : "FAILED");
+        errorCount += !filesRemoved;
+    }
+
+    // Graph of the work graph shaders, with the includes of their source files
+    printf("\nWork graph shaders in %s:\n", shaderDirectory);
+    {
+        ShaderDependencyGraph     graph;
+        std::vector<std::wstring> allShaders;
+        std::set<std::string>     includedFiles;
+
+        for (const WorkGraphShaderDesc& shader : WorkGraphShaders)
+        {
+            const std::string     file = ToNarrowString(shader.ShaderFilePath);
+            std::set<std::string> includes;
+
+            if (!std::filesystem::exists(std::filesystem::path(shaderDirectory) / file))
+            {
+                printf("Shader %s not found\n", file.c_str());
+                return 1;
+            }
+
+            AddShaderIncludes(shaderDirectory, file, includes);
+            includedFiles.insert(includes.begin(), includes.end());
+
+            std::vector<std::wstring> files = {shader.ShaderFilePath};
+            for (const std::string& include : includes)
+            {
+                files.push_back(std::wstring(include.begin(), include.end()));
+            }
+
+            graph.SetDependencies(GetShaderName(shader), files);
+            allShaders.push_back(GetShaderName(shader));
+        }
+
+        std::sort(allShaders.begin(), allShaders.end());
+
+        printf("  %-28s %8s\n", "File", "Dirty");
+        for (const std::wstring& file : graph.GetFiles())
+        {
+            printf("  %-28s %8zu\n", ToNarrowString(file).c_str(), graph.GetDirtyShaders({file}).size());
+        }
+        printf("\n");
+
+        // every work graph shader includes common.hlsl, directly or through splinegeneration.hlsl
+        errorCount += !CheckShaders("common.hlsl dirties all shaders", graph.GetDirtyShaders({L"common.hlsl"}), allShaders);
+        errorCount += !CheckShaders("splinegeneration.hlsl dirties the tree & rock libraries",
+                                    graph.GetDirtyShaders({L"splinegeneration.hlsl"}),
+                                    {L"rock.hlsl lib_6_9", L"tree.hlsl lib_6_9"});
+
+        // source files no other shader includes only dirty the shaders compiled from them
+        std::set<std::string> checkedFiles;
+        for (const WorkGraphShaderDesc& shader : WorkGraphShaders)
+        {
+            const std::string file = ToNarrowString(shader.ShaderFilePath);
+            if ((includedFiles.count(file) > 0) || !checkedFiles.insert(file).second)
+            {
+                continue;
+            }
+
+            std::vector<std::wstring> expectedShaders;
+            for (const WorkGraphShaderDesc& other : WorkGraphShaders)
+            {
+                if (std::wcscmp(other.ShaderFilePath, shader.ShaderFilePath) == 0)
+                {
+                    expectedShaders.push_back(GetShaderName(other));
+                }
+            }
+            std::sort(expectedShaders.begin(), expectedShaders.end());
+
+            const std::string check = file + " dirties its own shaders";
+            errorCount += !CheckShaders(check.c_str(), graph.GetDirtyShaders({shader.ShaderFilePath}), expectedShaders);
+        }
+
+        for (const std::wstring& shader : allShaders)
+        {
+            graph.RemoveShader(shader);
+        }
+
+        const bool filesRemoved = graph.GetFiles().empty() && graph.GetDirtyShaders({L"common.hlsl"}).empty();
+        printf("  %-56s %s\n", "removing all shaders leaves no files", filesRemoved ? "ok" : "FAILED");
+        errorCount += !filesRemoved;
+    }
+
+    return (errorCount == 0) ? 0 : 1;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        return PrintUsage();
+    }
+
+    const std::string command = argv[1];
+
+    if ((command == "parity") && (argc <= 3))
+    {
+        const size_t count = (argc >= 3) ? std::strtoull(argv[2], nullptr, 10) : 262144;
+
+        return Parity(std::max<size_t>(count, 1));
+    }
+
+    if ((command == "bench") && (argc <= 4))
+    {
+        const size_t   count       = (argc >= 3) ? std::strtoull(argv[2], nullptr, 10) : 65536;
+        const uint32_t threadCount = (argc >= 4) ? static_cast<uint32_t>(std::strtoul(argv[3], nullptr, 10)) : 1;
+
+        return Bench(std::max<size_t>(count, 1), std::max(threadCount, 1u));
+    }
+
+    if ((command == "clipmap") && (argc <= 5))
+    {
+        const uint32_t frameCount  = (argc >= 3) ? static_cast<uint32_t>(std::strtoul(argv[2], nullptr, 10)) : 600;
+        const float    speed       = (argc >= 4) ? static_cast<float>(std::strtod(argv[3], nullptr)) : 20.f;
+        const uint32_t texelBudget = (argc >= 5) ? static_cast<uint32_t>(std::strtoul(argv[4], nullptr, 10)) : 65536;
+
+        return Clipmap(std::max(frameCount, 1u), speed, texelBudget);
+    }
+
+    if ((command == "gradient") && (argc <= 3))
+    {
+        const size_t count = (argc >= 3) ? std::strtoull(argv[2], nullptr, 10) : 65536;
+
+        return Gradient(std::max<size_t>(count, 1));
+    }
+
+    if ((command == "samples") && (argc <= 3))
+    {
+        const size_t count = (argc >= 3) ? std::strtoull(argv[2], nullptr, 10) : 16384;
+
+        return Samples(std::max<size_t>(count, 1));
+    }
+
+    if ((command == "graph") && (argc <= 5))
+    {
+        const uint32_t threadCount = (argc >= 3) ? static_cast<uint32_t>(std::strtoul(argv[2], nullptr, 10)) : 0;
+        const uint32_t frameCount  = (argc >= 4) ? static_cast<uint32_t>(std::strtoul(argv[3], nullptr, 10)) : 10;
+
+        return Graph(threadCount, std::max(frameCount, 1u), (argc >= 5) ? argv[4] : nullptr);
+    }
+
+    if ((command == "flythrough") && (argc >= 3) && (argc <= 6))
+    {
+        const uint32_t threadCount   = (argc >= 5) ? static_cast<uint32_t>(std::strtoul(argv[4], nullptr, 10)) : 0;
+        const uint32_t maxFrameCount = (argc >= 6) ? static_cast<uint32_t>(std::strtoul(argv[5], nullptr, 10)) : 0;
+
+        return Flythrough(argv[2], (argc >= 4) ? argv[3] : nullptr, threadCount, maxFrameCount);
+    }
+
+    if ((command == "chunks") && (argc <= 6))
+    {
+        const uint32_t    poseCount       = (argc >= 3) ? static_cast<uint32_t>(std::strtoul(argv[2], nullptr, 10)) : 1024;
+        const uint32_t    repetitionCount = (argc >= 4) ? static_cast<uint32_t>(std::strtoul(argv[3], nullptr, 10)) : 20;
+        const uint32_t    verifyPoseCount = (argc >= 5) ? static_cast<uint32_t>(std::strtoul(argv[4], nullptr, 10)) : 4;
+        const std::string tierName        = (argc >= 6) ? argv[5] : "High";
+
+        for (const auto& tier : QualityTierPresets)
+        {
+            if (tierName == tier.Name)
+            {
+                return Chunks(std::max(poseCount, 1u), std::max(repetitionCount, 1u), verifyPoseCount, tier);
+            }
+        }
+    }
+
+    if ((command == "chunkcache") && (argc <= 6))
+    {
+        const uint32_t frameCount      = (argc >= 3) ? static_cast<uint32_t>(std::strtoul(argv[2], nullptr, 10)) : 1800;
+        const float    speed           = (argc >= 4) ? static_cast<float>(std::strtod(argv[3], nullptr)) : 20.f;
+        const uint32_t verifyFrameCount = (argc >= 5) ? static_cast<uint32_t>(std::strtoul(argv[4], nullptr, 10)) : 2;
+        const uint32_t capacity        = (argc >= 6) ? static_cast<uint32_t>(std::strtoul(argv[5], nullptr, 10)) : ChunkMetadataCacheDesc().Capacity;
+
+        return ChunkCache(std::max(frameCount, 1u), speed, verifyFrameCount, std::max(capacity, 1u));
+    }
+
+    if ((command == "horizon") && (argc <= 5))
+    {
+        const uint32_t frameCount       = (argc >= 4) ? static_cast<uint32_t>(std::strtoul(argv[3], nullptr, 10)) : 0;
+        const uint32_t verifyFrameCount = (argc >= 5) ? static_cast<uint32_t>(std::strtoul(argv[4], nullptr, 10)) : 4;
+
+        return Horizon((argc >= 3) ? argv[2] : "flight", frameCount, verifyFrameCount);
+    }
+
+    if ((command == "bounds") && (argc <= 5))
+    {
+        const uint32_t frameCount       = (argc >= 4) ? static_cast<uint32_t>(std::strtoul(argv[3], nullptr, 10)) : 0;
+        const uint32_t verifyFrameCount = (argc >= 5) ? static_cast<uint32_t>(std::strtoul(argv[4], nullptr, 10)) : 4;
+
+        return Bounds((argc >= 3) ? argv[2] : "flight", frameCount, verifyFrameCount);
+    }
+
+    if ((command == "records") && (argc <= 5))
+    {
+        const size_t   count       = (argc >= 3) ? std::strtoull(argv[2], nullptr, 10) : 1048576;
+        const uint32_t poseCount   = (argc >= 4) ? static_cast<uint32_t>(std::strtoul(argv[3], nullptr, 10)) : 64;
+        const uint32_t threadCount = (argc >= 5) ? static_cast<uint32_t>(std::strtoul(argv[4], nullptr, 10)) : 0;
+
+        return Records(std::max<size_t>(count, 1), poseCount, threadCount);
+    }
+
+    if ((command == "layout") && (argc <= 3))
+    {
+        return Layout((argc >= 3) ? argv[2] : nullptr);
+    }
+
+    if ((command == "splines") && (argc <= 4))
+    {
+        const uint32_t poseCount   = (argc >= 3) ? static_cast<uint32_t>(std::strtoul(argv[2], nullptr, 10)) : 64;
+        const uint32_t threadCount = (argc >= 4) ? static_cast<uint32_t>(std::strtoul(argv[3], nullptr, 10)) : 0;
+
+        return Splines(std::max(poseCount, 1u), threadCount);
+    }
+
+    if ((command == "budget") && (argc <= 5))
+    {
+        const double   targetTimeMs = (argc >= 3) ? std::strtod(argv[2], nullptr) : 10.0;
+        const uint32_t poseCount    = (argc >= 4) ? static_cast<uint32_t>(std::strtoul(argv[3], nullptr, 10)) : 8;
+        const uint32_t threadCount  = (argc >= 5) ? static_cast<uint32_t>(std::strtoul(argv[4], nullptr, 10)) : 0;
+
+        return Budget((targetTimeMs > 0.0) ? targetTimeMs : 10.0, std::max(poseCount, 1u), threadCount);
+    }
+
+    if ((command == "counters") && (argc <= 4))
+    {
+        const uint32_t poseCount   = (argc >= 3) ? static_cast<uint32_t>(std::strtoul(argv[2], nullptr, 10)) : 64;
+        const uint32_t threadCount = (argc >= 4) ? static_cast<uint32_t>(std::strtoul(argv[3], nullptr, 10)) : 0;
+
+        return Counters(std::max(poseCount, 1u), threadCount);
+    }
+
+    if ((command == "trace") && (argc >= 4) && (argc <= 7))
+    {
+        const uint32_t threadCount   = (argc >= 5) ? static_cast<uint32_t>(std::strtoul(argv[4], nullptr, 10)) : 0;
+        const uint32_t maxFrameCount = (argc >= 6) ? static_cast<uint32_t>(std::strtoul(argv[5], nullptr, 10)) : 0;
+        const size_t   bufferSize    = (argc >= 7) ? std::strtoull(argv[6], nullptr, 10) : FrameTraceWriter::DefaultBufferSize;
+
+        return Trace(argv[2], argv[3], threadCount, maxFrameCount, bufferSize);
+    }
+
+    if ((command == "dependencies") && (argc <= 3))
+    {
+        return Dependencies((argc >= 3) ? argv[2] : "../meshNodeSample/shaders");
+    }
+
+    if ((command == "limits") && (argc <= 5))
+    {
+        const uint32_t    poseCount   = (argc >= 3) ? static_cast<uint32_t>(std::strtoul(argv[2], nullptr, 10)) : 2048;
+        const uint32_t    threadCount = (argc >= 4) ? static_cast<uint32_t>(std::strtoul(argv[3], nullptr, 10)) : 0;
+        const std::string tierName    = (argc >= 5) ? argv[4] : "High";
+
+        for (const auto& tier : QualityTierPresets)
+        {
+            if (tierName == tier.Name)
+            {
+                return Limits(std::max(poseCount, 1u), threadCount, tier);
+            }
+        }
+    }
+
+    return PrintUsage();
+}
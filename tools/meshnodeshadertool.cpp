@@ -0,0 +1,284 @@
+// This file is part of the AMD Work Graph Mesh Node Sample.
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+// Offline tool for precompiling all work graph shaders into a single shader archive.
+//
+// Usage:
+//   MeshNodeShaderTool build <shader directory> <archive> [config]
+//   MeshNodeShaderTool list <archive>
+//   MeshNodeShaderTool compile <shader directory> [threads] [iterations]
+//
+// "build" always adds the default variant of every shader. If a config file (meshnodesampleconfig.json) is passed,
+// a variant for every quality tier in "QualityTiers" is added as well.
+// "compile" compiles all work graph shaders without writing any output and reports the compile throughput.
+
+#include "qualitytiers.h"
+#include "shaderarchive.h"
+#include "shadercache.h"
+#include "shadercompiler.h"
+#include "workgraphshaders.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+static std::wstring ToWString(const char* string)
+{
+    const std::string narrow(string);
+    return std::wstring(narrow.begin(), narrow.end());
+}
+
+static int PrintUsage()
+{
+    printf("Usage:\n");
+    printf("  MeshNodeShaderTool build <shader directory> <archive> [config]\n");
+    printf("  MeshNodeShaderTool list <archive>\n");
+    printf("  MeshNodeShaderTool compile <shader directory> [threads] [iterations]\n");
+
+    return 1;
+}
+
+static std::vector<ShaderCompileJob> GetWorkGraphShaderJobs(const std::vector<ShaderDefine>& defines = {})
+{
+    std::vector<ShaderCompileJob> jobs;
+    for (uint32_t i = 0; i < WorkGraphShaderCount; ++i)
+    {
+        ShaderCompileJob job = {};
+        job.ShaderFilePath   = WorkGraphShaders[i].ShaderFilePath;
+        job.Target           = WorkGraphShaders[i].Target;
+        job.EntryPoint       = WorkGraphShaders[i].EntryPoint;
+        job.Defines          = defines;
+
+        jobs.push_back(job);
+    }
+
+    return jobs;
+}
+
+static int BuildArchive(const std::wstring& shadersDirectory, const std::wstring& archivePath, const std::wstring& configPath)
+{
+    // default variant, followed by all quality tiers
+    std::vector<QualityTier> tiers = {QualityTier{}};
+    if (!configPath.empty())
+    {
+        std::vector<QualityTier> configTiers;
+        std::string              errorString;
+        if (!LoadQualityTiers(configPath, configTiers, errorString))
+        {
+            fprintf(stderr, "Failed to load quality tiers from %s: %s\n", ShaderArchiveToUtf8(configPath.c_str()).c_str(), errorString.c_str());
+            return 1;
+        }
+
+        tiers.insert(tiers.end(), configTiers.begin(), configTiers.end());
+    }
+
+    std::vector<ShaderCompileJob> jobs;
+    std::set<std::wstring>        variantKeys;
+    for (const auto& tier : tiers)
+    {
+        // tiers with identical define sets share their variants
+        if (!variantKeys.insert(GetShaderVariantKey(tier.Defines)).second)
+        {
+            continue;
+        }
+
+        const auto tierJobs = GetWorkGraphShaderJobs(tier.Defines);
+        jobs.insert(jobs.end(), tierJobs.begin(), tierJobs.end());
+    }
+
+    // Compile all shaders, report all errors instead of stopping at the first one
+    const double wallTimeMs = CompileShadersParallel(jobs, nullptr, false, shadersDirectory);
+
+    bool                success = true;
+    ShaderArchiveWriter writer;
+
+    for (auto& job : jobs)
+    {
+        if (job.pBlob == nullptr)
+        {
+            fprintf(stderr, "%s\n", ShaderArchiveToUtf8(job.Error.c_str()).c_str());
+            success = false;
+            continue;
+        }
+
+        uint64_t hash = 0;
+        if (!ComputeShaderSourceHash(shadersDirectory, job.ShaderFilePath, job.Target, job.EntryPoint, hash))
+        {
+            fprintf(stderr, "Failed to hash %s\n", ShaderArchiveToUtf8(job.ShaderFilePath).c_str());
+            success = false;
+        }
+
+        const std::wstring variantKey = GetShaderVariantKey(job.Defines);
+        writer.AddShader(
+            job.ShaderFilePath, job.Target, job.EntryPoint, variantKey.c_str(), hash, job.pBlob->GetBufferPointer(), job.pBlob->GetBufferSize());
+
+        job.pBlob->Release();
+        job.pBlob = nullptr;
+    }
+
+    if (!success)
+    {
+        return 1;
+    }
+
+    if (!writer.Write(archivePath))
+    {
+        fprintf(stderr, "Failed to write %s\n", ShaderArchiveToUtf8(archivePath.c_str()).c_str());
+        return 1;
+    }
+
+    printf("Compiled %u shaders (%u variants) in %.1f ms into %s\n",
+           static_cast<uint32_t>(jobs.size()),
+           static_cast<uint32_t>(jobs.size() / WorkGraphShaderCount),
+           wallTimeMs,
+           ShaderArchiveToUtf8(archivePath.c_str()).c_str());
+
+    return 0;
+}
+
+static int ListArchive(const std::wstring& archivePath)
+{
+    ShaderArchive archive;
+    if (!archive.Open(archivePath))
+    {
+        fprintf(stderr, "Failed to open %s\n", ShaderArchiveToUtf8(archivePath.c_str()).c_str());
+        return 1;
+    }
+
+    // defines last, variant keys of quality tiers are long
+    printf("%-28s %-8s %-22s %-16s %10s %10s %s\n", "File", "Target", "Entry point", "Hash", "Offset", "Size", "Defines");
+
+    for (uint32_t i = 0; i < archive.GetEntryCount(); ++i)
+    {
+        const auto& entry = archive.GetEntry(i);
+
+        printf("%-28s %-8s %-22s %016llx %10llu %10llu %s\n",
+               archive.GetString(entry.ShaderFilePathOffset),
+               archive.GetString(entry.TargetOffset),
+               archive.GetString(entry.EntryPointOffset),
+               static_cast<unsigned long long>(entry.Hash),
+               static_cast<unsigned long long>(entry.BlobOffset),
+               static_cast<unsigned long long>(entry.BlobSize),
+               archive.GetString(entry.DefinesOffset));
+    }
+
+    return 0;
+}
+
+static int CompileThroughput(const std::wstring& shadersDirectory, uint32_t threadCount, uint32_t iterationCount)
+{
+    bool   success         = true;
+    double totalWallTimeMs = 0.0;
+    double totalSumTimeMs  = 0.0;
+    size_t totalDxilSize   = 0;
+
+    for (uint32_t iteration = 0; iteration < iterationCount; ++iteration)
+    {
+        std::vector<ShaderCompileJob> jobs = GetWorkGraphShaderJobs();
+
+        // No shader cache, such that every iteration invokes DXC
+        const double wallTimeMs = CompileShadersParallel(jobs, nullptr, false, shadersDirectory, threadCount);
+        totalWallTimeMs += wallTimeMs;
+
+        for (auto& job : jobs)
+        {
+            totalSumTimeMs += job.CompileTimeMs;
+
+            if (job.pBlob == nullptr)
+            {
+                fprintf(stderr, "%s\n", ShaderArchiveToUtf8(job.Error.c_str()).c_str());
+                success = false;
+                continue;
+            }
+
+            if (iteration == 0)
+            {
+                printf("%-28s %-8s %-22s %10.1f ms %10zu bytes\n",
+                       ShaderArchiveToUtf8(job.ShaderFilePath).c_str(),
+                       ShaderArchiveToUtf8(job.Target).c_str(),
+                       ShaderArchiveToUtf8(job.EntryPoint).c_str(),
+                       job.CompileTimeMs,
+                       static_cast<size_t>(job.pBlob->GetBufferSize()));
+            }
+            totalDxilSize += job.pBlob->GetBufferSize();
+
+            job.pBlob->Release();
+            job.pBlob = nullptr;
+        }
+    }
+
+    const uint32_t shaderCount = WorkGraphShaderCount * iterationCount;
+
+    printf("\n");
+    printf("Shaders:            %u (%u iterations)\n", shaderCount, iterationCount);
+    printf("Threads:            %u\n", (threadCount > 0) ? threadCount : std::thread::hardware_concurrency());
+    printf("Wall-clock time:    %.1f ms\n", totalWallTimeMs);
+    printf("Summed shader time: %.1f ms (%.2fx parallel speedup)\n", totalSumTimeMs, totalSumTimeMs / std::max(totalWallTimeMs, 1e-3));
+    printf("Throughput:         %.2f shaders/s, %.2f MiB DXIL/s\n",
+           shaderCount / std::max(totalWallTimeMs * 1e-3, 1e-6),
+           totalDxilSize / (1024.0 * 1024.0) / std::max(totalWallTimeMs * 1e-3, 1e-6));
+
+    return success ? 0 : 1;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        return PrintUsage();
+    }
+
+    const std::string command = argv[1];
+
+    try
+    {
+        if ((command == "build") && ((argc == 4) || (argc == 5)))
+        {
+            return BuildArchive(ToWString(argv[2]), ToWString(argv[3]), (argc == 5) ? ToWString(argv[4]) : std::wstring());
+        }
+
+        if ((command == "list") && (argc == 3))
+        {
+            return ListArchive(ToWString(argv[2]));
+        }
+
+        if ((command == "compile") && (argc >= 3) && (argc <= 5))
+        {
+            const uint32_t threadCount    = (argc >= 4) ? static_cast<uint32_t>(std::strtoul(argv[3], nullptr, 10)) : 0;
+            const uint32_t iterationCount = (argc >= 5) ? static_cast<uint32_t>(std::strtoul(argv[4], nullptr, 10)) : 1;
+
+            return CompileThroughput(ToWString(argv[2]), threadCount, std::max(iterationCount, 1u));
+        }
+    }
+    catch (const std::exception& exception)
+    {
+        fprintf(stderr, "%s\n", exception.what());
+        return 1;
+    }
+
+    return PrintUsage();
+}
@@ -0,0 +1,91 @@
+// This file is part of the AMD Work Graph Mesh Node Sample.
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include "qualitytiers.h"
+#include "jsonreader.h"
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+bool LoadQualityTiers(const std::wstring& configPath, std::vector<QualityTier>& tiers, std::string& errorString)
+{
+    std::ifstream file(std::filesystem::path(configPath), std::ios::binary);
+    if (!file)
+    {
+        errorString = "Failed to open config file";
+        return false;
+    }
+
+    std::stringstream stream;
+    stream << file.rdbuf();
+    const std::string text = stream.str();
+
+    JsonNode document;
+    if (!ParseJson(text, document, errorString))
+    {
+        return false;
+    }
+
+    tiers.clear();
+
+    const JsonNode* qualityTiers = FindJsonMember(document, "QualityTiers");
+    if (qualityTiers == nullptr)
+    {
+        return true;
+    }
+
+    if (qualityTiers->NodeType != JsonNode::Type::Object)
+    {
+        errorString = "\"QualityTiers\" must be an object";
+        return false;
+    }
+
+    for (const auto& tierNode : qualityTiers->Children)
+    {
+        if (tierNode.second.NodeType != JsonNode::Type::Object)
+        {
+            errorString = "Quality tier \"" + tierNode.first + "\" must be an object";
+            return false;
+        }
+
+        QualityTier tier;
+        tier.Name = tierNode.first;
+
+        for (const auto& define : tierNode.second.Children)
+        {
+            if (define.second.NodeType != JsonNode::Type::String)
+            {
+                errorString = "Define " + define.first + " of quality tier \"" + tier.Name + "\" must be a string";
+                return false;
+            }
+
+            // config files are ASCII, widen byte-wise same as the sample does
+            const std::string& value = define.second.Value;
+            tier.Defines.push_back({std::wstring(define.first.begin(), define.first.end()), std::wstring(value.begin(), value.end())});
+        }
+
+        tiers.push_back(std::move(tier));
+    }
+
+    return true;
+}
@@ -0,0 +1,45 @@
+// This file is part of the AMD Work Graph Mesh Node Sample.
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#pragma once
+
+#include "shadercache.h"
+
+#include <string>
+#include <vector>
+
+/**
+ * Named define set from "QualityTiers" in meshnodesampleconfig.json.
+ */
+struct QualityTier
+{
+    std::string               Name;
+    std::vector<ShaderDefine> Defines;
+};
+
+/**
+ * @brief   Read all quality tiers from a sample config file.
+ *          The "QualityTiers" object is searched anywhere in the document, such that the full meshnodesampleconfig.json can be passed.
+ *          Only the subset of JSON used by config files is supported. Define values must be strings.
+ *          Returns false and a description in errorString if the file could not be read or parsed.
+ */
+bool LoadQualityTiers(const std::wstring& configPath, std::vector<QualityTier>& tiers, std::string& errorString);